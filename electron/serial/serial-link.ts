@@ -0,0 +1,278 @@
+// Framed Center→PC channel (ESP32 side: esp32/center/SerialLink.h)
+//
+// Frame on the wire: 0x00 COBS(type u8 | boot u16le | seq u32le | payload | crc16le) 0x00
+// Debug text from the Center never contains 0x00, so text lines and frames
+// share the same serial stream.
+//
+// boot is picked by the Center at power-up and carried in every frame, so a
+// reboot is seen even when its HELLO was missed. ACK/NACK echo the boot they
+// refer to; the Center ignores ones from an earlier boot.
+
+export const FRAME_DATA = 1;
+export const FRAME_ACK = 2;
+export const FRAME_NACK = 3;
+export const FRAME_HELLO = 4;
+
+const FRAME_HEADER = 7; // type + boot + seq
+const FRAME_OVERHEAD = 9; // header + crc16
+const MAX_FRAME_BYTES = 2048;
+const MAX_TEXT_BYTES = 4096;
+const NACK_RETRY_MS = 500;
+const NACK_MAX_TRIES = 3;
+
+export type SerialLinkStats = {
+  delivered: number;
+  duplicates: number;
+  badFrames: number;
+  nacksSent: number;
+  lost: number;
+};
+
+export type SerialLinkOptions = {
+  write: (bytes: Buffer) => void;
+  onData: (payload: string, seq: number) => void;
+  onText: (line: string) => void;
+  writeLog?: (message: string) => void;
+};
+
+export type SerialLink = {
+  push: (chunk: Buffer) => void;
+  tick: () => void;
+  reset: () => void;
+  getStats: () => SerialLinkStats;
+};
+
+// CRC-16/CCITT-FALSE (same as Wire_crc16 on the ESP32)
+export const crc16 = (data: Uint8Array, crc = 0xffff): number => {
+  for (let i = 0; i < data.length; i++) {
+    crc ^= data[i] << 8;
+    for (let bit = 0; bit < 8; bit++) {
+      crc = crc & 0x8000 ? ((crc << 1) ^ 0x1021) & 0xffff : (crc << 1) & 0xffff;
+    }
+  }
+  return crc;
+};
+
+export const cobsEncode = (data: Uint8Array): Buffer => {
+  const out: number[] = [0];
+  let codeIndex = 0;
+  let code = 1;
+  for (let i = 0; i < data.length; i++) {
+    if (data[i] !== 0) {
+      out.push(data[i]);
+      code++;
+    }
+    if (data[i] === 0 || code === 0xff) {
+      out[codeIndex] = code;
+      codeIndex = out.length;
+      out.push(0);
+      code = 1;
+    }
+  }
+  out[codeIndex] = code;
+  return Buffer.from(out);
+};
+
+export const cobsDecode = (data: Uint8Array): Buffer | null => {
+  const out: number[] = [];
+  let i = 0;
+  while (i < data.length) {
+    const code = data[i++];
+    if (code === 0 || i + code - 1 > data.length) return null;
+    for (let j = 1; j < code; j++) out.push(data[i++]);
+    if (code < 0xff && i < data.length) out.push(0);
+  }
+  return Buffer.from(out);
+};
+
+export type Frame = { type: number; boot: number; seq: number; payload: Buffer };
+
+export const encodeFrame = (
+  type: number,
+  boot: number,
+  seq: number,
+  payload: Uint8Array = new Uint8Array(0)
+): Buffer => {
+  const body = Buffer.alloc(FRAME_HEADER + payload.length + 2);
+  body[0] = type;
+  body.writeUInt16LE(boot & 0xffff, 1);
+  body.writeUInt32LE(seq >>> 0, 3);
+  Buffer.from(payload).copy(body, FRAME_HEADER);
+  body.writeUInt16LE(crc16(body.subarray(0, FRAME_HEADER + payload.length)), FRAME_HEADER + payload.length);
+  return Buffer.concat([Buffer.from([0]), cobsEncode(body), Buffer.from([0])]);
+};
+
+export const decodeFrame = (chunk: Uint8Array): Frame | null => {
+  const body = cobsDecode(chunk);
+  if (!body || body.length < FRAME_OVERHEAD) return null;
+  const end = body.length - 2;
+  if (body.readUInt16LE(end) !== crc16(body.subarray(0, end))) return null;
+  return {
+    type: body[0],
+    boot: body.readUInt16LE(1),
+    seq: body.readUInt32LE(3),
+    payload: body.subarray(FRAME_HEADER, end)
+  };
+};
+
+export const createSerialLink = ({ write, onData, onText, writeLog }: SerialLinkOptions): SerialLink => {
+  // Stream state: text between frames, frame bytes after a 0x00 delimiter
+  let inFrame = false;
+  let frameBytes: number[] = [];
+  let textBytes: number[] = [];
+
+  // Sequence state
+  let boot = -1; // Center boot the sequence belongs to (-1 = not synced yet)
+  let expectedSeq = 0;
+  const missing = new Map<number, { nackedAt: number; tries: number }>();
+  const stats: SerialLinkStats = { delivered: 0, duplicates: 0, badFrames: 0, nacksSent: 0, lost: 0 };
+
+  const sendNack = (seq: number) => {
+    write(encodeFrame(FRAME_NACK, boot, seq));
+    stats.nacksSent++;
+  };
+
+  // Cumulative ACK: everything below the oldest missing seq is done
+  const sendAck = () => {
+    let acked = expectedSeq - 1;
+    missing.forEach((_, seq) => {
+      if (seq - 1 < acked) acked = seq - 1;
+    });
+    if (acked > 0) write(encodeFrame(FRAME_ACK, boot, acked));
+  };
+
+  const resync = (newBoot: number, seq: number) => {
+    missing.clear();
+    boot = newBoot;
+    expectedSeq = seq;
+  };
+
+  const handleFrame = (frame: Frame) => {
+    if (frame.type === FRAME_HELLO) {
+      writeLog?.("[SERIAL-LINK] Center restarted - sequence reset");
+      resync(frame.boot, 1);
+      return;
+    }
+    if (frame.type !== FRAME_DATA) return;
+
+    const seq = frame.seq;
+    if (frame.boot !== boot) {
+      // First frame seen, or the Center rebooted and its HELLO was missed
+      if (boot !== -1) writeLog?.("[SERIAL-LINK] Center boot changed - sequence reset");
+      resync(frame.boot, seq);
+    }
+
+    if (seq >= expectedSeq) {
+      // Every seq skipped over is a lost/corrupted frame → ask for it again
+      for (let gap = expectedSeq; gap < seq; gap++) {
+        if (!missing.has(gap)) {
+          missing.set(gap, { nackedAt: Date.now(), tries: 1 });
+          sendNack(gap);
+        }
+      }
+      expectedSeq = seq + 1;
+    } else if (missing.has(seq)) {
+      missing.delete(seq);
+    } else {
+      stats.duplicates++;
+      sendAck();
+      return;
+    }
+
+    stats.delivered++;
+    sendAck();
+    onData(frame.payload.toString("utf8"), seq);
+  };
+
+  const flushText = (bytes: number[]) => {
+    if (bytes.length === 0) return;
+    Buffer.from(bytes)
+      .toString("utf8")
+      .split("\n")
+      .forEach((line) => onText(line));
+  };
+
+  const push = (chunk: Buffer) => {
+    for (const byte of chunk) {
+      if (byte === 0) {
+        if (!inFrame) {
+          // Leading delimiter: text so far is complete
+          flushText(textBytes);
+          textBytes = [];
+          inFrame = true;
+          frameBytes = [];
+          continue;
+        }
+        if (frameBytes.length === 0) continue; // back-to-back delimiters
+
+        const frame = decodeFrame(Uint8Array.from(frameBytes));
+        if (frame) {
+          handleFrame(frame);
+          inFrame = false;
+        } else {
+          // Corrupted frame or misaligned text: keep the text, treat this 0x00 as a new start
+          stats.badFrames++;
+          flushText(frameBytes);
+        }
+        frameBytes = [];
+        continue;
+      }
+
+      if (inFrame) {
+        frameBytes.push(byte);
+        if (frameBytes.length > MAX_FRAME_BYTES) {
+          // No closing delimiter: this was text after a lost frame end
+          stats.badFrames++;
+          textBytes = frameBytes;
+          frameBytes = [];
+          inFrame = false;
+        }
+      } else if (byte === 0x0a) {
+        flushText(textBytes);
+        textBytes = [];
+      } else {
+        textBytes.push(byte);
+        if (textBytes.length > MAX_TEXT_BYTES) {
+          flushText(textBytes);
+          textBytes = [];
+        }
+      }
+    }
+  };
+
+  // Called periodically: re-NACK missing frames, give up after NACK_MAX_TRIES
+  const tick = () => {
+    const now = Date.now();
+    let changed = false;
+    missing.forEach((entry, seq) => {
+      if (now - entry.nackedAt < NACK_RETRY_MS) return;
+      if (entry.tries >= NACK_MAX_TRIES) {
+        missing.delete(seq);
+        stats.lost++;
+        changed = true;
+        writeLog?.(`[SERIAL-LINK] Frame ${seq} lost after ${entry.tries} NACKs`);
+        return;
+      }
+      entry.tries++;
+      entry.nackedAt = now;
+      sendNack(seq);
+    });
+    if (changed) sendAck();
+  };
+
+  const reset = () => {
+    inFrame = false;
+    frameBytes = [];
+    textBytes = [];
+    boot = -1;
+    expectedSeq = 0;
+    missing.clear();
+  };
+
+  return {
+    push,
+    tick,
+    reset,
+    getStats: () => ({ ...stats })
+  };
+};
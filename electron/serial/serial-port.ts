@@ -1,5 +1,5 @@
 import { SerialPort } from "serialport";
-import { ReadlineParser } from "@serialport/parser-readline";
+import { createSerialLink, type SerialLink } from "./serial-link";
 
 export type SerialDevice = {
   deviceId: string;
@@ -39,6 +39,8 @@ export const startSerialPort = ({
   let isConnected = false;
   let port: SerialPort | null = null;
   let deviceCheckInterval: NodeJS.Timeout | null = null;
+  let linkTickInterval: NodeJS.Timeout | null = null;
+  let link: SerialLink | null = null;
   let reconnectInterval: NodeJS.Timeout | null = null;
   let isReconnecting = false;
 
@@ -97,6 +99,140 @@ export const startSerialPort = ({
     }
   };
 
+  // Handle one [DATA] JSON message (from a frame or a legacy text line)
+  const handleJson = (jsonString: string) => {
+    try {
+      const data = JSON.parse(jsonString);
+      
+      // Handle device status message
+      if (data.type === "device_status") {
+        updateDevice(data.deviceId, data.deviceName || data.deviceId, data.macAddress || "");
+      }
+      
+      // Handle vitals data message
+      else if (data.type === "vitals") {
+        // Don't update device here - device_status messages handle device tracking
+        // Updating device from vitals causes duplicate device entries
+        
+        // Process vitals data - แปลงเป็นรูปแบบที่ handleCombinedVitals ต้องการ
+        const vitalsPayload: any = {
+          idcard: data.idcard || "",
+          timestamp: data.timestamp || data.data?.timestamp || Date.now()
+        };
+
+        // รองรับ payload แบบ batch/combined ที่ส่ง field ตรง ๆ
+        if (data.weight != null) vitalsPayload.weight = data.weight;
+        if (data.height != null) vitalsPayload.height = data.height;
+        if (data.bp != null) vitalsPayload.bp = data.bp;
+        if (data.bp2 != null) vitalsPayload.bp2 = data.bp2;
+        if (data.pressure != null) vitalsPayload.pressure = data.pressure;
+        if (data.temp != null) vitalsPayload.temp = data.temp;
+        if (data.temperature != null) vitalsPayload.temperature = data.temperature;
+        if (data.pulse != null) vitalsPayload.pulse = data.pulse;
+        if (data.spo2 != null) vitalsPayload.spo2 = data.spo2;
+        
+        // Handle nested data structure from combined measurements (weight_height, blood_pressure)
+        if (data.data && typeof data.data === 'object') {
+          if (data.data.weight != null) vitalsPayload.weight = data.data.weight;
+          if (data.data.height != null) vitalsPayload.height = data.data.height;
+          if (data.data.bp != null) vitalsPayload.bp = data.data.bp;
+          if (data.data.bp2 != null) vitalsPayload.bp2 = data.data.bp2;
+          if (data.data.temp != null) vitalsPayload.temp = data.data.temp;
+          if (data.data.temperature != null) vitalsPayload.temperature = data.data.temperature;
+          if (data.data.pulse != null) vitalsPayload.pulse = data.data.pulse;
+          if (data.data.spo2 != null) vitalsPayload.spo2 = data.data.spo2;
+        }
+        
+        // แมป deviceType กับ field ที่ถูกค้อง (สำหรับ single value measurements)
+        if (data.deviceType === "bp") {
+          vitalsPayload.bp = data.data?.value || null;
+          vitalsPayload.pressure = data.data?.value || null;  // alias
+        } else if (data.deviceType === "bp2") {
+          vitalsPayload.bp2 = data.data?.value || null;
+        } else if (data.deviceType === "temp") {
+          vitalsPayload.temp = data.data?.value || null;
+          vitalsPayload.temperature = data.data?.value || null;  // alias
+        } else if (data.deviceType === "pulse") {
+          vitalsPayload.pulse = data.data?.value || null;
+        } else if (data.deviceType === "spo2") {
+          vitalsPayload.spo2 = data.data?.value || null;
+        } else if (data.deviceType === "weight") {
+          vitalsPayload.weight = data.data?.value || null;
+        } else if (data.deviceType === "height") {
+          vitalsPayload.height = data.data?.value || null;
+        }
+        // weight_height deviceType is already handled above in nested data structure section
+        
+        onMessage?.({
+          deviceId: data.deviceId || "unknown",
+          deviceType: "vitals",
+          message: JSON.stringify(vitalsPayload)
+        });
+      }
+      
+      // Handle legacy device type messages (deviceType-based routing)
+      else if (data.deviceType && 'idcard' in data) {
+        // Accept any deviceType with idcard field (even if empty string)
+        // This handles: blood_pressure, weight_height, etc.
+        writeLog?.(`[SERIAL-PARSE] DeviceType: ${data.deviceType}, IDCard: ${data.idcard || '(empty)'}`);
+        
+        onMessage?.({
+          deviceId: data.deviceId || "unknown",
+          deviceType: data.deviceType,
+          message: JSON.stringify(data)
+        });
+      }
+    } catch (error) {
+      console.error("[SERIAL] Failed to parse message:", jsonString, error);
+    }
+  };
+
+  const handleLine = (line: string) => {
+    const trimmedLine = line.trim();
+    
+    // Skip empty lines
+    if (!trimmedLine) return;
+    
+    // Log ทุกบรรทัดที่รับมา (DEBUG)
+    writeLog?.(`[SERIAL-RAW] ${trimmedLine}`);
+    
+    // ========== PARSE DEBUG MESSAGES ==========
+    // Pattern: "Station X: MAC_ADDRESS"
+    const stationMatch = trimmedLine.match(/Station\s+(\d+):\s+([0-9A-Fa-f:]{17})/);
+    if (stationMatch) {
+      const stationNum = stationMatch[1];
+      const macAddress = stationMatch[2].toUpperCase();
+      const deviceId = `DEVICE_${stationNum.padStart(3, '0')}`;
+      const deviceName = `Device ${stationNum}`;
+      
+      writeLog?.(`[SERIAL-PARSE] Detected device from Station line: ${deviceId} MAC: ${macAddress}`);
+      updateDevice(deviceId, deviceName, macAddress);
+      return; // ไม่ต้อง process ต่อ
+    }
+    
+    // Pattern: "Method X - ... Y stations" หรือ "softAPgetStationNum(): Y"
+    const countMatch = trimmedLine.match(/(?:(\d+)\s+stations?|softAPgetStationNum\(\):\s*(\d+))/i);
+    if (countMatch) {
+      const count = parseInt(countMatch[1] || countMatch[2]);
+      writeLog?.(`[SERIAL-PARSE] Detected ${count} stations`);
+      // อาจจะเคลียร์ offline devices ที่เกินจำนวนนี้ในอนาคต
+      return;
+    }
+    
+    // ========== PARSE JSON MESSAGES ==========
+    let jsonString = trimmedLine;
+    if (trimmedLine.startsWith("[DATA]")) {
+      jsonString = trimmedLine.substring(6).trim();
+    } else if (trimmedLine.startsWith("{") && trimmedLine.endsWith("}")) {
+      jsonString = trimmedLine;
+    } else {
+      // ไม่ใช่ทั้ง Station pattern และ JSON - skip
+      return;
+    }
+    
+    handleJson(jsonString);
+  };
+
   const connect = () => {
     // Clear reconnect interval if connecting manually
     if (reconnectInterval) {
@@ -113,7 +249,16 @@ export const startSerialPort = ({
         autoOpen: false
       });
 
-      const parser = port.pipe(new ReadlineParser({ delimiter: "\n" }));
+      const activePort = port;
+      link = createSerialLink({
+        write: (bytes) => {
+          if (activePort.isOpen) activePort.write(bytes);
+        },
+        onData: (payload) => handleJson(payload),
+        onText: handleLine,
+        writeLog
+      });
+      port.on("data", (chunk: Buffer) => link?.push(chunk));
 
       port.open((err) => {
         if (err) {
@@ -131,135 +276,8 @@ export const startSerialPort = ({
 
         // Start device timeout checker - ตรวจสอบทุก 3 วินาที (เรียลไทม์)
         deviceCheckInterval = setInterval(checkDeviceTimeout, 3000);
-      });
-
-      parser.on("data", (line: string) => {
-        const trimmedLine = line.trim();
-        
-        // Skip empty lines
-        if (!trimmedLine) return;
-        
-        // Log ทุกบรรทัดที่รับมา (DEBUG)
-        writeLog?.(`[SERIAL-RAW] ${trimmedLine}`);
-        
-        // ========== PARSE DEBUG MESSAGES ==========
-        // Pattern: "Station X: MAC_ADDRESS"
-        const stationMatch = trimmedLine.match(/Station\s+(\d+):\s+([0-9A-Fa-f:]{17})/);
-        if (stationMatch) {
-          const stationNum = stationMatch[1];
-          const macAddress = stationMatch[2].toUpperCase();
-          const deviceId = `DEVICE_${stationNum.padStart(3, '0')}`;
-          const deviceName = `Device ${stationNum}`;
-          
-          writeLog?.(`[SERIAL-PARSE] Detected device from Station line: ${deviceId} MAC: ${macAddress}`);
-          updateDevice(deviceId, deviceName, macAddress);
-          return; // ไม่ต้อง process ต่อ
-        }
-        
-        // Pattern: "Method X - ... Y stations" หรือ "softAPgetStationNum(): Y"
-        const countMatch = trimmedLine.match(/(?:(\d+)\s+stations?|softAPgetStationNum\(\):\s*(\d+))/i);
-        if (countMatch) {
-          const count = parseInt(countMatch[1] || countMatch[2]);
-          writeLog?.(`[SERIAL-PARSE] Detected ${count} stations`);
-          // อาจจะเคลียร์ offline devices ที่เกินจำนวนนี้ในอนาคต
-          return;
-        }
-        
-        // ========== PARSE JSON MESSAGES ==========
-        let jsonString = trimmedLine;
-        if (trimmedLine.startsWith("[DATA]")) {
-          jsonString = trimmedLine.substring(6).trim();
-        } else if (trimmedLine.startsWith("{") && trimmedLine.endsWith("}")) {
-          jsonString = trimmedLine;
-        } else {
-          // ไม่ใช่ทั้ง Station pattern และ JSON - skip
-          return;
-        }
-        
-        try {
-          const data = JSON.parse(jsonString);
-          
-          // Handle device status message
-          if (data.type === "device_status") {
-            updateDevice(data.deviceId, data.deviceName || data.deviceId, data.macAddress || "");
-          }
-          
-          // Handle vitals data message
-          else if (data.type === "vitals") {
-            // Don't update device here - device_status messages handle device tracking
-            // Updating device from vitals causes duplicate device entries
-            
-            // Process vitals data - แปลงเป็นรูปแบบที่ handleCombinedVitals ต้องการ
-            const vitalsPayload: any = {
-              idcard: data.idcard || "",
-              timestamp: data.timestamp || data.data?.timestamp || Date.now()
-            };
-
-            // รองรับ payload แบบ batch/combined ที่ส่ง field ตรง ๆ
-            if (data.weight != null) vitalsPayload.weight = data.weight;
-            if (data.height != null) vitalsPayload.height = data.height;
-            if (data.bp != null) vitalsPayload.bp = data.bp;
-            if (data.bp2 != null) vitalsPayload.bp2 = data.bp2;
-            if (data.pressure != null) vitalsPayload.pressure = data.pressure;
-            if (data.temp != null) vitalsPayload.temp = data.temp;
-            if (data.temperature != null) vitalsPayload.temperature = data.temperature;
-            if (data.pulse != null) vitalsPayload.pulse = data.pulse;
-            if (data.spo2 != null) vitalsPayload.spo2 = data.spo2;
-            
-            // Handle nested data structure from combined measurements (weight_height, blood_pressure)
-            if (data.data && typeof data.data === 'object') {
-              if (data.data.weight != null) vitalsPayload.weight = data.data.weight;
-              if (data.data.height != null) vitalsPayload.height = data.data.height;
-              if (data.data.bp != null) vitalsPayload.bp = data.data.bp;
-              if (data.data.bp2 != null) vitalsPayload.bp2 = data.data.bp2;
-              if (data.data.temp != null) vitalsPayload.temp = data.data.temp;
-              if (data.data.temperature != null) vitalsPayload.temperature = data.data.temperature;
-              if (data.data.pulse != null) vitalsPayload.pulse = data.data.pulse;
-              if (data.data.spo2 != null) vitalsPayload.spo2 = data.data.spo2;
-            }
-            
-            // แมป deviceType กับ field ที่ถูกค้อง (สำหรับ single value measurements)
-            if (data.deviceType === "bp") {
-              vitalsPayload.bp = data.data?.value || null;
-              vitalsPayload.pressure = data.data?.value || null;  // alias
-            } else if (data.deviceType === "bp2") {
-              vitalsPayload.bp2 = data.data?.value || null;
-            } else if (data.deviceType === "temp") {
-              vitalsPayload.temp = data.data?.value || null;
-              vitalsPayload.temperature = data.data?.value || null;  // alias
-            } else if (data.deviceType === "pulse") {
-              vitalsPayload.pulse = data.data?.value || null;
-            } else if (data.deviceType === "spo2") {
-              vitalsPayload.spo2 = data.data?.value || null;
-            } else if (data.deviceType === "weight") {
-              vitalsPayload.weight = data.data?.value || null;
-            } else if (data.deviceType === "height") {
-              vitalsPayload.height = data.data?.value || null;
-            }
-            // weight_height deviceType is already handled above in nested data structure section
-            
-            onMessage?.({
-              deviceId: data.deviceId || "unknown",
-              deviceType: "vitals",
-              message: JSON.stringify(vitalsPayload)
-            });
-          }
-          
-          // Handle legacy device type messages (deviceType-based routing)
-          else if (data.deviceType && 'idcard' in data) {
-            // Accept any deviceType with idcard field (even if empty string)
-            // This handles: blood_pressure, weight_height, etc.
-            writeLog?.(`[SERIAL-PARSE] DeviceType: ${data.deviceType}, IDCard: ${data.idcard || '(empty)'}`);
-            
-            onMessage?.({
-              deviceId: data.deviceId || "unknown",
-              deviceType: data.deviceType,
-              message: JSON.stringify(data)
-            });
-          }
-        } catch (error) {
-          console.error("[SERIAL] Failed to parse message:", jsonString, error);
-        }
+        // Re-request missing frames from the Center
+        linkTickInterval = setInterval(() => link?.tick(), 250);
       });
 
       port.on("error", (err) => {
@@ -287,6 +305,7 @@ export const startSerialPort = ({
           clearInterval(deviceCheckInterval);
           deviceCheckInterval = null;
         }
+        stopLink();
         
         // Clear all devices on disconnect
         devices.clear();
@@ -305,6 +324,21 @@ export const startSerialPort = ({
     }
   };
 
+  const stopLink = () => {
+    if (linkTickInterval) {
+      clearInterval(linkTickInterval);
+      linkTickInterval = null;
+    }
+    if (link) {
+      const stats = link.getStats();
+      writeLog?.(
+        `[SERIAL-LINK] delivered=${stats.delivered} duplicates=${stats.duplicates} ` +
+          `badFrames=${stats.badFrames} nacks=${stats.nacksSent} lost=${stats.lost}`
+      );
+      link = null;
+    }
+  };
+
   const startReconnect = () => {
     if (reconnectInterval || isReconnecting) return;
     
@@ -356,6 +390,7 @@ export const startSerialPort = ({
         clearInterval(deviceCheckInterval);
         deviceCheckInterval = null;
       }
+      stopLink();
       
       devices.clear();
       isConnected = false;
@@ -0,0 +1,96 @@
+/**
+ * BPJsonProtocol.h
+ * เครื่องวัดความดัน: JSON 400+ bytes ต่อการวัด (JsonFramer.h + BPParser.h)
+ *
+ * ต้องใช้ ArduinoJson (BPParser.h) - ส่วนอื่นของ InstrumentProtocol.h ไม่ต้องใช้
+ */
+
+#ifndef BP_JSON_PROTOCOL_H
+#define BP_JSON_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "ProtocolRegistry.h"
+#include "WireProtocol.h"
+#include "JsonFramer.h"
+#include "BPParser.h"
+
+struct BPJsonProtocol {
+  static constexpr uint8_t ID = 1;
+  static constexpr const char* NAME = "bp-json";
+  static constexpr const char* DESCRIPTION = "เครื่องวัดความดัน";
+  static constexpr const char* FORMAT = "JSON {\"idcard\":...,\"blood_pressure_h\":...}";
+  static constexpr uint32_t BAUD = 115200;
+  static constexpr uint32_t IDLE_TIMEOUT = 1000;   // เฟรมค้างครึ่งทางเกิน 1 วินาที = ทิ้ง
+
+  typedef JsonFramer Framer;
+  struct Parser {
+    const char* error;
+  };
+
+  static void begin(Framer& f, Parser& p) {
+    BP_beginFilter();
+    JsonFramer_begin(f);
+    p.error = "";
+  }
+
+  static bool inFrame(const Framer& f) {
+    return JsonFramer_inFrame(f);
+  }
+
+  static ProtocolFrameResult push(Framer& f, char c) {
+    switch (JsonFramer_push(f, c)) {
+      case JSON_FRAMER_FRAME:    return PROTOCOL_FRAME_READY;
+      case JSON_FRAMER_OVERFLOW: return PROTOCOL_FRAME_OVERFLOW;
+      case JSON_FRAMER_CORRUPT:  return PROTOCOL_FRAME_CORRUPT;
+      default:                   return PROTOCOL_FRAME_NONE;
+    }
+  }
+
+  // JSON ต้องปิดด้วย '}' เสมอ - เงียบกลางเฟรม = สายหลุด/เครื่องดับระหว่างส่ง
+  // (เฟรมเสียที่กำลังข้ามอยู่ รายงาน CORRUPT ไปแล้ว)
+  static ProtocolFrameResult idle(Framer& f) {
+    return JsonFramer_idle(f) ? PROTOCOL_FRAME_INCOMPLETE : PROTOCOL_FRAME_NONE;
+  }
+
+  static char* frame(Framer& f, size_t& length) {
+    length = f.length;
+    return f.buffer;
+  }
+
+  static void reset(Framer& f) {
+    JsonFramer_reset(f);
+  }
+
+  static ProtocolParseResult parse(Parser& p, char* frame, size_t length, uint32_t now, WireReading& out) {
+    BPReading reading;
+    DeserializationError error = BP_extractReading(frame, length, reading);
+    if (error) {
+      p.error = error.c_str();
+      return PROTOCOL_PARSE_ERROR;
+    }
+    if (reading.fields == 0) {
+      return PROTOCOL_PARSE_PARTIAL;   // JSON ถูกต้องแต่ไม่มี field ที่ใช้
+    }
+
+    memset(&out, 0, sizeof(out));
+    out.kind = WIRE_KIND_BLOOD_PRESSURE;
+    out.values[0] = reading.bp;
+    out.values[1] = reading.bp2;
+    out.values[2] = reading.pulse;
+    if (reading.fields & BP_FIELD_BP) out.fields |= WIRE_FIELD_VALUE0;
+    if (reading.fields & BP_FIELD_BP2) out.fields |= WIRE_FIELD_VALUE1;
+    if (reading.fields & BP_FIELD_PULSE) out.fields |= WIRE_FIELD_VALUE2;
+    out.idcard = Wire_idcardFromString(reading.idcard);
+    if (out.idcard != 0) out.fields |= WIRE_FIELD_IDCARD;
+    return PROTOCOL_PARSE_READING;
+  }
+
+  // 1 เฟรม = 1 การวัด - ไม่มีค่าที่รอคู่
+  static ProtocolParseResult poll(Parser& p, uint32_t now, WireReading& out) {
+    return PROTOCOL_PARSE_NONE;
+  }
+};
+
+#endif
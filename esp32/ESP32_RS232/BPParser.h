@@ -0,0 +1,92 @@
+/**
+ * BPParser.h
+ * ดึงค่าจาก JSON ของเครื่องวัดความดัน (ไม่ขึ้นกับ Arduino core)
+ *
+ * ใช้แค่ ArduinoJson (header-only) - compile บน PC ได้ตรงๆ เพื่อทดสอบ/วัดเวลา parse
+ * โดยไม่ต้องมีบอร์ด ใช้ผ่าน BPJsonProtocol.h
+ */
+
+#ifndef BP_PARSER_H
+#define BP_PARSER_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <ArduinoJson.h>
+
+// ===== ค่าที่อ่านได้จากเครื่องวัดความดัน =====
+// ดึงเฉพาะ 4 fields จาก JSON ของเครื่อง แล้วส่งต่อเป็น struct จนถึงตอนส่ง Center
+#define BP_FIELD_IDCARD 0x01
+#define BP_FIELD_BP     0x02
+#define BP_FIELD_BP2    0x04
+#define BP_FIELD_PULSE  0x08
+
+struct BPReading {
+  char idcard[24];      // เลขบัตรประชาชน (13 หลัก)
+  int16_t bp;           // ความดันบน (mmHg)
+  int16_t bp2;          // ความดันล่าง (mmHg)
+  int16_t pulse;        // ชีพจร (bpm)
+  uint8_t fields;       // BP_FIELD_* ที่มีในข้อมูล
+};
+
+// ===== Filter สำหรับ ArduinoJson =====
+// JSON จากเครื่อง 400+ bytes แต่ใช้แค่ 4 fields → parse เฉพาะ field ที่ต้องการ
+StaticJsonDocument<128> bpFilter;
+
+inline void BP_beginFilter() {
+  bpFilter["idcard"] = true;
+  bpFilter["blood_pressure_h"] = true;
+  bpFilter["blood_pressure_l"] = true;
+  bpFilter["heart_rate"] = true;
+}
+
+// ===== ดึงค่า BP จากเฟรม JSON =====
+// json ต้องแก้ไขได้ (char*) - ArduinoJson จะใช้ string ใน buffer เดิมโดยไม่ copy
+// คืน error ของ ArduinoJson (ผู้เรียกเป็นคน log)
+inline DeserializationError BP_extractReading(char* json, size_t length, BPReading& reading) {
+  StaticJsonDocument<128> doc;
+  DeserializationError error = deserializeJson(doc, json, length,
+                                               DeserializationOption::Filter(bpFilter));
+  
+  if (error) {
+    return error;
+  }
+  
+  memset(&reading, 0, sizeof(reading));
+  
+  // 1. ID Card (เลขบัตรประชาชน)
+  // บางเครื่องส่งเป็นตัวเลข (ไม่มี "") → แปลงเป็นข้อความเหมือน as<String>() ของวิธีเดิม
+  JsonVariant idcard = doc["idcard"];
+  if (idcard.is<const char*>()) {
+    strlcpy(reading.idcard, idcard.as<const char*>(), sizeof(reading.idcard));
+    reading.fields |= BP_FIELD_IDCARD;
+  } else if (idcard.is<long long>()) {
+    snprintf(reading.idcard, sizeof(reading.idcard), "%lld", idcard.as<long long>());
+    reading.fields |= BP_FIELD_IDCARD;
+  }
+  
+  // 2. ความดันบน
+  JsonVariant bpH = doc["blood_pressure_h"];
+  if (!bpH.isNull()) {
+    reading.bp = bpH.as<int>();
+    reading.fields |= BP_FIELD_BP;
+  }
+  
+  // 3. ความดันล่าง
+  JsonVariant bpL = doc["blood_pressure_l"];
+  if (!bpL.isNull()) {
+    reading.bp2 = bpL.as<int>();
+    reading.fields |= BP_FIELD_BP2;
+  }
+  
+  // 4. ชีพจร
+  JsonVariant hr = doc["heart_rate"];
+  if (!hr.isNull()) {
+    reading.pulse = hr.as<int>();
+    reading.fields |= BP_FIELD_PULSE;
+  }
+  
+  return error;
+}
+
+#endif
@@ -0,0 +1,256 @@
+/**
+ * BaudProbe.h
+ * หา baud rate ของเครื่องที่ต่อ RS232 อัตโนมัติ (autobaud)
+ *
+ * ลองทีละ rate มาตรฐาน (เริ่มจาก baud ของโปรโตคอล) แล้วดูข้อมูลที่ถอดได้ที่ rate นั้น:
+ *   - parse เฟรมสำเร็จ                            → lock ทันที (บันทึกลง Config)
+ *   - printable < 90% หรือ parse ไม่ได้ 2 เฟรม     → rate ผิด → ลอง rate ถัดไปทันที
+ *   - ยังตัดสินไม่ได้                               → ให้คะแนนเมื่อครบ AUTOBAUD_WINDOW_MS
+ *                                                    (นับจาก byte แรก) หรือ AUTOBAUD_WINDOW_MAX_BYTES
+ *     ถ้าดูเป็น Text รอได้ถึง AUTOBAUD_TEXT_WINDOW_MS ให้เฟรมถัดไปมาครบ
+ *     (เปลี่ยน rate กลางข้อความ → ได้แค่ท้ายเฟรม ต้องรอเครื่องส่งครั้งถัดไป)
+ *   ครบทุก rate แล้วไม่มีเฟรมที่ parse ได้ → lock rate ที่คะแนนดีสุดชั่วคราว (ไม่บันทึก)
+ *   คะแนน = % printable + 50 ถ้า Framer ได้เฟรม
+ *
+ * สายเงียบไม่นับเวลา (เครื่องวัดความดันส่งแค่ตอนวัด) - rate หนึ่งใช้เวลาไม่เกิน
+ * AUTOBAUD_TEXT_WINDOW_MS หลังจากมีข้อมูล → ครบ 8 rate ภายในเวลาที่จำกัด
+ * (rate ที่ผิดส่วนใหญ่ตัดสินได้จากข้อความเดียว - ถอดได้ไม่ถึง 90% เป็น Text)
+ *
+ * lock แล้วยังเฝ้าดู (นับจากเฟรมที่ parse ได้ล่าสุด) → หาใหม่เมื่อ:
+ *   - parse ไม่ได้ AUTOBAUD_REPROBE_REJECTS เฟรมติดกัน
+ *   - printable < 90% หลังได้ AUTOBAUD_REPROBE_MIN_BYTES
+ *   - ได้ byte เกิน AUTOBAUD_REPROBE_BYTES โดยไม่มีเฟรมที่ parse ได้เลย
+ *
+ * ผู้เรียกนับ counter สะสม (BaudProbeCounters) แล้วเรียก BaudProbe_update() เป็นระยะ
+ * ได้ BAUD_PROBE_SWITCH → ตั้ง UART เป็น BaudProbe_rate() / BAUD_PROBE_LOCKED → บันทึก rate ด้วย
+ * ไม่ขึ้นกับ Arduino - compile บน PC ได้ (รับ now เป็น argument)
+ */
+
+#ifndef BAUD_PROBE_H
+#define BAUD_PROBE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ===== Configuration =====
+#define AUTOBAUD_WINDOW_MIN_BYTES 32     // ตัดสินจาก % printable ได้เมื่อได้เท่านี้
+#define AUTOBAUD_WINDOW_MAX_BYTES 2048   // ดูเป็น Text แต่ไม่ครบเฟรมเกินนี้ → ให้คะแนนแล้วไปต่อ
+#define AUTOBAUD_WINDOW_MS 3000          // นับจาก byte แรกที่ rate นี้
+#define AUTOBAUD_TEXT_WINDOW_MS 10000    // ดูเป็น Text แต่ยังไม่มีเฟรมที่ parse ได้
+#define AUTOBAUD_WINDOW_REJECTS 2        // parse ไม่ได้เท่านี้ = rate ผิด (เฟรมแรกหลังเปลี่ยน rate อาจขาดหัว)
+#define AUTOBAUD_PRINTABLE_MIN 90        // % ต่ำกว่านี้ = rate ผิด
+#define AUTOBAUD_LOCK_SCORE 90           // คะแนนขั้นต่ำที่ lock ได้โดยไม่มีเฟรมที่ parse ได้
+#define AUTOBAUD_REPROBE_REJECTS 3
+#define AUTOBAUD_REPROBE_MIN_BYTES 256
+#define AUTOBAUD_REPROBE_BYTES 4096
+
+const uint32_t AUTOBAUD_RATES[] = { 1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200 };
+#define AUTOBAUD_RATE_COUNT (sizeof(AUTOBAUD_RATES) / sizeof(AUTOBAUD_RATES[0]))
+
+enum BaudProbeAction : uint8_t {
+  BAUD_PROBE_NONE = 0,
+  BAUD_PROBE_SWITCH,    // ตั้ง UART เป็น BaudProbe_rate() (กำลังหา / lock ชั่วคราว / หาใหม่)
+  BAUD_PROBE_LOCKED     // parse ได้ที่ BaudProbe_rate() → ตั้ง UART (ถ้ายังไม่ใช่) และบันทึกลง Config
+};
+
+// ===== Counter สะสม (ผู้เรียกนับเพิ่มอย่างเดียว ไม่ reset) =====
+struct BaudProbeCounters {
+  uint32_t bytes;
+  uint32_t printable;   // 0x20-0x7E, \t, \r, \n
+  uint32_t frames;      // Framer ได้เฟรมครบ
+  uint32_t valid;       // parse สำเร็จ
+  uint32_t rejects;     // parse ไม่ได้
+};
+
+struct BaudProbe {
+  uint8_t index;            // rate ปัจจุบันใน AUTOBAUD_RATES
+  bool locked;
+  bool confirmed;           // lock เพราะ parse ได้ (ไม่ใช่แค่คะแนนดีสุด)
+  uint8_t tried;            // rate ที่ให้คะแนนแล้วในรอบนี้
+  uint8_t bestIndex;
+  uint8_t bestScore;
+  BaudProbeCounters mark;   // counter ตอนเริ่ม window / ตอน parse ได้ล่าสุด (เมื่อ lock)
+  uint32_t windowStart;     // ms: byte แรกของ window (0 = ยังไม่มี byte)
+  uint32_t probeStart;      // ms: เริ่มหารอบนี้
+
+  // สถิติ
+  uint32_t switchCount;
+  uint32_t reprobeCount;
+  uint32_t lastLockTime;    // ms ที่ใช้หาครั้งล่าสุด (เริ่มหา → parse ได้)
+};
+
+// ===== ตัวอักษรที่ถือว่าเป็น Text =====
+inline bool BaudProbe_isPrintable(uint8_t c) {
+  return (c >= 0x20 && c < 0x7F) || c == '\t' || c == '\r' || c == '\n';
+}
+
+inline uint32_t BaudProbe_countPrintable(const uint8_t* data, size_t length) {
+  uint32_t count = 0;
+  for (size_t i = 0; i < length; i++) {
+    count += BaudProbe_isPrintable(data[i]);
+  }
+  return count;
+}
+
+// ===== index ใน AUTOBAUD_RATES (-1 = ไม่ใช่ rate มาตรฐาน) =====
+inline int BaudProbe_indexOf(uint32_t baud) {
+  for (size_t i = 0; i < AUTOBAUD_RATE_COUNT; i++) {
+    if (AUTOBAUD_RATES[i] == baud) {
+      return (int)i;
+    }
+  }
+  return -1;
+}
+
+inline uint32_t BaudProbe_rate(const BaudProbe& p) {
+  return AUTOBAUD_RATES[p.index];
+}
+
+inline void BaudProbe_startWindow(BaudProbe& p, const BaudProbeCounters& counters) {
+  p.mark = counters;
+  p.windowStart = 0;
+}
+
+inline void BaudProbe_startSweep(BaudProbe& p, const BaudProbeCounters& counters, uint32_t now) {
+  p.locked = false;
+  p.confirmed = false;
+  p.tried = 0;
+  p.bestScore = 0;
+  p.bestIndex = p.index;
+  p.probeStart = now;
+  BaudProbe_startWindow(p, counters);
+}
+
+// ===== เริ่มต้น =====
+// savedBaud: rate ที่เคย lock ได้ (จาก Config) → lock ทันที / 0 = ยังไม่รู้ → เริ่มหาจาก defaultBaud
+inline void BaudProbe_begin(BaudProbe& p, uint32_t savedBaud, uint32_t defaultBaud,
+                            const BaudProbeCounters& counters, uint32_t now) {
+  int saved = BaudProbe_indexOf(savedBaud);
+  int preferred = BaudProbe_indexOf(defaultBaud);
+  p.index = saved >= 0 ? saved : (preferred >= 0 ? preferred : 0);
+  p.switchCount = 0;
+  p.reprobeCount = 0;
+  p.lastLockTime = 0;
+  BaudProbe_startSweep(p, counters, now);
+  p.locked = saved >= 0;
+  p.confirmed = saved >= 0;
+}
+
+// ===== ตั้ง rate เอง (lock ทันที) =====
+inline void BaudProbe_force(BaudProbe& p, uint32_t baud, const BaudProbeCounters& counters, uint32_t now) {
+  int index = BaudProbe_indexOf(baud);
+  if (index < 0) {
+    return;
+  }
+  p.index = index;
+  BaudProbe_startSweep(p, counters, now);
+  p.locked = true;
+  p.confirmed = true;
+}
+
+// ===== เริ่มหาใหม่ตั้งแต่ rate ถัดไป =====
+inline void BaudProbe_restart(BaudProbe& p, const BaudProbeCounters& counters, uint32_t now) {
+  p.reprobeCount++;
+  p.switchCount++;
+  p.index = (p.index + 1) % AUTOBAUD_RATE_COUNT;
+  BaudProbe_startSweep(p, counters, now);
+}
+
+// ===== คะแนนของ window =====
+inline uint8_t BaudProbe_score(const BaudProbe& p, const BaudProbeCounters& counters) {
+  uint32_t bytes = counters.bytes - p.mark.bytes;
+  if (bytes == 0) {
+    return 0;
+  }
+  uint32_t score = (uint64_t)(counters.printable - p.mark.printable) * 100 / bytes;
+  if (counters.frames != p.mark.frames) {
+    score += 50;
+  }
+  return (uint8_t)score;
+}
+
+// ===== % printable ต่ำเกินไป (หลังได้ byte พอให้ตัดสิน) =====
+inline bool BaudProbe_isGarbage(const BaudProbe& p, const BaudProbeCounters& counters, uint32_t minBytes) {
+  uint32_t bytes = counters.bytes - p.mark.bytes;
+  uint32_t printable = counters.printable - p.mark.printable;
+  return bytes >= minBytes && (uint64_t)printable * 100 < (uint64_t)bytes * AUTOBAUD_PRINTABLE_MIN;
+}
+
+// ===== lock แล้ว: เฝ้าดูว่ายังมีเฟรมที่ parse ได้ =====
+inline BaudProbeAction BaudProbe_watch(BaudProbe& p, const BaudProbeCounters& counters, uint32_t now) {
+  if (counters.valid != p.mark.valid) {
+    BaudProbe_startWindow(p, counters);
+    if (!p.confirmed) {
+      p.confirmed = true;
+      p.lastLockTime = now - p.probeStart;
+      return BAUD_PROBE_LOCKED;
+    }
+    return BAUD_PROBE_NONE;
+  }
+
+  bool rejected = counters.rejects - p.mark.rejects >= AUTOBAUD_REPROBE_REJECTS;
+  bool garbage = BaudProbe_isGarbage(p, counters, AUTOBAUD_REPROBE_MIN_BYTES);
+  bool silent = counters.bytes - p.mark.bytes >= AUTOBAUD_REPROBE_BYTES;
+  if (rejected || garbage || silent) {
+    BaudProbe_restart(p, counters, now);
+    return BAUD_PROBE_SWITCH;
+  }
+  return BAUD_PROBE_NONE;
+}
+
+// ===== เรียกเป็นระยะ (หลัง parse เฟรมที่ค้างอยู่แล้ว) =====
+inline BaudProbeAction BaudProbe_update(BaudProbe& p, const BaudProbeCounters& counters, uint32_t now) {
+  if (p.locked) {
+    return BaudProbe_watch(p, counters, now);
+  }
+
+  if (counters.valid != p.mark.valid) {
+    p.locked = true;
+    p.confirmed = true;
+    p.lastLockTime = now - p.probeStart;
+    BaudProbe_startWindow(p, counters);
+    return BAUD_PROBE_LOCKED;
+  }
+
+  uint32_t bytes = counters.bytes - p.mark.bytes;
+  if (bytes == 0) {
+    return BAUD_PROBE_NONE;   // สายเงียบ - ยังไม่มีข้อมูลให้ตัดสิน
+  }
+  if (p.windowStart == 0) {
+    p.windowStart = now != 0 ? now : 1;
+  }
+
+  bool rejected = counters.rejects - p.mark.rejects >= AUTOBAUD_WINDOW_REJECTS;
+  bool garbage = BaudProbe_isGarbage(p, counters, AUTOBAUD_WINDOW_MIN_BYTES);
+  uint32_t dwell = BaudProbe_isGarbage(p, counters, 1) ? AUTOBAUD_WINDOW_MS : AUTOBAUD_TEXT_WINDOW_MS;
+  bool expired = now - p.windowStart >= dwell || bytes >= AUTOBAUD_WINDOW_MAX_BYTES;
+  if (!rejected && !garbage && !expired) {
+    return BAUD_PROBE_NONE;
+  }
+
+  uint8_t score = rejected || garbage ? 0 : BaudProbe_score(p, counters);
+  if (score > p.bestScore) {
+    p.bestScore = score;
+    p.bestIndex = p.index;
+  }
+  p.tried++;
+  p.switchCount++;
+
+  if (p.tried >= AUTOBAUD_RATE_COUNT) {
+    if (p.bestScore >= AUTOBAUD_LOCK_SCORE) {
+      // ไม่มี rate ไหน parse ได้ (อาจเลือกโปรโตคอลผิด) → ใช้ rate ที่ดูเป็น Text ที่สุดไปก่อน
+      p.index = p.bestIndex;
+      p.locked = true;
+      BaudProbe_startWindow(p, counters);
+      return BAUD_PROBE_SWITCH;
+    }
+    // ไม่มี rate ไหนดีพอ (สายเสีย / สัญญาณรบกวน) → เริ่มรอบใหม่
+    p.tried = 0;
+    p.bestScore = 0;
+  }
+  p.index = (p.index + 1) % AUTOBAUD_RATE_COUNT;
+  BaudProbe_startWindow(p, counters);
+  return BAUD_PROBE_SWITCH;
+}
+
+#endif
@@ -3,16 +3,27 @@
  * ไฟล์กำหนดค่าการทำงานของระบบ RS232 to HTTP POST
  * 
  * =============================================================================
- * ===== รองรับอุปกรณ์ 2 ประเภท =====
+ * ===== รองรับอุปกรณ์ 2 ประเภท (InstrumentProtocol.h) =====
  * =============================================================================
  * 
- * 1️⃣ เครื่องวัดความดัน (BP Monitor) - ESP32
+ * firmware เดียวรองรับทุกโปรโตคอล - เลือกด้วยคำสั่ง "protocol <ชื่อ>" ใน Serial Monitor
+ * (บันทึกใน EEPROM) ถ้ายังไม่เคยเลือก: ESP32 = bp-json, ESP8266 = weight-text
+ * 
+ * Baud rate หาอัตโนมัติ (BaudProbe.h) เริ่มจาก Baud ของโปรโตคอล - หาเจอแล้วบันทึกใน EEPROM
+ * เปิดเครื่องครั้งหน้าใช้ค่าเดิมทันที / ตั้งเองด้วย "baud <rate>" / หาใหม่ด้วย "baud auto"
+ * 
+ * Config ทั้งหมดอยู่ใน record เดียวที่มี version + CRC (ConfigRecord.h)
+ * WiFi ด้านล่างเป็นค่าเริ่มต้น - แก้ได้ใน Serial Monitor ("ssid", "pass", "center", "ip")
+ * เชื่อมต่อได้แล้วจำ BSSID/channel ของ Center → ครั้งต่อไปไม่ต้อง scan
+ * ตั้ง IP ของเครื่องเอง ("ip 10.1.10.201") → ไม่ต้องรอ DHCP
+ * 
+ * 1️⃣ เครื่องวัดความดัน (BP Monitor) - bp-json (ใช้ ESP32)
  *    - Baud: 115200
  *    - รับข้อมูล JSON: {"end_time":"...", "idcard":"...", "blood_pressure_h":127, ...}
  *    - ดึงค่า: idcard, bp, bp2, pulse
  *    - กรองข้อมูล: ส่งเฉพาะ 4 fields
  * 
- * 2️⃣ เครื่องชั่ง (Weight Scale) - ESP8266
+ * 2️⃣ เครื่องชั่ง (Weight Scale) - weight-text
  *    - Baud: 9600
  *    - รับข้อมูล Text: W:070.3 H:173.5, T365$
  *    - ดึงค่า: weight, height, temp
@@ -38,13 +49,35 @@
 #define CONFIG_H
 
 #include <ArduinoJson.h>
+#include "InstrumentProtocol.h"
+#include "BaudProbe.h"
+#include "ConfigRecord.h"
+
+// =============================================================================
+// ===== WIFI CONFIGURATION (ค่าเริ่มต้น - ใช้เมื่อยังไม่เคยบันทึกใน EEPROM) =====
+// =============================================================================
+const char* DEFAULT_CENTER_SSID = "MEDICAL_CENTER_01";  // SSID ของ Center AP
+const char* DEFAULT_CENTER_PASSWORD = "Abc123**";       // รหัสผ่าน WiFi
+const char* DEFAULT_CENTER_IP = "10.1.10.1";            // IP Address ของ Center
+const char* DEFAULT_LOCAL_IP = "";                      // "" = DHCP / เช่น "10.1.10.201" (ห้ามซ้ำกันแต่ละเครื่อง)
 
 // =============================================================================
-// ===== WIFI CONFIGURATION (ตั้งค่า WiFi Center) =====
+// ===== UPLINK PROTOCOL (รูปแบบการส่งข้อมูลไปยัง Center) =====
 // =============================================================================
-const char* CENTER_SSID = "MEDICAL_CENTER_01";  // SSID ของ Center AP
-const char* CENTER_PASSWORD = "Abc123**";       // รหัสผ่าน WiFi
-const char* CENTER_IP = "10.1.10.1";            // IP Address ของ Center
+// true  = Binary ผ่าน UDP (WireProtocol.h) ~34 bytes/reading
+//         ข้อมูลอุปกรณ์ (MAC + ชื่อ) ส่งครั้งเดียวต่อ session - ต้องใช้ Center ที่รองรับ UDP 5600
+// false = JSON ผ่าน HTTP POST /api/vitals (~250 bytes/reading)
+const bool UPLINK_BINARY = true;
+
+// =============================================================================
+// ===== LOG (ข้อความ debug ทาง Serial Monitor - ดู Log.h) =====
+// =============================================================================
+// LOG_LEVEL: LOG_LEVEL_NONE / ERROR / WARN / INFO / DEBUG
+//   ระดับที่สูงกว่านี้ถูกตัดออกตอน compile (DEBUG = dump JSON / response ทุก reading)
+// LOG_DEFERRED: 1 = เขียนลง RAM แล้วทยอยส่งตอนว่าง (ไม่หน่วงการอ่าน RS232)
+//               0 = พิมพ์ตรงแบบเดิม (ใช้ตอนไล่หาปัญหาที่ทำให้เครื่อง reset)
+#define LOG_LEVEL LOG_LEVEL_INFO
+#define LOG_DEFERRED 1
 
 // =============================================================================
 // ===== DEVICE CONFIGURATION (ตั้งค่าอุปกรณ์) =====
@@ -57,12 +90,24 @@ const char* CENTER_IP = "10.1.10.1";            // IP Address ของ Center
 //   - "Thermometer_Main"   - เครื่องวัดอุณหภูมิหลัก
 const char* DEFAULT_DEVICE_NAME = "DEVICE W:02";
 
+// โปรโตคอลของเครื่องที่ต่อ RS232 (ใช้เมื่อยังไม่เคยบันทึกใน EEPROM)
+#ifdef ESP32
+  const uint8_t DEFAULT_PROTOCOL = BPJsonProtocol::ID;       // Hardware UART รับ JSON 115200 ได้
+#else
+  const uint8_t DEFAULT_PROTOCOL = WeightTextProtocol::ID;   // SoftwareSerial 9600
+#endif
+
 // =============================================================================
-// ===== DATA STRUCTURE =====
+// ===== DATA STRUCTURE (ConfigData อยู่ใน ConfigRecord.h) =====
 // =============================================================================
-struct ConfigData {
-  char deviceName[32];  // ชื่ออุปกรณ์ (แสดงใน Center)
-};
+#define CONFIG_ADDR 0
+
+// Config แบบเดิม (ก่อนมี version) - ย้ายเข้า record ใหม่ครั้งแรกที่เปิดเครื่อง
+#define CONFIG_LEGACY_ADDR_NAME 0
+#define CONFIG_LEGACY_ADDR_PROTOCOL 32
+#define CONFIG_LEGACY_ADDR_BAUD 33
+
+static_assert(CONFIG_ADDR + sizeof(ConfigData) <= EEPROM_SIZE, "ConfigData ใหญ่เกิน EEPROM_SIZE");
 
 ConfigData config;
 
@@ -70,37 +115,112 @@ ConfigData config;
 // ===== FUNCTIONS (ฟังก์ชันสำหรับจัดการ Config) =====
 // =============================================================================
 
+// ===== ค่า Default ทั้งหมด =====
+void Config_defaults() {
+  memset(&config, 0, sizeof(config));
+  strlcpy(config.deviceName, DEFAULT_DEVICE_NAME, sizeof(config.deviceName));
+  config.protocol = DEFAULT_PROTOCOL;
+  config.baud = 0;
+  strlcpy(config.ssid, DEFAULT_CENTER_SSID, sizeof(config.ssid));
+  strlcpy(config.password, DEFAULT_CENTER_PASSWORD, sizeof(config.password));
+  strlcpy(config.centerIp, DEFAULT_CENTER_IP, sizeof(config.centerIp));
+  strlcpy(config.localIp, DEFAULT_LOCAL_IP, sizeof(config.localIp));
+}
+
+// ===== โหลด Config แบบเดิม (ชื่อ@0, protocol@32, baud@33) - false = ไม่มี =====
+bool Config_loadLegacy() {
+  char name[32] = "";       // EEPROM.get() ไม่เขียนค่าถ้าอยู่นอก EEPROM_SIZE
+  uint8_t protocol = 0;
+  uint32_t baud = 0;
+  EEPROM.get(CONFIG_LEGACY_ADDR_NAME, name);
+  EEPROM.get(CONFIG_LEGACY_ADDR_PROTOCOL, protocol);
+  EEPROM.get(CONFIG_LEGACY_ADDR_BAUD, baud);
+  name[sizeof(name) - 1] = '\0';
+  
+  bool hasName = name[0] != '\0' && (uint8_t)name[0] != 0xFF;
+  bool hasProtocol = Protocol_find(protocol) != nullptr;
+  if (!hasName && !hasProtocol) {
+    return false;
+  }
+  
+  Config_defaults();
+  if (hasName) {
+    strlcpy(config.deviceName, name, sizeof(config.deviceName));
+  }
+  if (hasProtocol) {
+    config.protocol = protocol;
+    config.baud = baud;
+  }
+  return true;
+}
+
+// ===== ฟังก์ชันบันทึก Config =====
+void Config_save() {
+  Serial.println("\n💾 บันทึก Config...");
+  
+  ConfigRecord_seal(config);
+  EEPROM.put(CONFIG_ADDR, config);
+  EEPROM.commit();
+  
+  Serial.println("✅ บันทึก Config สำเร็จ!");
+}
+
 // ===== ฟังก์ชันโหลด Config =====
 void Config_begin() {
   EEPROM.begin(EEPROM_SIZE);
   
-  // โหลด Config จาก EEPROM
-  int addr = 0;
-  EEPROM.get(addr, config.deviceName);
+  // โหลด Config จาก EEPROM (CRC ผิด / version อื่น → ค่า Default, ไม่มี record → ลองแบบเดิม)
+  EEPROM.get(CONFIG_ADDR, config);
+  if (!ConfigRecord_isValid(config)) {
+    if (ConfigRecord_isRecord(config)) {
+      Serial.println("⚠️  Config ใน EEPROM เสีย (CRC ผิด) - ใช้ค่าเริ่มต้น");
+      Config_defaults();
+    } else if (Config_loadLegacy()) {
+      Serial.println("🔧 ย้าย Config แบบเดิมเข้า record ใหม่");
+      Config_save();
+    } else {
+      Config_defaults();
+    }
+  }
   
-  // ถ้าไม่มี Config ให้ใช้ค่า Default
-  if (strlen(config.deviceName) == 0 || config.deviceName[0] == 0xFF) {
-    strcpy(config.deviceName, DEFAULT_DEVICE_NAME);
+  if (Protocol_find(config.protocol) == nullptr) {
+    config.protocol = DEFAULT_PROTOCOL;
+    config.baud = 0;
   }
+  if (BaudProbe_indexOf(config.baud) < 0) {
+    config.baud = 0;
+  }
+  const ProtocolInfo* protocol = Protocol_find(config.protocol);
   
   Serial.println("📋 Config ปัจจุบัน:");
   Serial.println("================================================================================");
   Serial.println("WIFI SETTINGS:");
-  Serial.printf("   Center SSID: %s\n", CENTER_SSID);
-  Serial.printf("   Center IP:   %s\n", CENTER_IP);
+  Serial.printf("   Center SSID: %s\n", config.ssid);
+  Serial.printf("   Center IP:   %s\n", config.centerIp);
+  Serial.printf("   Device IP:   %s\n", config.localIp[0] != '\0' ? config.localIp : "DHCP");
+  if (config.channel != 0) {
+    Serial.printf("   Center AP:   %02X:%02X:%02X:%02X:%02X:%02X ch %u (ไม่ต้อง scan)\n",
+                  config.bssid[0], config.bssid[1], config.bssid[2],
+                  config.bssid[3], config.bssid[4], config.bssid[5], config.channel);
+  } else {
+    Serial.println("   Center AP:   ยังไม่รู้ (scan หา)");
+  }
   Serial.println();
   Serial.println("RS232 SETTINGS:");
   
+  Serial.printf("   Protocol:    %s\n", protocol->name);
+  Serial.printf("   Device:      %s\n", protocol->description);
+  if (config.baud != 0) {
+    Serial.printf("   Baud Rate:   %lu (บันทึกไว้)\n", (unsigned long)config.baud);
+  } else {
+    Serial.printf("   Baud Rate:   อัตโนมัติ (เริ่มที่ %lu)\n", (unsigned long)protocol->baud);
+  }
   #ifdef ESP32
     Serial.println("   Board:       ESP32");
-    Serial.println("   Device:      เครื่องวัดความดัน");
-    Serial.println("   Baud Rate:   115200");
     Serial.println("   RX Pin:      GPIO16");
     Serial.println("   TX Pin:      GPIO17");
   #elif defined(ESP8266)
     Serial.println("   Board:       ESP8266");
-    Serial.println("   Device:      เครื่องชั่ง/ส่วนสูง");
-    Serial.println("   Baud Rate:   9600");
     Serial.println("   RX Pin:      D7 (GPIO13)");
     Serial.println("   TX Pin:      D8 (GPIO15)");
   #endif
@@ -112,61 +232,44 @@ void Config_begin() {
   Serial.println();
 }
 
-// ===== ฟังก์ชันบันทึก Config =====
-void Config_save() {
-  Serial.println("\n💾 บันทึก Config...");
-  
-  int addr = 0;
-  EEPROM.put(addr, config.deviceName);
-  EEPROM.commit();
-  
-  Serial.println("✅ บันทึก Config สำเร็จ!");
-}
-
-// ===== ฟังก์ชันเชื่อมต่อ WiFi =====
-bool Config_connectWiFi() {
-  Serial.println("\n🔌 กำลังเชื่อมต่อ WiFi...");
-  Serial.printf("   SSID: %s\n", CENTER_SSID);
-  Serial.printf("   Center IP: %s\n", CENTER_IP);
-  Serial.println();
-  
-  // ตัดการเชื่อมต่อเดิม (ถ้ามี)
-  WiFi.disconnect(true);
-  delay(1000);
+// ===== ฟังก์ชันเริ่มเชื่อมต่อ WiFi =====
+// ไม่รอผล - ผู้เรียกต้องตรวจ WiFi.status() เอง (ดู taskWiFi ใน ESP32_RS232.ino)
+// useCache = ใช้ BSSID/channel ที่จำไว้ (ไม่ scan) → คืน true ถ้าใช้จริง (มีค่าที่จำไว้)
+// ตั้ง IP เองไว้ → ไม่ต้องรอ DHCP (gateway = Center, subnet /24)
+bool Config_beginWiFi(bool useCache) {
+  bool cached = useCache && config.channel != 0;
   
-  // เชื่อมต่อ WiFi
+  // ไม่เขียน SSID/รหัสผ่านลง flash ของ SDK ทุกครั้งที่ begin (ค่าอยู่ใน Config แล้ว)
+  WiFi.persistent(false);
   WiFi.mode(WIFI_STA);
-  WiFi.begin(CENTER_SSID, CENTER_PASSWORD);
-  
-  int attempts = 0;
-  int maxAttempts = 20;  // 20 วินาที
   
-  Serial.print("   รอการเชื่อมต่อ");
-  while (WiFi.status() != WL_CONNECTED && attempts < maxAttempts) {
-    delay(1000);
-    Serial.print(".");
-    attempts++;
+  IPAddress localIp, centerIp;
+  if (config.localIp[0] != '\0' && localIp.fromString(config.localIp) && centerIp.fromString(config.centerIp)) {
+    WiFi.config(localIp, centerIp, IPAddress(255, 255, 255, 0));
+  } else {
+    WiFi.config(IPAddress((uint32_t)0), IPAddress((uint32_t)0), IPAddress((uint32_t)0));   // DHCP
   }
-  Serial.println();
   
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("\n✅ เชื่อมต่อ WiFi สำเร็จ!");
-    Serial.print("   IP: ");
-    Serial.println(WiFi.localIP());
-    Serial.print("   MAC: ");
-    Serial.println(WiFi.macAddress());
-    Serial.print("   RSSI: ");
-    Serial.print(WiFi.RSSI());
-    Serial.println(" dBm\n");
-    return true;
+  if (cached) {
+    WiFi.begin(config.ssid, config.password, config.channel, config.bssid);
   } else {
-    Serial.println("\n❌ ไม่สามารถเชื่อมต่อ WiFi ได้");
-    Serial.println("   กรุณาตรวจสอบ:");
-    Serial.printf("   - Center AP (%s) เปิดอยู่หรือไม่\n", CENTER_SSID);
-    Serial.printf("   - รหัสผ่าน (%s) ถูกต้องหรือไม่\n", CENTER_PASSWORD);
-    Serial.println();
-    return false;
+    WiFi.begin(config.ssid, config.password);
+  }
+  return cached;
+}
+
+// ===== จำ BSSID/channel ของ Center AP ที่เชื่อมต่อได้ =====
+// บันทึกเฉพาะเมื่อเปลี่ยน (เช่น เปลี่ยนเครื่อง Center) - ไม่เขียน flash ทุกครั้งที่ reconnect
+void Config_rememberAp(const uint8_t* bssid, uint8_t channel) {
+  if (bssid == nullptr || channel == 0) {
+    return;
+  }
+  if (config.channel == channel && memcmp(config.bssid, bssid, sizeof(config.bssid)) == 0) {
+    return;
   }
+  memcpy(config.bssid, bssid, sizeof(config.bssid));
+  config.channel = channel;
+  Config_save();
 }
 
 // ===== ฟังก์ชัน Reset Config =====
@@ -0,0 +1,133 @@
+/**
+ * ConfigRecord.h
+ * รูปแบบ Config ที่บันทึกใน EEPROM (record เดียว มี version + CRC-32)
+ *
+ *   magic | version | length | ข้อมูล ... | crc
+ *
+ * - version/length ไม่ตรง หรือ CRC ผิด (เขียนไม่จบ / ไฟดับระหว่าง commit) → ใช้ค่า default
+ * - magic ไม่ตรง = ยังเป็น Config แบบเดิม (ชื่อ@0, protocol@32, baud@33) → Config.h ย้ายให้
+ * - เพิ่ม field: ต่อท้ายก่อน crc แล้วเพิ่ม CONFIG_VERSION (Config.h ย้ายค่าจาก version เก่าเอง)
+ * - ค่า WiFi (SSID / รหัสผ่าน / Center IP / IP ของเครื่อง) แก้ได้จาก Serial Monitor
+ * - BSSID + channel ของ Center AP จำไว้หลังเชื่อมต่อสำเร็จ → ครั้งต่อไปไม่ต้อง scan
+ *
+ * ไม่ขึ้นกับ Arduino - compile บน PC ได้ (ต้องมี strlcpy)
+ */
+
+#ifndef CONFIG_RECORD_H
+#define CONFIG_RECORD_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ===== Configuration =====
+#define CONFIG_MAGIC 0xC3A5      // byte แรก 0xA5 - ชื่ออุปกรณ์ (UTF-8) ของ Config แบบเดิมขึ้นต้นแบบนี้ไม่ได้
+#define CONFIG_VERSION 1
+
+struct ConfigData {
+  uint16_t magic;
+  uint8_t version;
+  uint8_t reserved;
+  uint16_t length;         // sizeof(ConfigData) ตอนบันทึก
+
+  char deviceName[32];     // ชื่ออุปกรณ์ (แสดงใน Center)
+  uint8_t protocol;        // ID ใน InstrumentProtocols
+  uint32_t baud;           // baud rate ที่หาเจอ (0 = ยังไม่รู้ → หาอัตโนมัติ)
+
+  char ssid[33];           // SSID ของ Center AP
+  char password[65];
+  char centerIp[16];       // IP ของ Center (HTTP + UDP)
+  char localIp[16];        // IP ของเครื่องนี้ ("" = DHCP) - ต้องอยู่ใน subnet /24 เดียวกับ Center
+
+  uint8_t bssid[6];        // MAC ของ Center AP ที่เชื่อมต่อได้ล่าสุด
+  uint8_t channel;         // channel ของ Center AP (0 = ไม่รู้ → scan)
+
+  uint32_t crc;            // CRC-32 ของทุก byte ก่อนหน้า
+};
+
+// ===== CRC-32 (IEEE, ไม่ใช้ตาราง - เรียกแค่ตอนเปิดเครื่อง/บันทึก) =====
+inline uint32_t ConfigRecord_crc32(const uint8_t* data, size_t length) {
+  uint32_t crc = 0xFFFFFFFF;
+  for (size_t i = 0; i < length; i++) {
+    crc ^= data[i];
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+inline uint32_t ConfigRecord_checksum(const ConfigData& record) {
+  return ConfigRecord_crc32((const uint8_t*)&record, offsetof(ConfigData, crc));
+}
+
+// ===== ใส่ magic/version/length/crc ก่อนบันทึก =====
+inline void ConfigRecord_seal(ConfigData& record) {
+  record.magic = CONFIG_MAGIC;
+  record.version = CONFIG_VERSION;
+  record.reserved = 0;
+  record.length = sizeof(ConfigData);
+  record.crc = ConfigRecord_checksum(record);
+}
+
+// magic ตรง = เคยบันทึกแบบ record แล้ว (แม้ CRC ผิด) → ไม่ใช่ Config แบบเดิม
+inline bool ConfigRecord_isRecord(const ConfigData& record) {
+  return record.magic == CONFIG_MAGIC;
+}
+
+inline bool ConfigRecord_isValid(const ConfigData& record) {
+  return record.magic == CONFIG_MAGIC && record.version == CONFIG_VERSION &&
+         record.length == sizeof(ConfigData) && record.crc == ConfigRecord_checksum(record);
+}
+
+// ===== ข้อความ → ค่า (ตัดที่ขนาด buffer / ไม่รับข้อความว่าง) =====
+inline bool ConfigRecord_setText(char* field, size_t size, const char* value) {
+  size_t length = strlen(value);
+  if (length == 0 || length >= size) {
+    return false;
+  }
+  strlcpy(field, value, size);
+  return true;
+}
+
+// ===== "a.b.c.d" → 4 bytes =====
+inline bool ConfigRecord_parseIp(const char* text, uint8_t ip[4]) {
+  for (int part = 0; part < 4; part++) {
+    if (*text < '0' || *text > '9') {
+      return false;
+    }
+    uint16_t value = 0;
+    int digits = 0;
+    while (*text >= '0' && *text <= '9') {
+      value = value * 10 + (*text++ - '0');
+      if (++digits > 3 || value > 255) {
+        return false;
+      }
+    }
+    ip[part] = (uint8_t)value;
+    if (part < 3 && *text++ != '.') {
+      return false;
+    }
+  }
+  return *text == '\0';
+}
+
+// ===== IP ของเครื่องใช้ได้หรือไม่: subnet /24 เดียวกับ Center และไม่ชน Center / network / broadcast =====
+inline bool ConfigRecord_isLocalIp(const char* text, const char* centerIp) {
+  uint8_t ip[4], center[4];
+  if (!ConfigRecord_parseIp(text, ip) || !ConfigRecord_parseIp(centerIp, center)) {
+    return false;
+  }
+  if (memcmp(ip, center, 3) != 0) {
+    return false;
+  }
+  return ip[3] != center[3] && ip[3] != 0 && ip[3] != 255;
+}
+
+// ===== ล้าง BSSID/channel ที่จำไว้ (ครั้งต่อไป scan หา AP ใหม่) =====
+inline void ConfigRecord_forgetAp(ConfigData& record) {
+  memset(record.bssid, 0, sizeof(record.bssid));
+  record.channel = 0;
+}
+
+#endif
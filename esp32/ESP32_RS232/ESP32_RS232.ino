@@ -4,32 +4,27 @@
  * อ่านข้อมูล Text/JSON จาก RS232 และส่งไปยัง Center ผ่าน HTTP POST
  * 
  * =============================================================================
- * 🎯 การแบ่งงาน (โดยอัตโนมัติ):
+ * 🎯 เครื่องที่รองรับ (InstrumentProtocol.h - firmware เดียวรองรับทุกเครื่อง):
  * =============================================================================
  * 
- * ✅ ESP32 → เครื่องวัดความดัน (Blood Pressure Monitor)
- *    - Baud: 115200
- *    - Pin: GPIO16 (RX), GPIO17 (TX)
- *    - Buffer: ใหญ่ (รองรับ JSON 400+ bytes)
- *    - ใช้: RS232Reader_BP.h
+ * ✅ bp-json → เครื่องวัดความดัน (Blood Pressure Monitor)
+ *    - Baud: 115200, JSON 400+ bytes ต่อการวัด
+ *    - ใช้ ESP32 (Hardware UART2 buffer ใหญ่)
  * 
- * ✅ ESP8266 → เครื่องชั่ง/ส่วนสูง (Weight Scale & Height Meter)
- *    - Baud: 9600
- *    - Pin: D7/GPIO13 (RX), D8/GPIO15 (TX)
- *    - Buffer: 64 bytes (รองรับ Text สั้นๆ)
- *    - ใช้: RS232Reader_Weight.h
+ * ✅ weight-text → เครื่องชั่ง/ส่วนสูง (Weight Scale & Height Meter)
+ *    - Baud: 9600, Text "W:070.3 H:173.5" / "T365$"
+ *    - ใช้ได้ทั้ง ESP32 และ ESP8266 (SoftwareSerial)
  * 
  * =============================================================================
- * 🔧 วิธีเลือกอุปกรณ์:
+ * 🔧 วิธีเลือกเครื่อง:
  * =============================================================================
  * 
- * วิธีที่ 1: เลือก Board ใน Arduino IDE (แนะนำ)
- *   • ESP32 Dev Module → จะใช้ RS232Reader_BP.h อัตโนมัติ
- *   • NodeMCU 1.0 → จะใช้ RS232Reader_Weight.h อัตโนมัติ
- * 
- * วิธีที่ 2: แก้โค้ดด้านล่าง (กรณีต้องการสลับ)
- *   • Uncomment #include ที่ต้องการ
- *   • Comment #include ที่ไม่ใช้
+ *   • ค่าเริ่มต้นตามบอร์ด: ESP32 = bp-json, ESP8266 = weight-text
+ *   • พิมพ์ 'protocol' ใน Serial Monitor เพื่อดูรายการ
+ *     'protocol <ชื่อ>' เพื่อเลือก (บันทึกใน EEPROM แล้ว restart)
+ *   • เพิ่มเครื่องใหม่: เขียน struct แบบ WeightTextProtocol.h แล้วเพิ่มใน InstrumentProtocols (ไม่ต้องแยก firmware)
+ *   • Baud rate หาอัตโนมัติ (1200-115200) แล้วบันทึกไว้ - 'baud' ดูสถานะ,
+ *     'baud <rate>' ตั้งเอง, 'baud auto' หาใหม่
  * 
  * =============================================================================
  * ฮาร์ดแวร์:
@@ -78,20 +73,16 @@
 #endif
 
 #include "Config.h"
+#include "Log.h"
+#include "Histogram.h"
+#include "Uplink.h"
+#include "WireLink.h"
+#include "Outbox.h"
+#include "Journal.h"
+#include "Scheduler.h"
 
-// =============================================================================
-// 🔧 เลือกอุปกรณ์ (แก้ได้ถ้าต้องการสลับ)
-// =============================================================================
-
-#ifdef ESP32
-  // ✅ ESP32 → เครื่องวัดความดัน (Baud: 115200, JSON 400+ bytes)
-  #include "RS232Reader_BP.h"
-#elif defined(ESP8266)
-  // ✅ ESP8266 → เครื่องชั่ง (Baud: 9600, Text < 64 bytes)
-  #include "RS232Reader_Weight.h"
-#endif
-
-// =============================================================================
+// RS232 - โปรโตคอลเลือกจาก Config (คำสั่ง "protocol" ใน Serial Monitor)
+#include "RS232Reader.h"
 
 // ===== LED & Button Pins =====
 #ifdef ESP32
@@ -107,474 +98,995 @@ int httpPostCount = 0;
 unsigned long lastLedBlink = 0;
 bool ledBlinkState = false;
 
+// ===== LED Pattern (กระพริบเร็วแบบไม่ใช้ delay) =====
+int ledPatternToggles = 0;            // จำนวนครั้งที่ต้องสลับไฟที่เหลือ
+unsigned long ledPatternInterval = 100;
+unsigned long ledPatternLast = 0;
+
 // ===== Auto-Reconnect Variables =====
-unsigned long lastWiFiCheck = 0;
-const unsigned long WIFI_CHECK_INTERVAL = 10000;  // ตรวจสอบทุก 10 วินาที
+// WiFi เป็น state machine: UP → (หลุด) → CONNECTING → (หมดเวลา) → BACKOFF → CONNECTING ...
+enum WiFiLinkState {
+  WIFI_LINK_CONNECTING,
+  WIFI_LINK_UP,
+  WIFI_LINK_BACKOFF
+};
+
+WiFiLinkState wifiLinkState = WIFI_LINK_CONNECTING;
+unsigned long wifiLinkDeadline = 0;
+const unsigned long WIFI_CHECK_INTERVAL = 10000;    // แสดงสถานะทุก 10 วินาที
+const unsigned long WIFI_BOOT_TIMEOUT = 20000;      // รอเชื่อมต่อครั้งแรก 20 วินาที
+const unsigned long WIFI_CONNECT_TIMEOUT = 10000;   // รอ reconnect 10 วินาที
+const unsigned long WIFI_CACHED_TIMEOUT = 3000;     // ใช้ BSSID/channel ที่จำไว้แล้วไม่ติด → scan ทันที
+const unsigned long WIFI_RETRY_INTERVAL = 5000;     // พักก่อนลองใหม่ 5 วินาที
 int wifiReconnectCount = 0;
-bool isReconnecting = false;
-
-// ===== Buffer สำหรับเก็บข้อมูล Weight/Height (ESP8266) =====
-#ifdef ESP8266
-float bufferedWeight = 0;
-float bufferedHeight = 0;
-bool hasBufferedWeight = false;
-bool hasBufferedHeight = false;
-unsigned long lastBufferTime = 0;
-const unsigned long BUFFER_TIMEOUT = 5000;  // timeout 5 วินาที
+
+// ===== เวลาเชื่อมต่อ (แสดงในสถานะ + ส่งไปกับ heartbeat) =====
+bool wifiUseCache = true;              // false = ครั้งก่อนใช้ BSSID/channel ที่จำไว้ไม่ติด
+bool wifiCachedAttempt = false;        // ครั้งนี้ใช้ BSSID/channel ที่จำไว้
+unsigned long wifiAttemptStart = 0;
+unsigned long wifiDropAt = 0;          // 0 = ไม่ได้หลุด (เปิดเครื่อง / ตั้งค่าใหม่)
+unsigned long wifiConnectTime = 0;     // WiFi.begin() → เชื่อมต่อได้ ครั้งล่าสุด (ms)
+unsigned long wifiReconnectTime = 0;   // รู้ว่าหลุด → เชื่อมต่อได้ ครั้งล่าสุด (ms)
+unsigned long firstUplinkTime = 0;     // เปิดเครื่อง → Center ตอบรับครั้งแรก (ms, 0 = ยังไม่เคย)
+
+// ===== Uplink Retry (Backoff) =====
+const unsigned long UPLINK_BACKOFF_MIN = 1000;
+const unsigned long UPLINK_BACKOFF_MAX = 30000;
+unsigned long uplinkNextAttempt = 0;
+unsigned long uplinkBackoff = UPLINK_BACKOFF_MIN;
+unsigned long uplinkRetryCount = 0;
+
+// ===== Uplink Batch (รวมหลายรายการใน 1 request) =====
+#ifdef ESP32
+  const int UPLINK_BATCH_MAX = 8;
+#else
+  const int UPLINK_BATCH_MAX = 4;     // ESP8266 มี RAM น้อยกว่า
 #endif
+bool uplinkBatchSupported = true;     // false เมื่อ Center ตอบ 404
+int uplinkSingleRemaining = 0;        // batch ถูกปฏิเสธ → ส่งทีละรายการอีกกี่ครั้ง
+unsigned long uplinkBatchCount = 0;
 
-// ===== ฟังก์ชันตรวจสอบและ Reconnect WiFi =====
-bool ensureWiFiConnected() {
-  if (WiFi.status() == WL_CONNECTED) {
-    isReconnecting = false;
-    return true;
-  }
-  
-  if (isReconnecting) {
-    Serial.println("   ⏳ กำลัง reconnect WiFi อยู่...");
-    return false;
-  }
+// ===== สถิติการสร้าง Payload (JSON หรือ Binary ตาม UPLINK_BINARY) =====
+unsigned long payloadBuildCount = 0;
+unsigned long payloadBuildTimeTotal = 0;   // us
+unsigned long payloadBytesTotal = 0;
+
+// ===== Journal Replay (ส่งข้อมูลค้างใน flash) =====
+// ส่งซ้ำได้ครั้งละ 1 รายการทุก 250 ms และเฉพาะตอนคิวว่างเกินครึ่ง → ข้อมูลใหม่ไม่ต้องรอนาน
+const unsigned long JOURNAL_REPLAY_INTERVAL = 250;
+const int JOURNAL_REPLAY_SCAN = 8;     // ตรวจ slot ได้สูงสุดต่อรอบ (slot ที่ส่งแล้วจะถูกข้าม)
+unsigned long journalReplayCount = 0;
+
+// ===== RS232 Task (วัดช่วงห่างระหว่างการเรียก RS232_loop) =====
+unsigned long rs232LastPoll = 0;
+unsigned long rs232MaxPollGap = 0;        // ช่วงห่างนานสุดในรอบรายงานนี้
+unsigned long rs232MaxPollGapEver = 0;    // ช่วงห่างนานสุดตั้งแต่เปิดเครื่อง
+unsigned long loopCount = 0;
+
+// ===== Latency แต่ละช่วง (Histogram.h - สรุปส่งไปกับ heartbeat) =====
+Histogram histFrameMs;       // RS232 byte แรก → ครบเฟรม/บรรทัด
+Histogram histParseUs;       // parse เฟรม
+Histogram histHandleUs;      // RS232_loop ที่ได้ reading (parse + log + สร้าง payload + เข้าคิว)
+Histogram histDeliverMs;     // เข้าคิว → Center ตอบรับ (HTTP 200 / UDP ACK)
+uint32_t heapMinFree = 0;    // ESP8266: ค่าต่ำสุดที่สุ่มเห็น (ESP32 ใช้ค่าจาก SDK)
+
+// ===== Heartbeat (POST /api/status พร้อมสรุป metrics) =====
+const unsigned long HEARTBEAT_INTERVAL = 30000;
+const unsigned long PRESENCE_INTERVAL = 3000;   // UDP heartbeat 18 bytes (Center: DEVICE_TIMEOUT 10 วินาที)
+
+// ===== Serial Command Buffer =====
+char commandBuffer[96];   // "pass <รหัสผ่าน 64 ตัว>"
+int commandLength = 0;
+
+// ===== WiFi พร้อมส่งข้อมูลหรือไม่ =====
+bool isWiFiUp() {
+  return wifiLinkState == WIFI_LINK_UP;
+}
+
+// ===== เริ่มเชื่อมต่อ WiFi (ไม่รอผล) - ใช้ BSSID/channel ที่จำไว้ถ้ามี =====
+void startWiFiAttempt(unsigned long now, unsigned long timeout) {
+  ConfigData* cfg = Config_get();
+  wifiCachedAttempt = Config_beginWiFi(wifiUseCache);
+  wifiAttemptStart = now;
+  LOG_I("🔌 เชื่อมต่อ %s (%s, IP: %s)\n", cfg->ssid,
+        wifiCachedAttempt ? "BSSID/channel ที่จำไว้" : "scan",
+        cfg->localIp[0] != '\0' ? cfg->localIp : "DHCP");
   
-  Serial.println("\n⚠️  WiFi หลุดการเชื่อมต่อ!");
-  Serial.println("🔄 พยายาม Reconnect...");
-  isReconnecting = true;
-  wifiReconnectCount++;
+  wifiLinkState = WIFI_LINK_CONNECTING;
+  wifiLinkDeadline = now + timeout;
+}
+
+// ===== เริ่มเชื่อมต่อ WiFi ใหม่ (ไม่รอผล) =====
+void startWiFiReconnect(unsigned long now) {
+  LOG_I("🔄 พยายาม Reconnect...\n");
   
   // กระพริบ LED เร็วๆ เพื่อแสดงว่ากำลัง reconnect
-  for (int i = 0; i < 5; i++) {
-    digitalWrite(GREEN_LED_PIN, HIGH);
-    delay(50);
-    digitalWrite(GREEN_LED_PIN, LOW);
-    delay(50);
-  }
+  startLEDPattern(5, 50);
+  
+  // connection เดิมใช้ไม่ได้แล้วหลัง WiFi หลุด
+  Uplink_close();
+  WireLink_reset();
   
   WiFi.disconnect();
-  delay(100);
-  WiFi.begin(CENTER_SSID, CENTER_PASSWORD);
+  startWiFiAttempt(now, WIFI_CONNECT_TIMEOUT);
+}
+
+// ===== Task: ตรวจสอบและ Reconnect WiFi =====
+void taskWiFi(unsigned long now) {
+  bool connected = (WiFi.status() == WL_CONNECTED);
+  
+  switch (wifiLinkState) {
+    case WIFI_LINK_UP:
+      if (!connected) {
+        LOG_W("\n⚠️  WiFi หลุดการเชื่อมต่อ!\n");
+        wifiReconnectCount++;
+        wifiDropAt = now;
+        startWiFiReconnect(now);
+      }
+      break;
+  
+    case WIFI_LINK_CONNECTING:
+      if (connected) {
+        wifiConnectTime = now - wifiAttemptStart;
+        LOG_I("\n✅ เชื่อมต่อ WiFi สำเร็จ! (%lu ms, %s)\n", wifiConnectTime,
+              wifiCachedAttempt ? "BSSID/channel ที่จำไว้" : "scan");
+        LOG_I("   IP: %s\n", WiFi.localIP().toString().c_str());
+        LOG_I("   RSSI: %d dBm | channel %d\n", WiFi.RSSI(), (int)WiFi.channel());
+        if (wifiDropAt != 0) {
+          wifiReconnectTime = now - wifiDropAt;
+          wifiDropAt = 0;
+          LOG_I("   Reconnect ครั้งที่: %d (หลุด → ต่อได้ %lu ms)\n", wifiReconnectCount, wifiReconnectTime);
+        }
+        wifiUseCache = true;
+        Config_rememberAp(WiFi.BSSID(), (uint8_t)WiFi.channel());
+        if (Outbox_size() > 0) {
+          LOG_I("   📦 มีข้อมูลรอส่ง %d รายการ\n", Outbox_size());
+        }
+        wifiLinkState = WIFI_LINK_UP;
+        lastLedBlink = now;
+        uplinkNextAttempt = now;
+        uplinkBackoff = UPLINK_BACKOFF_MIN;
+      } else if (wifiCachedAttempt && now - wifiAttemptStart >= WIFI_CACHED_TIMEOUT) {
+        // Center เปลี่ยน channel / เปลี่ยนเครื่อง → ค่าที่จำไว้ใช้ไม่ได้ scan หาใหม่ทันที
+        LOG_W("⚠️  เชื่อมต่อด้วย BSSID/channel ที่จำไว้ไม่ได้ - scan หา AP\n");
+        wifiUseCache = false;
+        WiFi.disconnect();
+        startWiFiAttempt(now, WIFI_CONNECT_TIMEOUT);
+      } else if ((long)(now - wifiLinkDeadline) >= 0) {
+        LOG_E("\n❌ Reconnect ล้มเหลว - จะลองใหม่อีกครั้ง...\n");
+        wifiLinkState = WIFI_LINK_BACKOFF;
+        wifiLinkDeadline = now + WIFI_RETRY_INTERVAL;
+      }
+      break;
   
-  // รอ 10 วินาที
-  int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < 20) {
-    delay(500);
-    Serial.print(".");
-    attempts++;
+    case WIFI_LINK_BACKOFF:
+      if (connected) {
+        // auto-reconnect ของ WiFi stack ต่อได้เองระหว่างพัก
+        wifiLinkState = WIFI_LINK_CONNECTING;
+      } else if ((long)(now - wifiLinkDeadline) >= 0) {
+        startWiFiReconnect(now);
+      }
+      break;
+  }
+}
+
+// ===== เพิ่มข้อมูลเข้าคิวรอส่งไปยัง Center (ใช้ร่วมกันทุกประเภท) =====
+// ไม่ส่งทันที - บันทึกลง Journal ก่อน แล้ว taskUplink จะทยอยส่งให้
+// ข้อมูลจึงไม่หายระหว่าง WiFi หลุด หรือไฟดับก่อนส่งสำเร็จ
+bool queueToCenter(const char* payload, size_t length, const char* label) {
+  if (length >= OUTBOX_PAYLOAD_SIZE) {
+    LOG_E("❌ ข้อมูล %s ใหญ่เกิน %d bytes - ไม่สามารถเข้าคิวได้\n", label, OUTBOX_PAYLOAD_SIZE);
+    return false;
   }
-  Serial.println();
   
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("✅ Reconnect สำเร็จ!");
-    Serial.printf("   IP: %s\n", WiFi.localIP().toString().c_str());
-    Serial.printf("   Reconnect ครั้งที่: %d\n", wifiReconnectCount);
-    isReconnecting = false;
-    lastLedBlink = millis();
+  uint32_t seq = Journal_append(payload, length, label);
+  
+  // คิวใน RAM เต็ม → เก็บไว้ใน flash อย่างเดียว taskJournalReplay จะดึงมาส่งทีหลัง
+  if (seq != 0 && Outbox_isFull()) {
+    LOG_I("💾 คิวเต็ม - เก็บ %s ไว้ใน flash (seq %lu)\n", label, (unsigned long)seq);
     return true;
-  } else {
-    Serial.println("❌ Reconnect ล้มเหลว - จะลองใหม่อีกครั้ง...");
-    isReconnecting = false;
-    return false;
   }
+  
+  Outbox_push(payload, length, label, seq, millis());
+  LOG_I("📦 เข้าคิวรอส่ง: %s (คิว %d/%d)\n", label, Outbox_size(), OUTBOX_CAPACITY);
+  if (!isWiFiUp()) {
+    LOG_W("   ⚠️  WiFi ไม่ได้เชื่อมต่อ - จะส่งเมื่อเชื่อมต่อได้\n");
+  }
+  return true;
 }
 
-// ===== ฟังก์ชันส่งข้อมูล BP พร้อม ID Card (มี Retry) =====
-void sendBPData(String jsonData) {
-  // ตรวจสอบและ reconnect WiFi ถ้าจำเป็น
-  if (!ensureWiFiConnected()) {
-    Serial.println("⚠️  WiFi ไม่ได้เชื่อมต่อ - ข้ามการส่งข้อมูล");
-    return;
+// ===== Center ตอบรับครั้งแรกหลังเปิดเครื่อง =====
+void noteCenterReached() {
+  if (firstUplinkTime == 0) {
+    firstUplinkTime = millis();
+    LOG_I("⏱️  เปิดเครื่อง → Center ตอบรับครั้งแรก: %lu ms\n", firstUplinkTime);
+  }
+}
+
+// ===== Center ตอบรับแล้ว: บันทึกเวลาตั้งแต่อ่านได้จนส่งถึง =====
+void noteDelivered(const OutboxEntry* entry) {
+  noteCenterReached();
+  if (entry->queuedAt != 0) {
+    Histogram_add(histDeliverMs, millis() - entry->queuedAt);
+  }
+}
+
+// ===== ตั้งเวลาส่งใหม่หลังส่งไม่สำเร็จ (backoff) =====
+void scheduleUplinkRetry(int httpCode, const char* label, int attempts) {
+  if (httpCode > 0) {
+    LOG_E("❌ HTTP Error: %d\n", httpCode);
+    if (uplinkResponse[0] != '\0') {
+      LOG_D("   Response: %s\n", uplinkResponse);
+    }
+  } else {
+    LOG_E("❌ การเชื่อมต่อล้มเหลว\n");
+    LOG_I("   Error: %s\n", HTTPClient::errorToString(httpCode).c_str());
+    LOG_I("   💡 Center IP: %s พร้อมใช้งานหรือไม่\n", Config_get()->centerIp);
   }
   
-  // Parse JSON ที่ได้จาก RS232Reader_BP.h
-  #ifdef ESP32
-    StaticJsonDocument<512> inDoc;
-  #else
-    StaticJsonDocument<300> inDoc;  // ESP8266 ใช้ buffer เล็กกว่า
-  #endif
+  uplinkRetryCount++;
+  uplinkNextAttempt = millis() + uplinkBackoff;
+  LOG_I("   🔄 จะลองส่ง %s ใหม่ใน %lu ms (ครั้งที่ %d)\n",
+        label, uplinkBackoff, attempts + 1);
+  uplinkBackoff = min(uplinkBackoff * 2, UPLINK_BACKOFF_MAX);
+}
+
+// ===== ส่งรายการแรกในคิว (POST /api/vitals) =====
+void sendOutboxSingle() {
+  OutboxEntry* entry = Outbox_peek();
+  int httpCode = Uplink_post("/api/vitals", entry->payload, entry->length);
+  entry->attempts++;
   
-  DeserializationError error = deserializeJson(inDoc, jsonData);
+  if (httpCode == 200) {
+    httpPostCount++;
+    noteDelivered(entry);
+    LOG_I("✅ ส่งข้อมูล %s #%d สำเร็จ", entry->label, httpPostCount);
+    if (entry->attempts > 1) {
+      LOG_I(" (หลัง retry %d ครั้ง)", entry->attempts - 1);
+    }
+    LOG_I("\n");
+    Journal_ack(entry->seq);
+    Outbox_pop();
+    blinkLEDOnce();
+    uplinkBackoff = UPLINK_BACKOFF_MIN;
+    return;
+  }
   
-  if (error) {
-    Serial.println("❌ JSON Parse Error: " + String(error.c_str()));
+  if (httpCode >= 400 && httpCode < 500) {
+    // Center ไม่รับข้อมูลนี้ - ส่งซ้ำก็ไม่ผ่าน → ทิ้ง
+    LOG_E("❌ HTTP Error: %d - ทิ้งข้อมูล %s\n", httpCode, entry->label);
+    if (uplinkResponse[0] != '\0') {
+      LOG_D("   Response: %s\n", uplinkResponse);
+    }
+    Journal_ack(entry->seq);
+    Outbox_pop();
     return;
   }
   
-  ConfigData* cfg = Config_get();
+  scheduleUplinkRetry(httpCode, entry->label, entry->attempts);
+}
+
+// ===== ส่งหลายรายการในคิวรวมเป็น request เดียว (POST /api/vitals/batch) =====
+void sendOutboxBatch() {
+  static char body[UPLINK_BATCH_MAX * (OUTBOX_PAYLOAD_SIZE + 1) + 2];
+  size_t length = 0;
+  int count = 0;
   
-  // สร้าง URL
-  String url = String("http://") + CENTER_IP + "/api/vitals";
+  body[length++] = '[';
+  while (count < UPLINK_BATCH_MAX && count < Outbox_size()) {
+    OutboxEntry* entry = Outbox_at(count);
+    if (WireLink_isPacked(entry->payload, entry->length)) {
+      break;   // รายการ Binary ส่งทาง UDP
+    }
+    if (count > 0) {
+      body[length++] = ',';
+    }
+    memcpy(body + length, entry->payload, entry->length);
+    length += entry->length;
+    entry->attempts++;
+    count++;
+  }
+  body[length++] = ']';
   
-  // สร้าง JSON Payload สำหรับเครื่องวัดความดัน
-  #ifdef ESP32
-    StaticJsonDocument<512> doc;
-  #else
-    StaticJsonDocument<300> doc;
-  #endif
-  doc["deviceId"] = WiFi.macAddress();
-  doc["deviceName"] = cfg->deviceName;
-  doc["macAddress"] = WiFi.macAddress();
-  doc["deviceType"] = "blood_pressure";
+  int httpCode = Uplink_post("/api/vitals/batch", body, length);
   
-  // ส่ง ID Card ด้วย (สำคัญ!)
-  if (inDoc.containsKey("idcard")) {
-    doc["idcard"] = inDoc["idcard"].as<String>();
-  } else {
-    doc["idcard"] = "";
+  if (httpCode == 404) {
+    // Center รุ่นเก่าไม่มี /api/vitals/batch → ส่งทีละรายการตลอด
+    LOG_I("ℹ️  Center ไม่รองรับ batch - เปลี่ยนเป็นส่งทีละรายการ\n");
+    uplinkBatchSupported = false;
+    return;
   }
   
-  // สร้าง nested data object
-  JsonObject dataObj = doc.createNestedObject("data");
-  
-  if (inDoc.containsKey("bp")) {
-    dataObj["bp"] = inDoc["bp"].as<int>();
+  if (httpCode >= 400 && httpCode < 500) {
+    // มีรายการที่ Center ไม่รับ → ส่งทีละรายการเพื่อทิ้งเฉพาะรายการที่เสีย
+    LOG_W("⚠️  Batch ถูกปฏิเสธ (HTTP %d) - ส่ง %d รายการนี้ทีละรายการ\n", httpCode, count);
+    uplinkSingleRemaining = count;
+    return;
   }
-  if (inDoc.containsKey("bp2")) {
-    dataObj["bp2"] = inDoc["bp2"].as<int>();
+  
+  if (httpCode != 200) {
+    scheduleUplinkRetry(httpCode, "batch", Outbox_peek()->attempts);
+    return;
   }
-  if (inDoc.containsKey("pulse")) {
-    dataObj["pulse"] = inDoc["pulse"].as<int>();
+  
+  // ผลรายรายการ: results[i] = 1 รับ, 0 ไม่รับ (ทิ้ง)
+  // รายการที่ไม่มีใน results (Center หยุดกลางทาง) ยังอยู่ในคิวรอส่งรอบหน้า
+  StaticJsonDocument<256> response;
+  JsonArray results;
+  int done = count;
+  if (!deserializeJson(response, (const char*)uplinkResponse)) {
+    results = response["results"];
+    if (!results.isNull() && (int)results.size() < done) {
+      done = results.size();
+    }
   }
   
-  dataObj["timestamp"] = millis();
+  if (done == 0) {
+    scheduleUplinkRetry(httpCode, "batch", Outbox_peek()->attempts);
+    return;
+  }
   
-  String payload;
-  serializeJson(doc, payload);
-  
-  Serial.println("\n📤 ส่งข้อมูล BP ไปยัง Center:");
-  serializeJsonPretty(doc, Serial);
-  Serial.println();
-  
-  // ส่ง HTTP POST พร้อม Retry (3 ครั้ง)
-  bool success = false;
-  int retryCount = 0;
-  const int MAX_RETRIES = 3;
-  
-  while (!success && retryCount < MAX_RETRIES) {
-    if (retryCount > 0) {
-      Serial.printf("   🔄 Retry ครั้งที่ %d/%d...\n", retryCount, MAX_RETRIES - 1);
-      delay(1000);  // รอ 1 วินาทีก่อน retry
-      
-      // ตรวจสอบ WiFi อีกครั้งก่อน retry
-      if (!ensureWiFiConnected()) {
-        Serial.println("   ⚠️  WiFi ยังไม่พร้อม - ข้าม retry");
-        break;
-      }
-    }
-    
-    HTTPClient http;
-    WiFiClient client;
-    http.begin(client, url);
-    
-    http.addHeader("Content-Type", "application/json");
-    http.setTimeout(5000);
-    
-    int httpCode = http.POST(payload);
-    
-    if (httpCode == 200) {
+  int accepted = 0;
+  for (int i = 0; i < done; i++) {
+    OutboxEntry* entry = Outbox_peek();
+    if (results.isNull() || results[i] == 1) {
+      accepted++;
       httpPostCount++;
-      Serial.printf("✅ ส่งข้อมูล BP #%d สำเร็จ", httpPostCount);
-      if (retryCount > 0) {
-        Serial.printf(" (หลัง retry %d ครั้ง)", retryCount);
-      }
-      Serial.println();
-      blinkLEDOnce();
-      success = true;
-    } else if (httpCode > 0) {
-      Serial.printf("❌ HTTP Error: %d\n", httpCode);
-      String response = http.getString();
-      if (response.length() > 0) {
-        Serial.println("   Response: " + response);
-      }
+      noteDelivered(entry);
     } else {
-      Serial.println("❌ การเชื่อมต่อล้มเหลว");
-      Serial.printf("   Error: %s\n", http.errorToString(httpCode).c_str());
+      LOG_E("   ❌ Center ไม่รับ %s - ทิ้ง\n", entry->label);
     }
-    
-    http.end();
-    retryCount++;
+    Journal_ack(entry->seq);
+    Outbox_pop();
+  }
+  
+  uplinkBatchCount++;
+  LOG_I("✅ ส่ง batch %d รายการสำเร็จ (รับ %d, ไม่รับ %d) #%d\n",
+        count, accepted, done - accepted, httpPostCount);
+  blinkLEDOnce();
+  uplinkBackoff = UPLINK_BACKOFF_MIN;
+}
+
+// ===== ส่งรายการแรกในคิวแบบ Binary (UDP) =====
+// WireLink_poll ไม่ block - ถูกเรียกซ้ำทุกรอบจนได้ ACK หรือหมดเวลา
+void sendOutboxWire(OutboxEntry* entry) {
+  WireLinkResult result = WireLink_poll((const uint8_t*)entry->payload, entry->length, entry->seq);
+  if (result == WIRE_LINK_PENDING) {
+    return;
+  }
+  entry->attempts++;
+  
+  if (result == WIRE_LINK_DELIVERED) {
+    httpPostCount++;
+    noteDelivered(entry);
+    LOG_I("✅ ส่งข้อมูล %s #%d สำเร็จ (UDP)", entry->label, httpPostCount);
+    if (entry->attempts > 1) {
+      LOG_I(" (หลัง retry %d ครั้ง)", entry->attempts - 1);
+    }
+    LOG_I("\n");
+    Journal_ack(entry->seq);
+    Outbox_pop();
+    blinkLEDOnce();
+    uplinkBackoff = UPLINK_BACKOFF_MIN;
+    return;
   }
   
-  if (!success) {
-    Serial.printf("❌ ส่งข้อมูล BP ล้มเหลวหลังพยายาม %d ครั้ง\n", MAX_RETRIES);
-    Serial.println("   💡 กรุณาตรวจสอบ:");
-    Serial.printf("      - Center IP: %s พร้อมใช้งานหรือไม่\n", CENTER_IP);
-    Serial.println("      - Network connection");
+  if (result == WIRE_LINK_REJECTED) {
+    LOG_E("❌ Center ไม่รับข้อมูล %s - ทิ้ง\n", entry->label);
+    Journal_ack(entry->seq);
+    Outbox_pop();
+    return;
   }
+  
+  LOG_E("❌ ไม่ได้รับ ACK จาก Center (UDP)\n");
+  scheduleUplinkRetry(HTTPC_ERROR_READ_TIMEOUT, entry->label, entry->attempts);
 }
 
-// ===== ฟังก์ชันส่งข้อมูลแต่ละ Field (สำหรับ Weight/Height/Temp) พร้อม Retry =====
-void sendHTTPPost(String deviceType, float value) {
-  // ตรวจสอบและ reconnect WiFi ถ้าจำเป็น
-  if (!ensureWiFiConnected()) {
-    Serial.println("⚠️  WiFi ไม่ได้เชื่อมต่อ - ข้ามการส่งข้อมูล");
+// ===== Task: ส่งข้อมูลในคิวไปยัง Center =====
+// ส่งผ่าน Uplink (keep-alive) - ถ้าล้มเหลวจะรอแบบ backoff (1, 2, 4, ... 30 วินาที)
+// ถ้ามีหลายรายการค้าง (เช่นหลัง WiFi กลับมา / ส่งซ้ำจาก Journal) จะรวมเป็น batch เดียว
+void taskUplink(unsigned long now) {
+  if (Outbox_size() == 0 || !isWiFiUp()) {
+    return;
+  }
+  if ((long)(now - uplinkNextAttempt) < 0) {
     return;
   }
   
-  ConfigData* cfg = Config_get();
+  OutboxEntry* head = Outbox_peek();
+  if (WireLink_isPacked(head->payload, head->length)) {
+    sendOutboxWire(head);
+    return;
+  }
   
-  // สร้าง URL
-  String url = String("http://") + CENTER_IP + "/api/vitals";
+  if (Outbox_size() > 1 && uplinkBatchSupported && uplinkSingleRemaining == 0) {
+    sendOutboxBatch();
+    return;
+  }
   
-  // สร้าง JSON Payload
-  #ifdef ESP32
-    StaticJsonDocument<512> doc;
-  #else
-    StaticJsonDocument<250> doc;  // ESP8266: weight/height/temp ใช้ buffer เล็ก
-  #endif
-  doc["deviceId"] = WiFi.macAddress();
+  if (uplinkSingleRemaining > 0) {
+    uplinkSingleRemaining--;
+  }
+  sendOutboxSingle();
+}
+
+// ===== Task: ส่งข้อมูลค้างใน Journal ซ้ำ (เรียงตาม seq) =====
+void taskJournalReplay(unsigned long now) {
+  if (!Journal_hasBacklog() || !isWiFiUp() || Outbox_size() >= OUTBOX_CAPACITY / 2) {
+    return;
+  }
+  
+  static char payload[JOURNAL_PAYLOAD_SIZE + 1];
+  char label[JOURNAL_LABEL_SIZE];
+  uint16_t length;
+  
+  for (int i = 0; i < JOURNAL_REPLAY_SCAN && Journal_hasBacklog(); i++) {
+    uint32_t seq = Journal_nextBacklog(payload, length, label);
+    if (seq == 0 || Outbox_contains(seq)) {
+      continue;   // ส่งแล้ว หรืออยู่ในคิวแล้ว
+    }
+    
+    Outbox_push(payload, length, label, seq);
+    journalReplayCount++;
+    LOG_I("💾 ส่งซ้ำจาก flash: %s (seq %lu, ค้างอีก %d)\n",
+          label, (unsigned long)seq, Journal_getPendingCount() - Outbox_size());
+    return;
+  }
+}
+
+// ===== บันทึกเวลา/ขนาดของการสร้าง Payload =====
+void notePayloadBuilt(unsigned long start, size_t length) {
+  payloadBuildTimeTotal += micros() - start;
+  payloadBytesTotal += length;
+  payloadBuildCount++;
+}
+
+// ===== เพิ่ม reading แบบ Binary เข้าคิว (UPLINK_BINARY) =====
+// ข้อมูลอุปกรณ์ไม่อยู่ใน payload - WireLink ส่งให้ครั้งเดียวตอนเริ่ม session
+void queueWireReading(WireReading& reading, const char* label, unsigned long start) {
+  reading.timestamp = millis();
+  
+  uint8_t packed[WIRE_READING_SIZE];
+  Wire_packReading(packed, reading);
+  notePayloadBuilt(start, sizeof(packed));
+  
+  queueToCenter((const char*)packed, sizeof(packed), label);
+}
+
+// ===== MAC ของอุปกรณ์ (ใช้เป็น deviceId) =====
+// MAC ไม่เปลี่ยน → อ่านครั้งเดียวแล้วเก็บไว้
+const char* getDeviceMac() {
+  static char mac[18] = "";
+  if (mac[0] == '\0') {
+    strlcpy(mac, WiFi.macAddress().c_str(), sizeof(mac));
+  }
+  return mac;
+}
+
+// ===== ใส่ข้อมูลอุปกรณ์ใน Payload =====
+// seq = seq ที่ Journal จะให้กับ payload นี้ใน queueToCenter() (Center ใช้กรอง reading ซ้ำ)
+// epoch เปลี่ยนเมื่อ seq เริ่มนับใหม่ → Center เริ่ม window กรองซ้ำใหม่
+void fillDeviceFields(JsonDocument& doc, const char* deviceType) {
+  ConfigData* cfg = Config_get();
+  const char* mac = getDeviceMac();
+  
+  doc["deviceId"] = mac;
   doc["deviceName"] = cfg->deviceName;
-  doc["macAddress"] = WiFi.macAddress();
+  doc["macAddress"] = mac;
   doc["deviceType"] = deviceType;
-  doc["idcard"] = "";  // RS232 ไม่มีข้อมูล ID Card
+  
+  uint32_t seq = Journal_peekNextSeq();
+  if (seq != 0) {
+    doc["seq"] = seq;
+    doc["epoch"] = Journal_getEpoch();
+  }
+}
+
+// ===== deviceType ของ /api/vitals ตามชนิด reading =====
+const char* getDeviceType(uint8_t kind) {
+  switch (kind) {
+    case WIRE_KIND_BLOOD_PRESSURE: return "blood_pressure";
+    case WIRE_KIND_WEIGHT_HEIGHT:  return "weight_height";
+    case WIRE_KIND_WEIGHT:         return "weight";
+    case WIRE_KIND_HEIGHT:         return "height";
+    default:                       return "temp";
+  }
+}
+
+// ===== ฟังก์ชันส่งข้อมูลที่อ่านได้ (ทุกโปรโตคอล - ดู InstrumentProtocol.h) =====
+// JSON ใช้รูปแบบเดียวกับที่ Center แปลงจาก Binary → PC เห็นข้อมูลเหมือนกันทั้งสองทาง
+void sendReading(const WireReading& reading) {
+  unsigned long start = micros();
+  const char* deviceType = getDeviceType(reading.kind);
+  const char* label = reading.kind == WIRE_KIND_BLOOD_PRESSURE ? "BP" :
+                      reading.kind == WIRE_KIND_WEIGHT_HEIGHT ? "Weight+Height" : deviceType;
+  
+  if (UPLINK_BINARY) {
+    WireReading wire = reading;
+    LOG_I("\n📤 ส่งข้อมูล %s ไปยัง Center (Binary)\n", label);
+    queueWireReading(wire, label, start);
+    return;
+  }
+  
+  // สร้าง JSON Payload (serialize ครั้งเดียวจาก struct)
+  StaticJsonDocument<384> doc;
+  fillDeviceFields(doc, deviceType);
+  
+  char idcard[24] = "";   // RS232 ของเครื่องชั่งไม่มีข้อมูล ID Card
+  if (reading.fields & WIRE_FIELD_IDCARD) {
+    Wire_idcardToString(reading.idcard, idcard, sizeof(idcard));
+  }
+  doc["idcard"] = idcard;
   
   JsonObject dataObj = doc.createNestedObject("data");
-  dataObj["value"] = value;
+  switch (reading.kind) {
+    case WIRE_KIND_BLOOD_PRESSURE:
+      if (reading.fields & WIRE_FIELD_VALUE0) dataObj["bp"] = reading.values[0];
+      if (reading.fields & WIRE_FIELD_VALUE1) dataObj["bp2"] = reading.values[1];
+      if (reading.fields & WIRE_FIELD_VALUE2) dataObj["pulse"] = reading.values[2];
+      break;
+  
+    case WIRE_KIND_WEIGHT_HEIGHT:
+      dataObj["weight"] = reading.values[0] / 10.0f;
+      dataObj["height"] = reading.values[1] / 10.0f;
+      if (reading.fields & WIRE_FIELD_VALUE2) dataObj["temp"] = reading.values[2] / 10.0f;
+      break;
+  
+    default:
+      dataObj["value"] = reading.values[0] / 10.0f;
+      break;
+  }
   dataObj["timestamp"] = millis();
   
-  String payload;
-  serializeJson(doc, payload);
+  char payload[320];
+  size_t payloadLen = serializeJson(doc, payload, sizeof(payload));
+  notePayloadBuilt(start, payloadLen);
   
-  // ส่ง HTTP POST พร้อม Retry (3 ครั้ง)
-  bool success = false;
-  int retryCount = 0;
-  const int MAX_RETRIES = 3;
+  LOG_I("\n📤 ส่งข้อมูล %s ไปยัง Center:\n", label);
+  LOG_D("%s\n", payload);
   
-  while (!success && retryCount < MAX_RETRIES) {
-    if (retryCount > 0) {
-      Serial.printf("   🔄 Retry ครั้งที่ %d/%d...\n", retryCount, MAX_RETRIES - 1);
-      delay(1000);
-      
-      if (!ensureWiFiConnected()) {
-        Serial.println("   ⚠️  WiFi ยังไม่พร้อม - ข้าม retry");
-        break;
-      }
+  queueToCenter(payload, payloadLen, label);
+}
+
+// ===== Callback เมื่อได้รับข้อมูล RS232 =====
+// โปรโตคอลรวมค่าที่มาหลายบรรทัดให้แล้ว (เช่น W/H ของเครื่องชั่ง) - ที่นี่แค่ส่งต่อ
+void onRS232DataReceived(const WireReading& reading) {
+  LOG_I("\n📤 กำลังเตรียมข้อมูลส่งไปยัง Center...\n");
+  sendReading(reading);
+  LOG_I("✅ เข้าคิวข้อมูลครบทั้งหมดแล้ว\n\n");
+}
+
+// ===== Task: อ่านข้อมูล RS232 (ทุกรอบของ loop) =====
+// เก็บช่วงห่างนานสุดระหว่างการเรียก RS232_loop() ไว้แสดงในสถานะระบบ
+// ESP32: byte ถูกรับโดย task แยกแล้ว - ช่วงห่างนี้คือเวลาที่เฟรมรอในคิว ไม่ใช่ความเสี่ยง RX ล้น
+void taskRS232(unsigned long now) {
+  if (rs232LastPoll != 0) {
+    unsigned long gap = now - rs232LastPoll;
+    if (gap > rs232MaxPollGap) {
+      rs232MaxPollGap = gap;
     }
-    
-    HTTPClient http;
-    WiFiClient client;
-    http.begin(client, url);
-    
-    http.addHeader("Content-Type", "application/json");
-    http.setTimeout(5000);
-    
-    int httpCode = http.POST(payload);
-    
-    if (httpCode == 200) {
-      httpPostCount++;
-      Serial.printf("✅ ส่งข้อมูล #%d สำเร็จ", httpPostCount);
-      if (retryCount > 0) {
-        Serial.printf(" (หลัง retry %d ครั้ง)", retryCount);
-      }
-      Serial.println();
-      Serial.printf("   Type: %s\n", deviceType.c_str());
-      Serial.printf("   Value: %.1f\n", value);
-      blinkLEDOnce();
-      success = true;
-    } else if (httpCode > 0) {
-      Serial.printf("❌ HTTP Error: %d\n", httpCode);
-      String response = http.getString();
-      if (response.length() > 0) {
-        Serial.println("   Response: " + response);
-      }
-    } else {
-      Serial.println("❌ การเชื่อมต่อล้มเหลว");
-      Serial.printf("   Error: %s\n", http.errorToString(httpCode).c_str());
+    if (gap > rs232MaxPollGapEver) {
+      rs232MaxPollGapEver = gap;
     }
-    
-    http.end();
-    retryCount++;
   }
+  rs232LastPoll = now;
+  loopCount++;
   
-  if (!success) {
-    Serial.printf("❌ ส่งข้อมูล %s ล้มเหลวหลังพยายาม %d ครั้ง\n", deviceType.c_str(), MAX_RETRIES);
-    Serial.println("   💡 กรุณาตรวจสอบ:");
-    Serial.printf("      - Center IP: %s พร้อมใช้งานหรือไม่\n", CENTER_IP);
-    Serial.println("      - Network connection");
+  // อ่านข้อมูล RS232 (passive receiver - รับข้อมูลที่ส่งมาอย่างเดียว)
+  int validBefore = RS232_getValidDataCount();
+  unsigned long start = micros();
+  RS232_loop();
+  if (RS232_getValidDataCount() != validBefore) {
+    Histogram_add(histHandleUs, micros() - start);
+    Histogram_add(histFrameMs, RS232_getLastFrameTime());
+    Histogram_add(histParseUs, RS232_getLastParseTime());
   }
 }
 
-// ===== ฟังก์ชันส่งข้อมูล Weight + Height พร้อมกัน (ESP8266) =====
-#ifdef ESP8266
-void sendWeightHeight(float weight, float height, bool hasTemp, float temp) {
-  // ตรวจสอบและ reconnect WiFi ถ้าจำเป็น
-  if (!ensureWiFiConnected()) {
-    Serial.println("⚠️  WiFi ไม่ได้เชื่อมต่อ - ข้ามการส่งข้อมูล");
+// ===== Heap ว่างต่ำสุดตั้งแต่เปิดเครื่อง =====
+uint32_t getHeapMinFree() {
+  #ifdef ESP32
+    return ESP.getMinFreeHeap();
+  #else
+    // ESP8266 ไม่มีค่าต่ำสุดจาก SDK → สุ่มดูตอนแสดงสถานะ/heartbeat
+    uint32_t freeHeap = ESP.getFreeHeap();
+    if (heapMinFree == 0 || freeHeap < heapMinFree) {
+      heapMinFree = freeHeap;
+    }
+    return heapMinFree;
+  #endif
+}
+
+// ===== Task: ส่งสถานะ + สรุป metrics ไปยัง Center (POST /api/status) =====
+// ส่งเฉพาะตอนคิวว่าง ไม่แย่งเวลาส่ง reading (มีข้อมูลค้าง → ข้ามรอบนี้)
+// histogram ส่งเป็น [n,p50,p95,max] สะสมตั้งแต่เปิดเครื่อง - Center เก็บค่าล่าสุดต่ออุปกรณ์
+void taskHeartbeat(unsigned long now) {
+  if (!isWiFiUp() || Outbox_size() > 0) {
     return;
   }
   
-  ConfigData* cfg = Config_get();
+  char frame[48], parse[48], handle[48], deliver[48];
+  Histogram_summary(histFrameMs, frame, sizeof(frame));
+  Histogram_summary(histParseUs, parse, sizeof(parse));
+  Histogram_summary(histHandleUs, handle, sizeof(handle));
+  Histogram_summary(histDeliverMs, deliver, sizeof(deliver));
   
-  // สร้าง URL
-  String url = String("http://") + CENTER_IP + "/api/vitals";
+  StaticJsonDocument<768> doc;
+  const char* mac = getDeviceMac();
+  doc["type"] = "device_status";
+  doc["deviceId"] = mac;
+  doc["deviceName"] = Config_get()->deviceName;
+  doc["macAddress"] = mac;
+  doc["timestamp"] = now;
+  if (Journal_getEpoch() != 0) {
+    doc["epoch"] = Journal_getEpoch();
+  }
   
-  // สร้าง JSON Payload รวม Weight + Height
-  StaticJsonDocument<300> doc;
-  doc["deviceId"] = WiFi.macAddress();
-  doc["deviceName"] = cfg->deviceName;
-  doc["macAddress"] = WiFi.macAddress();
-  doc["deviceType"] = "weight_height";  // ประเภทรวม
-  doc["idcard"] = "";  // ไม่มี ID Card
+  JsonObject metrics = doc.createNestedObject("metrics");
+  metrics["up"] = now / 1000;
+  metrics["frameMs"] = serialized(frame);
+  metrics["parseUs"] = serialized(parse);
+  metrics["handleUs"] = serialized(handle);
+  metrics["deliverMs"] = serialized(deliver);
+  metrics["retry"] = uplinkRetryCount;
+  metrics["reconnect"] = wifiReconnectCount;
+  metrics["dropped"] = RS232_getDroppedFrameCount();
+  metrics["overrun"] = RS232_getOverrunCount();
+  metrics["baud"] = RS232_getCurrentBaudRate();
+  metrics["baudLocked"] = RS232_isBaudRateLocked();
+  metrics["queueDropped"] = Outbox_getDroppedCount();
+  metrics["heapMin"] = getHeapMinFree();
+  metrics["wifiMs"] = wifiConnectTime;
+  metrics["reconnectMs"] = wifiReconnectTime;
+  metrics["firstPostMs"] = firstUplinkTime;
   
-  JsonObject dataObj = doc.createNestedObject("data");
-  dataObj["weight"] = weight;
-  dataObj["height"] = height;
-  if (hasTemp) {
-    dataObj["temp"] = temp;
+  char body[576];
+  size_t length = serializeJson(doc, body, sizeof(body));
+  int httpCode = Uplink_post("/api/status", body, length);
+  if (httpCode == 200) {
+    noteCenterReached();
+    LOG_D("💓 Heartbeat ส่งแล้ว (%u bytes)\n", (unsigned)length);
+  } else {
+    LOG_W("⚠️  Heartbeat ส่งไม่สำเร็จ (HTTP %d)\n", httpCode);
   }
-  dataObj["timestamp"] = millis();
+}
+
+// ===== Task: บอก Center ว่ายังออนไลน์ (UDP heartbeat - ไม่มี TCP handshake) =====
+// Center ไม่รู้จักอุปกรณ์ (เพิ่ง reboot) → ส่ง /api/status ทันทีไม่ต้องรอรอบ heartbeat
+void taskPresence(unsigned long now) {
+  if (!isWiFiUp()) {
+    return;
+  }
+  if (WireLink_takeStatusRequest()) {
+    taskHeartbeat(now);
+  }
+  WireLink_sendHeartbeat();
+}
+
+// ===== Task: ทยอยส่ง log ใน RAM ออก Serial (เท่าที่ TX FIFO ว่าง) =====
+void taskLog(unsigned long now) {
+  Log_drain();
+}
+
+// ===== คำสั่ง "protocol [ชื่อ]": แสดงรายการ / เลือกโปรโตคอล (บันทึกแล้ว restart) =====
+// baud rate และ Framer ถูกตั้งตอน RS232_begin() → ต้อง restart ให้มีผล
+void runProtocolCommand(const char* arg) {
+  while (*arg == ' ') arg++;
   
-  String payload;
-  serializeJson(doc, payload);
+  if (*arg == '\0') {
+    Serial.println("\n📋 โปรโตคอลที่รองรับ:");
+    for (size_t i = 0; i < InstrumentProtocols::COUNT; i++) {
+      const ProtocolInfo& info = InstrumentProtocols::table[i];
+      Serial.printf("   %s %-12s %6lu baud  %s (%s)\n",
+                    info.id == Config_get()->protocol ? "▶" : " ", info.name,
+                    (unsigned long)info.baud, info.description, info.format);
+    }
+    Serial.println("💡 เลือกด้วย 'protocol <ชื่อ>'");
+    return;
+  }
   
-  Serial.println("\n📤 ส่งข้อมูล Weight + Height รวมกัน:");
-  serializeJsonPretty(doc, Serial);
-  Serial.println();
+  const ProtocolInfo* info = Protocol_findByName(arg);
+  if (info == nullptr) {
+    Serial.printf("❌ ไม่รู้จักโปรโตคอล '%s' - พิมพ์ 'protocol' เพื่อดูรายการ\n", arg);
+    return;
+  }
+  if (info->id == Config_get()->protocol) {
+    Serial.printf("ℹ️  ใช้ %s อยู่แล้ว\n", info->name);
+    return;
+  }
   
-  // ส่ง HTTP POST พร้อม Retry
-  bool success = false;
-  int retryCount = 0;
-  const int MAX_RETRIES = 3;
+  Serial.printf("\n🔧 เปลี่ยนโปรโตคอลเป็น %s (%s, %lu baud) - restart...\n",
+                info->name, info->description, (unsigned long)info->baud);
+  Config_get()->protocol = info->id;
+  Config_get()->baud = 0;   // เครื่องใหม่ - หา baud rate ใหม่
+  Config_save();
+  delay(500);
+  ESP.restart();
+}
+
+// ===== บันทึก baud rate ที่หาเจอ (เปิดเครื่องครั้งหน้า lock ทันที) =====
+void onRS232BaudLocked(uint32_t baud) {
+  if (Config_get()->baud != baud) {
+    Config_get()->baud = baud;
+    Config_save();
+  }
+}
+
+// ===== คำสั่ง "baud [auto|rate]": แสดงสถานะ / หาใหม่ / ตั้งเอง (มีผลทันที ไม่ต้อง restart) =====
+void runBaudCommand(const char* arg) {
+  while (*arg == ' ') arg++;
   
-  while (!success && retryCount < MAX_RETRIES) {
-    if (retryCount > 0) {
-      Serial.printf("   🔄 Retry ครั้งที่ %d/%d...\n", retryCount, MAX_RETRIES - 1);
-      delay(1000);
-      
-      if (!ensureWiFiConnected()) {
-        Serial.println("   ⚠️  WiFi ยังไม่พร้อม - ข้าม retry");
-        break;
+  if (*arg == '\0') {
+    const BaudProbe* probe = RS232_getBaudProbe();
+    Serial.printf("\n📡 Baud rate: %ld (%s) | บันทึกไว้: %lu\n", RS232_getCurrentBaudRate(),
+                  RS232_isBaudRateLocked() ? "lock" : "กำลังหา", (unsigned long)Config_get()->baud);
+    Serial.printf("   เปลี่ยน rate %lu ครั้ง | หาใหม่ %lu ครั้ง | หาเจอล่าสุดใน %lu ms\n",
+                  (unsigned long)probe->switchCount, (unsigned long)probe->reprobeCount,
+                  (unsigned long)probe->lastLockTime);
+    Serial.println("💡 'baud auto' = หาใหม่, 'baud <rate>' = ตั้งเอง (1200-115200)");
+    return;
+  }
+  
+  if (strcmp(arg, "auto") == 0) {
+    Config_get()->baud = 0;
+    Config_save();
+    RS232_autobaud();
+    return;
+  }
+  
+  uint32_t baud = strtoul(arg, nullptr, 10);
+  if (!RS232_setBaudRate(baud)) {
+    Serial.printf("❌ baud rate '%s' ไม่รองรับ - ใช้ 1200/2400/4800/9600/19200/38400/57600/115200\n", arg);
+    return;
+  }
+  onRS232BaudLocked(baud);
+}
+
+// ===== ค่า WiFi เปลี่ยน: บันทึกแล้วเชื่อมต่อใหม่ทันที (ไม่ต้อง restart) =====
+void applyWiFiConfig() {
+  Config_save();
+  wifiUseCache = true;
+  wifiDropAt = 0;   // ไม่นับเป็น "หลุด → ต่อได้"
+  startWiFiReconnect(millis());
+}
+
+// ===== คำสั่ง "wifi [forget]": แสดงค่า WiFi / ลืม BSSID-channel ที่จำไว้ (scan ใหม่) =====
+void runWiFiCommand(const char* arg) {
+  while (*arg == ' ') arg++;
+  ConfigData* cfg = Config_get();
+  
+  if (strcmp(arg, "forget") == 0) {
+    ConfigRecord_forgetAp(*cfg);
+    Serial.println("\n🔧 ลืม BSSID/channel ของ Center - scan หาใหม่");
+    applyWiFiConfig();
+    return;
+  }
+  
+  Serial.printf("\n📶 SSID: %s | Center IP: %s | IP: %s\n", cfg->ssid, cfg->centerIp,
+                cfg->localIp[0] != '\0' ? cfg->localIp : "DHCP");
+  if (cfg->channel != 0) {
+    Serial.printf("   Center AP: %02X:%02X:%02X:%02X:%02X:%02X ch %u (ไม่ต้อง scan)\n",
+                  cfg->bssid[0], cfg->bssid[1], cfg->bssid[2], cfg->bssid[3], cfg->bssid[4], cfg->bssid[5],
+                  cfg->channel);
+  } else {
+    Serial.println("   Center AP: ยังไม่รู้ (scan หา)");
+  }
+  Serial.printf("   เชื่อมต่อล่าสุด %lu ms | หลุด → ต่อได้ %lu ms | เปิดเครื่อง → Center ตอบรับ %lu ms\n",
+                wifiConnectTime, wifiReconnectTime, firstUplinkTime);
+  Serial.println("💡 'ssid <ชื่อ>', 'pass <รหัส>', 'center <ip>', 'ip <ip>' / 'ip dhcp', 'wifi forget'");
+}
+
+// ===== คำสั่ง "ssid <ชื่อ>" / "pass <รหัสผ่าน>" =====
+void runCredentialCommand(bool isSsid, const char* arg) {
+  while (*arg == ' ') arg++;
+  ConfigData* cfg = Config_get();
+  
+  bool ok = isSsid ? ConfigRecord_setText(cfg->ssid, sizeof(cfg->ssid), arg)
+                   : ConfigRecord_setText(cfg->password, sizeof(cfg->password), arg);
+  if (!ok) {
+    Serial.printf("❌ %s ต้องยาว 1-%u ตัวอักษร\n", isSsid ? "SSID" : "รหัสผ่าน",
+                  (unsigned)(isSsid ? sizeof(cfg->ssid) : sizeof(cfg->password)) - 1);
+    return;
+  }
+  if (isSsid) {
+    ConfigRecord_forgetAp(*cfg);   // AP อื่น
+    Serial.printf("\n🔧 SSID: %s\n", cfg->ssid);
+  } else {
+    Serial.println("\n🔧 เปลี่ยนรหัสผ่าน WiFi แล้ว");
+  }
+  applyWiFiConfig();
+}
+
+// ===== คำสั่ง "center <ip>": IP ของ Center (HTTP + UDP) =====
+void runCenterCommand(const char* arg) {
+  while (*arg == ' ') arg++;
+  ConfigData* cfg = Config_get();
+  
+  uint8_t ip[4];
+  if (!ConfigRecord_parseIp(arg, ip) || !ConfigRecord_setText(cfg->centerIp, sizeof(cfg->centerIp), arg)) {
+    Serial.printf("❌ IP '%s' ไม่ถูกต้อง (เช่น 10.1.10.1)\n", arg);
+    return;
+  }
+  Serial.printf("\n🔧 Center IP: %s\n", cfg->centerIp);
+  if (cfg->localIp[0] != '\0' && !ConfigRecord_isLocalIp(cfg->localIp, cfg->centerIp)) {
+    Serial.printf("   ⚠️  IP ของเครื่อง %s อยู่คนละ subnet กับ Center - กลับไปใช้ DHCP\n", cfg->localIp);
+    cfg->localIp[0] = '\0';
+  }
+  applyWiFiConfig();
+}
+
+// ===== คำสั่ง "ip <ip>|dhcp": IP ของเครื่องนี้ (ตั้งเอง = ไม่ต้องรอ DHCP) =====
+void runLocalIpCommand(const char* arg) {
+  while (*arg == ' ') arg++;
+  ConfigData* cfg = Config_get();
+  
+  if (strcmp(arg, "dhcp") == 0) {
+    cfg->localIp[0] = '\0';
+    Serial.println("\n🔧 IP ของเครื่อง: DHCP");
+    applyWiFiConfig();
+    return;
+  }
+  if (!ConfigRecord_isLocalIp(arg, cfg->centerIp)) {
+    Serial.printf("❌ IP '%s' ใช้ไม่ได้ - ต้องอยู่ใน subnet ของ Center (%s/24) และไม่ซ้ำ Center\n",
+                  arg, cfg->centerIp);
+    return;
+  }
+  strlcpy(cfg->localIp, arg, sizeof(cfg->localIp));
+  Serial.printf("\n🔧 IP ของเครื่อง: %s (ห้ามซ้ำกับเครื่องอื่น / ช่วงที่ DHCP ของ Center แจก)\n", cfg->localIp);
+  applyWiFiConfig();
+}
+
+// ===== Task: รับคำสั่งจาก Serial Monitor (ไม่รอ newline) =====
+void taskSerialCommand(unsigned long now) {
+  while (Serial.available() > 0) {
+    char c = Serial.read();
+  
+    if (c != '\n' && c != '\r') {
+      if (commandLength < (int)sizeof(commandBuffer) - 1) {
+        commandBuffer[commandLength++] = c;
       }
+      continue;
     }
-    
-    HTTPClient http;
-    WiFiClient client;
-    http.begin(client, url);
-    
-    http.addHeader("Content-Type", "application/json");
-    http.setTimeout(5000);
-    
-    int httpCode = http.POST(payload);
-    
-    if (httpCode == 200) {
-      httpPostCount++;
-      Serial.printf("✅ ส่งข้อมูล Weight+Height #%d สำเร็จ", httpPostCount);
-      if (retryCount > 0) {
-        Serial.printf(" (หลัง retry %d ครั้ง)", retryCount);
-      }
-      Serial.println();
-      Serial.printf("   Weight: %.1f kg\n", weight);
-      Serial.printf("   Height: %.1f cm\n", height);
-      if (hasTemp) {
-        Serial.printf("   Temp: %.1f °C\n", temp);
-      }
-      blinkLEDOnce();
-      success = true;
-    } else if (httpCode > 0) {
-      Serial.printf("❌ HTTP Error: %d\n", httpCode);
-      String response = http.getString();
-      if (response.length() > 0) {
-        Serial.println("   Response: " + response);
-      }
-    } else {
-      Serial.println("❌ การเชื่อมต่อล้มเหลว");
-      Serial.printf("   Error: %s\n", http.errorToString(httpCode).c_str());
+  
+    if (commandLength == 0) {
+      continue;
+    }
+    commandBuffer[commandLength] = '\0';
+    commandLength = 0;
+  
+    // คำสั่งไม่สนตัวพิมพ์ใหญ่-เล็ก - ยกเว้นค่าของ ssid / pass
+    bool keepCase = strncasecmp(commandBuffer, "ssid ", 5) == 0 || strncasecmp(commandBuffer, "pass ", 5) == 0;
+    for (int i = 0; commandBuffer[i] != '\0' && (!keepCase || i < 4); i++) {
+      commandBuffer[i] = tolower(commandBuffer[i]);
     }
-    
-    http.end();
-    retryCount++;
-  }
   
-  if (!success) {
-    Serial.printf("❌ ส่งข้อมูล Weight+Height ล้มเหลวหลังพยายาม %d ครั้ง\n", MAX_RETRIES);
-    Serial.println("   💡 กรุณาตรวจสอบ:");
-    Serial.printf("      - Center IP: %s พร้อมใช้งานหรือไม่\n", CENTER_IP);
-    Serial.println("      - Network connection");
+    if (strcmp(commandBuffer, "reset") == 0) {
+      Serial.println("\n🔄 ได้รับคำสั่ง Reset Config จาก Serial Monitor");
+      Config_reset();
+      delay(1000);
+      ESP.restart();
+    } else if (strcmp(commandBuffer, "log") == 0) {
+      // ส่ง log ที่ค้างใน RAM ออกทั้งหมดทันที
+      Log_flush();
+    } else if (strncmp(commandBuffer, "protocol", 8) == 0) {
+      runProtocolCommand(commandBuffer + 8);
+    } else if (strncmp(commandBuffer, "baud", 4) == 0) {
+      runBaudCommand(commandBuffer + 4);
+    } else if (strncmp(commandBuffer, "wifi", 4) == 0) {
+      runWiFiCommand(commandBuffer + 4);
+    } else if (strncmp(commandBuffer, "ssid ", 5) == 0) {
+      runCredentialCommand(true, commandBuffer + 5);
+    } else if (strncmp(commandBuffer, "pass ", 5) == 0) {
+      runCredentialCommand(false, commandBuffer + 5);
+    } else if (strncmp(commandBuffer, "center ", 7) == 0) {
+      runCenterCommand(commandBuffer + 7);
+    } else if (strncmp(commandBuffer, "ip ", 3) == 0) {
+      runLocalIpCommand(commandBuffer + 3);
+    }
   }
 }
-#endif
 
-// ===== Callback เมื่อได้รับข้อมูล RS232 =====
-void onRS232DataReceived(String jsonData) {
-  Serial.println("\n📤 กำลังส่งข้อมูลไปยัง Center...");
+// ===== Task: ตรวจสอบปุ่มกดค้าง 3 วินาที = Reset Config =====
+void taskButton(unsigned long now) {
+  if (digitalRead(BOOT_BTN) == LOW) {
+    if (now - lastButtonCheck > 3000) {
+      #ifdef ESP32
+        Serial.println("\n🔄 กำลัง Reset Config (BOOT Button)...");
+      #elif defined(ESP8266)
+        Serial.println("\n🔄 กำลัง Reset Config (D2 Button)...");
+      #endif
+      Config_reset();
+      ESP.restart();
+    }
+  } else {
+    lastButtonCheck = now;
+  }
+}
+
+// ===== Task: แสดงสถานะระบบ =====
+void taskStatus(unsigned long now) {
+  // แสดงสถานะ RS232 ก่อนเสมอ
+  LOG_I("\n📊 สถานะระบบ:\n");
   
-  // Parse JSON
-  #ifdef ESP32
-    StaticJsonDocument<512> doc;
-  #else
-    StaticJsonDocument<200> doc;  // ESP8266: parse weight/height/temp data
-  #endif
-  DeserializationError error = deserializeJson(doc, jsonData);
+  long currentBaud = RS232_getCurrentBaudRate();
+  int byteCount = RS232_getByteCount();
+  int validCount = RS232_getValidDataCount();
   
-  if (error) {
-    Serial.println("❌ JSON Parse Error: " + String(error.c_str()));
-    return;
+  LOG_I("   📡 %s (%s) | Baud Rate: %ld (%s)\n",
+        RS232_getProtocol()->description, RS232_getProtocol()->name, currentBaud,
+        RS232_isBaudRateLocked() ? "lock" : "กำลังหา");
+  LOG_I("   📊 Bytes รับทั้งหมด: %d bytes\n", byteCount);
+  LOG_I("   ✅ ข้อมูล Valid: %d ครั้ง | ทิ้ง %d เฟรม | RX ล้น %lu ครั้ง\n",
+        validCount, RS232_getDroppedFrameCount(), RS232_getOverrunCount());
+  LOG_I("   🔄 Loop Count: %lu ครั้ง | RS232 ห่างนานสุด: %lu ms (ตั้งแต่เปิดเครื่อง: %lu ms)\n",
+        loopCount, rs232MaxPollGap, rs232MaxPollGapEver);
+  LOG_I("   📦 คิวรอส่ง: %d/%d | ทิ้ง (คิวเต็ม): %lu | Retry: %lu ครั้ง\n",
+        Outbox_size(), OUTBOX_CAPACITY, Outbox_getDroppedCount(), uplinkRetryCount);
+  if (journalReady) {
+    unsigned long appendTime = Journal_getMeanAppendTime();
+    LOG_I("   💾 Journal: ค้าง %d | ส่งซ้ำ %lu | ถูกเขียนทับ %lu | เขียน %lu us/record (~%lu records/s)\n",
+          Journal_getPendingCount(), journalReplayCount, Journal_getLostCount(),
+          appendTime, appendTime > 0 ? 1000000UL / appendTime : 0);
   }
+  char frame[48], parse[48], handle[48], deliver[48];
+  Histogram_summary(histFrameMs, frame, sizeof(frame));
+  Histogram_summary(histParseUs, parse, sizeof(parse));
+  Histogram_summary(histHandleUs, handle, sizeof(handle));
+  Histogram_summary(histDeliverMs, deliver, sizeof(deliver));
+  LOG_I("   ⏱️  Latency [n,p50,p95,max]: เฟรม %s ms | parse %s us | จัดการ %s us | ส่งถึง %s ms\n",
+        frame, parse, handle, deliver);
+  LOG_I("   🧠 Heap ต่ำสุด: %lu bytes\n", (unsigned long)getHeapMinFree());
+  LOG_I("   📝 Log: ค้าง %u bytes | ทิ้ง %lu ข้อความ\n", (unsigned)Log_pending(), logDroppedCount);
+  Scheduler_printStats();
+  loopCount = 0;
+  rs232MaxPollGap = 0;
   
-  #ifdef ESP32
-    // ===== ESP32: เครื่องวัดความดัน - ส่งรวมกัน 1 ครั้ง พร้อม ID Card =====
-    sendBPData(jsonData);
-    
-  #elif defined(ESP8266)
-    // ===== ESP8266: เครื่องชั่ง - ต้องมีทั้ง Weight และ Height ถึงจะส่ง =====
-    bool hasWeight = doc.containsKey("weight");
-    bool hasHeight = doc.containsKey("height");
-    bool hasTemp = doc.containsKey("temp");
-    
-    float weight = hasWeight ? doc["weight"].as<float>() : 0;
-    float height = hasHeight ? doc["height"].as<float>() : 0;
-    float temp = hasTemp ? doc["temp"].as<float>() : 0;
-    
-    // ถ้ามีทั้ง Weight และ Height → ส่งทันที
-    if (hasWeight && hasHeight) {
-      Serial.println("✅ ได้ทั้ง Weight และ Height → ส่งรวมกันทันที");
-      sendWeightHeight(weight, height, hasTemp, temp);
-      
-      // Clear buffer
-      hasBufferedWeight = false;
-      hasBufferedHeight = false;
-      bufferedWeight = 0;
-      bufferedHeight = 0;
+  if (WiFi.status() == WL_CONNECTED) {
+    LOG_I("   📶 WiFi: Connected (RSSI: %d dBm)\n", WiFi.RSSI());
+    LOG_I("   🌐 Center IP: %s | IP: %s (%s)\n", Config_get()->centerIp,
+          WiFi.localIP().toString().c_str(), Config_get()->localIp[0] != '\0' ? "ตั้งเอง" : "DHCP");
+    LOG_I("   ⏱️  เชื่อมต่อ WiFi: %lu ms | หลุด → ต่อได้: %lu ms | เปิดเครื่อง → ส่งถึง Center: %lu ms\n",
+          wifiConnectTime, wifiReconnectTime, firstUplinkTime);
+    LOG_I("   📤 ส่งข้อมูลแล้ว: %d ครั้ง\n", httpPostCount);
+    LOG_I("   🔗 TCP Connections: %lu ครั้ง | POST เฉลี่ย: %lu ms\n",
+          Uplink_getConnectCount(), Uplink_getMeanLatency());
+    if (payloadBuildCount > 0) {
+      LOG_I("   📐 Payload (%s): เฉลี่ย %lu bytes | สร้าง %lu us\n",
+            UPLINK_BINARY ? "Binary" : "JSON", payloadBytesTotal / payloadBuildCount,
+            payloadBuildTimeTotal / payloadBuildCount);
     }
-    // ถ้ามีแค่ Weight → เก็บ buffer รอ Height
-    else if (hasWeight && !hasHeight) {
-      Serial.println("⏳ ได้ Weight แล้ว → รอ Height...");
-      bufferedWeight = weight;
-      hasBufferedWeight = true;
-      lastBufferTime = millis();
-      
-      // ถ้ามี Height ใน buffer อยู่แล้ว → ส่งเลย
-      if (hasBufferedHeight) {
-        Serial.println("✅ มี Height ใน buffer แล้ว → ส่งรวมกัน");
-        sendWeightHeight(bufferedWeight, bufferedHeight, hasTemp, temp);
-        hasBufferedWeight = false;
-        hasBufferedHeight = false;
-        bufferedWeight = 0;
-        bufferedHeight = 0;
-      }
+    if (wireReadingCount > 0) {
+      LOG_I("   📡 UDP: %lu bytes/reading (รวม HELLO %lu ครั้ง)\n",
+            WireLink_getBytesPerReading(), wireHelloCount);
     }
-    // ถ้ามีแค่ Height → เก็บ buffer รอ Weight
-    else if (!hasWeight && hasHeight) {
-      Serial.println("⏳ ได้ Height แล้ว → รอ Weight...");
-      bufferedHeight = height;
-      hasBufferedHeight = true;
-      lastBufferTime = millis();
-      
-      // ถ้ามี Weight ใน buffer อยู่แล้ว → ส่งเลย
-      if (hasBufferedWeight) {
-        Serial.println("✅ มี Weight ใน buffer แล้ว → ส่งรวมกัน");
-        sendWeightHeight(bufferedWeight, bufferedHeight, hasTemp, temp);
-        hasBufferedWeight = false;
-        hasBufferedHeight = false;
-        bufferedWeight = 0;
-        bufferedHeight = 0;
-      }
+    if (httpPostCount > 0) {
+      LOG_I("   📦 Batch: %lu ครั้ง | %.2f request/reading | %lu bytes/reading\n",
+            uplinkBatchCount, (float)Uplink_getRequestCount() / httpPostCount,
+            Uplink_getBytesTotal() / httpPostCount);
     }
-    // ถ้ามีแค่ Temp เดี่ยว → ส่งแยก (ไม่สำคัญ)
-    else if (hasTemp && !hasWeight && !hasHeight) {
-      Serial.println("ℹ️  มีแค่ Temp → ส่งแยก");
-      sendHTTPPost("temp", temp);
+    if (wifiReconnectCount > 0) {
+      LOG_I("   🔄 WiFi Reconnect: %d ครั้ง\n", wifiReconnectCount);
     }
-  #endif
+  } else {
+    LOG_W("   ⚠️  WiFi: Disconnected (พยายาม reconnect อัตโนมัติ...)\n");
+  }
+  
+  if (byteCount == 0) {
+    LOG_W("\n   ⚠️  ยังไม่มีข้อมูลเข้ามา - ตรวจสอบ:\n");
+    LOG_I("      1. สาย RS232: TX → RX, RX → TX (ต้องสลับข้าม!)\n");
+    LOG_I("      2. MAX3232: มีไฟเลี้ยง (VCC, GND)\n");
+    LOG_I("      3. อุปกรณ์: เปิดเครื่องและกำลังส่งข้อมูลหรือไม่\n");
+    LOG_I("      4. Baud Rate: ตรง %ld หรือไม่ (%s) - พิมพ์ 'baud auto' เพื่อหาใหม่\n",
+          currentBaud, RS232_getProtocol()->description);
+  } else if (validCount == 0 && byteCount > 0) {
+    LOG_W("\n   ⚠️  มีข้อมูลเข้ามาแต่ parse ไม่ได้:\n");
+    LOG_I("      - กำลังรอข้อมูลครบทั้งเฟรม\n");
+    LOG_I("      - หรือข้อมูลไม่ใช่รูปแบบ %s\n", RS232_getProtocol()->format);
+    LOG_I("      - หรือเลือกโปรโตคอลผิดเครื่อง (ตอนนี้: %s - พิมพ์ 'protocol' เพื่อเปลี่ยน)\n",
+          RS232_getProtocol()->name);
+  }
   
-  Serial.println("✅ ส่งข้อมูลครบทั้งหมดแล้ว\n");
+  LOG_I("\n");
 }
 
 // ===== Setup =====
@@ -584,9 +1096,9 @@ void setup() {
   
   Serial.println("\n================================================================================");
   #ifdef ESP32
-    Serial.println("  ESP32 RS232 to HTTP POST - Blood Pressure Monitor");
+    Serial.println("  ESP32 RS232 to HTTP POST");
   #elif defined(ESP8266)
-    Serial.println("  ESP8266 RS232 to HTTP POST - Weight Scale");
+    Serial.println("  ESP8266 RS232 to HTTP POST");
   #endif
   Serial.println("================================================================================\n");
   
@@ -605,24 +1117,43 @@ void setup() {
   // โหลด Config
   Config_begin();
   
-  // เชื่อมต่อ WiFi (Fixed) - ข้ามถ้าไม่สำเร็จ เพื่อทดสอบ RS232
-  Serial.println("🔌 กำลังเชื่อมต่อ WiFi...");
-  if (!Config_connectWiFi()) {
-    Serial.println("⚠️  ไม่สามารถเชื่อมต่อ WiFi ได้");
-    Serial.println("✅ ข้าม WiFi - ดำเนินการทดสอบ RS232 ต่อ...\n");
-    // ไม่ restart เพื่อให้ทดสอบ RS232 ได้
-  } else {
-    // ตั้งค่า WiFi Auto-Reconnect
-    WiFi.setAutoReconnect(true);
-    WiFi.persistent(true);
-  }
+  // เปิด Journal (ข้อมูลที่ยังไม่ได้ส่งจากครั้งก่อนจะถูกส่งซ้ำหลังเชื่อมต่อ WiFi)
+  Journal_begin();
+  
+  // เริ่มเชื่อมต่อ WiFi - ไม่รอผล taskWiFi จะติดตามต่อ
+  // RS232 จึงเริ่มรับข้อมูลได้ทันทีแม้ WiFi ยังไม่พร้อม
+  startWiFiAttempt(millis(), WIFI_BOOT_TIMEOUT);
+  WiFi.setAutoReconnect(true);
+  
+  // ข้อมูลอุปกรณ์สำหรับ HELLO ของ WireLink (ส่งครั้งเดียวต่อ session)
+  uint8_t mac[6];
+  WiFi.macAddress(mac);
+  WireLink_begin(mac, Config_get()->deviceName, Journal_getEpoch());
   
   // เริ่มต้น RS232
-  RS232_begin();
+  RS232_begin(Config_get()->protocol, Config_get()->baud);
   RS232_setCallback(onRS232DataReceived);
+  RS232_setBaudLockCallback(onRS232BaudLocked);
+  
+  // ตารางงาน (RS232 อยู่ก่อนเสมอ และทำทุกรอบ)
+  Scheduler_add("rs232", taskRS232, 0);
+  Scheduler_add("uplink", taskUplink, 0);
+  Scheduler_add("replay", taskJournalReplay, JOURNAL_REPLAY_INTERVAL);
+  Scheduler_add("led", taskLED, 0);
+  Scheduler_add("wifi", taskWiFi, 100);
+  Scheduler_add("cmd", taskSerialCommand, 50);
+  Scheduler_add("button", taskButton, 50);
+  Scheduler_add("status", taskStatus, WIFI_CHECK_INTERVAL);
+  Scheduler_add("heartbeat", taskHeartbeat, HEARTBEAT_INTERVAL);
+  Scheduler_add("presence", taskPresence, PRESENCE_INTERVAL);
+  Scheduler_add("log", taskLog, 0);
   
   Serial.println("\n✅ พร้อมใช้งาน!");
   Serial.println("💡 พิมพ์ 'reset' ใน Serial Monitor เพื่อ Reset Config");
+  Serial.println("💡 พิมพ์ 'log' เพื่อส่ง log ที่ค้างอยู่ออกทันที");
+  Serial.println("💡 พิมพ์ 'protocol' เพื่อดู/เลือกเครื่องที่ต่อ RS232 (เช่น 'protocol weight-text')");
+  Serial.println("💡 พิมพ์ 'baud' เพื่อดู baud rate ('baud auto' = หาใหม่, 'baud 9600' = ตั้งเอง)");
+  Serial.println("💡 พิมพ์ 'wifi' เพื่อดู/ตั้งค่า WiFi ('ssid', 'pass', 'center', 'ip', 'wifi forget')");
   Serial.println("================================================================================\n");
   
   Serial.println("🔧 กำลังเริ่มต้น RS232 Loop...");
@@ -632,130 +1163,10 @@ void setup() {
 
 // ===== Loop =====
 void loop() {
-  // ตรวจสอบคำสั่งจาก Serial Monitor
-  if (Serial.available() > 0) {
-    String command = Serial.readStringUntil('\n');
-    command.trim();
-    command.toLowerCase();
-    
-    if (command == "reset") {
-      Serial.println("\n🔄 ได้รับคำสั่ง Reset Config จาก Serial Monitor");
-      Config_reset();
-      delay(1000);
-      ESP.restart();
-    }
-  }
-  
-  // อัพเดท LED
-  updateLED();
-  
-  // ===== ESP8266: ตรวจสอบ Buffer Timeout =====
-  #ifdef ESP8266
-  if ((hasBufferedWeight || hasBufferedHeight) && lastBufferTime > 0) {
-    if (millis() - lastBufferTime > BUFFER_TIMEOUT) {
-      Serial.println("\n⏰ Buffer Timeout (5 วินาที)!");
-      
-      // ถ้ามีแค่ตัวเดียว → ไม่ส่ง (รอให้ครบ)
-      if (hasBufferedWeight && !hasBufferedHeight) {
-        Serial.println("   ⚠️  มีแค่ Weight ไม่มี Height → ไม่ส่ง (ต้องมีทั้งคู่)");
-      } else if (!hasBufferedWeight && hasBufferedHeight) {
-        Serial.println("   ⚠️  มีแค่ Height ไม่มี Weight → ไม่ส่ง (ต้องมีทั้งคู่)");
-      }
-      
-      // Clear buffer
-      hasBufferedWeight = false;
-      hasBufferedHeight = false;
-      bufferedWeight = 0;
-      bufferedHeight = 0;
-      lastBufferTime = 0;
-    }
-  }
-  #endif
-  
-  // ตรวจสอบปุ่มกดค้าง 3 วินาที = Reset Config
-  if (digitalRead(BOOT_BTN) == LOW) {
-    if (millis() - lastButtonCheck > 3000) {
-      #ifdef ESP32
-        Serial.println("\n🔄 กำลัง Reset Config (BOOT Button)...");
-      #elif defined(ESP8266)
-        Serial.println("\n🔄 กำลัง Reset Config (D2 Button)...");
-      #endif
-      Config_reset();
-      ESP.restart();
-    }
-  } else {
-    lastButtonCheck = millis();
-  }
-  
-  // ตรวจสอบสถานะ WiFi อย่างสม่ำเสมอ (Auto-reconnect)
-  if (millis() - lastWiFiCheck > WIFI_CHECK_INTERVAL) {
-    lastWiFiCheck = millis();
-    
-    // พยายาม reconnect ถ้า WiFi หลุด
-    ensureWiFiConnected();
-    
-    // แสดงสถานะ RS232 ก่อนเสมอ
-    Serial.println("\n📊 สถานะระบบ:");
-    
-    long currentBaud = RS232_getCurrentBaudRate();
-    int byteCount = RS232_getByteCount();
-    int validCount = RS232_getValidDataCount();
-    
-    Serial.printf("   📡 Baud Rate: %ld\n", currentBaud);
-    Serial.printf("   📊 Bytes รับทั้งหมด: %d bytes\n", byteCount);
-    Serial.printf("   ✅ ข้อมูล Valid: %d ครั้ง\n", validCount);
-    
-    if (WiFi.status() == WL_CONNECTED) {
-      Serial.printf("   📶 WiFi: Connected (RSSI: %d dBm)\n", WiFi.RSSI());
-      Serial.printf("   🌐 Center IP: %s\n", CENTER_IP);
-      Serial.printf("   📤 ส่งข้อมูลแล้ว: %d ครั้ง\n", httpPostCount);
-      if (wifiReconnectCount > 0) {
-        Serial.printf("   🔄 WiFi Reconnect: %d ครั้ง\n", wifiReconnectCount);
-      }
-    } else {
-      Serial.println("   ⚠️  WiFi: Disconnected (พยายาม reconnect อัตโนมัติ...)");
-    }
-    
-    if (byteCount == 0) {
-      Serial.println("\n   ⚠️  ยังไม่มีข้อมูลเข้ามา - ตรวจสอบ:");
-      Serial.println("      1. สาย RS232: TX → RX, RX → TX (ต้องสลับข้าม!)");
-      Serial.println("      2. MAX3232: มีไฟเลี้ยง (VCC, GND)");
-      Serial.println("      3. อุปกรณ์: เปิดเครื่องและกำลังส่งข้อมูลหรือไม่");
-      #ifdef ESP32
-        Serial.println("      4. Baud Rate: ตรง 115200 หรือไม่ (เครื่องวัดความดัน)");
-      #elif defined(ESP8266)
-        Serial.println("      4. Baud Rate: ตรง 9600 หรือไม่ (เครื่องชั่ง)");
-      #endif
-    } else if (validCount == 0 && byteCount > 0) {
-      Serial.println("\n   ⚠️  มีข้อมูลเข้ามาแต่ parse ไม่ได้:");
-      #ifdef ESP32
-        Serial.println("      - กำลังรอข้อมูลครบ (รอ '}' ของ JSON)");
-        Serial.println("      - หรือข้อมูลไม่ใช่ JSON format");
-      #elif defined(ESP8266)
-        Serial.println("      - กำลังรอข้อมูลครบ (รอ newline)");
-        Serial.println("      - หรือข้อมูลไม่ใช่รูปแบบ W:xxx H:xxx");
-      #endif
-    }
-    
-    Serial.println();
-  }
-  
-  // อ่านข้อมูล RS232 (passive receiver - รับข้อมูลที่ส่งมาอย่างเดียว)
-  RS232_loop();
-  
-  // แสดงสถานะการอ่าน RS232 ทุก 10 วินาที
-  static unsigned long lastDebug = 0;
-  static unsigned long loopCount = 0;
-  loopCount++;
-  
-  if (millis() - lastDebug > 10000) {
-    lastDebug = millis();
-    int byteCount = RS232_getByteCount();
-    Serial.printf("🔄 Loop Count: %lu ครั้ง | RS232 Bytes: %d bytes\n", loopCount, byteCount);
-    loopCount = 0;
-  }
-  
-  // ไม่ต้อง delay เพราะ RS232_loop() อ่านต่อเนื่อง
+  // ทุกงานเป็น non-blocking - ไม่มี delay ใน loop
+  // ช่วงห่างระหว่าง RS232_loop() นานสุด ≈ 2 × UPLINK_TIMEOUT (POST + ส่งซ้ำบน connection ใหม่)
+  // (ESP32 รับ UART ใน task แยกบน core 0 - ส่วน ESP8266 ต้องอาศัย buffer ของ SoftwareSerial)
+  Scheduler_run();
 }
 
 // ===== SETUP LED =====
@@ -773,7 +1184,7 @@ void setupLED() {
 }
 
 // ===== UPDATE LED =====
-void updateLED() {
+void updateLED(unsigned long now) {
   if (WiFi.status() != WL_CONNECTED) {
     // ไม่ได้เชื่อมต่อ - ดับ LED
     digitalWrite(GREEN_LED_PIN, LOW);
@@ -781,7 +1192,6 @@ void updateLED() {
   }
   
   // เชื่อมต่อแล้ว - กระพริบทุก 1 วิ ดับ 5 วิ
-  unsigned long now = millis();
   unsigned long interval = 6000;  // 1วิ + 5วิ = 6 วินาที
   unsigned long elapsed = now - lastLedBlink;
   
@@ -797,15 +1207,35 @@ void updateLED() {
   }
 }
 
+// ===== Task: LED (pattern กระพริบเร็ว หรือสถานะปกติ) =====
+void taskLED(unsigned long now) {
+  if (ledPatternToggles == 0) {
+    updateLED(now);
+    return;
+  }
+  
+  if (now - ledPatternLast < ledPatternInterval) {
+    return;
+  }
+  ledPatternLast = now;
+  ledPatternToggles--;
+  digitalWrite(GREEN_LED_PIN, (ledPatternToggles % 2) ? HIGH : LOW);
+  
+  if (ledPatternToggles == 0) {
+    // รีเซ็ตตัวจับเวลาสำหรับการกระพริบปกติ
+    lastLedBlink = now;
+  }
+}
+
+// ===== เริ่ม LED Pattern (กระพริบ count ครั้ง, ติด/ดับครั้งละ interval ms) =====
+void startLEDPattern(int count, unsigned long interval) {
+  ledPatternToggles = count * 2;
+  ledPatternInterval = interval;
+  ledPatternLast = millis() - interval;
+}
+
 // ===== BLINK LED ONCE =====
 void blinkLEDOnce() {
-  // กระพริบสั้นๆ 1 ชุด (3 ครั้งเร็ว)
-  for (int i = 0; i < 3; i++) {
-    digitalWrite(GREEN_LED_PIN, HIGH);
-    delay(100);
-    digitalWrite(GREEN_LED_PIN, LOW);
-    delay(100);
-  }
-  // รีเซ็ตตัวจับเวลาสำหรับการกระพริบปกติ
-  lastLedBlink = millis();
+  // กระพริบสั้นๆ 1 ชุด (3 ครั้งเร็ว) - taskLED จะทำต่อเอง
+  startLEDPattern(3, 100);
 }
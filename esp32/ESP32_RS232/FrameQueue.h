@@ -0,0 +1,103 @@
+/**
+ * FrameQueue.h - คิวเฟรมที่ครบแล้ว ส่งต่อจาก task รับ RS232 ไปยัง loop()
+ *
+ * ESP32: task รับ UART (core 0) แยกเฟรมแล้ว FrameQueue_push()
+ *        loop() (core 1) ดึงไป parse / เข้าคิวส่ง ผ่าน FrameQueue_peek()/FrameQueue_pop()
+ *        HTTP ที่ช้าใน loop() จึงไม่ทำให้ UART RX ล้น - เฟรมรออยู่ในคิวนี้แทน
+ *
+ * Single-producer / single-consumer: producer เขียน head, consumer เขียน tail
+ * จึงไม่ต้องใช้ lock - แค่ต้องมี memory barrier ก่อนเลื่อน index (แบบเดียวกับ center/Inbox.h)
+ * คิวเต็ม → ทิ้งเฟรมใหม่และนับไว้ (ไม่เขียนทับ slot ที่ consumer อาจกำลังอ่าน)
+ *
+ * ไม่ขึ้นกับ Arduino - compile บน PC ได้ (ทดสอบ producer/consumer คนละ thread)
+ */
+
+#ifndef FRAME_QUEUE_H
+#define FRAME_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ===== Configuration =====
+#ifndef FRAME_QUEUE_SLOTS
+  #define FRAME_QUEUE_SLOTS 4          // เครื่องวัดส่ง 1 เฟรมต่อการวัด - 4 เฟรมพอรอ HTTP timeout
+#endif
+#ifndef FRAME_QUEUE_SLOT_SIZE
+  #define FRAME_QUEUE_SLOT_SIZE 1024   // เท่ากับ JSON_FRAMER_CAPACITY
+#endif
+
+struct QueuedFrame {
+  uint16_t length;
+  uint32_t startedAt;      // ms: byte แรกของเฟรม
+  uint32_t completedAt;    // ms: ครบเฟรม
+  char data[FRAME_QUEUE_SLOT_SIZE + 1];   // null-terminated
+};
+
+struct FrameQueue {
+  QueuedFrame slots[FRAME_QUEUE_SLOTS];
+  volatile uint32_t head;           // เขียนโดย producer
+  volatile uint32_t tail;           // เขียนโดย consumer
+  volatile uint32_t droppedCount;   // คิวเต็ม / เฟรมใหญ่เกิน slot
+  volatile uint32_t highWater;
+};
+
+inline void FrameQueue_begin(FrameQueue& q) {
+  q.head = 0;
+  q.tail = 0;
+  q.droppedCount = 0;
+  q.highWater = 0;
+}
+
+// ===== Producer =====
+// คืน false ถ้าคิวเต็มหรือเฟรมใหญ่เกิน slot
+inline bool FrameQueue_push(FrameQueue& q, const char* data, size_t length,
+                            uint32_t startedAt, uint32_t completedAt) {
+  if (length > FRAME_QUEUE_SLOT_SIZE) {
+    q.droppedCount = q.droppedCount + 1;
+    return false;
+  }
+
+  uint32_t head = q.head;
+  uint32_t used = head - q.tail;
+  if (used >= FRAME_QUEUE_SLOTS) {
+    q.droppedCount = q.droppedCount + 1;
+    return false;
+  }
+
+  QueuedFrame& frame = q.slots[head % FRAME_QUEUE_SLOTS];
+  memcpy(frame.data, data, length);
+  frame.data[length] = '\0';
+  frame.length = length;
+  frame.startedAt = startedAt;
+  frame.completedAt = completedAt;
+
+  __sync_synchronize();  // ข้อมูลใน slot ต้องเห็นก่อน head ใหม่
+  q.head = head + 1;
+
+  if (used + 1 > q.highWater) {
+    q.highWater = used + 1;
+  }
+  return true;
+}
+
+// ===== Consumer =====
+// slot ที่ได้แก้ไขได้ (parse แบบ in-place) จนกว่าจะ FrameQueue_pop()
+inline QueuedFrame* FrameQueue_peek(FrameQueue& q) {
+  if (q.tail == q.head) {
+    return nullptr;
+  }
+  __sync_synchronize();  // อ่าน slot หลังเห็น head แล้ว
+  return &q.slots[q.tail % FRAME_QUEUE_SLOTS];
+}
+
+inline void FrameQueue_pop(FrameQueue& q) {
+  __sync_synchronize();  // ใช้ slot เสร็จก่อนคืนให้ producer
+  q.tail = q.tail + 1;
+}
+
+inline uint32_t FrameQueue_size(const FrameQueue& q) {
+  return q.head - q.tail;
+}
+
+#endif
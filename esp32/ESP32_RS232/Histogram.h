@@ -0,0 +1,74 @@
+/**
+ * Histogram.h - Histogram ของเวลาแบบ bucket คงที่ (เปิดทิ้งไว้ได้ตลอด)
+ *
+ * bucket ตามจำนวน bit ของค่า: 0 | 1 | 2-3 | 4-7 | 8-15 | ... (ละเอียด 2 เท่าต่อ bucket)
+ * - Histogram_add() = นับ bit ครั้งเดียว + บวก counter (ไม่มี float / heap / lock)
+ * - percentile คืนขอบบนของ bucket (ไม่เกิน max ที่เห็นจริง) → ค่าประมาณไม่เกิน 2 เท่า
+ * - หน่วยแล้วแต่ผู้ใช้ (ms หรือ us) - ตั้งชื่อตัวแปรให้บอกหน่วย
+ *
+ * ไม่ขึ้นกับ Arduino - ต้นฉบับอยู่ที่ common/ (สำเนาใน ESP32_RS232/, center/) - แก้ที่ common/ แล้ว copy ทับ
+ */
+
+#ifndef HISTOGRAM_H
+#define HISTOGRAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+// ===== Configuration =====
+#define HISTOGRAM_BUCKETS 24       // bucket สุดท้ายรับทุกค่า ≥ 2^22
+
+struct Histogram {
+  uint32_t buckets[HISTOGRAM_BUCKETS];
+  uint32_t count;
+  uint32_t max;
+};
+
+inline void Histogram_reset(Histogram& h) {
+  memset(&h, 0, sizeof(h));
+}
+
+inline void Histogram_add(Histogram& h, uint32_t value) {
+  int bucket = value == 0 ? 0 : 32 - __builtin_clz(value);
+  if (bucket >= HISTOGRAM_BUCKETS) {
+    bucket = HISTOGRAM_BUCKETS - 1;
+  }
+  h.buckets[bucket]++;
+  h.count++;
+  if (value > h.max) {
+    h.max = value;
+  }
+}
+
+// percent = 50, 95, 99 ... (0 ถ้ายังไม่มีข้อมูล)
+inline uint32_t Histogram_percentile(const Histogram& h, int percent) {
+  if (h.count == 0) {
+    return 0;
+  }
+  uint32_t target = ((uint64_t)h.count * percent + 99) / 100;
+  uint32_t seen = 0;
+  for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++) {
+    seen += h.buckets[bucket];
+    if (seen >= target && seen > 0) {
+      if (bucket == HISTOGRAM_BUCKETS - 1) {
+        return h.max;
+      }
+      uint32_t upper = bucket == 0 ? 0 : (uint32_t)((1ULL << bucket) - 1);
+      return upper < h.max ? upper : h.max;
+    }
+  }
+  return h.max;
+}
+
+// สรุปแบบสั้นสำหรับ JSON: [count,p50,p95,max]
+inline int Histogram_summary(const Histogram& h, char* out, size_t size) {
+  return snprintf(out, size, "[%lu,%lu,%lu,%lu]",
+                  (unsigned long)h.count,
+                  (unsigned long)Histogram_percentile(h, 50),
+                  (unsigned long)Histogram_percentile(h, 95),
+                  (unsigned long)h.max);
+}
+
+#endif
@@ -0,0 +1,66 @@
+/**
+ * InstrumentProtocol.h
+ * โปรโตคอลของเครื่องมือแพทย์ที่ต่อผ่าน RS232 (ไม่ขึ้นกับบอร์ด/Arduino core)
+ *
+ * แต่ละเครื่อง = struct หนึ่งตัวที่มี static member ชุดเดียวกัน:
+ *   - ID / NAME / DESCRIPTION / FORMAT / BAUD / IDLE_TIMEOUT
+ *   - Framer: แยกเฟรมจาก byte stream (ใช้ใน task รับ UART)
+ *     push(framer, c) / idle(framer) / inFrame() / frame() / reset()
+ *     frame() คืน buffer ของ Framer เอง (แก้ไขได้ - parse แบบ in-place) ใช้ได้จนกว่าจะ reset()
+ *   - Parser: เฟรม → WireReading (ใช้ใน loop) - parse() ต่อเฟรม, poll() สำหรับค่าที่รอคู่
+ *
+ * ทุกเครื่องส่งออกเป็น WireReading (WireProtocol.h) - ฝั่งส่ง Center ไม่ต้องรู้จักเครื่อง
+ *
+ * RS232Reader.h เลือกโปรโตคอลจาก ID ที่บันทึกใน Config ตอนเปิดเครื่อง แล้วเรียกผ่าน
+ * Protocol_dispatch() ครั้งเดียวต่อ chunk/เฟรม - ภายในเป็น template ของโปรโตคอลนั้น
+ * (inline ทั้งหมด ไม่มี virtual / function pointer / heap ในลูปต่อ byte)
+ *
+ * เพิ่มเครื่องใหม่: เขียน struct ตามแบบ WeightTextProtocol.h (ID ใหม่ ห้ามใช้ ID เดิมซ้ำ
+ * เพราะบันทึกอยู่ใน EEPROM) แล้วเพิ่มใน InstrumentProtocols ด้านล่าง
+ *
+ *   ProtocolRegistry.h   - ผลลัพธ์ของ Framer/Parser + ProtocolList + dispatch
+ *   BPJsonProtocol.h     - เครื่องวัดความดัน (ใช้ ArduinoJson)
+ *   WeightTextProtocol.h - เครื่องชั่ง/ส่วนสูง/อุณหภูมิ
+ *
+ * ใช้แค่ C/C++ standard header + ArduinoJson (BPParser.h) - compile บน PC ได้
+ */
+
+#ifndef INSTRUMENT_PROTOCOL_H
+#define INSTRUMENT_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "ProtocolRegistry.h"
+#include "BPJsonProtocol.h"
+#include "WeightTextProtocol.h"
+
+// ===== โปรโตคอลที่ firmware นี้รองรับ (ทุกบอร์ด) =====
+typedef ProtocolList<BPJsonProtocol, WeightTextProtocol> InstrumentProtocols;
+
+// ===== หาโปรโตคอลจาก ID / ชื่อ (nullptr = ไม่รู้จัก) =====
+inline const ProtocolInfo* Protocol_find(uint8_t id) {
+  for (size_t i = 0; i < InstrumentProtocols::COUNT; i++) {
+    if (InstrumentProtocols::table[i].id == id) {
+      return &InstrumentProtocols::table[i];
+    }
+  }
+  return nullptr;
+}
+
+inline const ProtocolInfo* Protocol_findByName(const char* name) {
+  for (size_t i = 0; i < InstrumentProtocols::COUNT; i++) {
+    if (strcmp(InstrumentProtocols::table[i].name, name) == 0) {
+      return &InstrumentProtocols::table[i];
+    }
+  }
+  return nullptr;
+}
+
+// ===== Static dispatch ของ InstrumentProtocols (ProtocolRegistry.h) =====
+template <typename Visitor>
+bool Protocol_dispatch(uint8_t id, Visitor& visitor) {
+  return Protocol_dispatch(id, visitor, (InstrumentProtocols*)nullptr);
+}
+
+#endif
@@ -0,0 +1,350 @@
+/**
+ * Journal.h
+ * บันทึกข้อมูลที่รอส่งลง Flash (LittleFS) - Store-and-Forward
+ *
+ * ทุก reading ถูกเขียนลง journal ก่อนเข้าคิวส่ง และจะถูก mark ว่าส่งแล้ว (ack)
+ * เมื่อ Center ตอบรับ → ถ้าไฟดับ / reboot / WiFi หลุดนาน ข้อมูลยังอยู่ใน flash
+ * และจะถูกส่งซ้ำตามลำดับ seq หลังเชื่อมต่อได้
+ *
+ * รูปแบบไฟล์ /journal.bin: ring ของ slot ขนาดคงที่ (slot = seq % JOURNAL_SLOT_COUNT)
+ * ตามด้วย epoch 4 bytes ท้ายไฟล์
+ *
+ *   [magic 4][seq 4][length 2][ack 1][reserved 1][crc32 4][label 16][payload 320]
+ *
+ * - epoch = ค่าสุ่มที่สร้างใหม่ทุกครั้งที่ seq เริ่มที่ 1 (ไฟล์ใหม่ / ไม่มี record ที่อ่านได้)
+ *   Center ใช้คู่กับ seq กรองซ้ำ → seq ที่เริ่มใหม่ไม่ถูกมองว่าเป็น reading เก่า
+ *   (ไฟล์จาก firmware เก่าที่ไม่มี epoch → ต่อท้ายให้ตอน recover)
+ * - crc32 ครอบคลุม magic, seq, length, label และ payload (ไม่รวม ack)
+ * - ack = 0xFF ยังไม่ส่ง, 0x00 ส่งแล้ว (เขียนทับ byte เดียว)
+ * - ไฟดับระหว่างเขียน: LittleFS จะย้อนไฟล์กลับไปสถานะก่อน flush ล่าสุด
+ *   และ slot ที่ crc ไม่ตรงจะถูกข้ามตอน recover → ไม่มี record ครึ่งๆ กลางๆ
+ * - ring เต็ม: record เก่าสุดถูกเขียนทับ (นับไว้ใน journalLostCount ถ้ายังไม่ได้ส่ง)
+ *
+ * ESP8266: ต้องเลือก Flash Size ที่มี FS อย่างน้อย 64KB ใน Arduino IDE
+ */
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <LittleFS.h>
+
+// ===== Configuration =====
+#define JOURNAL_FILE "/journal.bin"
+#define JOURNAL_MAGIC 0x314A5256UL     // "VRJ1"
+#define JOURNAL_SLOT_COUNT 64
+#define JOURNAL_LABEL_SIZE 16
+#define JOURNAL_PAYLOAD_SIZE 320
+#define JOURNAL_ACK_OFFSET 10          // ตำแหน่ง byte ack ใน slot
+
+struct JournalHeader {
+  uint32_t magic;
+  uint32_t seq;
+  uint16_t length;
+  uint8_t ack;          // 0xFF = ยังไม่ส่ง, 0x00 = ส่งแล้ว
+  uint8_t reserved;
+  uint32_t crc;
+};
+
+#define JOURNAL_SLOT_SIZE (sizeof(JournalHeader) + JOURNAL_LABEL_SIZE + JOURNAL_PAYLOAD_SIZE)
+#define JOURNAL_EPOCH_OFFSET (JOURNAL_SLOT_COUNT * JOURNAL_SLOT_SIZE)
+#define JOURNAL_FILE_SIZE (JOURNAL_EPOCH_OFFSET + 4)
+
+// ===== Variables =====
+File journalFile;
+bool journalReady = false;
+uint32_t journalNextSeq = 1;       // seq ของ record ถัดไป (0 = ไม่มี journal)
+uint32_t journalReplaySeq = 1;     // seq ถัดไปที่ต้องตรวจเพื่อส่งซ้ำ
+uint32_t journalEpoch = 0;         // epoch ของตัวนับ seq (0 = ไม่มี journal)
+int journalPending = 0;            // record ที่ยังไม่ได้ ack
+
+// ===== สถิติ =====
+unsigned long journalAppendCount = 0;
+unsigned long journalAppendTimeTotal = 0;   // us
+unsigned long journalLostCount = 0;         // ถูกเขียนทับก่อนได้ส่ง
+unsigned long journalCorruptCount = 0;      // slot ที่ crc ไม่ตรงตอน recover
+
+// ===== CRC32 (IEEE) =====
+inline uint32_t Journal_crc32(uint32_t crc, const uint8_t* data, size_t length) {
+  crc = ~crc;
+  while (length--) {
+    crc ^= *data++;
+    for (int i = 0; i < 8; i++) {
+      crc = (crc >> 1) ^ (0xEDB88320UL & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+inline uint32_t Journal_recordCrc(const JournalHeader& header, const char* label, const char* payload) {
+  uint32_t crc = Journal_crc32(0, (const uint8_t*)&header.magic, sizeof(header.magic));
+  crc = Journal_crc32(crc, (const uint8_t*)&header.seq, sizeof(header.seq));
+  crc = Journal_crc32(crc, (const uint8_t*)&header.length, sizeof(header.length));
+  crc = Journal_crc32(crc, (const uint8_t*)label, JOURNAL_LABEL_SIZE);
+  return Journal_crc32(crc, (const uint8_t*)payload, header.length);
+}
+
+// ===== อ่าน slot (คืน false ถ้าว่าง/เสีย) =====
+inline bool Journal_readSlot(uint32_t slot, JournalHeader& header, char* label, char* payload) {
+  header.magic = 0;
+  if (!journalFile.seek(slot * JOURNAL_SLOT_SIZE)) {
+    return false;
+  }
+  if (journalFile.read((uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+    return false;
+  }
+  if (header.magic != JOURNAL_MAGIC || header.length > JOURNAL_PAYLOAD_SIZE) {
+    return false;
+  }
+  journalFile.read((uint8_t*)label, JOURNAL_LABEL_SIZE);
+  if (journalFile.read((uint8_t*)payload, header.length) != header.length) {
+    return false;
+  }
+  return Journal_recordCrc(header, label, payload) == header.crc;
+}
+
+// ===== อ่านเฉพาะ header (ใช้ตอน ack / เขียนทับ) =====
+inline bool Journal_readHeader(uint32_t slot, JournalHeader& header) {
+  header.magic = 0;
+  if (!journalFile.seek(slot * JOURNAL_SLOT_SIZE)) {
+    return false;
+  }
+  if (journalFile.read((uint8_t*)&header, sizeof(header)) != sizeof(header)) {
+    return false;
+  }
+  return header.magic == JOURNAL_MAGIC;
+}
+
+// ===== สร้างไฟล์ใหม่ (slot ว่างทั้งหมด) =====
+inline bool Journal_create() {
+  File f = LittleFS.open(JOURNAL_FILE, "w");
+  if (!f) {
+    return false;
+  }
+  uint8_t zero[32] = {0};
+  for (size_t i = 0; i < JOURNAL_EPOCH_OFFSET; i += sizeof(zero)) {
+    f.write(zero, sizeof(zero));
+  }
+  f.write(zero, 4);   // epoch = 0 → สร้างใหม่ตอน recover
+  f.close();
+  return true;
+}
+
+// ===== epoch ใหม่ (สุ่มจาก hardware RNG, ไม่เป็น 0) =====
+inline uint32_t Journal_newEpoch() {
+  #ifdef ESP32
+    uint32_t epoch = esp_random();
+  #elif defined(ESP8266)
+    uint32_t epoch = RANDOM_REG32;
+  #endif
+  return epoch != 0 ? epoch : 1;
+}
+
+// ===== สแกนทุก slot หา seq ล่าสุดและ record ที่ยังไม่ได้ส่ง =====
+inline void Journal_recover() {
+  JournalHeader header;
+  char label[JOURNAL_LABEL_SIZE];
+  char payload[JOURNAL_PAYLOAD_SIZE];
+  uint32_t maxSeq = 0;
+  uint32_t oldestPending = 0;
+
+  journalPending = 0;
+  for (uint32_t slot = 0; slot < JOURNAL_SLOT_COUNT; slot++) {
+    if (!Journal_readSlot(slot, header, label, payload)) {
+      if (header.magic == JOURNAL_MAGIC) {
+        journalCorruptCount++;
+      }
+      continue;
+    }
+    if (header.seq > maxSeq) {
+      maxSeq = header.seq;
+    }
+    if (header.ack == 0xFF) {
+      journalPending++;
+      if (oldestPending == 0 || header.seq < oldestPending) {
+        oldestPending = header.seq;
+      }
+    }
+  }
+
+  journalNextSeq = maxSeq + 1;
+  journalReplaySeq = oldestPending != 0 ? oldestPending : journalNextSeq;
+
+  // seq เริ่มที่ 1 ใหม่ → epoch ใหม่ (ไม่อย่างนั้น Center จะเห็น seq 1, 2, ... เป็นของเก่า)
+  journalEpoch = 0;
+  if (journalFile.seek(JOURNAL_EPOCH_OFFSET)) {
+    journalFile.read((uint8_t*)&journalEpoch, sizeof(journalEpoch));
+  }
+  if (maxSeq == 0 || journalEpoch == 0) {
+    journalEpoch = Journal_newEpoch();
+    journalFile.seek(JOURNAL_EPOCH_OFFSET);
+    journalFile.write((const uint8_t*)&journalEpoch, sizeof(journalEpoch));
+    journalFile.flush();
+  }
+}
+
+// ===== เริ่มต้น =====
+inline bool Journal_begin() {
+  #ifdef ESP32
+    bool mounted = LittleFS.begin(true);   // format อัตโนมัติถ้า mount ไม่ได้
+  #elif defined(ESP8266)
+    bool mounted = LittleFS.begin();
+    if (!mounted) {
+      LittleFS.format();
+      mounted = LittleFS.begin();
+    }
+  #endif
+
+  if (!mounted) {
+    Serial.println("❌ LittleFS mount ไม่ได้ - ไม่มี journal (ข้อมูลจะอยู่ใน RAM เท่านั้น)");
+    return false;
+  }
+
+  bool valid = false;
+  if (LittleFS.exists(JOURNAL_FILE)) {
+    File f = LittleFS.open(JOURNAL_FILE, "r");
+    valid = f && (f.size() == JOURNAL_FILE_SIZE || f.size() == JOURNAL_EPOCH_OFFSET);
+    f.close();
+  }
+  if (!valid && !Journal_create()) {
+    Serial.println("❌ สร้างไฟล์ journal ไม่ได้");
+    return false;
+  }
+
+  journalFile = LittleFS.open(JOURNAL_FILE, "r+");
+  if (!journalFile) {
+    Serial.println("❌ เปิดไฟล์ journal ไม่ได้");
+    return false;
+  }
+
+  unsigned long start = millis();
+  Journal_recover();
+  journalReady = true;
+
+  Serial.println("💾 Journal (LittleFS)");
+  Serial.printf("   Slots: %d x %d bytes\n", JOURNAL_SLOT_COUNT, (int)JOURNAL_SLOT_SIZE);
+  Serial.printf("   รอส่งจากครั้งก่อน: %d รายการ | seq ถัดไป: %lu | epoch: %08lX | recover: %lu ms\n",
+                journalPending, (unsigned long)journalNextSeq, (unsigned long)journalEpoch,
+                millis() - start);
+  if (journalCorruptCount > 0) {
+    Serial.printf("   ⚠️  slot เสีย (เขียนไม่ครบ): %lu\n", journalCorruptCount);
+  }
+  Serial.println();
+  return true;
+}
+
+// ===== เพิ่ม record (คืน seq, 0 = เขียนไม่ได้) =====
+inline uint32_t Journal_append(const char* payload, size_t length, const char* label) {
+  if (!journalReady || length > JOURNAL_PAYLOAD_SIZE) {
+    return 0;
+  }
+
+  unsigned long start = micros();
+  uint32_t seq = journalNextSeq;
+  uint32_t slot = seq % JOURNAL_SLOT_COUNT;
+
+  // slot นี้ยังมี record เก่าที่ยังไม่ได้ส่ง → จะหายไป
+  JournalHeader old;
+  if (Journal_readHeader(slot, old) && old.ack == 0xFF) {
+    journalPending--;
+    journalLostCount++;
+  }
+
+  JournalHeader header;
+  header.magic = JOURNAL_MAGIC;
+  header.seq = seq;
+  header.length = length;
+  header.ack = 0xFF;
+  header.reserved = 0;
+
+  char labelField[JOURNAL_LABEL_SIZE] = {0};
+  strlcpy(labelField, label, sizeof(labelField));
+  header.crc = Journal_recordCrc(header, labelField, payload);
+
+  journalFile.seek(slot * JOURNAL_SLOT_SIZE);
+  journalFile.write((const uint8_t*)&header, sizeof(header));
+  journalFile.write((const uint8_t*)labelField, sizeof(labelField));
+  journalFile.write((const uint8_t*)payload, length);
+  journalFile.flush();   // commit ลง flash
+
+  journalNextSeq++;
+  journalPending++;
+
+  // ส่งซ้ำได้ไม่เกินจำนวน slot (ที่เก่ากว่านั้นถูกเขียนทับแล้ว)
+  if (journalNextSeq - journalReplaySeq > JOURNAL_SLOT_COUNT) {
+    journalReplaySeq = journalNextSeq - JOURNAL_SLOT_COUNT;
+  }
+
+  journalAppendCount++;
+  journalAppendTimeTotal += micros() - start;
+  return seq;
+}
+
+// ===== seq ที่ Journal_append() ครั้งถัดไปจะให้ (0 = ไม่มี journal) =====
+// ใส่ seq ลงใน payload ก่อน append ได้ (ต้อง append ต่อทันทีโดยไม่มี append อื่นคั่น)
+inline uint32_t Journal_peekNextSeq() {
+  return journalReady ? journalNextSeq : 0;
+}
+
+// ===== epoch ของตัวนับ seq (0 = ไม่มี journal) - ส่งคู่กับ seq เสมอ =====
+inline uint32_t Journal_getEpoch() {
+  return journalReady ? journalEpoch : 0;
+}
+
+// ===== Mark ว่าส่งแล้ว =====
+inline void Journal_ack(uint32_t seq) {
+  if (!journalReady || seq == 0) {
+    return;
+  }
+
+  uint32_t slot = seq % JOURNAL_SLOT_COUNT;
+  JournalHeader header;
+  if (!Journal_readHeader(slot, header) || header.seq != seq || header.ack != 0xFF) {
+    return;
+  }
+
+  uint8_t acked = 0x00;
+  journalFile.seek(slot * JOURNAL_SLOT_SIZE + JOURNAL_ACK_OFFSET);
+  journalFile.write(&acked, 1);
+  journalFile.flush();
+  journalPending--;
+}
+
+// ===== Backlog สำหรับส่งซ้ำ (เรียงตาม seq) =====
+inline bool Journal_hasBacklog() {
+  return journalReady && journalReplaySeq < journalNextSeq;
+}
+
+// อ่าน record ถัดไปตาม replay cursor แล้วเลื่อน cursor
+// payload ต้องมีขนาดอย่างน้อย JOURNAL_PAYLOAD_SIZE + 1, label อย่างน้อย JOURNAL_LABEL_SIZE
+// คืน seq ของ record (0 = slot นี้ส่งแล้ว/ถูกเขียนทับ/เสีย → ข้ามได้เลย)
+inline uint32_t Journal_nextBacklog(char* payload, uint16_t& length, char* label) {
+  uint32_t seq = journalReplaySeq++;
+  JournalHeader header;
+
+  if (!Journal_readSlot(seq % JOURNAL_SLOT_COUNT, header, label, payload)) {
+    return 0;
+  }
+  if (header.seq != seq || header.ack != 0xFF) {
+    return 0;
+  }
+
+  label[JOURNAL_LABEL_SIZE - 1] = '\0';
+  payload[header.length] = '\0';
+  length = header.length;
+  return seq;
+}
+
+// ===== สถิติ =====
+inline int Journal_getPendingCount() {
+  return journalPending;
+}
+
+inline unsigned long Journal_getLostCount() {
+  return journalLostCount;
+}
+
+inline unsigned long Journal_getMeanAppendTime() {
+  return journalAppendCount > 0 ? journalAppendTimeTotal / journalAppendCount : 0;
+}
+
+#endif
@@ -0,0 +1,184 @@
+/**
+ * JsonFramer.h
+ * ตัวแยกเฟรม JSON แบบ streaming สำหรับข้อมูลจาก RS232
+ *
+ * ป้อนข้อมูลทีละ byte แล้วจะได้เฟรมทันทีที่ '}' ตัวนอกสุดมาถึง
+ * (ไม่ต้องรอ idle gap) โดยนับความลึกของ { } และติดตามสถานะ string/escape
+ * เพื่อไม่ให้ { } ที่อยู่ใน string ทำให้นับผิด
+ *
+ * - ข้อมูลขยะก่อน '{' จะถูกทิ้ง (resync อัตโนมัติ)
+ * - เฟรมที่ใหญ่เกิน JSON_FRAMER_CAPACITY จะถูกข้ามจนจบเฟรม แล้วเริ่มใหม่
+ * - เฟรมที่ซ้อนลึกผิดปกติ (> JSON_FRAMER_MAX_DEPTH) หรือปิดวงเล็บผิดชนิด ({"a":[1}) ถือว่าเสีย
+ *   แล้วข้ามต่อจนกว่า '}' นอกสุด
+ *   จะปิดเฟรม หรือสายเงียบ (JsonFramer_idle) จึงรอ '{' ใหม่
+ *   → '{' ด้านในของเฟรมที่เสียไม่ถูกนับเป็นต้นเฟรมใหม่
+ * - ใช้ buffer ขนาดคงที่ ไม่มีการจอง heap
+ */
+
+#ifndef JSON_FRAMER_H
+#define JSON_FRAMER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ===== Configuration =====
+#ifndef JSON_FRAMER_CAPACITY
+  #define JSON_FRAMER_CAPACITY 1024  // JSON จากเครื่องวัดความดัน ~400-500 bytes
+#endif
+#ifndef JSON_FRAMER_MAX_DEPTH
+  #define JSON_FRAMER_MAX_DEPTH 16
+#endif
+static_assert(JSON_FRAMER_MAX_DEPTH <= 32, "ชนิดวงเล็บเก็บใน bit ของ JsonFramer::arrays (32 ระดับ)");
+
+// ===== ผลลัพธ์จากการป้อน byte =====
+enum JsonFramerResult : uint8_t {
+  JSON_FRAMER_NONE = 0,   // ยังไม่ครบเฟรม
+  JSON_FRAMER_FRAME,      // ได้เฟรมครบ (อยู่ใน buffer, null-terminated)
+  JSON_FRAMER_OVERFLOW,   // เฟรมใหญ่เกิน buffer - กำลังข้ามจนจบเฟรม
+  JSON_FRAMER_CORRUPT     // โครงสร้างผิดปกติ - ข้ามจนจบเฟรม/สายเงียบ แล้วรอ '{' ใหม่
+};
+
+// ===== สถานะของ Framer =====
+struct JsonFramer {
+  char buffer[JSON_FRAMER_CAPACITY + 1];
+  size_t length;
+  uint8_t depth;        // 0 = อยู่นอกเฟรม (รอ '{')
+  uint32_t arrays;      // bit (d - 1) = ระดับ d เปิดด้วย '[' (ไม่ใช่ '{')
+  bool inString;
+  bool escaped;
+  bool skipping;        // เฟรมใหญ่เกิน/เสีย - นับความลึกต่อแต่ไม่เก็บ byte
+  bool corrupt;         // ลึกเกิน / วงเล็บไม่คู่กัน (รายงานแล้ว - ข้ามจนจบเฟรม)
+
+  // สถิติ
+  uint32_t frameCount;
+  uint32_t garbageBytes;
+  uint32_t overflowCount;
+  uint32_t corruptCount;
+};
+
+// ===== Reset สถานะ (ไม่ล้างสถิติ) =====
+inline void JsonFramer_reset(JsonFramer& f) {
+  f.length = 0;
+  f.depth = 0;
+  f.arrays = 0;
+  f.inString = false;
+  f.escaped = false;
+  f.skipping = false;
+  f.corrupt = false;
+  f.buffer[0] = '\0';
+}
+
+// ===== เริ่มต้น (ล้างสถิติด้วย) =====
+inline void JsonFramer_begin(JsonFramer& f) {
+  JsonFramer_reset(f);
+  f.frameCount = 0;
+  f.garbageBytes = 0;
+  f.overflowCount = 0;
+  f.corruptCount = 0;
+}
+
+// ===== กำลังอยู่ระหว่างเฟรมหรือไม่ =====
+inline bool JsonFramer_inFrame(const JsonFramer& f) {
+  return f.depth > 0;
+}
+
+// ===== สายเงียบกลางเฟรม: ทิ้งที่ค้างแล้วรอ '{' ใหม่ =====
+// คืน false ถ้ากำลังข้ามเฟรมเสียอยู่ (รายงาน CORRUPT ไปแล้ว ไม่ต้องนับเป็นเฟรมไม่ครบซ้ำ)
+inline bool JsonFramer_idle(JsonFramer& f) {
+  bool incomplete = !f.corrupt;
+  JsonFramer_reset(f);
+  return incomplete;
+}
+
+// ===== เฟรมเสีย: รายงานครั้งเดียว แล้วนับความลึกต่อโดยไม่เก็บ byte =====
+// ไม่ reset ตรงนี้ - ไม่อย่างนั้น '{' ด้านในถัดไปจะกลายเป็นต้นเฟรมใหม่
+inline JsonFramerResult JsonFramer_markCorrupt(JsonFramer& f) {
+  f.corruptCount++;
+  f.corrupt = true;
+  f.skipping = true;
+  f.length = 0;
+  return JSON_FRAMER_CORRUPT;
+}
+
+// ===== ป้อนข้อมูล 1 byte =====
+// เมื่อได้ JSON_FRAMER_FRAME ต้องใช้ buffer ให้เสร็จก่อนป้อน byte ถัดไป
+inline JsonFramerResult JsonFramer_push(JsonFramer& f, char c) {
+  // นอกเฟรม: ทิ้งทุกอย่างจนกว่าจะเจอ '{'
+  if (f.depth == 0) {
+    if (c != '{') {
+      f.garbageBytes++;
+      return JSON_FRAMER_NONE;
+    }
+    JsonFramer_reset(f);
+  }
+
+  // เก็บ byte (ถ้ายังไม่เกินขนาด)
+  JsonFramerResult result = JSON_FRAMER_NONE;
+  if (!f.skipping) {
+    if (f.length < JSON_FRAMER_CAPACITY) {
+      f.buffer[f.length++] = c;
+    } else {
+      f.skipping = true;
+      f.overflowCount++;
+      result = JSON_FRAMER_OVERFLOW;
+    }
+  }
+
+  // ภายใน string: สนใจแค่ escape และ '"' ปิด
+  if (f.inString) {
+    if (f.escaped) {
+      f.escaped = false;
+    } else if (c == '\\') {
+      f.escaped = true;
+    } else if (c == '"') {
+      f.inString = false;
+    }
+    return result;
+  }
+
+  switch (c) {
+    case '"':
+      f.inString = true;
+      break;
+
+    case '{':
+    case '[':
+      if (f.depth >= JSON_FRAMER_MAX_DEPTH && !f.corrupt) {
+        result = JsonFramer_markCorrupt(f);
+      }
+      if (f.depth < JSON_FRAMER_MAX_DEPTH) {
+        uint32_t bit = (uint32_t)1 << f.depth;
+        f.arrays = c == '[' ? f.arrays | bit : f.arrays & ~bit;
+      }
+      if (f.depth < 255) {
+        f.depth++;
+      }
+      break;
+
+    case '}':
+    case ']':
+      if (!f.corrupt && f.depth <= JSON_FRAMER_MAX_DEPTH &&
+          ((f.arrays >> (f.depth - 1)) & 1) != (c == ']')) {
+        result = JsonFramer_markCorrupt(f);   // {"a":[1} - ข้ามจน '}' นอกสุด / สายเงียบ
+      }
+      f.depth--;
+      if (f.depth == 0) {
+        if (f.skipping) {
+          // จบเฟรมที่ใหญ่เกิน/เสียแล้ว - กลับไปรอเฟรมใหม่ (CORRUPT ถ้าเสียที่ '}' ตัวนี้เอง)
+          JsonFramer_reset(f);
+          return result;
+        }
+        f.buffer[f.length] = '\0';
+        f.frameCount++;
+        return JSON_FRAMER_FRAME;
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  return result;
+}
+
+#endif
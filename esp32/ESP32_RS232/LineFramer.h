@@ -0,0 +1,90 @@
+/**
+ * LineFramer.h
+ * ตัวแยกบรรทัด Text แบบ streaming สำหรับข้อมูลจาก RS232 (เครื่องชั่ง: W:070.3 H:173.5)
+ *
+ * ป้อนข้อมูลทีละ byte - ได้บรรทัดเมื่อเจอ '\n' หรือ '\r'
+ * บรรทัดที่ไม่มี newline ปิด (เช่น T365$) ให้ผู้เรียก LineFramer_finish() เมื่อสายเงียบไป
+ *
+ * - บรรทัดว่าง (\r\n ติดกัน) ไม่นับเป็นบรรทัด
+ * - บรรทัดที่ยาวเกิน LINE_FRAMER_CAPACITY จะถูกทิ้งทั้งบรรทัด (ไม่ตัดครึ่ง)
+ * - ใช้ buffer ขนาดคงที่ ไม่มีการจอง heap
+ */
+
+#ifndef LINE_FRAMER_H
+#define LINE_FRAMER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ===== Configuration =====
+#ifndef LINE_FRAMER_CAPACITY
+  #define LINE_FRAMER_CAPACITY 256   // บรรทัดของเครื่องชั่ง < 64 bytes
+#endif
+
+// ===== ผลลัพธ์จากการป้อน byte =====
+enum LineFramerResult : uint8_t {
+  LINE_FRAMER_NONE = 0,   // ยังไม่จบบรรทัด
+  LINE_FRAMER_FRAME,      // ได้บรรทัด (อยู่ใน buffer, null-terminated)
+  LINE_FRAMER_OVERFLOW    // บรรทัดยาวเกิน buffer - ทิ้งแล้ว
+};
+
+// ===== สถานะของ Framer =====
+struct LineFramer {
+  char buffer[LINE_FRAMER_CAPACITY + 1];
+  size_t length;
+  bool overflow;        // ยาวเกิน - ทิ้ง byte จนจบบรรทัด
+
+  // สถิติ
+  uint32_t lineCount;
+  uint32_t overflowCount;
+};
+
+// ===== Reset สถานะ (ไม่ล้างสถิติ) =====
+inline void LineFramer_reset(LineFramer& f) {
+  f.length = 0;
+  f.overflow = false;
+  f.buffer[0] = '\0';
+}
+
+// ===== เริ่มต้น (ล้างสถิติด้วย) =====
+inline void LineFramer_begin(LineFramer& f) {
+  LineFramer_reset(f);
+  f.lineCount = 0;
+  f.overflowCount = 0;
+}
+
+// ===== กำลังอยู่ระหว่างบรรทัดหรือไม่ =====
+inline bool LineFramer_inFrame(const LineFramer& f) {
+  return f.length > 0 || f.overflow;
+}
+
+// ===== จบบรรทัด (newline หรือสายเงียบ) =====
+inline LineFramerResult LineFramer_finish(LineFramer& f) {
+  if (f.overflow) {
+    f.overflowCount++;
+    LineFramer_reset(f);
+    return LINE_FRAMER_OVERFLOW;
+  }
+  if (f.length == 0) {
+    return LINE_FRAMER_NONE;
+  }
+  f.buffer[f.length] = '\0';
+  f.lineCount++;
+  return LINE_FRAMER_FRAME;
+}
+
+// ===== ป้อนข้อมูล 1 byte =====
+// เมื่อได้ LINE_FRAMER_FRAME ต้องใช้ buffer ให้เสร็จ แล้ว LineFramer_reset() ก่อนป้อน byte ถัดไป
+inline LineFramerResult LineFramer_push(LineFramer& f, char c) {
+  if (c == '\n' || c == '\r') {
+    return LineFramer_finish(f);
+  }
+  if (f.length < LINE_FRAMER_CAPACITY) {
+    f.buffer[f.length++] = c;
+  } else {
+    f.overflow = true;
+  }
+  return LINE_FRAMER_NONE;
+}
+
+#endif
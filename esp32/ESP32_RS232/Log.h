@@ -0,0 +1,166 @@
+/**
+ * Log.h - Log แบบกำหนดระดับตอน compile และเขียนลง RAM ก่อนส่งออก Serial
+ *
+ * ที่ 115200 baud Serial ส่งได้ ~11 bytes/ms: เมื่อ TX FIFO เต็ม Serial.print จะ block
+ * log หลายร้อย bytes ต่อ reading จึงหน่วง handler เป็นสิบ ms
+ *
+ * - LOG_E / LOG_W / LOG_I / LOG_D ใช้แบบ printf
+ * - ระดับที่สูงกว่า LOG_LEVEL ถูกตัดออกตอน compile (argument ไม่ถูกประเมินเลย)
+ * - LOG_DEFERRED = 1: เขียนลง ring buffer ใน RAM แล้ว Log_drain() ทยอยส่งเท่าที่ TX FIFO ว่าง
+ *   (ไม่ block) ส่วน Log_flush() ส่งทั้งหมดทันที (เช่นจากคำสั่ง Serial)
+ * - LOG_DEFERRED = 0: พิมพ์ตรงแบบเดิม
+ * - buffer เต็ม → ทิ้งข้อความใหม่และนับไว้ (แจ้งจำนวนที่หายตอน drain)
+ *
+ * ตั้งค่า LOG_LEVEL / LOG_DEFERRED ใน Config.h (ก่อน include ไฟล์นี้)
+ * ต้นฉบับอยู่ที่ common/ (สำเนาใน ESP32_RS232/, center/, device/) - แก้ที่ common/ แล้ว copy ทับ
+ */
+
+#ifndef LOG_H
+#define LOG_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+// ===== ระดับ Log =====
+#define LOG_LEVEL_NONE 0
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#ifndef LOG_LEVEL
+  #define LOG_LEVEL LOG_LEVEL_INFO
+#endif
+
+#ifndef LOG_DEFERRED
+  #define LOG_DEFERRED 1
+#endif
+
+// ===== Configuration =====
+// LOG_LINE_MAX = ข้อความยาวสุดต่อครั้ง (ส่วนเกินถูกตัด) - ESP32 ต้องพอสำหรับ JSON จากเครื่องวัดความดัน
+#ifdef ESP32
+  #define LOG_BUFFER_SIZE 4096
+  #define LOG_LINE_MAX 512
+#else
+  #define LOG_BUFFER_SIZE 2048
+  #define LOG_LINE_MAX 192
+#endif
+
+// ===== Macros =====
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+  #define LOG_E(...) Log_write(__VA_ARGS__)
+#else
+  #define LOG_E(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+  #define LOG_W(...) Log_write(__VA_ARGS__)
+#else
+  #define LOG_W(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+  #define LOG_I(...) Log_write(__VA_ARGS__)
+#else
+  #define LOG_I(...) do {} while (0)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+  #define LOG_D(...) Log_write(__VA_ARGS__)
+#else
+  #define LOG_D(...) do {} while (0)
+#endif
+
+// ===== Ring buffer =====
+char logBuffer[LOG_BUFFER_SIZE];
+volatile size_t logHead = 0;       // ตำแหน่งเขียนถัดไป
+volatile size_t logTail = 0;       // ตำแหน่งอ่านถัดไป
+unsigned long logDroppedCount = 0;
+unsigned long logDroppedReported = 0;
+
+#ifdef ESP32
+  portMUX_TYPE logMux = portMUX_INITIALIZER_UNLOCKED;
+  #define LOG_LOCK() portENTER_CRITICAL(&logMux)
+  #define LOG_UNLOCK() portEXIT_CRITICAL(&logMux)
+#else
+  #define LOG_LOCK() do {} while (0)
+  #define LOG_UNLOCK() do {} while (0)
+#endif
+
+size_t Log_pending() {
+  return (logHead + LOG_BUFFER_SIZE - logTail) % LOG_BUFFER_SIZE;
+}
+
+void Log_append(const char* text, size_t length) {
+  LOG_LOCK();
+  size_t space = LOG_BUFFER_SIZE - 1 - Log_pending();
+  if (length > space) {
+    logDroppedCount++;
+  } else {
+    for (size_t i = 0; i < length; i++) {
+      logBuffer[logHead] = text[i];
+      logHead = (logHead + 1) % LOG_BUFFER_SIZE;
+    }
+  }
+  LOG_UNLOCK();
+}
+
+// ===== เขียน Log (เรียกผ่าน macro) =====
+void Log_write(const char* format, ...) {
+  char line[LOG_LINE_MAX];
+  va_list args;
+  va_start(args, format);
+  int length = vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  if (length <= 0) {
+    return;
+  }
+  if (length >= (int)sizeof(line)) {
+    length = sizeof(line) - 1;
+  }
+
+#if LOG_DEFERRED
+  Log_append(line, length);
+#else
+  Serial.write((const uint8_t*)line, length);
+#endif
+}
+
+// ===== ส่งออก Serial เท่าที่ TX FIFO ว่าง (ไม่ block) - เรียกตอนว่าง =====
+void Log_drain() {
+  if (logDroppedCount != logDroppedReported && Serial.availableForWrite() > 48) {
+    Serial.printf("\n⚠️  [LOG] buffer เต็ม ทิ้งไป %lu ข้อความ\n", logDroppedCount - logDroppedReported);
+    logDroppedReported = logDroppedCount;
+  }
+
+  size_t room = Serial.availableForWrite();
+  while (room > 0 && logTail != logHead) {
+    // ส่งเป็นช่วงต่อเนื่องใน buffer (ไม่ข้ามรอยต่อของ ring)
+    size_t head = logHead;
+    size_t end = head > logTail ? head : LOG_BUFFER_SIZE;
+    size_t chunk = end - logTail;
+    if (chunk > room) {
+      chunk = room;
+    }
+    Serial.write((const uint8_t*)logBuffer + logTail, chunk);
+    LOG_LOCK();
+    logTail = (logTail + chunk) % LOG_BUFFER_SIZE;
+    LOG_UNLOCK();
+    room -= chunk;
+  }
+}
+
+// ===== ส่งทั้งหมดทันที (block จนหมด) =====
+void Log_flush() {
+  while (logTail != logHead) {
+    size_t head = logHead;
+    size_t end = head > logTail ? head : LOG_BUFFER_SIZE;
+    Serial.write((const uint8_t*)logBuffer + logTail, end - logTail);
+    LOG_LOCK();
+    logTail = end % LOG_BUFFER_SIZE;
+    LOG_UNLOCK();
+  }
+  Serial.flush();
+}
+
+#endif
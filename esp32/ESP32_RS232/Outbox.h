@@ -0,0 +1,112 @@
+/**
+ * Outbox.h
+ * คิวข้อมูลรอส่งไปยัง Center (เก็บใน RAM)
+ *
+ * ข้อมูลที่อ่านได้จาก RS232 จะถูกสร้างเป็น payload แล้วเข้าคิวนี้ทันที
+ * งาน Uplink จะทยอยส่งทีละรายการ ถ้าส่งไม่สำเร็จ (WiFi หลุด / Center ไม่ตอบ)
+ * รายการยังอยู่ในคิวรอส่งใหม่ ไม่หายไประหว่าง reconnect
+ *
+ * ถ้าคิวเต็มจะทิ้งรายการที่เก่าที่สุด (นับไว้ใน outboxDroppedCount)
+ * เมื่อมี Journal ผู้เรียกจะไม่ push ตอนคิวเต็ม - รายการจะรออยู่ใน flash แทน
+ * และแต่ละรายการเก็บ seq ของ journal ไว้สำหรับ ack หลังส่งสำเร็จ
+ */
+
+#ifndef OUTBOX_H
+#define OUTBOX_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ===== Configuration =====
+#ifdef ESP32
+  #define OUTBOX_CAPACITY 16
+#else
+  #define OUTBOX_CAPACITY 8     // ESP8266 มี RAM น้อยกว่า
+#endif
+#define OUTBOX_PAYLOAD_SIZE 320
+#define OUTBOX_LABEL_SIZE 16
+
+struct OutboxEntry {
+  char payload[OUTBOX_PAYLOAD_SIZE];
+  uint16_t length;
+  char label[OUTBOX_LABEL_SIZE];   // ใช้แสดงใน log เช่น "BP", "Weight+Height"
+  uint8_t attempts;
+  uint32_t seq;                    // seq ใน Journal (0 = ไม่มี journal)
+  unsigned long queuedAt;          // millis() ตอนอ่านได้ (0 = ไม่ทราบ เช่นส่งซ้ำจาก Journal)
+};
+
+// ===== Variables =====
+OutboxEntry outbox[OUTBOX_CAPACITY];
+uint8_t outboxHead = 0;    // index ของรายการเก่าสุด
+uint8_t outboxCount = 0;
+unsigned long outboxDroppedCount = 0;
+
+// ===== เพิ่มรายการท้ายคิว =====
+inline bool Outbox_push(const char* payload, size_t length, const char* label, uint32_t seq = 0,
+                        unsigned long queuedAt = 0) {
+  if (length >= OUTBOX_PAYLOAD_SIZE) {
+    return false;
+  }
+
+  // คิวเต็ม → ทิ้งรายการเก่าสุด
+  if (outboxCount == OUTBOX_CAPACITY) {
+    outboxHead = (outboxHead + 1) % OUTBOX_CAPACITY;
+    outboxCount--;
+    outboxDroppedCount++;
+  }
+
+  OutboxEntry& entry = outbox[(outboxHead + outboxCount) % OUTBOX_CAPACITY];
+  memcpy(entry.payload, payload, length);
+  entry.payload[length] = '\0';
+  entry.length = length;
+  strlcpy(entry.label, label, sizeof(entry.label));
+  entry.attempts = 0;
+  entry.seq = seq;
+  entry.queuedAt = queuedAt;
+
+  outboxCount++;
+  return true;
+}
+
+// ===== ดูรายการแรก (nullptr = คิวว่าง) =====
+inline OutboxEntry* Outbox_peek() {
+  return outboxCount > 0 ? &outbox[outboxHead] : nullptr;
+}
+
+// ===== ดูรายการลำดับที่ index (0 = เก่าสุด) =====
+inline OutboxEntry* Outbox_at(int index) {
+  return index < outboxCount ? &outbox[(outboxHead + index) % OUTBOX_CAPACITY] : nullptr;
+}
+
+// ===== เอารายการแรกออก (หลังส่งสำเร็จ) =====
+inline void Outbox_pop() {
+  if (outboxCount == 0) {
+    return;
+  }
+  outboxHead = (outboxHead + 1) % OUTBOX_CAPACITY;
+  outboxCount--;
+}
+
+// ===== มีรายการ seq นี้ในคิวแล้วหรือไม่ =====
+inline bool Outbox_contains(uint32_t seq) {
+  for (uint8_t i = 0; i < outboxCount; i++) {
+    if (outbox[(outboxHead + i) % OUTBOX_CAPACITY].seq == seq) {
+      return true;
+    }
+  }
+  return false;
+}
+
+inline bool Outbox_isFull() {
+  return outboxCount == OUTBOX_CAPACITY;
+}
+
+inline int Outbox_size() {
+  return outboxCount;
+}
+
+inline unsigned long Outbox_getDroppedCount() {
+  return outboxDroppedCount;
+}
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ * ProtocolRegistry.h
+ * ส่วนกลางของ InstrumentProtocol.h ที่ไม่ขึ้นกับโปรโตคอลใด:
+ * ผลลัพธ์ของ Framer/Parser, ProtocolInfo, ProtocolList และ Protocol_dispatch() แบบ compile-time
+ *
+ * แยกออกมาเพื่อให้ test บน PC ใช้ ProtocolList ของตัวเองได้ (เช่นโปรโตคอลปลอม)
+ * โดยไม่ต้องมี ArduinoJson - ใช้แค่ C/C++ standard header
+ */
+
+#ifndef PROTOCOL_REGISTRY_H
+#define PROTOCOL_REGISTRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// ===== ผลลัพธ์ของ Framer =====
+enum ProtocolFrameResult : uint8_t {
+  PROTOCOL_FRAME_NONE = 0,     // ยังไม่ครบเฟรม
+  PROTOCOL_FRAME_READY,        // ได้เฟรม - อ่านด้วย frame() แล้ว reset()
+  PROTOCOL_FRAME_OVERFLOW,     // เฟรมใหญ่เกิน buffer - ทิ้ง
+  PROTOCOL_FRAME_CORRUPT,      // โครงสร้างผิดปกติ - ทิ้ง
+  PROTOCOL_FRAME_INCOMPLETE    // สายเงียบกลางเฟรม - ทิ้ง
+};
+
+// ===== ผลลัพธ์ของ Parser =====
+enum ProtocolParseResult : uint8_t {
+  PROTOCOL_PARSE_NONE = 0,     // poll(): ไม่มีอะไรต้องทำ
+  PROTOCOL_PARSE_READING,      // ได้ WireReading พร้อมส่ง
+  PROTOCOL_PARSE_PARTIAL,      // ข้อมูลถูกต้อง แต่รอส่วนที่เหลือ (หรือไม่มีค่าที่ต้องส่ง)
+  PROTOCOL_PARSE_ERROR,        // เฟรมใช้ไม่ได้ (รายละเอียดใน parser.error)
+  PROTOCOL_PARSE_EXPIRED       // poll(): รอส่วนที่เหลือไม่ทัน - ทิ้งค่าที่ค้าง
+};
+
+// =============================================================================
+// ===== Registry (compile-time) =====
+// =============================================================================
+struct ProtocolInfo {
+  uint8_t id;
+  const char* name;
+  const char* description;
+  const char* format;
+  uint32_t baud;
+};
+
+template <typename P>
+constexpr ProtocolInfo Protocol_info() {
+  return ProtocolInfo{ P::ID, P::NAME, P::DESCRIPTION, P::FORMAT, P::BAUD };
+}
+
+template <typename... Ps>
+struct ProtocolList {
+  static constexpr size_t COUNT = sizeof...(Ps);
+  static constexpr ProtocolInfo table[sizeof...(Ps)] = { Protocol_info<Ps>()... };
+};
+
+template <typename... Ps>
+constexpr ProtocolInfo ProtocolList<Ps...>::table[sizeof...(Ps)];
+
+// ===== Static dispatch: ID → visitor.template apply<P>() =====
+// visitor เป็น struct ที่มี template <typename P> void apply() - compiler ขยายเป็น if/else
+// ของ ID แล้ว inline apply<P>() ของแต่ละโปรโตคอล (คืน false ถ้าไม่รู้จัก ID)
+template <typename Visitor>
+bool Protocol_dispatch(uint8_t id, Visitor& visitor, ProtocolList<>*) {
+  return false;
+}
+
+template <typename Visitor, typename P, typename... Rest>
+bool Protocol_dispatch(uint8_t id, Visitor& visitor, ProtocolList<P, Rest...>*) {
+  if (id == P::ID) {
+    visitor.template apply<P>();
+    return true;
+  }
+  return Protocol_dispatch(id, visitor, (ProtocolList<Rest...>*)nullptr);
+}
+
+#endif
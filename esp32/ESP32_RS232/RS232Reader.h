@@ -0,0 +1,623 @@
+/**
+ * RS232Reader.h
+ * รับข้อมูลจากเครื่องมือแพทย์ผ่าน RS232 - โปรโตคอลเลือกจาก Config ตอนเปิดเครื่อง
+ * (ดูรายการใน InstrumentProtocol.h - firmware เดียวรองรับทุกเครื่อง)
+ *
+ * ไฟล์นี้ดูแลแค่การรับ byte ตามบอร์ด:
+ *   ESP32:   UART2 GPIO16(RX)/GPIO17(TX) - UART driver (ring 4KB) → event queue
+ *            → rs232IngestTask (core 0) แยกเฟรม → FrameQueue (lock-free)
+ *            → RS232_loop() ใน loop() (core 1) parse + callback
+ *            loop() ติด HTTP นานแค่ไหน byte ก็ไม่ล้น - เฟรมที่ครบแล้วรอในคิว
+ *   ESP8266: SoftwareSerial D7(RX)/D8(TX) - RS232_loop() อ่านเท่าที่มีแล้วคืนทันที (non-blocking)
+ *            รับและ parse ใน loop() เดียวกัน → parse จาก buffer ของ Framer ได้เลย (ไม่ผ่านคิว)
+ *            JSON ของเครื่องวัดความดันที่ 115200 baud เกินกำลัง SoftwareSerial - ใช้ ESP32
+ *
+ * byte ถูกส่งให้ Framer/Parser ของโปรโตคอลที่เลือก ผ่าน Protocol_dispatch() ครั้งเดียวต่อ chunk/เฟรม
+ * (ลูปต่อ byte เป็น template ไม่มี virtual)
+ *
+ * Baud rate: ใช้ค่าที่บันทึกไว้ (lock ทันที) หรือหาเองด้วย BaudProbe.h เริ่มจาก baud ของโปรโตคอล
+ * → RS232_loop() เปลี่ยน rate ของ UART ตอนสายว่าง แล้วแจ้ง onBaudLocked ให้บันทึกเมื่อ parse ได้
+ */
+
+#ifndef RS232_READER_H
+#define RS232_READER_H
+
+#include <Arduino.h>
+#include "InstrumentProtocol.h"
+#include "BaudProbe.h"
+
+// ===== Pin ตามบอร์ด =====
+#ifdef ESP32
+  #include <driver/uart.h>
+  #define RX_PIN 16  // GPIO16
+  #define TX_PIN 17  // GPIO17
+  #define RS232_UART UART_NUM_2
+#elif defined(ESP8266)
+  #include <SoftwareSerial.h>
+  #define RS232_RX_PIN D7  // GPIO13 (RX)
+  #define RS232_TX_PIN D8  // GPIO15 (TX)
+  SoftwareSerial rs232Serial(RS232_RX_PIN, RS232_TX_PIN);
+#endif
+
+#ifdef ESP32
+  #include "FrameQueue.h"
+#endif
+
+// ===== Configuration =====
+#define RS232_RX_BUFFER_SIZE 4096     // ESP32: ring ของ UART driver (~350 ms ที่ 115200 baud)
+#define RS232_EVENT_QUEUE_SIZE 20
+#define RS232_INGEST_CORE 0           // loop() อยู่ core 1 (ARDUINO_RUNNING_CORE)
+#define RS232_INGEST_PRIORITY 5       // สูงกว่า loop() (1) - ได้ CPU ทันทีที่มี byte
+#define RS232_INGEST_STACK 4096
+#define RS232_BAUD_SWITCH_GAP 20      // ms: เปลี่ยน baud ตอนสายว่าง → UART จับ start bit ของ byte ถัดไปได้ตรง
+#define RS232_BAUD_SWITCH_WAIT 4000   // ms: ไม่มีช่วงว่างเลย → เปลี่ยนทั้งที่ยังส่งอยู่ (JSON 450 bytes ที่ 1200 = 3.8 s)
+
+// ===== สถานะต่อโปรโตคอล (static - ไม่ใช้ heap) =====
+// framer ใช้ใน ingest task เท่านั้น / parser ใช้ใน loop() เท่านั้น
+template <typename P>
+struct ProtocolState {
+  static typename P::Framer framer;
+  static typename P::Parser parser;
+};
+
+template <typename P>
+typename P::Framer ProtocolState<P>::framer;
+
+template <typename P>
+typename P::Parser ProtocolState<P>::parser;
+
+// ===== ตัวแปร (เขียนโดย ingest task / อ่านจาก loop) =====
+uint8_t rs232Protocol = 0;                       // ID ของโปรโตคอลที่ใช้ (ตั้งครั้งเดียวใน RS232_begin)
+const ProtocolInfo* rs232ProtocolInfo = nullptr;
+volatile int rs232ByteCount = 0;
+volatile int rs232DroppedFrameCount = 0;
+volatile unsigned long rs232OverrunCount = 0;   // UART FIFO / ring ล้น (byte หาย)
+volatile unsigned long lastDataTime = 0;
+volatile uint32_t rs232PrintableCount = 0;      // byte ที่เป็น Text (ให้คะแนน baud rate)
+volatile uint32_t rs232FrameCount = 0;          // Framer ได้เฟรมครบ
+volatile bool rs232Resync = false;              // เปลี่ยน baud แล้ว - ทิ้งเฟรมที่ค้างใน Framer
+unsigned long frameStartTime = 0;   // เวลาที่ได้ byte แรกของเฟรม (วัด latency)
+
+#ifdef ESP32
+FrameQueue rs232Frames;
+QueueHandle_t rs232UartQueue = nullptr;
+TaskHandle_t rs232IngestTask = nullptr;
+#endif
+
+// ===== ตัวแปร (loop) =====
+int rs232ValidLineCount = 0;
+uint32_t rs232ParseErrorCount = 0;
+BaudProbe rs232Baud;
+uint32_t rs232PendingBaud = 0;          // รอสายว่างก่อนเปลี่ยน baud (0 = ไม่มี)
+unsigned long rs232PendingSince = 0;
+unsigned long rs232LastFrameTime = 0;   // ms: byte แรก → ครบเฟรม (เฟรมล่าสุด)
+unsigned long rs232LastParseTime = 0;   // us: parse เฟรมล่าสุด
+
+// ===== Callback =====
+void (*onDataReceived)(const WireReading& reading) = nullptr;
+void (*onBaudLocked)(uint32_t baud) = nullptr;
+
+// ===== ตั้งค่า Callback =====
+void RS232_setCallback(void (*callback)(const WireReading&)) {
+  onDataReceived = callback;
+}
+
+// เรียกเมื่อหา baud rate เจอ (parse ได้) - ผู้เรียกบันทึกลง Config ให้ครั้งหน้า lock ทันที
+void RS232_setBaudLockCallback(void (*callback)(uint32_t)) {
+  onBaudLocked = callback;
+}
+
+// ===== แสดงค่าที่อ่านได้ =====
+void RS232_logReading(const WireReading& reading) {
+  if (reading.fields & WIRE_FIELD_IDCARD) {
+    char idcard[24];
+    Wire_idcardToString(reading.idcard, idcard, sizeof(idcard));
+    LOG_I("   💳 ID Card: %s\n", idcard);
+  }
+  switch (reading.kind) {
+    case WIRE_KIND_BLOOD_PRESSURE:
+      if (reading.fields & WIRE_FIELD_VALUE0) LOG_I("   💉 ความดันบน: %d mmHg\n", reading.values[0]);
+      if (reading.fields & WIRE_FIELD_VALUE1) LOG_I("   💉 ความดันล่าง: %d mmHg\n", reading.values[1]);
+      if (reading.fields & WIRE_FIELD_VALUE2) LOG_I("   💓 ชีพจร: %d bpm\n", reading.values[2]);
+      break;
+    case WIRE_KIND_WEIGHT_HEIGHT:
+      LOG_I("   ⚖️  น้ำหนัก: %d.%d kg\n", reading.values[0] / 10, reading.values[0] % 10);
+      LOG_I("   📏 ส่วนสูง: %d.%d cm\n", reading.values[1] / 10, reading.values[1] % 10);
+      if (reading.fields & WIRE_FIELD_VALUE2) {
+        LOG_I("   🌡️  อุณหภูมิ: %d.%d °C\n", reading.values[2] / 10, reading.values[2] % 10);
+      }
+      break;
+    default:
+      LOG_I("   📊 ค่า: %d.%d\n", reading.values[0] / 10, reading.values[0] % 10);
+      break;
+  }
+}
+
+void RS232_emit(const WireReading& reading) {
+  RS232_logReading(reading);
+  if (onDataReceived != nullptr) {
+    onDataReceived(reading);
+  }
+}
+
+// ===== Parse เฟรมและส่งต่อ (loop) =====
+// data แก้ไขได้ (parse แบบ in-place) และ null-terminated
+template <typename P>
+void RS232_processFrame(char* data, size_t length, unsigned long startedAt, unsigned long completedAt) {
+  LOG_I("\n📥 รับข้อมูล %s: %d bytes\n", P::NAME, (int)length);
+  LOG_D("================================================================================\n");
+  LOG_D("%s\n", data);
+  LOG_D("================================================================================\n");
+  rs232LastFrameTime = completedAt - startedAt;
+  LOG_I("   ⏱️  byte แรก → ครบเฟรม: %lu ms | รอในคิว: %lu ms\n",
+        rs232LastFrameTime, millis() - completedAt);
+  
+  typename P::Parser& parser = ProtocolState<P>::parser;
+  WireReading reading;
+  unsigned long parseStart = micros();
+  ProtocolParseResult result = P::parse(parser, data, length, millis(), reading);
+  rs232LastParseTime = micros() - parseStart;
+  
+  if (result == PROTOCOL_PARSE_ERROR) {
+    rs232ParseErrorCount++;
+    LOG_W("⚠️  Parse Error: %s\n", parser.error);
+    return;
+  }
+  
+  rs232ValidLineCount++;
+  LOG_I("✅ Parse สำเร็จ! (%lu us)\n", rs232LastParseTime);
+  if (result == PROTOCOL_PARSE_READING) {
+    RS232_emit(reading);
+  } else {
+    LOG_I("   ⏳ รอข้อมูลส่วนที่เหลือ...\n");
+  }
+}
+
+// ===== จัดการผลของ Framer (ingest task) =====
+template <typename P>
+void RS232_onFrameResult(typename P::Framer& framer, ProtocolFrameResult result) {
+  switch (result) {
+    case PROTOCOL_FRAME_READY: {
+      rs232FrameCount++;
+      size_t length;
+      char* data = P::frame(framer, length);
+      #ifdef ESP32
+        if (!FrameQueue_push(rs232Frames, data, length, frameStartTime, lastDataTime)) {
+          rs232DroppedFrameCount++;
+          LOG_W("⚠️  คิวเฟรมเต็ม (%d) - ทิ้งเฟรมนี้\n", FRAME_QUEUE_SLOTS);
+        }
+      #else
+        RS232_processFrame<P>(data, length, frameStartTime, lastDataTime);
+      #endif
+      P::reset(framer);
+      break;
+    }
+    case PROTOCOL_FRAME_OVERFLOW:
+      rs232DroppedFrameCount++;
+      LOG_W("⚠️  เฟรมใหญ่เกิน buffer - ข้ามเฟรมนี้\n");
+      break;
+    case PROTOCOL_FRAME_CORRUPT:
+      rs232DroppedFrameCount++;
+      LOG_W("⚠️  โครงสร้างเฟรมผิดปกติ - ข้ามจนจบเฟรมแล้วรอเฟรมใหม่\n");
+      break;
+    case PROTOCOL_FRAME_INCOMPLETE:
+      rs232DroppedFrameCount++;
+      LOG_W("⚠️  เฟรมไม่ครบ (สายเงียบกลางเฟรม) - ทิ้งเฟรม\n");
+      break;
+    default:
+      break;
+  }
+}
+
+// ===== ป้อน byte ที่อ่านได้เข้า Framer (ingest task) =====
+// ทุก byte ใน chunk มีเวลาเดียวกัน (lastDataTime) → เฟรมที่เริ่มใน chunk นี้เริ่มตอน chunk มาถึง
+// (ไม่ต้องตรวจ inFrame() ทุก byte)
+template <typename P>
+void RS232_ingest(const uint8_t* data, int length) {
+  typename P::Framer& framer = ProtocolState<P>::framer;
+  unsigned long chunkTime = lastDataTime;
+  if (!P::inFrame(framer)) {
+    frameStartTime = chunkTime;
+  }
+  for (int i = 0; i < length; i++) {
+    ProtocolFrameResult result = P::push(framer, (char)data[i]);
+    if (result != PROTOCOL_FRAME_NONE) {
+      RS232_onFrameResult<P>(framer, result);
+      frameStartTime = chunkTime;
+    }
+  }
+}
+
+// ===== สายเงียบเกิน IDLE_TIMEOUT ระหว่างเฟรม (ingest task) =====
+template <typename P>
+void RS232_checkIdle(unsigned long now) {
+  typename P::Framer& framer = ProtocolState<P>::framer;
+  if (P::inFrame(framer) && now - lastDataTime > P::IDLE_TIMEOUT) {
+    RS232_onFrameResult<P>(framer, P::idle(framer));
+  }
+}
+
+// ===== ค่าที่รอคู่/รอนิ่งหมดเวลา (loop) =====
+template <typename P>
+void RS232_pollParser() {
+  typename P::Parser& parser = ProtocolState<P>::parser;
+  WireReading reading;
+  ProtocolParseResult result = P::poll(parser, millis(), reading);
+  if (result == PROTOCOL_PARSE_EXPIRED) {
+    LOG_W("   ⏱️  รอข้อมูลไม่ครบ: %s → ไม่ส่ง\n", parser.error);
+  } else if (result == PROTOCOL_PARSE_READING) {
+    LOG_I("   ⏱️  %s → ส่ง\n", parser.error);
+    RS232_emit(reading);
+  }
+}
+
+// ===== Visitor สำหรับ Protocol_dispatch() =====
+struct RS232BeginVisitor {
+  template <typename P> void apply() {
+    P::begin(ProtocolState<P>::framer, ProtocolState<P>::parser);
+  }
+};
+
+// ทิ้งเฟรมที่กำลังรับ (byte หาย) - ไม่แตะ parser ที่ loop() ใช้อยู่
+struct RS232ResetVisitor {
+  template <typename P> void apply() {
+    if (P::inFrame(ProtocolState<P>::framer)) {
+      rs232DroppedFrameCount++;
+    }
+    P::reset(ProtocolState<P>::framer);
+  }
+};
+
+// เปลี่ยน baud rate - byte ที่ค้างใน Framer ถอดมาจาก rate เดิม (ไม่นับเป็นเฟรมที่ทิ้ง)
+struct RS232ResyncVisitor {
+  template <typename P> void apply() {
+    P::reset(ProtocolState<P>::framer);
+  }
+};
+
+struct RS232IngestVisitor {
+  const uint8_t* data;
+  int length;
+  template <typename P> void apply() {
+    RS232_ingest<P>(data, length);
+  }
+};
+
+struct RS232IdleVisitor {
+  unsigned long now;
+  template <typename P> void apply() {
+    RS232_checkIdle<P>(now);
+  }
+};
+
+#ifdef ESP32
+struct RS232FrameVisitor {
+  QueuedFrame* frame;
+  template <typename P> void apply() {
+    RS232_processFrame<P>(frame->data, frame->length, frame->startedAt, frame->completedAt);
+  }
+};
+#endif
+
+struct RS232PollVisitor {
+  template <typename P> void apply() {
+    RS232_pollParser<P>();
+  }
+};
+
+void RS232_ingestBytes(const uint8_t* data, int length) {
+  if (rs232Resync) {
+    rs232Resync = false;
+    RS232ResyncVisitor resync;
+    Protocol_dispatch(rs232Protocol, resync);
+  }
+  rs232PrintableCount += BaudProbe_countPrintable(data, length);
+  RS232IngestVisitor visitor = { data, length };
+  Protocol_dispatch(rs232Protocol, visitor);
+}
+
+void RS232_checkIdleFrame(unsigned long now) {
+  RS232IdleVisitor visitor = { now };
+  Protocol_dispatch(rs232Protocol, visitor);
+}
+
+#ifdef ESP32
+// ===== Task รับข้อมูล UART (core 0) =====
+// ตื่นเมื่อ UART driver แจ้ง event (ได้ byte / FIFO ล้น) หรือทุก 100 ms เพื่อตรวจเฟรมค้าง
+void RS232_ingestTask(void* arg) {
+  uart_event_t event;
+  uint8_t chunk[128];
+  
+  for (;;) {
+    if (xQueueReceive(rs232UartQueue, &event, pdMS_TO_TICKS(100)) == pdTRUE) {
+      switch (event.type) {
+        case UART_DATA: {
+          int remaining = event.size;
+          while (remaining > 0) {
+            int count = uart_read_bytes(RS232_UART, chunk, min(remaining, (int)sizeof(chunk)), 0);
+            if (count <= 0) {
+              break;
+            }
+            rs232ByteCount += count;
+            lastDataTime = millis();
+            RS232_ingestBytes(chunk, count);
+            remaining -= count;
+          }
+          break;
+        }
+  
+        case UART_FIFO_OVF:
+        case UART_BUFFER_FULL: {
+          // byte หายไปแล้ว - เฟรมที่กำลังรับใช้ไม่ได้ → ล้างทั้งหมดแล้วรอเฟรมใหม่
+          rs232OverrunCount++;
+          RS232ResetVisitor visitor;
+          Protocol_dispatch(rs232Protocol, visitor);
+          uart_flush_input(RS232_UART);
+          xQueueReset(rs232UartQueue);
+          LOG_W("⚠️  UART RX ล้น - ทิ้งข้อมูลที่ค้าง (ครั้งที่ %lu)\n", rs232OverrunCount);
+          break;
+        }
+  
+        default:
+          break;
+      }
+    }
+  
+    // เฟรมค้างครึ่งทาง (สายหลุด/เครื่องดับระหว่างส่ง) หรือบรรทัดที่ไม่มี newline ปิด
+    RS232_checkIdleFrame(millis());
+  }
+}
+#endif
+
+// ===== Counter สำหรับ BaudProbe (loop) =====
+BaudProbeCounters RS232_probeCounters() {
+  BaudProbeCounters counters;
+  counters.bytes = rs232ByteCount;
+  counters.printable = rs232PrintableCount;
+  counters.frames = rs232FrameCount;
+  counters.valid = rs232ValidLineCount;
+  counters.rejects = rs232ParseErrorCount;
+  return counters;
+}
+
+// ===== เปลี่ยน baud rate ของ UART (loop) =====
+// byte ที่ค้างอยู่ถอดมาจาก rate เดิม → ทิ้ง แล้วให้ Framer เริ่มเฟรมใหม่
+void RS232_applyBaudRate(uint32_t baud) {
+  #ifdef ESP32
+    uart_set_baudrate(RS232_UART, baud);
+    uart_flush_input(RS232_UART);
+    rs232Resync = true;   // ingest task reset Framer ก่อน chunk ถัดไป
+  #elif defined(ESP8266)
+    rs232Serial.end();
+    rs232Serial.begin(baud);
+    RS232ResyncVisitor resync;
+    Protocol_dispatch(rs232Protocol, resync);
+  #endif
+}
+
+// ===== ฟังก์ชันเริ่มต้น =====
+// protocolId ที่ไม่รู้จัก → ใช้โปรโตคอลแรกใน InstrumentProtocols
+// savedBaud: rate ที่เคยหาเจอ (lock ทันที) / 0 = หาใหม่ เริ่มจาก baud ของโปรโตคอล
+void RS232_begin(uint8_t protocolId, uint32_t savedBaud) {
+  rs232ProtocolInfo = Protocol_find(protocolId);
+  if (rs232ProtocolInfo == nullptr) {
+    rs232ProtocolInfo = &InstrumentProtocols::table[0];
+  }
+  rs232Protocol = rs232ProtocolInfo->id;
+  
+  RS232BeginVisitor visitor;
+  Protocol_dispatch(rs232Protocol, visitor);
+  #ifdef ESP32
+    FrameQueue_begin(rs232Frames);
+  #endif
+  lastDataTime = millis();
+  BaudProbe_begin(rs232Baud, savedBaud, rs232ProtocolInfo->baud, RS232_probeCounters(), millis());
+  uint32_t baud = BaudProbe_rate(rs232Baud);
+  
+  Serial.printf("📡 RS232 %s (%s)\n", rs232ProtocolInfo->description, rs232ProtocolInfo->name);
+  Serial.printf("   Baud: %lu (%s) | รูปแบบ: %s\n", (unsigned long)baud,
+                rs232Baud.locked ? "บันทึกไว้" : "กำลังหาอัตโนมัติ", rs232ProtocolInfo->format);
+  
+  #ifdef ESP32
+    // ESP32: ใช้ UART driver ของ ESP-IDF ตรงๆ (ไม่ผ่าน Serial2) เพื่อรับ event
+    uart_config_t uartConfig = {};
+    uartConfig.baud_rate = baud;
+    uartConfig.data_bits = UART_DATA_8_BITS;
+    uartConfig.parity = UART_PARITY_DISABLE;
+    uartConfig.stop_bits = UART_STOP_BITS_1;
+    uartConfig.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+  
+    uart_driver_install(RS232_UART, RS232_RX_BUFFER_SIZE, 0, RS232_EVENT_QUEUE_SIZE, &rs232UartQueue, 0);
+    uart_param_config(RS232_UART, &uartConfig);
+    uart_set_pin(RS232_UART, TX_PIN, RX_PIN, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+  
+    Serial.printf("   Pin: GPIO%d(RX) / GPIO%d(TX)\n", RX_PIN, TX_PIN);
+    Serial.printf("   รับข้อมูลด้วย task แยก (core %d) | UART buffer %d bytes\n",
+                  RS232_INGEST_CORE, RS232_RX_BUFFER_SIZE);
+  
+    xTaskCreatePinnedToCore(RS232_ingestTask, "rs232", RS232_INGEST_STACK, nullptr,
+                            RS232_INGEST_PRIORITY, &rs232IngestTask, RS232_INGEST_CORE);
+  #elif defined(ESP8266)
+    rs232Serial.begin(baud);
+  
+    Serial.println("   Pin: D7(RX) / D8(TX) - SoftwareSerial 8N1");
+    Serial.println("   โหมด: Non-blocking - อ่านเท่าที่มีในแต่ละรอบ loop()");
+  #endif
+  Serial.println("✅ พร้อมรับข้อมูล\n");
+}
+
+#ifdef ESP8266
+// ===== อ่านข้อมูล SoftwareSerial (Non-blocking) =====
+// อ่านเฉพาะ byte ที่มีอยู่แล้วแล้วคืนทันที - เฟรมที่ยังไม่ครบค้างใน Framer รอรอบถัดไป
+void RS232_poll() {
+  // overflow() คืน true ครั้งเดียวต่อการล้น (แล้วล้าง flag เอง)
+  if (rs232Serial.overflow()) {
+    rs232OverrunCount++;
+    LOG_W("⚠️  SoftwareSerial RX ล้น - byte บางส่วนหาย (ครั้งที่ %lu)\n", rs232OverrunCount);
+  }
+  
+  int available = rs232Serial.available();
+  if (available > 0) {
+    // แสดงข้อความแรกเมื่อเริ่มรับ
+    static bool firstData = true;
+    if (firstData) {
+      LOG_I("\n🎉 เริ่มรับข้อมูล RS232!\n");
+      firstData = false;
+    }
+  
+    uint8_t chunk[64];
+    lastDataTime = millis();
+    while (available > 0) {
+      int count = rs232Serial.read(chunk, min(available, (int)sizeof(chunk)));
+      if (count <= 0) {
+        break;
+      }
+      rs232ByteCount += count;
+      RS232_ingestBytes(chunk, count);
+      available -= count;
+    }
+  }
+  
+  RS232_checkIdleFrame(millis());
+}
+#endif
+
+// ===== ตรวจ baud rate (loop - หลัง parse เฟรมที่ค้างแล้ว) =====
+// เปลี่ยนกลางข้อความ UART อาจจับบิตกลาง byte เป็น start bit แล้วถอดผิดไปหลายสิบ byte
+// (ข้อความที่ส่งติดกันไม่มีช่วงว่างให้ sync ใหม่) → rate ที่ถูกดูเป็นขยะ
+// จึงรอให้สายว่างก่อน แล้วเริ่มนับ window ของ rate ใหม่ตอนเปลี่ยนจริง
+void RS232_checkBaudRate(unsigned long now) {
+  if (rs232PendingBaud != 0) {
+    unsigned long last = lastDataTime;
+    if (millis() - last < RS232_BAUD_SWITCH_GAP && now - rs232PendingSince < RS232_BAUD_SWITCH_WAIT) {
+      return;
+    }
+    RS232_applyBaudRate(rs232PendingBaud);
+    rs232PendingBaud = 0;
+    BaudProbe_startWindow(rs232Baud, RS232_probeCounters());
+    return;
+  }
+  
+  bool wasLocked = rs232Baud.locked;
+  uint32_t previous = BaudProbe_rate(rs232Baud);
+  BaudProbeAction action = BaudProbe_update(rs232Baud, RS232_probeCounters(), now);
+  if (action == BAUD_PROBE_NONE) {
+    return;
+  }
+  
+  uint32_t baud = BaudProbe_rate(rs232Baud);
+  if (baud != previous) {
+    rs232PendingBaud = baud;
+    rs232PendingSince = now;
+  }
+  
+  if (action == BAUD_PROBE_LOCKED) {
+    LOG_I("🔒 RS232 baud rate: %lu (หาเจอใน %lu ms)\n",
+          (unsigned long)baud, (unsigned long)rs232Baud.lastLockTime);
+    if (onBaudLocked != nullptr) {
+      onBaudLocked(baud);
+    }
+  } else if (wasLocked && !rs232Baud.locked) {
+    LOG_W("⚠️  RS232 %lu baud parse ไม่ได้แล้ว - หา baud rate ใหม่ (เริ่มที่ %lu)\n",
+          (unsigned long)previous, (unsigned long)baud);
+  } else if (rs232Baud.locked) {
+    LOG_W("⚠️  RS232 ไม่มี baud rate ไหน parse ได้ - ใช้ %lu (ดูเป็น Text ที่สุด) ไปก่อน\n",
+          (unsigned long)baud);
+  } else {
+    LOG_D("🔍 RS232 ลอง baud rate %lu\n", (unsigned long)baud);
+  }
+}
+
+// ===== ฟังก์ชันประมวลผลเฟรม (loop) =====
+// ESP32: byte ถูกรับโดย ingest task แล้ว - ที่นี่แค่ดึงเฟรมที่ครบจากคิวมา parse
+// ESP8266: อ่าน SoftwareSerial แล้ว parse ทันทีที่ครบเฟรม
+void RS232_loop() {
+  #ifdef ESP32
+    QueuedFrame* frame;
+    while ((frame = FrameQueue_peek(rs232Frames)) != nullptr) {
+      RS232FrameVisitor visitor = { frame };
+      Protocol_dispatch(rs232Protocol, visitor);
+      FrameQueue_pop(rs232Frames);
+    }
+  #elif defined(ESP8266)
+    RS232_poll();
+  #endif
+  
+  RS232PollVisitor poll;
+  Protocol_dispatch(rs232Protocol, poll);
+  
+  RS232_checkBaudRate(millis());
+}
+
+// ===== ตั้ง baud rate เอง (lock ทันที - ยังหาใหม่ให้ถ้า parse ไม่ได้) =====
+// คืน false ถ้าไม่ใช่ rate มาตรฐานใน AUTOBAUD_RATES
+bool RS232_setBaudRate(uint32_t baud) {
+  if (BaudProbe_indexOf(baud) < 0) {
+    return false;
+  }
+  rs232PendingBaud = 0;
+  BaudProbe_force(rs232Baud, baud, RS232_probeCounters(), millis());
+  RS232_applyBaudRate(baud);
+  LOG_I("🔒 RS232 baud rate: %lu (ตั้งเอง)\n", (unsigned long)baud);
+  return true;
+}
+
+// ===== เริ่มหา baud rate ใหม่ (เริ่มจาก rate ปัจจุบัน) =====
+void RS232_autobaud() {
+  rs232PendingBaud = 0;
+  rs232Baud.reprobeCount++;
+  BaudProbe_startSweep(rs232Baud, RS232_probeCounters(), millis());
+  LOG_I("🔍 RS232 กำลังหา baud rate (เริ่มที่ %lu)\n", (unsigned long)BaudProbe_rate(rs232Baud));
+}
+
+// ===== ฟังก์ชันสถิติ =====
+const ProtocolInfo* RS232_getProtocol() {
+  return rs232ProtocolInfo;
+}
+
+int RS232_getByteCount() {
+  return rs232ByteCount;
+}
+
+int RS232_getValidLineCount() {
+  return rs232ValidLineCount;
+}
+
+unsigned long RS232_getLastFrameTime() {
+  return rs232LastFrameTime;
+}
+
+unsigned long RS232_getLastParseTime() {
+  return rs232LastParseTime;
+}
+
+int RS232_getValidDataCount() {
+  return rs232ValidLineCount;
+}
+
+int RS232_getDroppedFrameCount() {
+  return rs232DroppedFrameCount;
+}
+
+unsigned long RS232_getOverrunCount() {
+  return rs232OverrunCount;
+}
+
+unsigned long RS232_getLastDataTime() {
+  return lastDataTime;
+}
+
+long RS232_getCurrentBaudRate() {
+  return (long)BaudProbe_rate(rs232Baud);
+}
+
+// lock เพราะ parse ได้ (หรือค่าที่บันทึกไว้/ตั้งเอง) - false ระหว่างหา หรือ lock ชั่วคราวตามคะแนน
+bool RS232_isBaudRateLocked() {
+  return rs232Baud.locked && rs232Baud.confirmed;
+}
+
+const BaudProbe* RS232_getBaudProbe() {
+  return &rs232Baud;
+}
+
+#endif
@@ -0,0 +1,75 @@
+/**
+ * Scheduler.h
+ * ตัวจัดตารางงานแบบ Cooperative (ไม่มี delay ใน loop)
+ *
+ * แต่ละงานเป็นฟังก์ชันสั้นๆ ที่ทำเสร็จแล้วคืนทันที
+ * งานที่ต้องรอ (WiFi reconnect, HTTP retry, LED กระพริบ) เก็บสถานะไว้เอง
+ * แล้วทำต่อในรอบถัดไป → loop() วนได้ถี่ และ RS232_loop() ไม่ถูกบล็อก
+ *
+ * interval = 0 หมายถึงทำทุกรอบของ loop()
+ */
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#define SCHEDULER_MAX_TASKS 16
+
+typedef void (*SchedulerTaskFn)(unsigned long now);
+
+struct SchedulerTask {
+  const char* name;
+  SchedulerTaskFn fn;
+  unsigned long interval;     // ms (0 = ทุกรอบ)
+  unsigned long lastRun;
+  unsigned long maxRunTime;   // เวลาทำงานนานสุดของงานนี้ (ms)
+};
+
+SchedulerTask schedulerTasks[SCHEDULER_MAX_TASKS];
+int schedulerTaskCount = 0;
+
+// ===== เพิ่มงาน =====
+bool Scheduler_add(const char* name, SchedulerTaskFn fn, unsigned long interval) {
+  if (schedulerTaskCount >= SCHEDULER_MAX_TASKS) {
+    return false;
+  }
+
+  SchedulerTask& task = schedulerTasks[schedulerTaskCount++];
+  task.name = name;
+  task.fn = fn;
+  task.interval = interval;
+  task.lastRun = millis();
+  task.maxRunTime = 0;
+  return true;
+}
+
+// ===== ทำงานที่ถึงเวลาแล้ว (เรียกจาก loop()) =====
+void Scheduler_run() {
+  for (int i = 0; i < schedulerTaskCount; i++) {
+    SchedulerTask& task = schedulerTasks[i];
+    unsigned long now = millis();
+
+    // millis() เป็น 32 bit - ลบแบบ uint32_t ให้ข้ามจุดวนรอบได้แม้ unsigned long กว้างกว่า (host build)
+    if (task.interval != 0 && (uint32_t)(now - task.lastRun) < task.interval) {
+      continue;
+    }
+
+    task.lastRun = now;
+    task.fn(now);
+
+    unsigned long runTime = (uint32_t)(millis() - now);
+    if (runTime > task.maxRunTime) {
+      task.maxRunTime = runTime;
+    }
+  }
+}
+
+// ===== แสดงเวลาทำงานนานสุดของแต่ละงาน =====
+void Scheduler_printStats() {
+  LOG_I("   ⏱️  งานนานสุด (ms):");
+  for (int i = 0; i < schedulerTaskCount; i++) {
+    LOG_I(" %s=%lu", schedulerTasks[i].name, schedulerTasks[i].maxRunTime);
+  }
+  LOG_I("\n");
+}
+
+#endif
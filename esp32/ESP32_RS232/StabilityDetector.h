@@ -0,0 +1,190 @@
+/**
+ * StabilityDetector.h
+ * หาค่าที่ "นิ่งแล้ว" จากเครื่องชั่ง/ส่วนสูงที่ส่งค่าต่อเนื่องระหว่างคนไข้ยืนบนเครื่อง
+ *
+ * เครื่องชั่งส่ง W:/H: หลายครั้งต่อวินาทีตั้งแต่ก้าวขึ้นจนก้าวลง ค่าแรกๆ ยังแกว่ง
+ * → ส่งเฉพาะค่าเฉลี่ยเมื่อนิ่งแล้ว ครั้งเดียวต่อการชั่ง 1 ครั้ง (session)
+ *
+ *   - นิ่ง = SD ของ STABILITY_WINDOW sample ล่าสุด ≤ STABILITY_TOLERANCE (ทั้ง W และ H)
+ *            ต่อเนื่องนาน STABILITY_DWELL ms
+ *   - W ≤ STABILITY_ZERO (ไม่มีคนบนเครื่อง) = จบ session → คนถัดไปส่งได้อีกครั้ง
+ *   - ไม่มี sample ใหม่ STABILITY_QUIET ms = จบ session เช่นกัน
+ *     เครื่องที่ส่งครั้งเดียวต่อคน (พิมพ์เมื่อนิ่ง) จึงส่งค่านั้นเมื่อครบเวลานี้
+ *
+ * mean/variance แบบ running sum ใน ring buffer - O(1) ต่อ sample หน่วย 0.1 (จำนวนเต็ม)
+ * ไม่ขึ้นกับ Arduino - compile บน PC ได้ (รับ now เป็น argument)
+ */
+
+#ifndef STABILITY_DETECTOR_H
+#define STABILITY_DETECTOR_H
+
+#include <stdint.h>
+
+// ===== Configuration =====
+#ifndef STABILITY_WINDOW
+  #define STABILITY_WINDOW 8     // sample ล่าสุดที่ใช้ (เครื่องชั่งส่ง ~5 ครั้ง/วินาที ≈ 1.6 s)
+#endif
+#ifndef STABILITY_TOLERANCE
+  #define STABILITY_TOLERANCE 2  // SD ≤ 0.2 kg / 0.2 cm
+#endif
+#ifndef STABILITY_DWELL
+  #define STABILITY_DWELL 1000   // ms: นิ่งต่อเนื่องเท่านี้ก่อนส่ง
+#endif
+#ifndef STABILITY_QUIET
+  #define STABILITY_QUIET 2000   // ms: ไม่มี sample ใหม่ = จบการชั่ง
+#endif
+#ifndef STABILITY_ZERO
+  #define STABILITY_ZERO 20      // W ≤ 2.0 kg = ไม่มีคนบนเครื่อง
+#endif
+
+// ===== ค่าล่าสุด N ค่า + ผลรวม (ลบค่าเก่าสุดออกเมื่อเต็ม) =====
+struct StabilityWindow {
+  int16_t samples[STABILITY_WINDOW];
+  uint8_t head;
+  uint8_t count;
+  int32_t sum;
+  int64_t sumSquares;
+};
+
+inline void StabilityWindow_reset(StabilityWindow& w) {
+  w.head = 0;
+  w.count = 0;
+  w.sum = 0;
+  w.sumSquares = 0;
+}
+
+inline void StabilityWindow_add(StabilityWindow& w, int16_t value) {
+  if (w.count == STABILITY_WINDOW) {
+    int16_t oldest = w.samples[w.head];
+    w.sum -= oldest;
+    w.sumSquares -= (int32_t)oldest * oldest;
+  } else {
+    w.count++;
+  }
+  w.samples[w.head] = value;
+  w.head = (w.head + 1) % STABILITY_WINDOW;
+  w.sum += value;
+  w.sumSquares += (int32_t)value * value;
+}
+
+// SD ≤ tolerance โดยไม่ต้องหาร/ถอดราก: n·Σx² − (Σx)² ≤ n²·tolerance²
+inline bool StabilityWindow_isSteady(const StabilityWindow& w, uint8_t minCount) {
+  if (w.count == 0 || w.count < minCount) {
+    return false;
+  }
+  int64_t n = w.count;
+  int64_t spread = n * w.sumSquares - (int64_t)w.sum * w.sum;
+  return spread <= n * n * STABILITY_TOLERANCE * STABILITY_TOLERANCE;
+}
+
+inline int16_t StabilityWindow_mean(const StabilityWindow& w) {
+  if (w.count == 0) {
+    return 0;
+  }
+  int32_t half = w.sum >= 0 ? w.count / 2 : -(w.count / 2);
+  return (int16_t)((w.sum + half) / w.count);
+}
+
+// ===== ผลของ sample / poll =====
+enum StabilityResult : uint8_t {
+  STABILITY_NONE = 0,    // ยังไม่นิ่ง / ส่งไปแล้วใน session นี้ / ไม่มีคนบนเครื่อง
+  STABILITY_SETTLED,     // นิ่งแล้ว → ส่งค่าเฉลี่ย (ครั้งเดียวต่อ session)
+  STABILITY_ABANDONED    // session จบโดยไม่เคยนิ่ง → ไม่ส่ง
+};
+
+// ===== การชั่ง 1 ครั้ง (ก้าวขึ้น → ก้าวลง) =====
+struct StabilitySession {
+  StabilityWindow weight;
+  StabilityWindow height;
+  uint32_t lastSample;    // ms: sample ล่าสุดของ session (0 = ไม่มี session)
+  uint32_t steadySince;   // ms: เริ่มนิ่ง (0 = ยังไม่นิ่ง)
+  bool emitted;
+
+  // สถิติ
+  uint32_t sampleCount;
+  uint32_t settledCount;
+  uint32_t abandonedCount;
+};
+
+inline void Stability_reset(StabilitySession& s) {
+  StabilityWindow_reset(s.weight);
+  StabilityWindow_reset(s.height);
+  s.lastSample = 0;
+  s.steadySince = 0;
+  s.emitted = false;
+}
+
+inline void Stability_begin(StabilitySession& s) {
+  Stability_reset(s);
+  s.sampleCount = 0;
+  s.settledCount = 0;
+  s.abandonedCount = 0;
+}
+
+inline StabilityResult Stability_emit(StabilitySession& s, int16_t& weight, int16_t& height) {
+  weight = StabilityWindow_mean(s.weight);
+  height = StabilityWindow_mean(s.height);
+  s.emitted = true;
+  s.settledCount++;
+  return STABILITY_SETTLED;
+}
+
+// จบ session - ABANDONED ถ้ามีคนขึ้นเครื่องแต่ไม่เคยนิ่งพอจะส่ง
+inline StabilityResult Stability_end(StabilitySession& s) {
+  bool abandoned = s.lastSample != 0 && !s.emitted;
+  Stability_reset(s);
+  if (abandoned) {
+    s.abandonedCount++;
+    return STABILITY_ABANDONED;
+  }
+  return STABILITY_NONE;
+}
+
+// ===== เพิ่ม sample (W/H หน่วย 0.1) =====
+// SETTLED → weight/height = ค่าเฉลี่ยของ window
+inline StabilityResult Stability_add(StabilitySession& s, int16_t weightTenths, int16_t heightTenths,
+                                     uint32_t now, int16_t& weight, int16_t& height) {
+  s.sampleCount++;
+  if (weightTenths <= STABILITY_ZERO) {
+    return Stability_end(s);
+  }
+  if (s.lastSample != 0 && now - s.lastSample >= STABILITY_QUIET) {
+    Stability_end(s);   // ผู้เรียกไม่ได้ poll ระหว่างนั้น - ถือเป็นคนใหม่
+  }
+  s.lastSample = now != 0 ? now : 1;
+
+  StabilityWindow_add(s.weight, weightTenths);
+  StabilityWindow_add(s.height, heightTenths);
+  if (s.emitted) {
+    return STABILITY_NONE;
+  }
+
+  if (!StabilityWindow_isSteady(s.weight, STABILITY_WINDOW) ||
+      !StabilityWindow_isSteady(s.height, STABILITY_WINDOW)) {
+    s.steadySince = 0;
+    return STABILITY_NONE;
+  }
+  if (s.steadySince == 0) {
+    s.steadySince = s.lastSample;
+  }
+  if (now - s.steadySince < STABILITY_DWELL) {
+    return STABILITY_NONE;
+  }
+  return Stability_emit(s, weight, height);
+}
+
+// ===== เรียกเป็นระยะ: sample หยุดมาเกิน STABILITY_QUIET = จบ session =====
+// ยังไม่เคยส่งและ sample ที่มีอยู่นิ่ง (เช่น เครื่องที่ส่งครั้งเดียวต่อคน) → ส่งค่าเฉลี่ยตอนนี้
+inline StabilityResult Stability_poll(StabilitySession& s, uint32_t now, int16_t& weight, int16_t& height) {
+  if (s.lastSample == 0 || now - s.lastSample < STABILITY_QUIET) {
+    return STABILITY_NONE;
+  }
+  if (!s.emitted && StabilityWindow_isSteady(s.weight, 1) && StabilityWindow_isSteady(s.height, 1)) {
+    Stability_emit(s, weight, height);
+    Stability_reset(s);
+    return STABILITY_SETTLED;
+  }
+  return Stability_end(s);
+}
+
+#endif
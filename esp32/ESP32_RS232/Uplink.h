@@ -0,0 +1,126 @@
+/**
+ * Uplink.h
+ * การเชื่อมต่อ HTTP ไปยัง Center แบบ Keep-Alive
+ *
+ * ใช้ HTTPClient/WiFiClient ชุดเดียวตลอดการทำงาน (HTTP/1.1 + setReuse)
+ * แทนการสร้างใหม่ทุกครั้งที่ส่ง → ไม่ต้อง TCP handshake ทุก reading/retry
+ *
+ * - สลับ path (/api/vitals, /api/vitals/batch, /api/status) ใช้ connection เดิม
+ *   ปิดเฉพาะเมื่อ request ล้มเหลว
+ * - ถ้า connection เดิมถูก Center ปิดไปแล้ว (stale socket) จะเปิดใหม่
+ *   แล้วส่งซ้ำให้ทันที 1 ครั้งโดยอัตโนมัติ
+ * - นับจำนวน connection ที่เปิด, เวลาเฉลี่ย และจำนวน bytes ของ POST ไว้ดูในสถานะระบบ
+ *
+ * ต้อง include หลัง Config.h (ใช้ Config_get()->centerIp)
+ */
+
+#ifndef UPLINK_H
+#define UPLINK_H
+
+// ===== Configuration =====
+#define UPLINK_PORT 80
+#define UPLINK_TIMEOUT 2000        // timeout ต่อ 1 request (ms) - Center อยู่ใน LAN เดียวกัน
+#define UPLINK_RESPONSE_SIZE 128   // เก็บ response ไว้แสดงตอน error
+
+// ===== Session =====
+HTTPClient uplinkHttp;
+WiFiClient uplinkClient;
+bool uplinkOpen = false;
+char uplinkPath[32] = "";
+char uplinkResponse[UPLINK_RESPONSE_SIZE] = "";
+
+// ===== สถิติ =====
+unsigned long uplinkConnectCount = 0;    // จำนวน TCP connection ที่เปิดใหม่
+unsigned long uplinkStaleCount = 0;      // connection ค้างที่ต้องเปิดใหม่
+unsigned long uplinkRequestCount = 0;    // POST ที่ได้ response (ทุก status code)
+unsigned long uplinkLatencyTotal = 0;    // เวลารวมของ POST ที่ได้ response (ms)
+unsigned long uplinkBytesTotal = 0;      // body รวมของ POST ที่ได้ response (bytes)
+
+// ===== ปิด Session =====
+void Uplink_close() {
+  uplinkHttp.end();
+  uplinkClient.stop();
+  uplinkOpen = false;
+}
+
+// ===== เปิด Session / เปลี่ยน path =====
+// begin() ซ้ำแค่เปลี่ยน URI - host/port เดิม HTTPClient จึงใช้ socket ที่เชื่อมต่ออยู่ต่อ
+// (ไม่ stop() uplinkClient ที่นี่)
+bool Uplink_open(const char* path) {
+  if (uplinkOpen && strcmp(uplinkPath, path) == 0) {
+    return true;
+  }
+
+  uplinkHttp.setReuse(true);
+  uplinkHttp.setTimeout(UPLINK_TIMEOUT);
+  if (!uplinkHttp.begin(uplinkClient, Config_get()->centerIp, UPLINK_PORT, path)) {
+    return false;
+  }
+
+  strlcpy(uplinkPath, path, sizeof(uplinkPath));
+  uplinkOpen = true;
+  return true;
+}
+
+// ===== ส่ง POST 1 ครั้ง =====
+// คืนค่า HTTP status code (> 0) หรือ error code ของ HTTPClient (< 0)
+int Uplink_post(const char* path, const char* body, size_t length, const char* contentType = "application/json") {
+  uplinkResponse[0] = '\0';
+
+  for (int attempt = 0; attempt < 2; attempt++) {
+    if (!Uplink_open(path)) {
+      return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+
+    bool reused = uplinkClient.connected();
+    if (!reused) {
+      uplinkConnectCount++;
+    }
+
+    // header ถูกล้างหลังจบแต่ละ request จึงต้องใส่ใหม่ทุกครั้ง
+    uplinkHttp.addHeader("Content-Type", contentType);
+
+    unsigned long start = millis();
+    int code = uplinkHttp.POST((uint8_t*)body, length);
+
+    if (code > 0) {
+      // อ่าน response ให้หมด เพื่อให้ใช้ connection เดิมต่อได้
+      String response = uplinkHttp.getString();
+      strlcpy(uplinkResponse, response.c_str(), sizeof(uplinkResponse));
+      uplinkRequestCount++;
+      uplinkLatencyTotal += millis() - start;
+      uplinkBytesTotal += length;
+      return code;
+    }
+
+    // ส่งไม่ได้ → ทิ้ง connection นี้
+    Uplink_close();
+
+    // ถ้าเป็น connection เก่าที่ค้างอยู่ → เปิดใหม่แล้วลองอีกครั้งทันที
+    if (!reused) {
+      return code;
+    }
+    uplinkStaleCount++;
+  }
+
+  return HTTPC_ERROR_CONNECTION_LOST;
+}
+
+// ===== สถิติ =====
+unsigned long Uplink_getConnectCount() {
+  return uplinkConnectCount;
+}
+
+unsigned long Uplink_getRequestCount() {
+  return uplinkRequestCount;
+}
+
+unsigned long Uplink_getBytesTotal() {
+  return uplinkBytesTotal;
+}
+
+unsigned long Uplink_getMeanLatency() {
+  return uplinkRequestCount > 0 ? uplinkLatencyTotal / uplinkRequestCount : 0;
+}
+
+#endif
@@ -0,0 +1,112 @@
+/**
+ * WeightParser.h
+ * แยกค่าจากบรรทัด Text ของเครื่องชั่ง/ส่วนสูง (ไม่ขึ้นกับ Arduino core)
+ *
+ *   - W:070.3 H:173.5
+ *   - T365$ (อุณหภูมิ 36.5°C)
+ *
+ * ใช้แค่ C standard header - compile บน PC ได้ตรงๆ เพื่อทดสอบ/วัดเวลา parse
+ * โดยไม่ต้องมีบอร์ด ใช้ผ่าน WeightTextProtocol.h
+ */
+
+#ifndef WEIGHT_PARSER_H
+#define WEIGHT_PARSER_H
+
+#include <stdint.h>
+
+// ===== ค่าที่อ่านได้จากเครื่องชั่ง =====
+// เก็บเป็นจำนวนเต็มหน่วย 0.1 (070.3 kg → 703) ไม่ใช้ float/String
+#define WEIGHT_FIELD_WEIGHT 0x01
+#define WEIGHT_FIELD_HEIGHT 0x02
+#define WEIGHT_FIELD_TEMP   0x04
+
+struct WeightReading {
+  int16_t weightTenths;   // น้ำหนัก (0.1 kg)
+  int16_t heightTenths;   // ส่วนสูง (0.1 cm)
+  int16_t tempTenths;     // อุณหภูมิ (0.1 °C)
+  uint8_t fields;         // WEIGHT_FIELD_* ที่มีในข้อมูล
+};
+
+// ===== Parse ตัวเลขทศนิยม 1 ตำแหน่ง → หน่วย 0.1 =====
+// "070.3" → 703, "173" → 1730, "65.25" → 652 (ตัดทศนิยมตำแหน่งที่ 2 ทิ้ง)
+// "-0.5" → -5 (เครื่องชั่งติดลบหลัง tare), ".5" → 5 / เกิน ±3276.7 → ไม่รับ
+// คืนค่าจำนวนตัวอักษรที่อ่าน (0 = ไม่ใช่ตัวเลข)
+inline int Weight_parseTenths(const char* p, int16_t& out) {
+  const char* start = p;
+  bool negative = *p == '-';
+  if (negative) p++;
+  long value = 0;
+  int digits = 0;
+  int fraction = -1;   // -1 = ยังไม่เจอ '.'
+  
+  while (*p != '\0') {
+    char c = *p;
+    if (c >= '0' && c <= '9') {
+      if (fraction < 0) {
+        value = value * 10 + (c - '0');
+        digits++;
+      } else if (fraction == 0) {
+        value = value * 10 + (c - '0');
+        fraction = 1;
+      }
+      if (value > 32767) return 0;
+    } else if (c == '.' && fraction < 0) {
+      fraction = 0;
+    } else {
+      break;
+    }
+    p++;
+  }
+  
+  if (digits == 0 && fraction <= 0) return 0;
+  if (fraction <= 0) value *= 10;  // ไม่มีทศนิยม → คูณ 10
+  if (value > 32767) return 0;
+  
+  out = (int16_t)(negative ? -value : value);
+  return (int)(p - start);
+}
+
+// ===== Tokenizer: หา W:, H:, Txxx$ ในบรรทัด =====
+// คืนค่า WEIGHT_FIELD_* ที่เจอในบรรทัดนี้
+inline uint8_t Weight_tokenizeLine(const char* line, WeightReading& reading) {
+  uint8_t found = 0;
+  
+  for (const char* p = line; *p != '\0'; p++) {
+    if ((p[0] == 'W' || p[0] == 'H') && p[1] == ':') {
+      const char* v = p + 2;
+      while (*v == ' ') v++;
+      int16_t tenths;
+      int used = Weight_parseTenths(v, tenths);
+      if (used > 0) {
+        if (p[0] == 'W') {
+          reading.weightTenths = tenths;
+          found |= WEIGHT_FIELD_WEIGHT;
+        } else {
+          reading.heightTenths = tenths;
+          found |= WEIGHT_FIELD_HEIGHT;
+        }
+        p = v + used - 1;
+      }
+    } else if (p[0] == 'T') {
+      // Txxx$ - ตัวเลขล้วนอย่างน้อย 2 หลัก ปิดด้วย '$' (T365$ = 36.5 °C)
+      const char* v = p + 1;
+      long value = 0;
+      int digits = 0;
+      while (*v >= '0' && *v <= '9' && digits < 5) {
+        value = value * 10 + (*v - '0');
+        digits++;
+        v++;
+      }
+      if (*v == '$' && digits >= 2 && value <= 32767) {
+        reading.tempTenths = (int16_t)value;
+        found |= WEIGHT_FIELD_TEMP;
+        p = v;
+      }
+    }
+  }
+  
+  reading.fields |= found;
+  return found;
+}
+
+#endif
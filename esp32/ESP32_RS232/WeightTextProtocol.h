@@ -0,0 +1,184 @@
+/**
+ * WeightTextProtocol.h
+ * เครื่องชั่ง/ส่วนสูง/อุณหภูมิ: Text "W:070.3 H:173.5", "T365$"
+ * (LineFramer.h + WeightParser.h + StabilityDetector.h)
+ *
+ * ใช้แค่ C/C++ standard header - compile บน PC ได้
+ */
+
+#ifndef WEIGHT_TEXT_PROTOCOL_H
+#define WEIGHT_TEXT_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "ProtocolRegistry.h"
+#include "WireProtocol.h"
+#include "LineFramer.h"
+#include "WeightParser.h"
+#include "StabilityDetector.h"
+
+// W และ H อาจมาคนละบรรทัด → เก็บไว้จนได้ครบคู่ (ไม่เกิน WEIGHT_PAIR_TIMEOUT)
+// T ที่มาระหว่างรอคู่ส่งไปพร้อม W/H - T ที่มาเดี่ยวส่งเป็น WIRE_KIND_TEMP
+// คู่ W+H ผ่าน StabilityDetector.h → ส่งเฉพาะค่าที่นิ่งแล้ว ครั้งเดียวต่อการชั่ง 1 ครั้ง
+#define WEIGHT_PAIR_TIMEOUT 8000   // ms: ได้ W (หรือ H) แล้วรออีกค่าได้นานสุด
+
+struct WeightTextProtocol {
+  static constexpr uint8_t ID = 2;
+  static constexpr const char* NAME = "weight-text";
+  static constexpr const char* DESCRIPTION = "เครื่องชั่ง/ส่วนสูง";
+  static constexpr const char* FORMAT = "W:xxx H:xxx / Txxx$";
+  static constexpr uint32_t BAUD = 9600;
+  static constexpr uint32_t IDLE_TIMEOUT = 200;    // ไม่มี byte ใหม่ 200ms = จบบรรทัด (กรณีไม่มี newline)
+
+  typedef LineFramer Framer;
+  struct Parser {
+    WeightReading pending;   // W/H/T ที่ยังไม่ครบคู่
+    uint32_t pendingSince;   // ms: ได้ W หรือ H ค่าแรก (0 = ไม่มี)
+    StabilitySession stability;
+    const char* error;
+  };
+
+  static void begin(Framer& f, Parser& p) {
+    LineFramer_begin(f);
+    memset(&p.pending, 0, sizeof(p.pending));
+    p.pendingSince = 0;
+    Stability_begin(p.stability);
+    p.error = "";
+  }
+
+  static bool inFrame(const Framer& f) {
+    return LineFramer_inFrame(f);
+  }
+
+  static ProtocolFrameResult push(Framer& f, char c) {
+    switch (LineFramer_push(f, c)) {
+      case LINE_FRAMER_FRAME:    return PROTOCOL_FRAME_READY;
+      case LINE_FRAMER_OVERFLOW: return PROTOCOL_FRAME_OVERFLOW;
+      default:                   return PROTOCOL_FRAME_NONE;
+    }
+  }
+
+  // บรรทัดที่ไม่มี newline ปิด (เช่น T365$) → ถือว่าจบเมื่อเงียบไป
+  static ProtocolFrameResult idle(Framer& f) {
+    switch (LineFramer_finish(f)) {
+      case LINE_FRAMER_FRAME:    return PROTOCOL_FRAME_READY;
+      case LINE_FRAMER_OVERFLOW: return PROTOCOL_FRAME_OVERFLOW;
+      default:                   return PROTOCOL_FRAME_NONE;
+    }
+  }
+
+  static char* frame(Framer& f, size_t& length) {
+    length = f.length;
+    return f.buffer;
+  }
+
+  static void reset(Framer& f) {
+    LineFramer_reset(f);
+  }
+
+  static void clear(Parser& p) {
+    memset(&p.pending, 0, sizeof(p.pending));
+    p.pendingSince = 0;
+  }
+
+  static void toWire(const WeightReading& reading, WireReading& out) {
+    memset(&out, 0, sizeof(out));
+    if ((reading.fields & WEIGHT_FIELD_WEIGHT) && (reading.fields & WEIGHT_FIELD_HEIGHT)) {
+      out.kind = WIRE_KIND_WEIGHT_HEIGHT;
+      out.values[0] = reading.weightTenths;
+      out.values[1] = reading.heightTenths;
+      out.fields = WIRE_FIELD_VALUE0 | WIRE_FIELD_VALUE1;
+      if (reading.fields & WEIGHT_FIELD_TEMP) {
+        out.values[2] = reading.tempTenths;
+        out.fields |= WIRE_FIELD_VALUE2;
+      }
+    } else {
+      out.kind = WIRE_KIND_TEMP;
+      out.values[0] = reading.tempTenths;
+      out.fields = WIRE_FIELD_VALUE0;
+    }
+  }
+
+  static ProtocolParseResult parse(Parser& p, char* frame, size_t length, uint32_t now, WireReading& out) {
+    WeightReading line;
+    memset(&line, 0, sizeof(line));
+    uint8_t found = Weight_tokenizeLine(frame, line);
+    if (found == 0) {
+      p.error = "ไม่พบ W:/H:/T$ ในบรรทัดนี้";
+      return PROTOCOL_PARSE_ERROR;
+    }
+
+    if (found & WEIGHT_FIELD_WEIGHT) p.pending.weightTenths = line.weightTenths;
+    if (found & WEIGHT_FIELD_HEIGHT) p.pending.heightTenths = line.heightTenths;
+    if (found & WEIGHT_FIELD_TEMP) p.pending.tempTenths = line.tempTenths;
+    p.pending.fields |= found;
+    if (p.pendingSince == 0 && (found & (WEIGHT_FIELD_WEIGHT | WEIGHT_FIELD_HEIGHT))) {
+      p.pendingSince = now != 0 ? now : 1;
+    }
+
+    uint8_t pair = WEIGHT_FIELD_WEIGHT | WEIGHT_FIELD_HEIGHT;
+    if ((p.pending.fields & pair) == pair) {
+      // ครบคู่ W+H → ส่งเมื่อนิ่งแล้วเท่านั้น (ค่าเฉลี่ยของ window)
+      int16_t weight, height;
+      StabilityResult stable = Stability_add(p.stability, p.pending.weightTenths, p.pending.heightTenths,
+                                             now, weight, height);
+      if (stable == STABILITY_SETTLED) {
+        p.pending.weightTenths = weight;
+        p.pending.heightTenths = height;
+        toWire(p.pending, out);
+        clear(p);
+        return PROTOCOL_PARSE_READING;
+      }
+      // ยังไม่นิ่ง: ทิ้งคู่นี้ - T ที่มาด้วยส่งเดี่ยว
+      p.pending.fields &= WEIGHT_FIELD_TEMP;
+      p.pendingSince = 0;
+    }
+    if (!(p.pending.fields & pair) && (p.pending.fields & WEIGHT_FIELD_TEMP)) {
+      // ได้ T เดี่ยว
+      toWire(p.pending, out);
+      clear(p);
+      return PROTOCOL_PARSE_READING;
+    }
+    return PROTOCOL_PARSE_PARTIAL;
+  }
+
+  // เครื่องหยุดส่งเกิน STABILITY_QUIET → จบการชั่ง (ส่งค่าถ้านิ่งแต่ยังไม่เคยส่ง)
+  // W หรือ H ค้างเกิน WEIGHT_PAIR_TIMEOUT → ทิ้ง (ต้องมีทั้งคู่) แต่ T ที่รอไปด้วยยังส่งได้
+  static ProtocolParseResult poll(Parser& p, uint32_t now, WireReading& out) {
+    int16_t weight, height;
+    StabilityResult stable = Stability_poll(p.stability, now, weight, height);
+    if (stable == STABILITY_SETTLED) {
+      WeightReading settled;
+      memset(&settled, 0, sizeof(settled));
+      settled.weightTenths = weight;
+      settled.heightTenths = height;
+      settled.fields = WEIGHT_FIELD_WEIGHT | WEIGHT_FIELD_HEIGHT;
+      toWire(settled, out);
+      p.error = "ค่านิ่ง (เครื่องหยุดส่ง)";
+      return PROTOCOL_PARSE_READING;
+    }
+    if (stable == STABILITY_ABANDONED) {
+      p.error = "น้ำหนัก/ส่วนสูงไม่นิ่ง";
+      return PROTOCOL_PARSE_EXPIRED;
+    }
+
+    if (p.pendingSince == 0 || now - p.pendingSince < WEIGHT_PAIR_TIMEOUT) {
+      return PROTOCOL_PARSE_NONE;
+    }
+    p.error = (p.pending.fields & WEIGHT_FIELD_WEIGHT) ? "มีแค่ Weight (ไม่มี Height)"
+                                                       : "มีแค่ Height (ไม่มี Weight)";
+    if (p.pending.fields & WEIGHT_FIELD_TEMP) {
+      p.error = (p.pending.fields & WEIGHT_FIELD_WEIGHT) ? "มีแค่ Weight (ไม่มี Height) - ส่งเฉพาะ T"
+                                                         : "มีแค่ Height (ไม่มี Weight) - ส่งเฉพาะ T";
+      p.pending.fields = WEIGHT_FIELD_TEMP;
+      toWire(p.pending, out);
+      clear(p);
+      return PROTOCOL_PARSE_READING;
+    }
+    clear(p);
+    return PROTOCOL_PARSE_EXPIRED;
+  }
+};
+
+#endif
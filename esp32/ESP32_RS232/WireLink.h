@@ -0,0 +1,190 @@
+/**
+ * WireLink.h
+ * ส่ง reading แบบ Binary (WireProtocol.h) ไปยัง Center ผ่าน UDP
+ *
+ * - เริ่ม session: ส่ง HELLO (MAC + ชื่ออุปกรณ์ + epoch ของ Journal) จนกว่า Center จะ ACK
+ * - จากนั้นส่ง READING ทีละรายการ แล้วรอ ACK ตาม seq (stop-and-wait)
+ * - seq = seq ของ Journal (ไม่เปลี่ยนเมื่อส่งซ้ำ / reboot) → Center กรอง reading ซ้ำได้
+ * - Center ตอบ UNKNOWN_SESSION (เช่น Center reboot) → ส่ง HELLO ใหม่แล้วส่งต่อ
+ * - HEARTBEAT (WireLink_sendHeartbeat) บอก Center ว่ายังออนไลน์ - Center ตอบ UNKNOWN_DEVICE
+ *   เมื่อไม่รู้จักอุปกรณ์ → WireLink_takeStatusRequest() = true ให้ส่ง /api/status
+ *
+ * ทุกฟังก์ชันไม่ block: WireLink_poll() ถูกเรียกซ้ำจาก taskUplink จนได้ผล
+ * ต้อง include หลัง Config.h (ใช้ Config_get()->centerIp)
+ */
+
+#ifndef WIRE_LINK_H
+#define WIRE_LINK_H
+
+#include <WiFiUdp.h>
+#include "WireProtocol.h"
+
+// ===== Configuration =====
+#define WIRE_ACK_TIMEOUT 500     // รอ ACK (ms) ก่อนถือว่าส่งไม่สำเร็จ
+
+enum WireLinkResult {
+  WIRE_LINK_PENDING,      // กำลังรอ ACK
+  WIRE_LINK_DELIVERED,    // Center รับแล้ว
+  WIRE_LINK_REJECTED,     // Center ไม่รับข้อมูลนี้ (ทิ้ง)
+  WIRE_LINK_TIMEOUT       // ไม่มี ACK ภายในเวลา
+};
+
+// ===== Session =====
+WiFiUDP wireUdp;
+WireHello wireHello;
+uint16_t wireSession = 0;
+bool wireStarted = false;
+bool wireHelloAcked = false;
+unsigned long wireHelloSentAt = 0;
+bool wireHelloInFlight = false;
+uint32_t wireSeq = 0;                // ใช้เมื่อไม่มี journal (seq ไม่คงที่ข้าม reboot)
+uint32_t wireInFlightSeq = 0;        // 0 = ไม่มี reading ที่รอ ACK
+unsigned long wireSentAt = 0;
+bool wireAckReceived = false;
+uint8_t wireAckStatus = WIRE_ACK_OK;
+bool wireStatusRequested = false;    // Center ขอข้อมูลอุปกรณ์ (/api/status)
+
+// ===== สถิติ =====
+unsigned long wireHelloCount = 0;
+unsigned long wireBytesSent = 0;
+unsigned long wireReadingCount = 0;
+unsigned long wireHeartbeatCount = 0;
+
+// ===== เริ่มต้น (ข้อมูลอุปกรณ์สำหรับ HELLO) =====
+// epoch = Journal_getEpoch() (0 = ไม่มี journal)
+void WireLink_begin(const uint8_t* mac, const char* name, uint32_t epoch) {
+  memcpy(wireHello.mac, mac, 6);
+  strlcpy(wireHello.name, name, sizeof(wireHello.name));
+  wireHello.epoch = epoch;
+  wireSession = random(1, 65536);
+}
+
+// ===== เริ่ม session ใหม่ (เรียกเมื่อ WiFi หลุด) =====
+void WireLink_reset() {
+  wireHelloAcked = false;
+  wireHelloInFlight = false;
+  wireInFlightSeq = 0;
+  wireAckReceived = false;
+}
+
+// ===== ส่ง frame ไปยัง Center =====
+void WireLink_sendFrame(const uint8_t* frame, size_t length) {
+  if (!wireStarted) {
+    wireUdp.begin(WIRE_UDP_PORT);
+    wireStarted = true;
+  }
+  wireUdp.beginPacket(Config_get()->centerIp, WIRE_UDP_PORT);
+  wireUdp.write(frame, length);
+  wireUdp.endPacket();
+  wireBytesSent += length;
+}
+
+// ===== อ่าน ACK ที่เข้ามา =====
+void WireLink_receive() {
+  if (!wireStarted) {
+    return;
+  }
+
+  uint8_t frame[WIRE_MAX_FRAME];
+  while (wireUdp.parsePacket() > 0) {
+    int length = wireUdp.read(frame, sizeof(frame));
+    WireHeader header;
+    if (length <= 0 || Wire_parseFrame(frame, length, header) < 0) {
+      continue;
+    }
+    if (header.type != WIRE_MSG_ACK || header.session != wireSession) {
+      continue;
+    }
+
+    if (header.status == WIRE_ACK_UNKNOWN_DEVICE) {
+      wireStatusRequested = true;
+    } else if (header.status == WIRE_ACK_UNKNOWN_SESSION) {
+      // Center ไม่รู้จัก session นี้ → HELLO ใหม่ แล้วส่ง reading เดิมซ้ำ
+      WireLink_reset();
+    } else if (header.seq == 0 && wireHelloInFlight) {
+      wireHelloAcked = true;
+      wireHelloInFlight = false;
+    } else if (header.seq == wireInFlightSeq) {
+      wireAckReceived = true;
+      wireAckStatus = header.status;
+    }
+  }
+}
+
+// ===== ส่ง reading (packed) แล้วติดตามผล - เรียกซ้ำจนไม่ได้ PENDING =====
+// seq = seq ของ reading ใน Journal (0 = ไม่มี journal → ใช้ตัวนับของ session)
+WireLinkResult WireLink_poll(const uint8_t* packed, size_t length, uint32_t seq) {
+  WireLink_receive();
+  unsigned long now = millis();
+  uint8_t frame[WIRE_MAX_FRAME];
+
+  // 1. ยังไม่มี session → ส่ง HELLO ก่อน
+  if (!wireHelloAcked) {
+    if (!wireHelloInFlight) {
+      WireLink_sendFrame(frame, Wire_encodeHello(frame, wireSession, wireHello));
+      wireHelloInFlight = true;
+      wireHelloSentAt = now;
+      wireHelloCount++;
+    } else if (now - wireHelloSentAt > WIRE_ACK_TIMEOUT) {
+      wireHelloInFlight = false;
+      return WIRE_LINK_TIMEOUT;
+    }
+    return WIRE_LINK_PENDING;
+  }
+
+  // 2. ส่ง reading
+  if (wireInFlightSeq == 0) {
+    if (length != WIRE_READING_SIZE) {
+      return WIRE_LINK_REJECTED;
+    }
+    wireInFlightSeq = seq != 0 ? seq : ++wireSeq;
+    wireAckReceived = false;
+    wireSentAt = now;
+    uint8_t flags = seq != 0 ? WIRE_READING_DURABLE_SEQ : 0;
+    WireLink_sendFrame(frame, Wire_encodeReading(frame, wireSession, wireInFlightSeq, packed, flags));
+    return WIRE_LINK_PENDING;
+  }
+
+  // 3. รอ ACK
+  if (wireAckReceived) {
+    wireInFlightSeq = 0;
+    if (wireAckStatus != WIRE_ACK_OK) {
+      return WIRE_LINK_REJECTED;
+    }
+    wireReadingCount++;
+    return WIRE_LINK_DELIVERED;
+  }
+  if (now - wireSentAt > WIRE_ACK_TIMEOUT) {
+    wireInFlightSeq = 0;
+    return WIRE_LINK_TIMEOUT;
+  }
+  return WIRE_LINK_PENDING;
+}
+
+// ===== HEARTBEAT (ไม่รอ ACK - คำตอบถูกอ่านในรอบถัดไป) =====
+void WireLink_sendHeartbeat() {
+  WireLink_receive();
+  uint8_t frame[WIRE_HEADER_SIZE + WIRE_HEARTBEAT_SIZE + WIRE_CRC_SIZE];
+  WireLink_sendFrame(frame, Wire_encodeHeartbeat(frame, wireSession, wireHello.mac));
+  wireHeartbeatCount++;
+}
+
+// คืน true ครั้งเดียวต่อคำขอ
+bool WireLink_takeStatusRequest() {
+  WireLink_receive();
+  bool requested = wireStatusRequested;
+  wireStatusRequested = false;
+  return requested;
+}
+
+// ===== payload ในคิวเป็น Binary reading หรือไม่ (JSON ขึ้นต้นด้วย '{') =====
+bool WireLink_isPacked(const char* payload, size_t length) {
+  return length == WIRE_READING_SIZE && payload[0] != '{';
+}
+
+// ===== สถิติ =====
+unsigned long WireLink_getBytesPerReading() {
+  return wireReadingCount > 0 ? wireBytesSent / wireReadingCount : 0;
+}
+
+#endif
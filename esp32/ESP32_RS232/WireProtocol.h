@@ -0,0 +1,291 @@
+/**
+ * WireProtocol.h
+ * โปรโตคอล Binary ขนาดเล็กระหว่าง Device กับ Center (UDP)
+ *
+ * ใช้แทน JSON ที่ส่งซ้ำ deviceId/deviceName/macAddress ทุก reading
+ * - HELLO: ส่งข้อมูลอุปกรณ์ (MAC + ชื่อ + epoch ของ seq) ครั้งเดียวต่อ session
+ * - READING: ค่าที่วัดได้แบบ fixed layout (22 bytes) อ้างอิง session แทนข้อมูลอุปกรณ์
+ * - ACK: Center ตอบรับตาม seq (หรือแจ้งให้ส่ง HELLO ใหม่)
+ * - HEARTBEAT: บอกว่ายังออนไลน์ (MAC 6 bytes) แทน POST /api/status ทุกไม่กี่วินาที
+ *   Center ไม่ตอบ ยกเว้นไม่รู้จักอุปกรณ์ → ACK สถานะ UNKNOWN_DEVICE ให้ส่ง /api/status
+ *
+ * Frame (little-endian ทุก field):
+ *
+ *   [magic 1][version 1][type 1][status 1][session 2][seq 4][payload ...][crc16 2]
+ *
+ * HELLO payload:
+ *
+ *   [mac 6][name length 1][name ...][epoch 4]
+ *
+ * READING payload:
+ *
+ *   [kind 1][fields 1][idcard 8][value0 2][value1 2][value2 2][value3 2][timestamp 4]
+ *
+ * - crc16 = CRC-16/CCITT-FALSE ของทุก byte ก่อนหน้า
+ * - status ของ READING = WIRE_READING_* flags (ของ ACK = WireAckStatus)
+ * - ค่า BP เป็น mmHg, ค่า weight/height/temp เป็นทศนิยม 1 ตำแหน่ง x10
+ * - epoch ใน HELLO เปลี่ยนทุกครั้งที่ตัวนับ seq ของอุปกรณ์เริ่มใหม่ (0 = ไม่มี journal)
+ *   ไม่มี epoch (HELLO จาก firmware เก่า) ยังรับได้ → epoch = 0
+ * - ต้นฉบับอยู่ที่ common/ - Arduino IDE compile เฉพาะไฟล์ในโฟลเดอร์ sketch จึงมีสำเนาใน ESP32_RS232/, center/, device/
+ *   แก้ที่ common/ แล้ว copy ทับทุกสำเนา (host/CMakeLists.txt ไม่ยอม configure ถ้าไม่ตรงกัน)
+ *   และเพิ่ม WIRE_VERSION ถ้า layout เปลี่ยน
+ */
+
+#ifndef WIRE_PROTOCOL_H
+#define WIRE_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ===== Configuration =====
+#define WIRE_UDP_PORT 5600
+#define WIRE_MAGIC 0xA5
+#define WIRE_VERSION 1
+#define WIRE_HEADER_SIZE 10
+#define WIRE_CRC_SIZE 2
+#define WIRE_READING_SIZE 22
+#define WIRE_NAME_SIZE 32
+#define WIRE_HEARTBEAT_SIZE 6
+#define WIRE_MAX_FRAME (WIRE_HEADER_SIZE + 7 + WIRE_NAME_SIZE + 4 + WIRE_CRC_SIZE)
+
+// ===== ประเภทข้อความ =====
+enum WireMessageType : uint8_t {
+  WIRE_MSG_HELLO = 1,
+  WIRE_MSG_READING = 2,
+  WIRE_MSG_ACK = 3,
+  WIRE_MSG_HEARTBEAT = 4
+};
+
+// ===== สถานะใน ACK =====
+enum WireAckStatus : uint8_t {
+  WIRE_ACK_OK = 0,
+  WIRE_ACK_UNKNOWN_SESSION = 1,   // Center ไม่รู้จัก session → ส่ง HELLO ใหม่
+  WIRE_ACK_REJECTED = 2,          // ข้อมูลผิดรูปแบบ → ทิ้ง (ส่งซ้ำก็ไม่ผ่าน)
+  WIRE_ACK_UNKNOWN_DEVICE = 3     // HEARTBEAT จากอุปกรณ์ที่ไม่อยู่ในรายชื่อ → ส่ง /api/status
+};
+
+// ===== ชนิดของ reading (แปลงเป็น deviceType ของ JSON เดิม) =====
+enum WireKind : uint8_t {
+  WIRE_KIND_BLOOD_PRESSURE = 1,   // value0=bp, value1=bp2, value2=pulse
+  WIRE_KIND_WEIGHT_HEIGHT = 2,    // value0=weight, value1=height, value2=temp (x10)
+  WIRE_KIND_TEMP = 3,             // value0=temp (x10)
+  WIRE_KIND_WEIGHT = 4,           // value0=weight (x10)
+  WIRE_KIND_HEIGHT = 5            // value0=height (x10)
+};
+
+#define WIRE_FIELD_VALUE0 0x01
+#define WIRE_FIELD_VALUE1 0x02
+#define WIRE_FIELD_VALUE2 0x04
+#define WIRE_FIELD_VALUE3 0x08
+#define WIRE_FIELD_IDCARD 0x10
+
+// ===== flags ใน status ของ READING =====
+#define WIRE_READING_DURABLE_SEQ 0x01   // seq มาจาก Journal (ไม่เปลี่ยนเมื่อส่งซ้ำ/reboot) → Center กรองซ้ำได้
+
+struct WireHeader {
+  uint8_t type;
+  uint8_t status;
+  uint16_t session;
+  uint32_t seq;
+};
+
+struct WireReading {
+  uint8_t kind;
+  uint8_t fields;
+  uint64_t idcard;        // เลขบัตรประชาชน 13 หลักเป็นตัวเลข (0 = ไม่มี)
+  int16_t values[4];
+  uint32_t timestamp;     // millis() ของ device
+};
+
+struct WireHello {
+  uint8_t mac[6];
+  char name[WIRE_NAME_SIZE];
+  uint32_t epoch;         // epoch ของตัวนับ seq (0 = ไม่มี journal)
+};
+
+// ===== CRC-16/CCITT-FALSE =====
+// ต่อ CRC ข้ามหลาย buffer ได้โดยส่งค่าที่ได้ก่อนหน้าเป็น crc
+inline uint16_t Wire_crc16(const uint8_t* data, size_t length, uint16_t crc = 0xFFFF) {
+  while (length--) {
+    crc ^= (uint16_t)(*data++) << 8;
+    for (int i = 0; i < 8; i++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+// ===== อ่าน/เขียนตัวเลขแบบ little-endian =====
+inline void Wire_put16(uint8_t* p, uint16_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+}
+
+inline void Wire_put32(uint8_t* p, uint32_t v) {
+  Wire_put16(p, v);
+  Wire_put16(p + 2, v >> 16);
+}
+
+inline uint16_t Wire_get16(const uint8_t* p) {
+  return p[0] | ((uint16_t)p[1] << 8);
+}
+
+inline uint32_t Wire_get32(const uint8_t* p) {
+  return Wire_get16(p) | ((uint32_t)Wire_get16(p + 2) << 16);
+}
+
+// ===== ประกอบ frame (ใส่ header + crc รอบ payload ที่เขียนไว้แล้ว) =====
+// payload ต้องอยู่ที่ buffer + WIRE_HEADER_SIZE แล้ว คืนขนาด frame ทั้งหมด
+inline size_t Wire_finishFrame(uint8_t* buffer, const WireHeader& header, size_t payloadLength) {
+  buffer[0] = WIRE_MAGIC;
+  buffer[1] = WIRE_VERSION;
+  buffer[2] = header.type;
+  buffer[3] = header.status;
+  Wire_put16(buffer + 4, header.session);
+  Wire_put32(buffer + 6, header.seq);
+
+  size_t length = WIRE_HEADER_SIZE + payloadLength;
+  Wire_put16(buffer + length, Wire_crc16(buffer, length));
+  return length + WIRE_CRC_SIZE;
+}
+
+// ===== ตรวจและแยก header (คืนขนาด payload, -1 = frame เสีย) =====
+inline int Wire_parseFrame(const uint8_t* buffer, size_t length, WireHeader& header) {
+  if (length < WIRE_HEADER_SIZE + WIRE_CRC_SIZE) {
+    return -1;
+  }
+  if (buffer[0] != WIRE_MAGIC || buffer[1] != WIRE_VERSION) {
+    return -1;
+  }
+  size_t body = length - WIRE_CRC_SIZE;
+  if (Wire_get16(buffer + body) != Wire_crc16(buffer, body)) {
+    return -1;
+  }
+
+  header.type = buffer[2];
+  header.status = buffer[3];
+  header.session = Wire_get16(buffer + 4);
+  header.seq = Wire_get32(buffer + 6);
+  return body - WIRE_HEADER_SIZE;
+}
+
+// ===== READING =====
+// pack ค่าลง 22 bytes (เก็บในคิว/journal ได้เลย) - session/seq ใส่ตอนส่ง
+inline void Wire_packReading(uint8_t* p, const WireReading& reading) {
+  p[0] = reading.kind;
+  p[1] = reading.fields;
+  Wire_put32(p + 2, (uint32_t)reading.idcard);
+  Wire_put32(p + 6, (uint32_t)(reading.idcard >> 32));
+  for (int i = 0; i < 4; i++) {
+    Wire_put16(p + 10 + i * 2, (uint16_t)reading.values[i]);
+  }
+  Wire_put32(p + 18, reading.timestamp);
+}
+
+inline size_t Wire_encodeReading(uint8_t* buffer, uint16_t session, uint32_t seq, const uint8_t* packed,
+                                 uint8_t flags = 0) {
+  memcpy(buffer + WIRE_HEADER_SIZE, packed, WIRE_READING_SIZE);
+  WireHeader header = { WIRE_MSG_READING, flags, session, seq };
+  return Wire_finishFrame(buffer, header, WIRE_READING_SIZE);
+}
+
+inline bool Wire_decodeReading(const uint8_t* payload, size_t length, WireReading& reading) {
+  if (length != WIRE_READING_SIZE) {
+    return false;
+  }
+  reading.kind = payload[0];
+  reading.fields = payload[1];
+  reading.idcard = Wire_get32(payload + 2) | ((uint64_t)Wire_get32(payload + 6) << 32);
+  for (int i = 0; i < 4; i++) {
+    reading.values[i] = (int16_t)Wire_get16(payload + 10 + i * 2);
+  }
+  reading.timestamp = Wire_get32(payload + 18);
+  return reading.kind >= WIRE_KIND_BLOOD_PRESSURE && reading.kind <= WIRE_KIND_HEIGHT;
+}
+
+// ===== HELLO =====
+inline size_t Wire_encodeHello(uint8_t* buffer, uint16_t session, const WireHello& hello) {
+  uint8_t* p = buffer + WIRE_HEADER_SIZE;
+  size_t nameLength = strnlen(hello.name, WIRE_NAME_SIZE - 1);
+  memcpy(p, hello.mac, 6);
+  p[6] = nameLength;
+  memcpy(p + 7, hello.name, nameLength);
+  Wire_put32(p + 7 + nameLength, hello.epoch);
+
+  WireHeader header = { WIRE_MSG_HELLO, 0, session, 0 };
+  return Wire_finishFrame(buffer, header, 7 + nameLength + 4);
+}
+
+inline bool Wire_decodeHello(const uint8_t* payload, size_t length, WireHello& hello) {
+  if (length < 7 || payload[6] >= WIRE_NAME_SIZE) {
+    return false;
+  }
+  size_t nameEnd = 7 + (size_t)payload[6];
+  if (length != nameEnd && length != nameEnd + 4) {
+    return false;
+  }
+  memcpy(hello.mac, payload, 6);
+  memcpy(hello.name, payload + 7, payload[6]);
+  hello.name[payload[6]] = '\0';
+  hello.epoch = length == nameEnd + 4 ? Wire_get32(payload + nameEnd) : 0;
+  return true;
+}
+
+// ===== ACK =====
+inline size_t Wire_encodeAck(uint8_t* buffer, uint16_t session, uint32_t seq, uint8_t status) {
+  WireHeader header = { WIRE_MSG_ACK, status, session, seq };
+  return Wire_finishFrame(buffer, header, 0);
+}
+
+// ===== HEARTBEAT =====
+inline size_t Wire_encodeHeartbeat(uint8_t* buffer, uint16_t session, const uint8_t* mac) {
+  memcpy(buffer + WIRE_HEADER_SIZE, mac, 6);
+  WireHeader header = { WIRE_MSG_HEARTBEAT, 0, session, 0 };
+  return Wire_finishFrame(buffer, header, WIRE_HEARTBEAT_SIZE);
+}
+
+inline bool Wire_decodeHeartbeat(const uint8_t* payload, size_t length, uint8_t* mac) {
+  if (length != WIRE_HEARTBEAT_SIZE) {
+    return false;
+  }
+  memcpy(mac, payload, 6);
+  return true;
+}
+
+// ===== เลขบัตรประชาชน (string ตัวเลข ↔ uint64) =====
+inline uint64_t Wire_idcardFromString(const char* idcard) {
+  uint64_t value = 0;
+  if (idcard == nullptr) {
+    return 0;
+  }
+  for (; *idcard != '\0'; idcard++) {
+    if (*idcard < '0' || *idcard > '9') {
+      return 0;
+    }
+    value = value * 10 + (*idcard - '0');
+  }
+  return value;
+}
+
+inline void Wire_idcardToString(uint64_t value, char* out, size_t size) {
+  char digits[21];
+  int n = 0;
+  do {
+    digits[n++] = '0' + value % 10;
+    value /= 10;
+  } while (value > 0 && n < 20);
+
+  // เลขบัตรประชาชนไทย 13 หลัก - เติม 0 ด้านหน้าให้ครบ
+  while (n < 13) {
+    digits[n++] = '0';
+  }
+
+  size_t i = 0;
+  while (n > 0 && i + 1 < size) {
+    out[i++] = digits[--n];
+  }
+  out[i] = '\0';
+}
+
+#endif
@@ -0,0 +1,882 @@
+/**
+ * LoadGenerator.cpp
+ * จำลองอุปกรณ์ N ตัวส่งข้อมูลเข้า Center พร้อมกัน → หาจุดที่ Center เริ่มรับไม่ไหว (saturation)
+ *
+ *   g++ -std=c++11 -O2 -o loadgen esp32/LoadGenerator/LoadGenerator.cpp
+ *   ./loadgen --center 10.1.10.1 --sweep 1,2,4,8,16,32 --interval 2000 --duration 60 > load.jsonl
+ *
+ * - HTTP (ค่าเริ่มต้น): POST /api/vitals เปิด connection ใหม่ทุก request (เหมือน HTTPClient ของอุปกรณ์)
+ *   Binary (--transport wire): HELLO แล้วส่ง READING ทีละ 1 รอ ACK (stop-and-wait เหมือน WireLink.h)
+ * - ทุกอุปกรณ์ส่ง UDP heartbeat / Center ตอบ UNKNOWN_DEVICE → POST /api/status (เหมือน ESP32_RS232)
+ * - ผล: JSON Lines ทาง stdout (1 บรรทัดต่อขั้น + บรรทัดสรุป) / ตารางทาง stderr
+ * - --standin: ไม่มีบอร์ด → ยิง Center จำลองในโปรเซสเดียวกัน (127.0.0.1)
+ *   ตอบแบบ Center: 200 ทันทีถ้า Inbox ยังว่าง / 503 เมื่อเต็ม และ loop() ใช้ --service-us ต่อ reading
+ *   ตัวเลขจาก stand-in = ตัว generator + โมเดลคิว ไม่ใช่ความจุของ ESP32 (ต้องยิงบอร์ดจริง)
+ *
+ * Linux / macOS (POSIX socket + poll) - ไม่ใช้ thread, 1 socket ต่อ request ที่ค้างอยู่
+ * อุปกรณ์มากกว่า ~500 ตัวพร้อม --standin อาจต้องเพิ่ม ulimit -n
+ */
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+#include <deque>
+#include <map>
+#include <string>
+#include "LoadProfile.h"
+#include "../center/DedupWindow.h"
+
+// ===== Configuration =====
+#define HTTP_REQUEST_SIZE (LOAD_PAYLOAD_SIZE + 256)
+#define HTTP_RESPONSE_SIZE 512
+#define STANDIN_INBOX_CAPACITY 32      // = INBOX_CAPACITY ของ Center (ESP32)
+#define STANDIN_REQUEST_SIZE 1024
+
+enum HttpState : uint8_t {
+  HTTP_IDLE = 0,
+  HTTP_CONNECTING,
+  HTTP_SENDING,
+  HTTP_RECEIVING
+};
+
+// ===== สถานะ I/O ของอุปกรณ์จำลอง =====
+struct DeviceRuntime {
+  HttpState state;
+  int fd;
+  bool isStatus;           // request นี้คือ /api/status (ไม่นับใน latency ของ reading)
+  bool abandon;            // churn: ส่ง body ไม่ครบแล้วปิด
+  uint64_t startUs;
+  char request[HTTP_REQUEST_SIZE];
+  size_t requestLength;
+  size_t requestSent;
+  char response[HTTP_RESPONSE_SIZE];
+  size_t responseLength;
+
+  uint32_t backlog;        // reading ที่ถึงเวลาแล้วแต่ยังส่งไม่ได้ (คิวของอุปกรณ์)
+  bool needStatus;         // Center ตอบ heartbeat ว่า UNKNOWN_DEVICE
+
+  bool helloAcked;         // Binary
+  uint64_t helloSentUs;
+  uint32_t pendingSeq;     // reading ที่รอ ACK (0 = ไม่มี)
+  uint64_t pendingSentUs;
+};
+
+// ===== Variables =====
+LoadOptions options = { 20000, 0.2, 0, 0, 0.0, 3000, 0, { 1, 1, 1 }, 1 };
+bool wireTransport = false;
+uint32_t durationMs = 30000;
+uint32_t pauseMs = 2000;
+std::vector<uint32_t> sweep;
+
+sockaddr_in centerHttp;
+sockaddr_in centerUdp;
+int udpFd = -1;
+
+LoadRandom loadRandom;
+LoadDevice devices[LOAD_MAX_DEVICES];
+DeviceRuntime runtimes[LOAD_MAX_DEVICES];
+std::map<uint16_t, int> sessionToDevice;
+LoadStats stats;
+uint64_t startedUs = 0;
+
+// ===== เวลา (us ตั้งแต่เริ่มโปรแกรม) =====
+uint64_t nowUs() {
+  timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000 - startedUs;
+}
+
+bool setNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// ===== STAND-IN: Center จำลอง (เฉพาะ --standin) =====
+// Inbox = คิวเวลาที่ loop() ประมวลผลเสร็จ (ไม่มี thread - คิดจากเวลาตอนรับ)
+struct StandinConn {
+  int fd;
+  char data[STANDIN_REQUEST_SIZE];
+  size_t length;
+};
+
+struct StandinAck {
+  uint64_t at;             // loop() ประมวลผลเสร็จ → ACK
+  sockaddr_in to;
+  uint16_t session;
+  uint32_t seq;
+};
+
+bool standinEnabled = false;
+uint32_t standinServiceUs = 2000;
+int standinListenFd = -1;
+int standinUdpFd = -1;
+std::vector<StandinConn> standinConns;
+std::deque<uint64_t> standinInbox;
+uint64_t standinLastFinish = 0;
+std::deque<StandinAck> standinAcks;
+std::map<std::string, DedupWindow> standinDevices;   // MAC → DedupWindow (มี = รู้จักแล้ว)
+std::map<uint16_t, std::string> standinSessions;
+uint32_t standinDuplicates = 0;
+
+bool standinEnqueue(uint64_t now, uint64_t& finish) {
+  while (!standinInbox.empty() && standinInbox.front() <= now) {
+    standinInbox.pop_front();
+  }
+  if (standinInbox.size() >= STANDIN_INBOX_CAPACITY) {
+    return false;
+  }
+  finish = (standinLastFinish > now ? standinLastFinish : now) + standinServiceUs;
+  standinLastFinish = finish;
+  standinInbox.push_back(finish);
+  return true;
+}
+
+void standinAccept(const char* mac, uint32_t epoch, uint32_t seq) {
+  if (Dedup_check(standinDevices[mac], epoch, seq) == DEDUP_DUPLICATE) {
+    standinDuplicates++;
+  }
+}
+
+// ดึงค่า string ของ key จาก JSON แบบง่าย (payload ของ generator เอง)
+bool standinField(const char* body, const char* key, char* out, size_t size) {
+  const char* p = strstr(body, key);
+  if (p == nullptr || (p = strchr(p + strlen(key), '"')) == nullptr) {
+    return false;
+  }
+  size_t length = strcspn(p + 1, "\"");
+  if (length >= size) {
+    return false;
+  }
+  memcpy(out, p + 1, length);
+  out[length] = '\0';
+  return true;
+}
+
+bool standinBegin() {
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(addr);
+
+  standinListenFd = socket(AF_INET, SOCK_STREAM, 0);
+  int yes = 1;
+  setsockopt(standinListenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+  if (bind(standinListenFd, (sockaddr*)&addr, sizeof(addr)) != 0 ||
+      listen(standinListenFd, 512) != 0 ||
+      getsockname(standinListenFd, (sockaddr*)&centerHttp, &length) != 0) {
+    return false;
+  }
+  setNonBlocking(standinListenFd);
+
+  standinUdpFd = socket(AF_INET, SOCK_DGRAM, 0);
+  length = sizeof(addr);
+  if (bind(standinUdpFd, (sockaddr*)&addr, sizeof(addr)) != 0 ||
+      getsockname(standinUdpFd, (sockaddr*)&centerUdp, &length) != 0) {
+    return false;
+  }
+  setNonBlocking(standinUdpFd);
+  return true;
+}
+
+void standinRespond(StandinConn& conn, int code, const char* body) {
+  char response[256];
+  int length = snprintf(response, sizeof(response),
+                        "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\nContent-Length: %u\r\n"
+                        "Connection: close\r\n\r\n%s",
+                        code, code == 200 ? "OK" : code == 503 ? "Service Unavailable" : "Not Found",
+                        (unsigned)strlen(body), body);
+  send(conn.fd, response, length, 0);
+}
+
+// request ครบแล้ว → ตอบแบบ Center (true = ปิด connection ได้)
+bool standinHandleHttp(StandinConn& conn, uint64_t now) {
+  conn.data[conn.length] = '\0';
+  char* headerEnd = strstr(conn.data, "\r\n\r\n");
+  if (headerEnd == nullptr) {
+    return false;
+  }
+  const char* lengthHeader = strstr(conn.data, "Content-Length:");
+  size_t bodyLength = lengthHeader != nullptr ? strtoul(lengthHeader + 15, nullptr, 10) : 0;
+  const char* body = headerEnd + 4;
+  if ((size_t)(conn.data + conn.length - body) < bodyLength) {
+    return false;
+  }
+
+  char mac[18];
+  if (!standinField(body, "\"macAddress\"", mac, sizeof(mac))) {
+    standinRespond(conn, 404, "{\"error\":\"Not found\"}");
+    return true;
+  }
+  uint64_t finish;
+  if (!standinEnqueue(now, finish)) {
+    standinRespond(conn, 503, "{\"error\":\"Center busy\"}");
+    return true;
+  }
+  if (strncmp(conn.data, "POST /api/status ", 17) == 0) {
+    const char* epoch = strstr(body, "\"epoch\":");
+    Dedup_setEpoch(standinDevices[mac], epoch != nullptr ? strtoul(epoch + 8, nullptr, 10) : 0);
+    standinRespond(conn, 200, "{\"status\":\"ok\",\"message\":\"Status received\"}");
+  } else {
+    const char* seq = strstr(body, "\"seq\":");
+    const char* epoch = strstr(body, "\"epoch\":");
+    standinAccept(mac, epoch != nullptr ? strtoul(epoch + 8, nullptr, 10) : 0,
+                  seq != nullptr ? strtoul(seq + 6, nullptr, 10) : 0);
+    standinRespond(conn, 200, "{\"status\":\"ok\",\"message\":\"Data received\"}");
+  }
+  return true;
+}
+
+void standinSendAck(const sockaddr_in& to, uint16_t session, uint32_t seq, uint8_t status) {
+  uint8_t frame[WIRE_HEADER_SIZE + WIRE_CRC_SIZE];
+  size_t length = Wire_encodeAck(frame, session, seq, status);
+  sendto(standinUdpFd, frame, length, 0, (const sockaddr*)&to, sizeof(to));
+}
+
+void standinHandleUdp(uint64_t now) {
+  uint8_t frame[WIRE_MAX_FRAME];
+  sockaddr_in from;
+  socklen_t fromLength = sizeof(from);
+  ssize_t length;
+  while ((length = recvfrom(standinUdpFd, frame, sizeof(frame), 0, (sockaddr*)&from, &fromLength)) > 0) {
+    WireHeader header;
+    int payloadLength = Wire_parseFrame(frame, length, header);
+    const uint8_t* payload = frame + WIRE_HEADER_SIZE;
+    if (payloadLength < 0) {
+      continue;
+    }
+    if (header.type == WIRE_MSG_HELLO) {
+      WireHello hello;
+      if (Wire_decodeHello(payload, payloadLength, hello)) {
+        char macText[18];
+        Load_formatMac(hello.mac, macText, sizeof(macText));
+        standinSessions[header.session] = macText;
+        Dedup_setEpoch(standinDevices[macText], hello.epoch);
+        standinSendAck(from, header.session, 0, WIRE_ACK_OK);
+      }
+    } else if (header.type == WIRE_MSG_READING) {
+      std::map<uint16_t, std::string>::iterator session = standinSessions.find(header.session);
+      uint64_t finish;
+      if (session == standinSessions.end()) {
+        standinSendAck(from, header.session, header.seq, WIRE_ACK_UNKNOWN_SESSION);
+      } else if (standinEnqueue(now, finish)) {
+        // Center ประมวลผล UDP ใน loop() แล้วจึง ACK
+        standinAccept(session->second.c_str(), 0, header.seq);
+        StandinAck ack = { finish, from, header.session, header.seq };
+        standinAcks.push_back(ack);
+      }
+      // คิวเต็ม = packet หาย (ไม่ ACK → อุปกรณ์หมดเวลา)
+    } else if (header.type == WIRE_MSG_HEARTBEAT) {
+      uint8_t mac[6];
+      char macText[18];
+      if (Wire_decodeHeartbeat(payload, payloadLength, mac)) {
+        Load_formatMac(mac, macText, sizeof(macText));
+        if (standinDevices.find(macText) == standinDevices.end()) {
+          standinSendAck(from, header.session, 0, WIRE_ACK_UNKNOWN_DEVICE);
+        }
+      }
+    }
+    fromLength = sizeof(from);
+  }
+}
+
+void standinPoll(uint64_t now) {
+  int fd;
+  while ((fd = accept(standinListenFd, nullptr, nullptr)) >= 0) {
+    setNonBlocking(fd);
+    StandinConn conn;
+    conn.fd = fd;
+    conn.length = 0;
+    standinConns.push_back(conn);
+  }
+  for (size_t i = 0; i < standinConns.size();) {
+    StandinConn& conn = standinConns[i];
+    ssize_t n = recv(conn.fd, conn.data + conn.length, sizeof(conn.data) - 1 - conn.length, 0);
+    bool done = n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK);
+    if (n > 0) {
+      conn.length += n;
+      done = standinHandleHttp(conn, now) || conn.length >= sizeof(conn.data) - 1;
+    }
+    if (done) {
+      close(conn.fd);
+      standinConns[i] = standinConns.back();
+      standinConns.pop_back();
+    } else {
+      i++;
+    }
+  }
+  standinHandleUdp(now);
+  while (!standinAcks.empty() && standinAcks.front().at <= now) {
+    const StandinAck& ack = standinAcks.front();
+    standinSendAck(ack.to, ack.session, ack.seq, WIRE_ACK_OK);
+    standinAcks.pop_front();
+  }
+}
+
+// stand-in อยู่ใน poll() เดียวกับ generator (owner = -2) → ตอบทันทีไม่ต้องรอรอบถัดไป
+void standinPollFds(std::vector<pollfd>& fds, std::vector<int>& owners) {
+  pollfd listenFd = { standinListenFd, POLLIN, 0 };
+  pollfd udp = { standinUdpFd, POLLIN, 0 };
+  fds.push_back(listenFd);
+  fds.push_back(udp);
+  for (size_t i = 0; i < standinConns.size(); i++) {
+    pollfd conn = { standinConns[i].fd, POLLIN, 0 };
+    fds.push_back(conn);
+  }
+  owners.resize(fds.size(), -2);
+}
+
+// ===== HTTP client (1 request ต่อ connection) =====
+void httpClose(DeviceRuntime& rt) {
+  if (rt.fd >= 0) {
+    close(rt.fd);
+  }
+  rt.fd = -1;
+  rt.state = HTTP_IDLE;
+}
+
+void httpFinish(DeviceRuntime& rt, int code, uint64_t now) {
+  if (!rt.isStatus) {
+    if (code == 200) {
+      stats.ok++;
+      stats.latencyUs.push_back((uint32_t)(now - rt.startUs));
+    } else if (code == 503) {
+      stats.busy++;
+    } else {
+      stats.errors++;
+    }
+  } else if (code == 200) {
+    rt.needStatus = false;
+  }
+  httpClose(rt);
+}
+
+bool httpStart(DeviceRuntime& rt, const char* path, const char* body, size_t length, uint64_t now) {
+  rt.requestLength = snprintf(rt.request, sizeof(rt.request),
+                              "POST %s HTTP/1.1\r\nHost: %s\r\nContent-Type: application/json\r\n"
+                              "Content-Length: %u\r\nConnection: close\r\n\r\n",
+                              path, inet_ntoa(centerHttp.sin_addr), (unsigned)length);
+  if (rt.requestLength + length >= sizeof(rt.request)) {
+    return false;
+  }
+  memcpy(rt.request + rt.requestLength, body, length);
+  rt.abandon = !rt.isStatus && LoadRandom_unit(loadRandom) < options.churn;
+  rt.requestLength += rt.abandon ? length / 2 : length;
+  rt.requestSent = 0;
+  rt.responseLength = 0;
+  rt.startUs = now;
+
+  rt.fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (rt.fd < 0 || !setNonBlocking(rt.fd)) {
+    httpFinish(rt, 0, now);
+    return true;
+  }
+  if (connect(rt.fd, (const sockaddr*)&centerHttp, sizeof(centerHttp)) == 0) {
+    rt.state = HTTP_SENDING;
+  } else if (errno == EINPROGRESS) {
+    rt.state = HTTP_CONNECTING;
+  } else {
+    httpFinish(rt, 0, now);
+  }
+  return true;
+}
+
+// status code เมื่อได้ header + body ครบ / server ปิด (-1 = ยังไม่ครบ)
+int httpParse(DeviceRuntime& rt, bool closed) {
+  rt.response[rt.responseLength] = '\0';
+  const char* headerEnd = strstr(rt.response, "\r\n\r\n");
+  if (headerEnd == nullptr || strncmp(rt.response, "HTTP/1.", 7) != 0) {
+    return closed ? 0 : -1;
+  }
+  const char* lengthHeader = strstr(rt.response, "Content-Length:");
+  size_t bodyLength = lengthHeader != nullptr ? strtoul(lengthHeader + 15, nullptr, 10) : 0;
+  bool complete = (size_t)(rt.response + rt.responseLength - (headerEnd + 4)) >= bodyLength;
+  if (!complete && !closed && rt.responseLength < sizeof(rt.response) - 1) {
+    return -1;
+  }
+  return atoi(rt.response + 9);
+}
+
+void httpPoll(int index, short revents, uint64_t now) {
+  DeviceRuntime& rt = runtimes[index];
+  if (rt.state == HTTP_CONNECTING) {
+    int error = 0;
+    socklen_t length = sizeof(error);
+    getsockopt(rt.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+    if (error != 0) {
+      httpFinish(rt, 0, now);
+      return;
+    }
+    rt.state = HTTP_SENDING;
+  }
+  if (rt.state == HTTP_SENDING && (revents & POLLOUT)) {
+    ssize_t n = send(rt.fd, rt.request + rt.requestSent, rt.requestLength - rt.requestSent, 0);
+    if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+      httpFinish(rt, 0, now);
+      return;
+    }
+    rt.requestSent += n > 0 ? n : 0;
+    if (rt.requestSent == rt.requestLength) {
+      if (rt.abandon) {
+        // อุปกรณ์หลุดกลาง upload → Center ต้องคืน BodyArena slot เอง / reboot = session ใหม่
+        stats.abandoned++;
+        devices[index].session++;
+        httpClose(rt);
+        return;
+      }
+      rt.state = HTTP_RECEIVING;
+    }
+    return;
+  }
+  if (rt.state == HTTP_RECEIVING && (revents & (POLLIN | POLLHUP | POLLERR))) {
+    ssize_t n = recv(rt.fd, rt.response + rt.responseLength, sizeof(rt.response) - 1 - rt.responseLength, 0);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      return;
+    }
+    rt.responseLength += n > 0 ? n : 0;
+    int code = httpParse(rt, n <= 0);
+    if (code >= 0) {
+      httpFinish(rt, code, now);
+    }
+  }
+}
+
+// ===== UDP (heartbeat + Binary) =====
+void udpSend(const uint8_t* frame, size_t length) {
+  sendto(udpFd, frame, length, 0, (const sockaddr*)&centerUdp, sizeof(centerUdp));
+}
+
+void registerSession(int index) {
+  LoadDevice& d = devices[index];
+  while (sessionToDevice.count(d.session) != 0 && sessionToDevice[d.session] != index) {
+    d.session++;
+  }
+  sessionToDevice[d.session] = index;
+}
+
+void sendHeartbeat(int index) {
+  uint8_t frame[WIRE_HEADER_SIZE + WIRE_HEARTBEAT_SIZE + WIRE_CRC_SIZE];
+  registerSession(index);
+  udpSend(frame, Wire_encodeHeartbeat(frame, devices[index].session, devices[index].mac));
+  stats.heartbeats++;
+}
+
+void udpPoll(uint64_t now) {
+  uint8_t frame[WIRE_MAX_FRAME];
+  ssize_t length;
+  while ((length = recv(udpFd, frame, sizeof(frame), 0)) > 0) {
+    WireHeader header;
+    if (Wire_parseFrame(frame, length, header) < 0 || header.type != WIRE_MSG_ACK) {
+      continue;
+    }
+    std::map<uint16_t, int>::iterator found = sessionToDevice.find(header.session);
+    if (found == sessionToDevice.end() || devices[found->second].session != header.session) {
+      continue;   // session เก่าก่อน churn
+    }
+    DeviceRuntime& rt = runtimes[found->second];
+    if (header.status == WIRE_ACK_UNKNOWN_DEVICE) {
+      rt.needStatus = true;
+      continue;
+    }
+    if (header.seq == 0) {
+      rt.helloAcked = header.status == WIRE_ACK_OK;
+      continue;
+    }
+    if (header.seq != rt.pendingSeq) {
+      continue;   // ACK ที่มาหลังหมดเวลาแล้ว
+    }
+    if (header.status == WIRE_ACK_OK) {
+      stats.ok++;
+      stats.latencyUs.push_back((uint32_t)(now - rt.pendingSentUs));
+    } else {
+      stats.errors++;
+      rt.helloAcked = header.status != WIRE_ACK_UNKNOWN_SESSION;
+    }
+    rt.pendingSeq = 0;
+  }
+}
+
+// ===== เริ่มงานถัดไปของอุปกรณ์ (ถ้าว่าง) =====
+void startWork(int index, uint64_t now) {
+  LoadDevice& d = devices[index];
+  DeviceRuntime& rt = runtimes[index];
+  uint32_t timestampMs = (uint32_t)(now / 1000);
+  char body[LOAD_PAYLOAD_SIZE];
+
+  if (rt.state != HTTP_IDLE) {
+    return;
+  }
+  if (rt.needStatus) {
+    rt.isStatus = true;
+    httpStart(rt, "/api/status", body, Load_formatStatus(d, timestampMs, body, sizeof(body)), now);
+    stats.statusPosts++;
+    return;
+  }
+  if (rt.backlog == 0) {
+    return;
+  }
+
+  WireReading reading;
+  Load_makeReading(Load_pickKind(options, loadRandom), loadRandom, timestampMs, reading);
+
+  if (!wireTransport) {
+    rt.backlog--;
+    rt.isStatus = false;
+    httpStart(rt, "/api/vitals", body, Load_formatVitals(d, reading, ++d.seq, body, sizeof(body)), now);
+    if (!rt.abandon) {
+      stats.sent++;
+    }
+    return;
+  }
+
+  uint8_t frame[WIRE_MAX_FRAME];
+  registerSession(index);
+  if (!rt.helloAcked) {
+    if (rt.helloSentUs == 0 || now - rt.helloSentUs > options.timeoutMs * 1000ULL) {
+      WireHello hello;
+      memcpy(hello.mac, d.mac, 6);
+      snprintf(hello.name, sizeof(hello.name), "%s", d.name);
+      hello.epoch = d.epoch;
+      udpSend(frame, Wire_encodeHello(frame, d.session, hello));
+      rt.helloSentUs = now;
+    }
+    return;
+  }
+  if (rt.pendingSeq != 0) {
+    return;
+  }
+  uint8_t packed[WIRE_READING_SIZE];
+  Wire_packReading(packed, reading);
+  rt.backlog--;
+  udpSend(frame, Wire_encodeReading(frame, d.session, ++d.seq, packed, WIRE_READING_DURABLE_SEQ));
+  if (LoadRandom_unit(loadRandom) < options.churn) {
+    // reboot ก่อนได้ ACK → session ใหม่ ต้อง HELLO ใหม่
+    stats.abandoned++;
+    d.session++;
+    rt.helloAcked = false;
+    rt.helloSentUs = 0;
+    return;
+  }
+  stats.sent++;
+  rt.pendingSeq = d.seq;
+  rt.pendingSentUs = now;
+}
+
+bool isBusy(const DeviceRuntime& rt) {
+  return rt.state != HTTP_IDLE || rt.pendingSeq != 0;
+}
+
+// ===== 1 ขั้น: อุปกรณ์ count ตัว นาน durationMs =====
+void runStep(uint32_t count) {
+  uint64_t now = nowUs();
+  LoadStats_reset(stats, count, now);
+  uint64_t stepEnd = now + durationMs * 1000ULL;
+  uint64_t nextBurst = now + options.burstEveryMs * 1000ULL;
+
+  // เริ่มแต่ละอุปกรณ์คนละเวลา (ไม่ยิงพร้อมกันทั้งหมดตอนเริ่ม)
+  for (uint32_t i = 0; i < count; i++) {
+    devices[i].nextReadingUs = now + LoadRandom_below(loadRandom, options.intervalMs) * 1000ULL;
+    devices[i].nextHeartbeatUs = now + LoadRandom_below(loadRandom, options.heartbeatMs + 1) * 1000ULL;
+    runtimes[i].backlog = 0;
+  }
+
+  std::vector<pollfd> fds;
+  std::vector<int> owners;
+  bool sending = true;
+  while (true) {
+    now = nowUs();
+    if (sending && now >= stepEnd) {
+      sending = false;
+      stats.endUs = stepEnd;
+    }
+
+    if (sending) {
+      if (options.burstSize > 0 && options.burstEveryMs > 0 && now >= nextBurst) {
+        for (uint32_t b = 0; b < options.burstSize && b < count; b++) {
+          devices[LoadRandom_below(loadRandom, count)].nextReadingUs = now;
+        }
+        nextBurst += options.burstEveryMs * 1000ULL;
+      }
+      for (uint32_t i = 0; i < count; i++) {
+        if (now >= devices[i].nextReadingUs) {
+          devices[i].nextReadingUs = now + Load_nextDelayUs(options, loadRandom);
+          if (isBusy(runtimes[i]) || runtimes[i].backlog > 0) {
+            stats.deferred++;
+          }
+          runtimes[i].backlog++;
+        }
+        if (options.heartbeatMs > 0 && now >= devices[i].nextHeartbeatUs) {
+          devices[i].nextHeartbeatUs += options.heartbeatMs * 1000ULL;
+          sendHeartbeat(i);
+        }
+        startWork(i, now);
+      }
+    }
+
+    // หมดเวลา
+    bool inFlight = false;
+    for (uint32_t i = 0; i < count; i++) {
+      DeviceRuntime& rt = runtimes[i];
+      if (rt.state != HTTP_IDLE && now - rt.startUs > options.timeoutMs * 1000ULL) {
+        if (!rt.isStatus) {
+          stats.timeouts++;
+        }
+        httpClose(rt);
+      }
+      if (rt.pendingSeq != 0 && now - rt.pendingSentUs > options.timeoutMs * 1000ULL) {
+        stats.timeouts++;
+        rt.pendingSeq = 0;
+      }
+      inFlight |= isBusy(rt);
+    }
+    if (!sending && !inFlight) {
+      break;
+    }
+
+    fds.clear();
+    owners.clear();
+    for (uint32_t i = 0; i < count; i++) {
+      const DeviceRuntime& rt = runtimes[i];
+      if (rt.state != HTTP_IDLE) {
+        pollfd p = { rt.fd, (short)(rt.state == HTTP_RECEIVING ? POLLIN : POLLOUT), 0 };
+        fds.push_back(p);
+        owners.push_back(i);
+      }
+    }
+    pollfd udp = { udpFd, POLLIN, 0 };
+    fds.push_back(udp);
+    owners.push_back(-1);
+    if (standinEnabled) {
+      standinPollFds(fds, owners);
+    }
+    poll(fds.data(), fds.size(), 1);
+
+    now = nowUs();
+    if (standinEnabled) {
+      standinPoll(now);
+    }
+    for (size_t i = 0; i < fds.size(); i++) {
+      if (fds[i].revents == 0) {
+        continue;
+      }
+      if (owners[i] == -2) {
+        continue;
+      }
+      if (owners[i] < 0) {
+        udpPoll(now);
+      } else {
+        httpPoll(owners[i], fds[i].revents, now);
+      }
+    }
+  }
+  for (uint32_t i = 0; i < count; i++) {
+    runtimes[i].backlog = 0;
+  }
+}
+
+// ===== ตาราง (stderr) =====
+void printRow(LoadStats& s) {
+  double seconds = LoadStats_seconds(s);
+  fprintf(stderr, "%7lu %9.2f %9.2f %6lu %6lu %8lu %8lu %9.1f %9.1f %9.1f%s\n",
+          (unsigned long)s.devices, seconds > 0 ? s.sent / seconds : 0.0, seconds > 0 ? s.ok / seconds : 0.0,
+          (unsigned long)s.busy, (unsigned long)s.errors, (unsigned long)s.timeouts,
+          (unsigned long)s.abandoned,
+          LoadStats_percentile(s.latencyUs, 50) / 1000.0, LoadStats_percentile(s.latencyUs, 99) / 1000.0,
+          (s.latencyUs.empty() ? 0 : s.latencyUs.back()) / 1000.0,
+          LoadStats_saturated(s, options) ? "  ← อิ่มตัว" : "");
+}
+
+// ===== Command line =====
+void usage() {
+  fprintf(stderr,
+          "ใช้: loadgen [options]\n"
+          "  --center IP          Center (ค่าเริ่มต้น 10.1.10.1)\n"
+          "  --port N             HTTP port (80) / --udp-port N (%d)\n"
+          "  --standin            ยิง Center จำลองใน process นี้แทนบอร์ดจริง\n"
+          "  --service-us N       stand-in: เวลา loop() ต่อ reading (2000)\n"
+          "  --transport http|wire\n"
+          "  --devices N          จำนวนอุปกรณ์ (ขั้นเดียว) / --sweep 1,2,4,8 (หลายขั้น)\n"
+          "  --duration S         วินาทีต่อขั้น (30) / --pause MS ระหว่างขั้น (2000)\n"
+          "  --interval MS        reading ต่ออุปกรณ์ (20000) / --jitter F (0.2)\n"
+          "  --burst N --burst-every MS   N อุปกรณ์ส่งพร้อมกันทุก MS\n"
+          "  --churn F            โอกาสตัดการเชื่อมต่อกลาง request (0)\n"
+          "  --heartbeat MS       UDP heartbeat (3000, 0 = ไม่ส่ง)\n"
+          "  --timeout MS         (http 5000 / wire 500)\n"
+          "  --mix BP,WH,TEMP     สัดส่วนชนิด reading (1,1,1)\n"
+          "  --seed N\n",
+          WIRE_UDP_PORT);
+}
+
+bool parseList(const char* text, uint32_t* out, size_t capacity, size_t& count) {
+  count = 0;
+  while (*text != '\0' && count < capacity) {
+    char* end;
+    out[count++] = strtoul(text, &end, 10);
+    if (end == text) {
+      return false;
+    }
+    text = *end == ',' ? end + 1 : end;
+  }
+  return *text == '\0';
+}
+
+bool parseArgs(int argc, char** argv) {
+  const char* center = "10.1.10.1";
+  int port = 80;
+  int udpPort = WIRE_UDP_PORT;
+  uint32_t devicesArg = 8;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+    bool flag = strcmp(arg, "--standin") == 0;
+    if (!flag && value == nullptr) {
+      return false;
+    }
+    if (flag) {
+      standinEnabled = true;
+      continue;
+    }
+    i++;
+    if (strcmp(arg, "--center") == 0) center = value;
+    else if (strcmp(arg, "--port") == 0) port = atoi(value);
+    else if (strcmp(arg, "--udp-port") == 0) udpPort = atoi(value);
+    else if (strcmp(arg, "--service-us") == 0) standinServiceUs = strtoul(value, nullptr, 10);
+    else if (strcmp(arg, "--transport") == 0) wireTransport = strcmp(value, "wire") == 0;
+    else if (strcmp(arg, "--devices") == 0) devicesArg = strtoul(value, nullptr, 10);
+    else if (strcmp(arg, "--duration") == 0) durationMs = strtoul(value, nullptr, 10) * 1000;
+    else if (strcmp(arg, "--pause") == 0) pauseMs = strtoul(value, nullptr, 10);
+    else if (strcmp(arg, "--interval") == 0) options.intervalMs = strtoul(value, nullptr, 10);
+    else if (strcmp(arg, "--jitter") == 0) options.jitter = atof(value);
+    else if (strcmp(arg, "--burst") == 0) options.burstSize = strtoul(value, nullptr, 10);
+    else if (strcmp(arg, "--burst-every") == 0) options.burstEveryMs = strtoul(value, nullptr, 10);
+    else if (strcmp(arg, "--churn") == 0) options.churn = atof(value);
+    else if (strcmp(arg, "--heartbeat") == 0) options.heartbeatMs = strtoul(value, nullptr, 10);
+    else if (strcmp(arg, "--timeout") == 0) options.timeoutMs = strtoul(value, nullptr, 10);
+    else if (strcmp(arg, "--seed") == 0) options.seed = strtoul(value, nullptr, 10);
+    else if (strcmp(arg, "--mix") == 0) {
+      size_t count;
+      if (!parseList(value, options.mix, 3, count) || count != 3) {
+        return false;
+      }
+    } else if (strcmp(arg, "--sweep") == 0) {
+      uint32_t steps[64];
+      size_t count;
+      if (!parseList(value, steps, 64, count)) {
+        return false;
+      }
+      sweep.assign(steps, steps + count);
+    } else {
+      return false;
+    }
+  }
+
+  if (sweep.empty()) {
+    sweep.push_back(devicesArg);
+  }
+  for (size_t i = 0; i < sweep.size(); i++) {
+    if (sweep[i] == 0 || sweep[i] > LOAD_MAX_DEVICES) {
+      fprintf(stderr, "จำนวนอุปกรณ์ต้องอยู่ระหว่าง 1-%d\n", LOAD_MAX_DEVICES);
+      return false;
+    }
+  }
+  if (options.timeoutMs == 0) {
+    options.timeoutMs = wireTransport ? 500 : 5000;   // WIRE_ACK_TIMEOUT / HTTPClient
+  }
+  if (options.intervalMs == 0) {
+    return false;
+  }
+
+  memset(&centerHttp, 0, sizeof(centerHttp));
+  centerHttp.sin_family = AF_INET;
+  centerHttp.sin_port = htons(port);
+  centerUdp = centerHttp;
+  centerUdp.sin_port = htons(udpPort);
+  if (inet_pton(AF_INET, center, &centerHttp.sin_addr) != 1) {
+    fprintf(stderr, "IP ของ Center ไม่ถูกต้อง: %s\n", center);
+    return false;
+  }
+  centerUdp.sin_addr = centerHttp.sin_addr;
+  return true;
+}
+
+int main(int argc, char** argv) {
+  signal(SIGPIPE, SIG_IGN);
+  startedUs = 0;
+  startedUs = nowUs();
+
+  if (!parseArgs(argc, argv)) {
+    usage();
+    return 2;
+  }
+  if (standinEnabled && !standinBegin()) {
+    perror("stand-in");
+    return 1;
+  }
+
+  udpFd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (udpFd < 0 || !setNonBlocking(udpFd)) {
+    perror("udp");
+    return 1;
+  }
+  loadRandom.seed = options.seed;
+  uint32_t epoch = (uint32_t)time(nullptr) | 1;   // seq เริ่มที่ 1 ทุกครั้งที่รัน → epoch ใหม่
+  for (int i = 0; i < LOAD_MAX_DEVICES; i++) {
+    Load_initDevice(devices[i], i, loadRandom, epoch);
+    memset(&runtimes[i], 0, sizeof(runtimes[i]));
+    runtimes[i].fd = -1;
+  }
+
+  const char* transport = wireTransport ? "wire" : "http";
+  fprintf(stderr, "Center %s:%d (%s%s) | interval %lu ms ±%.0f%% | %lu s ต่อขั้น\n",
+          inet_ntoa(centerHttp.sin_addr), ntohs(centerHttp.sin_port), transport,
+          standinEnabled ? ", stand-in" : "", (unsigned long)options.intervalMs, options.jitter * 100,
+          (unsigned long)(durationMs / 1000));
+  fprintf(stderr, "devices  offered/s     ok/s   busy  error  timeout  churned   p50 ms    p99 ms    max ms\n");
+
+  double peakThroughput = 0;
+  uint32_t peakDevices = 0;
+  long saturatedAt = -1;
+  char line[1024];
+  for (size_t step = 0; step < sweep.size(); step++) {
+    if (step > 0 && pauseMs > 0) {
+      usleep(pauseMs * 1000);   // ให้ Center ประมวลผลคิวที่ค้างก่อนขั้นถัดไป
+    }
+    runStep(sweep[step]);
+    LoadStats_format(stats, options, transport, line, sizeof(line));
+    printf("%s\n", line);
+    fflush(stdout);
+    printRow(stats);
+
+    double seconds = LoadStats_seconds(stats);
+    double throughput = seconds > 0 ? stats.ok / seconds : 0;
+    if (throughput > peakThroughput) {
+      peakThroughput = throughput;
+      peakDevices = stats.devices;
+    }
+    if (saturatedAt < 0 && LoadStats_saturated(stats, options)) {
+      saturatedAt = stats.devices;
+    }
+  }
+
+  char saturated[16] = "null";
+  if (saturatedAt >= 0) {
+    snprintf(saturated, sizeof(saturated), "%ld", saturatedAt);
+  }
+  printf("{\"step\":\"summary\",\"transport\":\"%s\",\"standin\":%s,\"serviceUs\":%lu,\"steps\":%u,"
+         "\"peakThroughputPerS\":%.2f,\"peakDevices\":%lu,\"saturatedAtDevices\":%s,\"seed\":%lu}\n",
+         transport, standinEnabled ? "true" : "false",
+         (unsigned long)(standinEnabled ? standinServiceUs : 0), (unsigned)sweep.size(),
+         peakThroughput, (unsigned long)peakDevices, saturated, (unsigned long)options.seed);
+  if (standinEnabled) {
+    fprintf(stderr, "stand-in: reading ซ้ำ %lu\n", (unsigned long)standinDuplicates);
+  }
+  return 0;
+}
@@ -0,0 +1,243 @@
+/**
+ * LoadProfile.h
+ * อุปกรณ์จำลอง N ตัวของ LoadGenerator.cpp - ตารางเวลา / payload / สรุปผล (ไม่มี socket)
+ *
+ * - อุปกรณ์แต่ละตัวมี MAC (locally administered 02:4C:47:..) และ seq ของตัวเอง
+ *   seq นับต่อเนื่องตลอดการทดสอบ (เหมือน Journal ของ ESP32_RS232) → Center กรองซ้ำได้ถูกต้อง
+ * - payload แบบเดียวกับ sendReading() ของ ESP32_RS232: blood_pressure / weight_height / temp
+ *   ค่า weight/height = ค่านิ่งของ SettlingCurve.h (Simulator_WeightScale) / Binary = WireReading เดียวกัน
+ * - เวลาส่ง: interval ± jitter, burst (หลายเครื่องส่งพร้อมกัน), churn (ตัดการเชื่อมต่อกลาง request)
+ * - latency เก็บทุกค่าแล้วเรียง → p50/p99/max แม่นยำ (Histogram.h ละเอียดแค่ 2 เท่าต่อ bucket)
+ *
+ * ใช้บน PC เท่านั้น (std::vector) - เวลาเป็น us รับจากผู้เรียก
+ */
+
+#ifndef LOAD_PROFILE_H
+#define LOAD_PROFILE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <vector>
+#include "../device/WireProtocol.h"
+#include "../Simulator_WeightScale/Simulator_WeightScale_ESP8266/SettlingCurve.h"
+
+// ===== Configuration =====
+#define LOAD_MAX_DEVICES 1024
+#define LOAD_PAYLOAD_SIZE 384      // = StaticJsonDocument<384> ของ ESP32_RS232
+#define LOAD_FAILURE_LIMIT 0.01    // ไม่สำเร็จเกิน 1% = Center อิ่มตัว
+
+struct LoadOptions {
+  uint32_t intervalMs;     // reading ต่ออุปกรณ์ (device.ino = 20000)
+  double jitter;           // ± สัดส่วนของ interval (0.2 = ±20%)
+  uint32_t burstSize;      // อุปกรณ์ที่ส่งพร้อมกันในแต่ละ burst (0 = ไม่มี)
+  uint32_t burstEveryMs;
+  double churn;            // โอกาสที่ request ถูกตัดกลางทาง (อุปกรณ์หลุด WiFi / reboot)
+  uint32_t heartbeatMs;    // UDP heartbeat (ESP32_RS232 = 3000, 0 = ไม่ส่ง)
+  uint32_t timeoutMs;      // HTTPClient.setTimeout(5000)
+  uint32_t mix[3];         // น้ำหนักการสุ่ม blood_pressure : weight_height : temp
+  uint32_t seed;
+};
+
+// ===== LCG (seed เดียวกัน = ลำดับเหตุการณ์เดียวกัน) =====
+struct LoadRandom {
+  uint32_t seed;
+};
+
+inline uint32_t LoadRandom_next(LoadRandom& r) {
+  r.seed = r.seed * 1664525UL + 1013904223UL;
+  return r.seed >> 8;
+}
+
+inline uint32_t LoadRandom_below(LoadRandom& r, uint32_t limit) {
+  return limit == 0 ? 0 : LoadRandom_next(r) % limit;
+}
+
+// 0.0 - 1.0
+inline double LoadRandom_unit(LoadRandom& r) {
+  return (double)LoadRandom_next(r) / (double)0xFFFFFF;
+}
+
+// ===== อุปกรณ์จำลอง 1 ตัว =====
+struct LoadDevice {
+  uint8_t mac[6];
+  char macText[18];
+  char name[WIRE_NAME_SIZE];
+  uint16_t session;        // session ของ Binary/heartbeat (เปลี่ยนเมื่อ churn = reboot)
+  uint32_t seq;            // seq ล่าสุดที่ใช้ (0 = ยังไม่ส่ง)
+  uint32_t epoch;          // epoch ของ seq (เปลี่ยนทุกครั้งที่รัน เหมือน journal ที่สร้างใหม่)
+  uint64_t nextReadingUs;
+  uint64_t nextHeartbeatUs;
+};
+
+inline void Load_formatMac(const uint8_t* mac, char* out, size_t size) {
+  snprintf(out, size, "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+}
+
+inline void Load_initDevice(LoadDevice& d, int index, LoadRandom& r, uint32_t epoch) {
+  const uint8_t mac[6] = { 0x02, 0x4C, 0x47, (uint8_t)(index >> 16), (uint8_t)(index >> 8), (uint8_t)index };
+  memcpy(d.mac, mac, 6);
+  Load_formatMac(mac, d.macText, sizeof(d.macText));
+  snprintf(d.name, sizeof(d.name), "LoadGen_%03d", index + 1);
+  d.session = (uint16_t)(1 + LoadRandom_below(r, 65535));
+  d.seq = 0;
+  d.epoch = epoch;
+  d.nextReadingUs = 0;
+  d.nextHeartbeatUs = 0;
+}
+
+// ===== เวลาถึง reading ถัดไป: interval ± jitter =====
+inline uint64_t Load_nextDelayUs(const LoadOptions& o, LoadRandom& r) {
+  double factor = 1.0 + o.jitter * (2.0 * LoadRandom_unit(r) - 1.0);
+  if (factor < 0.05) {
+    factor = 0.05;
+  }
+  return (uint64_t)(o.intervalMs * 1000.0 * factor);
+}
+
+// ===== สุ่มชนิด reading ตามสัดส่วน mix =====
+inline uint8_t Load_pickKind(const LoadOptions& o, LoadRandom& r) {
+  uint32_t total = o.mix[0] + o.mix[1] + o.mix[2];
+  uint32_t pick = LoadRandom_below(r, total == 0 ? 1 : total);
+  if (pick < o.mix[0] || total == 0) {
+    return WIRE_KIND_BLOOD_PRESSURE;
+  }
+  return pick < o.mix[0] + o.mix[1] ? WIRE_KIND_WEIGHT_HEIGHT : WIRE_KIND_TEMP;
+}
+
+// ===== ค่าที่วัดได้ (หน่วยเดียวกับ WireProtocol: BP = mmHg, อื่นๆ x10) =====
+inline void Load_makeReading(uint8_t kind, LoadRandom& r, uint32_t timestampMs, WireReading& reading) {
+  memset(&reading, 0, sizeof(reading));
+  reading.kind = kind;
+  reading.timestamp = timestampMs;
+
+  if (kind == WIRE_KIND_BLOOD_PRESSURE) {
+    reading.values[0] = (int16_t)(100 + LoadRandom_below(r, 60));
+    reading.values[1] = (int16_t)(60 + LoadRandom_below(r, 35));
+    reading.values[2] = (int16_t)(55 + LoadRandom_below(r, 50));
+    reading.fields = WIRE_FIELD_VALUE0 | WIRE_FIELD_VALUE1 | WIRE_FIELD_VALUE2 | WIRE_FIELD_IDCARD;
+    reading.idcard = 1000000000000ULL + (uint64_t)LoadRandom_next(r) * 100000ULL + LoadRandom_below(r, 100000);
+  } else if (kind == WIRE_KIND_WEIGHT_HEIGHT) {
+    // ค่าที่ StabilityDetector ส่งเมื่อคนไข้ยืนนิ่ง (ค่าจริง ± noise ช่วงนิ่ง)
+    SettlingCurve curve;
+    SettlingCurve_begin(curve, (int16_t)(400 + LoadRandom_below(r, 600)),
+                        (int16_t)(1450 + LoadRandom_below(r, 450)), LoadRandom_next(r));
+    SettlingCurve_sample(curve, curve.settleMs, reading.values[0], reading.values[1]);
+    reading.fields = WIRE_FIELD_VALUE0 | WIRE_FIELD_VALUE1;
+  } else {
+    reading.values[0] = (int16_t)(358 + LoadRandom_below(r, 20));
+    reading.fields = WIRE_FIELD_VALUE0;
+  }
+}
+
+// ===== JSON แบบเดียวกับ sendReading() ของ ESP32_RS232 (POST /api/vitals) =====
+inline size_t Load_formatVitals(const LoadDevice& d, const WireReading& reading, uint32_t seq,
+                                char* out, size_t size) {
+  char idcard[24] = "";
+  if (reading.fields & WIRE_FIELD_IDCARD) {
+    Wire_idcardToString(reading.idcard, idcard, sizeof(idcard));
+  }
+  const char* type = reading.kind == WIRE_KIND_BLOOD_PRESSURE ? "blood_pressure" :
+                     reading.kind == WIRE_KIND_WEIGHT_HEIGHT ? "weight_height" : "temp";
+  int length = snprintf(out, size,
+                        "{\"deviceId\":\"%s\",\"deviceName\":\"%s\",\"macAddress\":\"%s\","
+                        "\"deviceType\":\"%s\",\"seq\":%lu,\"epoch\":%lu,\"idcard\":\"%s\",\"data\":{",
+                        d.macText, d.name, d.macText, type, (unsigned long)seq, (unsigned long)d.epoch, idcard);
+  if (reading.kind == WIRE_KIND_BLOOD_PRESSURE) {
+    length += snprintf(out + length, size - length, "\"bp\":%d,\"bp2\":%d,\"pulse\":%d",
+                       reading.values[0], reading.values[1], reading.values[2]);
+  } else if (reading.kind == WIRE_KIND_WEIGHT_HEIGHT) {
+    length += snprintf(out + length, size - length, "\"weight\":%.1f,\"height\":%.1f",
+                       reading.values[0] / 10.0, reading.values[1] / 10.0);
+  } else {
+    length += snprintf(out + length, size - length, "\"value\":%.1f", reading.values[0] / 10.0);
+  }
+  length += snprintf(out + length, size - length, ",\"timestamp\":%lu}}", (unsigned long)reading.timestamp);
+  return length < (int)size ? (size_t)length : 0;
+}
+
+// ===== JSON ของ /api/status (ลงทะเบียนเมื่อ Center ตอบ heartbeat ว่า UNKNOWN_DEVICE) =====
+inline size_t Load_formatStatus(const LoadDevice& d, uint32_t timestampMs, char* out, size_t size) {
+  int length = snprintf(out, size,
+                        "{\"type\":\"device_status\",\"deviceId\":\"%s\",\"deviceName\":\"%s\","
+                        "\"macAddress\":\"%s\",\"timestamp\":%lu,\"epoch\":%lu}",
+                        d.macText, d.name, d.macText, (unsigned long)timestampMs, (unsigned long)d.epoch);
+  return length < (int)size ? (size_t)length : 0;
+}
+
+// ===== ผลของ 1 ขั้น (จำนวนอุปกรณ์ 1 ค่า) =====
+struct LoadStats {
+  uint32_t devices;
+  uint64_t startUs;
+  uint64_t endUs;            // หมดเวลาส่ง (ไม่รวมช่วงรอ request ที่ค้าง)
+  uint32_t sent;             // reading ที่ส่ง (ไม่รวมที่ churn ตัดกลางทาง)
+  uint32_t ok;               // HTTP 200 / ACK OK
+  uint32_t busy;             // HTTP 503 (Inbox / BodyArena เต็ม)
+  uint32_t errors;           // HTTP อื่น / ต่อไม่ได้ / ถูกตัด / ACK REJECTED
+  uint32_t timeouts;
+  uint32_t abandoned;        // churn: ตัดการเชื่อมต่อเองกลาง request
+  uint32_t deferred;         // ถึงเวลาส่งแต่ request ก่อนหน้ายังไม่จบ → รอในคิวของอุปกรณ์
+  uint32_t heartbeats;
+  uint32_t statusPosts;      // /api/status หลัง Center ตอบ UNKNOWN_DEVICE
+  std::vector<uint32_t> latencyUs;
+};
+
+inline void LoadStats_reset(LoadStats& s, uint32_t devices, uint64_t now) {
+  s.devices = devices;
+  s.startUs = now;
+  s.endUs = now;
+  s.sent = s.ok = s.busy = s.errors = s.timeouts = 0;
+  s.abandoned = s.deferred = s.heartbeats = s.statusPosts = 0;
+  s.latencyUs.clear();
+}
+
+// nearest-rank (latencyUs ต้องเรียงแล้ว)
+inline uint32_t LoadStats_percentile(const std::vector<uint32_t>& sorted, int percent) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  size_t rank = (sorted.size() * percent + 99) / 100;
+  return sorted[rank == 0 ? 0 : rank - 1];
+}
+
+inline double LoadStats_seconds(const LoadStats& s) {
+  return s.endUs > s.startUs ? (s.endUs - s.startUs) / 1e6 : 0.0;
+}
+
+inline double LoadStats_failureRate(const LoadStats& s) {
+  return s.sent == 0 ? 0.0 : (double)(s.sent - s.ok) / s.sent;
+}
+
+// อิ่มตัว = ไม่สำเร็จเกิน LOAD_FAILURE_LIMIT หรือ p99 เกินครึ่งหนึ่งของ timeout (อุปกรณ์เริ่มส่งซ้ำ)
+inline bool LoadStats_saturated(LoadStats& s, const LoadOptions& o) {
+  std::sort(s.latencyUs.begin(), s.latencyUs.end());
+  return LoadStats_failureRate(s) > LOAD_FAILURE_LIMIT ||
+         LoadStats_percentile(s.latencyUs, 99) > o.timeoutMs * 500UL;
+}
+
+// ===== 1 บรรทัด JSON ต่อขั้น (JSON Lines - เก็บเทียบระหว่าง release) =====
+inline int LoadStats_format(LoadStats& s, const LoadOptions& o, const char* transport, char* out, size_t size) {
+  bool saturated = LoadStats_saturated(s, o);
+  double seconds = LoadStats_seconds(s);
+  return snprintf(out, size,
+                  "{\"step\":\"load\",\"transport\":\"%s\",\"devices\":%lu,\"seconds\":%.1f,"
+                  "\"intervalMs\":%lu,\"offeredPerS\":%.2f,\"throughputPerS\":%.2f,"
+                  "\"sent\":%lu,\"ok\":%lu,\"busy\":%lu,\"errors\":%lu,\"timeouts\":%lu,"
+                  "\"abandoned\":%lu,\"deferred\":%lu,\"heartbeats\":%lu,\"statusPosts\":%lu,"
+                  "\"errorRate\":%.4f,\"timeoutRate\":%.4f,"
+                  "\"latencyUs\":{\"p50\":%lu,\"p99\":%lu,\"max\":%lu},\"saturated\":%s}",
+                  transport, (unsigned long)s.devices, seconds, (unsigned long)o.intervalMs,
+                  seconds > 0 ? s.sent / seconds : 0.0, seconds > 0 ? s.ok / seconds : 0.0,
+                  (unsigned long)s.sent, (unsigned long)s.ok, (unsigned long)s.busy,
+                  (unsigned long)s.errors, (unsigned long)s.timeouts, (unsigned long)s.abandoned,
+                  (unsigned long)s.deferred, (unsigned long)s.heartbeats, (unsigned long)s.statusPosts,
+                  s.sent == 0 ? 0.0 : (double)(s.busy + s.errors) / s.sent,
+                  s.sent == 0 ? 0.0 : (double)s.timeouts / s.sent,
+                  (unsigned long)LoadStats_percentile(s.latencyUs, 50),
+                  (unsigned long)LoadStats_percentile(s.latencyUs, 99),
+                  (unsigned long)(s.latencyUs.empty() ? 0 : s.latencyUs.back()),
+                  saturated ? "true" : "false");
+}
+
+#endif
@@ -0,0 +1,83 @@
+/**
+ * SettlingCurve.h
+ * จำลองค่าที่เครื่องชั่งส่งต่อเนื่องระหว่างคนไข้ 1 คนยืนบนเครื่อง (Streaming Mode)
+ *
+ *   ก้าวขึ้น → แกว่ง (overshoot + สั่นแล้วค่อยๆ นิ่ง) → ยืนนิ่ง (noise ±0.1) → ก้าวลง (W = 0)
+ *
+ * ค่าทั้งหมดหน่วย 0.1 (เหมือน WeightParser.h) - noise ใช้ LCG ของตัวเอง
+ * (seed เดียวกัน = เส้นเดียวกันทุกครั้ง) → compile บน PC ได้ ใช้ป้อนทดสอบ StabilityDetector.h
+ */
+
+#ifndef SETTLING_CURVE_H
+#define SETTLING_CURVE_H
+
+#include <stdint.h>
+#include <math.h>
+
+// ===== Configuration =====
+#define SETTLE_MIN_MS 1500       // ช่วงแกว่งหลังก้าวขึ้น
+#define SETTLE_MAX_MS 3500
+#define HOLD_MIN_MS 3000         // ยืนนิ่งก่อนก้าวลง
+#define HOLD_MAX_MS 6000
+#define SETTLE_NOISE 12          // noise ตอนเพิ่งก้าวขึ้น (0.1) - ลดลงจนเหลือ ±1 ตอนนิ่ง
+
+struct SettlingCurve {
+  int16_t weightTenths;    // ค่าจริงของคนไข้
+  int16_t heightTenths;
+  uint32_t settleMs;
+  uint32_t holdMs;
+  int16_t overshootTenths;
+  uint32_t seed;
+};
+
+// LCG (Numerical Recipes) - ไม่ใช้ random() ของ Arduino
+inline uint32_t SettlingCurve_next(SettlingCurve& c) {
+  c.seed = c.seed * 1664525UL + 1013904223UL;
+  return c.seed >> 8;
+}
+
+// -amplitude..+amplitude
+inline int16_t SettlingCurve_noise(SettlingCurve& c, int16_t amplitude) {
+  if (amplitude <= 0) {
+    return 0;
+  }
+  return (int16_t)(SettlingCurve_next(c) % (uint32_t)(2 * amplitude + 1)) - amplitude;
+}
+
+inline void SettlingCurve_begin(SettlingCurve& c, int16_t weightTenths, int16_t heightTenths, uint32_t seed) {
+  c.weightTenths = weightTenths;
+  c.heightTenths = heightTenths;
+  c.seed = seed;
+  c.settleMs = SETTLE_MIN_MS + SettlingCurve_next(c) % (SETTLE_MAX_MS - SETTLE_MIN_MS + 1);
+  c.holdMs = HOLD_MIN_MS + SettlingCurve_next(c) % (HOLD_MAX_MS - HOLD_MIN_MS + 1);
+  c.overshootTenths = (int16_t)(weightTenths * (3 + SettlingCurve_next(c) % 6) / 100);   // 3-8%
+}
+
+// ก้าวขึ้นจนก้าวลง (ms)
+inline uint32_t SettlingCurve_duration(const SettlingCurve& c) {
+  return c.settleMs + c.holdMs;
+}
+
+// ค่าที่ elapsed ms หลังก้าวขึ้น - เกิน duration = ก้าวลงแล้ว (W/H = 0)
+inline void SettlingCurve_sample(SettlingCurve& c, uint32_t elapsed, int16_t& weight, int16_t& height) {
+  if (elapsed >= SettlingCurve_duration(c)) {
+    weight = 0;
+    height = 0;
+    return;
+  }
+  if (elapsed >= c.settleMs) {
+    weight = c.weightTenths + SettlingCurve_noise(c, 1);
+    height = c.heightTenths + SettlingCurve_noise(c, 1);
+    return;
+  }
+
+  // เข้าหาค่าจริงแบบ exponential + สั่นแบบ damped ~2.5 รอบ แล้วค่อยๆ นิ่ง
+  float x = (float)elapsed / c.settleMs;
+  float approach = 1.0f - expf(-6.0f * x);
+  float swing = c.overshootTenths * expf(-4.0f * x) * sinf(2.0f * 3.14159265f * 2.5f * x);
+  int16_t noise = (int16_t)(SETTLE_NOISE * (1.0f - x)) + 1;
+  weight = (int16_t)(c.weightTenths * approach + swing) + SettlingCurve_noise(c, noise);
+  height = c.heightTenths + SettlingCurve_noise(c, noise);
+}
+
+#endif
@@ -22,9 +22,15 @@
  *   1. Auto Mode: ส่งข้อมูลอัตโนมัติทุก 5 วินาที
  *   2. Button Mode: กดปุ่ม D3 (GPIO0/FLASH) เพื่อส่งข้อมูล
  *   3. Serial Command: พิมพ์ "send" ใน Serial Monitor
+ *
+ * Streaming Mode (STREAM_MODE / คำสั่ง "stream"):
+ *   เหมือนเครื่องชั่งที่ส่งค่าตลอดเวลา - ทุก STREAM_INTERVAL ms ตั้งแต่คนไข้ก้าวขึ้น
+ *   (ค่าแกว่งแล้วค่อยๆ นิ่ง ตาม SettlingCurve.h) จนก้าวลง แล้วส่ง W:000.0 ระหว่างไม่มีคน
+ *   "send" / ปุ่ม / Auto = คนไข้คนใหม่ก้าวขึ้นเครื่อง
  */
 
 #include <SoftwareSerial.h>
+#include "SettlingCurve.h"
 
 // ===== Pin Configuration =====
 #define TX_PIN D8          // D4 (GPIO2) - ต่อกับ ESP8266 Reader RX (D7)
@@ -40,6 +46,9 @@
 #define AUTO_SEND_ENABLED true   // true = ส่งอัตโนมัติ, false = กดปุ่มเท่านั้น
 #define AUTO_SEND_INTERVAL 5000  // ส่งทุก 5 วินาที (ในโหมด Auto)
 #define SEND_TEMP false          // true = ส่งอุณหภูมิด้วย, false = ส่งแค่ W+H
+#define STREAM_MODE false        // true = ส่งต่อเนื่องระหว่างคนไข้ยืนบนเครื่อง (เริ่มต้น)
+#define STREAM_INTERVAL 200      // ms: ส่ง 1 บรรทัดทุกเท่านี้ (Streaming Mode)
+#define STREAM_IDLE_ZERO true    // true = ส่ง W:000.0 H:000.0 ระหว่างไม่มีคนบนเครื่อง
 
 // ===== Data Ranges (สำหรับสุ่มค่า) =====
 #define WEIGHT_MIN 40.0f
@@ -57,6 +66,14 @@ unsigned long lastSendTime = 0;
 unsigned long lastButtonPress = 0;
 bool lastButtonState = HIGH;
 int sendCount = 0;
+bool streamMode = STREAM_MODE;
+
+// Streaming Mode
+SettlingCurve patient;
+bool patientOn = false;
+unsigned long patientStart = 0;
+unsigned long lastStreamTime = 0;
+int streamLines = 0;
 
 // ===== Functions =====
 float randomFloat(float min, float max) {
@@ -109,6 +126,59 @@ void sendWeightData() {
   digitalWrite(LED_PIN, HIGH);  // HIGH = OFF
 }
 
+// ===== Streaming Mode =====
+void startPatient() {
+  float weight = randomFloat(WEIGHT_MIN, WEIGHT_MAX);
+  float height = randomFloat(HEIGHT_MIN, HEIGHT_MAX);
+  SettlingCurve_begin(patient, (int16_t)(weight * 10), (int16_t)(height * 10), (uint32_t)random(1, 0x7FFFFFFF));
+  patientOn = true;
+  patientStart = millis();
+  streamLines = 0;
+  sendCount++;
+  
+  Serial.println("\n========================================");
+  Serial.printf("🚶 Patient #%d ก้าวขึ้นเครื่อง\n", sendCount);
+  Serial.println("========================================");
+  Serial.printf("⚖️  Weight: %.1f kg\n", patient.weightTenths / 10.0f);
+  Serial.printf("📏 Height: %.1f cm\n", patient.heightTenths / 10.0f);
+  Serial.printf("⏱️  แกว่ง %lu ms → ยืนนิ่ง %lu ms\n",
+                (unsigned long)patient.settleMs, (unsigned long)patient.holdMs);
+}
+
+void streamSample(unsigned long currentTime) {
+  int16_t weight = 0;
+  int16_t height = 0;
+  if (patientOn) {
+    unsigned long elapsed = currentTime - patientStart;
+    SettlingCurve_sample(patient, elapsed, weight, height);
+    if (elapsed >= SettlingCurve_duration(patient)) {
+      patientOn = false;
+      lastSendTime = currentTime;   // Auto: นับช่วงว่างก่อนคนถัดไปจากตอนก้าวลง
+      Serial.printf("🚶 Patient #%d ก้าวลง (ส่ง %d บรรทัด)\n", sendCount, streamLines);
+    }
+  } else if (!STREAM_IDLE_ZERO) {
+    return;
+  }
+  
+  char line[32];
+  snprintf(line, sizeof(line), "W:%05.1f H:%05.1f", weight / 10.0f, height / 10.0f);
+  rs232Serial.println(line);
+  if (patientOn) {
+    streamLines++;
+  }
+  
+  digitalWrite(LED_PIN, patientOn ? LOW : HIGH);   // LED ติดระหว่างมีคนบนเครื่อง
+}
+
+// ส่ง 1 ครั้ง (ปกติ) หรือคนไข้คนใหม่ (Streaming Mode)
+void trigger() {
+  if (streamMode) {
+    startPatient();
+  } else {
+    sendWeightData();
+  }
+}
+
 void setup() {
   Serial.begin(115200);
   delay(100);
@@ -138,6 +208,7 @@ void setup() {
     Serial.printf("   • Interval: %d ms (%.1f sec)\n", AUTO_SEND_INTERVAL, AUTO_SEND_INTERVAL/1000.0);
   }
   Serial.printf("   • Send Temp: %s\n", SEND_TEMP ? "YES" : "NO");
+  Serial.printf("   • Streaming: %s (every %d ms)\n", streamMode ? "ON" : "OFF", STREAM_INTERVAL);
   Serial.printf("   • Weight: %.1f - %.1f kg\n", WEIGHT_MIN, WEIGHT_MAX);
   Serial.printf("   • Height: %.1f - %.1f cm\n", HEIGHT_MIN, HEIGHT_MAX);
   
@@ -150,6 +221,7 @@ void setup() {
   Serial.println("\n🎮 Controls:");
   Serial.println("   • Press FLASH button (D3) to send data");
   Serial.println("   • Type 'send' in Serial Monitor");
+  Serial.println("   • Type 'stream' to toggle Streaming Mode");
   if (AUTO_SEND_ENABLED) {
     Serial.printf("   • Auto send every %.1f seconds\n", AUTO_SEND_INTERVAL/1000.0);
   }
@@ -183,18 +255,25 @@ void loop() {
   unsigned long currentTime = millis();
   
   // ===== Auto Send Mode =====
-  if (AUTO_SEND_ENABLED && (currentTime - lastSendTime >= AUTO_SEND_INTERVAL)) {
-    sendWeightData();
+  // Streaming: คนถัดไปก้าวขึ้นหลังคนก่อนก้าวลง AUTO_SEND_INTERVAL
+  if (AUTO_SEND_ENABLED && !patientOn && (currentTime - lastSendTime >= AUTO_SEND_INTERVAL)) {
+    trigger();
     lastSendTime = currentTime;
   }
   
+  // ===== Streaming Mode =====
+  if (streamMode && (currentTime - lastStreamTime >= STREAM_INTERVAL)) {
+    streamSample(currentTime);
+    lastStreamTime = currentTime;
+  }
+  
   // ===== Button Mode =====
   bool buttonState = digitalRead(BUTTON_PIN);
   if (buttonState == LOW && lastButtonState == HIGH) {
     // Debounce
     if (currentTime - lastButtonPress > 300) {
       Serial.println("\n🔘 Button Pressed!");
-      sendWeightData();
+      trigger();
       lastButtonPress = currentTime;
       lastSendTime = currentTime;  // Reset auto send timer
     }
@@ -209,12 +288,19 @@ void loop() {
     
     if (cmd == "send" || cmd == "s") {
       Serial.println("\n💬 Command: SEND");
-      sendWeightData();
+      trigger();
       lastSendTime = currentTime;
     }
+    else if (cmd == "stream") {
+      streamMode = !streamMode;
+      patientOn = false;
+      digitalWrite(LED_PIN, HIGH);
+      Serial.printf("\n💬 Streaming Mode: %s\n", streamMode ? "ON" : "OFF");
+    }
     else if (cmd == "help" || cmd == "h" || cmd == "?") {
       Serial.println("\n📖 Commands:");
-      Serial.println("   send / s  - Send weight data");
+      Serial.println("   send / s  - Send weight data (Streaming: new patient)");
+      Serial.println("   stream    - Toggle Streaming Mode");
       Serial.println("   help / h  - Show this help");
       Serial.println("   info / i  - Show configuration");
     }
@@ -223,6 +309,7 @@ void loop() {
       Serial.printf("   • Board: ESP8266\n");
       Serial.printf("   • Auto Send: %s\n", AUTO_SEND_ENABLED ? "ENABLED" : "DISABLED");
       Serial.printf("   • Interval: %.1f sec\n", AUTO_SEND_INTERVAL/1000.0);
+      Serial.printf("   • Streaming: %s (every %d ms)\n", streamMode ? "ON" : "OFF", STREAM_INTERVAL);
       Serial.printf("   • Send Count: %d\n", sendCount);
       Serial.printf("   • TX Pin: D4 (GPIO2)\n");
       Serial.printf("   • Baud Rate: %d\n", RS232_BAUD);
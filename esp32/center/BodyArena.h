@@ -0,0 +1,122 @@
+/**
+ * BodyArena.h - buffer คงที่สำหรับ HTTP body (แทน malloc() ต่อ request)
+ *
+ * body มาหลาย chunk ใน network task → เขียนลง slot ของ request นั้น (หา slot ด้วย pointer ของ request)
+ * handler ใช้ body แล้วคืน slot ด้วย BodyArena_release() - จองไว้ตั้งแต่เปิดเครื่อง heap จึงไม่แตกเป็นชิ้น
+ * แม้รับ request ขนาดต่างกันไปหลายวัน (ESP8266 ไม่มี heap พอให้ malloc ก้อนใหญ่หลังใช้งานนาน)
+ *
+ * - slot เต็ม → BodyArena_claim() คืน nullptr ให้ handler ตอบ 503 (อุปกรณ์ retry ตาม backoff)
+ * - request ที่หลุดกลางทาง (handler ไม่ถูกเรียก) ไม่ได้คืน slot → ถูกนำกลับมาใช้หลัง BODY_ARENA_TIMEOUT_MS
+ * - ใช้จาก network task เท่านั้น (body callback และ handler ทำงานทีละตัว) จึงไม่ต้องใช้ lock
+ *
+ * ไม่ขึ้นกับ Arduino - compile บน PC ได้ (กำหนด BODY_ARENA_SLOT_SIZE เอง)
+ */
+
+#ifndef BODY_ARENA_H
+#define BODY_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ===== Configuration =====
+#ifndef BODY_ARENA_SLOTS
+  #ifdef ESP32
+    #define BODY_ARENA_SLOTS 3          // upload พร้อมกันได้ 3 request (3 x 12KB)
+  #else
+    #define BODY_ARENA_SLOTS 2          // 2 x 4KB
+  #endif
+#endif
+#ifndef BODY_ARENA_SLOT_SIZE
+  #define BODY_ARENA_SLOT_SIZE MAX_BODY_SIZE   // Config.h
+#endif
+#define BODY_ARENA_TIMEOUT_MS 10000     // request ที่ค้างนานกว่านี้ถือว่าหลุดแล้ว
+
+struct BodySlot {
+  const void* owner;      // request ที่ใช้ slot อยู่ (nullptr = ว่าง)
+  uint32_t claimedAt;     // ms
+  uint32_t total;         // Content-Length
+  uint32_t received;
+  char data[BODY_ARENA_SLOT_SIZE + 1];   // null-terminated เมื่อครบ
+};
+
+BodySlot bodySlots[BODY_ARENA_SLOTS];
+uint32_t bodyArenaBusyCount = 0;        // request ที่ไม่ได้ slot (ตอบ 503)
+uint32_t bodyArenaExpiredCount = 0;     // slot ที่นำกลับมาใช้เพราะ request หลุด
+uint32_t bodyArenaHighWater = 0;
+
+inline BodySlot* BodyArena_find(const void* owner) {
+  for (int i = 0; i < BODY_ARENA_SLOTS; i++) {
+    if (bodySlots[i].owner == owner) {
+      return &bodySlots[i];
+    }
+  }
+  return nullptr;
+}
+
+inline void BodyArena_release(const void* owner) {
+  BodySlot* slot = BodyArena_find(owner);
+  if (slot != nullptr) {
+    slot->owner = nullptr;
+  }
+}
+
+// เรียกเมื่อได้ chunk แรก - คืน nullptr ถ้าใหญ่เกิน slot หรือ slot เต็ม
+inline BodySlot* BodyArena_claim(const void* owner, size_t total, uint32_t now) {
+  // pointer เดียวกับ request เก่าที่หลุดไป (ถูก free แล้วได้ที่อยู่เดิม) → ทิ้ง slot เก่า
+  BodyArena_release(owner);
+  if (total > BODY_ARENA_SLOT_SIZE) {
+    return nullptr;
+  }
+
+  BodySlot* slot = nullptr;
+  uint32_t used = 0;
+  for (int i = 0; i < BODY_ARENA_SLOTS; i++) {
+    if (bodySlots[i].owner == nullptr) {
+      if (slot == nullptr) {
+        slot = &bodySlots[i];
+      }
+    } else {
+      used++;
+    }
+  }
+  for (int i = 0; i < BODY_ARENA_SLOTS && slot == nullptr; i++) {
+    if (now - bodySlots[i].claimedAt >= BODY_ARENA_TIMEOUT_MS) {
+      slot = &bodySlots[i];
+      used--;
+      bodyArenaExpiredCount++;
+    }
+  }
+  if (slot == nullptr) {
+    bodyArenaBusyCount++;
+    return nullptr;
+  }
+
+  slot->owner = owner;
+  slot->claimedAt = now;
+  slot->total = total;
+  slot->received = 0;
+  slot->data[0] = '\0';
+  if (used + 1 > bodyArenaHighWater) {
+    bodyArenaHighWater = used + 1;
+  }
+  return slot;
+}
+
+// chunk ที่อยู่นอก Content-Length ถูกทิ้ง (slot จะไม่ครบ → handler ตอบ 400)
+inline void BodyArena_write(BodySlot& slot, const uint8_t* data, size_t length, size_t index) {
+  if (index != slot.received || index + length > slot.total) {
+    return;
+  }
+  memcpy(slot.data + index, data, length);
+  slot.received += length;
+  if (slot.received == slot.total) {
+    slot.data[slot.total] = '\0';
+  }
+}
+
+inline bool BodyArena_complete(const BodySlot& slot) {
+  return slot.received == slot.total;
+}
+
+#endif
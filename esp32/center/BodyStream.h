@@ -0,0 +1,58 @@
+/**
+ * BodyStream.h - อ่าน HTTP body ทีละ byte ผ่าน Stream
+ *
+ * ใช้กับ deserializeJson(doc, stream) เพื่อ parse JSON array ทีละ element
+ * ArduinoJson จะหยุดอ่านทันทีที่จบ 1 value → รู้ตำแหน่งเริ่ม/จบของแต่ละ element
+ * และใช้ JsonDocument ขนาดคงที่ตัวเดียวได้ไม่ว่า batch จะมีกี่รายการ
+ */
+
+#ifndef BODY_STREAM_H
+#define BODY_STREAM_H
+
+#include <Arduino.h>
+
+class BodyStream : public Stream {
+  public:
+    BodyStream(const char* data, size_t length) : _data(data), _length(length), _pos(0) {
+      setTimeout(0);  // ข้อมูลอยู่ใน RAM ครบแล้ว ไม่ต้องรอ
+    }
+
+    int available() override {
+      return _length - _pos;
+    }
+
+    int read() override {
+      return _pos < _length ? (uint8_t)_data[_pos++] : -1;
+    }
+
+    int peek() override {
+      return _pos < _length ? (uint8_t)_data[_pos] : -1;
+    }
+
+    size_t write(uint8_t) override {
+      return 0;  // อ่านอย่างเดียว
+    }
+
+    // ข้าม whitespace แล้วคืน byte ถัดไป (ไม่อ่านออก) หรือ -1 ถ้าหมด
+    int peekToken() {
+      while (_pos < _length && isspace((uint8_t)_data[_pos])) {
+        _pos++;
+      }
+      return peek();
+    }
+
+    size_t position() const {
+      return _pos;
+    }
+
+    const char* data() const {
+      return _data;
+    }
+
+  private:
+    const char* _data;
+    size_t _length;
+    size_t _pos;
+};
+
+#endif
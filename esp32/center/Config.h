@@ -15,13 +15,34 @@ const char* CENTER_SSID = "MEDICAL_CENTER_01";  // SSID สำหรับ Soft
 const char* CENTER_PASSWORD = "Abc123**";       // รหัสผ่าน WiFi (ต้องมีอย่างน้อย 8 ตัวอักษร)
 const char* CENTER_NAME = "MEDICAL_CENTER_01";  // ชื่ออุปกรณ์
 
+// Serial Settings (ต้องตรงกับ Baud Rate ในหน้า Settings ของแอป)
+// ข้อมูลส่งเป็น frame มี CRC + ACK/NACK จึงใช้ 460800 / 921600 ได้ถ้าสาย USB รองรับ
+const unsigned long SERIAL_BAUD = 115200;
+
+// Log Settings (ดู Log.h)
+// LOG_LEVEL_INFO = บรรทัดเดียวต่อ reading | LOG_LEVEL_DEBUG = raw JSON + ค่าที่ parse ได้ทุก reading
+// LOG_DEFERRED 1 = เขียนลง RAM แล้วทยอยส่งระหว่าง frame | 0 = พิมพ์ตรง (ใช้ไล่หาปัญหาเครื่อง reset)
+#define LOG_LEVEL LOG_LEVEL_INFO
+#define LOG_DEFERRED 1
+
 // Network Configuration
 IPAddress local_ip(10, 1, 10, 1);      // Center IP Address (Fixed)
 IPAddress gateway(10, 1, 10, 1);       // Gateway Address
 IPAddress subnet(255, 255, 255, 0);    // Subnet Mask
 
 // Timing Settings (ปรับให้อัพเดตเรียลไทม์เร็วขึ้น)
-const unsigned long CLEANUP_INTERVAL = 10000;  // ตรวจสอบอุปกรณ์ออฟไลน์ทุก 10 วินาที (เร็วขึ้น)
 const unsigned long DEVICE_TIMEOUT = 10000;    // ถือว่าอุปกรณ์ออฟไลน์หากไม่ได้รับข้อมูลเกิน 10 วินาที (ตอบสนองเร็วขึ้น)
 
+// Batch Settings
+const int BATCH_MAX_ITEMS = 32;                // จำนวนรายการสูงสุดต่อ 1 request ของ /api/vitals/batch
+
+// HTTP Settings
+#ifdef ESP32
+const size_t MAX_BODY_SIZE = 12288;            // ขนาด body สูงสุดต่อ request (batch 32 รายการ)
+const size_t CACHE_JSON_SIZE = 8192;           // GET /api/devices, /api/changes (~400 bytes/อุปกรณ์ - ไม่พอ = แบ่งหน้า)
+#else
+const size_t MAX_BODY_SIZE = 4096;             // ESP8266 มี RAM น้อย
+const size_t CACHE_JSON_SIZE = 2048;
+#endif
+
 #endif
@@ -0,0 +1,92 @@
+/**
+ * DedupWindow.h - กรอง reading ซ้ำด้วย seq ของอุปกรณ์ (sliding window bitmap)
+ *
+ * อุปกรณ์ส่ง reading ซ้ำได้เมื่อ POST หมดเวลา / ไม่ได้ ACK ทั้งที่ Center รับไปแล้ว
+ * หรือเมื่อส่งซ้ำจาก Journal หลัง reboot - seq มาจาก Journal จึงไม่ซ้ำแม้อุปกรณ์ reboot
+ *
+ * - เก็บ seq สูงสุดที่เห็น + bitmap 64 bit ของ seq ที่ต่ำกว่า (bit i = highest - i)
+ *   → 16 bytes ต่ออุปกรณ์ รับ reading ที่มาไม่เรียงลำดับได้ภายใน 64 seq
+ * - epoch = ค่าสุ่มที่อุปกรณ์สร้างทุกครั้งที่ตัวนับ seq เริ่มที่ 1 ใหม่ (ไฟล์ journal ถูกสร้างใหม่)
+ *   มากับ reading (JSON "epoch"), HELLO และ /api/status → epoch เปลี่ยน = เริ่ม window ใหม่
+ *   ไม่ว่า seq ใหม่จะห่างจาก seq เดิมเท่าใด
+ * - epoch = 0 (firmware เก่า) → ใช้ระยะห่างแทน: seq ต่ำกว่า window ถือว่าเริ่มนับใหม่
+ *   (อุปกรณ์ส่งซ้ำได้ไม่เกิน JOURNAL_SLOT_COUNT = 64 seq อยู่แล้ว)
+ *   และ Center ล้าง window เอง (Dedup_reset) เมื่ออุปกรณ์เริ่ม session ใหม่
+ * - seq = 0 = อุปกรณ์ไม่มี seq (ไม่มี journal / firmware เก่า) → ส่งต่อเสมอ ไม่บันทึก
+ *
+ * ไม่ขึ้นกับ Arduino - compile บน PC ได้
+ */
+
+#ifndef DEDUP_WINDOW_H
+#define DEDUP_WINDOW_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ===== Configuration =====
+#define DEDUP_WINDOW_SIZE 64      // จำนวน bit ของ seen (ต้อง ≥ JOURNAL_SLOT_COUNT ของอุปกรณ์)
+
+enum DedupResult : uint8_t {
+  DEDUP_NEW = 0,          // ยังไม่เคยเห็น → ส่งต่อ
+  DEDUP_DUPLICATE,        // เคยส่งต่อแล้ว → ตอบรับแต่ไม่ส่งต่อ
+  DEDUP_RESTARTED,        // epoch เปลี่ยน / ต่ำกว่า window → ตัวนับของอุปกรณ์เริ่มใหม่ (ส่งต่อ)
+  DEDUP_UNTRACKED         // seq = 0 (ส่งต่อ)
+};
+
+struct DedupWindow {
+  uint32_t epoch;         // epoch ของตัวนับ seq ที่ window นี้ใช้ (0 = ไม่รู้)
+  uint32_t highest;       // seq สูงสุดที่เห็น (0 = ยังไม่เคยเห็น)
+  uint64_t seen;          // bit i = เห็น seq (highest - i) แล้ว
+};
+
+inline void Dedup_reset(DedupWindow& w) {
+  memset(&w, 0, sizeof(w));
+}
+
+// epoch จาก HELLO / /api/status / reading (0 = อุปกรณ์ไม่ส่งมา → ไม่เปลี่ยนอะไร)
+// คืน true ถ้า epoch เปลี่ยน (window เดิมถูกล้าง)
+inline bool Dedup_setEpoch(DedupWindow& w, uint32_t epoch) {
+  if (epoch == 0 || epoch == w.epoch) {
+    return false;
+  }
+  bool restarted = w.highest != 0;
+  Dedup_reset(w);
+  w.epoch = epoch;
+  return restarted;
+}
+
+// ตรวจ seq แล้วบันทึกว่าเห็นแล้ว (เรียกครั้งเดียวต่อ reading ที่รับ)
+inline DedupResult Dedup_check(DedupWindow& w, uint32_t epoch, uint32_t seq) {
+  if (seq == 0) {
+    return DEDUP_UNTRACKED;
+  }
+  if (Dedup_setEpoch(w, epoch)) {
+    w.highest = seq;
+    w.seen = 1;
+    return DEDUP_RESTARTED;
+  }
+
+  if (w.highest == 0 || seq > w.highest) {
+    uint32_t shift = w.highest == 0 ? DEDUP_WINDOW_SIZE : seq - w.highest;
+    w.seen = shift >= DEDUP_WINDOW_SIZE ? 0 : w.seen << shift;
+    w.seen |= 1;
+    w.highest = seq;
+    return DEDUP_NEW;
+  }
+
+  uint32_t offset = w.highest - seq;
+  if (offset >= DEDUP_WINDOW_SIZE) {
+    w.highest = seq;
+    w.seen = 1;
+    return DEDUP_RESTARTED;
+  }
+
+  uint64_t bit = (uint64_t)1 << offset;
+  if (w.seen & bit) {
+    return DEDUP_DUPLICATE;
+  }
+  w.seen |= bit;
+  return DEDUP_NEW;
+}
+
+#endif
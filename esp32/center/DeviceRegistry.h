@@ -0,0 +1,402 @@
+/**
+ * DeviceRegistry.h - รายชื่ออุปกรณ์ที่ส่งข้อมูลมายัง Center
+ *
+ * - ค้นหาด้วย MAC 6 bytes ผ่าน hash table แบบ open addressing (linear probing) → O(1)
+ * - ID/ชื่อ/MAC เก็บใน struct ขนาดคงที่ (ไม่ใช้ String / heap)
+ * - นับจำนวนอุปกรณ์ออนไลน์ไว้ตลอด (updateRedLED ไม่ต้องวนนับทุก loop)
+ * - หมดเวลา (DEVICE_TIMEOUT) ด้วย timer wheel: แต่ละ tick ตรวจเฉพาะอุปกรณ์ที่ครบกำหนดใน slot นั้น
+ * - Registry_touch()/Registry_setOffline(): สถานะจาก MAC อย่างเดียว (UDP heartbeat, AP station event)
+ * - ตารางเต็ม → แทนที่อุปกรณ์ออฟไลน์ที่เห็นล่าสุดนานที่สุด (ไม่ทิ้งอุปกรณ์ใหม่เงียบๆ)
+ *
+ * ข้อมูลอุปกรณ์อยู่ใน registryDevices[] ตำแหน่งคงที่ hash table เก็บแค่ index
+ * จึงลบ/ย้ายใน table ได้โดยไม่กระทบ link ของ timer wheel
+ * ไม่ขึ้นกับ Arduino (รับเวลา now เป็นพารามิเตอร์)
+ */
+
+#ifndef DEVICE_REGISTRY_H
+#define DEVICE_REGISTRY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// ===== Configuration =====
+#ifndef REGISTRY_CAPACITY                         // กำหนดเองได้ก่อน include (ต้องเป็น power of 2)
+  #ifdef ESP8266
+    #define REGISTRY_CAPACITY 16
+  #else
+    #define REGISTRY_CAPACITY 64
+  #endif
+#endif
+#define REGISTRY_TABLE_SIZE (REGISTRY_CAPACITY * 2)   // power of 2, load factor ≤ 0.5
+#define REGISTRY_ID_SIZE 24
+#define REGISTRY_NAME_SIZE 32
+#define REGISTRY_MAC_SIZE 18
+#define REGISTRY_WHEEL_SLOTS 16
+#define REGISTRY_WHEEL_TICK 1000                      // ms ต่อ slot
+#define REGISTRY_NONE -1
+
+struct RegistryDevice {
+  bool used;
+  bool online;
+  uint8_t key[6];                       // MAC (หรือ hash ของ deviceId ถ้า MAC อ่านไม่ได้)
+  char deviceId[REGISTRY_ID_SIZE];
+  char deviceName[REGISTRY_NAME_SIZE];
+  char macAddress[REGISTRY_MAC_SIZE];
+  unsigned long lastSeen;
+  unsigned long expireTick;
+  int16_t wheelPrev;
+  int16_t wheelNext;
+};
+
+RegistryDevice registryDevices[REGISTRY_CAPACITY];
+int16_t registryTable[REGISTRY_TABLE_SIZE];
+int16_t registryWheel[REGISTRY_WHEEL_SLOTS];
+int registryCount = 0;
+int registryOnlineCount = 0;
+unsigned long registryTimeout = 10000;
+unsigned long registryWheelTick = 0;
+unsigned long registryEvictedCount = 0;
+
+// ===== Helpers =====
+inline void Registry_copy(char* out, const char* in, size_t size) {
+  size_t i = 0;
+  if (in != nullptr) {
+    for (; i + 1 < size && in[i] != '\0'; i++) {
+      out[i] = in[i];
+    }
+  }
+  out[i] = '\0';
+}
+
+inline int Registry_hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+// "AA:BB:CC:DD:EE:FF" (หรือคั่นด้วย '-') → 6 bytes
+inline bool Registry_parseMac(const char* text, uint8_t* mac) {
+  if (text == nullptr) {
+    return false;
+  }
+  for (int i = 0; i < 6; i++) {
+    int high = Registry_hexValue(text[0]);
+    int low = high < 0 ? -1 : Registry_hexValue(text[1]);
+    if (low < 0) {
+      return false;
+    }
+    mac[i] = (high << 4) | low;
+    text += 2;
+    if (i < 5) {
+      if (*text != ':' && *text != '-') {
+        return false;
+      }
+      text++;
+    }
+  }
+  return *text == '\0';
+}
+
+// key ของอุปกรณ์: MAC ถ้าอ่านได้ ไม่งั้นใช้ FNV-1a ของ deviceId
+inline void Registry_makeKey(const char* mac, const char* deviceId, uint8_t* key) {
+  if (Registry_parseMac(mac, key)) {
+    return;
+  }
+  uint64_t hash = 0xcbf29ce484222325ULL;
+  for (const char* p = deviceId; p != nullptr && *p != '\0'; p++) {
+    hash = (hash ^ (uint8_t)*p) * 0x100000001b3ULL;
+  }
+  for (int i = 0; i < 6; i++) {
+    key[i] = hash >> (i * 8);
+  }
+  key[0] |= 0x02;  // locally administered → ไม่ชนกับ MAC จริง
+}
+
+inline uint32_t Registry_hash(const uint8_t* key) {
+  uint32_t hash = 2166136261u;
+  for (int i = 0; i < 6; i++) {
+    hash = (hash ^ key[i]) * 16777619u;
+  }
+  return hash & (REGISTRY_TABLE_SIZE - 1);
+}
+
+// ===== Timer wheel =====
+inline void Registry_wheelUnlink(int16_t index) {
+  RegistryDevice& device = registryDevices[index];
+  if (device.wheelPrev != REGISTRY_NONE) {
+    registryDevices[device.wheelPrev].wheelNext = device.wheelNext;
+  } else {
+    int slot = device.expireTick % REGISTRY_WHEEL_SLOTS;
+    if (registryWheel[slot] == index) {
+      registryWheel[slot] = device.wheelNext;
+    }
+  }
+  if (device.wheelNext != REGISTRY_NONE) {
+    registryDevices[device.wheelNext].wheelPrev = device.wheelPrev;
+  }
+  device.wheelPrev = REGISTRY_NONE;
+  device.wheelNext = REGISTRY_NONE;
+}
+
+inline void Registry_wheelLink(int16_t index, unsigned long expireTick) {
+  RegistryDevice& device = registryDevices[index];
+  int slot = expireTick % REGISTRY_WHEEL_SLOTS;
+  device.expireTick = expireTick;
+  device.wheelPrev = REGISTRY_NONE;
+  device.wheelNext = registryWheel[slot];
+  if (device.wheelNext != REGISTRY_NONE) {
+    registryDevices[device.wheelNext].wheelPrev = index;
+  }
+  registryWheel[slot] = index;
+}
+
+// tick แรกที่ now - lastSeen > timeout แน่นอน
+inline unsigned long Registry_expireTickFor(unsigned long now, unsigned long elapsed) {
+  unsigned long remaining = elapsed >= registryTimeout ? 0 : registryTimeout - elapsed;
+  return now / REGISTRY_WHEEL_TICK + (remaining + REGISTRY_WHEEL_TICK - 1) / REGISTRY_WHEEL_TICK + 1;
+}
+
+// millis() วนรอบ (~49 วัน) → tick ย้อนกลับ: จัด wheel ใหม่ตามเวลาที่เหลือจริง (O(n) ครั้งเดียว)
+inline void Registry_rebuildWheel(unsigned long now) {
+  for (int i = 0; i < REGISTRY_WHEEL_SLOTS; i++) {
+    registryWheel[i] = REGISTRY_NONE;
+  }
+  for (int16_t i = 0; i < REGISTRY_CAPACITY; i++) {
+    RegistryDevice& device = registryDevices[i];
+    if (device.used && device.online) {
+      Registry_wheelLink(i, Registry_expireTickFor(now, now - device.lastSeen));
+    }
+  }
+  registryWheelTick = now / REGISTRY_WHEEL_TICK;
+}
+
+// ===== เริ่มต้น =====
+inline void Registry_begin(unsigned long timeout, unsigned long now) {
+  memset(registryDevices, 0, sizeof(registryDevices));
+  for (int i = 0; i < REGISTRY_TABLE_SIZE; i++) {
+    registryTable[i] = REGISTRY_NONE;
+  }
+  for (int i = 0; i < REGISTRY_WHEEL_SLOTS; i++) {
+    registryWheel[i] = REGISTRY_NONE;
+  }
+  registryCount = 0;
+  registryOnlineCount = 0;
+  registryTimeout = timeout;
+  registryWheelTick = now / REGISTRY_WHEEL_TICK;
+}
+
+// ===== ค้นหา (คืนตำแหน่งใน hash table หรือ REGISTRY_NONE) =====
+inline int Registry_findSlot(const uint8_t* key) {
+  uint32_t slot = Registry_hash(key);
+  while (registryTable[slot] != REGISTRY_NONE) {
+    if (memcmp(registryDevices[registryTable[slot]].key, key, 6) == 0) {
+      return slot;
+    }
+    slot = (slot + 1) & (REGISTRY_TABLE_SIZE - 1);
+  }
+  return REGISTRY_NONE;
+}
+
+inline RegistryDevice* Registry_find(const char* mac, const char* deviceId) {
+  uint8_t key[6];
+  Registry_makeKey(mac, deviceId, key);
+  int slot = Registry_findSlot(key);
+  return slot == REGISTRY_NONE ? nullptr : &registryDevices[registryTable[slot]];
+}
+
+// ===== ลบออกจาก table (backward-shift: ไม่ต้องใช้ tombstone) =====
+inline void Registry_remove(int16_t index) {
+  RegistryDevice& device = registryDevices[index];
+  int slot = Registry_findSlot(device.key);
+  if (slot == REGISTRY_NONE) {
+    return;
+  }
+
+  uint32_t mask = REGISTRY_TABLE_SIZE - 1;
+  uint32_t hole = slot;
+  uint32_t next = (hole + 1) & mask;
+  while (registryTable[next] != REGISTRY_NONE) {
+    uint32_t home = Registry_hash(registryDevices[registryTable[next]].key);
+    // ย้ายเข้า hole ได้ถ้า home ไม่อยู่ระหว่าง (hole, next]
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      registryTable[hole] = registryTable[next];
+      hole = next;
+    }
+    next = (next + 1) & mask;
+  }
+  registryTable[hole] = REGISTRY_NONE;
+
+  if (device.online) {
+    Registry_wheelUnlink(index);
+    registryOnlineCount--;
+  }
+  device.used = false;
+  registryCount--;
+}
+
+// อุปกรณ์ออฟไลน์ที่ไม่เห็นนานที่สุด (ใช้เมื่อตารางเต็มเท่านั้น)
+inline int16_t Registry_oldestOffline(unsigned long now) {
+  int16_t oldest = REGISTRY_NONE;
+  for (int16_t i = 0; i < REGISTRY_CAPACITY; i++) {
+    const RegistryDevice& device = registryDevices[i];
+    if (device.used && !device.online &&
+        (oldest == REGISTRY_NONE || now - device.lastSeen > now - registryDevices[oldest].lastSeen)) {
+      oldest = i;
+    }
+  }
+  return oldest;
+}
+
+// ===== เห็นอุปกรณ์ตอนนี้: ออนไลน์ + เลื่อนเวลาหมดอายุ =====
+inline void Registry_markSeen(int16_t index, unsigned long now) {
+  RegistryDevice& device = registryDevices[index];
+  device.lastSeen = now;
+
+  if (device.online) {
+    Registry_wheelUnlink(index);
+  } else {
+    device.online = true;
+    registryOnlineCount++;
+  }
+  Registry_wheelLink(index, Registry_expireTickFor(now, 0));
+}
+
+// ===== อัพเดท/เพิ่มอุปกรณ์ =====
+// คืน nullptr ถ้าตารางเต็มด้วยอุปกรณ์ออนไลน์ทั้งหมด, isNew = true ถ้าเพิ่งเพิ่ม
+inline RegistryDevice* Registry_update(const char* deviceId, const char* deviceName, const char* mac,
+                                       unsigned long now, bool& isNew) {
+  uint8_t key[6];
+  Registry_makeKey(mac, deviceId, key);
+  isNew = false;
+
+  int16_t index;
+  int slot = Registry_findSlot(key);
+  if (slot != REGISTRY_NONE) {
+    index = registryTable[slot];
+  } else {
+    if (registryCount >= REGISTRY_CAPACITY) {
+      int16_t victim = Registry_oldestOffline(now);
+      if (victim == REGISTRY_NONE) {
+        return nullptr;
+      }
+      Registry_remove(victim);
+      registryEvictedCount++;
+    }
+
+    index = 0;
+    while (registryDevices[index].used) {
+      index++;
+    }
+    RegistryDevice& device = registryDevices[index];
+    memset(&device, 0, sizeof(device));
+    device.used = true;
+    memcpy(device.key, key, 6);
+    device.wheelPrev = REGISTRY_NONE;
+    device.wheelNext = REGISTRY_NONE;
+
+    slot = Registry_hash(key);
+    while (registryTable[slot] != REGISTRY_NONE) {
+      slot = (slot + 1) & (REGISTRY_TABLE_SIZE - 1);
+    }
+    registryTable[slot] = index;
+    registryCount++;
+    isNew = true;
+  }
+
+  RegistryDevice& device = registryDevices[index];
+  Registry_copy(device.deviceId, deviceId, sizeof(device.deviceId));
+  Registry_copy(device.deviceName, deviceName, sizeof(device.deviceName));
+  Registry_copy(device.macAddress, mac, sizeof(device.macAddress));
+  Registry_markSeen(index, now);
+  return &device;
+}
+
+// ===== อุปกรณ์ที่รู้จักแล้วยังอยู่ (ไม่มีข้อมูลอุปกรณ์มาด้วย - ไม่เพิ่มอุปกรณ์ใหม่) =====
+// คืน nullptr ถ้าไม่รู้จัก MAC นี้ (ผู้เรียกขอให้อุปกรณ์ส่งข้อมูลเต็มมา), wasOnline = สถานะก่อนหน้า
+inline RegistryDevice* Registry_touch(const uint8_t* mac, unsigned long now, bool& wasOnline) {
+  int slot = Registry_findSlot(mac);
+  if (slot == REGISTRY_NONE) {
+    return nullptr;
+  }
+  int16_t index = registryTable[slot];
+  wasOnline = registryDevices[index].online;
+  Registry_markSeen(index, now);
+  return &registryDevices[index];
+}
+
+// ===== ออฟไลน์ทันที (เช่น หลุดจาก AP) - คืน nullptr ถ้าไม่รู้จักหรือออฟไลน์อยู่แล้ว =====
+inline RegistryDevice* Registry_setOffline(const uint8_t* mac) {
+  int slot = Registry_findSlot(mac);
+  if (slot == REGISTRY_NONE) {
+    return nullptr;
+  }
+  int16_t index = registryTable[slot];
+  RegistryDevice& device = registryDevices[index];
+  if (!device.online) {
+    return nullptr;
+  }
+  Registry_wheelUnlink(index);
+  device.online = false;
+  registryOnlineCount--;
+  return &device;
+}
+
+// ===== ตรวจอุปกรณ์ที่หมดเวลา (เรียกบ่อยได้ - ทำงานเฉพาะเมื่อข้าม tick) =====
+// เรียก onOffline ต่ออุปกรณ์ที่เพิ่งออฟไลน์ คืนจำนวนอุปกรณ์ที่ออฟไลน์รอบนี้
+inline int Registry_expire(unsigned long now, void (*onOffline)(const RegistryDevice&)) {
+  unsigned long nowTick = now / REGISTRY_WHEEL_TICK;
+  if ((long)(nowTick - registryWheelTick) < -1) {
+    Registry_rebuildWheel(now);
+  }
+
+  int expired = 0;
+  int steps = 0;
+  while ((long)(nowTick - registryWheelTick) >= 0 && steps < REGISTRY_WHEEL_SLOTS) {
+    int16_t index = registryWheel[registryWheelTick % REGISTRY_WHEEL_SLOTS];
+    while (index != REGISTRY_NONE) {
+      RegistryDevice& device = registryDevices[index];
+      int16_t next = device.wheelNext;
+      // slot เดียวกันอาจมีอุปกรณ์ของรอบถัดไป (timeout ยาวกว่า wheel)
+      if ((long)(nowTick - device.expireTick) >= 0) {
+        Registry_wheelUnlink(index);
+        device.online = false;
+        registryOnlineCount--;
+        expired++;
+        if (onOffline != nullptr) {
+          onOffline(device);
+        }
+      }
+      index = next;
+    }
+    registryWheelTick++;
+    steps++;
+  }
+
+  // ไม่ได้เรียกนานเกิน 1 รอบ wheel: ทุก slot ถูกตรวจด้วย nowTick แล้ว
+  if ((long)(nowTick - registryWheelTick) >= 0) {
+    registryWheelTick = nowTick + 1;
+  }
+  return expired;
+}
+
+// ===== Getters =====
+inline int Registry_getCount() {
+  return registryCount;
+}
+
+inline int Registry_getOnlineCount() {
+  return registryOnlineCount;
+}
+
+inline unsigned long Registry_getEvictedCount() {
+  return registryEvictedCount;
+}
+
+// วนดูอุปกรณ์ทั้งหมด: i = 0..REGISTRY_CAPACITY-1 (nullptr = ช่องว่าง)
+inline const RegistryDevice* Registry_at(int i) {
+  return registryDevices[i].used ? &registryDevices[i] : nullptr;
+}
+
+#endif
@@ -0,0 +1,105 @@
+/**
+ * Inbox.h - คิวข้อมูลที่รับจาก HTTP รอประมวลผลใน loop()
+ *
+ * AsyncWebServer เรียก handler จาก network task (ESP32: async_tcp / ESP8266: SYS)
+ * handler จึงต้องจบเร็ว: ตรวจ body แล้ว Inbox_push() และตอบ response ทันที
+ * งานช้า (Serial log, ส่ง [DATA], LED, อัพเดทรายชื่ออุปกรณ์) ทำใน loop() ผ่าน Inbox_peek()/Inbox_pop()
+ *
+ * Single-producer / single-consumer: network task เขียน head, loop() เขียน tail
+ * จึงไม่ต้องใช้ lock - แค่ต้องมี memory barrier ก่อนเลื่อน index (ESP32 มี 2 cores)
+ */
+
+#ifndef INBOX_H
+#define INBOX_H
+
+#include <Arduino.h>
+
+// ===== Configuration =====
+// INBOX_BODY_SIZE = body ใหญ่สุดที่ส่งต่อไปคอมพิวเตอร์ (SerialLink ใช้ขนาดเดียวกัน)
+// status + metrics จาก ESP32_RS232 ยาวได้ถึง 576 bytes
+#ifdef ESP32
+  #define INBOX_CAPACITY 32
+#else
+  #define INBOX_CAPACITY 8
+#endif
+#define INBOX_BODY_SIZE 640
+
+enum InboxKind : uint8_t {
+  INBOX_VITALS,
+  INBOX_STATUS
+};
+
+struct InboxItem {
+  uint8_t kind;
+  uint32_t remoteIP;
+  uint16_t length;
+  unsigned long receivedAt;         // micros() ตอนเข้าคิว (วัดเวลารอในคิวถึงส่งออก Serial)
+  char body[INBOX_BODY_SIZE];
+};
+
+InboxItem inboxItems[INBOX_CAPACITY];
+volatile uint32_t inboxHead = 0;   // เขียนโดย network task
+volatile uint32_t inboxTail = 0;   // เขียนโดย loop()
+volatile unsigned long inboxDroppedCount = 0;
+volatile uint32_t inboxHighWater = 0;
+
+// ===== Producer (network task) =====
+// คืน false ถ้าคิวเต็มหรือ body ใหญ่เกิน → ให้ตอบ 503 / 413 แล้ว device จะส่งใหม่
+inline bool Inbox_push(uint8_t kind, uint32_t remoteIP, const char* body, size_t length) {
+  if (length >= INBOX_BODY_SIZE) {
+    inboxDroppedCount++;
+    return false;
+  }
+
+  uint32_t head = inboxHead;
+  uint32_t used = head - inboxTail;
+  if (used >= INBOX_CAPACITY) {
+    inboxDroppedCount++;
+    return false;
+  }
+
+  InboxItem& item = inboxItems[head % INBOX_CAPACITY];
+  item.kind = kind;
+  item.remoteIP = remoteIP;
+  item.length = length;
+  item.receivedAt = micros();
+  memcpy(item.body, body, length);
+  item.body[length] = '\0';
+
+  __sync_synchronize();  // ข้อมูลใน slot ต้องเห็นก่อน head ใหม่
+  inboxHead = head + 1;
+
+  if (used + 1 > inboxHighWater) {
+    inboxHighWater = used + 1;
+  }
+  return true;
+}
+
+// ===== Consumer (loop) =====
+inline InboxItem* Inbox_peek() {
+  if (inboxTail == inboxHead) {
+    return nullptr;
+  }
+  __sync_synchronize();  // อ่าน slot หลังเห็น head แล้ว
+  return &inboxItems[inboxTail % INBOX_CAPACITY];
+}
+
+inline void Inbox_pop() {
+  __sync_synchronize();  // ใช้ slot เสร็จก่อนคืนให้ producer
+  inboxTail = inboxTail + 1;
+}
+
+// ===== สถิติ =====
+inline uint32_t Inbox_size() {
+  return inboxHead - inboxTail;
+}
+
+inline unsigned long Inbox_getDroppedCount() {
+  return inboxDroppedCount;
+}
+
+inline uint32_t Inbox_getHighWater() {
+  return inboxHighWater;
+}
+
+#endif
@@ -0,0 +1,307 @@
+/**
+ * ReadingCache.h - ค่าล่าสุดของแต่ละอุปกรณ์ (GET /api/devices, GET /api/changes)
+ *
+ * PC ที่ต่อ Serial ใหม่ / แอปเปิดใหม่ ดึงค่าที่พลาดไประหว่างนั้นจาก Center ได้
+ *
+ * - หน่วยความจำคงที่: REGISTRY_CAPACITY x 3 ประเภท (BP / weight-height / temp)
+ *   index เดียวกับ registryDevices[] - ล้างเมื่อช่องถูกใช้กับอุปกรณ์ใหม่
+ * - ทุกครั้งที่เก็บค่าใหม่ cacheGeneration เพิ่ม 1 และ entry จำ generation ของตัวเอง
+ *   → /api/changes?since=<gen> ส่งเฉพาะ entry ที่ generation > gen
+ * - เขียนใน loop() / อ่านใน network task: entry ใช้ generation เป็น seqlock
+ *   (0 ระหว่างเขียน → ผู้อ่าน copy แล้วตรวจ generation ซ้ำ ได้ค่าจาก reading เดียวกันเสมอ)
+ * - JSON เขียนลง buffer ที่ผู้เรียกเตรียมไว้ (ไม่ใช้ String / ArduinoJson / heap)
+ *   buffer ไม่พอ → ตัดที่ขอบอุปกรณ์ "complete": false และ "generation" = จุดที่ต้องถามต่อ
+ *
+ * ไม่ขึ้นกับ Arduino (รับเวลา now เป็นพารามิเตอร์)
+ */
+
+#ifndef READING_CACHE_H
+#define READING_CACHE_H
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "DeviceRegistry.h"
+#include "WireProtocol.h"
+
+// ===== Configuration =====
+#define CACHE_SLOTS 3
+#define CACHE_READ_RETRIES 4      // ผู้อ่านลอง copy ใหม่ได้กี่ครั้งถ้าชนกับการเขียน
+
+enum CacheSlot : uint8_t {
+  CACHE_SLOT_BP = 0,
+  CACHE_SLOT_WEIGHT_HEIGHT,
+  CACHE_SLOT_TEMP,
+  CACHE_SLOT_NONE = 0xFF
+};
+
+const char* const CACHE_SLOT_NAMES[CACHE_SLOTS] = { "blood_pressure", "weight_height", "temp" };
+
+struct CachedReading {
+  volatile uint32_t generation;   // 0 = ว่าง / กำลังเขียน
+  uint32_t receivedAt;            // ms (เวลาของ Center)
+  uint32_t seq;                   // seq ของอุปกรณ์ (0 = ไม่มี)
+  WireReading reading;            // ค่าแบบเดียวกับ WireProtocol (BP = mmHg, อื่นๆ x10)
+};
+
+// ===== Variables =====
+CachedReading cacheEntries[REGISTRY_CAPACITY][CACHE_SLOTS];
+volatile uint32_t cacheGeneration = 0;
+
+// ===== ประเภทของ reading → ช่องใน cache =====
+inline uint8_t Cache_slotFor(uint8_t kind) {
+  switch (kind) {
+    case WIRE_KIND_BLOOD_PRESSURE:
+      return CACHE_SLOT_BP;
+    case WIRE_KIND_WEIGHT_HEIGHT:
+    case WIRE_KIND_WEIGHT:
+    case WIRE_KIND_HEIGHT:
+      return CACHE_SLOT_WEIGHT_HEIGHT;
+    case WIRE_KIND_TEMP:
+      return CACHE_SLOT_TEMP;
+    default:
+      return CACHE_SLOT_NONE;
+  }
+}
+
+// ===== ล้างค่าของอุปกรณ์ (ช่อง registry ถูกใช้กับอุปกรณ์ใหม่) =====
+inline void Cache_clearDevice(int index) {
+  for (int slot = 0; slot < CACHE_SLOTS; slot++) {
+    cacheEntries[index][slot].generation = 0;
+  }
+  __sync_synchronize();
+}
+
+// ===== เก็บค่าล่าสุด (loop) - คืน generation ใหม่ (0 = ประเภทที่ไม่ cache) =====
+inline uint32_t Cache_store(int index, const WireReading& reading, uint32_t seq, uint32_t now) {
+  uint8_t slot = Cache_slotFor(reading.kind);
+  if (index < 0 || index >= REGISTRY_CAPACITY || slot == CACHE_SLOT_NONE) {
+    return 0;
+  }
+
+  CachedReading& entry = cacheEntries[index][slot];
+  uint32_t generation = cacheGeneration + 1;
+
+  entry.generation = 0;
+  __sync_synchronize();   // ผู้อ่านต้องเห็น 0 ก่อนค่าใหม่
+  entry.receivedAt = now;
+  entry.seq = seq;
+  entry.reading = reading;
+  __sync_synchronize();   // ค่าใหม่ครบก่อน generation ใหม่
+  entry.generation = generation;
+  cacheGeneration = generation;
+  return generation;
+}
+
+// ===== อ่าน entry แบบไม่ขาดครึ่ง (network task) - false = ว่าง / ชนกับการเขียนทุกครั้ง =====
+inline bool Cache_read(int index, int slot, CachedReading& out) {
+  const CachedReading& entry = cacheEntries[index][slot];
+  for (int attempt = 0; attempt < CACHE_READ_RETRIES; attempt++) {
+    uint32_t before = entry.generation;
+    if (before == 0) {
+      continue;
+    }
+    __sync_synchronize();
+    out.receivedAt = entry.receivedAt;
+    out.seq = entry.seq;
+    memcpy(&out.reading, (const void*)&entry.reading, sizeof(out.reading));
+    __sync_synchronize();
+    if (entry.generation == before) {
+      out.generation = before;
+      return true;
+    }
+  }
+  return false;
+}
+
+// ===== JSON writer (buffer คงที่) =====
+struct JsonWriter {
+  char* out;
+  size_t size;
+  size_t length;
+  bool overflow;
+};
+
+inline void JsonWriter_begin(JsonWriter& w, char* out, size_t size) {
+  w.out = out;
+  w.size = size;
+  w.length = 0;
+  w.overflow = false;
+  if (size > 0) {
+    out[0] = '\0';
+  }
+}
+
+inline void JsonWriter_printf(JsonWriter& w, const char* format, ...) {
+  if (w.overflow) {
+    return;
+  }
+  va_list args;
+  va_start(args, format);
+  int n = vsnprintf(w.out + w.length, w.size - w.length, format, args);
+  va_end(args);
+  if (n < 0 || (size_t)n >= w.size - w.length) {
+    w.overflow = true;
+    return;
+  }
+  w.length += n;
+}
+
+// string พร้อม escape (ชื่ออุปกรณ์ตั้งเองได้)
+inline void JsonWriter_string(JsonWriter& w, const char* text) {
+  JsonWriter_printf(w, "\"");
+  for (; *text != '\0' && !w.overflow; text++) {
+    unsigned char c = *text;
+    if (c == '"' || c == '\\') {
+      JsonWriter_printf(w, "\\%c", c);
+    } else if (c < 0x20) {
+      JsonWriter_printf(w, "\\u%04x", c);
+    } else if (w.length + 1 < w.size) {
+      w.out[w.length++] = c;
+      w.out[w.length] = '\0';
+    } else {
+      w.overflow = true;
+    }
+  }
+  JsonWriter_printf(w, "\"");
+}
+
+// ค่า x10 → ทศนิยม 1 ตำแหน่ง (ไม่ใช้ float)
+inline void JsonWriter_tenths(JsonWriter& w, int16_t value) {
+  int v = value;
+  JsonWriter_printf(w, "%s%d.%d", v < 0 ? "-" : "", (v < 0 ? -v : v) / 10, (v < 0 ? -v : v) % 10);
+}
+
+// ===== JSON ของ entry เดียว =====
+inline void Cache_writeEntry(JsonWriter& w, int slot, const CachedReading& entry, uint32_t now) {
+  const WireReading& r = entry.reading;
+  JsonWriter_printf(w, "\"%s\":{\"generation\":%lu,\"ageMs\":%lu,\"seq\":%lu",
+                    CACHE_SLOT_NAMES[slot], (unsigned long)entry.generation,
+                    (unsigned long)(now - entry.receivedAt), (unsigned long)entry.seq);
+  if (r.fields & WIRE_FIELD_IDCARD) {
+    char idcard[24];
+    Wire_idcardToString(r.idcard, idcard, sizeof(idcard));
+    JsonWriter_printf(w, ",\"idcard\":\"%s\"", idcard);
+  }
+
+  if (slot == CACHE_SLOT_BP) {
+    if (r.fields & WIRE_FIELD_VALUE0) JsonWriter_printf(w, ",\"bp\":%d", r.values[0]);
+    if (r.fields & WIRE_FIELD_VALUE1) JsonWriter_printf(w, ",\"bp2\":%d", r.values[1]);
+    if (r.fields & WIRE_FIELD_VALUE2) JsonWriter_printf(w, ",\"pulse\":%d", r.values[2]);
+  } else if (slot == CACHE_SLOT_TEMP) {
+    JsonWriter_printf(w, ",\"temp\":");
+    JsonWriter_tenths(w, r.values[0]);
+  } else {
+    // weight / height เดี่ยวใช้ value0 ตาม kind
+    const char* first = r.kind == WIRE_KIND_HEIGHT ? "height" : "weight";
+    if (r.fields & WIRE_FIELD_VALUE0) {
+      JsonWriter_printf(w, ",\"%s\":", first);
+      JsonWriter_tenths(w, r.values[0]);
+    }
+    if (r.fields & WIRE_FIELD_VALUE1) {
+      JsonWriter_printf(w, ",\"height\":");
+      JsonWriter_tenths(w, r.values[1]);
+    }
+    if (r.fields & WIRE_FIELD_VALUE2) {
+      JsonWriter_printf(w, ",\"temp\":");
+      JsonWriter_tenths(w, r.values[2]);
+    }
+  }
+  JsonWriter_printf(w, "}");
+}
+
+// ===== Snapshot (since = 0) / เฉพาะที่เปลี่ยน (since > 0) =====
+// since = 0: ทุกอุปกรณ์ในตาราง (รวมที่ยังไม่มีค่า) | since > 0: เฉพาะอุปกรณ์/entry ที่ generation > since
+// คืนความยาว JSON (0 = buffer เล็กเกินแม้แต่ส่วนหัว)
+inline size_t Cache_writeJson(char* out, size_t size, uint32_t since, uint32_t now) {
+  // generation ก่อนเริ่มอ่าน: ค่าที่เขียนระหว่างนี้อาจติดมาด้วย (ส่งซ้ำได้) แต่ไม่ตกหล่น
+  uint32_t generation = cacheGeneration;
+  uint32_t resumeFrom = 0;     // generation ต่ำสุดที่ตัดทิ้ง (0 = ไม่มี entry ที่ตัดทิ้ง)
+  bool truncated = false;
+  bool first = true;
+
+  JsonWriter w;
+  JsonWriter_begin(w, out, size);
+  // เว้นที่ไว้ปิดท้าย: ],"generation":<10>,"complete":false}
+  size_t reserve = 48;
+  if (size <= reserve) {
+    return 0;
+  }
+  w.size = size - reserve;
+  JsonWriter_printf(w, "{\"devices\":[");
+
+  for (int i = 0; i < REGISTRY_CAPACITY; i++) {
+    const RegistryDevice* device = Registry_at(i);
+    if (device == nullptr) {
+      continue;
+    }
+
+    CachedReading entries[CACHE_SLOTS];
+    bool present[CACHE_SLOTS];
+    bool changed = since == 0;
+    for (int slot = 0; slot < CACHE_SLOTS; slot++) {
+      present[slot] = Cache_read(i, slot, entries[slot]) && entries[slot].generation > since;
+      changed = changed || present[slot];
+    }
+    if (!changed) {
+      continue;
+    }
+
+    // buffer เต็มแล้ว → แค่หา generation ต่ำสุดที่ยังไม่ได้ส่ง
+    if (w.overflow) {
+      truncated = true;
+      for (int slot = 0; slot < CACHE_SLOTS; slot++) {
+        if (present[slot] && (resumeFrom == 0 || entries[slot].generation < resumeFrom)) {
+          resumeFrom = entries[slot].generation;
+        }
+      }
+      continue;
+    }
+
+    size_t mark = w.length;
+    JsonWriter_printf(w, "%s{\"deviceId\":", first ? "" : ",");
+    JsonWriter_string(w, device->deviceId);
+    JsonWriter_printf(w, ",\"deviceName\":");
+    JsonWriter_string(w, device->deviceName);
+    JsonWriter_printf(w, ",\"macAddress\":\"%s\",\"online\":%s,\"lastSeenMs\":%lu,\"readings\":{",
+                      device->macAddress, device->online ? "true" : "false",
+                      (unsigned long)(now - device->lastSeen));
+    bool firstEntry = true;
+    for (int slot = 0; slot < CACHE_SLOTS; slot++) {
+      if (!present[slot]) {
+        continue;
+      }
+      if (!firstEntry) {
+        JsonWriter_printf(w, ",");
+      }
+      Cache_writeEntry(w, slot, entries[slot], now);
+      firstEntry = false;
+    }
+    JsonWriter_printf(w, "}}");
+
+    if (w.overflow) {
+      // อุปกรณ์นี้ไม่พอดี → ตัดทิ้งทั้งก้อน (JSON ยังถูกต้อง)
+      w.length = mark;
+      out[mark] = '\0';
+      truncated = true;
+      for (int slot = 0; slot < CACHE_SLOTS; slot++) {
+        if (present[slot] && (resumeFrom == 0 || entries[slot].generation < resumeFrom)) {
+          resumeFrom = entries[slot].generation;
+        }
+      }
+      continue;
+    }
+    first = false;
+  }
+
+  // ถูกตัด → ถามต่อด้วย since = generation ก่อนตัวที่ตกหล่น
+  w.size = size;
+  w.overflow = false;
+  JsonWriter_printf(w, "],\"generation\":%lu,\"complete\":%s}",
+                    (unsigned long)(resumeFrom != 0 ? resumeFrom - 1 : generation),
+                    truncated ? "false" : "true");
+  return w.length;
+}
+
+#endif
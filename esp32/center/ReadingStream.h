@@ -0,0 +1,198 @@
+/**
+ * ReadingStream.h - ส่ง reading ที่ Center รับแล้วให้ PC ผ่าน WebSocket (/ws) ทันที
+ *
+ * แทนการ poll /api/changes: reading ที่ผ่านการกรองซ้ำ (จุดเดียวกับที่ส่งออก Serial)
+ * ถูกส่งเป็น JSON แบบเดียวกับ [DATA] ให้ทุก client ที่ต่ออยู่
+ *
+ *   loop: ReadingStream_publish() → log วนรอบ (copy ครั้งเดียว ไม่ขึ้นกับจำนวน client)
+ *   loop: ReadingStream_drain()   → client แต่ละตัวส่งจาก cursor ของตัวเองเท่าที่ transport รับ
+ *
+ * - หน่วยความจำคงที่: STREAM_LOG_FRAMES frame + STREAM_MAX_CLIENTS cursor (ไม่ malloc)
+ * - client ช้า (ค้างเกิน STREAM_LOG_FRAMES frame = frame ที่ยังไม่ได้ส่งถูกเขียนทับ)
+ *   → ตัดการเชื่อมต่อ client นั้น ไม่รอ/ไม่ชะลอการรับข้อมูล - client ต่อใหม่แล้วดึงที่พลาดจาก /api/changes
+ * - client ใหม่เริ่มที่ reading ถัดไป (ค่าล่าสุดดูจาก /api/devices)
+ * - ต่อ/หลุด (network task) → คิว single-producer / single-consumer แบบ StationEvents.h
+ *   ตาราง client แก้ใน loop() เท่านั้น
+ *
+ * ไม่ขึ้นกับ Arduino - transport เป็น function pointer (รับเวลา now เป็นพารามิเตอร์)
+ */
+
+#ifndef READING_STREAM_H
+#define READING_STREAM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "Histogram.h"
+
+// ===== Configuration =====
+#ifdef ESP32
+  #define STREAM_MAX_CLIENTS 4
+  #define STREAM_LOG_FRAMES 16
+  #define STREAM_FRAME_SIZE 512    // reading JSON (status ไม่ส่งทาง /ws)
+#else
+  #define STREAM_MAX_CLIENTS 2
+  #define STREAM_LOG_FRAMES 4
+  #define STREAM_FRAME_SIZE 384
+#endif
+#define STREAM_EVENTS_CAPACITY 8
+
+struct StreamFrame {
+  uint16_t length;
+  uint32_t publishedAt;    // us
+  char data[STREAM_FRAME_SIZE];
+};
+
+struct StreamClient {
+  bool used;
+  uint32_t id;             // id ของ transport (AsyncWebSocketClient::id())
+  uint32_t cursor;         // frame ถัดไปที่ต้องส่ง (นับต่อเนื่องแบบเดียวกับ streamHead)
+};
+
+enum StreamSendResult : uint8_t {
+  STREAM_SENT = 0,
+  STREAM_BUSY,             // คิวของ client เต็ม → ลองใหม่รอบหน้า
+  STREAM_GONE              // client ไม่อยู่แล้ว → เอาออกจากตาราง
+};
+
+typedef StreamSendResult (*StreamSendFn)(uint32_t id, const char* data, size_t length);
+typedef void (*StreamCloseFn)(uint32_t id);
+
+struct StreamEvent {
+  uint32_t id;
+  bool connected;
+};
+
+// ===== Variables =====
+StreamFrame streamLog[STREAM_LOG_FRAMES];
+uint32_t streamHead = 0;                     // จำนวน frame ที่ publish แล้วทั้งหมด
+StreamClient streamClients[STREAM_MAX_CLIENTS];
+
+StreamEvent streamEvents[STREAM_EVENTS_CAPACITY];
+volatile uint32_t streamEventsHead = 0;      // เขียนโดย network task
+volatile uint32_t streamEventsTail = 0;      // เขียนโดย loop()
+
+// สถิติ
+uint32_t streamPublished = 0;
+uint32_t streamTooLarge = 0;                 // reading ยาวเกิน frame → ไม่ส่ง
+uint32_t streamSent = 0;                     // frame ที่ส่งสำเร็จ (รวมทุก client)
+uint32_t streamSlowDropped = 0;              // client ที่ถูกตัดเพราะช้า
+uint32_t streamRejected = 0;                 // client ที่ไม่รับเพราะตารางเต็ม
+volatile uint32_t streamEventsDropped = 0;
+
+// ===== ต่อ/หลุด (network task) =====
+inline bool ReadingStream_pushEvent(uint32_t id, bool connected) {
+  uint32_t head = streamEventsHead;
+  if (head - streamEventsTail >= STREAM_EVENTS_CAPACITY) {
+    streamEventsDropped = streamEventsDropped + 1;
+    return false;
+  }
+  streamEvents[head % STREAM_EVENTS_CAPACITY].id = id;
+  streamEvents[head % STREAM_EVENTS_CAPACITY].connected = connected;
+
+  __sync_synchronize();  // ข้อมูลต้องเห็นก่อน head ใหม่
+  streamEventsHead = head + 1;
+  return true;
+}
+
+inline StreamClient* ReadingStream_find(uint32_t id) {
+  for (int i = 0; i < STREAM_MAX_CLIENTS; i++) {
+    if (streamClients[i].used && streamClients[i].id == id) {
+      return &streamClients[i];
+    }
+  }
+  return nullptr;
+}
+
+// ===== อัพเดทตาราง client จากคิว (loop) - ตารางเต็ม → close =====
+inline void ReadingStream_processEvents(StreamCloseFn close) {
+  while (streamEventsTail != streamEventsHead) {
+    uint32_t tail = streamEventsTail;
+    __sync_synchronize();  // อ่านข้อมูลหลังเห็น head แล้ว
+    StreamEvent event = streamEvents[tail % STREAM_EVENTS_CAPACITY];
+    __sync_synchronize();
+    streamEventsTail = tail + 1;
+
+    StreamClient* client = ReadingStream_find(event.id);
+    if (!event.connected) {
+      if (client != nullptr) {
+        client->used = false;
+      }
+      continue;
+    }
+    for (int i = 0; i < STREAM_MAX_CLIENTS && client == nullptr; i++) {
+      if (!streamClients[i].used) {
+        client = &streamClients[i];
+      }
+    }
+    if (client == nullptr) {
+      streamRejected++;
+      close(event.id);
+      continue;
+    }
+    client->used = true;
+    client->id = event.id;
+    client->cursor = streamHead;
+  }
+}
+
+// ===== เพิ่ม reading (loop) - O(1) ไม่แตะ client =====
+inline bool ReadingStream_publish(const char* json, size_t length, uint32_t nowUs) {
+  if (length >= STREAM_FRAME_SIZE) {
+    streamTooLarge++;
+    return false;
+  }
+  StreamFrame& frame = streamLog[streamHead % STREAM_LOG_FRAMES];
+  memcpy(frame.data, json, length);
+  frame.data[length] = '\0';
+  frame.length = (uint16_t)length;
+  frame.publishedAt = nowUs;
+  streamHead++;
+  streamPublished++;
+  return true;
+}
+
+// ===== ส่ง frame ที่ค้างให้ทุก client (loop) =====
+// latencyUs: publish → ส่งให้ transport แล้ว / คืนจำนวน frame ที่ส่งรอบนี้
+inline int ReadingStream_drain(uint32_t nowUs, StreamSendFn send, StreamCloseFn close, Histogram& latencyUs) {
+  int sent = 0;
+  for (int i = 0; i < STREAM_MAX_CLIENTS; i++) {
+    StreamClient& client = streamClients[i];
+    if (!client.used) {
+      continue;
+    }
+    if (streamHead - client.cursor > STREAM_LOG_FRAMES) {
+      // frame ที่ยังไม่ได้ส่งถูกเขียนทับแล้ว → ตัด (client ดึงที่พลาดจาก /api/changes)
+      streamSlowDropped++;
+      client.used = false;
+      close(client.id);
+      continue;
+    }
+    while (client.cursor != streamHead) {
+      const StreamFrame& frame = streamLog[client.cursor % STREAM_LOG_FRAMES];
+      StreamSendResult result = send(client.id, frame.data, frame.length);
+      if (result == STREAM_BUSY) {
+        break;
+      }
+      if (result == STREAM_GONE) {
+        client.used = false;
+        break;
+      }
+      Histogram_add(latencyUs, nowUs - frame.publishedAt);
+      client.cursor++;
+      streamSent++;
+      sent++;
+    }
+  }
+  return sent;
+}
+
+inline int ReadingStream_clientCount() {
+  int count = 0;
+  for (int i = 0; i < STREAM_MAX_CLIENTS; i++) {
+    count += streamClients[i].used ? 1 : 0;
+  }
+  return count;
+}
+
+#endif
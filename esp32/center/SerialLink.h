@@ -0,0 +1,250 @@
+/**
+ * SerialLink.h - ช่องทางส่ง reading จาก Center ไปยังคอมพิวเตอร์แบบมี frame
+ *
+ * เดิมส่งเป็นบรรทัด "[DATA] {...}" ปนกับ debug log → บรรทัดที่เสีย/ถูกแทรกหายไปเงียบๆ
+ * ตอนนี้แต่ละ reading เป็น frame ที่ตรวจสอบได้และมีเลขลำดับ:
+ *
+ *   0x00 [COBS( type 1 | boot 2 | seq 4 | payload ... | crc16 2 )] 0x00
+ *
+ * - COBS ทำให้ใน frame ไม่มี byte 0x00 → ใช้ 0x00 เป็นตัวคั่น (debug text ไม่มี 0x00 จึงปนกันได้)
+ * - crc16 = CRC-16/CCITT-FALSE (Wire_crc16) ของ type+boot+seq+payload, ตัวเลขเป็น little-endian
+ * - boot = ค่าสุ่มต่อการเปิดเครื่องของ Center อยู่ในทุก frame → PC เริ่มนับ seq ใหม่เมื่อ boot เปลี่ยน
+ *   แม้ HELLO จะหายไป (เช่น เปิดแอปหลัง Center reboot); ACK/NACK สะท้อน boot กลับมา
+ *   → ACK/NACK ที่ค้างจากก่อน reboot ไม่ถูกนำไปใช้กับ seq ชุดใหม่
+ * - DATA (Center→PC): payload = JSON แบบเดียวกับบรรทัด [DATA] เดิม, seq เพิ่มทีละ 1
+ * - ACK (PC→Center): seq = รับครบถึง seq นี้แล้ว (cumulative)
+ * - NACK (PC→Center): ขอ seq นี้ใหม่ (เห็นช่องว่างของ seq หรือ frame เสีย)
+ * - HELLO (Center→PC): ส่งตอนเริ่มทำงาน ให้ PC เริ่มนับ seq ใหม่
+ *
+ * Center เก็บ frame ล่าสุดไว้ใน ring เพื่อส่งซ้ำ (ไม่รอ ACK - ring เต็มก็เขียนทับ)
+ * ถ้า PC เคย ACK แล้วแต่ไม่มีความคืบหน้านาน → ส่ง frame แรกที่ยังไม่ ACK ซ้ำ (กันหายตอนท้าย)
+ * ครบ SERIAL_LINK_MAX_PROBES ครั้งแล้วยังเงียบ → หยุดส่งซ้ำจนกว่า PC จะ ACK อีก
+ * ฝั่ง PC: electron/serial/serial-link.ts
+ */
+
+#ifndef SERIAL_LINK_H
+#define SERIAL_LINK_H
+
+#include <Arduino.h>
+#include "WireProtocol.h"  // Wire_crc16, Wire_put32, Wire_get32
+#include "Inbox.h"         // INBOX_BODY_SIZE
+
+// ===== Configuration =====
+#ifdef ESP32
+  #define SERIAL_LINK_RING_SIZE 16
+#else
+  #define SERIAL_LINK_RING_SIZE 8
+#endif
+#define SERIAL_LINK_PAYLOAD_SIZE INBOX_BODY_SIZE   // body ที่ส่งต่อทุกแบบต้องลง frame เดียวได้
+#define SERIAL_LINK_HEADER_SIZE 7             // type + boot + seq
+#define SERIAL_LINK_OVERHEAD 9                // header + crc16
+#define SERIAL_LINK_RX_SIZE 32                // frame จาก PC (ACK/NACK) มีขนาดเล็ก
+#define SERIAL_LINK_RETRANSMIT_TIMEOUT 1000   // ms ไม่มี ACK ใหม่ → ส่ง frame ที่ค้างซ้ำ
+#define SERIAL_LINK_MAX_PROBES 3              // ส่งซ้ำแล้วยังเงียบ → ถือว่าแอปปิด (รอ ACK ครั้งถัดไป)
+
+enum SerialFrameType : uint8_t {
+  SERIAL_FRAME_DATA = 1,
+  SERIAL_FRAME_ACK = 2,
+  SERIAL_FRAME_NACK = 3,
+  SERIAL_FRAME_HELLO = 4
+};
+
+struct SerialLinkEntry {
+  uint32_t seq;
+  uint16_t length;
+  char payload[SERIAL_LINK_PAYLOAD_SIZE];
+};
+
+SerialLinkEntry serialLinkRing[SERIAL_LINK_RING_SIZE];
+uint16_t serialLinkBoot = 0;             // สุ่มใหม่ทุกครั้งที่เปิดเครื่อง (SerialLink_begin)
+uint32_t serialLinkNextSeq = 1;
+uint32_t serialLinkAckedSeq = 0;         // PC รับครบถึง seq นี้แล้ว
+bool serialLinkPeerActive = false;       // PC เคย ACK (แอปเวอร์ชันที่รองรับ frame)
+unsigned long serialLinkLastProgress = 0;
+int serialLinkProbeCount = 0;             // ส่งซ้ำเพราะไม่มี ACK ติดต่อกันกี่ครั้ง
+uint8_t serialLinkRx[SERIAL_LINK_RX_SIZE];
+size_t serialLinkRxLength = 0;
+bool serialLinkRxOverflow = false;
+
+// ===== สถิติ =====
+unsigned long serialLinkFramesSent = 0;
+unsigned long serialLinkRetransmits = 0;
+unsigned long serialLinkOverwritten = 0;   // ถูกเขียนทับก่อน PC ACK
+unsigned long serialLinkNackMissed = 0;    // PC ขอ seq ที่ไม่อยู่ใน ring แล้ว
+unsigned long serialLinkBadFrames = 0;
+unsigned long serialLinkStaleFrames = 0;   // ACK/NACK ของ boot ก่อนหน้า (ไม่ใช้)
+unsigned long serialLinkTooLarge = 0;      // payload ใหญ่เกิน slot (ไม่ได้ส่ง)
+
+// ===== COBS =====
+// encode ทีละ block แล้วเขียนออก Serial เลย (ไม่ต้องมี buffer ขนาด 2x)
+inline void SerialLink_writeCobs(const uint8_t* header, size_t headerLength,
+                                 const uint8_t* payload, size_t payloadLength,
+                                 const uint8_t* trailer, size_t trailerLength) {
+  uint8_t block[255];
+  size_t blockLength = 0;
+  const uint8_t* parts[3] = { header, payload, trailer };
+  size_t lengths[3] = { headerLength, payloadLength, trailerLength };
+
+  Serial.write((uint8_t)0x00);
+  for (int part = 0; part < 3; part++) {
+    for (size_t i = 0; i < lengths[part]; i++) {
+      uint8_t c = parts[part][i];
+      if (c != 0x00) {
+        block[blockLength++] = c;
+      }
+      if (c == 0x00 || blockLength == 254) {
+        Serial.write((uint8_t)(blockLength + 1));
+        Serial.write(block, blockLength);
+        blockLength = 0;
+      }
+    }
+  }
+  Serial.write((uint8_t)(blockLength + 1));
+  Serial.write(block, blockLength);
+  Serial.write((uint8_t)0x00);
+}
+
+// decode ใน buffer เดิม คืนความยาว หรือ -1 ถ้าผิดรูปแบบ
+inline int SerialLink_decodeCobs(uint8_t* data, size_t length) {
+  size_t in = 0;
+  size_t out = 0;
+  while (in < length) {
+    uint8_t code = data[in++];
+    if (code == 0x00 || in + code - 1 > length) {
+      return -1;
+    }
+    memmove(data + out, data + in, code - 1);   // out <= in เสมอ (ซ้อนกันได้)
+    out += code - 1;
+    in += code - 1;
+    if (code < 0xFF && in < length) {
+      data[out++] = 0x00;
+    }
+  }
+  return out;
+}
+
+// ===== ส่ง frame =====
+inline void SerialLink_writeFrame(uint8_t type, uint32_t seq, const char* payload, size_t length) {
+  uint8_t header[SERIAL_LINK_HEADER_SIZE];
+  header[0] = type;
+  Wire_put16(header + 1, serialLinkBoot);
+  Wire_put32(header + 3, seq);
+
+  uint8_t crc[2];
+  Wire_put16(crc, Wire_crc16((const uint8_t*)payload, length,
+                             Wire_crc16(header, SERIAL_LINK_HEADER_SIZE)));
+
+  SerialLink_writeCobs(header, SERIAL_LINK_HEADER_SIZE, (const uint8_t*)payload, length, crc, 2);
+}
+
+inline void SerialLink_begin() {
+  serialLinkBoot = random(1, 65536);
+  serialLinkNextSeq = 1;
+  serialLinkAckedSeq = 0;
+  SerialLink_writeFrame(SERIAL_FRAME_HELLO, 0, "", 0);
+}
+
+// ===== ส่ง reading (JSON) ไปยัง PC =====
+// คืน false ถ้า payload ใหญ่เกิน slot (ไม่ส่ง - ไม่ควรเกิดเพราะ body ถูกจำกัดที่ INBOX_BODY_SIZE)
+inline bool SerialLink_send(const char* payload, size_t length) {
+  if (length > SERIAL_LINK_PAYLOAD_SIZE) {
+    serialLinkTooLarge++;
+    return false;
+  }
+
+  uint32_t seq = serialLinkNextSeq++;
+  SerialLinkEntry& entry = serialLinkRing[seq % SERIAL_LINK_RING_SIZE];
+  if (entry.seq > serialLinkAckedSeq) {
+    serialLinkOverwritten++;
+  }
+  entry.seq = seq;
+  entry.length = length;
+  memcpy(entry.payload, payload, length);
+
+  SerialLink_writeFrame(SERIAL_FRAME_DATA, seq, payload, length);
+  serialLinkFramesSent++;
+  return true;
+}
+
+inline bool SerialLink_retransmit(uint32_t seq) {
+  SerialLinkEntry& entry = serialLinkRing[seq % SERIAL_LINK_RING_SIZE];
+  if (entry.seq != seq || seq == 0) {
+    serialLinkNackMissed++;
+    return false;
+  }
+  SerialLink_writeFrame(SERIAL_FRAME_DATA, seq, entry.payload, entry.length);
+  serialLinkRetransmits++;
+  return true;
+}
+
+// ===== frame จาก PC =====
+inline void SerialLink_handleFrame(uint8_t* data, size_t length) {
+  int decoded = SerialLink_decodeCobs(data, length);
+  if (decoded < SERIAL_LINK_OVERHEAD ||
+      Wire_get16(data + decoded - 2) != Wire_crc16(data, decoded - 2)) {
+    serialLinkBadFrames++;
+    return;
+  }
+
+  uint8_t type = data[0];
+  if (Wire_get16(data + 1) != serialLinkBoot) {
+    // แอปยังไม่เห็น frame ของ boot นี้ → seq ในนี้เป็นของชุดก่อน reboot
+    serialLinkStaleFrames++;
+    return;
+  }
+  uint32_t seq = Wire_get32(data + 3);
+  if (type == SERIAL_FRAME_ACK) {
+    if (seq < serialLinkNextSeq && seq > serialLinkAckedSeq) {
+      serialLinkAckedSeq = seq;
+      serialLinkProbeCount = 0;
+    }
+    serialLinkLastProgress = millis();
+    serialLinkPeerActive = true;
+  } else if (type == SERIAL_FRAME_NACK) {
+    serialLinkPeerActive = true;
+    SerialLink_retransmit(seq);
+  }
+}
+
+// ===== เรียกทุก loop: อ่าน ACK/NACK และส่งซ้ำเมื่อไม่มีความคืบหน้า =====
+inline void SerialLink_poll() {
+  while (Serial.available() > 0) {
+    uint8_t c = Serial.read();
+    if (c != 0x00) {
+      if (serialLinkRxLength < SERIAL_LINK_RX_SIZE) {
+        serialLinkRx[serialLinkRxLength++] = c;
+      } else {
+        serialLinkRxOverflow = true;
+      }
+      continue;
+    }
+    if (serialLinkRxLength > 0 && !serialLinkRxOverflow) {
+      SerialLink_handleFrame(serialLinkRx, serialLinkRxLength);
+    }
+    serialLinkRxLength = 0;
+    serialLinkRxOverflow = false;
+  }
+
+  unsigned long now = millis();
+  if (serialLinkPeerActive && serialLinkAckedSeq + 1 < serialLinkNextSeq &&
+      now - serialLinkLastProgress > SERIAL_LINK_RETRANSMIT_TIMEOUT) {
+    // frame แรกที่ยังไม่ ACK (ถ้าหลุด ring ไปแล้ว ข้ามไปตัวที่ยังมี)
+    uint32_t seq = serialLinkAckedSeq + 1;
+    if (serialLinkNextSeq - seq > SERIAL_LINK_RING_SIZE) {
+      seq = serialLinkNextSeq - SERIAL_LINK_RING_SIZE;
+    }
+    SerialLink_retransmit(seq);
+    serialLinkLastProgress = now;
+    if (++serialLinkProbeCount >= SERIAL_LINK_MAX_PROBES) {
+      serialLinkPeerActive = false;
+      serialLinkProbeCount = 0;
+    }
+  }
+}
+
+// ===== Getters =====
+inline uint32_t SerialLink_getPendingCount() {
+  return serialLinkNextSeq - 1 - serialLinkAckedSeq;
+}
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ * StationEvents.h - คิว event อุปกรณ์ต่อ/หลุดจาก AP ของ Center ส่งต่อไปยัง loop()
+ *
+ * WiFi event (ESP32: event task / ESP8266: SYS) ห้ามแตะ DeviceRegistry ที่ loop() ใช้อยู่
+ * → StationEvents_push() แค่จด MAC + ต่อ/หลุด แล้ว loop() อัพเดทสถานะผ่าน StationEvents_pop()
+ *
+ * - หลุดจาก AP = ออฟไลน์ทันที (ไม่ต้องรอ DEVICE_TIMEOUT)
+ * - ต่อ AP = ออนไลน์ถ้ารู้จักอยู่แล้ว (อุปกรณ์ใหม่ต้องส่ง /api/status / vitals ก่อน จึงจะรู้ ID/ชื่อ)
+ *
+ * Single-producer / single-consumer แบบเดียวกับ Inbox.h - คิวเต็มทิ้ง event ใหม่
+ * (สถานะยังถูกแก้ด้วย heartbeat / DEVICE_TIMEOUT ตามปกติ)
+ * ไม่ขึ้นกับ Arduino - compile บน PC ได้
+ */
+
+#ifndef STATION_EVENTS_H
+#define STATION_EVENTS_H
+
+#include <stdint.h>
+#include <string.h>
+
+// ===== Configuration =====
+#define STATION_EVENTS_CAPACITY 16
+
+struct StationEvent {
+  uint8_t mac[6];
+  bool connected;
+};
+
+StationEvent stationEvents[STATION_EVENTS_CAPACITY];
+volatile uint32_t stationEventsHead = 0;     // เขียนโดย WiFi event
+volatile uint32_t stationEventsTail = 0;     // เขียนโดย loop()
+volatile uint32_t stationEventsDropped = 0;
+
+// ===== Producer (WiFi event) =====
+inline bool StationEvents_push(const uint8_t* mac, bool connected) {
+  uint32_t head = stationEventsHead;
+  if (head - stationEventsTail >= STATION_EVENTS_CAPACITY) {
+    stationEventsDropped = stationEventsDropped + 1;
+    return false;
+  }
+  StationEvent& event = stationEvents[head % STATION_EVENTS_CAPACITY];
+  memcpy(event.mac, mac, 6);
+  event.connected = connected;
+
+  __sync_synchronize();  // ข้อมูลต้องเห็นก่อน head ใหม่
+  stationEventsHead = head + 1;
+  return true;
+}
+
+// ===== Consumer (loop) =====
+inline bool StationEvents_pop(StationEvent& out) {
+  uint32_t tail = stationEventsTail;
+  if (tail == stationEventsHead) {
+    return false;
+  }
+  __sync_synchronize();  // อ่านข้อมูลหลังเห็น head แล้ว
+  out = stationEvents[tail % STATION_EVENTS_CAPACITY];
+  __sync_synchronize();
+  stationEventsTail = tail + 1;
+  return true;
+}
+
+#endif
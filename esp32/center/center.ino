@@ -1,21 +1,39 @@
 // ===== BOARD DETECTION =====
 #ifdef ESP32
   #include <WiFi.h>
-  #include <WebServer.h>
+  #include <AsyncTCP.h>
   #include <esp_wifi.h>
   #define BOARD_TYPE "ESP32"
-  WebServer server(80);
 #elif defined(ESP8266)
   #include <ESP8266WiFi.h>
-  #include <ESP8266WebServer.h>
+  #include <ESPAsyncTCP.h>
   #define BOARD_TYPE "ESP8266"
-  ESP8266WebServer server(80);
 #else
   #error "This board is not supported! Use ESP32 or ESP8266"
 #endif
 
+#include <ESPAsyncWebServer.h>
 #include <ArduinoJson.h>
+#include <WiFiUdp.h>
 #include "Config.h"  // ไฟล์ Configuration แยกต่างหาก
+#include "Log.h"
+#include "BodyStream.h"
+#include "BodyArena.h"
+#include "DeviceRegistry.h"
+#include "DedupWindow.h"
+#include "ReadingCache.h"
+#include "Histogram.h"
+#include "ReadingStream.h"
+#include "Inbox.h"
+#include "StationEvents.h"
+#include "SerialLink.h"
+#include "WireProtocol.h"
+
+// Async server: รับหลาย connection พร้อมกัน handler ทำงานใน network task
+AsyncWebServer server(80);
+
+// PC รับ reading แบบ push (ดู ReadingStream.h) - ต่อที่ ws://<IP ของ Center>/ws
+AsyncWebSocket streamSocket("/ws");
 
 // ===== LED PINS =====
 #ifdef ESP32
@@ -28,76 +46,184 @@
 
 // ===== VARIABLES =====
 String macAddress;
-unsigned long lastCleanup = 0;
 unsigned long lastRedBlink = 0;
 int redBlinkCount = 0;
 bool redBlinkState = false;
 int currentBlinkNumber = 0;
+unsigned long greenLedOnAt = 0;
+bool greenLedOn = false;
 
 // WiFi Event Handler
+// อุปกรณ์ต่อ/หลุดจาก AP → StationEvents (ออนไลน์/ออฟไลน์ทันที - อัพเดทรายชื่อใน loop)
 #ifdef ESP32
+// (เรียกจาก WiFi event task - เขียนผ่าน Log จึงไม่แทรกกลาง frame ของ SerialLink)
 void WiFiAPStationConnected(WiFiEvent_t event, WiFiEventInfo_t info) {
-  Serial.println("\n🎉 ========================================");
-  Serial.println("   NEW DEVICE CONNECTED TO AP!");
-  Serial.println("========================================");
-  Serial.print("   MAC Address: ");
-  for (int i = 0; i < 6; i++) {
-    Serial.printf("%02X", info.wifi_ap_staconnected.mac[i]);
-    if (i < 5) Serial.print(":");
-  }
-  Serial.println();
-  Serial.println("========================================\n");
+  const uint8_t* mac = info.wifi_ap_staconnected.mac;
+  StationEvents_push(mac, true);
+  LOG_I("\n🎉 ========================================\n");
+  LOG_I("   NEW DEVICE CONNECTED TO AP!\n");
+  LOG_I("========================================\n");
+  LOG_I("   MAC Address: %02X:%02X:%02X:%02X:%02X:%02X\n",
+        mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+  LOG_I("========================================\n\n");
 }
 
 void WiFiAPStationDisconnected(WiFiEvent_t event, WiFiEventInfo_t info) {
-  Serial.println("\n❌ ========================================");
-  Serial.println("   DEVICE DISCONNECTED FROM AP");
-  Serial.println("========================================");
-  Serial.print("   MAC Address: ");
-  for (int i = 0; i < 6; i++) {
-    Serial.printf("%02X", info.wifi_ap_stadisconnected.mac[i]);
-    if (i < 5) Serial.print(":");
-  }
-  Serial.println();
-  Serial.println("========================================\n");
+  const uint8_t* mac = info.wifi_ap_stadisconnected.mac;
+  StationEvents_push(mac, false);
+  LOG_I("\n❌ ========================================\n");
+  LOG_I("   DEVICE DISCONNECTED FROM AP\n");
+  LOG_I("========================================\n");
+  LOG_I("   MAC Address: %02X:%02X:%02X:%02X:%02X:%02X\n",
+        mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+  LOG_I("========================================\n\n");
+}
+#elif defined(ESP8266)
+// (เรียกจาก SYS - ต้องเก็บ handler ไว้ ไม่งั้นยกเลิกการลงทะเบียน)
+WiFiEventHandler stationConnectedHandler;
+WiFiEventHandler stationDisconnectedHandler;
+
+void WiFiAPStationConnected(const WiFiEventSoftAPModeStationConnected& event) {
+  StationEvents_push(event.mac, true);
+}
+
+void WiFiAPStationDisconnected(const WiFiEventSoftAPModeStationDisconnected& event) {
+  StationEvents_push(event.mac, false);
 }
 #endif
 
-struct DeviceInfo {
-  String deviceId;
-  String deviceName;
-  String macAddress;
-  unsigned long lastSeen;
-  bool online;
+// ===== BINARY PROTOCOL (UDP) =====
+// session → ข้อมูลอุปกรณ์ที่ได้จาก HELLO (reading อ้างอิงแค่ session id)
+struct WireSession {
+  bool used;
+  uint16_t session;
+  char mac[18];
+  char name[WIRE_NAME_SIZE];
+  uint32_t epoch;              // epoch ของ seq จาก HELLO (0 = ไม่มี journal / firmware เก่า)
 };
 
 #ifdef ESP32
-  std::vector<DeviceInfo> connectedDevices;
+  #define WIRE_MAX_SESSIONS 16
+#else
+  #define WIRE_MAX_SESSIONS 8
+#endif
+
+WiFiUDP wireUdp;
+WireSession wireSessions[WIRE_MAX_SESSIONS];
+int wireNextEvict = 0;
+unsigned long wireReadingCount = 0;
+unsigned long wireBadFrameCount = 0;
+unsigned long wireHeartbeatCount = 0;
+
+// ===== METRICS (GET /api/metrics) =====
+Histogram histForwardUs;     // HTTP handler รับ body → ส่งออก Serial แล้ว (รวมเวลารอในคิว) / UDP: รับ → ส่ง
+Histogram histHandleUs;      // ประมวลผล reading ใน loop (parse + log + ส่ง Serial)
+Histogram histStreamUs;      // reading ผ่านการกรองซ้ำ → ส่งให้ client ของ /ws แล้ว
+uint32_t heapMinFree = 0;    // ESP8266: ค่าต่ำสุดที่สุ่มเห็น (ESP32 ใช้ค่าจาก SDK)
+
+// สรุปที่อุปกรณ์ส่งมากับ heartbeat (/api/status "metrics") + ที่ Center นับเอง
+// index เดียวกับ registryDevices[] (ตำแหน่งคงที่ - ล้างเมื่อช่องถูกใช้กับอุปกรณ์ใหม่)
+#define METRIC_SUMMARY_SIZE 4    // [n,p50,p95,max]
+
+struct DeviceMetrics {
+  bool reported;               // เคยได้รับ metrics จากอุปกรณ์
+  unsigned long reportedAt;    // millis() ของ Center
+  uint32_t readings;           // reading ที่ Center ได้รับจากอุปกรณ์นี้ (ไม่รวมที่ซ้ำ)
+  uint32_t duplicates;         // reading ซ้ำที่ตอบรับแต่ไม่ส่งต่อ
+  uint32_t up;                 // วินาทีตั้งแต่อุปกรณ์เปิดเครื่อง
+  uint32_t frameMs[METRIC_SUMMARY_SIZE];
+  uint32_t parseUs[METRIC_SUMMARY_SIZE];
+  uint32_t handleUs[METRIC_SUMMARY_SIZE];
+  uint32_t deliverMs[METRIC_SUMMARY_SIZE];
+  uint32_t retry;
+  uint32_t reconnect;
+  uint32_t dropped;
+  uint32_t overrun;            // UART RX ล้นที่อุปกรณ์ (byte หาย)
+  uint32_t baud;               // baud rate RS232 ที่อุปกรณ์ใช้อยู่ (0 = ไม่ได้รายงาน)
+  bool baudLocked;             // false = อุปกรณ์กำลังหา baud rate
+  uint32_t queueDropped;
+  uint32_t heapMin;
+  uint32_t wifiMs;             // WiFi.begin() → เชื่อมต่อได้ ครั้งล่าสุด
+  uint32_t reconnectMs;        // WiFi หลุด → เชื่อมต่อได้ ครั้งล่าสุด (0 = ยังไม่เคยหลุด)
+  uint32_t firstPostMs;        // อุปกรณ์เปิดเครื่อง → Center ตอบรับครั้งแรก
+};
+
+DeviceMetrics deviceMetrics[REGISTRY_CAPACITY];
+
+// ===== กรอง reading ซ้ำ (seq จาก Journal ของอุปกรณ์ - ดู DedupWindow.h) =====
+// index เดียวกับ registryDevices[] เช่นเดียวกับ deviceMetrics
+DedupWindow deviceDedup[REGISTRY_CAPACITY];
+unsigned long duplicateReadingCount = 0;
+
+// ===== ค่าล่าสุดต่ออุปกรณ์ (GET /api/devices, /api/changes - ดู ReadingCache.h) =====
+// เขียน JSON ลง buffer นี้ใน network task แล้วส่งจาก buffer ตรงๆ (ไม่ copy ลง heap)
+// cacheJsonBusy = response ก่อนหน้ายังส่งไม่หมด (library อ่าน cacheJson ตาม TCP window) → ห้ามเขียนทับ
+// onDisconnect ไม่มาภายใน CACHE_JSON_HOLD_MAX (ไม่ควรเกิด - AsyncTCP ตัดเองเมื่อ ACK timeout) → ปล่อย buffer
+#define CACHE_JSON_HOLD_MAX 30000
+char cacheJson[CACHE_JSON_SIZE];
+volatile bool cacheJsonBusy = false;
+unsigned long cacheJsonBusySince = 0;
+
+// ===== ขนาด JsonDocument (ทุกจุดที่ parse body ชนิดเดียวกันใช้ค่าเดียวกัน) =====
+// network task: ตรวจด้วย acceptFilter → doc เก็บแค่ deviceId/deviceType/data{} ไม่ขึ้นกับขนาด body
+// loop: parse ทั้ง body (string ถูก copy) - vitals ต้องพอสำหรับ BP + idcard + seq
+#define ACCEPT_JSON_SIZE 192
+#ifdef ESP32
+  #define VITALS_JSON_SIZE 512
+  #define STATUS_JSON_SIZE 1024   // status จาก ESP32_RS232 มี "metrics" ~38 ค่า
 #else
-  // ESP8266 มี memory น้อยกว่า ใช้ array แทน vector
-  DeviceInfo connectedDevices[10];  // รองรับสูงสุด 10 อุปกรณ์
-  int deviceCount = 0;
+  #define VITALS_JSON_SIZE 384
+  #define STATUS_JSON_SIZE 768
 #endif
+StaticJsonDocument<64> acceptFilter;
 
 // ===== FUNCTION DECLARATIONS =====
 void setupSoftAP();
 void setupWebServer();
-void handleVitals();
-void handleDeviceStatus();
-void handleNotFound();
-void updateDevice(String deviceId, String deviceName, String mac);
+void handleBody(AsyncWebServerRequest* request, uint8_t* data, size_t length, size_t index, size_t total);
+void handleWithBody(AsyncWebServerRequest* request,
+                    void (*handler)(AsyncWebServerRequest* request, const char* body, size_t length));
+bool isValidVitals(JsonDocument& doc);
+void acceptVitals(AsyncWebServerRequest* request, const char* body, size_t length);
+void acceptVitalsBatch(AsyncWebServerRequest* request, const char* body, size_t length);
+void acceptDeviceStatus(AsyncWebServerRequest* request, const char* body, size_t length);
+void handleVitals(AsyncWebServerRequest* request);
+void handleVitalsBatch(AsyncWebServerRequest* request);
+void handleDeviceStatus(AsyncWebServerRequest* request);
+void handleNotFound(AsyncWebServerRequest* request);
+void onStreamEvent(AsyncWebSocket* socket, AsyncWebSocketClient* client, AwsEventType type,
+                   void* arg, uint8_t* data, size_t length);
+void pumpReadingStream();
+void handleMetrics(AsyncWebServerRequest* request);
+void handleDevicesSnapshot(AsyncWebServerRequest* request);
+void handleChanges(AsyncWebServerRequest* request);
+void processInbox();
+void processVitals(const InboxItem& item);
+void processDeviceStatus(const InboxItem& item);
+void handleWireUdp();
+void processStationEvents();
+RegistryDevice* updateDevice(const char* deviceId, const char* deviceName, const char* mac);
+bool isDuplicateReading(RegistryDevice* device, uint32_t epoch, uint32_t seq, const char* name);
+void noteSeqEpoch(RegistryDevice* device, uint32_t epoch, const char* name);
+bool readingFromJson(JsonDocument& doc, const char* deviceType, WireReading& reading);
 void cleanupOfflineDevices();
-void sendToSerial(String jsonString);
+void printOfflineDevice(const RegistryDevice& device);
+void sendToSerial(const char* json, size_t length);
 void printDeviceList();
 void setupLEDs();
 void updateRedLED();
 void blinkGreenLED();
+void updateGreenLED();
 int getOnlineDeviceCount();
+uint32_t getHeapMinFree();
+uint32_t getHeapMaxBlock();
+void formatIP(uint32_t ip, char* out, size_t size);
 
 // ===== SETUP =====
 void setup() {
-  Serial.begin(115200);
+  Serial.begin(SERIAL_BAUD);
   delay(100);
+  SerialLink_begin();  // แจ้งแอปให้เริ่มนับ seq ใหม่
   Serial.println("\n=============================");
   Serial.print("=== ");
   Serial.print(BOARD_TYPE);
@@ -112,6 +238,10 @@ void setup() {
     WiFi.onEvent(WiFiAPStationConnected, ARDUINO_EVENT_WIFI_AP_STACONNECTED);
     WiFi.onEvent(WiFiAPStationDisconnected, ARDUINO_EVENT_WIFI_AP_STADISCONNECTED);
     Serial.println("✓ WiFi event handlers registered");
+  #elif defined(ESP8266)
+    stationConnectedHandler = WiFi.onSoftAPModeStationConnected(WiFiAPStationConnected);
+    stationDisconnectedHandler = WiFi.onSoftAPModeStationDisconnected(WiFiAPStationDisconnected);
+    Serial.println("✓ WiFi event handlers registered");
   #endif
   
   // เริ่ม Soft AP พร้อม IP ที่กำหนด
@@ -120,6 +250,9 @@ void setup() {
   // ตั้งค่า LED
   setupLEDs();
   
+  // รายชื่ออุปกรณ์ (hash table ตาม MAC + timer wheel สำหรับ DEVICE_TIMEOUT)
+  Registry_begin(DEVICE_TIMEOUT, millis());
+  
   // แสดง MAC Address
   macAddress = WiFi.softAPmacAddress();
   Serial.print("Center MAC Address: ");
@@ -128,6 +261,10 @@ void setup() {
   // เริ่มต้น Web Server
   setupWebServer();
   
+  // เริ่มรับข้อมูล Binary ผ่าน UDP
+  wireUdp.begin(WIRE_UDP_PORT);
+  Serial.printf("✓ Binary protocol listening on UDP %d\n", WIRE_UDP_PORT);
+  
   Serial.println("\n=== Center Configuration ===");
   Serial.print("Board: ");
   Serial.println(BOARD_TYPE);
@@ -142,28 +279,49 @@ void setup() {
   Serial.println("Center ready! Waiting for device connections...");
   Serial.println("API Endpoints:");
   Serial.println("  POST /api/vitals - Receive vitals data");
+  Serial.println("  POST /api/vitals/batch - Receive array of vitals data");
   Serial.println("  POST /api/status - Receive device status");
+  Serial.println("  GET  /api/metrics - Latency histograms per device");
+  Serial.println("  GET  /api/devices - Latest reading of each device");
+  Serial.println("  GET  /api/changes?since=<generation> - Readings updated since generation");
+  Serial.println("  WS   /ws - Push each accepted reading (same JSON as Serial)");
+  Serial.printf("  UDP  %d - Binary readings + heartbeat (WireProtocol v%d)\n", WIRE_UDP_PORT, WIRE_VERSION);
 }
 
 // ===== LOOP =====
 void loop() {
-  // จัดการ HTTP requests
-  server.handleClient();
+  // ประมวลผลข้อมูลที่ HTTP handler ใส่คิวไว้ (Serial log, [DATA], LED)
+  processInbox();
+  
+  // รับ ACK/NACK จากคอมพิวเตอร์ และส่ง frame ที่ค้างซ้ำ
+  SerialLink_poll();
+  
+  // จัดการข้อมูล Binary (UDP) และ heartbeat
+  handleWireUdp();
+  
+  // ส่ง reading ใหม่ให้ client ของ /ws
+  pumpReadingStream();
+  
+  // อุปกรณ์ต่อ/หลุดจาก AP
+  processStationEvents();
   
   // อัพเดท LED แดง - กระพริบตามจำนวนอุปกรณ์
   updateRedLED();
+  updateGreenLED();
+  
+  // ทยอยส่ง log ออก Serial เท่าที่ TX FIFO ว่าง (ระหว่าง frame เท่านั้น)
+  Log_drain();
   
   // แสดงสถานะ AP ทุก 5 วินาที
   static unsigned long lastClientCheck = 0;
   if (millis() - lastClientCheck > 5000) {
-    Serial.println("\n========================================");
-    Serial.println("📊 AP STATUS CHECK");
-    Serial.println("========================================");
+    LOG_I("\n========================================\n");
+    LOG_I("📊 AP STATUS CHECK\n");
+    LOG_I("========================================\n");
     
     // วิธีที่ 1: softAPgetStationNum()
     int clientCount = WiFi.softAPgetStationNum();
-    Serial.print("Method 1 - softAPgetStationNum(): ");
-    Serial.println(clientCount);
+    LOG_I("Method 1 - softAPgetStationNum(): %d\n", clientCount);
     
     #ifdef ESP32
       // วิธีที่ 2: esp_wifi API (ESP32 only)
@@ -171,54 +329,68 @@ void loop() {
       memset(&wifi_sta_list, 0, sizeof(wifi_sta_list));
       
       esp_wifi_ap_get_sta_list(&wifi_sta_list);
-      Serial.print("Method 2 - esp_wifi_ap_get_sta_list(): ");
-      Serial.print(wifi_sta_list.num);
-      Serial.println(" stations");
+      LOG_I("Method 2 - esp_wifi_ap_get_sta_list(): %d stations\n", wifi_sta_list.num);
       
       if (wifi_sta_list.num > 0) {
-        Serial.println("\n🔍 Connected Stations:");
+        LOG_I("\n🔍 Connected Stations:\n");
         for (int i = 0; i < wifi_sta_list.num; i++) {
-          Serial.print("  Station ");
-          Serial.print(i + 1);
-          Serial.print(": ");
-          for (int j = 0; j < 6; j++) {
-            Serial.printf("%02X", wifi_sta_list.sta[i].mac[j]);
-            if (j < 5) Serial.print(":");
-          }
-          Serial.println();
+          const uint8_t* mac = wifi_sta_list.sta[i].mac;
+          LOG_I("  Station %d: %02X:%02X:%02X:%02X:%02X:%02X\n",
+                i + 1, mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
         }
       }
     #endif
     
     // แสดงสถานะ AP
-    Serial.print("AP SSID: ");
-    Serial.println(WiFi.softAPSSID());
-    Serial.print("AP IP: ");
-    Serial.println(WiFi.softAPIP());
-    Serial.print("AP Running: ");
-    Serial.println(WiFi.getMode() == WIFI_AP || WiFi.getMode() == WIFI_AP_STA ? "YES" : "NO");
+    LOG_I("AP SSID: %s\n", WiFi.softAPSSID().c_str());
+    LOG_I("AP IP: %s\n", WiFi.softAPIP().toString().c_str());
+    LOG_I("AP Running: %s\n", WiFi.getMode() == WIFI_AP || WiFi.getMode() == WIFI_AP_STA ? "YES" : "NO");
+    LOG_I("HTTP Inbox: %u/%d (สูงสุด %u) | ทิ้ง (คิวเต็ม): %lu | reading ซ้ำ (ไม่ส่งต่อ): %lu\n",
+          Inbox_size(), INBOX_CAPACITY, Inbox_getHighWater(), Inbox_getDroppedCount(),
+          duplicateReadingCount);
+    LOG_I("Serial Link: ส่ง %lu | รอ ACK %u | ส่งซ้ำ %lu | เขียนทับก่อน ACK %lu | frame เสียจาก PC %lu | ใหญ่เกิน %lu\n",
+          serialLinkFramesSent, SerialLink_getPendingCount(), serialLinkRetransmits,
+          serialLinkOverwritten, serialLinkBadFrames, serialLinkTooLarge);
+    char forward[48], handle[48];
+    Histogram_summary(histForwardUs, forward, sizeof(forward));
+    Histogram_summary(histHandleUs, handle, sizeof(handle));
+    LOG_I("Latency [n,p50,p95,max]: รับ → Serial %s us | ประมวลผล %s us\n", forward, handle);
+    LOG_I("Heap: ว่าง %lu | ต่ำสุด %lu | ก้อนใหญ่สุด %lu | Body slot สูงสุด %lu/%d ไม่ว่าง %lu\n",
+          (unsigned long)ESP.getFreeHeap(), (unsigned long)getHeapMinFree(),
+          (unsigned long)getHeapMaxBlock(), (unsigned long)bodyArenaHighWater, BODY_ARENA_SLOTS,
+          (unsigned long)bodyArenaBusyCount);
+    LOG_I("Log: ค้าง %u bytes | ทิ้ง %lu ข้อความ\n", (unsigned)Log_pending(), logDroppedCount);
+    char stream[48];
+    Histogram_summary(histStreamUs, stream, sizeof(stream));
+    LOG_I("WebSocket: client %d/%d | ส่ง %lu | ตัด (ช้า) %lu | ไม่รับ (เต็ม) %lu | latency %s us\n",
+          ReadingStream_clientCount(), STREAM_MAX_CLIENTS, (unsigned long)streamSent,
+          (unsigned long)streamSlowDropped, (unsigned long)streamRejected, stream);
+    streamSocket.cleanupClients();
     
     if (clientCount > 0) {
-      Serial.println("\n✅ Clients detected! Listening for HTTP requests...");
+      LOG_I("\n✅ Clients detected! Listening for HTTP requests...\n");
     } else {
-      Serial.println("\n⚠️  No clients detected");
-      Serial.println("   Troubleshooting:");
-      Serial.println("   1. Check Device is powered on");
-      Serial.println("   2. Check password matches: Abc123**");
-      Serial.println("   3. Check WiFi channel compatibility");
+      LOG_W("\n⚠️  No clients detected\n");
+      LOG_I("   Troubleshooting:\n");
+      LOG_I("   1. Check Device is powered on\n");
+      LOG_I("   2. Check password matches: Abc123**\n");
+      LOG_I("   3. Check WiFi channel compatibility\n");
     }
-    Serial.println("========================================\n");
+    LOG_I("========================================\n\n");
     
     lastClientCheck = millis();
   }
   
-  // ทำความสะอาดอุปกรณ์ที่ออฟไลน์
-  if (millis() - lastCleanup > CLEANUP_INTERVAL) {
-    cleanupOfflineDevices();
-    lastCleanup = millis();
-  }
+  // ทำความสะอาดอุปกรณ์ที่ออฟไลน์ (timer wheel - ทำงานจริงเฉพาะเมื่อข้าม tick)
+  cleanupOfflineDevices();
   
-  delay(10);
+  // ยังมีงานค้าง → แค่ yield() แล้ววนต่อทันที (delay(10) เดิมเพิ่ม latency ได้ถึง 10 ms ต่อ reading)
+  // ว่าง → delay(1) ให้ idle task / WiFi stack ได้ทำงาน
+  if (Inbox_size() > 0 || Log_pending() > 0) {
+    yield();
+  } else {
+    delay(1);
+  }
 }
 
 // ===== SETUP SOFT AP =====
@@ -280,363 +452,983 @@ void setupSoftAP() {
 
 // ===== SETUP WEB SERVER =====
 void setupWebServer() {
-  // กำหนด API endpoints
-  server.on("/api/vitals", HTTP_POST, handleVitals);
-  server.on("/api/status", HTTP_POST, handleDeviceStatus);
+  // field ที่ accept handler ตรวจ (data เป็น object ว่าง = ตรวจว่าเป็น object แต่ไม่เก็บค่า)
+  acceptFilter["deviceId"] = true;
+  acceptFilter["deviceType"] = true;
+  acceptFilter.createNestedObject("data");
+  
+  // กำหนด API endpoints (body มาทาง handleBody ก่อน แล้วจึงเรียก handler)
+  server.on("/api/vitals", HTTP_POST, handleVitals, nullptr, handleBody);
+  server.on("/api/vitals/batch", HTTP_POST, handleVitalsBatch, nullptr, handleBody);
+  server.on("/api/status", HTTP_POST, handleDeviceStatus, nullptr, handleBody);
+  server.on("/api/metrics", HTTP_GET, handleMetrics);
+  server.on("/api/devices", HTTP_GET, handleDevicesSnapshot);
+  server.on("/api/changes", HTTP_GET, handleChanges);
+  streamSocket.onEvent(onStreamEvent);
+  server.addHandler(&streamSocket);
   server.onNotFound(handleNotFound);
   
   // เริ่ม server
   server.begin();
-  Serial.println("✓ HTTP Server started on port 80");
+  Serial.println("✓ Async HTTP Server started on port 80");
+}
+
+// ===== รับ HTTP body (อาจมาหลาย chunk) =====
+// เก็บใน BodyArena (buffer คงที่) - ไม่ malloc() ต่อ request
+void handleBody(AsyncWebServerRequest* request, uint8_t* data, size_t length, size_t index, size_t total) {
+  if (index == 0) {
+    if (total > MAX_BODY_SIZE) {
+      return;  // handler จะตอบ 413
+    }
+    BodyArena_claim(request, total, millis());
+  }
+  
+  BodySlot* slot = BodyArena_find(request);
+  if (slot != nullptr) {
+    BodyArena_write(*slot, data, length, index);
+  }
+}
+
+// คืน body ของ request หรือ nullptr (ตอบ error ให้แล้ว)
+const char* getRequestBody(AsyncWebServerRequest* request, size_t& length) {
+  length = request->contentLength();
+  if (length > MAX_BODY_SIZE) {
+    request->send(413, "application/json", "{\"error\":\"Body too large\"}");
+    return nullptr;
+  }
+  BodySlot* slot = BodyArena_find(request);
+  if (length > 0 && slot == nullptr) {
+    // slot เต็ม → device จะ retry ตาม backoff
+    request->send(503, "application/json", "{\"error\":\"Center busy\"}");
+    return nullptr;
+  }
+  if (length == 0 || !BodyArena_complete(*slot)) {
+    request->send(400, "application/json", "{\"error\":\"No data received\"}");
+    return nullptr;
+  }
+  return slot->data;
+}
+
+// ===== POST handlers (network task) =====
+// body อยู่ใน BodyArena ระหว่างที่ handler ทำงาน แล้วคืน slot ทุกครั้ง (ทั้งตอบสำเร็จและ error)
+void handleWithBody(AsyncWebServerRequest* request,
+                    void (*handler)(AsyncWebServerRequest* request, const char* body, size_t length)) {
+  size_t length;
+  const char* body = getRequestBody(request, length);
+  if (body != nullptr) {
+    handler(request, body, length);
+  }
+  BodyArena_release(request);
+}
+
+void handleVitals(AsyncWebServerRequest* request) {
+  handleWithBody(request, acceptVitals);
+}
+
+void handleVitalsBatch(AsyncWebServerRequest* request) {
+  handleWithBody(request, acceptVitalsBatch);
+}
+
+void handleDeviceStatus(AsyncWebServerRequest* request) {
+  handleWithBody(request, acceptDeviceStatus);
+}
+
+// ===== ตรวจ payload ของ vitals (network task) =====
+// ใช้ร่วมกันระหว่าง /api/vitals และแต่ละ element ของ /api/vitals/batch → รับ/ไม่รับด้วยเกณฑ์เดียวกัน
+// ต้องมี deviceId (ไม่ว่าง), deviceType และ data เป็น object (doc ผ่าน acceptFilter มาแล้ว)
+bool isValidVitals(JsonDocument& doc) {
+  const char* deviceId = doc["deviceId"];
+  const char* deviceType = doc["deviceType"];
+  return deviceId != nullptr && deviceId[0] != '\0' &&
+         deviceType != nullptr && doc["data"].is<JsonObject>();
 }
 
-// ===== HANDLE VITALS DATA =====
-void handleVitals() {
-  if (server.hasArg("plain") == false) {
-    server.send(400, "application/json", "{\"error\":\"No data received\"}");
+// ===== HANDLE VITALS DATA (network task) =====
+// ตรวจ JSON แล้วเข้าคิว ตอบทันทีโดยไม่รอ Serial/LED (ประมวลผลต่อใน processVitals)
+void acceptVitals(AsyncWebServerRequest* request, const char* body, size_t length) {
+  if (length >= INBOX_BODY_SIZE) {
+    request->send(413, "application/json", "{\"error\":\"Body too large\"}");
     return;
   }
   
-  String body = server.arg("plain");
+  StaticJsonDocument<ACCEPT_JSON_SIZE> doc;
+  if (deserializeJson(doc, body, length, DeserializationOption::Filter(acceptFilter))) {
+    request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+    return;
+  }
   
-  Serial.println("\n========================================");
-  Serial.println("📥 VITALS DATA RECEIVED");
-  Serial.println("========================================");
-  Serial.print("From IP: ");
-  Serial.println(server.client().remoteIP());
-  Serial.println("\n--- RAW JSON DATA ---");
-  Serial.println(body);
-  Serial.println("--- END RAW DATA ---\n");
+  if (!isValidVitals(doc)) {
+    request->send(400, "application/json", "{\"error\":\"Missing deviceId, deviceType or data\"}");
+    return;
+  }
   
-  // Parse JSON
-  #ifdef ESP32
-    StaticJsonDocument<512> doc;
-  #else
-    StaticJsonDocument<256> doc;
-  #endif
+  if (!Inbox_push(INBOX_VITALS, request->client()->remoteIP(), body, length)) {
+    // คิวเต็ม → device จะ retry ตาม backoff
+    request->send(503, "application/json", "{\"error\":\"Center busy\"}");
+    return;
+  }
+  
+  request->send(200, "application/json", "{\"status\":\"ok\",\"message\":\"Data received\"}");
+}
+
+// ===== PROCESS VITALS DATA (loop) =====
+// รายละเอียดทั้งหมด (raw JSON + ค่าที่ parse ได้) อยู่ที่ LOG_D - ระดับ INFO แสดงแค่บรรทัดเดียวต่อ reading
+void processVitals(const InboxItem& item) {
+  unsigned long start = micros();
+  const char* body = item.body;
+  char ip[16];
+  formatIP(item.remoteIP, ip, sizeof(ip));
+  
+  LOG_D("\n========================================\n");
+  LOG_D("📥 VITALS DATA RECEIVED\n");
+  LOG_D("========================================\n");
+  LOG_D("From IP: %s\n", ip);
+  LOG_D("\n--- RAW JSON DATA ---\n");
+  LOG_D("%s\n", body);
+  LOG_D("--- END RAW DATA ---\n\n");
   
-  DeserializationError error = deserializeJson(doc, body);
+  // Parse JSON (string ถูก copy จาก body)
+  StaticJsonDocument<VITALS_JSON_SIZE> doc;
+  
+  DeserializationError error = deserializeJson(doc, body, item.length);
   
   if (error) {
-    Serial.print("❌ JSON parse error: ");
-    Serial.println(error.c_str());
-    Serial.println("========================================\n");
-    server.send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+    LOG_E("❌ JSON parse error: %s\n", error.c_str());
     return;
   }
   
-  // ดึงข้อมูลอุปกรณ์
-  String deviceId = doc["deviceId"].as<String>();
-  String deviceName = doc["deviceName"].as<String>();
-  String mac = doc["macAddress"].as<String>();
-  String deviceType = doc["deviceType"].as<String>();
-  String idcard = doc["idcard"].as<String>();
+  // ดึงข้อมูลอุปกรณ์ (ชี้เข้าไปใน doc - ไม่ copy เป็น String)
+  const char* deviceId = doc["deviceId"] | "";
+  const char* deviceName = doc["deviceName"] | "";
+  const char* mac = doc["macAddress"] | "";
+  const char* deviceType = doc["deviceType"] | "";
+  const char* idcard = doc["idcard"] | "";
+  
+  LOG_I("📥 VITALS: %s (%s) %s\n", deviceName, deviceType, ip);
   
   // แสดงข้อมูลแบบละเอียด
-  Serial.println("--- PARSED DATA ---");
-  Serial.print("  Device ID:   ");
-  Serial.println(deviceId);
-  Serial.print("  Device Name: ");
-  Serial.println(deviceName);
-  Serial.print("  MAC Address: ");
-  Serial.println(mac);
-  Serial.print("  Device Type: ");
-  Serial.println(deviceType);
-  Serial.print("  ID Card:     ");
-  Serial.println(idcard);
+  LOG_D("--- PARSED DATA ---\n");
+  LOG_D("  Device ID:   %s\n", deviceId);
+  LOG_D("  Device Name: %s\n", deviceName);
+  LOG_D("  MAC Address: %s\n", mac);
+  LOG_D("  Device Type: %s\n", deviceType);
+  LOG_D("  ID Card:     %s\n", idcard);
   
   // Handle combined measurements (weight_height, blood_pressure)
-  if (deviceType == "weight_height") {
-    float weight = doc["data"]["weight"].as<float>();
-    float height = doc["data"]["height"].as<float>();
-    unsigned long timestamp = doc["data"]["timestamp"].as<unsigned long>();
-    
-    Serial.print("  Weight:      ");
-    Serial.print(weight);
-    Serial.println(" kg");
-    Serial.print("  Height:      ");
-    Serial.print(height);
-    Serial.println(" cm");
-    Serial.print("  Timestamp:   ");
-    Serial.println(timestamp);
-  }
-  else if (deviceType == "blood_pressure") {
-    int bp = doc["data"]["bp"].as<int>();
-    int bp2 = doc["data"]["bp2"].as<int>();
-    int pulse = doc["data"]["pulse"].as<int>();
-    unsigned long timestamp = doc["data"]["timestamp"].as<unsigned long>();
-    
-    Serial.print("  BP:          ");
-    Serial.print(bp);
-    Serial.print("/");
-    Serial.print(bp2);
-    Serial.println(" mmHg");
-    Serial.print("  Pulse:       ");
-    Serial.print(pulse);
-    Serial.println(" bpm");
-    Serial.print("  Timestamp:   ");
-    Serial.println(timestamp);
+  if (strcmp(deviceType, "weight_height") == 0) {
+    LOG_D("  Weight:      %.2f kg\n", doc["data"]["weight"].as<float>());
+    LOG_D("  Height:      %.2f cm\n", doc["data"]["height"].as<float>());
+  }
+  else if (strcmp(deviceType, "blood_pressure") == 0) {
+    LOG_D("  BP:          %d/%d mmHg\n", doc["data"]["bp"].as<int>(), doc["data"]["bp2"].as<int>());
+    LOG_D("  Pulse:       %d bpm\n", doc["data"]["pulse"].as<int>());
   }
   else {
-    // Single value measurement
-    float value = doc["data"]["value"].as<float>();
-    unsigned long timestamp = doc["data"]["timestamp"].as<unsigned long>();
+    // Single value measurement - แสดงหน่วยตามประเภทข้อมูล
+    const char* unit = "";
+    if (strcmp(deviceType, "bp") == 0 || strcmp(deviceType, "bp2") == 0) {
+      unit = " mmHg";
+    } else if (strcmp(deviceType, "temp") == 0) {
+      unit = " °C";
+    } else if (strcmp(deviceType, "pulse") == 0) {
+      unit = " bpm";
+    } else if (strcmp(deviceType, "spo2") == 0) {
+      unit = " %";
+    }
+    LOG_D("  Value:       %.2f%s\n", doc["data"]["value"].as<float>(), unit);
+  }
+  LOG_D("  Timestamp:   %lu\n", doc["data"]["timestamp"].as<unsigned long>());
+  LOG_D("--- END PARSED DATA ---\n");
+  
+  // อัพเดทสถานะอุปกรณ์
+  RegistryDevice* device = updateDevice(deviceId, deviceName, mac);
+  
+  // ส่งซ้ำเพราะ POST หมดเวลา / ส่งซ้ำจาก Journal → ตอบ 200 ไปแล้ว แค่ไม่ส่งต่อ
+  uint32_t seq = doc["seq"] | 0UL;
+  uint32_t epoch = doc["epoch"] | 0UL;
+  if (isDuplicateReading(device, epoch, seq, deviceName)) {
+    return;
+  }
+  if (device != nullptr) {
+    deviceMetrics[device - registryDevices].readings++;
+    WireReading reading;
+    if (readingFromJson(doc, deviceType, reading)) {
+      Cache_store(device - registryDevices, reading, seq, millis());
+    }
+  }
+  
+  // กระพริบ LED เขียว เมื่อได้รับข้อมูล
+  blinkGreenLED();
+  
+  // ส่งข้อมูลไปยัง Serial (คอมพิวเตอร์จะอ่าน) และ client ของ /ws
+  sendToSerial(body, item.length);
+  ReadingStream_publish(body, item.length, micros());
+  
+  LOG_D("✅ Data processed successfully\n");
+  LOG_D("========================================\n\n");
+  
+  unsigned long end = micros();
+  Histogram_add(histHandleUs, end - start);
+  Histogram_add(histForwardUs, end - item.receivedAt);
+}
+
+// ===== HANDLE VITALS BATCH (network task) =====
+// Body เป็น JSON array ของ payload แบบเดียวกับ /api/vitals
+// parse ทีละ element ด้วย JsonDocument ตัวเดียว → memory คงที่ไม่ว่า batch จะใหญ่แค่ไหน
+// element ที่ถูกต้องเข้าคิวทีละรายการ (ประมวลผลต่อใน processVitals)
+// Response: {"status":"ok","accepted":N,"rejected":N,"results":[1,0,...]} (1 = รับ, 0 = ไม่รับ)
+// element ที่ไม่อยู่ใน results (parse ไม่ได้ / เกิน BATCH_MAX_ITEMS / คิวเต็ม) ให้ device ส่งใหม่
+void acceptVitalsBatch(AsyncWebServerRequest* request, const char* body, size_t length) {
+  BodyStream stream(body, length);
+  
+  if (stream.peekToken() != '[') {
+    request->send(400, "application/json", "{\"error\":\"Expected JSON array\"}");
+    return;
+  }
+  stream.read();
+  
+  StaticJsonDocument<ACCEPT_JSON_SIZE> doc;
+  uint32_t remoteIP = request->client()->remoteIP();
+  char results[BATCH_MAX_ITEMS * 2 + 1];
+  int resultLength = 0;
+  int accepted = 0;
+  int rejected = 0;
+  const char* error = nullptr;
+  bool busy = false;
+  
+  while (stream.peekToken() != ']') {
+    if (accepted + rejected >= BATCH_MAX_ITEMS) {
+      error = "Too many items";
+      break;
+    }
+    
+    size_t start = stream.position();
+    DeserializationError parseError = deserializeJson(doc, stream, DeserializationOption::Filter(acceptFilter));
+    if (parseError) {
+      // ตำแหน่งใน stream ไม่แน่นอนแล้ว → หยุด (element ที่เหลือให้ device ส่งใหม่)
+      error = "Invalid JSON";
+      break;
+    }
+    size_t end = stream.position();
     
-    Serial.print("  Value:       ");
-    Serial.print(value);
+    bool ok = isValidVitals(doc) && end - start < INBOX_BODY_SIZE;
     
-    // แสดงหน่วยตามประเภทข้อมูล
-    if (deviceType == "bp" || deviceType == "bp2") {
-      Serial.println(" mmHg");
-    } else if (deviceType == "temp") {
-      Serial.println(" °C");
-    } else if (deviceType == "pulse") {
-      Serial.println(" bpm");
-    } else if (deviceType == "spo2") {
-      Serial.println(" %");
+    if (ok && !Inbox_push(INBOX_VITALS, remoteIP, body + start, end - start)) {
+      // คิวเต็ม → element นี้และที่เหลือไม่อยู่ใน results ให้ device ส่งใหม่
+      error = "Center busy";
+      busy = true;
+      break;
+    }
+    if (ok) {
+      accepted++;
     } else {
-      Serial.println();
+      rejected++;
     }
     
-    Serial.print("  Timestamp:   ");
-    Serial.println(timestamp);
+    if (resultLength > 0) {
+      results[resultLength++] = ',';
+    }
+    results[resultLength++] = ok ? '1' : '0';
+    
+    // ข้าม ',' ระหว่าง element
+    if (stream.peekToken() == ',') {
+      stream.read();
+    } else if (stream.peek() != ']') {
+      error = "Expected ',' or ']'";
+      break;
+    }
   }
+  results[resultLength] = '\0';
   
-  Serial.println("--- END PARSED DATA ---");
+  if (accepted + rejected == 0 && error != nullptr) {
+    if (busy) {
+      request->send(503, "application/json", "{\"error\":\"Center busy\"}");
+    } else {
+      request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+    }
+    return;
+  }
   
-  // อัพเดทสถานะอุปกรณ์
-  updateDevice(deviceId, deviceName, mac);
+  char response[96 + sizeof(results)];
+  if (error != nullptr) {
+    snprintf(response, sizeof(response),
+             "{\"status\":\"partial\",\"accepted\":%d,\"rejected\":%d,\"results\":[%s],\"error\":\"%s\"}",
+             accepted, rejected, results, error);
+  } else {
+    snprintf(response, sizeof(response),
+             "{\"status\":\"ok\",\"accepted\":%d,\"rejected\":%d,\"results\":[%s]}",
+             accepted, rejected, results);
+  }
+  request->send(200, "application/json", response);
+}
+
+// ===== BINARY PROTOCOL: หา session =====
+WireSession* findWireSession(uint16_t session) {
+  for (int i = 0; i < WIRE_MAX_SESSIONS; i++) {
+    if (wireSessions[i].used && wireSessions[i].session == session) {
+      return &wireSessions[i];
+    }
+  }
+  return nullptr;
+}
+
+// ===== BINARY PROTOCOL: ลงทะเบียน session จาก HELLO =====
+WireSession* registerWireSession(uint16_t session, const WireHello& hello) {
+  char mac[18];
+  snprintf(mac, sizeof(mac), "%02X:%02X:%02X:%02X:%02X:%02X",
+           hello.mac[0], hello.mac[1], hello.mac[2], hello.mac[3], hello.mac[4], hello.mac[5]);
   
-  // กระพริบ LED เขียว เมื่อได้รับข้อมูล
-  blinkGreenLED();
+  // อุปกรณ์เดิม (reboot แล้วได้ session ใหม่) → ใช้ช่องเดิม
+  WireSession* slot = nullptr;
+  for (int i = 0; i < WIRE_MAX_SESSIONS && slot == nullptr; i++) {
+    if (wireSessions[i].used && strcmp(wireSessions[i].mac, mac) == 0) {
+      slot = &wireSessions[i];
+    }
+  }
+  for (int i = 0; i < WIRE_MAX_SESSIONS && slot == nullptr; i++) {
+    if (!wireSessions[i].used) {
+      slot = &wireSessions[i];
+    }
+  }
+  if (slot == nullptr) {
+    // เต็ม → แทนที่แบบวนรอบ (อุปกรณ์ที่ถูกแทนจะได้ UNKNOWN_SESSION แล้วส่ง HELLO ใหม่)
+    slot = &wireSessions[wireNextEvict];
+    wireNextEvict = (wireNextEvict + 1) % WIRE_MAX_SESSIONS;
+  }
   
-  // ส่งข้อมูลไปยัง Serial (คอมพิวเตอร์จะอ่าน)
-  sendToSerial(body);
+  slot->used = true;
+  slot->session = session;
+  strlcpy(slot->mac, mac, sizeof(slot->mac));
+  strlcpy(slot->name, hello.name, sizeof(slot->name));
+  slot->epoch = hello.epoch;
+  return slot;
+}
+
+// ===== BINARY PROTOCOL: แปลง reading เป็น JSON แบบเดียวกับ /api/vitals =====
+void sendWireReadingToSerial(const WireSession& session, const WireReading& reading) {
+  StaticJsonDocument<VITALS_JSON_SIZE> doc;
+  doc["deviceId"] = session.mac;
+  doc["deviceName"] = session.name;
+  doc["macAddress"] = session.mac;
+  
+  char idcard[24] = "";
+  if (reading.fields & WIRE_FIELD_IDCARD) {
+    Wire_idcardToString(reading.idcard, idcard, sizeof(idcard));
+  }
   
-  Serial.println("✅ Data processed successfully");
-  Serial.println("========================================\n");
+  JsonObject data;
+  switch (reading.kind) {
+    case WIRE_KIND_BLOOD_PRESSURE:
+      doc["deviceType"] = "blood_pressure";
+      doc["idcard"] = idcard;
+      data = doc.createNestedObject("data");
+      if (reading.fields & WIRE_FIELD_VALUE0) data["bp"] = reading.values[0];
+      if (reading.fields & WIRE_FIELD_VALUE1) data["bp2"] = reading.values[1];
+      if (reading.fields & WIRE_FIELD_VALUE2) data["pulse"] = reading.values[2];
+      break;
+      
+    case WIRE_KIND_WEIGHT_HEIGHT:
+      doc["deviceType"] = "weight_height";
+      doc["idcard"] = idcard;
+      data = doc.createNestedObject("data");
+      if (reading.fields & WIRE_FIELD_VALUE0) data["weight"] = reading.values[0] / 10.0;
+      if (reading.fields & WIRE_FIELD_VALUE1) data["height"] = reading.values[1] / 10.0;
+      if (reading.fields & WIRE_FIELD_VALUE2) data["temp"] = reading.values[2] / 10.0;
+      break;
+      
+    default:
+      doc["deviceType"] = reading.kind == WIRE_KIND_TEMP ? "temp" :
+                          reading.kind == WIRE_KIND_WEIGHT ? "weight" : "height";
+      doc["idcard"] = idcard;
+      data = doc.createNestedObject("data");
+      data["value"] = reading.values[0] / 10.0;
+      break;
+  }
+  data["timestamp"] = reading.timestamp;
   
-  // ส่ง response กลับ
-  server.send(200, "application/json", "{\"status\":\"ok\",\"message\":\"Data received\"}");
+  char json[384];
+  size_t length = serializeJson(doc, json, sizeof(json));
+  sendToSerial(json, length);
+  ReadingStream_publish(json, length, micros());
 }
 
-// ===== HANDLE DEVICE STATUS =====
-void handleDeviceStatus() {
-  if (server.hasArg("plain") == false) {
-    server.send(400, "application/json", "{\"error\":\"No data received\"}");
+// ===== BINARY PROTOCOL: รับ frame จาก UDP =====
+void sendWireAck(uint16_t session, uint32_t seq, uint8_t status) {
+  uint8_t frame[WIRE_HEADER_SIZE + WIRE_CRC_SIZE];
+  size_t length = Wire_encodeAck(frame, session, seq, status);
+  wireUdp.beginPacket(wireUdp.remoteIP(), wireUdp.remotePort());
+  wireUdp.write(frame, length);
+  wireUdp.endPacket();
+}
+
+void handleWireUdp() {
+  uint8_t frame[WIRE_MAX_FRAME];
+  
+  while (wireUdp.parsePacket() > 0) {
+    unsigned long receivedAt = micros();
+    int length = wireUdp.read(frame, sizeof(frame));
+    WireHeader header;
+    int payloadLength = length > 0 ? Wire_parseFrame(frame, length, header) : -1;
+    if (payloadLength < 0) {
+      wireBadFrameCount++;
+      continue;
+    }
+    const uint8_t* payload = frame + WIRE_HEADER_SIZE;
+    
+    if (header.type == WIRE_MSG_HELLO) {
+      WireHello hello;
+      if (!Wire_decodeHello(payload, payloadLength, hello)) {
+        sendWireAck(header.session, 0, WIRE_ACK_REJECTED);
+        continue;
+      }
+      // session ใหม่ = อุปกรณ์ reboot (HELLO ซ้ำหลัง WiFi หลุดใช้ session เดิม)
+      bool newSession = findWireSession(header.session) == nullptr;
+      WireSession* session = registerWireSession(header.session, hello);
+      LOG_I("🤝 WIRE HELLO: %s (%s) session %u\n", session->name, session->mac, header.session);
+      RegistryDevice* device = updateDevice(session->mac, session->name, session->mac);
+      if (hello.epoch != 0) {
+        noteSeqEpoch(device, hello.epoch, session->name);
+      } else if (newSession && device != nullptr) {
+        // ไม่มี epoch → seq อาจเริ่มใหม่หลัง reboot ล้าง window ไว้ก่อน (ส่งซ้ำดีกว่าทิ้ง)
+        Dedup_reset(deviceDedup[device - registryDevices]);
+      }
+      sendWireAck(header.session, 0, WIRE_ACK_OK);
+    }
+    else if (header.type == WIRE_MSG_READING) {
+      WireSession* session = findWireSession(header.session);
+      if (session == nullptr) {
+        sendWireAck(header.session, header.seq, WIRE_ACK_UNKNOWN_SESSION);
+        continue;
+      }
+      
+      WireReading reading;
+      if (!Wire_decodeReading(payload, payloadLength, reading)) {
+        sendWireAck(header.session, header.seq, WIRE_ACK_REJECTED);
+        continue;
+      }
+      
+      // ไม่ได้ ACK แล้วส่งซ้ำ → ACK อีกครั้งแต่ไม่ส่งต่อ (seq คงที่เฉพาะเมื่อมี flag)
+      RegistryDevice* device = updateDevice(session->mac, session->name, session->mac);
+      uint32_t durableSeq = (header.status & WIRE_READING_DURABLE_SEQ) ? header.seq : 0;
+      if (isDuplicateReading(device, session->epoch, durableSeq, session->name)) {
+        sendWireAck(header.session, header.seq, WIRE_ACK_OK);
+        continue;
+      }
+      
+      LOG_I("📥 WIRE READING #%lu from %s (seq %lu, %d bytes)\n",
+            wireReadingCount + 1, session->name, (unsigned long)header.seq, length);
+      if (device != nullptr) {
+        deviceMetrics[device - registryDevices].readings++;
+        Cache_store(device - registryDevices, reading, durableSeq, millis());
+      }
+      sendWireReadingToSerial(*session, reading);
+      Histogram_add(histForwardUs, micros() - receivedAt);
+      wireReadingCount++;
+      sendWireAck(header.session, header.seq, WIRE_ACK_OK);
+      blinkGreenLED();
+    }
+    else if (header.type == WIRE_MSG_HEARTBEAT) {
+      uint8_t mac[6];
+      if (!Wire_decodeHeartbeat(payload, payloadLength, mac)) {
+        wireBadFrameCount++;
+        continue;
+      }
+      wireHeartbeatCount++;
+      
+      // อุปกรณ์ที่รู้จักแล้ว → ไม่ตอบ (ประหยัด airtime)
+      // ไม่รู้จัก (Center reboot / ถูกแทนที่ในตาราง) → ขอให้ส่ง /api/status พร้อม ID/ชื่อ
+      bool wasOnline;
+      if (Registry_touch(mac, millis(), wasOnline) == nullptr) {
+        sendWireAck(header.session, 0, WIRE_ACK_UNKNOWN_DEVICE);
+      }
+    }
+  }
+}
+
+// ===== PRESENCE: อุปกรณ์ต่อ/หลุดจาก AP (loop) =====
+// ต่อ AP = ออนไลน์เฉพาะอุปกรณ์ที่รู้จัก / หลุด = ออฟไลน์ทันทีไม่ต้องรอ DEVICE_TIMEOUT
+// (ไฟดับไม่มี event หลุด - ยังออฟไลน์ตาม DEVICE_TIMEOUT เมื่อ heartbeat หยุด)
+void processStationEvents() {
+  StationEvent event;
+  bool changed = false;
+  while (StationEvents_pop(event)) {
+    if (event.connected) {
+      bool wasOnline;
+      RegistryDevice* device = Registry_touch(event.mac, millis(), wasOnline);
+      changed |= device != nullptr && !wasOnline;
+    } else {
+      RegistryDevice* device = Registry_setOffline(event.mac);
+      if (device != nullptr) {
+        printOfflineDevice(*device);
+        changed = true;
+      }
+    }
+  }
+  if (changed) {
+    printDeviceList();
+  }
+}
+
+// ===== HANDLE DEVICE STATUS (network task) =====
+void acceptDeviceStatus(AsyncWebServerRequest* request, const char* body, size_t length) {
+  if (length >= INBOX_BODY_SIZE) {
+    request->send(413, "application/json", "{\"error\":\"Body too large\"}");
+    return;
+  }
+  
+  StaticJsonDocument<ACCEPT_JSON_SIZE> doc;
+  if (deserializeJson(doc, body, length, DeserializationOption::Filter(acceptFilter))) {
+    request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+    return;
+  }
+  
+  if (!Inbox_push(INBOX_STATUS, request->client()->remoteIP(), body, length)) {
+    request->send(503, "application/json", "{\"error\":\"Center busy\"}");
+    return;
+  }
+  
+  request->send(200, "application/json", "{\"status\":\"ok\",\"message\":\"Status received\"}");
+}
+
+// ===== แปลง JSON reading เป็นแบบเดียวกับ Binary (เก็บใน ReadingCache) =====
+// คืน false ถ้าเป็นประเภทที่ไม่ cache (เช่น spo2, glucose)
+void setReadingValue(WireReading& reading, int index, JsonVariant value, bool tenths) {
+  if (value.isNull()) {
     return;
   }
+  reading.values[index] = tenths ? (int16_t)lroundf(value.as<float>() * 10) : value.as<int16_t>();
+  reading.fields |= WIRE_FIELD_VALUE0 << index;
+}
+
+bool readingFromJson(JsonDocument& doc, const char* deviceType, WireReading& reading) {
+  memset(&reading, 0, sizeof(reading));
+  JsonObject data = doc["data"];
+  
+  if (strcmp(deviceType, "blood_pressure") == 0) {
+    reading.kind = WIRE_KIND_BLOOD_PRESSURE;
+    setReadingValue(reading, 0, data["bp"], false);
+    setReadingValue(reading, 1, data["bp2"], false);
+    setReadingValue(reading, 2, data["pulse"], false);
+  } else if (strcmp(deviceType, "weight_height") == 0) {
+    reading.kind = WIRE_KIND_WEIGHT_HEIGHT;
+    setReadingValue(reading, 0, data["weight"], true);
+    setReadingValue(reading, 1, data["height"], true);
+    setReadingValue(reading, 2, data["temp"], true);
+  } else if (strcmp(deviceType, "temp") == 0) {
+    reading.kind = WIRE_KIND_TEMP;
+    setReadingValue(reading, 0, data["value"], true);
+  } else if (strcmp(deviceType, "weight") == 0) {
+    reading.kind = WIRE_KIND_WEIGHT;
+    setReadingValue(reading, 0, data["value"], true);
+  } else if (strcmp(deviceType, "height") == 0) {
+    reading.kind = WIRE_KIND_HEIGHT;
+    setReadingValue(reading, 0, data["value"], true);
+  } else {
+    return false;
+  }
+  
+  reading.idcard = Wire_idcardFromString(doc["idcard"].as<const char*>());
+  if (reading.idcard != 0) {
+    reading.fields |= WIRE_FIELD_IDCARD;
+  }
+  reading.timestamp = data["timestamp"] | 0UL;
+  return true;
+}
+
+// ===== กรอง reading ซ้ำ =====
+// คืน true ถ้าเคยส่งต่อ reading นี้แล้ว (ผู้เรียกตอบรับแต่ไม่ส่งต่อ)
+// device = nullptr (ตารางเต็ม) หรือ seq = 0 → ส่งต่อเสมอ
+// epoch = epoch ของ seq จากอุปกรณ์ (0 = ไม่รู้ → ใช้ระยะห่างของ seq แทน)
+bool isDuplicateReading(RegistryDevice* device, uint32_t epoch, uint32_t seq, const char* name) {
+  if (device == nullptr) {
+    return false;
+  }
+  int index = device - registryDevices;
+  DedupResult result = Dedup_check(deviceDedup[index], epoch, seq);
   
-  String body = server.arg("plain");
+  if (result == DEDUP_DUPLICATE) {
+    deviceMetrics[index].duplicates++;
+    duplicateReadingCount++;
+    LOG_I("♻️  DUPLICATE: %s seq %lu - ส่งต่อไปแล้ว ข้าม\n", name, (unsigned long)seq);
+    return true;
+  }
+  if (result == DEDUP_RESTARTED) {
+    LOG_W("⚠️  %s: seq %lu - อุปกรณ์เริ่มนับ seq ใหม่\n", name, (unsigned long)seq);
+  }
+  return false;
+}
+
+// epoch จาก HELLO / /api/status (ก่อน reading แรกหลัง reboot) → เปลี่ยน = ล้าง window
+void noteSeqEpoch(RegistryDevice* device, uint32_t epoch, const char* name) {
+  if (device == nullptr) {
+    return;
+  }
+  if (Dedup_setEpoch(deviceDedup[device - registryDevices], epoch)) {
+    LOG_W("⚠️  %s: epoch ใหม่ %08lX - อุปกรณ์เริ่มนับ seq ใหม่\n", name, (unsigned long)epoch);
+  }
+}
+
+// ===== METRICS: เก็บสรุปจาก heartbeat ของอุปกรณ์ =====
+void readMetricSummary(JsonVariant value, uint32_t* out) {
+  for (int i = 0; i < METRIC_SUMMARY_SIZE; i++) {
+    out[i] = value[i] | 0UL;
+  }
+}
+
+void storeDeviceMetrics(DeviceMetrics& metrics, JsonObject source) {
+  metrics.reported = true;
+  metrics.reportedAt = millis();
+  metrics.up = source["up"] | 0UL;
+  readMetricSummary(source["frameMs"], metrics.frameMs);
+  readMetricSummary(source["parseUs"], metrics.parseUs);
+  readMetricSummary(source["handleUs"], metrics.handleUs);
+  readMetricSummary(source["deliverMs"], metrics.deliverMs);
+  metrics.retry = source["retry"] | 0UL;
+  metrics.reconnect = source["reconnect"] | 0UL;
+  metrics.dropped = source["dropped"] | 0UL;
+  metrics.overrun = source["overrun"] | 0UL;
+  metrics.baud = source["baud"] | 0UL;
+  metrics.baudLocked = source["baudLocked"] | false;
+  metrics.queueDropped = source["queueDropped"] | 0UL;
+  metrics.heapMin = source["heapMin"] | 0UL;
+  metrics.wifiMs = source["wifiMs"] | 0UL;
+  metrics.reconnectMs = source["reconnectMs"] | 0UL;
+  metrics.firstPostMs = source["firstPostMs"] | 0UL;
+}
+
+// ===== PROCESS DEVICE STATUS (loop) =====
+void processDeviceStatus(const InboxItem& item) {
+  const char* body = item.body;
+  char ip[16];
+  formatIP(item.remoteIP, ip, sizeof(ip));
   
-  Serial.println("\n========================================");
-  Serial.println("📋 DEVICE STATUS RECEIVED");
-  Serial.println("========================================");
-  Serial.print("From IP: ");
-  Serial.println(server.client().remoteIP());
-  Serial.println("\n--- RAW JSON DATA ---");
-  Serial.println(body);
-  Serial.println("--- END RAW DATA ---\n");
+  LOG_D("\n========================================\n");
+  LOG_D("📋 DEVICE STATUS RECEIVED\n");
+  LOG_D("========================================\n");
+  LOG_D("From IP: %s\n", ip);
+  LOG_D("\n--- RAW JSON DATA ---\n");
+  LOG_D("%s\n", body);
+  LOG_D("--- END RAW DATA ---\n\n");
   
   // Parse JSON
-  #ifdef ESP32
-    StaticJsonDocument<512> doc;
-  #else
-    StaticJsonDocument<256> doc;
-  #endif
+  StaticJsonDocument<STATUS_JSON_SIZE> doc;
   
-  DeserializationError error = deserializeJson(doc, body);
+  DeserializationError error = deserializeJson(doc, body, item.length);
   
   if (error) {
-    Serial.print("❌ JSON parse error: ");
-    Serial.println(error.c_str());
-    Serial.println("========================================\n");
-    server.send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+    LOG_E("❌ JSON parse error: %s\n", error.c_str());
     return;
   }
   
-  // ดึงข้อมูลอุปกรณ์
-  String deviceId = doc["deviceId"].as<String>();
-  String deviceName = doc["deviceName"].as<String>();
-  String mac = doc["macAddress"].as<String>();
+  // ดึงข้อมูลอุปกรณ์ (ชี้เข้าไปใน doc - ไม่ copy เป็น String)
+  const char* deviceId = doc["deviceId"] | "";
+  const char* deviceName = doc["deviceName"] | "";
+  const char* mac = doc["macAddress"] | "";
   unsigned long timestamp = doc["timestamp"].as<unsigned long>();
   
   // แสดงข้อมูลแบบละเอียด
-  Serial.println("--- PARSED DATA ---");
-  Serial.print("  Device ID:   ");
-  Serial.println(deviceId);
-  Serial.print("  Device Name: ");
-  Serial.println(deviceName);
-  Serial.print("  MAC Address: ");
-  Serial.println(mac);
-  Serial.print("  Timestamp:   ");
-  Serial.println(timestamp);
-  Serial.println("--- END PARSED DATA ---");
+  LOG_D("--- PARSED DATA ---\n");
+  LOG_D("  Device ID:   %s\n", deviceId);
+  LOG_D("  Device Name: %s\n", deviceName);
+  LOG_D("  MAC Address: %s\n", mac);
+  LOG_D("  Timestamp:   %lu\n", timestamp);
+  LOG_D("--- END PARSED DATA ---\n");
   
   // อัพเดทสถานะอุปกรณ์
-  updateDevice(deviceId, deviceName, mac);
+  RegistryDevice* device = updateDevice(deviceId, deviceName, mac);
+  noteSeqEpoch(device, doc["epoch"] | 0UL, deviceName);
+  JsonObject metrics = doc["metrics"];
+  if (device != nullptr && !metrics.isNull()) {
+    storeDeviceMetrics(deviceMetrics[device - registryDevices], metrics);
+  }
   
   // กระพริบ LED เขียว เมื่อได้รับข้อมูล
   blinkGreenLED();
   
   // ส่งข้อมูลไปยัง Serial (คอมพิวเตอร์จะอ่าน)
-  sendToSerial(body);
+  sendToSerial(body, item.length);
   
-  Serial.println("✅ Status processed successfully");
-  Serial.println("========================================\n");
+  LOG_D("✅ Status processed successfully\n");
+  LOG_D("========================================\n\n");
+}
+
+// ===== GET /api/devices, GET /api/changes?since=<generation> (network task) =====
+// JSON เขียนลง cacheJson โดยตรง (ไม่ใช้ String) แล้ว beginResponse_P ส่งจาก buffer เดิม
+// (AsyncResponseStream จะ copy ทั้งก้อนลง cbuf บน heap อีกรอบ)
+// buffer ถูกอ่านจนกว่า client ตัดการเชื่อมต่อ → ระหว่างนั้น request ที่ซ้อนเข้ามาได้ 503 ให้ถามใหม่
+// "complete": false = buffer ไม่พอ ให้ถามต่อด้วย /api/changes?since=<generation ที่ได้>
+void sendCacheJson(AsyncWebServerRequest* request, uint32_t since) {
+  unsigned long now = millis();
+  if (cacheJsonBusy && now - cacheJsonBusySince < CACHE_JSON_HOLD_MAX) {
+    request->send(503, "application/json", "{\"error\":\"Center busy\"}");
+    return;
+  }
   
-  // ส่ง response กลับ
-  server.send(200, "application/json", "{\"status\":\"ok\",\"message\":\"Status received\"}");
+  size_t length = Cache_writeJson(cacheJson, sizeof(cacheJson), since, now);
+  cacheJsonBusy = true;
+  cacheJsonBusySince = now;
+  request->onDisconnect([]() { cacheJsonBusy = false; });
+  request->send(request->beginResponse_P(200, "application/json", (const uint8_t*)cacheJson, length));
+}
+
+void handleDevicesSnapshot(AsyncWebServerRequest* request) {
+  sendCacheJson(request, 0);
+}
+
+void handleChanges(AsyncWebServerRequest* request) {
+  if (!request->hasParam("since")) {
+    request->send(400, "application/json", "{\"error\":\"Missing since\"}");
+    return;
+  }
+  uint32_t since = strtoul(request->getParam("since")->value().c_str(), nullptr, 10);
+  sendCacheJson(request, since);
 }
 
 // ===== HANDLE NOT FOUND =====
-void handleNotFound() {
-  String message = "Not Found\n\n";
-  message += "URI: " + server.uri() + "\n";
-  message += "Method: " + String((server.method() == HTTP_GET) ? "GET" : "POST") + "\n";
-  server.send(404, "text/plain", message);
+void handleNotFound(AsyncWebServerRequest* request) {
+  char message[160];
+  snprintf(message, sizeof(message), "Not Found\n\nURI: %s\nMethod: %s\n",
+           request->url().c_str(), request->method() == HTTP_GET ? "GET" : "POST");
+  request->send(404, "text/plain", message);
 }
 
-// ===== UPDATE DEVICE =====
-void updateDevice(String deviceId, String deviceName, String mac) {
+// ===== GET /api/metrics (network task) =====
+// อ่านค่าขณะที่ loop() อาจกำลังอัพเดท (ไม่ใช้ lock) - ตัวเลขของอุปกรณ์หนึ่งอาจมาจาก 2 รอบปนกัน
+// histogram เป็น [n,p50,p95,max] สะสมตั้งแต่เปิดเครื่อง
+void addMetricSummary(JsonObject target, const char* key, const uint32_t* summary) {
+  JsonArray array = target.createNestedArray(key);
+  for (int i = 0; i < METRIC_SUMMARY_SIZE; i++) {
+    array.add(summary[i]);
+  }
+}
+
+void addHistogram(JsonObject target, const char* key, const Histogram& histogram) {
+  uint32_t summary[METRIC_SUMMARY_SIZE] = {
+    histogram.count,
+    Histogram_percentile(histogram, 50),
+    Histogram_percentile(histogram, 95),
+    histogram.max
+  };
+  addMetricSummary(target, key, summary);
+}
+
+void handleMetrics(AsyncWebServerRequest* request) {
+  AsyncResponseStream* response = request->beginResponseStream("application/json");
   unsigned long now = millis();
-  bool found = false;
   
-  #ifdef ESP32
-    // ค้นหาและอัพเดทอุปกรณ์ที่มีอยู่
-    for (auto &device : connectedDevices) {
-      if (device.deviceId == deviceId) {
-        device.lastSeen = now;
-        device.online = true;
-        device.deviceName = deviceName;
-        device.macAddress = mac;
-        found = true;
-        break;
-      }
+  // ส่วนของ Center (อุปกรณ์หนึ่งใช้ ~36 ช่อง x 16 bytes - string เก็บเป็น pointer ไม่ copy)
+  StaticJsonDocument<768> doc;
+  JsonObject center = doc.to<JsonObject>();
+  center["up"] = now / 1000;
+  addHistogram(center, "forwardUs", histForwardUs);
+  addHistogram(center, "handleUs", histHandleUs);
+  center["inboxDropped"] = Inbox_getDroppedCount();
+  center["inboxHighWater"] = Inbox_getHighWater();
+  center["duplicates"] = duplicateReadingCount;
+  center["serialRetransmits"] = serialLinkRetransmits;
+  center["serialOverwritten"] = serialLinkOverwritten;
+  center["wireBadFrames"] = wireBadFrameCount;
+  center["heartbeats"] = wireHeartbeatCount;
+  addHistogram(center, "streamUs", histStreamUs);
+  center["streamClients"] = ReadingStream_clientCount();
+  center["streamSent"] = streamSent;
+  center["streamSlowDropped"] = streamSlowDropped;
+  center["bodyBusy"] = bodyArenaBusyCount;
+  center["bodyExpired"] = bodyArenaExpiredCount;
+  center["heapFree"] = ESP.getFreeHeap();
+  center["heapMin"] = getHeapMinFree();
+  center["heapMaxBlock"] = getHeapMaxBlock();
+  
+  response->print("{\"center\":");
+  serializeJson(doc, *response);
+  response->print(",\"devices\":[");
+  
+  // ทีละอุปกรณ์ (ใช้ doc ตัวเดิม → memory คงที่ไม่ว่าจะมีกี่อุปกรณ์)
+  bool first = true;
+  for (int i = 0; i < REGISTRY_CAPACITY; i++) {
+    const RegistryDevice* device = Registry_at(i);
+    if (device == nullptr) {
+      continue;
     }
+    const DeviceMetrics& metrics = deviceMetrics[i];
     
-    // ถ้าไม่พบ ให้เพิ่มเป็นอุปกรณ์ใหม่
-    if (!found) {
-      DeviceInfo newDevice;
-      newDevice.deviceId = deviceId;
-      newDevice.deviceName = deviceName;
-      newDevice.macAddress = mac;
-      newDevice.lastSeen = now;
-      newDevice.online = true;
-      
-      connectedDevices.push_back(newDevice);
-      
-      Serial.print("New device connected: ");
-      Serial.println(deviceId);
-      printDeviceList();
-    }
-  #else
-    // ESP8266 - ใช้ array แทน vector
-    for (int i = 0; i < deviceCount; i++) {
-      if (connectedDevices[i].deviceId == deviceId) {
-        connectedDevices[i].lastSeen = now;
-        connectedDevices[i].online = true;
-        connectedDevices[i].deviceName = deviceName;
-        connectedDevices[i].macAddress = mac;
-        found = true;
-        break;
+    doc.clear();
+    JsonObject entry = doc.to<JsonObject>();
+    entry["deviceId"] = device->deviceId;
+    entry["deviceName"] = device->deviceName;
+    entry["online"] = device->online;
+    entry["lastSeenMs"] = now - device->lastSeen;
+    entry["readings"] = metrics.readings;
+    entry["duplicates"] = metrics.duplicates;
+    if (metrics.reported) {
+      entry["reportedMs"] = now - metrics.reportedAt;
+      entry["up"] = metrics.up;
+      addMetricSummary(entry, "frameMs", metrics.frameMs);
+      addMetricSummary(entry, "parseUs", metrics.parseUs);
+      addMetricSummary(entry, "handleUs", metrics.handleUs);
+      addMetricSummary(entry, "deliverMs", metrics.deliverMs);
+      entry["retry"] = metrics.retry;
+      entry["reconnect"] = metrics.reconnect;
+      entry["dropped"] = metrics.dropped;
+      entry["overrun"] = metrics.overrun;
+      if (metrics.baud != 0) {
+        entry["baud"] = metrics.baud;
+        entry["baudLocked"] = metrics.baudLocked;
       }
+      entry["queueDropped"] = metrics.queueDropped;
+      entry["heapMin"] = metrics.heapMin;
+      entry["wifiMs"] = metrics.wifiMs;
+      entry["reconnectMs"] = metrics.reconnectMs;
+      entry["firstPostMs"] = metrics.firstPostMs;
     }
     
-    // ถ้าไม่พบและยังมีที่ว่าง ให้เพิ่มเป็นอุปกรณ์ใหม่
-    if (!found && deviceCount < 10) {
-      connectedDevices[deviceCount].deviceId = deviceId;
-      connectedDevices[deviceCount].deviceName = deviceName;
-      connectedDevices[deviceCount].macAddress = mac;
-      connectedDevices[deviceCount].lastSeen = now;
-      connectedDevices[deviceCount].online = true;
-      deviceCount++;
-      
-      Serial.print("New device connected: ");
-      Serial.println(deviceId);
-      printDeviceList();
+    if (!first) {
+      response->print(",");
     }
-  #endif
+    serializeJson(doc, *response);
+    first = false;
+  }
+  
+  response->print("]}");
+  request->send(response);
 }
 
-// ===== CLEANUP OFFLINE DEVICES =====
-void cleanupOfflineDevices() {
-  unsigned long now = millis();
-  bool changed = false;
-  
+// ===== Heap ว่างต่ำสุดตั้งแต่เปิดเครื่อง =====
+uint32_t getHeapMinFree() {
   #ifdef ESP32
-    for (auto &device : connectedDevices) {
-      if (device.online && (now - device.lastSeen > DEVICE_TIMEOUT)) {
-        device.online = false;
-        changed = true;
-        Serial.print("Device went offline: ");
-        Serial.println(device.deviceId);
-      }
-    }
+    return ESP.getMinFreeHeap();
   #else
-    // ESP8266 - ใช้ array
-    for (int i = 0; i < deviceCount; i++) {
-      if (connectedDevices[i].online && (now - connectedDevices[i].lastSeen > DEVICE_TIMEOUT)) {
-        connectedDevices[i].online = false;
-        changed = true;
-        Serial.print("Device went offline: ");
-        Serial.println(connectedDevices[i].deviceId);
-      }
+    // ESP8266 ไม่มีค่าต่ำสุดจาก SDK → สุ่มดูตอนแสดงสถานะ / เรียก /api/metrics
+    uint32_t freeHeap = ESP.getFreeHeap();
+    if (heapMinFree == 0 || freeHeap < heapMinFree) {
+      heapMinFree = freeHeap;
     }
+    return heapMinFree;
+  #endif
+}
+
+// ===== ก้อน heap ใหญ่สุดที่ malloc ได้ (ว่างมากแต่ก้อนเล็ก = heap แตกเป็นชิ้น) =====
+uint32_t getHeapMaxBlock() {
+  #ifdef ESP32
+    return ESP.getMaxAllocHeap();
+  #else
+    return ESP.getMaxFreeBlockSize();
   #endif
+}
+
+// ===== IP เป็นข้อความ (IPAddress::toString() สร้าง String ใหม่ทุกครั้ง) =====
+// ip แบบเดียวกับ (uint32_t)IPAddress - byte แรกคือส่วนแรกของ address
+void formatIP(uint32_t ip, char* out, size_t size) {
+  snprintf(out, size, "%u.%u.%u.%u", (unsigned)(ip & 0xFF), (unsigned)((ip >> 8) & 0xFF),
+           (unsigned)((ip >> 16) & 0xFF), (unsigned)(ip >> 24));
+}
+
+// ===== PROCESS INBOX (loop) =====
+// ทำงานช้าที่ย้ายออกจาก HTTP handler: Serial log, ส่ง [DATA], อัพเดทอุปกรณ์, LED
+void processInbox() {
+  InboxItem* item;
+  while ((item = Inbox_peek()) != nullptr) {
+    if (item->kind == INBOX_STATUS) {
+      processDeviceStatus(*item);
+    } else {
+      processVitals(*item);
+    }
+    Inbox_pop();
+  }
+}
+
+// ===== WEBSOCKET /ws (ดู ReadingStream.h) =====
+// ต่อ/หลุด มาจาก network task → เข้าคิว ตาราง client แก้ใน loop เท่านั้น
+// ข้อความจาก client ไม่ใช้ (ส่งทางเดียว)
+void onStreamEvent(AsyncWebSocket* socket, AsyncWebSocketClient* client, AwsEventType type,
+                   void* arg, uint8_t* data, size_t length) {
+  if (type == WS_EVT_CONNECT) {
+    ReadingStream_pushEvent(client->id(), true);
+  } else if (type == WS_EVT_DISCONNECT) {
+    ReadingStream_pushEvent(client->id(), false);
+  }
+}
+
+// คิวของ AsyncWebSocketClient เต็ม (TCP ส่งไม่ทัน) → BUSY ไม่รอ
+StreamSendResult streamSend(uint32_t id, const char* data, size_t length) {
+  AsyncWebSocketClient* client = streamSocket.client(id);
+  if (client == nullptr || client->status() != WS_CONNECTED) {
+    return STREAM_GONE;
+  }
+  if (client->queueIsFull()) {
+    return STREAM_BUSY;
+  }
+  client->text(data, length);
+  return STREAM_SENT;
+}
+
+void streamClose(uint32_t id) {
+  LOG_W("⚠️  WebSocket client #%lu ตามไม่ทัน/เกินจำนวน - ตัดการเชื่อมต่อ\n", (unsigned long)id);
+  streamSocket.close(id);
+}
+
+void pumpReadingStream() {
+  ReadingStream_processEvents(streamClose);
+  ReadingStream_drain(micros(), streamSend, streamClose, histStreamUs);
+}
+
+// ===== UPDATE DEVICE =====
+// คืน nullptr ถ้าตารางเต็ม (ไม่ได้ติดตามอุปกรณ์นี้)
+RegistryDevice* updateDevice(const char* deviceId, const char* deviceName, const char* mac) {
+  bool isNew;
+  RegistryDevice* device = Registry_update(deviceId, deviceName, mac, millis(), isNew);
   
-  if (changed) {
+  if (device == nullptr) {
+    LOG_W("⚠️  Device list full (all online) - not tracking: %s\n", deviceId);
+    return nullptr;
+  }
+  
+  if (isNew) {
+    // ช่องนี้อาจเคยเป็นของอุปกรณ์ที่ถูกแทนที่ → ล้าง metrics เดิม
+    memset(&deviceMetrics[device - registryDevices], 0, sizeof(DeviceMetrics));
+    Dedup_reset(deviceDedup[device - registryDevices]);
+    Cache_clearDevice(device - registryDevices);
+    LOG_I("New device connected: %s\n", deviceId);
+    printDeviceList();
+  }
+  return device;
+}
+
+// ===== CLEANUP OFFLINE DEVICES =====
+void printOfflineDevice(const RegistryDevice& device) {
+  LOG_I("Device went offline: %s\n", device.deviceId);
+}
+
+void cleanupOfflineDevices() {
+  if (Registry_expire(millis(), printOfflineDevice) > 0) {
     printDeviceList();
   }
 }
 
 // ===== SEND TO SERIAL =====
-void sendToSerial(String jsonString) {
-  // ส่งข้อมูล JSON ไปยัง Serial เพื่อให้คอมพิวเตอร์อ่าน
-  // เพิ่ม prefix [DATA] เพื่อให้แยกจาก debug messages
-  Serial.print("[DATA] ");
-  Serial.println(jsonString);
+// ส่งข้อมูล JSON ไปยังคอมพิวเตอร์เป็น frame (SerialLink.h) - ตรวจ CRC ได้ มี seq และส่งซ้ำได้
+void sendToSerial(const char* json, size_t length) {
+  if (!SerialLink_send(json, length)) {
+    // ไม่ส่งแบบบรรทัด [DATA] นอก frame (ไม่มี CRC/ส่งซ้ำ) - นับไว้ใน serialLinkTooLarge
+    LOG_E("❌ ข้อมูล %u bytes ใหญ่เกิน frame ของ SerialLink - ไม่ได้ส่ง\n", (unsigned)length);
+  }
 }
 
 // ===== PRINT DEVICE LIST =====
 void printDeviceList() {
-  Serial.println("\n=== Connected Devices ===");
-  int onlineCount = 0;
-  int totalCount = 0;
+  LOG_I("\n=== Connected Devices ===\n");
   
-  #ifdef ESP32
-    totalCount = connectedDevices.size();
-    for (const auto &device : connectedDevices) {
-      Serial.print("  - ");
-      Serial.print(device.deviceName);
-      Serial.print(" (");
-      Serial.print(device.deviceId);
-      Serial.print(") ");
-      Serial.println(device.online ? "[ONLINE]" : "[OFFLINE]");
-      
-      if (device.online) onlineCount++;
+  for (int i = 0; i < REGISTRY_CAPACITY; i++) {
+    const RegistryDevice* device = Registry_at(i);
+    if (device == nullptr) {
+      continue;
     }
-  #else
-    // ESP8266 - ใช้ array
-    totalCount = deviceCount;
-    for (int i = 0; i < deviceCount; i++) {
-      Serial.print("  - ");
-      Serial.print(connectedDevices[i].deviceName);
-      Serial.print(" (");
-      Serial.print(connectedDevices[i].deviceId);
-      Serial.print(") ");
-      Serial.println(connectedDevices[i].online ? "[ONLINE]" : "[OFFLINE]");
-      
-      if (connectedDevices[i].online) onlineCount++;
-    }
-  #endif
+    LOG_I("  - %s (%s) %s\n", device->deviceName, device->deviceId,
+          device->online ? "[ONLINE]" : "[OFFLINE]");
+  }
   
-  Serial.print("Total: ");
-  Serial.print(totalCount);
-  Serial.print(" devices (");
-  Serial.print(onlineCount);
-  Serial.println(" online)");
-  Serial.println("========================\n");
+  LOG_I("Total: %d devices (%d online)\n", Registry_getCount(), Registry_getOnlineCount());
+  LOG_I("========================\n\n");
 }
 
 // ===== SETUP LEDS =====
@@ -662,17 +1454,7 @@ void setupLEDs() {
 
 // ===== GET ONLINE DEVICE COUNT =====
 int getOnlineDeviceCount() {
-  int count = 0;
-  #ifdef ESP32
-    for (const auto &device : connectedDevices) {
-      if (device.online) count++;
-    }
-  #else
-    for (int i = 0; i < deviceCount; i++) {
-      if (connectedDevices[i].online) count++;
-    }
-  #endif
-  return count;
+  return Registry_getOnlineCount();  // นับไว้ตลอดใน DeviceRegistry
 }
 
 // ===== UPDATE RED LED =====
@@ -717,8 +1499,16 @@ void updateRedLED() {
 
 // ===== BLINK GREEN LED =====
 void blinkGreenLED() {
-  // กระพริบสั้นๆ เมื่อได้รับข้อมูล
+  // กระพริบสั้นๆ เมื่อได้รับข้อมูล (ดับใน updateGreenLED - ไม่ block)
   digitalWrite(GREEN_LED_PIN, HIGH);
-  delay(100);
-  digitalWrite(GREEN_LED_PIN, LOW);
+  greenLedOn = true;
+  greenLedOnAt = millis();
+}
+
+// ===== UPDATE GREEN LED =====
+void updateGreenLED() {
+  if (greenLedOn && millis() - greenLedOnAt >= 100) {
+    digitalWrite(GREEN_LED_PIN, LOW);
+    greenLedOn = false;
+  }
 }
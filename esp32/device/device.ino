@@ -13,6 +13,15 @@
 #endif
 
 #include <ArduinoJson.h>
+#include <WiFiUdp.h>
+#include "WireProtocol.h"  // HEARTBEAT (UDP) - สำเนาเดียวกับ center/
+
+// ===== LOG (ดู Log.h) =====
+// LOG_LEVEL_DEBUG = แสดง request/response ทุกครั้ง
+// LOG_DEFERRED 0: ตัวจำลองพิมพ์ขั้นตอนการวัดตรงๆ (มี delay อยู่แล้ว) → log ต้องออกตามลำดับเดียวกัน
+#define LOG_LEVEL LOG_LEVEL_INFO
+#define LOG_DEFERRED 0
+#include "Log.h"
 
 // ===== LED PIN =====
 #ifdef ESP32
@@ -44,14 +53,31 @@ String currentIdCard = "";                   // เก็บ ID Card ปัจ
 String macAddress;
 bool wifiConnected = false;
 unsigned long lastStatusSend = 0;
-const unsigned long STATUS_INTERVAL = 3000;     // ส่งสถานะทุก 3 วินาที (เรียลไทม์)
+bool statusPending = true;                      // ต้องส่ง /api/status (เริ่มต้น / ต่อ WiFi ใหม่ / Center ขอ)
+const unsigned long STATUS_REFRESH_INTERVAL = 300000;  // ส่ง /api/status ซ้ำทุก 5 นาที (ข้อมูลอุปกรณ์ไม่เปลี่ยน)
+
+// ===== PRESENCE (UDP heartbeat แทน HTTP ทุก 3 วินาที) =====
+// Center รู้สถานะออนไลน์จาก heartbeat 18 bytes + การต่อ/หลุดจาก AP → ไม่ต้องเปิด TCP ทุกรอบ
+WiFiUDP presenceUdp;
+uint8_t macBytes[6];
+uint16_t presenceSession = 0;
+unsigned long lastHeartbeat = 0;
+const unsigned long HEARTBEAT_INTERVAL = 3000;  // Center: DEVICE_TIMEOUT 10 วินาที
 unsigned long lastLedBlink = 0;
 bool ledBlinkState = false;
 
+// ===== WIFI RECONNECT (จำ BSSID/channel ของ Center → reconnect ไม่ต้อง scan) =====
+uint8_t centerBssid[6];
+int32_t centerChannel = 0;                      // 0 = ยังไม่รู้ → scan
+const unsigned long WIFI_CONNECT_TIMEOUT = 15000;
+const unsigned long WIFI_CACHED_TIMEOUT = 3000; // ใช้ค่าที่จำไว้แล้วไม่ติด → scan
+
 // ===== FUNCTION DECLARATIONS =====
 void connectWiFi();
 bool sendHTTPPost(String endpoint, String jsonData);
-void sendDeviceStatus();
+bool sendDeviceStatus();
+void sendHeartbeat();
+void receivePresenceReply();
 void sendVitalsData(const char* idcard, const char* deviceType, float value);
 void setupLED();
 void updateLED();
@@ -67,11 +93,14 @@ void setup() {
   Serial.println(" Device Starting ===");
   Serial.println("=============================");
   
-  // ตั้งค่า WiFi mode
+  // ตั้งค่า WiFi mode (ไม่เขียน SSID/รหัสผ่านลง flash ทุกครั้งที่ begin)
+  WiFi.persistent(false);
   WiFi.mode(WIFI_STA);
   
   // แสดง MAC Address
   macAddress = WiFi.macAddress();
+  WiFi.macAddress(macBytes);
+  presenceSession = random(1, 65536);
   Serial.print("Device MAC Address: ");
   Serial.println(macAddress);
   Serial.print("Device ID: ");
@@ -85,10 +114,11 @@ void setup() {
   // เชื่อมต่อ WiFi
   connectWiFi();
   
-  // ส่งสถานะแรกทันที
+  // ส่งสถานะแรกทันที (ไม่สำเร็จ → loop ส่งใหม่)
+  presenceUdp.begin(WIRE_UDP_PORT);
   if (wifiConnected) {
-    delay(1000);
-    sendDeviceStatus();
+    statusPending = !sendDeviceStatus();
+    lastStatusSend = millis();
   }
   
   Serial.println("\nDevice ready!");
@@ -109,9 +139,20 @@ void loop() {
   // อัพเดท LED
   updateLED();
   
-  // ส่งสถานะอุปกรณ์เป็นระยะ
-  if (wifiConnected && (millis() - lastStatusSend > STATUS_INTERVAL)) {
-    sendDeviceStatus();
+  // ทยอยส่ง log ออก Serial (เมื่อ LOG_DEFERRED = 1)
+  Log_drain();
+  
+  // บอก Center ว่ายังออนไลน์ (UDP)
+  if (wifiConnected && (millis() - lastHeartbeat >= HEARTBEAT_INTERVAL)) {
+    receivePresenceReply();
+    sendHeartbeat();
+    lastHeartbeat = millis();
+  }
+  
+  // ส่งข้อมูลอุปกรณ์ (HTTP) เมื่อต้องส่งใหม่ หรือนานๆ ครั้ง - ส่งไม่สำเร็จลองใหม่ทุก HEARTBEAT_INTERVAL
+  unsigned long statusInterval = statusPending ? HEARTBEAT_INTERVAL : STATUS_REFRESH_INTERVAL;
+  if (wifiConnected && (millis() - lastStatusSend >= statusInterval)) {
+    statusPending = !sendDeviceStatus();
     lastStatusSend = millis();
   }
   
@@ -233,20 +274,36 @@ void connectWiFi() {
   Serial.print("Expected Gateway: ");
   Serial.println(CENTER_IP);
   
-  // ลบ WiFi ที่จำไว้ทั้งหมด และตัดการเชื่อมต่อเก่า
-  WiFi.disconnect(true);  // true = ลบ credentials ที่จำไว้
-  delay(500);
-  
-  WiFi.begin(CENTER_SSID, CENTER_PASSWORD);
-  Serial.println("\nConnecting");
+  // ตัดการเชื่อมต่อเก่า (ไม่ลบ credentials / ไม่ต้องรอ)
+  // เคยต่อได้แล้ว → ใช้ BSSID/channel เดิม ไม่ต้อง scan ทุก channel
+  WiFi.disconnect();
+  bool cached = centerChannel != 0;
+  if (cached) {
+    WiFi.begin(CENTER_SSID, CENTER_PASSWORD, centerChannel, centerBssid);
+    Serial.printf("\nConnecting (channel %d, BSSID ที่จำไว้)", (int)centerChannel);
+  } else {
+    WiFi.begin(CENTER_SSID, CENTER_PASSWORD);
+    Serial.print("\nConnecting (scan)");
+  }
   
+  unsigned long startedAt = millis();
   int attempts = 0;
-  while (WiFi.status() != WL_CONNECTED && attempts < 30) {
-    delay(500);
-    Serial.print(".");
+  while (WiFi.status() != WL_CONNECTED && millis() - startedAt < WIFI_CONNECT_TIMEOUT) {
+    delay(100);
+    if (cached && millis() - startedAt >= WIFI_CACHED_TIMEOUT) {
+      // Center เปลี่ยน channel / เปลี่ยนเครื่อง → scan หาใหม่
+      Serial.print("\n  BSSID/channel ที่จำไว้ใช้ไม่ได้ - scan");
+      centerChannel = 0;
+      cached = false;
+      WiFi.disconnect();
+      WiFi.begin(CENTER_SSID, CENTER_PASSWORD);
+    }
+    if (attempts % 5 == 4) {
+      Serial.print(".");
+    }
     
     // แสดงสถานะการเชื่อมต่อ
-    if (attempts % 10 == 9) {
+    if (attempts % 50 == 49) {
       Serial.println();
       Serial.print("  Status code: ");
       Serial.print(WiFi.status());
@@ -271,7 +328,10 @@ void connectWiFi() {
   
   if (WiFi.status() == WL_CONNECTED) {
     wifiConnected = true;
-    Serial.println("\n✅ WiFi Connected Successfully!");
+    statusPending = true;  // Center อาจไม่รู้จักเรา (เช่น Center reboot ระหว่างที่หลุด)
+    memcpy(centerBssid, WiFi.BSSID(), sizeof(centerBssid));
+    centerChannel = WiFi.channel();
+    Serial.printf("\n✅ WiFi Connected Successfully! (%lu ms)\n", millis() - startedAt);
     Serial.println("--- Connection Details ---");
     Serial.print("  Connected SSID: ");
     Serial.println(WiFi.SSID());
@@ -334,56 +394,48 @@ void connectWiFi() {
 // ===== SEND HTTP POST =====
 bool sendHTTPPost(String endpoint, String jsonData) {
   if (!wifiConnected) {
-    Serial.println("❌ WiFi not connected! Cannot send HTTP request.");
+    LOG_E("❌ WiFi not connected! Cannot send HTTP request.\n");
     return false;
   }
   
-  Serial.println("\n--- HTTP POST REQUEST ---");
-  Serial.print("  Endpoint: ");
-  Serial.println(endpoint);
-  Serial.print("  URL: http://");
-  Serial.print(CENTER_IP);
-  Serial.println(endpoint);
-  Serial.print("  Data size: ");
-  Serial.print(jsonData.length());
-  Serial.println(" bytes");
+  LOG_D("\n--- HTTP POST REQUEST ---\n");
+  LOG_D("  Endpoint: %s\n", endpoint.c_str());
+  LOG_D("  URL: http://%s%s\n", CENTER_IP, endpoint.c_str());
+  LOG_D("  Data size: %u bytes\n", jsonData.length());
   
   #ifdef ESP32
     HTTPClient http;
     String url = "http://" + String(CENTER_IP) + endpoint;
     
-    Serial.println("  Starting HTTP connection...");
+    LOG_D("  Starting HTTP connection...\n");
     http.begin(url);
     http.addHeader("Content-Type", "application/json");
     http.setTimeout(5000); // 5 second timeout
     
-    Serial.println("  Sending POST request...");
+    LOG_D("  Sending POST request...\n");
     int httpResponseCode = http.POST(jsonData);
     
-    Serial.print("  HTTP Response Code: ");
-    Serial.println(httpResponseCode);
+    LOG_D("  HTTP Response Code: %d\n", httpResponseCode);
     
     if (httpResponseCode > 0) {
       String response = http.getString();
-      Serial.print("  Response: ");
-      Serial.println(response);
+      LOG_D("  Response: %s\n", response.c_str());
       http.end();
-      Serial.println("✅ HTTP Request Successful");
-      Serial.println("--- END HTTP REQUEST ---\n");
+      LOG_I("✅ POST %s → %d\n", endpoint.c_str(), httpResponseCode);
+      LOG_D("--- END HTTP REQUEST ---\n\n");
       
       // กระพริบ LED เมื่อส่งข้อมูลสำเร็จ
       blinkLEDOnce();
       
       return true;
     } else {
-      Serial.print("❌ HTTP Error: ");
-      Serial.println(http.errorToString(httpResponseCode));
-      Serial.println("  Possible reasons:");
-      Serial.println("  - Center not responding");
-      Serial.println("  - Network connection lost");
-      Serial.println("  - Timeout (>5 seconds)");
+      LOG_E("❌ HTTP Error: %s\n", http.errorToString(httpResponseCode).c_str());
+      LOG_W("  Possible reasons:\n");
+      LOG_W("  - Center not responding\n");
+      LOG_W("  - Network connection lost\n");
+      LOG_W("  - Timeout (>5 seconds)\n");
       http.end();
-      Serial.println("--- END HTTP REQUEST ---\n");
+      LOG_D("--- END HTTP REQUEST ---\n\n");
       return false;
     }
   #else
@@ -392,46 +444,44 @@ bool sendHTTPPost(String endpoint, String jsonData) {
     HTTPClient http;
     String url = "http://" + String(CENTER_IP) + endpoint;
     
-    Serial.println("  Starting HTTP connection...");
+    LOG_D("  Starting HTTP connection...\n");
     http.begin(client, url);
     http.addHeader("Content-Type", "application/json");
     http.setTimeout(5000); // 5 second timeout
     
-    Serial.println("  Sending POST request...");
+    LOG_D("  Sending POST request...\n");
     int httpResponseCode = http.POST(jsonData);
     
-    Serial.print("  HTTP Response Code: ");
-    Serial.println(httpResponseCode);
+    LOG_D("  HTTP Response Code: %d\n", httpResponseCode);
     
     if (httpResponseCode > 0) {
       String response = http.getString();
-      Serial.print("  Response: ");
-      Serial.println(response);
+      LOG_D("  Response: %s\n", response.c_str());
       http.end();
-      Serial.println("✅ HTTP Request Successful");
-      Serial.println("--- END HTTP REQUEST ---\n");
+      LOG_I("✅ POST %s → %d\n", endpoint.c_str(), httpResponseCode);
+      LOG_D("--- END HTTP REQUEST ---\n\n");
       
       // กระพริบ LED เมื่อส่งข้อมูลสำเร็จ
       blinkLEDOnce();
       
       return true;
     } else {
-      Serial.print("❌ HTTP Error code: ");
-      Serial.println(httpResponseCode);
-      Serial.println("  Possible reasons:");
-      Serial.println("  - Center not responding");
-      Serial.println("  - Network connection lost");
-      Serial.println("  - Timeout (>5 seconds)");
+      LOG_E("❌ HTTP Error code: %d\n", httpResponseCode);
+      LOG_W("  Possible reasons:\n");
+      LOG_W("  - Center not responding\n");
+      LOG_W("  - Network connection lost\n");
+      LOG_W("  - Timeout (>5 seconds)\n");
       http.end();
-      Serial.println("--- END HTTP REQUEST ---\n");
+      LOG_D("--- END HTTP REQUEST ---\n\n");
       return false;
     }
   #endif
 }
 
 // ===== SEND DEVICE STATUS =====
-void sendDeviceStatus() {
-  if (!wifiConnected) return;
+// ข้อมูลอุปกรณ์ (ID/ชื่อ/MAC) - ไม่ต้องส่งบ่อย สถานะออนไลน์มาจาก heartbeat
+bool sendDeviceStatus() {
+  if (!wifiConnected) return false;
   
   #ifdef ESP32
     StaticJsonDocument<256> doc;
@@ -448,11 +498,39 @@ void sendDeviceStatus() {
   String jsonString;
   serializeJson(doc, jsonString);
   
-  Serial.println("\n--- Sending Device Status ---");
+  LOG_D("\n--- Sending Device Status ---\n");
   if (sendHTTPPost("/api/status", jsonString)) {
-    Serial.println("✓ Status sent successfully");
-  } else {
-    Serial.println("✗ Failed to send status");
+    LOG_D("✓ Status sent successfully\n");
+    return true;
+  }
+  LOG_E("✗ Failed to send status\n");
+  return false;
+}
+
+// ===== SEND HEARTBEAT (UDP) =====
+void sendHeartbeat() {
+  uint8_t frame[WIRE_HEADER_SIZE + WIRE_HEARTBEAT_SIZE + WIRE_CRC_SIZE];
+  size_t length = Wire_encodeHeartbeat(frame, presenceSession, macBytes);
+  presenceUdp.beginPacket(CENTER_IP, WIRE_UDP_PORT);
+  presenceUdp.write(frame, length);
+  presenceUdp.endPacket();
+}
+
+// ===== Center ตอบ heartbeat เฉพาะเมื่อไม่รู้จักเรา → ส่ง /api/status ใหม่ =====
+void receivePresenceReply() {
+  uint8_t frame[WIRE_MAX_FRAME];
+  while (presenceUdp.parsePacket() > 0) {
+    int length = presenceUdp.read(frame, sizeof(frame));
+    WireHeader header;
+    if (length <= 0 || Wire_parseFrame(frame, length, header) < 0) {
+      continue;
+    }
+    if (header.type == WIRE_MSG_ACK && header.session == presenceSession &&
+        header.status == WIRE_ACK_UNKNOWN_DEVICE) {
+      LOG_I("📡 Center ไม่รู้จักอุปกรณ์นี้ → ส่งสถานะใหม่\n");
+      statusPending = true;
+      lastStatusSend = millis() - HEARTBEAT_INTERVAL;
+    }
   }
 }
 
@@ -483,7 +561,7 @@ void sendVitalsData(const char* idcard, const char* deviceType, float value) {
   if (sendHTTPPost("/api/vitals", jsonString)) {
     // Success message already printed by sendHTTPPost
   } else {
-    Serial.println("✗ Failed to send vitals data");
+    LOG_E("✗ Failed to send vitals data\n");
   }
 }
 
@@ -514,13 +592,13 @@ void sendBatchVitalsData(const char* idcard, int bpSystolic, int bpDiastolic, in
   String jsonString;
   serializeJson(doc, jsonString);
   
-  Serial.println("\n--- Sending BP Monitor Batch ---");
-  Serial.println(jsonString);
+  LOG_D("\n--- Sending BP Monitor Batch ---\n");
+  LOG_D("%s\n", jsonString.c_str());
   
   if (sendHTTPPost("/api/vitals", jsonString)) {
-    Serial.println("✅ BP Monitor batch sent successfully");
+    LOG_I("✅ BP Monitor batch sent successfully\n");
   } else {
-    Serial.println("✗ Failed to send BP Monitor batch");
+    LOG_E("✗ Failed to send BP Monitor batch\n");
   }
 }
 
@@ -551,13 +629,13 @@ void sendScaleVitalsData(float weight, float height, float temperature) {
   String jsonString;
   serializeJson(doc, jsonString);
   
-  Serial.println("\n--- Sending Scale Batch ---");
-  Serial.println(jsonString);
+  LOG_D("\n--- Sending Scale Batch ---\n");
+  LOG_D("%s\n", jsonString.c_str());
   
   if (sendHTTPPost("/api/vitals", jsonString)) {
-    Serial.println("✅ Scale batch sent successfully");
+    LOG_I("✅ Scale batch sent successfully\n");
   } else {
-    Serial.println("✗ Failed to send Scale batch");
+    LOG_E("✗ Failed to send Scale batch\n");
   }
 }
 
@@ -0,0 +1,227 @@
+/**
+ * BenchProbe.h - วัด heap และ stack ของ benchmark บน PC (ใช้ร่วมกันทุกไฟล์ใน bench/)
+ *
+ * heap:  แทน operator new/delete ทั้งโปรแกรม → นับ byte/จำนวนครั้งที่ allocate
+ *        ระหว่าง BenchHeap_begin() / BenchHeap_end() (firmware ไม่ควร allocate ในลูปเลย)
+ * stack: รันโค้ดใน thread ที่ทา stack ด้วยค่าคงที่ไว้ก่อน แล้วดูว่าถูกเขียนทับลึกสุดเท่าไร
+ *        (high-water mark แบบ uxTaskGetStackHighWaterMark) หัก thread เปล่าออกแล้ว
+ *   - Bench_runOnPaintedStack(body, arg)  รัน body ใน thread ใหม่แล้วคืน byte ที่ใช้
+ *   - BenchTask                           thread ค้างไว้สำหรับงานอีก "task" หนึ่ง
+ *                                         (เช่น loop() ขณะที่ RS232 task อยู่ใน thread หลัก)
+ *                                         BenchTask_run() ส่งงานไปทำแล้วรอจนเสร็จ
+ *
+ * มี operator new → include จาก .cpp ไฟล์เดียวต่อ executable เท่านั้น
+ * ตัวเลขเป็นของ PC (ABI x86-64/ARM64 ไม่ใช่ Xtensa) → ใช้เทียบก่อน/หลังแก้โค้ด ไม่ใช่ขนาด stack ของบอร์ด
+ */
+
+#ifndef BENCH_PROBE_H
+#define BENCH_PROBE_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <new>
+
+// ===== Configuration =====
+#define BENCH_STACK_SIZE (1024 * 1024)
+#define BENCH_STACK_PAINT 0xA5
+
+// ===== heap =====
+struct BenchHeap {
+  size_t current;
+  size_t peak;
+  unsigned long allocations;
+  bool tracking;
+  size_t startBytes;                 // current ตอน BenchHeap_begin()
+  unsigned long startAllocations;
+};
+
+BenchHeap benchHeap = { 0, 0, 0, false, 0, 0 };
+
+void* operator new(size_t size) {
+  size_t* block = (size_t*)malloc(size + sizeof(max_align_t));
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+  block[0] = size;
+  benchHeap.current += size;
+  if (benchHeap.tracking) {
+    benchHeap.allocations++;
+    benchHeap.peak = std::max(benchHeap.peak, benchHeap.current);
+  }
+  return (char*)block + sizeof(max_align_t);
+}
+
+void operator delete(void* ptr) noexcept {
+  if (ptr == nullptr) {
+    return;
+  }
+  size_t* block = (size_t*)((char*)ptr - sizeof(max_align_t));
+  benchHeap.current -= block[0];
+  free(block);
+}
+
+inline void BenchHeap_begin() {
+  benchHeap.peak = benchHeap.current;
+  benchHeap.startBytes = benchHeap.current;
+  benchHeap.startAllocations = benchHeap.allocations;
+  benchHeap.tracking = true;
+}
+
+inline void BenchHeap_end() {
+  benchHeap.tracking = false;
+}
+
+// peak ที่เพิ่มจากตอน begin (byte) / จำนวนครั้งที่ allocate ระหว่างนั้น
+inline size_t BenchHeap_peakBytes() {
+  return benchHeap.peak - benchHeap.startBytes;
+}
+
+inline unsigned long BenchHeap_allocationCount() {
+  return benchHeap.allocations - benchHeap.startAllocations;
+}
+
+// ===== stack: ทาทั้ง buffer แล้วนับจากปลายล่าง (stack โตลง) =====
+inline void* BenchStack_alloc() {
+  void* stack = nullptr;
+  if (posix_memalign(&stack, 4096, BENCH_STACK_SIZE) != 0) {
+    return nullptr;
+  }
+  memset(stack, BENCH_STACK_PAINT, BENCH_STACK_SIZE);
+  return stack;
+}
+
+inline size_t BenchStack_used(const void* stack) {
+  const uint8_t* bytes = (const uint8_t*)stack;
+  size_t untouched = 0;
+  while (untouched < BENCH_STACK_SIZE && bytes[untouched] == BENCH_STACK_PAINT) {
+    untouched++;
+  }
+  return BENCH_STACK_SIZE - untouched;
+}
+
+inline bool BenchStack_start(pthread_t& thread, void* stack, void* (*body)(void*), void* arg) {
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setstack(&attr, stack, BENCH_STACK_SIZE);
+  bool started = pthread_create(&thread, &attr, body, arg) == 0;
+  pthread_attr_destroy(&attr);
+  return started;
+}
+
+// คืน byte ที่ถูกใช้ / 0 ถ้าสร้าง thread ไม่ได้
+inline size_t Bench_runOnPaintedStack(void* (*body)(void*), void* arg) {
+  void* stack = BenchStack_alloc();
+  if (stack == nullptr) {
+    return 0;
+  }
+  size_t used = 0;
+  pthread_t thread;
+  if (BenchStack_start(thread, stack, body, arg)) {
+    pthread_join(thread, nullptr);
+    used = BenchStack_used(stack);
+  }
+  free(stack);
+  return used;
+}
+
+inline void* Bench_idleThread(void* arg) {
+  return arg;
+}
+
+// stack ที่ thread เปล่าใช้ (libc/pthread) - หักออกจากผลของทุก thread
+inline size_t Bench_baselineStack() {
+  static size_t baseline = Bench_runOnPaintedStack(Bench_idleThread, nullptr);
+  return baseline;
+}
+
+inline size_t Bench_stackAboveBaseline(size_t used) {
+  size_t baseline = Bench_baselineStack();
+  return used > baseline ? used - baseline : 0;
+}
+
+// ===== BenchTask: thread ที่ทา stack ไว้ รองานทีละชิ้นจาก thread อื่น =====
+struct BenchTask {
+  pthread_t thread;
+  void* stack;
+  pthread_mutex_t lock;
+  pthread_cond_t changed;
+  void (*job)(void*);   // nullptr = ว่าง
+  void* arg;
+  bool quit;
+  bool running;
+};
+
+inline void* BenchTask_main(void* arg) {
+  BenchTask* task = (BenchTask*)arg;
+  pthread_mutex_lock(&task->lock);
+  while (true) {
+    while (task->job == nullptr && !task->quit) {
+      pthread_cond_wait(&task->changed, &task->lock);
+    }
+    if (task->job == nullptr) {
+      break;
+    }
+    pthread_mutex_unlock(&task->lock);
+    task->job(task->arg);
+    pthread_mutex_lock(&task->lock);
+    task->job = nullptr;
+    pthread_cond_broadcast(&task->changed);
+  }
+  pthread_mutex_unlock(&task->lock);
+  return nullptr;
+}
+
+inline bool BenchTask_start(BenchTask& task) {
+  task.stack = BenchStack_alloc();
+  task.job = nullptr;
+  task.arg = nullptr;
+  task.quit = false;
+  task.running = false;
+  if (task.stack == nullptr) {
+    return false;
+  }
+  pthread_mutex_init(&task.lock, nullptr);
+  pthread_cond_init(&task.changed, nullptr);
+  task.running = BenchStack_start(task.thread, task.stack, BenchTask_main, &task);
+  return task.running;
+}
+
+// ทำ job(arg) ใน task แล้วรอจนเสร็จ (ไม่ได้ start → ทำใน thread ที่เรียกเลย)
+inline void BenchTask_run(BenchTask& task, void (*job)(void*), void* arg) {
+  if (!task.running) {
+    job(arg);
+    return;
+  }
+  pthread_mutex_lock(&task.lock);
+  task.job = job;
+  task.arg = arg;
+  pthread_cond_broadcast(&task.changed);
+  while (task.job != nullptr) {
+    pthread_cond_wait(&task.changed, &task.lock);
+  }
+  pthread_mutex_unlock(&task.lock);
+}
+
+// หยุด thread แล้วคืน byte ของ stack ที่ใช้
+inline size_t BenchTask_stop(BenchTask& task) {
+  size_t used = 0;
+  if (task.running) {
+    pthread_mutex_lock(&task.lock);
+    task.quit = true;
+    pthread_cond_broadcast(&task.changed);
+    pthread_mutex_unlock(&task.lock);
+    pthread_join(task.thread, nullptr);
+    used = BenchStack_used(task.stack);
+    pthread_mutex_destroy(&task.lock);
+    pthread_cond_destroy(&task.changed);
+    task.running = false;
+  }
+  free(task.stack);
+  task.stack = nullptr;
+  return used;
+}
+
+#endif
@@ -0,0 +1,190 @@
+/**
+ * CacheBench.cpp
+ * เวลาสร้าง JSON ของ GET /api/devices และ /api/changes (center/ReadingCache.h) ที่ 10 และ 100 อุปกรณ์
+ *
+ *   cmake -S esp32/host -B build && cmake --build build
+ *   ./build/cache_bench --passes 2000
+ *
+ * ทุกอุปกรณ์มีค่าครบ 3 ประเภท (BP + idcard / weight-height / temp) - ขนาด JSON ต่ออุปกรณ์สูงสุด
+ * - snapshot: Cache_writeJson(since = 0) ลง buffer ขนาด CACHE_JSON_SIZE ของ board
+ *   ไม่พอ → ถามต่อด้วย since = "generation" จนได้ "complete": true (แบบที่ PC/แอปทำ) = 1 รอบ
+ * - snapshot (buffer 64 KB): หน้าเดียวจบ - ดูต้นทุนของการแบ่งหน้า
+ * - changes: /api/changes หลังมีค่าใหม่ 1 ค่า
+ * ผลที่รายงาน: หน้า, bytes, us ต่อรอบ, allocate ต่อรอบ, stack ที่ใช้ (หัก thread เปล่าแล้ว)
+ * ตรวจด้วยว่าทุกอุปกรณ์อยู่ในผลลัพธ์ (ขาด → exit 1 ให้ ctest ล้ม)
+ *
+ * REGISTRY_CAPACITY ของ firmware = 64 (ESP32) / 16 (ESP8266) → ที่นี่ตั้ง 128 ให้ใส่ 100 อุปกรณ์ได้
+ * ตัวเลขเวลาเป็นของ PC → ใช้เทียบก่อน/หลังแก้โค้ด ไม่ใช่เวลาบนบอร์ด
+ */
+
+#define REGISTRY_CAPACITY 128
+
+#include <chrono>
+#include <set>
+#include <string>
+#include "BenchProbe.h"
+#include <IPAddress.h>
+#include "Config.h"
+#include "ReadingCache.h"
+
+#define CACHE_BENCH_LARGE (64 * 1024)
+
+static char pageBuffer[CACHE_BENCH_LARGE];
+static uint32_t benchNow = 100000;
+volatile long benchSink = 0;
+
+// ===== เตรียมอุปกรณ์ N ตัว ค่าครบทุกประเภท =====
+static void fillDevices(int count) {
+  Registry_begin(DEVICE_TIMEOUT, benchNow);
+  memset((void*)cacheEntries, 0, sizeof(cacheEntries));
+  cacheGeneration = 0;
+
+  for (int i = 0; i < count; i++) {
+    char mac[REGISTRY_MAC_SIZE];
+    char name[REGISTRY_NAME_SIZE];
+    snprintf(mac, sizeof(mac), "24:6F:28:00:%02X:%02X", (i >> 8) & 0xFF, i & 0xFF);
+    snprintf(name, sizeof(name), "ESP32-Station-%03d", i);
+    bool isNew;
+    Registry_update(mac, name, mac, benchNow, isNew);
+    int index = (int)(Registry_find(mac, mac) - registryDevices);
+
+    WireReading bp = { WIRE_KIND_BLOOD_PRESSURE,
+                       WIRE_FIELD_VALUE0 | WIRE_FIELD_VALUE1 | WIRE_FIELD_VALUE2 | WIRE_FIELD_IDCARD,
+                       1103700012345ULL + i, { 127, 82, 74, 0 }, 0 };
+    WireReading weight = { WIRE_KIND_WEIGHT_HEIGHT, WIRE_FIELD_VALUE0 | WIRE_FIELD_VALUE1 | WIRE_FIELD_VALUE2,
+                           0, { 703, 1735, 365, 0 }, 0 };
+    WireReading temp = { WIRE_KIND_TEMP, WIRE_FIELD_VALUE0, 0, { 368, 0, 0, 0 }, 0 };
+    Cache_store(index, bp, 1000 + i, benchNow);
+    Cache_store(index, weight, 2000 + i, benchNow);
+    Cache_store(index, temp, 3000 + i, benchNow);
+  }
+}
+
+// ===== ดึงทั้งหมดแบบ PC: snapshot แล้วถาม /api/changes ต่อจนครบ =====
+struct FetchResult {
+  int pages;
+  size_t bytes;
+};
+
+static uint32_t resumeGeneration(const char* json) {
+  const char* found = strstr(json, "],\"generation\":");
+  return found != nullptr ? strtoul(found + 15, nullptr, 10) : 0;
+}
+
+static FetchResult fetchAll(size_t bufferSize, uint32_t since, std::set<std::string>* seen) {
+  FetchResult result = { 0, 0 };
+  while (result.pages < 1000) {
+    size_t length = Cache_writeJson(pageBuffer, bufferSize, since, benchNow);
+    result.pages++;
+    result.bytes += length;
+    if (seen != nullptr) {
+      for (const char* p = strstr(pageBuffer, "\"deviceId\":\""); p != nullptr; p = strstr(p + 1, "\"deviceId\":\"")) {
+        p += 12;
+        seen->insert(std::string(p, strchr(p, '"') - p));
+      }
+    }
+    if (length == 0 || strstr(pageBuffer, "\"complete\":true") != nullptr) {
+      break;
+    }
+    since = resumeGeneration(pageBuffer);
+  }
+  return result;
+}
+
+static bool checkAllDevices(int count, size_t bufferSize) {
+  std::set<std::string> seen;
+  fetchAll(bufferSize, 0, &seen);
+  if ((int)seen.size() != count) {
+    fprintf(stderr, "❌ %d อุปกรณ์ แต่ได้ %u ใน snapshot (buffer %u bytes)\n",
+            count, (unsigned)seen.size(), (unsigned)bufferSize);
+    return false;
+  }
+  return true;
+}
+
+// ===== วัดเวลา =====
+struct CacheResult {
+  FetchResult fetch;
+  double usPerFetch;
+  double allocationsPerFetch;
+  size_t stack;
+};
+
+struct StackJob {
+  size_t bufferSize;
+  uint32_t since;
+};
+
+static void* fetchOnStack(void* arg) {
+  StackJob* job = (StackJob*)arg;
+  fetchAll(job->bufferSize, job->since, nullptr);
+  return arg;
+}
+
+static CacheResult runFetch(size_t bufferSize, uint32_t since, int passes) {
+  CacheResult result;
+  result.fetch = fetchAll(bufferSize, since, nullptr);
+
+  BenchHeap_begin();
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < passes; pass++) {
+    FetchResult fetch = fetchAll(bufferSize, since, nullptr);
+    benchSink += fetch.bytes;
+  }
+  double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  BenchHeap_end();
+  result.usPerFetch = us / passes;
+  result.allocationsPerFetch = (double)BenchHeap_allocationCount() / passes;
+
+  StackJob job = { bufferSize, since };
+  result.stack = Bench_stackAboveBaseline(Bench_runOnPaintedStack(fetchOnStack, &job));
+  return result;
+}
+
+static void printResult(const char* name, const CacheResult& result) {
+  printf("  %-24s %6d %9u %10.1f %8.2f %8u\n", name, result.fetch.pages, (unsigned)result.fetch.bytes,
+         result.usPerFetch, result.allocationsPerFetch, (unsigned)result.stack);
+}
+
+static int usage() {
+  fprintf(stderr, "usage: cache_bench [--passes N]\n");
+  return 2;
+}
+
+int main(int argc, char** argv) {
+  int passes = 2000;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+      passes = atoi(argv[++i]);
+    } else {
+      return usage();
+    }
+  }
+  if (passes <= 0) {
+    return usage();
+  }
+
+  bool ok = true;
+  const int counts[] = { 10, 100 };
+  for (int c = 0; c < 2; c++) {
+    int count = counts[c];
+    fillDevices(count);
+    ok = checkAllDevices(count, CACHE_JSON_SIZE) && ok;
+    ok = checkAllDevices(count, CACHE_BENCH_LARGE) && ok;
+
+    char label[48];
+    snprintf(label, sizeof(label), "snapshot (%u B)", (unsigned)CACHE_JSON_SIZE);
+    printf("%s%d devices x 3 readings (host CPU / host stack)\n", c == 0 ? "" : "\n", count);
+    printf("  %-24s %6s %9s %10s %8s %8s\n", "request", "pages", "bytes", "us/fetch", "allocs", "stack");
+    printResult(label, runFetch(CACHE_JSON_SIZE, 0, passes));
+    printResult("snapshot (64 KB)", runFetch(CACHE_BENCH_LARGE, 0, passes));
+
+    // ค่าใหม่ 1 ค่าที่อุปกรณ์กลางตาราง → /api/changes?since=<ก่อนหน้า>
+    uint32_t since = cacheGeneration;
+    WireReading temp = { WIRE_KIND_TEMP, WIRE_FIELD_VALUE0, 0, { 371, 0, 0, 0 }, 0 };
+    Cache_store(count / 2, temp, 9999, benchNow);
+    printResult("changes (1 reading)", runFetch(CACHE_JSON_SIZE, since, passes));
+  }
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,390 @@
+/**
+ * ParserBench.cpp
+ * เทียบ parser ปัจจุบันกับวิธีเดิม (ก่อนแยก header) บนข้อมูลชุดเดียวกัน
+ *
+ *   cmake -S esp32/host -B build && cmake --build build
+ *   ./build/parser_bench --passes 20000
+ *
+ * weight-text: Weight_tokenizeLine() (char* → หน่วย 0.1) กับ RS232_parseLine() เดิม
+ *              (String.indexOf + ต่อ String ทีละตัว + toFloat - ตัด Serial.print ออก)
+ * bp-json:     BP_extractReading() (filter + StaticJsonDocument<128> + struct) กับ RS232_processJSON() เดิม
+ *              (String → StaticJsonDocument<2048> ทั้งเฟรม → sendDoc<256> → serializeJson เป็น String)
+ *              ต้องมี ArduinoJson (HOST_HAVE_ARDUINOJSON)
+ * ผลที่รายงาน: ns ต่อบรรทัด/เฟรม (CPU ของ PC), จำนวนครั้งที่ allocate ต่อบรรทัด/เฟรม (operator new)
+ *              bp-json เพิ่ม heap สูงสุดต่อเฟรม และ stack ที่ใช้ parse หนึ่งเฟรม (BenchProbe.h)
+ * ตรวจด้วยว่าทั้งสองวิธีได้ค่าเท่ากันทุกบรรทัด/เฟรม (ไม่เท่า → exit 1 ให้ ctest ล้ม)
+ *
+ * String ของ shim เป็น std::string (มี small-string buffer) → allocate น้อยกว่า String ของบอร์ด
+ * ตัวเลขทั้งหมดเป็นของ PC → ใช้เทียบสองวิธีบนเครื่องเดียวกัน ไม่ใช่เวลาบนบอร์ด
+ */
+
+#include <chrono>
+#include "BenchProbe.h"
+#include "WeightParser.h"
+#ifdef HOST_HAVE_ARDUINOJSON
+#include "BPParser.h"
+#endif
+
+// ===== วิธีเดิม (RS232Reader_Weight.h ก่อนแยก WeightParser.h) =====
+struct LegacyWeight {
+  float weight;
+  float height;
+  float temp;
+  bool hasWeight;
+  bool hasHeight;
+  bool hasTemp;
+};
+
+LegacyWeight legacy;
+
+void Legacy_parseLine(String line) {
+  line.trim();
+  if (line.length() == 0) return;
+
+  int wIdx = line.indexOf("W:");
+  if (wIdx >= 0) {
+    String wStr = "";
+    for (int i = wIdx + 2; i < (int)line.length(); i++) {
+      char c = line[i];
+      if (c == ' ' || c == '\t') break;
+      if ((c >= '0' && c <= '9') || c == '.') wStr += c;
+    }
+    if (wStr.length() > 0) {
+      legacy.weight = wStr.toFloat();
+      legacy.hasWeight = true;
+    }
+  }
+
+  int hIdx = line.indexOf("H:");
+  if (hIdx >= 0) {
+    String hStr = "";
+    for (int i = hIdx + 2; i < (int)line.length(); i++) {
+      char c = line[i];
+      if (c == ' ' || c == '\t') break;
+      if ((c >= '0' && c <= '9') || c == '.') hStr += c;
+    }
+    if (hStr.length() > 0) {
+      legacy.height = hStr.toFloat();
+      legacy.hasHeight = true;
+    }
+  }
+
+  int tIdx = line.indexOf("T");
+  while (tIdx >= 0) {
+    int dollarIdx = line.indexOf("$", tIdx + 1);
+    if (dollarIdx > tIdx + 1) {
+      String tStr = line.substring(tIdx + 1, dollarIdx);
+      bool allDigits = true;
+      for (int i = 0; i < (int)tStr.length(); i++) {
+        if (tStr[i] < '0' || tStr[i] > '9') { allDigits = false; break; }
+      }
+      if (allDigits && tStr.length() >= 2) {
+        legacy.temp = tStr.toFloat() / 10.0;
+        legacy.hasTemp = true;
+        break;
+      }
+    }
+    tIdx = line.indexOf("T", tIdx + 1);
+  }
+}
+
+// ===== ข้อมูล: บรรทัดแบบที่เครื่องชั่ง/ส่วนสูง/วัดไข้ส่ง =====
+// เฉพาะรูปแบบที่วิธีเดิมอ่านได้ (วิธีเดิมไม่รับช่องว่างหลัง "W:" / ค่าติดลบ - ดู WeightParserTest.cpp)
+static const char* const WEIGHT_LINES[] = {
+  "W:070.3 H:173.5",
+  "W:055.2 H:160.0",
+  "W:102.8 H:181.2",
+  "H:165.4",
+  "W:048.9",
+  "T365$",
+  "T372$",
+  "ST,GS W:071.1 H:174.0",
+  "W:000.0 H:000.0",
+};
+static const int WEIGHT_LINE_COUNT = sizeof(WEIGHT_LINES) / sizeof(WEIGHT_LINES[0]);
+
+static long toTenths(float value) {
+  return lroundf(value * 10);
+}
+
+// ทั้งสองวิธีต้องได้ค่าเดียวกัน (หน่วย 0.1)
+static bool checkWeightAgreement() {
+  bool agree = true;
+  for (int i = 0; i < WEIGHT_LINE_COUNT; i++) {
+    WeightReading reading = { 0, 0, 0, 0 };
+    uint8_t found = Weight_tokenizeLine(WEIGHT_LINES[i], reading);
+    legacy = LegacyWeight();
+    Legacy_parseLine(WEIGHT_LINES[i]);
+
+    bool same = ((found & WEIGHT_FIELD_WEIGHT) != 0) == legacy.hasWeight &&
+                ((found & WEIGHT_FIELD_HEIGHT) != 0) == legacy.hasHeight &&
+                ((found & WEIGHT_FIELD_TEMP) != 0) == legacy.hasTemp &&
+                (!legacy.hasWeight || toTenths(legacy.weight) == reading.weightTenths) &&
+                (!legacy.hasHeight || toTenths(legacy.height) == reading.heightTenths) &&
+                (!legacy.hasTemp || toTenths(legacy.temp) == reading.tempTenths);
+    if (!same) {
+      fprintf(stderr, "❌ ผลไม่ตรงกัน: \"%s\"\n", WEIGHT_LINES[i]);
+      agree = false;
+    }
+  }
+  return agree;
+}
+
+#ifdef HOST_HAVE_ARDUINOJSON
+// ===== วิธีเดิม (RS232Reader_BP.h ก่อนแยก BPParser.h) =====
+// ค่าที่ส่งต่อเก็บใน legacyBp เพิ่มจาก sendDoc เพื่อเทียบกับ BPReading
+struct LegacyBP {
+  String idcard;
+  int bp;
+  int bp2;
+  int pulse;
+  bool hasIdcard;
+  bool hasBp;
+  bool hasBp2;
+  bool hasPulse;
+  String sent;         // JSON ที่ส่งต่อให้ callback
+};
+
+LegacyBP legacyBp;
+
+bool Legacy_processJSON(String json) {
+  StaticJsonDocument<2048> doc;
+  DeserializationError error = deserializeJson(doc, json);
+
+  if (error) {
+    return false;
+  }
+
+  StaticJsonDocument<256> sendDoc;
+  bool hasData = false;
+
+  if (doc.containsKey("idcard")) {
+    String idcard = doc["idcard"].as<String>();
+    sendDoc["idcard"] = idcard;
+    legacyBp.idcard = idcard;
+    legacyBp.hasIdcard = true;
+    hasData = true;
+  }
+
+  if (doc.containsKey("blood_pressure_h")) {
+    int bpH = doc["blood_pressure_h"].as<int>();
+    sendDoc["bp"] = bpH;
+    legacyBp.bp = bpH;
+    legacyBp.hasBp = true;
+    hasData = true;
+  }
+
+  if (doc.containsKey("blood_pressure_l")) {
+    int bpL = doc["blood_pressure_l"].as<int>();
+    sendDoc["bp2"] = bpL;
+    legacyBp.bp2 = bpL;
+    legacyBp.hasBp2 = true;
+    hasData = true;
+  }
+
+  if (doc.containsKey("heart_rate")) {
+    int hr = doc["heart_rate"].as<int>();
+    sendDoc["pulse"] = hr;
+    legacyBp.pulse = hr;
+    legacyBp.hasPulse = true;
+    hasData = true;
+  }
+
+  if (hasData) {
+    String jsonStr;
+    serializeJson(sendDoc, jsonStr);
+    legacyBp.sent = jsonStr;
+  }
+  return hasData;
+}
+
+// ===== ข้อมูล: เฟรมแบบใน streams/bp-json.stream (400+ bytes) =====
+// เฟรมที่ 2 ส่ง idcard เป็นตัวเลข / เฟรมที่ 3 ไม่มี heart_rate
+static const char* const BP_FRAMES[] = {
+  "{\"end_time\":\"2026-10-17 09:10:00\",\"start_time\":\"2026-10-17 09:09:25\",\"device_model\":\"BP-900\","
+  "\"serial_no\":\"BP9A0031884\",\"idcard\":\"1103700012345\",\"name\":\"\",\"sex\":\"\",\"age\":\"\","
+  "\"blood_pressure_h\":127,\"blood_pressure_l\":82,\"heart_rate\":74,\"mean_pressure\":97,"
+  "\"irregular_heartbeat\":0,\"body_movement\":0,\"cuff_fit\":1,\"measure_mode\":\"auto\",\"arm\":\"left\","
+  "\"error_code\":0,\"retry\":0,\"unit\":\"mmHg\",\"firmware\":\"2.14.7\"}",
+  "{\"end_time\":\"2026-10-17 09:11:17\",\"start_time\":\"2026-10-17 09:10:42\",\"device_model\":\"BP-900\","
+  "\"serial_no\":\"BP9A0031884\",\"idcard\":3100500654321,\"name\":\"\",\"sex\":\"\",\"age\":\"\","
+  "\"blood_pressure_h\":118,\"blood_pressure_l\":76,\"heart_rate\":68,\"mean_pressure\":90,"
+  "\"irregular_heartbeat\":0,\"body_movement\":0,\"cuff_fit\":1,\"measure_mode\":\"auto\",\"arm\":\"left\","
+  "\"error_code\":0,\"retry\":0,\"unit\":\"mmHg\",\"firmware\":\"2.14.7\"}",
+  "{\"end_time\":\"2026-10-17 09:12:34\",\"start_time\":\"2026-10-17 09:11:59\",\"device_model\":\"BP-900\","
+  "\"serial_no\":\"BP9A0031884\",\"idcard\":\"1409900112233\",\"name\":\"\",\"sex\":\"\",\"age\":\"\","
+  "\"blood_pressure_h\":141,\"blood_pressure_l\":93,\"mean_pressure\":109,"
+  "\"irregular_heartbeat\":1,\"body_movement\":0,\"cuff_fit\":1,\"measure_mode\":\"auto\",\"arm\":\"right\","
+  "\"error_code\":0,\"retry\":1,\"unit\":\"mmHg\",\"firmware\":\"2.14.7\"}",
+};
+static const int BP_FRAME_COUNT = sizeof(BP_FRAMES) / sizeof(BP_FRAMES[0]);
+
+// BP_extractReading แก้ buffer (zero-copy) → copy เฟรมใหม่ทุกครั้ง เหมือนเฟรมที่ Framer เพิ่งเก็บ
+static char bpFrame[1024];
+
+static DeserializationError extractFrame(int index, BPReading& reading) {
+  size_t length = strlen(BP_FRAMES[index]);
+  memcpy(bpFrame, BP_FRAMES[index], length + 1);
+  return BP_extractReading(bpFrame, length, reading);
+}
+
+static bool checkBPAgreement() {
+  bool agree = true;
+  for (int i = 0; i < BP_FRAME_COUNT; i++) {
+    BPReading reading;
+    bool parsed = !extractFrame(i, reading);
+    legacyBp = LegacyBP();
+    bool legacyParsed = Legacy_processJSON(BP_FRAMES[i]);
+
+    bool same = parsed == legacyParsed &&
+                ((reading.fields & BP_FIELD_IDCARD) != 0) == legacyBp.hasIdcard &&
+                ((reading.fields & BP_FIELD_BP) != 0) == legacyBp.hasBp &&
+                ((reading.fields & BP_FIELD_BP2) != 0) == legacyBp.hasBp2 &&
+                ((reading.fields & BP_FIELD_PULSE) != 0) == legacyBp.hasPulse &&
+                (!legacyBp.hasIdcard || strcmp(legacyBp.idcard.c_str(), reading.idcard) == 0) &&
+                (!legacyBp.hasBp || legacyBp.bp == reading.bp) &&
+                (!legacyBp.hasBp2 || legacyBp.bp2 == reading.bp2) &&
+                (!legacyBp.hasPulse || legacyBp.pulse == reading.pulse);
+    if (!same) {
+      fprintf(stderr, "❌ ผลไม่ตรงกัน: bp-json เฟรมที่ %d\n", i + 1);
+      agree = false;
+    }
+  }
+  return agree;
+}
+#endif
+
+struct ParserResult {
+  double nsPerLine;
+  double allocationsPerLine;
+};
+
+volatile long benchSink = 0;
+
+static ParserResult runWeightLegacy(int passes) {
+  BenchHeap_begin();
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < passes; pass++) {
+    for (int i = 0; i < WEIGHT_LINE_COUNT; i++) {
+      Legacy_parseLine(WEIGHT_LINES[i]);
+      benchSink += (long)legacy.weight;
+    }
+  }
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  BenchHeap_end();
+  double lines = (double)passes * WEIGHT_LINE_COUNT;
+  ParserResult result = { ns / lines, BenchHeap_allocationCount() / lines };
+  return result;
+}
+
+static ParserResult runWeightTokenize(int passes) {
+  BenchHeap_begin();
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < passes; pass++) {
+    for (int i = 0; i < WEIGHT_LINE_COUNT; i++) {
+      WeightReading reading = { 0, 0, 0, 0 };
+      Weight_tokenizeLine(WEIGHT_LINES[i], reading);
+      benchSink += reading.weightTenths;
+    }
+  }
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  BenchHeap_end();
+  double lines = (double)passes * WEIGHT_LINE_COUNT;
+  ParserResult result = { ns / lines, BenchHeap_allocationCount() / lines };
+  return result;
+}
+
+#ifdef HOST_HAVE_ARDUINOJSON
+struct BPResult {
+  ParserResult parse;
+  size_t peakHeap;     // byte สูงสุดที่ allocate ค้างพร้อมกัน
+  size_t stack;        // byte ของ stack ที่ใช้ parse หนึ่งเฟรม (หัก thread เปล่าแล้ว)
+};
+
+// วิธีเดิมได้เฟรมเป็น String (jsonBuffer.substring) → สร้าง String ในรอบที่จับเวลาด้วย
+static void runBPLegacyOnce(int index) {
+  Legacy_processJSON(String(BP_FRAMES[index]));
+  benchSink += legacyBp.bp;
+}
+
+static void runBPExtractOnce(int index) {
+  BPReading reading;
+  extractFrame(index, reading);
+  benchSink += reading.bp;
+}
+
+static void* bpLegacyStack(void* arg) {
+  runBPLegacyOnce(0);
+  return arg;
+}
+
+static void* bpExtractStack(void* arg) {
+  runBPExtractOnce(0);
+  return arg;
+}
+
+static BPResult runBP(void (*once)(int), void* (*onStack)(void*), int passes) {
+  BenchHeap_begin();
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < passes; pass++) {
+    for (int i = 0; i < BP_FRAME_COUNT; i++) {
+      once(i);
+    }
+  }
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  BenchHeap_end();
+  double frames = (double)passes * BP_FRAME_COUNT;
+  BPResult result = { { ns / frames, BenchHeap_allocationCount() / frames }, BenchHeap_peakBytes(),
+                      Bench_stackAboveBaseline(Bench_runOnPaintedStack(onStack, nullptr)) };
+  return result;
+}
+
+static void printBPResult(const char* name, const BPResult& result) {
+  printf("  %-34s %10.1f %12.2f %10zu %10zu\n", name, result.parse.nsPerLine, result.parse.allocationsPerLine,
+         result.peakHeap, result.stack);
+}
+#endif
+
+static void printResult(const char* name, const ParserResult& result) {
+  printf("  %-34s %10.1f %12.2f\n", name, result.nsPerLine, result.allocationsPerLine);
+}
+
+static int usage() {
+  fprintf(stderr, "usage: parser_bench [--passes N]\n");
+  return 2;
+}
+
+int main(int argc, char** argv) {
+  int passes = 20000;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+      passes = atoi(argv[++i]);
+    } else {
+      return usage();
+    }
+  }
+  if (passes <= 0) {
+    return usage();
+  }
+
+  bool ok = checkWeightAgreement();
+
+  printf("weight-text: %d lines x %d passes (host CPU)\n", WEIGHT_LINE_COUNT, passes);
+  printf("  %-34s %10s %12s\n", "parser", "ns/line", "allocs/line");
+  printResult("String + toFloat (legacy)", runWeightLegacy(passes));
+  printResult("Weight_tokenizeLine", runWeightTokenize(passes));
+
+#ifdef HOST_HAVE_ARDUINOJSON
+  BP_beginFilter();
+  ok = checkBPAgreement() && ok;
+
+  // BP: เฟรมใหญ่กว่า → ใช้รอบน้อยกว่า weight-text
+  int bpPasses = std::max(1, passes / 10);
+  printf("\nbp-json: %d frames x %d passes (host CPU / host stack)\n", BP_FRAME_COUNT, bpPasses);
+  printf("  %-34s %10s %12s %10s %10s\n", "parser", "ns/frame", "allocs/frame", "peak heap", "stack");
+  printBPResult("StaticJsonDocument<2048> (legacy)", runBP(runBPLegacyOnce, bpLegacyStack, bpPasses));
+  printBPResult("BP_extractReading", runBP(runBPExtractOnce, bpExtractStack, bpPasses));
+#endif
+
+  return ok ? 0 : 1;
+}
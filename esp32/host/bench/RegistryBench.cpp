@@ -0,0 +1,210 @@
+/**
+ * RegistryBench.cpp
+ * เทียบตารางอุปกรณ์ของ Center (center/DeviceRegistry.h) กับ vector<DeviceInfo> + String ของเดิม
+ *
+ *   cmake -S esp32/host -B build && cmake --build build
+ *   ./build/registry_bench --passes 100000
+ *
+ * 1 op = ที่ loop() ของ Center ทำต่อ reading: อัพเดทอุปกรณ์ที่ส่งมา + ตรวจอุปกรณ์ที่หมดเวลา + นับออนไลน์ (LED แดง)
+ * - ปัจจุบัน: Registry_update() + Registry_expire() ทุกรอบ + Registry_getOnlineCount()
+ * - เดิม (ก่อนใช้ DeviceRegistry.h): updateDevice(String...) วนหาด้วย deviceId, cleanupOfflineDevices()
+ *   ทุก CLEANUP_INTERVAL, getOnlineDeviceCount() วนนับ (โค้ดเดิมแบบ ESP32 ไม่รวม Serial.print)
+ * อุปกรณ์ 10 และ 60 ตัว ส่งสลับกันทุก 10 ms (นาฬิกาจำลอง) - 1/4 ส่งห่างกว่า DEVICE_TIMEOUT → ออฟไลน์/กลับมาซ้ำๆ
+ * ผลที่รายงาน: ns ต่อ op และ allocate ต่อ op
+ * ตรวจด้วยว่าทั้งสองวิธีได้รายชื่อและ lastSeen เท่ากัน (ไม่เท่า → exit 1 ให้ ctest ล้ม)
+ *
+ * ตัวเลขเวลาเป็นของ PC และ String ของ shim คือ std::string → ใช้เทียบสองวิธีบนเครื่องเดียวกัน ไม่ใช่เวลาบนบอร์ด
+ */
+
+#include <chrono>
+#include <vector>
+#include "BenchProbe.h"
+#include <IPAddress.h>
+#include "Config.h"
+#include "DeviceRegistry.h"
+
+#define LEGACY_CLEANUP_INTERVAL 10000   // CLEANUP_INTERVAL ของ Config.h เดิม
+#define BENCH_STEP_MS 10
+
+volatile long benchSink = 0;
+
+// ===== วิธีเดิม =====
+struct DeviceInfo {
+  String deviceId;
+  String deviceName;
+  String macAddress;
+  unsigned long lastSeen;
+  bool online;
+};
+
+static std::vector<DeviceInfo> connectedDevices;
+static unsigned long lastCleanup = 0;
+
+static void Legacy_updateDevice(String deviceId, String deviceName, String mac, unsigned long now) {
+  for (auto &device : connectedDevices) {
+    if (device.deviceId == deviceId) {
+      device.lastSeen = now;
+      device.online = true;
+      device.deviceName = deviceName;
+      device.macAddress = mac;
+      return;
+    }
+  }
+  DeviceInfo newDevice;
+  newDevice.deviceId = deviceId;
+  newDevice.deviceName = deviceName;
+  newDevice.macAddress = mac;
+  newDevice.lastSeen = now;
+  newDevice.online = true;
+  connectedDevices.push_back(newDevice);
+}
+
+static void Legacy_cleanupOfflineDevices(unsigned long now) {
+  for (auto &device : connectedDevices) {
+    if (device.online && (now - device.lastSeen > DEVICE_TIMEOUT)) {
+      device.online = false;
+    }
+  }
+}
+
+static int Legacy_getOnlineDeviceCount() {
+  int count = 0;
+  for (const auto &device : connectedDevices) {
+    if (device.online) count++;
+  }
+  return count;
+}
+
+// ===== ลำดับการส่งของอุปกรณ์ (เหมือนกันทั้งสองวิธี) =====
+struct BenchDevice {
+  char mac[REGISTRY_MAC_SIZE];
+  char name[REGISTRY_NAME_SIZE];
+};
+
+static std::vector<BenchDevice> benchDevices;
+
+static void makeDevices(int count) {
+  benchDevices.resize(count);
+  for (int i = 0; i < count; i++) {
+    snprintf(benchDevices[i].mac, sizeof(benchDevices[i].mac), "24:6F:28:00:00:%02X", i & 0xFF);
+    snprintf(benchDevices[i].name, sizeof(benchDevices[i].name), "ESP32-Station-%02d", i);
+  }
+}
+
+// op ที่ n: อุปกรณ์ตัวไหนส่ง - 1/4 สุดท้ายส่งเฉพาะช่วงครึ่งหลังของทุก 2 x DEVICE_TIMEOUT
+static int senderAt(long n, int count) {
+  int device = (int)((n * 7) % count);
+  int quiet = count - count / 4;
+  unsigned long now = (unsigned long)n * BENCH_STEP_MS;
+  if (device >= quiet && (now / DEVICE_TIMEOUT) % 2 == 0) {
+    device = device % quiet;
+  }
+  return device;
+}
+
+static void runRegistry(long ops, int count) {
+  Registry_begin(DEVICE_TIMEOUT, 0);
+  for (long n = 0; n < ops; n++) {
+    unsigned long now = (unsigned long)n * BENCH_STEP_MS;
+    const BenchDevice& device = benchDevices[senderAt(n, count)];
+    bool isNew;
+    Registry_update(device.mac, device.name, device.mac, now, isNew);
+    Registry_expire(now, nullptr);
+    benchSink += Registry_getOnlineCount();
+  }
+}
+
+static void runLegacy(long ops, int count) {
+  connectedDevices.clear();
+  connectedDevices.shrink_to_fit();
+  lastCleanup = 0;
+  for (long n = 0; n < ops; n++) {
+    unsigned long now = (unsigned long)n * BENCH_STEP_MS;
+    const BenchDevice& device = benchDevices[senderAt(n, count)];
+    // processVitals เดิมส่ง String ที่อ่านจาก JsonDocument
+    Legacy_updateDevice(String(device.mac), String(device.name), String(device.mac), now);
+    if (now - lastCleanup > LEGACY_CLEANUP_INTERVAL) {
+      Legacy_cleanupOfflineDevices(now);
+      lastCleanup = now;
+    }
+    benchSink += Legacy_getOnlineDeviceCount();
+  }
+}
+
+// รายชื่อและ lastSeen ต้องเท่ากัน
+static bool checkAgreement(long ops, int count) {
+  runRegistry(ops, count);
+  runLegacy(ops, count);
+  if ((int)connectedDevices.size() != Registry_getCount()) {
+    fprintf(stderr, "❌ %d อุปกรณ์: เดิมมี %u ตัว ปัจจุบัน %d ตัว\n",
+            count, (unsigned)connectedDevices.size(), Registry_getCount());
+    return false;
+  }
+  for (const auto &legacy : connectedDevices) {
+    const RegistryDevice* device = Registry_find(legacy.macAddress.c_str(), legacy.deviceId.c_str());
+    if (device == nullptr || device->lastSeen != legacy.lastSeen) {
+      fprintf(stderr, "❌ %s: lastSeen ไม่ตรงกัน\n", legacy.deviceId.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+struct RegistryResult {
+  double nsPerOp;
+  double allocationsPerOp;
+};
+
+static RegistryResult measure(void (*run)(long, int), long ops, int count) {
+  RegistryResult result;
+  run(ops / 10, count);   // warm up
+  BenchHeap_begin();
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  run(ops, count);
+  double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+  BenchHeap_end();
+  result.nsPerOp = ns / ops;
+  result.allocationsPerOp = (double)BenchHeap_allocationCount() / ops;
+  return result;
+}
+
+static void printResult(const char* name, const RegistryResult& result) {
+  printf("  %-36s %10.1f %12.2f\n", name, result.nsPerOp, result.allocationsPerOp);
+}
+
+static int usage() {
+  fprintf(stderr, "usage: registry_bench [--passes N]\n");
+  return 2;
+}
+
+int main(int argc, char** argv) {
+  long passes = 100000;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+      passes = atol(argv[++i]);
+    } else {
+      return usage();
+    }
+  }
+  if (passes <= 0) {
+    return usage();
+  }
+
+  bool ok = true;
+  const int counts[] = { 10, 60 };
+  for (int c = 0; c < 2; c++) {
+    int count = counts[c];
+    if (count > REGISTRY_CAPACITY) {
+      continue;   // ESP8266: REGISTRY_CAPACITY 16
+    }
+    makeDevices(count);
+    ok = checkAgreement(passes, count) && ok;
+
+    printf("%s%d devices x %ld ops, 1 op ต่อ %d ms (host CPU)\n", c == 0 ? "" : "\n", count, passes, BENCH_STEP_MS);
+    printf("  %-36s %10s %12s\n", "registry", "ns/op", "allocs/op");
+    printResult("DeviceRegistry.h", measure(runRegistry, passes, count));
+    printResult("legacy vector<DeviceInfo> + String", measure(runLegacy, passes, count));
+  }
+
+  return ok ? 0 : 1;
+}
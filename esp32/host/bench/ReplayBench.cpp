@@ -0,0 +1,433 @@
+/**
+ * ReplayBench.cpp
+ * เล่นไฟล์ .stream (byte จาก RS232 + เวลา) ผ่านเส้นทางเดียวกับ firmware ของอุปกรณ์:
+ *   UART chunk → Framer → (ESP32: FrameQueue) → Parser → pack WireReading → Journal + Outbox → ack
+ * (ลำดับเดียวกับ RS232Reader.h + queueWireReading()/queueToCenter() ใน ESP32_RS232.ino)
+ *
+ *   cmake -S esp32/host -B build && cmake --build build
+ *   ./build/replay_bench esp32/host/streams/weight-text.stream --repeat 200
+ *
+ * ผลที่รายงาน:
+ * - readings/s: ที่สายส่งได้ (เวลาจำลองตาม baud/@gap) และที่ CPU ของ PC ทำได้ (เฉพาะเวลาใน stage)
+ * - latency ต่อ stage: wire = byte แรกของเฟรมออกจากเครื่อง → Framer ได้เฟรมครบ (เวลาจำลอง, us)
+ *                       framer/parse/journal/ack = CPU ของ PC ต่อเฟรม/reading (ns)
+ * - heap: operator new ระหว่าง replay (firmware ไม่ควร allocate เลย)
+ * - stack: high-water ต่อ task (BenchProbe.h - หัก thread เปล่าออกแล้ว)
+ *     ESP32:   rs232 = UART chunk → Framer → FrameQueue (RS232_ingestTask)
+ *              loop  = FrameQueue → Parser → Journal/Outbox/ack (loop()) - แยก thread ส่งงานให้ทีละ tick
+ *     ESP8266: loop  = ทุก stage (ไม่มี ingest task)
+ *
+ * ตัวเลข CPU/stack เป็นของ PC (x86-64/ARM64 ไม่ใช่ Xtensa, LittleFS เป็นของ shim ใน RAM ไม่ใช่ flash)
+ * → ใช้เทียบก่อน/หลังแก้โค้ดบนเครื่องเดียวกัน ไม่ใช่ความจุของบอร์ด
+ * UART: ส่ง chunk ให้ Framer เมื่อครบ UART_RX_FULL byte หรือสายเงียบ UART_RX_TIMEOUT byte (แบบ UART driver)
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+#include "BenchProbe.h"
+#include "ProtocolRegistry.h"
+#include "WeightTextProtocol.h"
+#ifdef HOST_HAVE_ARDUINOJSON
+  #include "BPJsonProtocol.h"
+#endif
+#include "WireProtocol.h"
+#include "Journal.h"
+#include "Outbox.h"
+#ifdef ESP32
+  #include "FrameQueue.h"
+#endif
+#include "ReplayStream.h"
+
+// ===== Configuration =====
+#define UART_RX_FULL 120              // byte ใน FIFO ที่ทำให้ driver ส่ง chunk
+#define UART_RX_TIMEOUT 2             // byte-time ที่สายเงียบแล้ว driver ส่ง chunk ที่ค้าง
+#define REPLAY_TICK_MS 10             // ระหว่างสายเงียบ: ตรวจ idle/poll ทุกเท่านี้ (แทน loop())
+#define REPLAY_RS232_STACK 4096       // = RS232_INGEST_STACK ใน RS232Reader.h (byte ของ FreeRTOS)
+
+#ifdef HOST_HAVE_ARDUINOJSON
+typedef ProtocolList<BPJsonProtocol, WeightTextProtocol> BenchProtocols;
+#else
+typedef ProtocolList<WeightTextProtocol> BenchProtocols;   // bp-json ต้องมี ArduinoJson
+#endif
+
+// ===== ผลของ replay =====
+struct BenchStats {
+  unsigned long frames;
+  unsigned long readings;
+  unsigned long dropped;           // OVERFLOW / CORRUPT / INCOMPLETE
+  unsigned long parseErrors;
+  std::vector<uint32_t> wireUs;    // เวลาจำลอง
+  std::vector<uint32_t> framerNs;  // CPU
+  std::vector<uint32_t> parseNs;
+  std::vector<uint32_t> journalNs;
+  std::vector<uint32_t> ackNs;
+  uint64_t cpuNs;                  // รวมทุก stage
+};
+
+BenchStats stats;
+uint32_t frameStartUs = 0;         // byte แรกของเฟรมที่กำลังรับ
+uint64_t frameFramerNs = 0;        // CPU ของ Framer สะสมของเฟรมที่กำลังรับ
+#ifdef ESP32
+FrameQueue benchFrames;
+BenchTask loopTask;                // loop() ของ Arduino (core 1) - thread หลักเป็น RS232 task
+#endif
+
+typedef std::chrono::steady_clock BenchClock;
+
+inline uint32_t Bench_elapsedNs(BenchClock::time_point start) {
+  return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(BenchClock::now() - start).count();
+}
+
+template <typename P>
+struct ReplayState {
+  static typename P::Framer framer;
+  static typename P::Parser parser;
+};
+
+template <typename P>
+typename P::Framer ReplayState<P>::framer;
+
+template <typename P>
+typename P::Parser ReplayState<P>::parser;
+
+// ===== reading → Journal + Outbox แล้ว Center ตอบรับทันที (queueWireReading + noteDelivered) =====
+inline void Bench_emit(WireReading& reading) {
+  BenchClock::time_point start = BenchClock::now();
+  reading.timestamp = millis();
+  uint8_t packed[WIRE_READING_SIZE];
+  Wire_packReading(packed, reading);
+  uint32_t seq = Journal_append((const char*)packed, sizeof(packed), "reading");
+  Outbox_push((const char*)packed, sizeof(packed), "reading", seq, millis());
+  uint32_t journalNs = Bench_elapsedNs(start);
+
+  start = BenchClock::now();
+  OutboxEntry* entry = Outbox_peek();
+  if (entry != nullptr) {
+    Journal_ack(entry->seq);
+    Outbox_pop();
+  }
+  uint32_t ackNs = Bench_elapsedNs(start);
+
+  stats.journalNs.push_back(journalNs);
+  stats.ackNs.push_back(ackNs);
+  stats.cpuNs += journalNs + ackNs;
+  stats.readings++;
+}
+
+template <typename P>
+void Bench_parse(char* data, size_t length) {
+  WireReading reading;
+  BenchClock::time_point start = BenchClock::now();
+  ProtocolParseResult result = P::parse(ReplayState<P>::parser, data, length, millis(), reading);
+  uint32_t parseNs = Bench_elapsedNs(start);
+  stats.parseNs.push_back(parseNs);
+  stats.cpuNs += parseNs;
+
+  if (result == PROTOCOL_PARSE_READING) {
+    Bench_emit(reading);
+  } else if (result == PROTOCOL_PARSE_ERROR) {
+    stats.parseErrors++;
+  }
+}
+
+// ===== ผลของ Framer (RS232_onFrameResult) =====
+template <typename P>
+void Bench_onFrameResult(ProtocolFrameResult result, uint32_t deliveredUs) {
+  typename P::Framer& framer = ReplayState<P>::framer;
+  if (result == PROTOCOL_FRAME_READY) {
+    stats.frames++;
+    stats.wireUs.push_back(deliveredUs - frameStartUs);
+    stats.framerNs.push_back((uint32_t)frameFramerNs);
+    size_t length;
+    char* data = P::frame(framer, length);
+    #ifdef ESP32
+      BenchClock::time_point start = BenchClock::now();
+      FrameQueue_push(benchFrames, data, length, frameStartUs, deliveredUs);
+      stats.cpuNs += Bench_elapsedNs(start);
+    #else
+      Bench_parse<P>(data, length);
+    #endif
+    P::reset(framer);
+  } else if (result != PROTOCOL_FRAME_NONE) {
+    stats.dropped++;
+  }
+  frameFramerNs = 0;
+}
+
+// ===== loop(): เฟรมในคิว (ESP32) + ค่าที่รอคู่/รอนิ่ง =====
+template <typename P>
+void Bench_loopBody(void*) {
+  #ifdef ESP32
+    QueuedFrame* frame;
+    while ((frame = FrameQueue_peek(benchFrames)) != nullptr) {
+      Bench_parse<P>(frame->data, frame->length);
+      FrameQueue_pop(benchFrames);
+    }
+  #endif
+  WireReading reading;
+  if (P::poll(ReplayState<P>::parser, millis(), reading) == PROTOCOL_PARSE_READING) {
+    Bench_emit(reading);
+  }
+}
+
+template <typename P>
+void Bench_loop() {
+  #ifdef ESP32
+    BenchTask_run(loopTask, Bench_loopBody<P>, nullptr);
+  #else
+    Bench_loopBody<P>(nullptr);
+  #endif
+}
+
+// ===== 1 chunk จาก UART driver (RS232_ingest) =====
+// byte ที่ i ออกจากเครื่องตอน firstByteUs + i * byteUs / chunk ถึง Framer ตอน deliveredUs
+template <typename P>
+void Bench_ingest(const char* data, size_t length, uint32_t firstByteUs, uint32_t byteUs, uint32_t deliveredUs) {
+  typename P::Framer& framer = ReplayState<P>::framer;
+  BenchClock::time_point start = BenchClock::now();
+  for (size_t i = 0; i < length; i++) {
+    if (!P::inFrame(framer)) {
+      frameStartUs = firstByteUs + i * byteUs;
+    }
+    ProtocolFrameResult result = P::push(framer, data[i]);
+    if (result != PROTOCOL_FRAME_NONE) {
+      uint32_t segmentNs = Bench_elapsedNs(start);
+      frameFramerNs += segmentNs;
+      stats.cpuNs += segmentNs;
+      Bench_onFrameResult<P>(result, deliveredUs);
+      start = BenchClock::now();
+    }
+  }
+  uint32_t tailNs = Bench_elapsedNs(start);
+  frameFramerNs += tailNs;
+  stats.cpuNs += tailNs;
+}
+
+// ===== สายเงียบ: idle timeout ของ Framer + loop() ทุก REPLAY_TICK_MS =====
+template <typename P>
+void Bench_wait(uint32_t ms, uint32_t lastByteMs) {
+  typename P::Framer& framer = ReplayState<P>::framer;
+  for (uint32_t waited = 0; waited < ms; waited += REPLAY_TICK_MS) {
+    Host_advanceMillis(std::min<uint32_t>(REPLAY_TICK_MS, ms - waited));
+    if (P::inFrame(framer) && millis() - lastByteMs > P::IDLE_TIMEOUT) {
+      ProtocolFrameResult result = P::idle(framer);
+      if (result != PROTOCOL_FRAME_NONE) {
+        Bench_onFrameResult<P>(result, micros());
+      }
+    }
+    Bench_loop<P>();
+  }
+}
+
+// ===== เล่นทั้งไฟล์ 1 รอบ =====
+template <typename P>
+void Bench_replay(const ReplayStream& stream) {
+  uint32_t byteUs = (uint32_t)(10000000ULL / stream.baud);
+  uint32_t lastByteMs = millis();
+  for (size_t c = 0; c < stream.chunks.size(); c++) {
+    const ReplayChunk& chunk = stream.chunks[c];
+    Bench_wait<P>(chunk.gapMs, lastByteMs);
+
+    for (size_t offset = 0; offset < chunk.bytes.size(); offset += UART_RX_FULL) {
+      size_t length = std::min<size_t>(UART_RX_FULL, chunk.bytes.size() - offset);
+      bool last = offset + length == chunk.bytes.size();
+      uint32_t firstByteUs = micros();
+      Host_advanceMicros((uint64_t)length * byteUs);
+      lastByteMs = millis();
+      if (last) {
+        Host_advanceMicros((uint64_t)UART_RX_TIMEOUT * byteUs);
+      }
+      Bench_ingest<P>(chunk.bytes.data() + offset, length, firstByteUs, byteUs, micros());
+    }
+    Bench_loop<P>();
+  }
+}
+
+// ===== เลือกโปรโตคอลจากชื่อ แล้วเล่น N รอบ =====
+struct BenchRun {
+  const ReplayStream* stream;
+  int repeat;
+  bool countsMatch;
+  unsigned long firstReadings;
+  unsigned long firstDropped;
+  uint64_t wireUsPerPass;
+};
+
+struct BenchBeginVisitor {
+  template <typename P> void apply() {
+    P::begin(ReplayState<P>::framer, ReplayState<P>::parser);
+  }
+};
+
+struct BenchReplayVisitor {
+  BenchRun* run;
+  template <typename P> void apply() {
+    for (int pass = 0; pass < run->repeat; pass++) {
+      unsigned long readings = stats.readings;
+      unsigned long dropped = stats.dropped;
+      uint64_t startUs = hostClockUs;
+      Bench_replay<P>(*run->stream);
+      if (pass == 0) {
+        run->firstReadings = stats.readings - readings;
+        run->firstDropped = stats.dropped - dropped;
+        run->wireUsPerPass = hostClockUs - startUs;
+      } else if (stats.readings - readings != run->firstReadings || stats.dropped - dropped != run->firstDropped) {
+        run->countsMatch = false;
+      }
+    }
+  }
+};
+
+const ProtocolInfo* Bench_findProtocol(const char* name) {
+  for (size_t i = 0; i < BenchProtocols::COUNT; i++) {
+    if (strcmp(BenchProtocols::table[i].name, name) == 0) {
+      return &BenchProtocols::table[i];
+    }
+  }
+  return nullptr;
+}
+
+// ===== replay ใน thread ที่ทา stack ไว้ (ESP32: RS232 task / ESP8266: loop) =====
+void* Bench_replayThread(void* arg) {
+  BenchRun* run = (BenchRun*)arg;
+  const ProtocolInfo* info = Bench_findProtocol(run->stream->protocol.c_str());
+  BenchReplayVisitor visitor = { run };
+  Protocol_dispatch(info->id, visitor, (BenchProtocols*)nullptr);
+  return nullptr;
+}
+
+// ===== รายงาน =====
+void Bench_printStage(const char* name, std::vector<uint32_t>& values, const char* unit) {
+  if (values.empty()) {
+    printf("  %-22s %8s\n", name, "-");
+    return;
+  }
+  std::sort(values.begin(), values.end());
+  size_t count = values.size();
+  printf("  %-22s %8lu %10lu %10lu %10lu  %s\n", name, (unsigned long)count,
+         (unsigned long)values[(count - 1) * 50 / 100],
+         (unsigned long)values[(count - 1) * 99 / 100],
+         (unsigned long)values[count - 1], unit);
+}
+
+void Bench_usage() {
+  fprintf(stderr, "usage: replay_bench <file.stream> [--repeat N]\n");
+}
+
+int main(int argc, char** argv) {
+  const char* path = nullptr;
+  int repeat = 100;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+      repeat = atoi(argv[++i]);
+    } else if (argv[i][0] != '-' && path == nullptr) {
+      path = argv[i];
+    } else {
+      Bench_usage();
+      return 2;
+    }
+  }
+  if (path == nullptr || repeat < 1) {
+    Bench_usage();
+    return 2;
+  }
+
+  ReplayStream stream;
+  std::string error;
+  if (!ReplayStream_load(path, stream, error)) {
+    fprintf(stderr, "❌ %s\n", error.c_str());
+    return 2;
+  }
+  const ProtocolInfo* info = Bench_findProtocol(stream.protocol.c_str());
+  if (info == nullptr) {
+    fprintf(stderr, "❌ ไม่รู้จักโปรโตคอล %s (bp-json ต้อง build พร้อม ArduinoJson)\n", stream.protocol.c_str());
+    return 2;
+  }
+
+  // ===== เตรียม: Journal บน LittleFS ของ shim + จองที่ของผลไว้ก่อน (ไม่ให้ vector นับเป็น heap ของ replay) =====
+  LittleFS.reset();
+  Journal_begin();
+  Serial.takeOutput();
+  #ifdef ESP32
+    FrameQueue_begin(benchFrames);
+  #endif
+  BenchBeginVisitor begin;
+  Protocol_dispatch(info->id, begin, (BenchProtocols*)nullptr);
+
+  size_t capacity = (stream.chunks.size() * 2 + 16) * repeat;
+  stats.wireUs.reserve(capacity);
+  stats.framerNs.reserve(capacity);
+  stats.parseNs.reserve(capacity);
+  stats.journalNs.reserve(capacity);
+  stats.ackNs.reserve(capacity);
+
+  BenchRun run = { &stream, repeat, true, 0, 0, 0 };
+  size_t baselineStack = Bench_baselineStack();
+  #ifdef ESP32
+    if (!BenchTask_start(loopTask)) {
+      fprintf(stderr, "❌ สร้าง thread ของ loop() ไม่ได้\n");
+      return 2;
+    }
+  #endif
+  BenchHeap_begin();
+  size_t replayStack = Bench_runOnPaintedStack(Bench_replayThread, &run);
+  BenchHeap_end();
+  #ifdef ESP32
+    size_t loopStack = BenchTask_stop(loopTask);
+  #endif
+
+  // ===== ผล =====
+  #ifdef ESP32
+    const char* board = "ESP32";
+  #else
+    const char* board = "ESP8266";
+  #endif
+  double wireSeconds = run.wireUsPerPass / 1e6;
+  printf("replay: %s (%s @ %lu baud) | board config %s | %d pass\n", path, info->name,
+         (unsigned long)stream.baud, board, repeat);
+  printf("per pass: %lu bytes, %lu chunks, %lu readings, %lu dropped frames, %.1f s on the wire\n",
+         (unsigned long)stream.totalBytes, (unsigned long)stream.chunks.size(),
+         run.firstReadings, run.firstDropped, wireSeconds);
+  printf("readings/s: wire %.2f | host CPU %.0f (stage time only, %lu readings in %.3f ms)\n",
+         wireSeconds > 0 ? run.firstReadings / wireSeconds : 0.0,
+         stats.cpuNs > 0 ? stats.readings * 1e9 / stats.cpuNs : 0.0,
+         stats.readings, stats.cpuNs / 1e6);
+  printf("  %-22s %8s %10s %10s %10s\n", "stage", "count", "p50", "p99", "max");
+  Bench_printStage("wire (virtual)", stats.wireUs, "us  first byte -> frame complete");
+  Bench_printStage("framer (host CPU)", stats.framerNs, "ns/frame");
+  Bench_printStage("parse (host CPU)", stats.parseNs, "ns/frame");
+  Bench_printStage("journal+outbox (CPU)", stats.journalNs, "ns/reading");
+  Bench_printStage("ack (host CPU)", stats.ackNs, "ns/reading");
+  printf("heap during replay: peak +%lu bytes, %lu allocations (operator new)\n",
+         (unsigned long)BenchHeap_peakBytes(), BenchHeap_allocationCount());
+  printf("stack high-water (host ABI, idle thread %lu bytes subtracted):\n", (unsigned long)baselineStack);
+  #ifdef ESP32
+    printf("  %-22s %8lu bytes  (FreeRTOS stack %d)\n", "rs232 task",
+           (unsigned long)Bench_stackAboveBaseline(replayStack), REPLAY_RS232_STACK);
+    printf("  %-22s %8lu bytes\n", "loop task", (unsigned long)Bench_stackAboveBaseline(loopStack));
+  #else
+    printf("  %-22s %8lu bytes\n", "loop", (unsigned long)Bench_stackAboveBaseline(replayStack));
+  #endif
+  printf("parse errors: %lu | journal pending: %d lost: %lu\n", stats.parseErrors,
+         Journal_getPendingCount(), Journal_getLostCount());
+
+  // ===== ตรวจผลกับ @expect =====
+  bool ok = run.countsMatch;
+  if (!run.countsMatch) {
+    fprintf(stderr, "❌ จำนวน reading/เฟรมที่ทิ้งไม่เท่ากันทุกรอบ\n");
+  }
+  if (stream.expectReadings >= 0 && (long)run.firstReadings != stream.expectReadings) {
+    fprintf(stderr, "❌ readings %lu (ต้องได้ %ld)\n", run.firstReadings, stream.expectReadings);
+    ok = false;
+  }
+  if (stream.expectDropped >= 0 && (long)run.firstDropped != stream.expectDropped) {
+    fprintf(stderr, "❌ dropped %lu (ต้องได้ %ld)\n", run.firstDropped, stream.expectDropped);
+    ok = false;
+  }
+  if (Journal_getPendingCount() != 0) {
+    fprintf(stderr, "❌ journal ยังมี record ที่ไม่ได้ ack: %d\n", Journal_getPendingCount());
+    ok = false;
+  }
+  return ok ? 0 : 1;
+}
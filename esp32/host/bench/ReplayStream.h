@@ -0,0 +1,153 @@
+/**
+ * ReplayStream.h - อ่านไฟล์ .stream (byte ที่เครื่องมือแพทย์ส่งทาง RS232 + เวลา) สำหรับ ReplayBench
+ *
+ * รูปแบบไฟล์ (ทีละบรรทัด):
+ *   # ...                  comment
+ *   @protocol <name>       โปรโตคอลที่ใช้ (NAME ใน ProtocolRegistry เช่น bp-json, weight-text)
+ *   @baud <rate>           byte ถัดไปมาห่างกัน 10 bit (start + 8 + stop) ที่ rate นี้
+ *   @gap <ms>              สายเงียบก่อน chunk ถัดไป (หลาย @gap ติดกัน = รวมกัน)
+ *   @expect <key> <n>      ผลที่ต้องได้ต่อ 1 รอบ (readings / dropped) - ไม่ตรง = benchmark ล้มเหลว
+ *   อื่นๆ                  byte ที่ส่ง (escape: \r \n \t \\ \xNN) - ไม่มี newline ต่อท้ายให้เอง
+ *
+ * ไฟล์ในโฟลเดอร์ streams/ เป็นข้อมูลสังเคราะห์ (ระบุไว้ในหัวไฟล์) - เวลาระหว่าง byte คิดจาก baud
+ */
+
+#ifndef REPLAY_STREAM_H
+#define REPLAY_STREAM_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+struct ReplayChunk {
+  uint32_t gapMs;              // สายเงียบก่อน chunk นี้
+  std::string bytes;
+};
+
+struct ReplayStream {
+  std::string protocol;
+  uint32_t baud;
+  std::vector<ReplayChunk> chunks;
+  long expectReadings;         // -1 = ไม่ตรวจ
+  long expectDropped;
+  size_t totalBytes;
+};
+
+inline int ReplayStream_hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+inline bool ReplayStream_unescape(const std::string& line, std::string& out) {
+  out.clear();
+  for (size_t i = 0; i < line.size(); i++) {
+    if (line[i] != '\\') {
+      out += line[i];
+      continue;
+    }
+    if (++i >= line.size()) {
+      return false;
+    }
+    switch (line[i]) {
+      case 'r':  out += '\r'; break;
+      case 'n':  out += '\n'; break;
+      case 't':  out += '\t'; break;
+      case '\\': out += '\\'; break;
+      case 'x': {
+        int high = i + 1 < line.size() ? ReplayStream_hexValue(line[i + 1]) : -1;
+        int low = i + 2 < line.size() ? ReplayStream_hexValue(line[i + 2]) : -1;
+        if (high < 0 || low < 0) {
+          return false;
+        }
+        out += (char)(high * 16 + low);
+        i += 2;
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  return true;
+}
+
+// คืน false + error ถ้าอ่านไม่ได้ / รูปแบบผิด
+inline bool ReplayStream_load(const char* path, ReplayStream& stream, std::string& error) {
+  stream.protocol.clear();
+  stream.baud = 0;
+  stream.chunks.clear();
+  stream.expectReadings = -1;
+  stream.expectDropped = -1;
+  stream.totalBytes = 0;
+
+  FILE* file = fopen(path, "rb");
+  if (file == nullptr) {
+    error = std::string("เปิดไฟล์ไม่ได้: ") + path;
+    return false;
+  }
+
+  char buffer[4096];
+  uint32_t gapMs = 0;
+  int lineNumber = 0;
+  while (fgets(buffer, sizeof(buffer), file) != nullptr) {
+    lineNumber++;
+    std::string line(buffer);
+    while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
+      line.pop_back();
+    }
+    if (line.empty() || line[0] == '#') {
+      continue;
+    }
+
+    if (line[0] == '@') {
+      char key[32] = "";
+      char value[64] = "";
+      long number = 0;
+      if (sscanf(line.c_str(), "@protocol %63s", value) == 1) {
+        stream.protocol = value;
+      } else if (sscanf(line.c_str(), "@baud %ld", &number) == 1 && number > 0) {
+        stream.baud = (uint32_t)number;
+      } else if (sscanf(line.c_str(), "@gap %ld", &number) == 1 && number >= 0) {
+        gapMs += (uint32_t)number;
+      } else if (sscanf(line.c_str(), "@expect %31s %ld", key, &number) == 2 && strcmp(key, "readings") == 0) {
+        stream.expectReadings = number;
+      } else if (sscanf(line.c_str(), "@expect %31s %ld", key, &number) == 2 && strcmp(key, "dropped") == 0) {
+        stream.expectDropped = number;
+      } else {
+        error = "บรรทัด " + std::to_string(lineNumber) + ": ไม่รู้จัก " + line;
+        fclose(file);
+        return false;
+      }
+      continue;
+    }
+
+    ReplayChunk chunk;
+    chunk.gapMs = gapMs;
+    if (!ReplayStream_unescape(line, chunk.bytes)) {
+      error = "บรรทัด " + std::to_string(lineNumber) + ": escape ผิด";
+      fclose(file);
+      return false;
+    }
+    stream.totalBytes += chunk.bytes.size();
+    stream.chunks.push_back(chunk);
+    gapMs = 0;
+  }
+  fclose(file);
+
+  if (gapMs > 0) {
+    ReplayChunk tail;       // เงียบท้ายไฟล์ (ให้ idle timeout / poll ทำงาน)
+    tail.gapMs = gapMs;
+    stream.chunks.push_back(tail);
+  }
+  if (stream.protocol.empty() || stream.baud == 0) {
+    error = "ต้องมี @protocol และ @baud";
+    return false;
+  }
+  return true;
+}
+
+#endif
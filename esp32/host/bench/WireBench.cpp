@@ -0,0 +1,279 @@
+/**
+ * WireBench.cpp
+ * เทียบ reading แบบ Binary (WireProtocol.h) กับ JSON ของ /api/vitals บน reading ชุดเดียวกัน
+ *
+ *   cmake -S esp32/host -B build -DARDUINOJSON_DIR=<ArduinoJson> && cmake --build build
+ *   ./build/wire_bench --passes 20000
+ *
+ * encode: Wire_packReading + Wire_encodeReading  กับ  StaticJsonDocument<384> + serializeJson (แบบ sendReading())
+ * decode: Wire_parseFrame + Wire_decodeReading    กับ  deserializeJson + อ่าน field (แบบ processVitals())
+ * ผลที่รายงาน: bytes ต่อ reading (ไม่รวม header ของ UDP/IP หรือ HTTP), ns ต่อ reading และ allocate ต่อ reading
+ * HELLO ส่งครั้งเดียวต่อ session → แสดงแยก ไม่รวมใน bytes ต่อ reading
+ * ตรวจด้วยว่า decode ทั้งสองทางได้ค่าเท่ากัน (ไม่เท่า → exit 1 ให้ ctest ล้ม)
+ *
+ * ไม่มี ArduinoJson → วัดเฉพาะ Binary
+ * ตัวเลขเวลาเป็นของ PC → ใช้เทียบสองวิธีบนเครื่องเดียวกัน ไม่ใช่เวลาบนบอร์ด
+ */
+
+#include <chrono>
+#include "BenchProbe.h"
+#include "WireProtocol.h"
+#ifdef HOST_HAVE_ARDUINOJSON
+#include <ArduinoJson.h>
+#endif
+
+// ===== ข้อมูล: reading แบบที่เครื่องวัดแต่ละชนิดส่ง =====
+static const char* const BENCH_MAC = "24:6F:28:00:00:01";
+static const char* const BENCH_NAME = "ESP32-BP-01";
+
+static const WireReading READINGS[] = {
+  { WIRE_KIND_BLOOD_PRESSURE, WIRE_FIELD_VALUE0 | WIRE_FIELD_VALUE1 | WIRE_FIELD_VALUE2 | WIRE_FIELD_IDCARD,
+    1103700012345ULL, { 127, 82, 74, 0 }, 912345 },
+  { WIRE_KIND_WEIGHT_HEIGHT, WIRE_FIELD_VALUE0 | WIRE_FIELD_VALUE1, 0, { 703, 1735, 0, 0 }, 1234567 },
+  { WIRE_KIND_TEMP, WIRE_FIELD_VALUE0, 0, { 365, 0, 0, 0 }, 2000000 },
+};
+static const int READING_COUNT = sizeof(READINGS) / sizeof(READINGS[0]);
+
+volatile long benchSink = 0;
+
+// ===== Binary =====
+static size_t encodeWire(const WireReading& reading, uint32_t seq, uint8_t* frame) {
+  uint8_t packed[WIRE_READING_SIZE];
+  Wire_packReading(packed, reading);
+  return Wire_encodeReading(frame, 0x1234, seq, packed, WIRE_READING_DURABLE_SEQ);
+}
+
+static bool decodeWire(const uint8_t* frame, size_t length, WireReading& reading) {
+  WireHeader header;
+  int payloadLength = Wire_parseFrame(frame, length, header);
+  return payloadLength >= 0 && Wire_decodeReading(frame + WIRE_HEADER_SIZE, payloadLength, reading);
+}
+
+#ifdef HOST_HAVE_ARDUINOJSON
+// ===== JSON (รูปแบบเดียวกับ sendReading() ใน ESP32_RS232.ino) =====
+static size_t encodeJson(const WireReading& reading, uint32_t seq, char* payload, size_t size) {
+  StaticJsonDocument<384> doc;
+  doc["deviceId"] = BENCH_MAC;
+  doc["deviceName"] = BENCH_NAME;
+  doc["macAddress"] = BENCH_MAC;
+  doc["deviceType"] = reading.kind == WIRE_KIND_BLOOD_PRESSURE ? "blood_pressure" :
+                      reading.kind == WIRE_KIND_WEIGHT_HEIGHT ? "weight_height" : "temp";
+  doc["seq"] = seq;
+  doc["epoch"] = 7;
+
+  char idcard[24] = "";
+  if (reading.fields & WIRE_FIELD_IDCARD) {
+    Wire_idcardToString(reading.idcard, idcard, sizeof(idcard));
+  }
+  doc["idcard"] = idcard;
+
+  JsonObject dataObj = doc.createNestedObject("data");
+  switch (reading.kind) {
+    case WIRE_KIND_BLOOD_PRESSURE:
+      if (reading.fields & WIRE_FIELD_VALUE0) dataObj["bp"] = reading.values[0];
+      if (reading.fields & WIRE_FIELD_VALUE1) dataObj["bp2"] = reading.values[1];
+      if (reading.fields & WIRE_FIELD_VALUE2) dataObj["pulse"] = reading.values[2];
+      break;
+
+    case WIRE_KIND_WEIGHT_HEIGHT:
+      dataObj["weight"] = reading.values[0] / 10.0f;
+      dataObj["height"] = reading.values[1] / 10.0f;
+      if (reading.fields & WIRE_FIELD_VALUE2) dataObj["temp"] = reading.values[2] / 10.0f;
+      break;
+
+    default:
+      dataObj["value"] = reading.values[0] / 10.0f;
+      break;
+  }
+  dataObj["timestamp"] = reading.timestamp;
+
+  return serializeJson(doc, payload, size);
+}
+
+// อ่านกลับเป็น WireReading (ฝั่ง Center: processVitals อ่าน field เดียวกัน)
+static bool decodeJson(const char* payload, size_t length, WireReading& reading) {
+  StaticJsonDocument<512> doc;
+  if (deserializeJson(doc, payload, length)) {
+    return false;
+  }
+  const char* deviceType = doc["deviceType"] | "";
+  JsonObject data = doc["data"];
+  memset(&reading, 0, sizeof(reading));
+  reading.idcard = Wire_idcardFromString(doc["idcard"] | "");
+  if (reading.idcard != 0) {
+    reading.fields |= WIRE_FIELD_IDCARD;
+  }
+  if (strcmp(deviceType, "blood_pressure") == 0) {
+    reading.kind = WIRE_KIND_BLOOD_PRESSURE;
+    reading.values[0] = data["bp"] | 0;
+    reading.values[1] = data["bp2"] | 0;
+    reading.values[2] = data["pulse"] | 0;
+    reading.fields |= WIRE_FIELD_VALUE0 | WIRE_FIELD_VALUE1 | WIRE_FIELD_VALUE2;
+  } else if (strcmp(deviceType, "weight_height") == 0) {
+    reading.kind = WIRE_KIND_WEIGHT_HEIGHT;
+    reading.values[0] = (int16_t)lroundf(data["weight"].as<float>() * 10);
+    reading.values[1] = (int16_t)lroundf(data["height"].as<float>() * 10);
+    reading.fields |= WIRE_FIELD_VALUE0 | WIRE_FIELD_VALUE1;
+  } else {
+    reading.kind = WIRE_KIND_TEMP;
+    reading.values[0] = (int16_t)lroundf(data["value"].as<float>() * 10);
+    reading.fields |= WIRE_FIELD_VALUE0;
+  }
+  reading.timestamp = data["timestamp"] | 0UL;
+  return true;
+}
+#endif
+
+static bool sameReading(const WireReading& a, const WireReading& b) {
+  return a.kind == b.kind && a.fields == b.fields && a.idcard == b.idcard && a.timestamp == b.timestamp &&
+         memcmp(a.values, b.values, sizeof(a.values)) == 0;
+}
+
+// decode ต้องได้ reading เดิมทุกชนิด (ทั้งสองทาง)
+static bool checkRoundTrip() {
+  bool agree = true;
+  for (int i = 0; i < READING_COUNT; i++) {
+    uint8_t frame[WIRE_MAX_FRAME];
+    WireReading wire;
+    bool ok = decodeWire(frame, encodeWire(READINGS[i], i + 1, frame), wire) && sameReading(wire, READINGS[i]);
+#ifdef HOST_HAVE_ARDUINOJSON
+    char payload[320];
+    WireReading json;
+    ok = ok && decodeJson(payload, encodeJson(READINGS[i], i + 1, payload, sizeof(payload)), json) &&
+         sameReading(json, READINGS[i]);
+#endif
+    if (!ok) {
+      fprintf(stderr, "❌ decode ไม่ได้ค่าเดิม: reading ที่ %d\n", i + 1);
+      agree = false;
+    }
+  }
+  return agree;
+}
+
+// ===== วัดเวลา =====
+struct WireResult {
+  double bytesPerReading;
+  double encodeNs;
+  double decodeNs;
+  double allocationsPerReading;   // encode + decode
+};
+
+static double elapsedNs(std::chrono::steady_clock::time_point start) {
+  return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+static WireResult runWire(int passes) {
+  static uint8_t frames[READING_COUNT][WIRE_MAX_FRAME];
+  size_t lengths[READING_COUNT];
+  size_t bytes = 0;
+  double readings = (double)passes * READING_COUNT;
+
+  BenchHeap_begin();
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < passes; pass++) {
+    for (int i = 0; i < READING_COUNT; i++) {
+      lengths[i] = encodeWire(READINGS[i], pass, frames[i]);
+      benchSink += lengths[i];
+    }
+  }
+  double encodeNs = elapsedNs(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < passes; pass++) {
+    for (int i = 0; i < READING_COUNT; i++) {
+      WireReading reading;
+      decodeWire(frames[i], lengths[i], reading);
+      benchSink += reading.values[0];
+    }
+  }
+  double decodeNs = elapsedNs(start);
+  BenchHeap_end();
+
+  for (int i = 0; i < READING_COUNT; i++) {
+    bytes += lengths[i];
+  }
+  WireResult result = { (double)bytes / READING_COUNT, encodeNs / readings, decodeNs / readings,
+                        BenchHeap_allocationCount() / readings };
+  return result;
+}
+
+#ifdef HOST_HAVE_ARDUINOJSON
+static WireResult runJson(int passes) {
+  static char payloads[READING_COUNT][320];
+  size_t lengths[READING_COUNT];
+  size_t bytes = 0;
+  double readings = (double)passes * READING_COUNT;
+
+  BenchHeap_begin();
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < passes; pass++) {
+    for (int i = 0; i < READING_COUNT; i++) {
+      lengths[i] = encodeJson(READINGS[i], pass, payloads[i], sizeof(payloads[i]));
+      benchSink += lengths[i];
+    }
+  }
+  double encodeNs = elapsedNs(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < passes; pass++) {
+    for (int i = 0; i < READING_COUNT; i++) {
+      WireReading reading;
+      decodeJson(payloads[i], lengths[i], reading);
+      benchSink += reading.values[0];
+    }
+  }
+  double decodeNs = elapsedNs(start);
+  BenchHeap_end();
+
+  for (int i = 0; i < READING_COUNT; i++) {
+    bytes += lengths[i];
+  }
+  WireResult result = { (double)bytes / READING_COUNT, encodeNs / readings, decodeNs / readings,
+                        BenchHeap_allocationCount() / readings };
+  return result;
+}
+#endif
+
+static void printResult(const char* name, const WireResult& result) {
+  printf("  %-28s %12.1f %10.1f %10.1f %14.2f\n", name, result.bytesPerReading, result.encodeNs, result.decodeNs,
+         result.allocationsPerReading);
+}
+
+static int usage() {
+  fprintf(stderr, "usage: wire_bench [--passes N]\n");
+  return 2;
+}
+
+int main(int argc, char** argv) {
+  int passes = 20000;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+      passes = atoi(argv[++i]);
+    } else {
+      return usage();
+    }
+  }
+  if (passes <= 0) {
+    return usage();
+  }
+
+  bool ok = checkRoundTrip();
+
+  WireHello hello;
+  memset(&hello, 0, sizeof(hello));
+  strlcpy(hello.name, BENCH_NAME, sizeof(hello.name));
+  uint8_t frame[WIRE_MAX_FRAME];
+  size_t helloBytes = Wire_encodeHello(frame, 0x1234, hello);
+
+  printf("reading: %d kinds x %d passes (host CPU)\n", READING_COUNT, passes);
+  printf("  %-28s %12s %10s %10s %14s\n", "format", "bytes/reading", "encode ns", "decode ns", "allocs/reading");
+  printResult("WireProtocol READING", runWire(passes));
+#ifdef HOST_HAVE_ARDUINOJSON
+  printResult("JSON /api/vitals", runJson(passes));
+#else
+  printf("  (ไม่มี ArduinoJson - ไม่ได้วัด JSON)\n");
+#endif
+  printf("  + HELLO %u bytes ครั้งเดียวต่อ session (ชื่อ \"%s\")\n", (unsigned)helloBytes, BENCH_NAME);
+
+  return ok ? 0 : 1;
+}
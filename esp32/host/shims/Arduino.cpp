@@ -0,0 +1,12 @@
+/**
+ * Arduino.cpp (host shim) - ตัวแปรของ Arduino.h (ประกาศครั้งเดียวใน library arduino_host)
+ */
+
+#include "Arduino.h"
+
+uint64_t hostClockUs = 0;
+uint32_t hostRandomState = 0x9E3779B9UL;
+
+HardwareSerial Serial;
+HardwareSerial Serial2;
+HostEsp ESP;
@@ -0,0 +1,358 @@
+/**
+ * Arduino.h (host shim)
+ * Arduino core ขั้นต่ำสำหรับ compile header ของ firmware บน PC (esp32/host)
+ *
+ * - เวลาเป็นนาฬิกาจำลอง: millis()/micros() อ่านจาก hostClockUs, delay() เลื่อนนาฬิกา
+ *   → test/benchmark กำหนดเวลาเองได้ (idle timeout, baud gap) ไม่ขึ้นกับความเร็วเครื่อง
+ * - Serial/Serial2: เก็บสิ่งที่ firmware เขียนไว้ใน buffer (output) และป้อน byte ขาเข้าด้วย inject()
+ * - random()/RANDOM_REG32/esp_random(): ตัวสุ่มที่กำหนด seed ได้ (ผลเหมือนเดิมทุกครั้ง)
+ * - ESP32: include freertos/FreeRTOS.h แบบ core ของ ESP32 (portMUX, task, queue)
+ *
+ * ไม่ใช่ emulator - มีเฉพาะ API ที่ header ของ firmware เรียกใช้
+ */
+
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+#include <math.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <deque>
+#include <string>
+
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+#define LED_BUILTIN 2
+#define D0 16
+#define D1 5
+#define D2 4
+#define D3 0
+#define D4 2
+#define D5 14
+#define D6 12
+#define D7 13
+#define D8 15
+
+// ===== นาฬิกาจำลอง =====
+extern uint64_t hostClockUs;
+
+inline void Host_setMicros(uint64_t us) {
+  hostClockUs = us;
+}
+
+inline void Host_advanceMicros(uint64_t us) {
+  hostClockUs += us;
+}
+
+inline void Host_advanceMillis(uint32_t ms) {
+  hostClockUs += (uint64_t)ms * 1000;
+}
+
+// ค่าของบอร์ดเป็น 32 bit (วนรอบ) - เก็บพฤติกรรมเดียวกัน
+inline unsigned long millis() {
+  return (uint32_t)(hostClockUs / 1000);
+}
+
+inline unsigned long micros() {
+  return (uint32_t)hostClockUs;
+}
+
+inline void delay(unsigned long ms) {
+  Host_advanceMillis(ms);
+}
+
+inline void delayMicroseconds(unsigned int us) {
+  Host_advanceMicros(us);
+}
+
+inline void yield() {
+}
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t value) {
+}
+
+inline int digitalRead(uint8_t pin) {
+  return LOW;
+}
+
+// ===== ตัวสุ่ม (xorshift32) =====
+extern uint32_t hostRandomState;
+
+inline uint32_t Host_random32() {
+  uint32_t x = hostRandomState;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  hostRandomState = x != 0 ? x : 0x9E3779B9UL;
+  return hostRandomState;
+}
+
+inline void randomSeed(unsigned long seed) {
+  hostRandomState = seed != 0 ? (uint32_t)seed : 0x9E3779B9UL;
+}
+
+inline long random(long limit) {
+  return limit > 0 ? (long)(Host_random32() % (uint32_t)limit) : 0;
+}
+
+inline long random(long low, long high) {
+  return high > low ? low + random(high - low) : low;
+}
+
+inline uint32_t esp_random() {
+  return Host_random32();
+}
+
+#define RANDOM_REG32 (Host_random32())
+
+// ===== strlcpy / strlcat (glibc ก่อน 2.38 ไม่มี) =====
+#if defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+inline size_t strlcpy(char* dst, const char* src, size_t size) {
+  size_t length = strlen(src);
+  if (size > 0) {
+    size_t n = length < size - 1 ? length : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return length;
+}
+
+inline size_t strlcat(char* dst, const char* src, size_t size) {
+  size_t used = strnlen(dst, size);
+  if (used == size) {
+    return size + strlen(src);
+  }
+  return used + strlcpy(dst + used, src, size - used);
+}
+#endif
+
+// ===== String (เท่าที่ firmware ใช้) =====
+class String {
+public:
+  String() {}
+  String(const char* text) : value(text != nullptr ? text : "") {}
+  String(const std::string& text) : value(text) {}
+  explicit String(char c) : value(1, c) {}
+  explicit String(int number) : value(std::to_string(number)) {}
+  explicit String(unsigned int number) : value(std::to_string(number)) {}
+  explicit String(long number) : value(std::to_string(number)) {}
+  explicit String(unsigned long number) : value(std::to_string(number)) {}
+
+  const char* c_str() const { return value.c_str(); }
+  unsigned int length() const { return (unsigned int)value.size(); }
+  char operator[](unsigned int index) const { return index < value.size() ? value[index] : '\0'; }
+  char charAt(unsigned int index) const { return (*this)[index]; }
+
+  String& operator+=(const String& other) { value += other.value; return *this; }
+  String& operator+=(const char* other) { value += other; return *this; }
+  String& operator+=(char c) { value += c; return *this; }
+  bool concat(const char* other) { value += other; return true; }
+
+  bool operator==(const String& other) const { return value == other.value; }
+  bool operator==(const char* other) const { return value == other; }
+  bool operator!=(const String& other) const { return value != other.value; }
+  bool operator!=(const char* other) const { return value != other; }
+
+  int indexOf(char c, unsigned int from = 0) const {
+    size_t found = value.find(c, from);
+    return found == std::string::npos ? -1 : (int)found;
+  }
+  int indexOf(const char* text, unsigned int from = 0) const {
+    size_t found = value.find(text, from);
+    return found == std::string::npos ? -1 : (int)found;
+  }
+  bool startsWith(const char* prefix) const { return value.compare(0, strlen(prefix), prefix) == 0; }
+  String substring(unsigned int from) const { return from < value.size() ? value.substr(from) : ""; }
+  String substring(unsigned int from, unsigned int to) const {
+    return from < to && from < value.size() ? value.substr(from, to - from) : "";
+  }
+  void trim() {
+    size_t first = value.find_first_not_of(" \t\r\n");
+    size_t last = value.find_last_not_of(" \t\r\n");
+    value = first == std::string::npos ? "" : value.substr(first, last - first + 1);
+  }
+  void toUpperCase() { for (size_t i = 0; i < value.size(); i++) value[i] = toupper((unsigned char)value[i]); }
+  long toInt() const { return atol(value.c_str()); }
+  float toFloat() const { return (float)atof(value.c_str()); }
+
+private:
+  std::string value;
+};
+
+inline String operator+(const String& a, const String& b) {
+  String result(a);
+  result += b;
+  return result;
+}
+
+inline String operator+(const String& a, const char* b) {
+  String result(a);
+  result += b;
+  return result;
+}
+
+// ===== Print / Stream =====
+class Print;
+
+class Printable {
+public:
+  virtual ~Printable() {}
+  virtual size_t printTo(Print& p) const = 0;
+};
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+      write(data[i]);
+    }
+    return length;
+  }
+  size_t write(const char* text) { return write((const uint8_t*)text, strlen(text)); }
+  size_t write(const char* data, size_t length) { return write((const uint8_t*)data, length); }
+
+  size_t print(const char* text) { return write(text); }
+  size_t print(const String& text) { return write(text.c_str()); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int n) { return printf("%d", n); }
+  size_t print(unsigned int n) { return printf("%u", n); }
+  size_t print(long n) { return printf("%ld", n); }
+  size_t print(unsigned long n) { return printf("%lu", n); }
+  size_t print(double n, int digits = 2) { return printf("%.*f", digits, n); }
+  size_t print(const Printable& value) { return value.printTo(*this); }
+
+  size_t println() { return write("\r\n"); }
+  template <typename T>
+  size_t println(const T& value) { return print(value) + println(); }
+
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3))) {
+    char line[512];
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (length <= 0) {
+      return 0;
+    }
+    if (length >= (int)sizeof(line)) {
+      length = sizeof(line) - 1;
+    }
+    return write((const uint8_t*)line, length);
+  }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  // ไม่มีการรอจริง (ข้อมูลของ host อยู่ใน RAM แล้ว) - เก็บค่าไว้เท่านั้น
+  void setTimeout(unsigned long timeout) { this->timeout = timeout; }
+  size_t readBytes(char* buffer, size_t length) {
+    size_t n = 0;
+    int c;
+    while (n < length && (c = read()) >= 0) {
+      buffer[n++] = (char)c;
+    }
+    return n;
+  }
+
+protected:
+  unsigned long timeout = 1000;
+};
+
+// ===== Serial: output เก็บใน buffer / input ป้อนด้วย inject() =====
+// echo = true → เขียน output ออก stdout ด้วย (ดู log ของ firmware ตอน debug)
+class HardwareSerial : public Stream {
+public:
+  bool echo = false;
+  size_t txCapacity = 4096;    // availableForWrite() (TX FIFO + ring ของ core)
+
+  void begin(unsigned long baud) { this->baud = baud; }
+  void updateBaudRate(unsigned long baud) { this->baud = baud; }
+  unsigned long baudRate() const { return baud; }
+  void end() {}
+  void setDebugOutput(bool enable) {}
+  void flush() {}
+  operator bool() const { return true; }
+
+  using Print::write;
+  size_t write(uint8_t c) override {
+    output.push_back((char)c);
+    if (echo) {
+      fputc(c, stdout);
+    }
+    return 1;
+  }
+  int availableForWrite() { return (int)txCapacity; }
+
+  int available() override { return (int)input.size(); }
+  int read() override {
+    if (input.empty()) {
+      return -1;
+    }
+    uint8_t c = input.front();
+    input.pop_front();
+    return c;
+  }
+  int peek() override { return input.empty() ? -1 : input.front(); }
+  using Stream::readBytes;
+  size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+
+  // ===== ฝั่ง host =====
+  void inject(const uint8_t* data, size_t length) { input.insert(input.end(), data, data + length); }
+  void inject(const char* text) { inject((const uint8_t*)text, strlen(text)); }
+  std::string takeOutput() {
+    std::string taken;
+    taken.swap(output);
+    return taken;
+  }
+
+private:
+  unsigned long baud = 0;
+  std::deque<uint8_t> input;
+  std::string output;
+};
+
+extern HardwareSerial Serial;
+extern HardwareSerial Serial2;
+
+// ===== ESP (เท่าที่ใช้แสดงสถานะ) =====
+// heap ของ host ไม่เหมือนบอร์ด → คืนค่าคงที่ (benchmark วัด heap เองด้วย operator new)
+class HostEsp {
+public:
+  uint32_t getFreeHeap() { return 48 * 1024; }
+  uint32_t getMinFreeHeap() { return 48 * 1024; }
+  uint32_t getMaxFreeBlockSize() { return 32 * 1024; }
+  uint32_t getMaxAllocHeap() { return 32 * 1024; }
+  const char* getResetReason() { return "host"; }
+  void restart() {}
+};
+
+extern HostEsp ESP;
+
+#ifdef ESP32
+  #include "freertos/FreeRTOS.h"
+#endif
+
+#endif
@@ -0,0 +1,10 @@
+/**
+ * AsyncTCP.h (host shim) - TCP ของ ESPAsyncWebServer (ไม่มีอะไรให้เรียกตรงๆ ใช้ผ่าน ESPAsyncWebServer.h)
+ */
+
+#ifndef HOST_ASYNCTCP_H
+#define HOST_ASYNCTCP_H
+
+#include "IPAddress.h"
+
+#endif
@@ -0,0 +1,7 @@
+/**
+ * EEPROM.cpp (host shim) - ตัวแปรของ EEPROM.h
+ */
+
+#include "EEPROM.h"
+
+EEPROMClass EEPROM;
@@ -0,0 +1,72 @@
+/**
+ * EEPROM.h (host shim)
+ * EEPROM แบบ ESP8266/ESP32 (จำลองด้วย RAM ตามขนาดที่ begin()) - get/put/commit
+ * commit() คัดลอก buffer ไปที่ committed → ฝั่ง host ดู/แก้ไบต์ที่ "บันทึกแล้ว" ได้
+ */
+
+#ifndef HOST_EEPROM_H
+#define HOST_EEPROM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+class EEPROMClass {
+public:
+  void begin(size_t size) {
+    committed.resize(size, 0xFF);
+    buffer = committed;
+  }
+
+  uint8_t read(int address) const {
+    return (size_t)address < buffer.size() ? buffer[address] : 0;
+  }
+
+  void write(int address, uint8_t value) {
+    if ((size_t)address < buffer.size()) {
+      buffer[address] = value;
+    }
+  }
+
+  template <typename T>
+  T& get(int address, T& value) const {
+    if ((size_t)address + sizeof(T) <= buffer.size()) {
+      memcpy(&value, &buffer[address], sizeof(T));
+    }
+    return value;
+  }
+
+  template <typename T>
+  const T& put(int address, const T& value) {
+    if ((size_t)address + sizeof(T) <= buffer.size()) {
+      memcpy(&buffer[address], &value, sizeof(T));
+    }
+    return value;
+  }
+
+  bool commit() {
+    committed = buffer;
+    commitCount++;
+    return true;
+  }
+
+  void end() {
+    commit();
+  }
+
+  size_t length() const {
+    return buffer.size();
+  }
+
+  // ===== ฝั่ง host =====
+  std::vector<uint8_t> committed;
+  unsigned long commitCount = 0;
+
+private:
+  std::vector<uint8_t> buffer;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
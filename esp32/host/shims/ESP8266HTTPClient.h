@@ -0,0 +1,92 @@
+/**
+ * ESP8266HTTPClient.h (host shim)
+ * HTTPClient จำลอง - ไม่ส่งอะไรออกเครือข่าย ตอบตาม responseCode ที่ฝั่ง host ตั้งไว้
+ *
+ * - POST() เปิด connection ถ้า client ยังไม่ต่อ (นับใน WiFiClient::openCount) แบบ HTTPClient จริง
+ *   setReuse(true) → คง connection ไว้หลังตอบ / false → ปิดทุกครั้ง
+ * - failNext: POST ครั้งถัดไปคืน HTTPC_ERROR_CONNECTION_LOST (เช่น Center ปิด socket ไปแล้ว)
+ * - นับ begin()/POST() และเก็บ path/body ล่าสุดไว้ตรวจ
+ */
+
+#ifndef HOST_ESP8266_HTTP_CLIENT_H
+#define HOST_ESP8266_HTTP_CLIENT_H
+
+#include "Arduino.h"
+#include "WiFiClient.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+#define HTTPC_ERROR_CONNECTION_LOST (-5)
+#define HTTPC_ERROR_READ_TIMEOUT (-11)
+
+#define HTTP_CODE_OK 200
+
+class HTTPClient {
+public:
+  bool begin(WiFiClient& client, const char* host, uint16_t port, const char* uri) {
+    this->client = &client;
+    path = uri;
+    beginCount++;
+    return true;
+  }
+  void end() {
+    if (client != nullptr && !reuse) {
+      client->stop();
+    }
+  }
+  void setReuse(bool reuse) { this->reuse = reuse; }
+  void setTimeout(uint16_t timeout) {}
+  void addHeader(const char* name, const char* value) {}
+
+  int POST(const uint8_t* body, size_t length) {
+    if (client == nullptr) {
+      return HTTPC_ERROR_NOT_CONNECTED;
+    }
+    if (!client->connected()) {
+      client->open();
+    }
+    postCount++;
+    lastBody.assign((const char*)body, length);
+    if (failNext) {
+      failNext = false;
+      client->dropByPeer();
+      return HTTPC_ERROR_CONNECTION_LOST;
+    }
+    if (!reuse) {
+      client->stop();
+    }
+    return responseCode;
+  }
+  int POST(const String& body) { return POST((const uint8_t*)body.c_str(), body.length()); }
+
+  String getString() { return String(responseBody.c_str()); }
+
+  static String errorToString(int error) {
+    switch (error) {
+      case HTTPC_ERROR_CONNECTION_REFUSED: return "connection refused";
+      case HTTPC_ERROR_SEND_HEADER_FAILED: return "send header failed";
+      case HTTPC_ERROR_SEND_PAYLOAD_FAILED: return "send payload failed";
+      case HTTPC_ERROR_NOT_CONNECTED: return "not connected";
+      case HTTPC_ERROR_CONNECTION_LOST: return "connection lost";
+      case HTTPC_ERROR_READ_TIMEOUT: return "read Timeout";
+      default: return String();
+    }
+  }
+
+  // ===== ฝั่ง host =====
+  int responseCode = HTTP_CODE_OK;
+  std::string responseBody = "{\"status\":\"ok\"}";
+  bool failNext = false;
+  unsigned long beginCount = 0;
+  unsigned long postCount = 0;
+  std::string path;
+  std::string lastBody;
+
+private:
+  WiFiClient* client = nullptr;
+  bool reuse = false;
+};
+
+#endif
@@ -0,0 +1,10 @@
+/**
+ * ESP8266WiFi.h (host shim) - ชื่อ header ของ ESP8266 → ใช้ WiFi ตัวเดียวกับ WiFi.h
+ */
+
+#ifndef HOST_ESP8266_WIFI_H
+#define HOST_ESP8266_WIFI_H
+
+#include "WiFi.h"
+
+#endif
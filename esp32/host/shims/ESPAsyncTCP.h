@@ -0,0 +1,10 @@
+/**
+ * ESPAsyncTCP.h (host shim) - TCP ของ ESPAsyncWebServer (ไม่มีอะไรให้เรียกตรงๆ ใช้ผ่าน ESPAsyncWebServer.h)
+ */
+
+#ifndef HOST_ESPASYNCTCP_H
+#define HOST_ESPASYNCTCP_H
+
+#include "IPAddress.h"
+
+#endif
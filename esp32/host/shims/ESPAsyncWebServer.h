@@ -0,0 +1,367 @@
+/**
+ * ESPAsyncWebServer.h (host shim)
+ * AsyncWebServer / AsyncWebSocket จำลอง - ไม่มี TCP: ฝั่ง host สร้าง request เองแล้วส่งให้ server.serve()
+ *
+ * - serve(): หา route ตาม url/method → เรียก onBody ทีละ chunk (index/total แบบ library จริง)
+ *   แล้วเรียก onRequest / ไม่พบ route → onNotFound
+ * - request->send(...) เก็บ code/type/body ของ response ไว้ใน request ให้ตรวจ
+ *   (beginResponse_P ไม่ copy: body อ่านจาก pointer ตอนส่งจริงแบบ AsyncProgmemResponse)
+ * - request.holdOpen = true: client ยังรับ response ไม่หมดหลัง handler จบ → body ถูกอ่านและ
+ *   onDisconnect() ถูกเรียกตอน request.disconnect() (ไม่ตั้ง = ส่งครบและตัดทันทีใน serve())
+ * - AsyncWebSocket: ฝั่ง host ต่อ/ตัด client ด้วย connect()/disconnect()
+ *   client.stalled = true → queueIsFull() (TCP ส่งไม่ทัน) / ข้อความที่ส่งแล้วอยู่ใน client.messages
+ *
+ * ไม่มี sync WebServer (WebServer.h) - firmware ใช้แค่ Async
+ */
+
+#ifndef HOST_ESP_ASYNC_WEB_SERVER_H
+#define HOST_ESP_ASYNC_WEB_SERVER_H
+
+#include <functional>
+#include <map>
+#include <vector>
+#include "Arduino.h"
+#include "IPAddress.h"
+
+typedef enum {
+  HTTP_GET = 0b00000001,
+  HTTP_POST = 0b00000010,
+  HTTP_DELETE = 0b00000100,
+  HTTP_PUT = 0b00001000,
+  HTTP_ANY = 0b01111111
+} WebRequestMethod;
+
+typedef uint8_t WebRequestMethodComposite;
+
+class AsyncWebServerRequest;
+
+typedef std::function<void(AsyncWebServerRequest* request)> ArRequestHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest* request, const String& filename, size_t index,
+                           uint8_t* data, size_t length, bool final)> ArUploadHandlerFunction;
+typedef std::function<void(AsyncWebServerRequest* request, uint8_t* data, size_t length,
+                           size_t index, size_t total)> ArBodyHandlerFunction;
+typedef std::function<void(void)> ArDisconnectHandler;
+
+// ===== client / parameter =====
+class AsyncClient {
+public:
+  IPAddress remoteIP() const { return ip; }
+
+  IPAddress ip;
+};
+
+class AsyncWebParameter {
+public:
+  AsyncWebParameter(const String& name, const String& value) : paramName(name), paramValue(value) {}
+  const String& name() const { return paramName; }
+  const String& value() const { return paramValue; }
+
+private:
+  String paramName;
+  String paramValue;
+};
+
+// ===== response =====
+class AsyncWebServerResponse {
+public:
+  AsyncWebServerResponse(int code, const String& contentType) : code(code), contentType(contentType) {}
+  virtual ~AsyncWebServerResponse() {}
+  virtual std::string content() const = 0;
+
+  int code;
+  String contentType;
+};
+
+class AsyncBasicResponse : public AsyncWebServerResponse {
+public:
+  AsyncBasicResponse(int code, const String& contentType, const String& body)
+    : AsyncWebServerResponse(code, contentType), body(body.c_str(), body.length()) {}
+  std::string content() const override { return body; }
+
+private:
+  std::string body;
+};
+
+// อ่านจาก pointer ของ firmware ตอนส่ง (ไม่ copy ตอนสร้าง)
+class AsyncProgmemResponse : public AsyncWebServerResponse {
+public:
+  AsyncProgmemResponse(int code, const String& contentType, const uint8_t* data, size_t length)
+    : AsyncWebServerResponse(code, contentType), data(data), length(length) {}
+  std::string content() const override { return std::string((const char*)data, length); }
+
+private:
+  const uint8_t* data;
+  size_t length;
+};
+
+// Print ที่สะสม body ใน buffer ของ response (heap ของ library จริง)
+class AsyncResponseStream : public AsyncWebServerResponse, public Print {
+public:
+  AsyncResponseStream(const String& contentType, size_t bufferSize)
+    : AsyncWebServerResponse(200, contentType) {
+    body.reserve(bufferSize);
+  }
+  using Print::write;
+  size_t write(uint8_t c) override {
+    body.push_back((char)c);
+    return 1;
+  }
+  size_t write(const uint8_t* data, size_t length) override {
+    body.append((const char*)data, length);
+    return length;
+  }
+  std::string content() const override { return body; }
+
+private:
+  std::string body;
+};
+
+// ===== request =====
+class AsyncWebServerRequest {
+public:
+  AsyncWebServerRequest(WebRequestMethodComposite method, const char* url,
+                        IPAddress remoteIp = IPAddress(10, 1, 10, 2))
+    : requestMethod(method), requestUrl(url) {
+    tcp.ip = remoteIp;
+  }
+  ~AsyncWebServerRequest() { disconnect(); }
+
+  WebRequestMethodComposite method() const { return requestMethod; }
+  const String& url() const { return requestUrl; }
+  size_t contentLength() const { return bodyLength; }
+  AsyncClient* client() { return &tcp; }
+
+  bool hasParam(const String& name) const { return params.count(name.c_str()) > 0; }
+  AsyncWebParameter* getParam(const String& name) {
+    std::map<std::string, AsyncWebParameter>::iterator found = params.find(name.c_str());
+    return found == params.end() ? nullptr : &found->second;
+  }
+
+  void send(int code, const String& contentType = String(), const String& content = String()) {
+    AsyncBasicResponse response(code, contentType, content);
+    record(response);
+    responseBody = response.content();
+  }
+  void send(AsyncWebServerResponse* response) {
+    record(*response);
+    if (holdOpen) {
+      pending = response;
+      return;
+    }
+    responseBody = response->content();
+    delete response;
+  }
+  void onDisconnect(ArDisconnectHandler handler) { disconnectHandler = handler; }
+
+  AsyncResponseStream* beginResponseStream(const String& contentType, size_t bufferSize = 1460) {
+    return new AsyncResponseStream(contentType, bufferSize);
+  }
+  AsyncWebServerResponse* beginResponse(int code, const String& contentType, const String& content = String()) {
+    return new AsyncBasicResponse(code, contentType, content);
+  }
+  AsyncWebServerResponse* beginResponse_P(int code, const String& contentType,
+                                          const uint8_t* content, size_t length) {
+    return new AsyncProgmemResponse(code, contentType, content, length);
+  }
+
+  // ===== ฝั่ง host =====
+  void addParam(const char* name, const char* value) {
+    params.insert(std::make_pair(std::string(name), AsyncWebParameter(name, value)));
+  }
+
+  // client รับ response ที่ค้างจนหมดแล้วตัดการเชื่อมต่อ
+  void disconnect() {
+    if (pending != nullptr) {
+      responseBody = pending->content();
+      delete pending;
+      pending = nullptr;
+    }
+    if (disconnectHandler) {
+      ArDisconnectHandler handler = disconnectHandler;
+      disconnectHandler = nullptr;
+      handler();
+    }
+  }
+
+  size_t bodyLength = 0;
+  bool holdOpen = false;       // true = response ยังส่งไม่หมดจนกว่า disconnect()
+  int responseCode = 0;        // 0 = ยังไม่ได้ตอบ
+  unsigned responseCount = 0;  // ตอบมากกว่า 1 ครั้ง = bug ของ handler
+  std::string responseType;
+  std::string responseBody;    // holdOpen → ว่างจนกว่า disconnect()
+
+private:
+  void record(const AsyncWebServerResponse& response) {
+    responseCode = response.code;
+    responseType = response.contentType.c_str();
+    responseCount++;
+  }
+
+  AsyncWebServerResponse* pending = nullptr;
+  ArDisconnectHandler disconnectHandler;
+
+  WebRequestMethodComposite requestMethod;
+  String requestUrl;
+  AsyncClient tcp;
+  std::map<std::string, AsyncWebParameter> params;
+};
+
+// ===== WebSocket =====
+typedef enum {
+  WS_DISCONNECTED,
+  WS_CONNECTED,
+  WS_DISCONNECTING
+} AwsClientStatus;
+
+typedef enum {
+  WS_EVT_CONNECT,
+  WS_EVT_DISCONNECT,
+  WS_EVT_PONG,
+  WS_EVT_ERROR,
+  WS_EVT_DATA
+} AwsEventType;
+
+class AsyncWebSocket;
+
+class AsyncWebSocketClient {
+public:
+  explicit AsyncWebSocketClient(uint32_t id) : clientId(id) {}
+  uint32_t id() const { return clientId; }
+  AwsClientStatus status() const { return clientStatus; }
+  bool queueIsFull() const { return stalled; }
+  void text(const char* data, size_t length) { messages.push_back(std::string(data, length)); }
+
+  // ===== ฝั่ง host =====
+  bool stalled = false;
+  std::vector<std::string> messages;
+
+private:
+  friend class AsyncWebSocket;
+  uint32_t clientId;
+  AwsClientStatus clientStatus = WS_CONNECTED;
+};
+
+typedef std::function<void(AsyncWebSocket* socket, AsyncWebSocketClient* client, AwsEventType type,
+                           void* arg, uint8_t* data, size_t length)> AwsEventHandler;
+
+class AsyncWebHandler {
+public:
+  virtual ~AsyncWebHandler() {}
+};
+
+class AsyncWebSocket : public AsyncWebHandler {
+public:
+  explicit AsyncWebSocket(const String& url) : socketUrl(url) {}
+  ~AsyncWebSocket() {
+    for (size_t i = 0; i < clients.size(); i++) {
+      delete clients[i];
+    }
+  }
+
+  void onEvent(AwsEventHandler handler) { this->handler = handler; }
+  AsyncWebSocketClient* client(uint32_t id) {
+    for (size_t i = 0; i < clients.size(); i++) {
+      if (clients[i]->id() == id && clients[i]->clientStatus == WS_CONNECTED) {
+        return clients[i];
+      }
+    }
+    return nullptr;
+  }
+  void close(uint32_t id) {
+    AsyncWebSocketClient* found = client(id);
+    if (found != nullptr) {
+      found->clientStatus = WS_DISCONNECTED;
+      closeCount++;
+      if (handler) {
+        handler(this, found, WS_EVT_DISCONNECT, nullptr, nullptr, 0);
+      }
+    }
+  }
+  void cleanupClients() {}
+
+  // ===== ฝั่ง host =====
+  AsyncWebSocketClient* connect() {
+    AsyncWebSocketClient* added = new AsyncWebSocketClient(nextId++);
+    clients.push_back(added);
+    if (handler) {
+      handler(this, added, WS_EVT_CONNECT, nullptr, nullptr, 0);
+    }
+    return added;
+  }
+  void disconnect(AsyncWebSocketClient* client) { close(client->id()); }
+
+  unsigned long closeCount = 0;   // รวมที่ firmware สั่ง close() เอง
+
+private:
+  String socketUrl;
+  AwsEventHandler handler;
+  std::vector<AsyncWebSocketClient*> clients;
+  uint32_t nextId = 1;
+};
+
+// ===== server =====
+class AsyncWebServer {
+public:
+  explicit AsyncWebServer(uint16_t port) : port(port) {}
+
+  void on(const char* uri, WebRequestMethodComposite method, ArRequestHandlerFunction onRequest,
+          ArUploadHandlerFunction onUpload = nullptr, ArBodyHandlerFunction onBody = nullptr) {
+    Route route;
+    route.uri = uri;
+    route.method = method;
+    route.onRequest = onRequest;
+    route.onBody = onBody;
+    routes.push_back(route);
+  }
+  void onNotFound(ArRequestHandlerFunction handler) { notFound = handler; }
+  void addHandler(AsyncWebHandler* handler) {}
+  void begin() { started = true; }
+
+  // ===== ฝั่ง host =====
+  // ส่ง body ทีละ chunkSize byte (TCP segment) แล้วเรียก handler ของ route
+  void serve(AsyncWebServerRequest& request, const char* body = nullptr, size_t length = 0,
+             size_t chunkSize = 1460) {
+    request.bodyLength = length;
+    for (size_t i = 0; i < routes.size(); i++) {
+      const Route& route = routes[i];
+      if (route.uri != request.url().c_str() || (route.method & request.method()) == 0) {
+        continue;
+      }
+      if (route.onBody && length > 0) {
+        for (size_t index = 0; index < length; index += chunkSize) {
+          size_t n = std::min(chunkSize, length - index);
+          route.onBody(&request, (uint8_t*)body + index, n, index, length);
+        }
+      }
+      route.onRequest(&request);
+      finish(request);
+      return;
+    }
+    if (notFound) {
+      notFound(&request);
+    }
+    finish(request);
+  }
+
+  bool started = false;
+
+private:
+  void finish(AsyncWebServerRequest& request) {
+    if (!request.holdOpen) {
+      request.disconnect();
+    }
+  }
+
+  struct Route {
+    std::string uri;
+    WebRequestMethodComposite method;
+    ArRequestHandlerFunction onRequest;
+    ArBodyHandlerFunction onBody;
+  };
+
+  uint16_t port;
+  std::vector<Route> routes;
+  ArRequestHandlerFunction notFound;
+};
+
+#endif
@@ -0,0 +1,10 @@
+/**
+ * HTTPClient.h (host shim) - ชื่อ header ของ ESP32 → ใช้ HTTPClient ตัวเดียวกับ ESP8266HTTPClient.h
+ */
+
+#ifndef HOST_HTTP_CLIENT_H
+#define HOST_HTTP_CLIENT_H
+
+#include "ESP8266HTTPClient.h"
+
+#endif
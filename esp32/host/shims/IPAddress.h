@@ -0,0 +1,50 @@
+/**
+ * IPAddress.h (host shim)
+ * IPv4 แบบ Arduino: (uint32_t) เป็น byte order ของบอร์ด - byte แรกคือส่วนแรกของ address
+ */
+
+#ifndef HOST_IP_ADDRESS_H
+#define HOST_IP_ADDRESS_H
+
+#include "Arduino.h"
+
+class IPAddress : public Printable {
+public:
+  IPAddress() : address(0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+    : address((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+  IPAddress(uint32_t value) : address(value) {}
+
+  operator uint32_t() const { return address; }
+  uint8_t operator[](int index) const { return (uint8_t)(address >> (index * 8)); }
+
+  bool fromString(const char* text) {
+    unsigned parts[4];
+    char tail;
+    if (text == nullptr || sscanf(text, "%u.%u.%u.%u%c", &parts[0], &parts[1], &parts[2], &parts[3], &tail) != 4) {
+      return false;
+    }
+    for (int i = 0; i < 4; i++) {
+      if (parts[i] > 255) {
+        return false;
+      }
+    }
+    *this = IPAddress(parts[0], parts[1], parts[2], parts[3]);
+    return true;
+  }
+
+  String toString() const {
+    char text[16];
+    snprintf(text, sizeof(text), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+    return String(text);
+  }
+
+  size_t printTo(Print& p) const override {
+    return p.print(toString());
+  }
+
+private:
+  uint32_t address;
+};
+
+#endif
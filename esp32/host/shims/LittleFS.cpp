@@ -0,0 +1,160 @@
+/**
+ * LittleFS.cpp (host shim) - ระบบไฟล์ในหน่วยความจำ (ดู LittleFS.h)
+ */
+
+#include "LittleFS.h"
+#include <string.h>
+
+HostFS LittleFS;
+
+// ===== File =====
+File::operator bool() const {
+  return file != nullptr && fs != nullptr && fs->mounted && generation == fs->generation;
+}
+
+bool File::seek(uint32_t offset, SeekMode mode) {
+  if (!*this) {
+    return false;
+  }
+  size_t base = mode == SeekSet ? 0 : mode == SeekCur ? pos : file->data.size();
+  size_t target = base + offset;
+  if (target > file->data.size()) {
+    return false;
+  }
+  pos = target;
+  return true;
+}
+
+size_t File::size() const {
+  return *this ? file->data.size() : 0;
+}
+
+size_t File::read(uint8_t* buffer, size_t length) {
+  if (!*this || pos >= file->data.size()) {
+    return 0;
+  }
+  size_t n = file->data.size() - pos;
+  if (n > length) {
+    n = length;
+  }
+  memcpy(buffer, &file->data[pos], n);
+  pos += n;
+  return n;
+}
+
+int File::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+size_t File::write(const uint8_t* buffer, size_t length) {
+  if (!*this || !writable) {
+    return 0;
+  }
+  size_t n = length;
+  if (fs->writeBudget >= 0 && (long)n > fs->writeBudget) {
+    n = fs->writeBudget;
+  }
+  if (fs->writeBudget >= 0) {
+    fs->writeBudget -= n;
+  }
+  if (pos + n > file->data.size()) {
+    file->data.resize(pos + n);
+  }
+  if (n > 0) {
+    memcpy(&file->data[pos], buffer, n);
+  }
+  pos += n;
+  return n;
+}
+
+void File::flush() {
+  if (!*this || !writable) {
+    return;
+  }
+  file->committed = file->data;
+  file->exists = true;
+  fs->flushCount++;
+}
+
+void File::close() {
+  flush();
+  file.reset();
+}
+
+// ===== HostFS =====
+bool HostFS::begin(bool formatOnFail) {
+  mounted = true;
+  return true;
+}
+
+bool HostFS::format() {
+  files.clear();
+  return true;
+}
+
+bool HostFS::exists(const char* path) {
+  return mounted && files.count(path) > 0;
+}
+
+bool HostFS::remove(const char* path) {
+  return mounted && files.erase(path) > 0;
+}
+
+File HostFS::open(const char* path, const char* mode) {
+  if (!mounted) {
+    return File();
+  }
+  std::shared_ptr<HostFileData>& file = files[path];
+  bool create = mode[0] == 'w' || mode[0] == 'a';
+  if (file == nullptr) {
+    if (!create) {
+      files.erase(path);
+      return File();
+    }
+    file = std::make_shared<HostFileData>();
+  }
+  if (mode[0] == 'w') {
+    file->data.clear();
+  }
+  bool writable = mode[0] != 'r' || strchr(mode, '+') != nullptr;
+  File handle(this, file, writable, generation);
+  if (mode[0] == 'a') {
+    handle.seek(0, SeekEnd);
+  }
+  return handle;
+}
+
+void HostFS::powerLoss() {
+  generation++;
+  mounted = false;
+  writeBudget = -1;
+  for (auto it = files.begin(); it != files.end();) {
+    if (!it->second->exists) {
+      it = files.erase(it);
+      continue;
+    }
+    it->second->data = it->second->committed;
+    ++it;
+  }
+}
+
+bool HostFS::corrupt(const char* path, size_t offset, uint8_t mask) {
+  auto it = files.find(path);
+  if (it == files.end() || offset >= it->second->committed.size()) {
+    return false;
+  }
+  it->second->committed[offset] ^= mask;
+  if (offset < it->second->data.size()) {
+    it->second->data[offset] ^= mask;
+  }
+  return true;
+}
+
+void HostFS::reset() {
+  files.clear();
+  generation++;
+  mounted = false;
+  writeBudget = -1;
+  flushCount = 0;
+}
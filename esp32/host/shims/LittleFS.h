@@ -0,0 +1,94 @@
+/**
+ * LittleFS.h (host shim)
+ * ระบบไฟล์ในหน่วยความจำ - API เดียวกับ LittleFS ของ ESP8266/ESP32 เท่าที่ Journal.h ใช้
+ *
+ * แต่ละไฟล์มีสองสถานะ:
+ *   data      = สิ่งที่อ่านได้ตอนนี้ (รวมที่ write แล้วแต่ยังไม่ flush)
+ *   committed = สถานะตอน flush()/close() ล่าสุด
+ *
+ * จำลองไฟดับ (ฝั่ง host):
+ *   LittleFS.powerLoss()        → ทุกไฟล์ย้อนกลับไปที่ committed (แบบ LittleFS จริง: copy-on-write)
+ *                                 handle ที่เปิดอยู่ใช้ไม่ได้อีก - ต้อง begin()/open() ใหม่
+ *   LittleFS.tearAfter(n)       → write หลังจากนี้ลง flash ได้อีก n byte แล้วหยุด (write คืนค่าสั้น)
+ *                                 ใช้คู่กับ flush()/powerLoss() = record ที่เขียนไม่ครบ (flash ที่ไม่ atomic)
+ *   LittleFS.corrupt(path, offset) → กลับ bit ของ byte ที่ offset ทั้งใน data และ committed
+ */
+
+#ifndef HOST_LITTLEFS_H
+#define HOST_LITTLEFS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum SeekMode {
+  SeekSet = 0,
+  SeekCur = 1,
+  SeekEnd = 2
+};
+
+struct HostFileData {
+  std::vector<uint8_t> data;
+  std::vector<uint8_t> committed;
+  bool exists = false;          // มีอยู่ใน committed (ไฟล์ที่สร้างแล้วยังไม่ flush หายเมื่อไฟดับ)
+  uint32_t generation = 0;      // เพิ่มทุกครั้งที่ไฟดับ → handle เก่าใช้ไม่ได้
+};
+
+class HostFS;
+
+class File {
+public:
+  File() {}
+  File(HostFS* fs, std::shared_ptr<HostFileData> file, bool writable, uint32_t generation)
+    : fs(fs), file(file), writable(writable), generation(generation) {}
+
+  explicit operator bool() const;
+  bool seek(uint32_t pos, SeekMode mode = SeekSet);
+  size_t position() const { return pos; }
+  size_t size() const;
+  size_t read(uint8_t* buffer, size_t length);
+  int read();
+  size_t write(const uint8_t* buffer, size_t length);
+  size_t write(uint8_t c) { return write(&c, 1); }
+  void flush();
+  void close();
+
+private:
+  HostFS* fs = nullptr;
+  std::shared_ptr<HostFileData> file;
+  bool writable = false;
+  uint32_t generation = 0;
+  size_t pos = 0;
+};
+
+class HostFS {
+public:
+  bool begin(bool formatOnFail = false);
+  bool format();
+  void end() { mounted = false; }
+  bool exists(const char* path);
+  bool remove(const char* path);
+  File open(const char* path, const char* mode);
+
+  // ===== ฝั่ง host =====
+  void powerLoss();
+  void tearAfter(long bytes) { writeBudget = bytes; }
+  bool corrupt(const char* path, size_t offset, uint8_t mask = 0xFF);
+  void reset();
+
+  // write ที่ยังลง flash ได้ (-1 = ไม่จำกัด) - File::write ใช้
+  long writeBudget = -1;
+  uint32_t generation = 0;
+  bool mounted = false;
+  unsigned long flushCount = 0;
+
+private:
+  std::map<std::string, std::shared_ptr<HostFileData>> files;
+};
+
+extern HostFS LittleFS;
+
+#endif
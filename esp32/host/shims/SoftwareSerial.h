@@ -0,0 +1,25 @@
+/**
+ * SoftwareSerial.h (host shim)
+ * SoftwareSerial ของ ESP8266 = HardwareSerial ของ shim (output เก็บใน buffer / input ป้อนด้วย inject())
+ * ไม่จำลองการหลุดของ byte ตอน interrupt ถูกปิด
+ */
+
+#ifndef HOST_SOFTWARE_SERIAL_H
+#define HOST_SOFTWARE_SERIAL_H
+
+#include "Arduino.h"
+
+class SoftwareSerial : public HardwareSerial {
+public:
+  SoftwareSerial(int8_t rxPin, int8_t txPin, bool invert = false) {}
+
+  using HardwareSerial::read;
+  int read(uint8_t* buffer, size_t size) { return (int)readBytes(buffer, size); }
+
+  bool overflow() { return false; }
+  bool isListening() { return true; }
+  bool listen() { return true; }
+  void enableIntTx(bool enable) {}
+};
+
+#endif
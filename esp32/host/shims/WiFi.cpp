@@ -0,0 +1,7 @@
+/**
+ * WiFi.cpp (host shim) - ตัวแปร WiFi ของ WiFi.h
+ */
+
+#include "WiFi.h"
+
+HostWiFi WiFi;
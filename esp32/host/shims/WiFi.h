@@ -0,0 +1,199 @@
+/**
+ * WiFi.h (host shim)
+ * WiFi แบบ ESP32/ESP8266 จำลอง - ไม่มีวิทยุ: ทุกคำสั่งสำเร็จทันทีและเก็บค่าไว้ให้ฝั่ง host ตรวจ
+ *
+ * - STA: begin() ตั้ง status() เป็น hostStaStatus (ค่าเริ่มต้น WL_CONNECTED)
+ * - AP: softAP()/softAPConfig() เก็บ SSID/IP ไว้ / ฝั่ง host ตั้งจำนวน station ได้
+ * - event: onEvent() (ESP32) / onSoftAPModeStation*() (ESP8266) เก็บ callback
+ *   แล้วฝั่ง host เรียก stationJoin()/stationLeave() เพื่อจำลองอุปกรณ์ต่อ/หลุด
+ */
+
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include <functional>
+#include <memory>
+#include "Arduino.h"
+#include "IPAddress.h"
+#include "WiFiClient.h"
+#include "WiFiUdp.h"
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_SCAN_COMPLETED = 2,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+  WIFI_OFF = 0,
+  WIFI_STA = 1,
+  WIFI_AP = 2,
+  WIFI_AP_STA = 3
+} WiFiMode_t;
+
+// ===== ESP32: WiFi.onEvent() =====
+typedef enum {
+  ARDUINO_EVENT_WIFI_AP_STACONNECTED,
+  ARDUINO_EVENT_WIFI_AP_STADISCONNECTED
+} WiFiEvent_t;
+
+struct HostStationMac {
+  uint8_t mac[6];
+};
+
+union WiFiEventInfo_t {
+  HostStationMac wifi_ap_staconnected;
+  HostStationMac wifi_ap_stadisconnected;
+};
+
+typedef void (*WiFiEventFuncCb)(WiFiEvent_t event, WiFiEventInfo_t info);
+
+// ===== ESP8266: onSoftAPModeStation*() =====
+struct WiFiEventSoftAPModeStationConnected {
+  uint8_t mac[6];
+  uint8_t aid;
+};
+
+struct WiFiEventSoftAPModeStationDisconnected {
+  uint8_t mac[6];
+  uint8_t aid;
+};
+
+typedef std::shared_ptr<void> WiFiEventHandler;
+
+class HostWiFi {
+public:
+  // ===== STA =====
+  void mode(WiFiMode_t mode) { currentMode = mode; }
+  WiFiMode_t getMode() const { return currentMode; }
+  void persistent(bool persistent) {}
+  void setAutoReconnect(bool autoReconnect) {}
+  bool config(IPAddress localIp, IPAddress gateway, IPAddress subnet) {
+    staIp = localIp;
+    return true;
+  }
+  wl_status_t begin(const char* ssid, const char* password, int32_t channel = 0,
+                    const uint8_t* bssid = nullptr) {
+    beginCount++;
+    staSsid = ssid;
+    staStatus = hostStaStatus;
+    return staStatus;
+  }
+  bool disconnect(bool wifiOff = false) {
+    staStatus = WL_DISCONNECTED;
+    return true;
+  }
+  wl_status_t status() const { return staStatus; }
+  IPAddress localIP() const { return staIp; }
+  IPAddress gatewayIP() const { return IPAddress(staIp[0], staIp[1], staIp[2], 1); }
+  IPAddress subnetMask() const { return IPAddress(255, 255, 255, 0); }
+  String SSID() const { return String(staSsid.c_str()); }
+  int32_t RSSI() const { return -55; }
+  uint8_t* BSSID() { return bssid; }
+  String BSSIDstr() const { return formatMac(bssid); }
+  int32_t channel() const { return 1; }
+  String macAddress() const { return formatMac(mac); }
+  uint8_t* macAddress(uint8_t* out) const {
+    memcpy(out, mac, sizeof(mac));
+    return out;
+  }
+
+  // ===== AP =====
+  bool softAPConfig(IPAddress localIp, IPAddress gateway, IPAddress subnet) {
+    apIp = localIp;
+    return true;
+  }
+  bool softAP(const char* ssid, const char* password = nullptr) {
+    apSsid = ssid;
+    return true;
+  }
+  IPAddress softAPIP() const { return apIp; }
+  String softAPSSID() const { return String(apSsid.c_str()); }
+  String softAPmacAddress() const { return formatMac(mac); }
+  uint8_t softAPgetStationNum() const { return stationCount; }
+
+  // ===== events =====
+  void onEvent(WiFiEventFuncCb callback, WiFiEvent_t event) {
+    if (event == ARDUINO_EVENT_WIFI_AP_STACONNECTED) {
+      onJoin = callback;
+    } else {
+      onLeave = callback;
+    }
+  }
+  WiFiEventHandler onSoftAPModeStationConnected(
+      std::function<void(const WiFiEventSoftAPModeStationConnected&)> callback) {
+    onJoin8266 = callback;
+    return WiFiEventHandler(new int(0), [](void* p) { delete (int*)p; });
+  }
+  WiFiEventHandler onSoftAPModeStationDisconnected(
+      std::function<void(const WiFiEventSoftAPModeStationDisconnected&)> callback) {
+    onLeave8266 = callback;
+    return WiFiEventHandler(new int(0), [](void* p) { delete (int*)p; });
+  }
+
+  // ===== ฝั่ง host =====
+  wl_status_t hostStaStatus = WL_CONNECTED;
+  uint8_t mac[6] = { 0x24, 0x6F, 0x28, 0x00, 0x00, 0x01 };
+  uint8_t bssid[6] = { 0x24, 0x6F, 0x28, 0x00, 0x00, 0xAA };
+  uint8_t stationCount = 0;
+  unsigned long beginCount = 0;
+
+  void stationJoin(const uint8_t* stationMac) {
+    stationCount++;
+    if (onJoin != nullptr) {
+      WiFiEventInfo_t info;
+      memcpy(info.wifi_ap_staconnected.mac, stationMac, 6);
+      onJoin(ARDUINO_EVENT_WIFI_AP_STACONNECTED, info);
+    }
+    if (onJoin8266) {
+      WiFiEventSoftAPModeStationConnected event;
+      memcpy(event.mac, stationMac, 6);
+      event.aid = stationCount;
+      onJoin8266(event);
+    }
+  }
+
+  void stationLeave(const uint8_t* stationMac) {
+    if (stationCount > 0) {
+      stationCount--;
+    }
+    if (onLeave != nullptr) {
+      WiFiEventInfo_t info;
+      memcpy(info.wifi_ap_stadisconnected.mac, stationMac, 6);
+      onLeave(ARDUINO_EVENT_WIFI_AP_STADISCONNECTED, info);
+    }
+    if (onLeave8266) {
+      WiFiEventSoftAPModeStationDisconnected event;
+      memcpy(event.mac, stationMac, 6);
+      event.aid = 0;
+      onLeave8266(event);
+    }
+  }
+
+private:
+  static String formatMac(const uint8_t* bytes) {
+    char text[18];
+    snprintf(text, sizeof(text), "%02X:%02X:%02X:%02X:%02X:%02X",
+             bytes[0], bytes[1], bytes[2], bytes[3], bytes[4], bytes[5]);
+    return String(text);
+  }
+
+  WiFiMode_t currentMode = WIFI_OFF;
+  wl_status_t staStatus = WL_IDLE_STATUS;
+  IPAddress staIp;
+  IPAddress apIp;
+  std::string staSsid;
+  std::string apSsid;
+  WiFiEventFuncCb onJoin = nullptr;
+  WiFiEventFuncCb onLeave = nullptr;
+  std::function<void(const WiFiEventSoftAPModeStationConnected&)> onJoin8266;
+  std::function<void(const WiFiEventSoftAPModeStationDisconnected&)> onLeave8266;
+};
+
+extern HostWiFi WiFi;
+
+#endif
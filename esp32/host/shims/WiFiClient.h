@@ -0,0 +1,34 @@
+/**
+ * WiFiClient.h (host shim)
+ * TCP client จำลอง - ไม่มี socket จริง: connected() เป็นสถานะที่ HTTPClient ของ shim ตั้ง
+ * ฝั่ง host ตัดการเชื่อมต่อเองได้ (dropByPeer) เพื่อจำลอง Center ปิด socket ที่ค้าง
+ */
+
+#ifndef HOST_WIFI_CLIENT_H
+#define HOST_WIFI_CLIENT_H
+
+#include "Arduino.h"
+
+class WiFiClient {
+public:
+  bool connected() const { return isConnected; }
+  void stop() {
+    isConnected = false;
+    stopCount++;
+  }
+
+  // ===== ฝั่ง host =====
+  void open() {
+    isConnected = true;
+    openCount++;
+  }
+  void dropByPeer() { isConnected = false; }
+
+  unsigned long openCount = 0;
+  unsigned long stopCount = 0;
+
+private:
+  bool isConnected = false;
+};
+
+#endif
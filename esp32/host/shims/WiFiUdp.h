@@ -0,0 +1,90 @@
+/**
+ * WiFiUdp.h (host shim)
+ * UDP จำลอง - ไม่มี socket จริง
+ *
+ * ขาเข้า: ฝั่ง host ป้อน datagram ด้วย inject() แล้ว firmware อ่านผ่าน parsePacket()/read() ตามปกติ
+ * ขาออก: beginPacket() → write() → endPacket() เก็บเป็น datagram ใน sent (ตรวจ/ป้อนให้อีกฝั่งได้)
+ */
+
+#ifndef HOST_WIFI_UDP_H
+#define HOST_WIFI_UDP_H
+
+#include "Arduino.h"
+#include "IPAddress.h"
+
+struct HostDatagram {
+  IPAddress ip;
+  uint16_t port;
+  std::string data;
+};
+
+class WiFiUDP {
+public:
+  uint8_t begin(uint16_t port) {
+    localPort = port;
+    return 1;
+  }
+  void stop() {}
+
+  int parsePacket() {
+    current.data.clear();
+    currentOffset = 0;
+    if (inbox.empty()) {
+      return 0;
+    }
+    current = inbox.front();
+    inbox.pop_front();
+    return (int)current.data.size();
+  }
+  int available() { return (int)(current.data.size() - currentOffset); }
+  int read(uint8_t* buffer, size_t length) {
+    size_t n = std::min(length, current.data.size() - currentOffset);
+    memcpy(buffer, current.data.data() + currentOffset, n);
+    currentOffset += n;
+    return (int)n;
+  }
+  int read(char* buffer, size_t length) { return read((uint8_t*)buffer, length); }
+  IPAddress remoteIP() const { return current.ip; }
+  uint16_t remotePort() const { return current.port; }
+
+  int beginPacket(IPAddress ip, uint16_t port) {
+    outgoing.ip = ip;
+    outgoing.port = port;
+    outgoing.data.clear();
+    return 1;
+  }
+  int beginPacket(const char* host, uint16_t port) {
+    IPAddress ip;
+    ip.fromString(host);
+    return beginPacket(ip, port);
+  }
+  size_t write(const uint8_t* data, size_t length) {
+    outgoing.data.append((const char*)data, length);
+    return length;
+  }
+  size_t write(uint8_t c) { return write(&c, 1); }
+  int endPacket() {
+    sent.push_back(outgoing);
+    return 1;
+  }
+
+  // ===== ฝั่ง host =====
+  void inject(const uint8_t* data, size_t length, IPAddress ip, uint16_t port) {
+    HostDatagram datagram;
+    datagram.ip = ip;
+    datagram.port = port;
+    datagram.data.assign((const char*)data, length);
+    inbox.push_back(datagram);
+  }
+
+  uint16_t localPort = 0;
+  std::deque<HostDatagram> sent;
+
+private:
+  std::deque<HostDatagram> inbox;
+  HostDatagram current;
+  size_t currentOffset = 0;
+  HostDatagram outgoing;
+};
+
+#endif
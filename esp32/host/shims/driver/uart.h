@@ -0,0 +1,120 @@
+/**
+ * driver/uart.h (host shim)
+ * UART driver ของ ESP-IDF เท่าที่ RS232Reader.h ใช้
+ *
+ * byte ที่ป้อนด้วย Host_uartInject() ไปอยู่ใน ring ของ driver แล้วแจ้ง UART_DATA เข้า event queue
+ * (แบบ driver จริง) - test อ่านต่อด้วย uart_read_bytes() / task ของ firmware ตามปกติ
+ */
+
+#ifndef HOST_DRIVER_UART_H
+#define HOST_DRIVER_UART_H
+
+#include "Arduino.h"
+
+typedef int uart_port_t;
+
+#define UART_NUM_0 0
+#define UART_NUM_1 1
+#define UART_NUM_2 2
+#define UART_NUM_MAX 3
+#define UART_PIN_NO_CHANGE (-1)
+
+enum uart_word_length_t { UART_DATA_5_BITS, UART_DATA_6_BITS, UART_DATA_7_BITS, UART_DATA_8_BITS };
+enum uart_parity_t { UART_PARITY_DISABLE, UART_PARITY_EVEN, UART_PARITY_ODD };
+enum uart_stop_bits_t { UART_STOP_BITS_1 = 1, UART_STOP_BITS_1_5, UART_STOP_BITS_2 };
+enum uart_hw_flowcontrol_t { UART_HW_FLOWCTRL_DISABLE, UART_HW_FLOWCTRL_RTS };
+
+struct uart_config_t {
+  int baud_rate;
+  uart_word_length_t data_bits;
+  uart_parity_t parity;
+  uart_stop_bits_t stop_bits;
+  uart_hw_flowcontrol_t flow_ctrl;
+  uint8_t rx_flow_ctrl_thresh;
+};
+
+enum uart_event_type_t {
+  UART_DATA,
+  UART_BREAK,
+  UART_BUFFER_FULL,
+  UART_FIFO_OVF,
+  UART_FRAME_ERR,
+  UART_PARITY_ERR
+};
+
+struct uart_event_t {
+  uart_event_type_t type;
+  size_t size;
+  bool timeout_flag;
+};
+
+struct HostUart {
+  bool installed = false;
+  int baud = 0;
+  size_t rxBufferSize = 0;
+  QueueHandle_t events = nullptr;
+  std::deque<uint8_t> rx;
+};
+
+inline HostUart& Host_uart(uart_port_t port) {
+  static HostUart uarts[UART_NUM_MAX];
+  return uarts[port];
+}
+
+inline int uart_driver_install(uart_port_t port, int rxBufferSize, int txBufferSize, int queueSize,
+                               QueueHandle_t* queue, int flags) {
+  HostUart& uart = Host_uart(port);
+  uart.installed = true;
+  uart.rxBufferSize = rxBufferSize;
+  uart.events = xQueueCreate(queueSize, sizeof(uart_event_t));
+  if (queue != nullptr) {
+    *queue = uart.events;
+  }
+  return 0;
+}
+
+inline int uart_param_config(uart_port_t port, const uart_config_t* config) {
+  Host_uart(port).baud = config->baud_rate;
+  return 0;
+}
+
+inline int uart_set_pin(uart_port_t port, int tx, int rx, int rts, int cts) {
+  return 0;
+}
+
+inline int uart_set_baudrate(uart_port_t port, uint32_t baud) {
+  Host_uart(port).baud = baud;
+  return 0;
+}
+
+inline int uart_flush_input(uart_port_t port) {
+  Host_uart(port).rx.clear();
+  return 0;
+}
+
+inline int uart_read_bytes(uart_port_t port, void* buffer, uint32_t length, TickType_t wait) {
+  HostUart& uart = Host_uart(port);
+  uint8_t* out = (uint8_t*)buffer;
+  uint32_t n = 0;
+  while (n < length && !uart.rx.empty()) {
+    out[n++] = uart.rx.front();
+    uart.rx.pop_front();
+  }
+  return (int)n;
+}
+
+// ===== ฝั่ง host: byte เข้าสาย → ring ของ driver + event (ring เต็ม = UART_BUFFER_FULL แบบ driver จริง) =====
+inline void Host_uartInject(uart_port_t port, const uint8_t* data, size_t length) {
+  HostUart& uart = Host_uart(port);
+  uart_event_t event = {};
+  if (uart.rx.size() + length > uart.rxBufferSize) {
+    event.type = UART_BUFFER_FULL;
+  } else {
+    uart.rx.insert(uart.rx.end(), data, data + length);
+    event.type = UART_DATA;
+    event.size = length;
+  }
+  xQueueSend(uart.events, &event, 0);
+}
+
+#endif
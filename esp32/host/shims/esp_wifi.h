@@ -0,0 +1,35 @@
+/**
+ * esp_wifi.h (host shim) - esp_wifi_ap_get_sta_list() คืนรายชื่อ station ตาม WiFi.stationCount
+ */
+
+#ifndef HOST_ESP_WIFI_H
+#define HOST_ESP_WIFI_H
+
+#include "WiFi.h"
+
+#define ESP_WIFI_MAX_CONN_NUM 10
+
+typedef int esp_err_t;
+#define ESP_OK 0
+
+typedef struct {
+  uint8_t mac[6];
+  int8_t rssi;
+} wifi_sta_info_t;
+
+typedef struct {
+  wifi_sta_info_t sta[ESP_WIFI_MAX_CONN_NUM];
+  int num;
+} wifi_sta_list_t;
+
+inline esp_err_t esp_wifi_ap_get_sta_list(wifi_sta_list_t* list) {
+  list->num = WiFi.softAPgetStationNum() < ESP_WIFI_MAX_CONN_NUM ? WiFi.softAPgetStationNum() : ESP_WIFI_MAX_CONN_NUM;
+  for (int i = 0; i < list->num; i++) {
+    memset(list->sta[i].mac, 0, 6);
+    list->sta[i].mac[5] = (uint8_t)(i + 1);
+    list->sta[i].rssi = -50;
+  }
+  return ESP_OK;
+}
+
+#endif
@@ -0,0 +1,143 @@
+/**
+ * freertos/FreeRTOS.h (host shim)
+ * FreeRTOS ของ ESP32 เท่าที่ firmware ใช้ (Arduino.h ของ shim include ให้เมื่อเป็น ESP32 แบบ core จริง)
+ *
+ * - portMUX / portENTER_CRITICAL: spinlock จริง (test ที่ใช้หลาย thread ได้ผลถูก)
+ * - queue: เก็บ item ใน deque - xQueueReceive()/xQueueSend() ไม่รอ (นาฬิกาเป็นของจำลอง รอไปก็ไม่มีใครเติมให้)
+ * - xTaskCreatePinnedToCore(): บันทึกไว้แต่ไม่สร้าง thread
+ *   (task ของ firmware วนไม่รู้จบ - test เรียกฟังก์ชันข้างในเองทีละขั้น)
+ * - 1 tick = 1 ms (configTICK_RATE_HZ ของ Arduino ESP32) / vTaskDelay() เลื่อนนาฬิกาจำลอง
+ */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+#include <string.h>
+#include <deque>
+#include <string>
+#include <vector>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define pdFAIL 0
+#define portMAX_DELAY 0xFFFFFFFFUL
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+// ===== critical section =====
+struct portMUX_TYPE {
+  volatile int locked;
+};
+
+#define portMUX_INITIALIZER_UNLOCKED { 0 }
+
+inline void Host_muxEnter(portMUX_TYPE* mux) {
+  while (__sync_lock_test_and_set(&mux->locked, 1)) {
+  }
+}
+
+inline void Host_muxExit(portMUX_TYPE* mux) {
+  __sync_lock_release(&mux->locked);
+}
+
+#define portENTER_CRITICAL(mux) Host_muxEnter(mux)
+#define portEXIT_CRITICAL(mux) Host_muxExit(mux)
+#define portENTER_CRITICAL_ISR(mux) Host_muxEnter(mux)
+#define portEXIT_CRITICAL_ISR(mux) Host_muxExit(mux)
+
+// ===== queue =====
+struct HostQueue {
+  size_t length;
+  size_t itemSize;
+  std::deque<std::vector<uint8_t> > items;
+};
+
+typedef HostQueue* QueueHandle_t;
+
+inline QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  HostQueue* queue = new HostQueue();
+  queue->length = length;
+  queue->itemSize = itemSize;
+  return queue;
+}
+
+inline BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t wait) {
+  if (queue == nullptr || queue->items.size() >= queue->length) {
+    return pdFALSE;
+  }
+  const uint8_t* bytes = (const uint8_t*)item;
+  queue->items.push_back(std::vector<uint8_t>(bytes, bytes + queue->itemSize));
+  return pdTRUE;
+}
+
+inline BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t wait) {
+  if (queue == nullptr || queue->items.empty()) {
+    return pdFALSE;
+  }
+  memcpy(item, queue->items.front().data(), queue->itemSize);
+  queue->items.pop_front();
+  return pdTRUE;
+}
+
+inline BaseType_t xQueueReset(QueueHandle_t queue) {
+  if (queue != nullptr) {
+    queue->items.clear();
+  }
+  return pdPASS;
+}
+
+inline UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  return queue != nullptr ? (UBaseType_t)queue->items.size() : 0;
+}
+
+// ===== task =====
+typedef void (*TaskFunction_t)(void*);
+
+struct HostTask {
+  TaskFunction_t function;
+  std::string name;
+  uint32_t stackSize;
+  void* arg;
+  UBaseType_t priority;
+  BaseType_t core;
+};
+
+typedef HostTask* TaskHandle_t;
+
+// task ที่ firmware สร้าง (ฝั่ง host ดูชื่อ/ขนาด stack ได้)
+inline std::vector<HostTask*>& Host_tasks() {
+  static std::vector<HostTask*> tasks;
+  return tasks;
+}
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t stackSize,
+                                          void* arg, UBaseType_t priority, TaskHandle_t* handle,
+                                          BaseType_t core) {
+  HostTask* task = new HostTask();
+  task->function = function;
+  task->name = name;
+  task->stackSize = stackSize;
+  task->arg = arg;
+  task->priority = priority;
+  task->core = core;
+  Host_tasks().push_back(task);
+  if (handle != nullptr) {
+    *handle = task;
+  }
+  return pdPASS;
+}
+
+inline void vTaskDelay(TickType_t ticks) {
+  Host_advanceMillis(ticks);
+}
+
+inline UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+  return 0;   // วัดบน host ด้วย bench/BenchProbe.h แทน
+}
+
+#endif
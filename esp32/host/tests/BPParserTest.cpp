@@ -0,0 +1,83 @@
+/**
+ * BPParserTest.cpp - ดึงค่าจาก JSON ของเครื่องวัดความดัน (ESP32_RS232/BPParser.h) - ต้องมี ArduinoJson
+ *
+ * - เฟรมเต็ม 400+ bytes (field อื่นถูก filter ทิ้ง) → 4 fields ครบ
+ * - idcard เป็นตัวเลข (ไม่มี "") → ได้ข้อความเหมือน as<String>() ของวิธีเดิม
+ * - ไม่มีบาง field → fields บอกว่ามีอะไร / JSON เสีย → คืน error
+ */
+
+#include "HostCheck.h"
+#include "BPParser.h"
+
+#include <string>
+
+static DeserializationError extract(const char* json, BPReading& reading) {
+  std::string copy = json;   // BP_extractReading แก้ buffer (zero-copy)
+  return BP_extractReading(&copy[0], copy.size(), reading);
+}
+
+static void testFullFrame() {
+  BPReading reading;
+  DeserializationError error = extract(
+      "{\"end_time\":\"2026-10-17 09:10:00\",\"start_time\":\"2026-10-17 09:09:25\",\"device_model\":\"BP-900\","
+      "\"serial_no\":\"BP9A0031884\",\"idcard\":\"1103700012345\",\"name\":\"\",\"sex\":\"\",\"age\":\"\","
+      "\"blood_pressure_h\":127,\"blood_pressure_l\":82,\"heart_rate\":74,\"mean_pressure\":97,"
+      "\"irregular_heartbeat\":0,\"body_movement\":0,\"cuff_fit\":1,\"measure_mode\":\"auto\",\"arm\":\"left\","
+      "\"error_code\":0,\"retry\":0,\"unit\":\"mmHg\",\"firmware\":\"2.14.7\"}",
+      reading);
+  CHECK(!error);
+  CHECK_EQ(reading.fields, BP_FIELD_IDCARD | BP_FIELD_BP | BP_FIELD_BP2 | BP_FIELD_PULSE);
+  CHECK_STR(reading.idcard, "1103700012345");
+  CHECK_EQ(reading.bp, 127);
+  CHECK_EQ(reading.bp2, 82);
+  CHECK_EQ(reading.pulse, 74);
+}
+
+static void testNumericIdcard() {
+  BPReading reading;
+  CHECK(!extract("{\"idcard\":1103700012345,\"blood_pressure_h\":120}", reading));
+  CHECK_EQ(reading.fields, BP_FIELD_IDCARD | BP_FIELD_BP);
+  CHECK_STR(reading.idcard, "1103700012345");
+
+  CHECK(!extract("{\"idcard\":0}", reading));
+  CHECK_EQ(reading.fields, BP_FIELD_IDCARD);
+  CHECK_STR(reading.idcard, "0");
+
+  // ไม่ใช่ข้อความ/จำนวนเต็ม → ไม่มี idcard (ไม่ใส่ค่าว่าง)
+  CHECK(!extract("{\"idcard\":null,\"heart_rate\":70}", reading));
+  CHECK_EQ(reading.fields, BP_FIELD_PULSE);
+  CHECK_STR(reading.idcard, "");
+  CHECK(!extract("{\"idcard\":true}", reading));
+  CHECK_EQ(reading.fields, 0);
+}
+
+static void testMissingFields() {
+  BPReading reading;
+  CHECK(!extract("{\"blood_pressure_h\":135,\"blood_pressure_l\":88}", reading));
+  CHECK_EQ(reading.fields, BP_FIELD_BP | BP_FIELD_BP2);
+  CHECK_EQ(reading.bp, 135);
+  CHECK_EQ(reading.pulse, 0);
+
+  CHECK(!extract("{\"error_code\":3}", reading));
+  CHECK_EQ(reading.fields, 0);
+
+  // idcard ยาวเกิน buffer → ตัดท้าย ไม่ล้น
+  CHECK(!extract("{\"idcard\":\"12345678901234567890123456789\"}", reading));
+  CHECK_EQ(strlen(reading.idcard), sizeof(reading.idcard) - 1);
+}
+
+static void testInvalidJson() {
+  BPReading reading;
+  CHECK(extract("{\"idcard\":\"1103700012345\",\"blood_pressure_h\":", reading));
+  CHECK(extract("", reading));
+  CHECK(extract("not json", reading));
+}
+
+int main() {
+  BP_beginFilter();
+  testFullFrame();
+  testNumericIdcard();
+  testMissingFields();
+  testInvalidJson();
+  return HostCheck_finish("bp_parser");
+}
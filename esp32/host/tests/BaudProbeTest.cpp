@@ -0,0 +1,198 @@
+/**
+ * BaudProbeTest.cpp - autobaud (ESP32_RS232/BaudProbe.h)
+ *
+ * ป้อน counter สะสมแบบเดียวกับ RS232Reader แล้วเรียก BaudProbe_update() พร้อมเวลา
+ * - rate ที่บันทึกไว้ → lock ทันที / สายเงียบไม่ทำให้เปลี่ยน rate
+ * - ขยะหรือ parse ไม่ได้ → ลอง rate ถัดไป / parse ได้ → LOCKED
+ * - ครบทุก rate ไม่มีเฟรมที่ parse ได้ → lock rate ที่ดูเป็น Text ที่สุดชั่วคราว (ไม่ confirmed)
+ * - lock แล้ว parse ไม่ได้ติดกัน / ขยะ / ไม่มีเฟรมนานเกิน → หาใหม่
+ */
+
+#include "HostCheck.h"
+#include "BaudProbe.h"
+
+#include <string.h>
+
+static void feed(BaudProbeCounters& c, uint32_t bytes, uint32_t printable) {
+  c.bytes += bytes;
+  c.printable += printable;
+}
+
+static BaudProbeCounters zeroCounters() {
+  BaudProbeCounters c;
+  memset(&c, 0, sizeof(c));
+  return c;
+}
+
+// ===== rate ที่บันทึกไว้ / เริ่มหา =====
+static void testBegin() {
+  BaudProbeCounters c = zeroCounters();
+  BaudProbe p;
+
+  BaudProbe_begin(p, 9600, 115200, c, 1000);
+  CHECK(p.locked);
+  CHECK(p.confirmed);
+  CHECK_EQ(BaudProbe_rate(p), 9600);
+  CHECK_EQ(BaudProbe_update(p, c, 5000), BAUD_PROBE_NONE);
+
+  // ไม่มี rate ที่บันทึก → เริ่มจาก baud ของโปรโตคอล / baud ที่ไม่ใช่มาตรฐาน → rate แรก
+  BaudProbe_begin(p, 0, 115200, c, 1000);
+  CHECK(!p.locked);
+  CHECK_EQ(BaudProbe_rate(p), 115200);
+  BaudProbe_begin(p, 0, 12345, c, 1000);
+  CHECK_EQ(BaudProbe_rate(p), AUTOBAUD_RATES[0]);
+
+  // สายเงียบนานแค่ไหนก็ไม่เปลี่ยน rate (เครื่องส่งแค่ตอนวัด)
+  BaudProbe_begin(p, 0, 9600, c, 1000);
+  CHECK_EQ(BaudProbe_update(p, c, 1000 + 10 * AUTOBAUD_TEXT_WINDOW_MS), BAUD_PROBE_NONE);
+  CHECK_EQ(BaudProbe_rate(p), 9600);
+
+  // ตั้งเอง
+  BaudProbe_force(p, 57600, c, 2000);
+  CHECK(p.locked);
+  CHECK_EQ(BaudProbe_rate(p), 57600);
+  BaudProbe_force(p, 1234, c, 2000);
+  CHECK_EQ(BaudProbe_rate(p), 57600);
+}
+
+// ===== ขยะ / parse ไม่ได้ → rate ถัดไป แล้ว lock เมื่อ parse ได้ =====
+static void testSwitchThenLock() {
+  BaudProbeCounters c = zeroCounters();
+  BaudProbe p;
+  BaudProbe_begin(p, 0, 4800, c, 1000);
+
+  // ได้ byte ยังไม่ถึง AUTOBAUD_WINDOW_MIN_BYTES → ยังไม่ตัดสิน
+  feed(c, AUTOBAUD_WINDOW_MIN_BYTES - 1, 0);
+  CHECK_EQ(BaudProbe_update(p, c, 1100), BAUD_PROBE_NONE);
+  feed(c, 1, 0);
+  CHECK_EQ(BaudProbe_update(p, c, 1200), BAUD_PROBE_SWITCH);
+  CHECK_EQ(BaudProbe_rate(p), 9600);
+
+  // ดูเป็น Text แต่ parse ไม่ได้ 2 เฟรม
+  feed(c, 100, 100);
+  c.frames += 2;
+  c.rejects += 1;
+  CHECK_EQ(BaudProbe_update(p, c, 1300), BAUD_PROBE_NONE);
+  c.rejects += 1;
+  CHECK_EQ(BaudProbe_update(p, c, 1400), BAUD_PROBE_SWITCH);
+  CHECK_EQ(BaudProbe_rate(p), 19200);
+
+  feed(c, 60, 60);
+  c.frames++;
+  c.valid++;
+  CHECK_EQ(BaudProbe_update(p, c, 1900), BAUD_PROBE_LOCKED);
+  CHECK(p.locked);
+  CHECK(p.confirmed);
+  CHECK_EQ(BaudProbe_rate(p), 19200);
+  CHECK_EQ(p.lastLockTime, 900);
+  CHECK_EQ(p.switchCount, 2);
+
+  // เฟรมถัดไปที่ parse ได้ไม่รายงาน LOCKED ซ้ำ
+  c.valid++;
+  CHECK_EQ(BaudProbe_update(p, c, 2500), BAUD_PROBE_NONE);
+}
+
+// ===== Text ที่ยังไม่ครบเฟรม → รอได้ถึง AUTOBAUD_TEXT_WINDOW_MS =====
+static void testTextWindow() {
+  BaudProbeCounters c = zeroCounters();
+  BaudProbe p;
+  BaudProbe_begin(p, 0, 9600, c, 1000);
+
+  feed(c, 20, 20);
+  CHECK_EQ(BaudProbe_update(p, c, 2000), BAUD_PROBE_NONE);          // window เริ่มที่ byte แรก
+  CHECK_EQ(BaudProbe_update(p, c, 2000 + AUTOBAUD_WINDOW_MS), BAUD_PROBE_NONE);
+  CHECK_EQ(BaudProbe_update(p, c, 2000 + AUTOBAUD_TEXT_WINDOW_MS), BAUD_PROBE_SWITCH);
+  CHECK_EQ(p.bestScore, 100);
+  CHECK_EQ(AUTOBAUD_RATES[p.bestIndex], 9600);
+
+  // Text ยาวเกิน AUTOBAUD_WINDOW_MAX_BYTES โดยไม่ครบเฟรม → ไม่ต้องรอเวลา
+  feed(c, AUTOBAUD_WINDOW_MAX_BYTES, AUTOBAUD_WINDOW_MAX_BYTES);
+  CHECK_EQ(BaudProbe_update(p, c, 20000), BAUD_PROBE_SWITCH);
+}
+
+// ===== ครบทุก rate ไม่มีเฟรมที่ parse ได้ =====
+static void testSweepFallback() {
+  BaudProbeCounters c = zeroCounters();
+  BaudProbe p;
+  BaudProbe_begin(p, 0, 1200, c, 0);
+
+  uint32_t now = 100;
+  for (size_t i = 0; i < AUTOBAUD_RATE_COUNT; i++) {
+    CHECK(!p.locked);
+    if (BaudProbe_rate(p) == 38400) {
+      feed(c, 40, 40);
+      c.frames++;               // Framer ได้เฟรม แต่ parse ไม่ได้ (โปรโตคอลผิด?)
+      BaudProbe_update(p, c, now);
+      now += AUTOBAUD_TEXT_WINDOW_MS;
+    } else {
+      feed(c, 64, 8);
+    }
+    CHECK_EQ(BaudProbe_update(p, c, now), BAUD_PROBE_SWITCH);
+    now += 100;
+  }
+  CHECK(p.locked);
+  CHECK(!p.confirmed);
+  CHECK_EQ(BaudProbe_rate(p), 38400);
+
+  // ภายหลัง parse ได้ → LOCKED (บันทึก)
+  c.valid++;
+  CHECK_EQ(BaudProbe_update(p, c, now), BAUD_PROBE_LOCKED);
+  CHECK(p.confirmed);
+
+  // ทุก rate เป็นขยะ → เริ่มรอบใหม่ ไม่ lock
+  BaudProbe_begin(p, 0, 1200, c, now);
+  for (size_t i = 0; i < AUTOBAUD_RATE_COUNT; i++) {
+    feed(c, 64, 0);
+    CHECK_EQ(BaudProbe_update(p, c, now), BAUD_PROBE_SWITCH);
+  }
+  CHECK(!p.locked);
+  CHECK_EQ(p.tried, 0);
+  CHECK_EQ(BaudProbe_rate(p), 1200);
+}
+
+// ===== lock แล้วเครื่องเปลี่ยน rate → หาใหม่ =====
+static void testReprobe() {
+  BaudProbeCounters c = zeroCounters();
+  BaudProbe p;
+
+  // parse ไม่ได้ติดกัน
+  BaudProbe_begin(p, 9600, 9600, c, 0);
+  c.rejects += AUTOBAUD_REPROBE_REJECTS - 1;
+  CHECK_EQ(BaudProbe_update(p, c, 100), BAUD_PROBE_NONE);
+  c.valid++;                               // parse ได้ → นับใหม่
+  c.rejects += AUTOBAUD_REPROBE_REJECTS - 1;
+  CHECK_EQ(BaudProbe_update(p, c, 200), BAUD_PROBE_NONE);
+  c.rejects++;
+  CHECK_EQ(BaudProbe_update(p, c, 300), BAUD_PROBE_NONE);
+  c.rejects++;
+  CHECK_EQ(BaudProbe_update(p, c, 400), BAUD_PROBE_NONE);
+  CHECK(p.locked);
+  c.rejects++;
+  CHECK_EQ(BaudProbe_update(p, c, 500), BAUD_PROBE_SWITCH);
+  CHECK(!p.locked);
+  CHECK_EQ(BaudProbe_rate(p), 19200);
+  CHECK_EQ(p.reprobeCount, 1);
+
+  // ขยะหลังได้ byte พอ
+  BaudProbe_begin(p, 9600, 9600, c, 0);
+  feed(c, AUTOBAUD_REPROBE_MIN_BYTES - 1, 0);
+  CHECK_EQ(BaudProbe_update(p, c, 100), BAUD_PROBE_NONE);
+  feed(c, 1, 0);
+  CHECK_EQ(BaudProbe_update(p, c, 200), BAUD_PROBE_SWITCH);
+
+  // Text แต่ไม่มีเฟรมที่ parse ได้เลย
+  BaudProbe_begin(p, 9600, 9600, c, 0);
+  feed(c, AUTOBAUD_REPROBE_BYTES - 1, AUTOBAUD_REPROBE_BYTES - 1);
+  CHECK_EQ(BaudProbe_update(p, c, 100), BAUD_PROBE_NONE);
+  feed(c, 1, 1);
+  CHECK_EQ(BaudProbe_update(p, c, 200), BAUD_PROBE_SWITCH);
+}
+
+int main() {
+  testBegin();
+  testSwitchThenLock();
+  testTextWindow();
+  testSweepFallback();
+  testReprobe();
+  return HostCheck_finish("baud probe");
+}
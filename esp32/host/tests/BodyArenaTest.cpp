@@ -0,0 +1,151 @@
+/**
+ * BodyArenaTest.cpp - buffer คงที่ของ HTTP body (center/BodyArena.h)
+ *
+ * - claim/write หลาย chunk/complete → body null-terminated, release แล้ว slot ว่างอีก
+ * - slot เต็ม → nullptr + bodyArenaBusyCount (handler ตอบ 503), ใหญ่เกิน slot → nullptr
+ * - request หลุด (ไม่ release) → slot ถูกนำกลับมาใช้หลัง BODY_ARENA_TIMEOUT_MS (รวมเมื่อ millis() วนรอบ)
+ * - pointer ของ request ซ้ำกับตัวที่หลุดไป → ทิ้ง slot เก่า ไม่ได้ 2 slot
+ * - chunk ข้าม/ซ้อน/เกิน Content-Length → ทิ้ง (body ไม่ครบ)
+ */
+
+#define BODY_ARENA_SLOTS 3
+#define BODY_ARENA_SLOT_SIZE 64
+
+#include "HostCheck.h"
+#include "BodyArena.h"
+
+static int requests[8];   // pointer ของ request ปลอม
+
+static void resetArena() {
+  memset(bodySlots, 0, sizeof(bodySlots));
+  bodyArenaBusyCount = 0;
+  bodyArenaExpiredCount = 0;
+  bodyArenaHighWater = 0;
+}
+
+static void writeText(BodySlot& slot, const char* text, size_t index) {
+  BodyArena_write(slot, (const uint8_t*)text, strlen(text), index);
+}
+
+// ===== claim → หลาย chunk → release =====
+static void testClaimWriteRelease() {
+  resetArena();
+  BodySlot* slot = BodyArena_claim(&requests[0], 11, 1000);
+  CHECK(slot != nullptr);
+  CHECK(BodyArena_find(&requests[0]) == slot);
+  CHECK(!BodyArena_complete(*slot));
+
+  writeText(*slot, "hello", 0);
+  CHECK(!BodyArena_complete(*slot));
+  writeText(*slot, " world", 5);
+  CHECK(BodyArena_complete(*slot));
+  CHECK_STR(slot->data, "hello world");
+
+  BodyArena_release(&requests[0]);
+  CHECK(BodyArena_find(&requests[0]) == nullptr);
+  CHECK_EQ(bodyArenaHighWater, 1);
+
+  // เต็ม slot พอดีได้ / เกิน 1 byte ไม่ได้ (ไม่นับเป็น busy)
+  slot = BodyArena_claim(&requests[1], BODY_ARENA_SLOT_SIZE, 1000);
+  CHECK(slot != nullptr);
+  char full[BODY_ARENA_SLOT_SIZE + 1];
+  memset(full, 'a', BODY_ARENA_SLOT_SIZE);
+  full[BODY_ARENA_SLOT_SIZE] = '\0';
+  writeText(*slot, full, 0);
+  CHECK(BodyArena_complete(*slot));
+  CHECK_EQ(strlen(slot->data), BODY_ARENA_SLOT_SIZE);
+  CHECK(BodyArena_claim(&requests[2], BODY_ARENA_SLOT_SIZE + 1, 1000) == nullptr);
+  CHECK_EQ(bodyArenaBusyCount, 0);
+
+  // body ว่าง (Content-Length: 0) ครบทันที
+  slot = BodyArena_claim(&requests[3], 0, 1000);
+  CHECK(slot != nullptr && BodyArena_complete(*slot));
+}
+
+// ===== slot เต็ม → busy / คืนแล้วได้ =====
+static void testBusy() {
+  resetArena();
+  for (int i = 0; i < BODY_ARENA_SLOTS; i++) {
+    CHECK(BodyArena_claim(&requests[i], 10, 1000 + i) != nullptr);
+  }
+  CHECK_EQ(bodyArenaHighWater, BODY_ARENA_SLOTS);
+  CHECK(BodyArena_claim(&requests[BODY_ARENA_SLOTS], 10, 2000) == nullptr);
+  CHECK_EQ(bodyArenaBusyCount, 1);
+
+  BodyArena_release(&requests[1]);
+  BodySlot* slot = BodyArena_claim(&requests[BODY_ARENA_SLOTS], 10, 2000);
+  CHECK(slot == &bodySlots[1]);
+  CHECK_EQ(bodyArenaExpiredCount, 0);
+  CHECK_EQ(bodyArenaHighWater, BODY_ARENA_SLOTS);
+}
+
+// ===== request หลุด → นำ slot กลับมาใช้หลัง timeout =====
+static void testTimeoutReclaim() {
+  resetArena();
+  const uint32_t start = 0xFFFFF000u;   // millis() วนรอบ uint32 ระหว่างรอ
+  for (int i = 0; i < BODY_ARENA_SLOTS; i++) {
+    BodySlot* slot = BodyArena_claim(&requests[i], 10, start + i * 100);
+    CHECK(slot != nullptr);
+    writeText(*slot, "half", 0);   // ไม่ครบ ไม่ release (client หลุดกลางทาง)
+  }
+
+  CHECK(BodyArena_claim(&requests[5], 10, start + BODY_ARENA_TIMEOUT_MS - 1) == nullptr);
+  CHECK_EQ(bodyArenaBusyCount, 1);
+  CHECK_EQ(bodyArenaExpiredCount, 0);
+
+  // slot แรกครบ timeout (ข้าม 2^32 แล้ว) → ได้ slot นั้น ข้อมูลเก่าไม่ติดมา
+  BodySlot* slot = BodyArena_claim(&requests[5], 10, start + BODY_ARENA_TIMEOUT_MS);
+  CHECK(slot == &bodySlots[0]);
+  CHECK_EQ(bodyArenaExpiredCount, 1);
+  CHECK(BodyArena_find(&requests[0]) == nullptr);
+  CHECK_EQ(slot->received, 0);
+  CHECK_STR(slot->data, "");
+  CHECK_EQ(bodyArenaHighWater, BODY_ARENA_SLOTS);
+
+  // slot ที่ 2 ยังไม่ครบ timeout → ยัง busy
+  CHECK(BodyArena_claim(&requests[6], 10, start + BODY_ARENA_TIMEOUT_MS + 50) == nullptr);
+  CHECK_EQ(bodyArenaBusyCount, 2);
+}
+
+// ===== pointer ซ้ำกับ request ที่หลุด → ไม่ค้าง 2 slot =====
+static void testReusedOwner() {
+  resetArena();
+  BodySlot* first = BodyArena_claim(&requests[0], 10, 1000);
+  writeText(*first, "abc", 0);
+  BodySlot* second = BodyArena_claim(&requests[0], 5, 1200);
+  CHECK(second != nullptr);
+  CHECK_EQ(second->total, 5);
+  CHECK_EQ(second->received, 0);
+
+  int owned = 0;
+  for (int i = 0; i < BODY_ARENA_SLOTS; i++) {
+    owned += bodySlots[i].owner == &requests[0] ? 1 : 0;
+  }
+  CHECK_EQ(owned, 1);
+}
+
+// ===== chunk ผิดลำดับ / เกิน Content-Length =====
+static void testBadChunks() {
+  resetArena();
+  BodySlot* slot = BodyArena_claim(&requests[0], 8, 1000);
+  writeText(*slot, "abcd", 0);
+  writeText(*slot, "zz", 6);         // ข้าม index 4-5
+  CHECK_EQ(slot->received, 4);
+  writeText(*slot, "abcd", 0);       // ซ้ำ chunk แรก
+  CHECK_EQ(slot->received, 4);
+  writeText(*slot, "efghi", 4);      // เกิน Content-Length
+  CHECK_EQ(slot->received, 4);
+  CHECK(!BodyArena_complete(*slot));
+  writeText(*slot, "efgh", 4);
+  CHECK(BodyArena_complete(*slot));
+  CHECK_STR(slot->data, "abcdefgh");
+}
+
+int main() {
+  testClaimWriteRelease();
+  testBusy();
+  testTimeoutReclaim();
+  testReusedOwner();
+  testBadChunks();
+  return HostCheck_finish("body_arena");
+}
@@ -0,0 +1,419 @@
+/**
+ * CenterSketchTest.cpp - center.ino ทั้งไฟล์ (ไม่แก้) บน PC ผ่าน shim ของ WiFi/AsyncWebServer/WiFiUDP
+ *
+ * request สร้างเองแล้วส่งให้ server.serve() (body มาทีละ chunk ผ่าน handleBody → BodyArena)
+ * - POST /api/vitals: 200 เข้าคิว → loop() ส่งออก Serial + ลงรายชื่อ / JSON เสีย 400 / ใหญ่เกิน 413
+ * - ไม่มี deviceId/deviceType หรือ data ไม่ใช่ object: /api/vitals 400, element ของ batch ได้ 0 (เกณฑ์เดียวกัน)
+ * - POST /api/vitals/batch: results ต่อ element, element เสีย / ไม่มี ',' / body ถูกตัด / เกิน BATCH_MAX_ITEMS /
+ *   คิวเต็มกลาง array → partial ที่ results มีเฉพาะ element ก่อนหน้า
+ * - UDP (handleWireUdp): HELLO → READING ได้ ACK OK / session ไม่รู้จัก / frame เสีย / ส่งซ้ำไม่ส่งต่อ
+ * - อุปกรณ์หลุดจาก AP → ออฟไลน์ทันที / ต่อใหม่ → ออนไลน์เฉพาะที่รู้จัก / heartbeat ทาง UDP → ออนไลน์ ไม่ตอบ
+ *   (MAC ไม่รู้จัก → ACK UNKNOWN_DEVICE) / heartbeat หยุด → ออฟไลน์ตาม DEVICE_TIMEOUT
+ * - /ws: reading จาก HTTP และ UDP ถึง client (ส่งซ้ำไม่ส่งต่อ), คิว client เต็ม → รอ, เกิน STREAM_MAX_CLIENTS → ตัด
+ * - GET /api/devices มี reading ที่รับแล้ว / response ที่ยังส่งไม่หมด → request ซ้อนได้ 503 ไม่เขียนทับ buffer
+ */
+
+#include "HostCheck.h"
+#include "center.ino"
+
+#include <string>
+#include <vector>
+
+struct HostResponse {
+  int code;
+  std::string body;
+};
+
+static HostResponse serve(WebRequestMethodComposite method, const char* url, const std::string& body,
+                          size_t chunkSize = 1460) {
+  AsyncWebServerRequest request(method, url);
+  server.serve(request, body.data(), body.size(), chunkSize);
+  CHECK_EQ(request.responseCount, 1);
+  HostResponse response = { request.responseCode, request.responseBody };
+  return response;
+}
+
+static std::string vitalsJson(const char* mac, uint32_t seq) {
+  char json[320];
+  snprintf(json, sizeof(json),
+           "{\"deviceId\":\"%s\",\"deviceName\":\"BP-%s\",\"macAddress\":\"%s\","
+           "\"deviceType\":\"blood_pressure\",\"idcard\":\"1234567890123\","
+           "\"data\":{\"bp\":120,\"bp2\":80,\"pulse\":70,\"timestamp\":1000},\"seq\":%lu,\"epoch\":7}",
+           mac, mac + 15, mac, (unsigned long)seq);
+  return json;
+}
+
+// ACK ล่าสุดที่ Center ส่งกลับทาง UDP (ล้างรายการที่ส่งแล้ว)
+static bool takeAck(WireHeader& header) {
+  if (wireUdp.sent.empty()) {
+    return false;
+  }
+  HostDatagram datagram = wireUdp.sent.back();
+  wireUdp.sent.clear();
+  return Wire_parseFrame((const uint8_t*)datagram.data.data(), datagram.data.size(), header) == 0 &&
+         header.type == WIRE_MSG_ACK;
+}
+
+static void injectUdp(const uint8_t* frame, size_t length) {
+  wireUdp.inject(frame, length, IPAddress(10, 1, 10, 5), 40000);
+  handleWireUdp();
+}
+
+static void testSetup() {
+  setup();
+  CHECK(server.started);
+  CHECK_EQ(wireUdp.localPort, WIRE_UDP_PORT);
+  CHECK_EQ(Registry_getCount(), 0);
+}
+
+static void testAcceptVitals() {
+  unsigned long framesBefore = serialLinkFramesSent;
+
+  // body มาเป็น chunk เล็ก (TCP segment) → ต่อใน BodyArena ก่อนเรียก handler
+  HostResponse response = serve(HTTP_POST, "/api/vitals", vitalsJson("AA:BB:CC:00:00:01", 1), 16);
+  CHECK_EQ(response.code, 200);
+  CHECK_EQ(Inbox_size(), 1);
+
+  loop();
+  CHECK_EQ(Inbox_size(), 0);
+  CHECK_EQ(Registry_getCount(), 1);
+  CHECK_EQ(serialLinkFramesSent, framesBefore + 1);
+
+  response = serve(HTTP_POST, "/api/vitals", "{\"deviceId\":\"AA:BB");
+  CHECK_EQ(response.code, 400);
+  CHECK_EQ(Inbox_size(), 0);
+
+  response = serve(HTTP_POST, "/api/vitals", std::string(MAX_BODY_SIZE + 1, ' '));
+  CHECK_EQ(response.code, 413);
+
+  response = serve(HTTP_POST, "/api/vitals", "");
+  CHECK_EQ(response.code, 400);
+}
+
+// /api/vitals กับ element ของ /api/vitals/batch ใช้เกณฑ์เดียวกัน (isValidVitals)
+static void testVitalsValidation() {
+  const char* invalid[] = {
+    "{\"deviceType\":\"temp\",\"data\":{\"value\":36.5}}",                            // ไม่มี deviceId
+    "{\"deviceId\":\"\",\"deviceType\":\"temp\",\"data\":{\"value\":36.5}}",             // deviceId ว่าง
+    "{\"deviceId\":\"AA:BB:CC:00:00:04\",\"data\":{\"value\":36.5}}",                    // ไม่มี deviceType
+    "{\"deviceId\":\"AA:BB:CC:00:00:04\",\"deviceType\":\"temp\"}",                      // ไม่มี data
+    "{\"deviceId\":\"AA:BB:CC:00:00:04\",\"deviceType\":\"temp\",\"data\":36.5}",          // data ไม่ใช่ object
+    "[]",
+  };
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+    HostResponse response = serve(HTTP_POST, "/api/vitals", invalid[i]);
+    CHECK_EQ(response.code, 400);
+    CHECK_EQ(Inbox_size(), 0);
+    if (invalid[i][0] == '{') {
+      response = serve(HTTP_POST, "/api/vitals/batch", std::string("[") + invalid[i] + "]");
+      CHECK_EQ(response.code, 200);
+      CHECK(response.body.find("\"accepted\":0,\"rejected\":1,\"results\":[0]") != std::string::npos);
+      CHECK_EQ(Inbox_size(), 0);
+    }
+  }
+
+  const char* minimal = "{\"deviceId\":\"AA:BB:CC:00:00:04\",\"deviceType\":\"temp\",\"data\":{}}";
+  CHECK_EQ(serve(HTTP_POST, "/api/vitals", minimal).code, 200);
+  HostResponse response = serve(HTTP_POST, "/api/vitals/batch", std::string("[") + minimal + "]");
+  CHECK(response.body.find("\"results\":[1]") != std::string::npos);
+  CHECK_EQ(Inbox_size(), 2);
+  loop();
+  loop();
+  CHECK_EQ(Inbox_size(), 0);
+}
+
+static void testAcceptVitalsBatch() {
+  std::string body = "[" + vitalsJson("AA:BB:CC:00:00:02", 1) +
+                     ",{\"deviceId\":\"AA:BB:CC:00:00:03\"}," +
+                     vitalsJson("AA:BB:CC:00:00:02", 2) + "]";
+  HostResponse response = serve(HTTP_POST, "/api/vitals/batch", body, 64);
+  CHECK_EQ(response.code, 200);
+  CHECK(response.body.find("\"status\":\"ok\"") != std::string::npos);
+  CHECK(response.body.find("\"results\":[1,0,1]") != std::string::npos);
+  CHECK_EQ(Inbox_size(), 2);
+  loop();
+  CHECK_EQ(Inbox_size(), 0);
+  CHECK_EQ(Registry_getCount(), 2);
+
+  // JSON เสียกลาง array → element ก่อนหน้ายังถูกรับ ที่เหลือให้ device ส่งใหม่
+  body = "[" + vitalsJson("AA:BB:CC:00:00:02", 3) + ",{\"deviceId\":" + "," + vitalsJson("AA:BB:CC:00:00:02", 4) + "]";
+  response = serve(HTTP_POST, "/api/vitals/batch", body);
+  CHECK_EQ(response.code, 200);
+  CHECK(response.body.find("\"status\":\"partial\"") != std::string::npos);
+  CHECK(response.body.find("\"results\":[1]") != std::string::npos);
+  CHECK_EQ(Inbox_size(), 1);
+  loop();
+
+  response = serve(HTTP_POST, "/api/vitals/batch", vitalsJson("AA:BB:CC:00:00:02", 5));
+  CHECK_EQ(response.code, 400);
+  CHECK_EQ(Inbox_size(), 0);
+}
+
+// BodyStream อ่านทีละ element: หยุดตรงไหน results ก็มีเฉพาะ element ก่อนหน้า (ที่เหลือ device ส่งใหม่)
+static void testBatchStopsMidArray() {
+  std::string a = vitalsJson("AA:BB:CC:00:00:02", 10);
+  std::string b = vitalsJson("AA:BB:CC:00:00:02", 11);
+
+  // whitespace / บรรทัดใหม่ระหว่าง element ได้
+  HostResponse response = serve(HTTP_POST, "/api/vitals/batch", " [\n " + a + " ,\n\t" + b + " ]\n", 7);
+  CHECK_EQ(response.code, 200);
+  CHECK(response.body.find("\"status\":\"ok\",\"accepted\":2,\"rejected\":0,\"results\":[1,1]") != std::string::npos);
+  CHECK_EQ(Inbox_size(), 2);
+  loop();
+
+  // ไม่มี ',' ระหว่าง element
+  response = serve(HTTP_POST, "/api/vitals/batch", "[" + a + " " + b + "]");
+  CHECK_EQ(response.code, 200);
+  CHECK(response.body.find("\"results\":[1],\"error\":\"Expected ',' or ']'\"") != std::string::npos);
+  CHECK_EQ(Inbox_size(), 1);
+  loop();
+
+  // array ไม่ปิด (body ถูกตัด) → element ที่ครบแล้วยังรับ
+  response = serve(HTTP_POST, "/api/vitals/batch", "[" + a + "," + b.substr(0, b.size() / 2));
+  CHECK_EQ(response.code, 200);
+  CHECK(response.body.find("\"status\":\"partial\"") != std::string::npos);
+  CHECK(response.body.find("\"results\":[1]") != std::string::npos);
+  loop();
+
+  // เกิน BATCH_MAX_ITEMS → หยุดที่ BATCH_MAX_ITEMS
+  std::string many = "[";
+  std::string expected;
+  for (int i = 0; i <= BATCH_MAX_ITEMS; i++) {
+    many += i == 0 ? "{}" : ",{}";
+    if (i < BATCH_MAX_ITEMS) {
+      expected += i == 0 ? "0" : ",0";
+    }
+  }
+  response = serve(HTTP_POST, "/api/vitals/batch", many + "]");
+  CHECK_EQ(response.code, 200);
+  CHECK(response.body.find("\"rejected\":" + std::to_string(BATCH_MAX_ITEMS) + ",\"results\":[" + expected +
+                           "],\"error\":\"Too many items\"") != std::string::npos);
+  CHECK_EQ(Inbox_size(), 0);
+
+  // คิวเหลือ 1 ช่อง → element แรกเข้า ที่เหลือไม่อยู่ใน results / คิวเต็มตั้งแต่ element แรก → 503
+  while (Inbox_size() < INBOX_CAPACITY - 1) {
+    CHECK(Inbox_push(INBOX_VITALS, 0, a.data(), a.size()));
+  }
+  response = serve(HTTP_POST, "/api/vitals/batch", "[" + a + "," + b + "]");
+  CHECK_EQ(response.code, 200);
+  CHECK(response.body.find("\"results\":[1],\"error\":\"Center busy\"") != std::string::npos);
+  response = serve(HTTP_POST, "/api/vitals/batch", "[" + b + "]");
+  CHECK_EQ(response.code, 503);
+  while (Inbox_size() > 0) {
+    loop();
+  }
+}
+
+static void testWireUdp() {
+  uint8_t frame[WIRE_MAX_FRAME];
+  WireHeader ack;
+  unsigned long readingsBefore = wireReadingCount;
+
+  WireHello hello = { { 0xAA, 0xBB, 0xCC, 0x00, 0x00, 0x10 }, "Scale-10", 42 };
+  injectUdp(frame, Wire_encodeHello(frame, 0x1234, hello));
+  CHECK(takeAck(ack));
+  CHECK_EQ(ack.status, WIRE_ACK_OK);
+
+  WireReading reading = { WIRE_KIND_WEIGHT_HEIGHT, WIRE_FIELD_VALUE0 | WIRE_FIELD_VALUE1, 0, { 703, 1735, 0, 0 }, 5000 };
+  uint8_t packed[WIRE_READING_SIZE];
+  Wire_packReading(packed, reading);
+  size_t length = Wire_encodeReading(frame, 0x1234, 1, packed, WIRE_READING_DURABLE_SEQ);
+  injectUdp(frame, length);
+  CHECK(takeAck(ack));
+  CHECK_EQ(ack.status, WIRE_ACK_OK);
+  CHECK_EQ(ack.seq, 1);
+  CHECK_EQ(wireReadingCount, readingsBefore + 1);
+  CHECK(Registry_find("AA:BB:CC:00:00:10", "AA:BB:CC:00:00:10") != nullptr);
+
+  // ACK หาย → device ส่ง seq เดิมซ้ำ: ACK อีกครั้งแต่ไม่ส่งต่อ
+  injectUdp(frame, length);
+  CHECK(takeAck(ack));
+  CHECK_EQ(ack.status, WIRE_ACK_OK);
+  CHECK_EQ(wireReadingCount, readingsBefore + 1);
+
+  // CRC ไม่ตรง → นับ bad frame ไม่ตอบ
+  unsigned long badBefore = wireBadFrameCount;
+  frame[WIRE_HEADER_SIZE + 3] ^= 0x01;
+  injectUdp(frame, length);
+  CHECK_EQ(wireBadFrameCount, badBefore + 1);
+  CHECK(wireUdp.sent.empty());
+
+  // session ที่ไม่เคยส่ง HELLO → ขอ HELLO ใหม่
+  injectUdp(frame, Wire_encodeReading(frame, 0x9999, 2, packed));
+  CHECK(takeAck(ack));
+  CHECK_EQ(ack.status, WIRE_ACK_UNKNOWN_SESSION);
+  CHECK_EQ(wireReadingCount, readingsBefore + 1);
+}
+
+static void testDevicesSnapshot() {
+  HostResponse response = serve(HTTP_GET, "/api/devices", "");
+  CHECK_EQ(response.code, 200);
+  CHECK(response.body.find("AA:BB:CC:00:00:10") != std::string::npos);
+  CHECK(response.body.find("AA:BB:CC:00:00:02") != std::string::npos);
+
+  response = serve(HTTP_GET, "/api/nothing", "");
+  CHECK_EQ(response.code, 404);
+}
+
+// response ส่งจาก cacheJson โดยตรง: ระหว่างที่ client ยังรับไม่หมด request อื่นต้องไม่เขียนทับ
+static void testDevicesInFlight() {
+  AsyncWebServerRequest slow(HTTP_GET, "/api/devices");
+  slow.holdOpen = true;
+  server.serve(slow);
+  CHECK_EQ(slow.responseCode, 200);
+  CHECK(cacheJsonBusy);
+
+  AsyncWebServerRequest changes(HTTP_GET, "/api/changes");
+  changes.addParam("since", "1");
+  server.serve(changes);
+  CHECK_EQ(changes.responseCode, 503);
+
+  slow.disconnect();
+  CHECK(!cacheJsonBusy);
+  CHECK(slow.responseBody.find("AA:BB:CC:00:00:10") != std::string::npos);
+  CHECK(slow.responseBody.find("\"complete\":true}") != std::string::npos);
+
+  HostResponse response = serve(HTTP_GET, "/api/devices", "");
+  CHECK_EQ(response.code, 200);
+
+  // onDisconnect ไม่มา (ไม่ควรเกิด) → ปล่อย buffer หลัง CACHE_JSON_HOLD_MAX
+  AsyncWebServerRequest lost(HTTP_GET, "/api/devices");
+  lost.holdOpen = true;
+  server.serve(lost);
+  lost.onDisconnect(nullptr);
+  CHECK_EQ(serve(HTTP_GET, "/api/devices", "").code, 503);
+  Host_advanceMillis(CACHE_JSON_HOLD_MAX);
+  CHECK_EQ(serve(HTTP_GET, "/api/devices", "").code, 200);
+}
+
+// อุปกรณ์หลุดจาก AP → ออฟไลน์ทันทีใน loop() / heartbeat ทาง UDP → ออนไลน์อีกครั้งโดยไม่ตอบ
+static void testPresence() {
+  const uint8_t mac[6] = { 0xAA, 0xBB, 0xCC, 0x00, 0x00, 0x10 };
+  const uint8_t stranger[6] = { 0xAA, 0xBB, 0xCC, 0x00, 0x00, 0x99 };
+  const RegistryDevice* device = Registry_find("AA:BB:CC:00:00:10", "AA:BB:CC:00:00:10");
+  CHECK(device != nullptr);
+  loop();   // อุปกรณ์จาก test ก่อนหน้าที่เลย DEVICE_TIMEOUT แล้ว → ออฟไลน์ก่อนนับ
+  bool isNew;
+  Registry_update(device->deviceId, device->deviceName, device->macAddress, millis(), isNew);
+  CHECK(device->online);
+  int count = Registry_getCount();
+  int online = Registry_getOnlineCount();
+
+  // WiFi event task เข้าคิวเท่านั้น - รายชื่อเปลี่ยนใน loop()
+  WiFi.stationLeave(mac);
+  CHECK(device->online);
+  loop();
+  CHECK(!device->online);
+  CHECK_EQ(Registry_getOnlineCount(), online - 1);
+
+  uint8_t frame[WIRE_MAX_FRAME];
+  WireHeader ack;
+  unsigned long heartbeatsBefore = wireHeartbeatCount;
+  Host_advanceMillis(500);
+  injectUdp(frame, Wire_encodeHeartbeat(frame, 0x1234, mac));
+  CHECK_EQ(wireHeartbeatCount, heartbeatsBefore + 1);
+  CHECK(device->online);
+  CHECK_EQ(device->lastSeen, millis());
+  CHECK(wireUdp.sent.empty());   // อุปกรณ์ที่รู้จัก → ไม่ตอบ
+
+  // ต่อ AP ใหม่ = ออนไลน์เฉพาะอุปกรณ์ที่รู้จัก
+  WiFi.stationLeave(mac);
+  loop();
+  CHECK(!device->online);
+  WiFi.stationJoin(mac);
+  WiFi.stationJoin(stranger);
+  loop();
+  CHECK(device->online);
+  CHECK_EQ(Registry_getCount(), count);
+
+  // heartbeat จาก MAC ที่ไม่รู้จัก → ขอ /api/status ไม่เพิ่มในรายชื่อ
+  injectUdp(frame, Wire_encodeHeartbeat(frame, 0x4321, stranger));
+  CHECK(takeAck(ack));
+  CHECK_EQ(ack.status, WIRE_ACK_UNKNOWN_DEVICE);
+  CHECK_EQ(Registry_getCount(), count);
+
+  // ไฟดับ (ไม่มี event หลุด) → ออฟไลน์ตาม DEVICE_TIMEOUT เมื่อ heartbeat หยุด
+  unsigned long lastHeartbeat = millis();
+  while (millis() - lastHeartbeat <= DEVICE_TIMEOUT + 1000) {
+    loop();
+    Host_advanceMillis(100);
+  }
+  CHECK(!device->online);
+  injectUdp(frame, Wire_encodeHeartbeat(frame, 0x1234, mac));
+  CHECK(device->online);
+  CHECK(wireUdp.sent.empty());
+}
+
+// client ของ /ws ได้ทุก reading ที่ผ่านการกรองซ้ำ (HTTP และ UDP) เป็น JSON เดียวกับ Serial
+static void testReadingStream() {
+  AsyncWebSocketClient* pc = streamSocket.connect();
+  loop();
+  CHECK_EQ(ReadingStream_clientCount(), 1);
+  CHECK(pc->messages.empty());   // ต่อใหม่ → เริ่มที่ reading ถัดไป ไม่ได้ของเก่า
+
+  std::string body = vitalsJson("AA:BB:CC:00:00:01", 50);
+  CHECK_EQ(serve(HTTP_POST, "/api/vitals", body).code, 200);
+  loop();
+  CHECK_EQ(pc->messages.size(), 1);
+  CHECK(pc->messages[0] == body);
+
+  // ส่งซ้ำ (seq เดิม) → ไม่ส่งต่อ
+  CHECK_EQ(serve(HTTP_POST, "/api/vitals", body).code, 200);
+  loop();
+  CHECK_EQ(pc->messages.size(), 1);
+
+  // reading ทาง UDP → JSON แบบเดียวกับ /api/vitals
+  uint8_t frame[WIRE_MAX_FRAME];
+  WireReading reading = { WIRE_KIND_TEMP, WIRE_FIELD_VALUE0, 0, { 368, 0, 0, 0 }, 6000 };
+  uint8_t packed[WIRE_READING_SIZE];
+  Wire_packReading(packed, reading);
+  injectUdp(frame, Wire_encodeReading(frame, 0x1234, 60, packed, WIRE_READING_DURABLE_SEQ));
+  wireUdp.sent.clear();
+  loop();
+  CHECK_EQ(pc->messages.size(), 2);
+  CHECK(pc->messages.back().find("\"deviceId\":\"AA:BB:CC:00:00:10\"") != std::string::npos);
+  CHECK(pc->messages.back().find("\"deviceType\":\"temp\"") != std::string::npos);
+
+  // คิวของ client เต็มชั่วคราว → รอ ไม่ตัด แล้วได้ครบตามลำดับ
+  pc->stalled = true;
+  CHECK_EQ(serve(HTTP_POST, "/api/vitals", vitalsJson("AA:BB:CC:00:00:01", 51)).code, 200);
+  loop();
+  CHECK_EQ(pc->messages.size(), 2);
+  pc->stalled = false;
+  loop();
+  CHECK_EQ(pc->messages.size(), 3);
+  CHECK(pc->messages.back().find("\"seq\":51") != std::string::npos);
+
+  // เกิน STREAM_MAX_CLIENTS → ตัดตัวที่เกิน ตัวเดิมยังได้ต่อ
+  unsigned long closesBefore = streamSocket.closeCount;
+  std::vector<AsyncWebSocketClient*> others;
+  for (int i = 0; i < STREAM_MAX_CLIENTS; i++) {
+    others.push_back(streamSocket.connect());
+  }
+  loop();
+  CHECK_EQ(ReadingStream_clientCount(), STREAM_MAX_CLIENTS);
+  CHECK_EQ(streamSocket.closeCount, closesBefore + 1);
+  CHECK(others.back()->status() == WS_DISCONNECTED);
+
+  // หลุด → ออกจากตาราง
+  streamSocket.disconnect(pc);
+  for (size_t i = 0; i + 1 < others.size(); i++) {
+    streamSocket.disconnect(others[i]);
+  }
+  loop();
+  CHECK_EQ(ReadingStream_clientCount(), 0);
+}
+
+int main() {
+  testSetup();
+  testAcceptVitals();
+  testAcceptVitalsBatch();
+  testBatchStopsMidArray();
+  testVitalsValidation();
+  testWireUdp();
+  testDevicesSnapshot();
+  testDevicesInFlight();
+  testPresence();
+  testReadingStream();
+  return HostCheck_finish("center_sketch");
+}
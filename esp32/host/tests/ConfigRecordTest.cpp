@@ -0,0 +1,226 @@
+/**
+ * ConfigRecordTest.cpp - Config ใน EEPROM (ESP32_RS232/ConfigRecord.h + Config_begin() ของ Config.h)
+ *
+ * - CRC-32 ค่ามาตรฐาน, seal → valid / byte เพี้ยน, version หรือ length อื่น → ไม่ valid แต่ยังเป็น record
+ * - ConfigRecord_parseIp: ตัวเลขเกิน 255 / เกิน 3 หลัก / ส่วนไม่ครบ / เกิน / ขยะหน้า-หลัง
+ * - ConfigRecord_isLocalIp: subnet /24 เดียวกับ Center, ไม่ชน Center / .0 / .255
+ * - ConfigRecord_setText: ว่าง / ยาวเกิน buffer ไม่รับ
+ * มี ArduinoJson (Config.h ใช้ InstrumentProtocol.h) → ตรวจ Config_begin() กับ EEPROM จำลองด้วย:
+ * - EEPROM ว่าง → ค่า default ไม่เขียน / Config แบบเดิม (ชื่อ@0, protocol@32, baud@33) → ย้ายเข้า record ครั้งเดียว
+ * - record เสีย / version ใหม่กว่า → ค่า default (ไม่อ่านเป็นแบบเดิม) / baud ที่ไม่ใช่มาตรฐาน → หาใหม่
+ */
+
+#include "HostCheck.h"
+#include "ConfigRecord.h"
+
+#ifdef HOST_HAVE_ARDUINOJSON
+  #include <WiFi.h>
+  #include <EEPROM.h>
+  #define EEPROM_SIZE 512
+  #include "Config.h"
+#endif
+
+// ===== CRC / seal / valid =====
+static void testSealAndCrc() {
+  CHECK_EQ(ConfigRecord_crc32((const uint8_t*)"123456789", 9), 0xCBF43926u);
+  CHECK_EQ(ConfigRecord_crc32(nullptr, 0), 0);
+
+  ConfigData record;
+  memset(&record, 0, sizeof(record));
+  strlcpy(record.deviceName, "BP-Room3", sizeof(record.deviceName));
+  strlcpy(record.centerIp, "10.1.10.1", sizeof(record.centerIp));
+  CHECK(!ConfigRecord_isRecord(record));
+  CHECK(!ConfigRecord_isValid(record));
+
+  ConfigRecord_seal(record);
+  CHECK(ConfigRecord_isRecord(record));
+  CHECK(ConfigRecord_isValid(record));
+  CHECK_EQ(record.length, sizeof(ConfigData));
+
+  // ทุก byte ก่อน crc มีผล (เขียนไม่จบ / ไฟดับระหว่าง commit)
+  bool allDetected = true;
+  for (size_t i = 0; i < offsetof(ConfigData, crc); i++) {
+    ConfigData damaged = record;
+    ((uint8_t*)&damaged)[i] ^= 0x01;
+    allDetected = allDetected && !ConfigRecord_isValid(damaged);
+  }
+  CHECK(allDetected);
+
+  ConfigData damaged = record;
+  damaged.crc ^= 0x80000000u;
+  CHECK(!ConfigRecord_isValid(damaged));
+  CHECK(ConfigRecord_isRecord(damaged));
+
+  // version / length อื่น แม้ CRC ถูก → ไม่ valid
+  ConfigData other = record;
+  other.version = CONFIG_VERSION + 1;
+  other.crc = ConfigRecord_checksum(other);
+  CHECK(!ConfigRecord_isValid(other));
+  other = record;
+  other.length = sizeof(ConfigData) - 4;
+  other.crc = ConfigRecord_checksum(other);
+  CHECK(!ConfigRecord_isValid(other));
+
+  // magic: byte แรกใน EEPROM ไม่ใช่ตัวอักษรของชื่อแบบเดิม
+  CHECK_EQ(((const uint8_t*)&record)[0], 0xA5);
+
+  record.channel = 6;
+  record.bssid[0] = 0x24;
+  ConfigRecord_forgetAp(record);
+  CHECK_EQ(record.channel, 0);
+  CHECK_EQ(record.bssid[0], 0);
+}
+
+// ===== IP =====
+static void testParseIp() {
+  uint8_t ip[4];
+  CHECK(ConfigRecord_parseIp("10.1.10.201", ip));
+  CHECK(ip[0] == 10 && ip[1] == 1 && ip[2] == 10 && ip[3] == 201);
+  CHECK(ConfigRecord_parseIp("0.0.0.0", ip));
+  CHECK(ConfigRecord_parseIp("255.255.255.255", ip));
+  CHECK_EQ(ip[3], 255);
+  CHECK(ConfigRecord_parseIp("010.001.010.001", ip));
+  CHECK_EQ(ip[0], 10);
+
+  const char* invalid[] = {
+    "", "10.1.10", "10.1.10.1.5", "10.1.10.256", "300.1.1.1", "1000.1.1.1", "0010.1.1.1",
+    "10..10.1", "10.1.10.", ".10.1.10", " 10.1.10.1", "10.1.10.1 ", "10.1.10.1a", "10,1,10,1", "a.b.c.d",
+    "-1.1.1.1",
+  };
+  for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+    if (ConfigRecord_parseIp(invalid[i], ip)) {
+      CHECK_STR(invalid[i], "(ต้อง parse ไม่ได้)");
+    }
+  }
+}
+
+static void testIsLocalIp() {
+  CHECK(ConfigRecord_isLocalIp("10.1.10.201", "10.1.10.1"));
+  CHECK(ConfigRecord_isLocalIp("10.1.10.2", "10.1.10.1"));
+  CHECK(ConfigRecord_isLocalIp("10.1.10.254", "10.1.10.1"));
+  CHECK(!ConfigRecord_isLocalIp("10.1.10.1", "10.1.10.1"));     // ชน Center
+  CHECK(!ConfigRecord_isLocalIp("10.1.10.0", "10.1.10.1"));     // network
+  CHECK(!ConfigRecord_isLocalIp("10.1.10.255", "10.1.10.1"));   // broadcast
+  CHECK(!ConfigRecord_isLocalIp("10.1.11.201", "10.1.10.1"));   // คนละ subnet
+  CHECK(!ConfigRecord_isLocalIp("192.168.4.2", "10.1.10.1"));
+  CHECK(!ConfigRecord_isLocalIp("10.1.10.300", "10.1.10.1"));
+  CHECK(!ConfigRecord_isLocalIp("10.1.10.201", "10.1.10"));     // Center IP เสีย
+  CHECK(!ConfigRecord_isLocalIp("", "10.1.10.1"));
+}
+
+static void testSetText() {
+  char field[8] = "old";
+  CHECK(!ConfigRecord_setText(field, sizeof(field), ""));
+  CHECK_STR(field, "old");
+  CHECK(!ConfigRecord_setText(field, sizeof(field), "12345678"));
+  CHECK_STR(field, "old");
+  CHECK(ConfigRecord_setText(field, sizeof(field), "1234567"));
+  CHECK_STR(field, "1234567");
+}
+
+#ifdef HOST_HAVE_ARDUINOJSON
+// ===== Config_begin() กับ EEPROM จำลอง =====
+static void eraseEeprom() {
+  EEPROM.committed.assign(EEPROM_SIZE, 0xFF);
+  EEPROM.commitCount = 0;
+}
+
+static ConfigData committedRecord() {
+  ConfigData record;
+  memcpy(&record, &EEPROM.committed[CONFIG_ADDR], sizeof(record));
+  return record;
+}
+
+static void writeLegacy(const char* name, uint8_t protocol, uint32_t baud) {
+  eraseEeprom();
+  char padded[32];
+  memset(padded, 0, sizeof(padded));
+  strlcpy(padded, name, sizeof(padded));
+  memcpy(&EEPROM.committed[CONFIG_LEGACY_ADDR_NAME], padded, sizeof(padded));
+  EEPROM.committed[CONFIG_LEGACY_ADDR_PROTOCOL] = protocol;
+  memcpy(&EEPROM.committed[CONFIG_LEGACY_ADDR_BAUD], &baud, sizeof(baud));
+}
+
+static void testBeginBlank() {
+  eraseEeprom();
+  Config_begin();
+  CHECK_STR(config.deviceName, DEFAULT_DEVICE_NAME);
+  CHECK_EQ(config.protocol, DEFAULT_PROTOCOL);
+  CHECK_EQ(config.baud, 0);
+  CHECK_STR(config.centerIp, DEFAULT_CENTER_IP);
+  CHECK_EQ(config.channel, 0);
+  CHECK_EQ(EEPROM.commitCount, 0);   // ไม่เขียน flash จนกว่าจะเปลี่ยนค่า
+}
+
+static void testBeginMigratesLegacy() {
+  writeLegacy("BP-Room3", WeightTextProtocol::ID, 9600);
+  Config_begin();
+  CHECK_STR(config.deviceName, "BP-Room3");
+  CHECK_EQ(config.protocol, WeightTextProtocol::ID);
+  CHECK_EQ(config.baud, 9600);
+  CHECK_STR(config.ssid, DEFAULT_CENTER_SSID);       // field ใหม่ได้ค่า default
+  CHECK_STR(config.centerIp, DEFAULT_CENTER_IP);
+  CHECK_EQ(EEPROM.commitCount, 1);
+  CHECK(ConfigRecord_isValid(committedRecord()));
+
+  // เปิดเครื่องครั้งต่อไป: อ่าน record ไม่ย้ายซ้ำ
+  Config_begin();
+  CHECK_STR(config.deviceName, "BP-Room3");
+  CHECK_EQ(config.baud, 9600);
+  CHECK_EQ(EEPROM.commitCount, 1);
+
+  // แบบเดิมที่มีแค่ชื่อ (protocol ไม่รู้จัก) → ชื่อเดิม + protocol default
+  writeLegacy("Scale-2", 0xEE, 9600);
+  Config_begin();
+  CHECK_STR(config.deviceName, "Scale-2");
+  CHECK_EQ(config.protocol, DEFAULT_PROTOCOL);
+  CHECK_EQ(config.baud, 0);
+  CHECK_EQ(EEPROM.commitCount, 1);
+}
+
+static void testBeginCorruptRecord() {
+  writeLegacy("BP-Room3", WeightTextProtocol::ID, 9600);
+  Config_begin();
+  strlcpy(config.localIp, "10.1.10.201", sizeof(config.localIp));
+  Config_rememberAp((const uint8_t*)"\x24\x6F\x28\x00\x00\x01", 6);
+  Config_save();
+  CHECK(ConfigRecord_isValid(committedRecord()));
+
+  // ไฟดับระหว่างเขียน: byte กลาง record เพี้ยน → default (ไม่ใช้ค่าครึ่งๆ กลางๆ / ไม่อ่านเป็นแบบเดิม)
+  EEPROM.committed[CONFIG_ADDR + offsetof(ConfigData, password) + 3] ^= 0x5A;
+  unsigned long commits = EEPROM.commitCount;
+  Config_begin();
+  CHECK_STR(config.deviceName, DEFAULT_DEVICE_NAME);
+  CHECK_STR(config.localIp, DEFAULT_LOCAL_IP);
+  CHECK_EQ(config.channel, 0);
+  CHECK_EQ(EEPROM.commitCount, commits);
+
+  // record จาก firmware ที่ใหม่กว่า (version อื่น) → default
+  ConfigData newer = committedRecord();
+  newer.version = CONFIG_VERSION + 1;
+  newer.crc = ConfigRecord_checksum(newer);
+  memcpy(&EEPROM.committed[CONFIG_ADDR], &newer, sizeof(newer));
+  Config_begin();
+  CHECK_STR(config.deviceName, DEFAULT_DEVICE_NAME);
+
+  // record ถูกต้องแต่ baud ไม่ใช่ rate มาตรฐาน → หาใหม่ (0)
+  Config_defaults();
+  config.baud = 12345;
+  Config_save();
+  Config_begin();
+  CHECK_EQ(config.baud, 0);
+}
+#endif
+
+int main() {
+  testSealAndCrc();
+  testParseIp();
+  testIsLocalIp();
+  testSetText();
+#ifdef HOST_HAVE_ARDUINOJSON
+  testBeginBlank();
+  testBeginMigratesLegacy();
+  testBeginCorruptRecord();
+#endif
+  return HostCheck_finish("config_record");
+}
@@ -0,0 +1,107 @@
+/**
+ * DedupWindowTest.cpp - กรอง reading ซ้ำด้วย epoch + seq (center/DedupWindow.h)
+ *
+ * - ส่งซ้ำ (ไม่ได้ ACK / replay จาก Journal) → DUPLICATE แม้มาไม่เรียงลำดับ
+ * - seq ข้าม (reading หาย) แล้วตัวที่หายมาทีหลัง → NEW
+ * - epoch เปลี่ยน → RESTARTED แม้ seq ใหม่จะอยู่ใน window เดิม
+ * - epoch = 0 (firmware เก่า) → seq ต่ำกว่า window ถือว่าเริ่มนับใหม่
+ */
+
+#include "HostCheck.h"
+#include "DedupWindow.h"
+
+// ===== ลำดับปกติ + ส่งซ้ำ =====
+static void testDuplicates() {
+  DedupWindow w;
+  Dedup_reset(w);
+
+  CHECK_EQ(Dedup_check(w, 0xA1, 0), DEDUP_UNTRACKED);
+  CHECK_EQ(w.highest, 0);
+
+  CHECK_EQ(Dedup_check(w, 0xA1, 1), DEDUP_NEW);
+  CHECK_EQ(Dedup_check(w, 0xA1, 2), DEDUP_NEW);
+  CHECK_EQ(Dedup_check(w, 0xA1, 2), DEDUP_DUPLICATE);
+  CHECK_EQ(Dedup_check(w, 0xA1, 1), DEDUP_DUPLICATE);
+  CHECK_EQ(Dedup_check(w, 0xA1, 3), DEDUP_NEW);
+  CHECK_EQ(w.highest, 3);
+}
+
+// ===== มาไม่เรียง / มีช่องว่าง =====
+static void testReorderAndGap() {
+  DedupWindow w;
+  Dedup_reset(w);
+
+  CHECK_EQ(Dedup_check(w, 7, 10), DEDUP_NEW);
+  CHECK_EQ(Dedup_check(w, 7, 14), DEDUP_NEW);     // 11-13 ยังไม่มา
+  CHECK_EQ(Dedup_check(w, 7, 12), DEDUP_NEW);
+  CHECK_EQ(Dedup_check(w, 7, 12), DEDUP_DUPLICATE);
+  CHECK_EQ(Dedup_check(w, 7, 11), DEDUP_NEW);
+  CHECK_EQ(Dedup_check(w, 7, 13), DEDUP_NEW);
+  CHECK_EQ(Dedup_check(w, 7, 10), DEDUP_DUPLICATE);
+  CHECK_EQ(w.highest, 14);
+
+  // ข้ามไปไกลกว่า window → ของเดิมหลุด window แต่ตัวล่าสุดยังกรองได้
+  CHECK_EQ(Dedup_check(w, 7, 14 + DEDUP_WINDOW_SIZE + 5), DEDUP_NEW);
+  CHECK_EQ(Dedup_check(w, 7, 14 + DEDUP_WINDOW_SIZE + 5), DEDUP_DUPLICATE);
+  CHECK_EQ(Dedup_check(w, 7, 14 + DEDUP_WINDOW_SIZE + 4), DEDUP_NEW);
+
+  // ขอบ window: offset 63 ยังอยู่ใน window, 64 = เริ่มนับใหม่
+  Dedup_reset(w);
+  CHECK_EQ(Dedup_check(w, 7, 100), DEDUP_NEW);
+  CHECK_EQ(Dedup_check(w, 7, 100 - (DEDUP_WINDOW_SIZE - 1)), DEDUP_NEW);
+  CHECK_EQ(Dedup_check(w, 7, 100 - (DEDUP_WINDOW_SIZE - 1)), DEDUP_DUPLICATE);
+  CHECK_EQ(w.highest, 100);
+}
+
+// ===== epoch เปลี่ยน → เริ่ม window ใหม่ =====
+static void testEpochChange() {
+  DedupWindow w;
+  Dedup_reset(w);
+
+  for (uint32_t seq = 1; seq <= 5; seq++) {
+    Dedup_check(w, 0x1111, seq);
+  }
+  // journal ถูกสร้างใหม่ → seq 1 อีกครั้ง (อยู่ใน window) แต่ epoch ใหม่
+  CHECK_EQ(Dedup_check(w, 0x2222, 1), DEDUP_RESTARTED);
+  CHECK_EQ(w.epoch, 0x2222);
+  CHECK_EQ(Dedup_check(w, 0x2222, 1), DEDUP_DUPLICATE);
+  CHECK_EQ(Dedup_check(w, 0x2222, 2), DEDUP_NEW);
+
+  // epoch = 0 ใน reading (ไม่ส่งมา) → ใช้ epoch เดิม
+  CHECK_EQ(Dedup_check(w, 0, 2), DEDUP_DUPLICATE);
+  CHECK_EQ(w.epoch, 0x2222);
+
+  // epoch จาก HELLO ก่อน reading แรก
+  CHECK(Dedup_setEpoch(w, 0x3333));
+  CHECK(!Dedup_setEpoch(w, 0x3333));
+  CHECK(!Dedup_setEpoch(w, 0));
+  CHECK_EQ(w.highest, 0);
+  CHECK_EQ(Dedup_check(w, 0x3333, 1), DEDUP_NEW);
+
+  // window ว่าง → epoch ใหม่ไม่นับเป็นการเริ่มใหม่
+  DedupWindow empty;
+  Dedup_reset(empty);
+  CHECK(!Dedup_setEpoch(empty, 0x4444));
+  CHECK_EQ(Dedup_check(empty, 0x4444, 1), DEDUP_NEW);
+}
+
+// ===== ไม่มี epoch (firmware เก่า) → seq ต่ำกว่า window = เริ่มนับใหม่ =====
+static void testLegacyRestart() {
+  DedupWindow w;
+  Dedup_reset(w);
+
+  CHECK_EQ(Dedup_check(w, 0, 500), DEDUP_NEW);
+  CHECK_EQ(Dedup_check(w, 0, 499), DEDUP_NEW);
+  CHECK_EQ(Dedup_check(w, 0, 1), DEDUP_RESTARTED);
+  CHECK_EQ(w.highest, 1);
+  CHECK_EQ(Dedup_check(w, 0, 1), DEDUP_DUPLICATE);
+  CHECK_EQ(Dedup_check(w, 0, 2), DEDUP_NEW);
+}
+
+int main() {
+  testDuplicates();
+  testReorderAndGap();
+  testEpochChange();
+  testLegacyRestart();
+  return HostCheck_finish("dedup window");
+}
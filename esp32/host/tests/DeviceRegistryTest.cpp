@@ -0,0 +1,309 @@
+/**
+ * DeviceRegistryTest.cpp - ตารางอุปกรณ์ของ Center (center/DeviceRegistry.h)
+ *
+ * - เพิ่ม/ค้นหาด้วย MAC, MAC อ่านไม่ได้ → key จาก deviceId, อัพเดทไม่เพิ่มซ้ำ
+ * - ลบแบบ backward-shift: MAC ที่ hash ชนกัน (probe chain) ลบตัวกลาง/ตัวแรก/ข้ามขอบตาราง แล้วตัวอื่นยังหาเจอ
+ * - insert/remove แบบสุ่มเทียบกับ model (std::map) ทุกขั้น
+ * - timer wheel: ออฟไลน์หลัง DEVICE_TIMEOUT ไม่ก่อน, touch เลื่อนเวลา, timeout ยาวกว่า 1 รอบ wheel,
+ *   ไม่ได้เรียกนาน, millis() วนรอบ
+ * - ตารางเต็ม → แทนที่อุปกรณ์ออฟไลน์ที่เห็นล่าสุดนานที่สุด / ออนไลน์ทั้งหมด → nullptr
+ */
+
+#define REGISTRY_CAPACITY 8
+
+#include "HostCheck.h"
+#include "DeviceRegistry.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#define TEST_TIMEOUT 10000
+
+static int offlineCalls = 0;
+
+static void countOffline(const RegistryDevice&) {
+  offlineCalls++;
+}
+
+static std::string macFor(uint32_t n) {
+  char mac[REGISTRY_MAC_SIZE];
+  snprintf(mac, sizeof(mac), "24:6F:28:%02X:%02X:%02X", (n >> 16) & 0xFF, (n >> 8) & 0xFF, n & 0xFF);
+  return mac;
+}
+
+static RegistryDevice* add(const std::string& mac, unsigned long now) {
+  bool isNew;
+  return Registry_update(mac.c_str(), "Station", mac.c_str(), now, isNew);
+}
+
+// ตาราง hash ตรงกับอุปกรณ์ที่ใช้อยู่: จำนวนเท่ากัน และทุกตัวหาเจอจาก key ของตัวเอง
+static bool tableConsistent() {
+  int inTable = 0;
+  for (int i = 0; i < REGISTRY_TABLE_SIZE; i++) {
+    if (registryTable[i] != REGISTRY_NONE) {
+      inTable++;
+      if (!registryDevices[registryTable[i]].used) {
+        return false;
+      }
+    }
+  }
+  int used = 0;
+  for (int i = 0; i < REGISTRY_CAPACITY; i++) {
+    if (registryDevices[i].used) {
+      used++;
+      int slot = Registry_findSlot(registryDevices[i].key);
+      if (slot == REGISTRY_NONE || registryTable[slot] != i) {
+        return false;
+      }
+    }
+  }
+  return inTable == used && used == Registry_getCount();
+}
+
+// ===== เพิ่ม / ค้นหา / อัพเดท =====
+static void testInsertFind() {
+  Registry_begin(TEST_TIMEOUT, 1000);
+  bool isNew;
+  RegistryDevice* a = Registry_update("AA:BB:CC:00:00:01", "BP-01", "AA:BB:CC:00:00:01", 1000, isNew);
+  CHECK(a != nullptr && isNew);
+  CHECK_STR(a->deviceName, "BP-01");
+
+  // MAC ตัวพิมพ์เล็ก / คั่นด้วย '-' → อุปกรณ์เดิม ชื่อใหม่
+  RegistryDevice* same = Registry_update("id-ignored", "BP-01b", "aa-bb-cc-00-00-01", 1100, isNew);
+  CHECK(same == a && !isNew);
+  CHECK_STR(a->deviceName, "BP-01b");
+  CHECK_EQ(Registry_getCount(), 1);
+
+  // MAC อ่านไม่ได้ → key จาก deviceId (locally administered bit)
+  RegistryDevice* byId = Registry_update("scale-7", "Scale", "", 1200, isNew);
+  CHECK(byId != nullptr && isNew);
+  CHECK(byId->key[0] & 0x02);
+  CHECK(Registry_find("", "scale-7") == byId);
+  CHECK(Registry_find("not-a-mac", "scale-7") == byId);
+  CHECK(Registry_find("", "scale-8") == nullptr);
+
+  // ชื่อยาวเกินถูกตัด ไม่ล้น
+  std::string longName(REGISTRY_NAME_SIZE * 2, 'n');
+  RegistryDevice* named = Registry_update("x", longName.c_str(), "AA:BB:CC:00:00:02", 1300, isNew);
+  CHECK_EQ(strlen(named->deviceName), REGISTRY_NAME_SIZE - 1);
+
+  CHECK_EQ(Registry_getCount(), 3);
+  CHECK_EQ(Registry_getOnlineCount(), 3);
+  CHECK(tableConsistent());
+
+  uint8_t mac[6];
+  CHECK(!Registry_parseMac("AA:BB:CC:00:00", mac));
+  CHECK(!Registry_parseMac("AA:BB:CC:00:00:0G", mac));
+  CHECK(!Registry_parseMac("AA:BB:CC:00:00:01:02", mac));
+  CHECK(!Registry_parseMac(nullptr, mac));
+}
+
+// ===== ลบ: MAC ที่ชนกันใน probe chain =====
+// หา MAC ที่ hash ลง slot home (chain ยาว) - เลือก home ท้ายตารางเพื่อให้ chain วนข้ามขอบ
+static std::vector<std::string> collidingMacs(uint32_t home, int count) {
+  std::vector<std::string> macs;
+  for (uint32_t n = 0; (int)macs.size() < count; n++) {
+    std::string mac = macFor(n);
+    uint8_t key[6];
+    Registry_parseMac(mac.c_str(), key);
+    if (Registry_hash(key) == home) {
+      macs.push_back(mac);
+    }
+  }
+  return macs;
+}
+
+static void testRemoveCollisions() {
+  const uint32_t homes[] = { 3, REGISTRY_TABLE_SIZE - 2 };
+  for (int h = 0; h < 2; h++) {
+    for (int victim = 0; victim < 4; victim++) {
+      Registry_begin(TEST_TIMEOUT, 1000);
+      std::vector<std::string> macs = collidingMacs(homes[h], 4);
+      // อุปกรณ์อื่นที่ home อยู่ถัดไป → ถูกดันไปอยู่หลัง chain
+      std::vector<std::string> neighbours = collidingMacs((homes[h] + 1) & (REGISTRY_TABLE_SIZE - 1), 2);
+      for (size_t i = 0; i < macs.size(); i++) {
+        add(macs[i], 1000);
+      }
+      for (size_t i = 0; i < neighbours.size(); i++) {
+        add(neighbours[i], 1000);
+      }
+      CHECK(tableConsistent());
+
+      RegistryDevice* gone = Registry_find(macs[victim].c_str(), "");
+      Registry_remove((int16_t)(gone - registryDevices));
+      CHECK(Registry_find(macs[victim].c_str(), "") == nullptr);
+      for (int i = 0; i < 4; i++) {
+        if (i != victim) {
+          CHECK(Registry_find(macs[i].c_str(), "") != nullptr);
+        }
+      }
+      for (size_t i = 0; i < neighbours.size(); i++) {
+        CHECK(Registry_find(neighbours[i].c_str(), "") != nullptr);
+      }
+      CHECK_EQ(Registry_getCount(), 5);
+      CHECK_EQ(Registry_getOnlineCount(), 5);
+      CHECK(tableConsistent());
+
+      // ช่องที่ว่างใช้ได้อีก
+      CHECK(add(macs[victim], 1100) != nullptr);
+      CHECK(tableConsistent());
+    }
+  }
+}
+
+// ===== insert/remove สุ่ม เทียบกับ model =====
+static void testRandomAgainstModel() {
+  Registry_begin(TEST_TIMEOUT, 1000);
+  std::map<std::string, int> model;   // mac → ครั้งที่เพิ่ม
+  uint32_t seed = 12345;
+  bool ok = true;
+
+  for (int step = 0; step < 20000 && ok; step++) {
+    seed = seed * 1103515245u + 12345u;
+    std::string mac = macFor((seed >> 8) % 24);   // 24 MAC ในตาราง 8 ช่อง → ชนกันบ่อย
+    RegistryDevice* found = Registry_find(mac.c_str(), "");
+    ok = (found != nullptr) == (model.count(mac) == 1);
+
+    if (found != nullptr && (seed & 0x100)) {
+      Registry_remove((int16_t)(found - registryDevices));
+      model.erase(mac);
+    } else if (found == nullptr && (int)model.size() < REGISTRY_CAPACITY) {
+      ok = ok && add(mac, 1000) != nullptr;
+      model[mac] = step;
+    }
+    ok = ok && tableConsistent() && Registry_getCount() == (int)model.size() &&
+         Registry_getOnlineCount() == (int)model.size();
+  }
+  CHECK(ok);
+  for (std::map<std::string, int>::const_iterator it = model.begin(); it != model.end(); ++it) {
+    CHECK(Registry_find(it->first.c_str(), "") != nullptr);
+  }
+}
+
+// ===== timer wheel =====
+static void testExpiry() {
+  unsigned long start = 5000;
+  Registry_begin(TEST_TIMEOUT, start);
+  offlineCalls = 0;
+  add(macFor(1), start);
+  add(macFor(2), start + 400);
+
+  CHECK_EQ(Registry_expire(start + TEST_TIMEOUT, countOffline), 0);
+  CHECK_EQ(Registry_getOnlineCount(), 2);
+
+  // touch ตัวที่ 2 → เลื่อนออกไป
+  uint8_t key[6];
+  Registry_parseMac(macFor(2).c_str(), key);
+  bool wasOnline = false;
+  CHECK(Registry_touch(key, start + 8000, wasOnline) != nullptr);
+  CHECK(wasOnline);
+
+  // ไม่ก่อน timeout แต่ไม่เกิน timeout + 2 tick
+  int expired = 0;
+  unsigned long now = start + TEST_TIMEOUT;
+  for (; now <= start + TEST_TIMEOUT + 2 * REGISTRY_WHEEL_TICK && expired == 0; now += 10) {
+    expired = Registry_expire(now, countOffline);
+  }
+  CHECK_EQ(expired, 1);
+  CHECK(now - 10 > start + TEST_TIMEOUT);
+  CHECK(!Registry_find(macFor(1).c_str(), "")->online);
+  CHECK(Registry_find(macFor(2).c_str(), "")->online);
+  CHECK_EQ(Registry_getOnlineCount(), 1);
+  CHECK_EQ(offlineCalls, 1);
+
+  // ไม่ได้เรียก expire นาน (loop ค้าง) → ตัวที่ครบแล้วออฟไลน์ในครั้งเดียว
+  CHECK_EQ(Registry_expire(start + 8000 + 5 * TEST_TIMEOUT, countOffline), 1);
+  CHECK_EQ(Registry_getOnlineCount(), 0);
+  CHECK_EQ(offlineCalls, 2);
+
+  // กลับมาออนไลน์ได้ / setOffline ทันที
+  Registry_parseMac(macFor(1).c_str(), key);
+  CHECK(Registry_touch(key, start + 60000, wasOnline) != nullptr);
+  CHECK(!wasOnline);
+  CHECK_EQ(Registry_getOnlineCount(), 1);
+  CHECK(Registry_setOffline(key) != nullptr);
+  CHECK(Registry_setOffline(key) == nullptr);
+  CHECK_EQ(Registry_getOnlineCount(), 0);
+  CHECK_EQ(Registry_expire(start + 60000 + 3 * TEST_TIMEOUT, countOffline), 0);
+}
+
+// timeout ยาวกว่า 1 รอบ wheel (16 s) → slot เดียวกันมีอุปกรณ์ของรอบถัดไป ต้องไม่ออฟไลน์ก่อนเวลา
+static void testLongTimeout() {
+  const unsigned long timeout = 40000;
+  Registry_begin(timeout, 0);
+  add(macFor(1), 0);
+  add(macFor(2), REGISTRY_WHEEL_SLOTS * REGISTRY_WHEEL_TICK);   // slot เดียวกัน รอบถัดไป
+
+  int expired = 0;
+  unsigned long firstAt = 0;
+  for (unsigned long now = 0; now <= timeout + REGISTRY_WHEEL_SLOTS * REGISTRY_WHEEL_TICK + 3000; now += 100) {
+    int n = Registry_expire(now, nullptr);
+    if (n > 0 && expired == 0) {
+      firstAt = now;
+    }
+    expired += n;
+  }
+  CHECK_EQ(expired, 2);
+  CHECK(firstAt > timeout && firstAt <= timeout + 2 * REGISTRY_WHEEL_TICK);
+}
+
+// millis() วนรอบ → tick ย้อนกลับ: จัด wheel ใหม่ ไม่ออฟไลน์ทันที และยังหมดเวลาตามจริง
+static void testMillisWrap() {
+  const unsigned long start = (unsigned long)0 - 3000;
+  Registry_begin(TEST_TIMEOUT, start);
+  add(macFor(1), start);
+  add(macFor(2), start + 2000);
+
+  int expired = 0;
+  unsigned long now = start;
+  unsigned long firstAt = 0;
+  for (int i = 0; i < 200; i++, now += 100) {
+    int n = Registry_expire(now, nullptr);
+    if (n > 0 && firstAt == 0) {
+      firstAt = now;
+    }
+    expired += n;
+  }
+  // now - start ยังเป็นเวลาจริงแม้ now วนรอบแล้ว
+  CHECK_EQ(expired, 2);
+  CHECK(firstAt - start > TEST_TIMEOUT);
+  CHECK(firstAt - start <= TEST_TIMEOUT + 2 * REGISTRY_WHEEL_TICK);
+  CHECK_EQ(Registry_getOnlineCount(), 0);
+}
+
+// ===== ตารางเต็ม =====
+static void testEviction() {
+  Registry_begin(TEST_TIMEOUT, 1000);
+  for (int i = 0; i < REGISTRY_CAPACITY; i++) {
+    CHECK(add(macFor(i), 1000 + i * 10) != nullptr);
+  }
+  CHECK(add(macFor(100), 2000) == nullptr);   // ออนไลน์ทั้งหมด
+  CHECK_EQ(Registry_getCount(), REGISTRY_CAPACITY);
+
+  // ออฟไลน์ 2 ตัว → แทนที่ตัวที่เห็นล่าสุดนานกว่า
+  uint8_t key[6];
+  Registry_parseMac(macFor(5).c_str(), key);
+  Registry_setOffline(key);
+  Registry_parseMac(macFor(2).c_str(), key);
+  Registry_setOffline(key);
+
+  CHECK(add(macFor(100), 3000) != nullptr);
+  CHECK(Registry_find(macFor(2).c_str(), "") == nullptr);
+  CHECK(Registry_find(macFor(5).c_str(), "") != nullptr);
+  CHECK_EQ(Registry_getEvictedCount(), 1);
+  CHECK_EQ(Registry_getCount(), REGISTRY_CAPACITY);
+  CHECK_EQ(Registry_getOnlineCount(), REGISTRY_CAPACITY - 1);
+  CHECK(tableConsistent());
+}
+
+int main() {
+  testInsertFind();
+  testRemoveCollisions();
+  testRandomAgainstModel();
+  testExpiry();
+  testLongTimeout();
+  testMillisWrap();
+  testEviction();
+  return HostCheck_finish("device_registry");
+}
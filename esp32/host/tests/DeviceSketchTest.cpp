@@ -0,0 +1,274 @@
+/**
+ * DeviceSketchTest.cpp - ESP32_RS232.ino ทั้งไฟล์ (ไม่แก้) บน PC: ทางส่ง reading ไปยัง Center
+ *
+ * Center จำลองอยู่ในไฟล์นี้: อ่าน datagram ที่อุปกรณ์ส่ง (wireUdp.sent) แล้วป้อน ACK กลับ
+ * - sendReading() → Journal + Outbox → loop() ส่ง HELLO แล้ว READING ทาง UDP → ACK → ออกจากคิว
+ * - Center ไม่ตอบ → timeout แล้วส่ง seq เดิมซ้ำตาม backoff (ไม่หาย ไม่ซ้ำ seq)
+ * - payload JSON (queueToCenter) ส่งทาง HTTP POST /api/vitals
+ * - หลายรายการค้าง → POST /api/vitals/batch: results [1,0] + รายการที่ไม่อยู่ใน results ส่งใหม่, 4xx → ทีละรายการ, 404 → ทีละรายการตลอด
+ * - keep-alive: socket ค้างที่ Center ปิดไปแล้ว → เปิดใหม่แล้วส่งซ้ำทันที / connection ใหม่ล้ม → รอ backoff
+ *
+ * UPLINK_BINARY ใน Config.h เป็นค่าคงที่ (true) → sendReading() ใช้ทาง UDP
+ * Arduino IDE สร้าง prototype ของฟังก์ชันใน .ino ให้เอง - บน PC ประกาศเองก่อน include
+ */
+
+#include "HostCheck.h"
+
+void setupLED();
+void taskLED(unsigned long now);
+void startLEDPattern(int count, unsigned long interval);
+void blinkLEDOnce();
+
+#include "ESP32_RS232.ino"
+
+#include <string>
+#include <vector>
+
+struct HostCenter {
+  bool answer;                       // false = ไม่ตอบ (Center ปิด / packet หาย)
+  int unanswered;                    // READING ที่ไม่ได้ตอบ
+  int hellos;
+  std::vector<WireHeader> readings;
+  std::vector<WireReading> values;
+};
+
+static HostCenter center = { true, 0, 0, {}, {} };
+
+static void answerWire() {
+  while (!wireUdp.sent.empty()) {
+    HostDatagram datagram = wireUdp.sent.front();
+    wireUdp.sent.pop_front();
+    CHECK_EQ(datagram.port, WIRE_UDP_PORT);
+    CHECK_STR(datagram.ip.toString().c_str(), DEFAULT_CENTER_IP);
+
+    const uint8_t* frame = (const uint8_t*)datagram.data.data();
+    WireHeader header;
+    int payloadLength = Wire_parseFrame(frame, datagram.data.size(), header);
+    CHECK(payloadLength >= 0);
+    if (payloadLength < 0 || header.type == WIRE_MSG_HEARTBEAT) {
+      continue;
+    }
+    if (!center.answer) {
+      center.unanswered += header.type == WIRE_MSG_READING;
+      continue;
+    }
+    if (header.type == WIRE_MSG_HELLO) {
+      center.hellos++;
+    } else if (header.type == WIRE_MSG_READING) {
+      WireReading reading;
+      CHECK(Wire_decodeReading(frame + WIRE_HEADER_SIZE, payloadLength, reading));
+      center.readings.push_back(header);
+      center.values.push_back(reading);
+    }
+    uint8_t ack[WIRE_HEADER_SIZE + WIRE_CRC_SIZE];
+    size_t length = Wire_encodeAck(ack, header.session, header.seq, WIRE_ACK_OK);
+    wireUdp.inject(ack, length, datagram.ip, WIRE_UDP_PORT);
+  }
+}
+
+// loop() ทุก 1 ms (นาฬิกาจำลอง) พร้อม Center ตอบ UDP
+static void runFor(unsigned long ms) {
+  for (unsigned long i = 0; i < ms; i++) {
+    loop();
+    answerWire();
+    Host_advanceMillis(1);
+  }
+}
+
+static WireReading bloodPressure(int16_t bp, int16_t bp2, int16_t pulse) {
+  WireReading reading = { WIRE_KIND_BLOOD_PRESSURE,
+                          WIRE_FIELD_VALUE0 | WIRE_FIELD_VALUE1 | WIRE_FIELD_VALUE2 | WIRE_FIELD_IDCARD,
+                          Wire_idcardFromString("1234567890123"), { bp, bp2, pulse, 0 }, 0 };
+  return reading;
+}
+
+static void testSetup() {
+  setup();
+  CHECK(WiFi.beginCount >= 1);
+  CHECK_STR(Config_get()->centerIp, DEFAULT_CENTER_IP);
+
+  runFor(200);
+  CHECK(isWiFiUp());
+  CHECK_EQ(Outbox_size(), 0);
+}
+
+static void testSendReadingWire() {
+  sendReading(bloodPressure(120, 80, 70));
+  CHECK_EQ(Outbox_size(), 1);
+  CHECK_EQ(Journal_getPendingCount(), 1);
+
+  runFor(50);
+  CHECK_EQ(center.hellos, 1);
+  CHECK_EQ(center.readings.size(), 1);
+  CHECK_EQ(Outbox_size(), 0);
+  CHECK_EQ(Journal_getPendingCount(), 0);
+  if (center.readings.size() == 1) {
+    CHECK(center.readings[0].status & WIRE_READING_DURABLE_SEQ);
+    CHECK_EQ(center.values[0].values[0], 120);
+    CHECK_EQ(center.values[0].values[1], 80);
+    CHECK_EQ(center.values[0].values[2], 70);
+    char idcard[24];
+    Wire_idcardToString(center.values[0].idcard, idcard, sizeof(idcard));
+    CHECK_STR(idcard, "1234567890123");
+  }
+}
+
+static void testSendReadingRetry() {
+  // Center ไม่ตอบ → reading ค้างในคิว (ไม่หาย) แล้วส่ง seq เดิมเมื่อ Center กลับมา
+  center.answer = false;
+  center.readings.clear();
+  center.values.clear();
+  sendReading(bloodPressure(130, 85, 72));
+  uint32_t seq = Outbox_peek()->seq;
+  runFor(WIRE_ACK_TIMEOUT * 3);
+  CHECK(center.unanswered >= 1);
+  CHECK_EQ(Outbox_size(), 1);
+  CHECK_EQ(Journal_getPendingCount(), 1);
+
+  center.answer = true;
+  runFor(UPLINK_BACKOFF_MAX);
+  CHECK_EQ(Outbox_size(), 0);
+  CHECK_EQ(Journal_getPendingCount(), 0);
+  CHECK_EQ(center.readings.size(), 1);
+  if (center.readings.size() == 1) {
+    CHECK_EQ(center.readings[0].seq, seq);
+    CHECK_EQ(center.values[0].values[0], 130);
+  }
+}
+
+static void testSendJson() {
+  unsigned long postsBefore = uplinkHttp.postCount;
+  const char* json = "{\"deviceId\":\"24:6F:28:00:00:01\",\"deviceType\":\"temp\",\"data\":{\"value\":36.5}}";
+  CHECK(queueToCenter(json, strlen(json), "temp"));
+  runFor(50);
+  CHECK_EQ(uplinkHttp.postCount, postsBefore + 1);
+  CHECK_STR(uplinkHttp.path.c_str(), "/api/vitals");
+  CHECK_STR(uplinkHttp.lastBody.c_str(), json);
+  CHECK_EQ(Outbox_size(), 0);
+}
+
+// keep-alive: Center ปิด socket ที่ค้างไปแล้ว → เปิดใหม่แล้วส่งซ้ำทันที 1 ครั้ง (ไม่รอ backoff)
+static void testStaleSocketRetry() {
+  CHECK(uplinkClient.connected());   // คงไว้จาก testSendJson (setReuse)
+  unsigned long postsBefore = uplinkHttp.postCount;
+  unsigned long opensBefore = uplinkClient.openCount;
+  unsigned long connectsBefore = Uplink_getConnectCount();
+  unsigned long staleBefore = uplinkStaleCount;
+
+  uplinkHttp.failNext = true;
+  const char* json = "{\"deviceId\":\"24:6F:28:00:00:01\",\"deviceType\":\"temp\",\"data\":{\"value\":36.7}}";
+  CHECK(queueToCenter(json, strlen(json), "temp"));
+  runFor(5);
+  CHECK_EQ(uplinkHttp.postCount, postsBefore + 2);
+  CHECK_EQ(uplinkStaleCount, staleBefore + 1);
+  CHECK_EQ(uplinkClient.openCount, opensBefore + 1);
+  CHECK_EQ(Uplink_getConnectCount(), connectsBefore + 1);
+  CHECK_STR(uplinkHttp.lastBody.c_str(), json);
+  CHECK_EQ(Outbox_size(), 0);
+  CHECK(uplinkClient.connected());
+
+  // connection ใหม่ล้มเหลว → ไม่ส่งซ้ำทันที รอ backoff แล้วค่อยส่ง (reading ไม่หาย)
+  Uplink_close();
+  postsBefore = uplinkHttp.postCount;
+  uplinkHttp.failNext = true;
+  CHECK(queueToCenter(json, strlen(json), "temp"));
+  runFor(5);
+  CHECK_EQ(uplinkHttp.postCount, postsBefore + 1);
+  CHECK_EQ(uplinkStaleCount, staleBefore + 1);
+  CHECK_EQ(Outbox_size(), 1);
+
+  runFor(UPLINK_BACKOFF_MIN);
+  CHECK_EQ(uplinkHttp.postCount, postsBefore + 2);
+  CHECK_EQ(Outbox_size(), 0);
+}
+
+static std::string tempJson(int n) {
+  char json[128];
+  snprintf(json, sizeof(json), "{\"deviceId\":\"24:6F:28:00:00:01\",\"deviceType\":\"temp\",\"data\":{\"value\":36.%d}}", n);
+  return json;
+}
+
+// หลายรายการค้าง → POST /api/vitals/batch ครั้งเดียว แล้วทำตาม results ทีละรายการ
+static void testSendBatchResults() {
+  std::string t1 = tempJson(1), t2 = tempJson(2), t3 = tempJson(3);
+  unsigned long postsBefore = uplinkHttp.postCount;
+  unsigned long batchesBefore = uplinkBatchCount;
+
+  // partial: [1,0] → รายการแรกส่งแล้ว รายการที่ 2 Center ไม่รับ (ทิ้ง) รายการที่ 3 ไม่อยู่ใน results → ส่งใหม่
+  uplinkHttp.responseBody = "{\"status\":\"partial\",\"accepted\":1,\"rejected\":1,\"results\":[1,0],\"error\":\"Center busy\"}";
+  CHECK(queueToCenter(t1.c_str(), t1.size(), "temp"));
+  CHECK(queueToCenter(t2.c_str(), t2.size(), "temp"));
+  CHECK(queueToCenter(t3.c_str(), t3.size(), "temp"));
+  runFor(1);
+  CHECK_EQ(uplinkHttp.postCount, postsBefore + 1);
+  CHECK_STR(uplinkHttp.path.c_str(), "/api/vitals/batch");
+  std::string batch = "[" + t1 + "," + t2 + "," + t3 + "]";
+  CHECK_STR(uplinkHttp.lastBody.c_str(), batch.c_str());
+  CHECK_EQ(uplinkBatchCount, batchesBefore + 1);
+  CHECK_EQ(Outbox_size(), 1);
+  CHECK_EQ(Journal_getPendingCount(), 1);
+
+  uplinkHttp.responseBody = "{\"status\":\"ok\"}";
+  runFor(5);
+  CHECK_EQ(uplinkHttp.postCount, postsBefore + 2);
+  CHECK_STR(uplinkHttp.path.c_str(), "/api/vitals");
+  CHECK_STR(uplinkHttp.lastBody.c_str(), t3.c_str());
+  CHECK_EQ(Outbox_size(), 0);
+  CHECK_EQ(Journal_getPendingCount(), 0);
+
+  // results ว่าง (Center หยุดที่ element แรก) → ไม่ทิ้งอะไร รอ backoff แล้วส่งใหม่ทั้งหมด
+  postsBefore = uplinkHttp.postCount;
+  uplinkHttp.responseBody = "{\"status\":\"partial\",\"accepted\":0,\"rejected\":0,\"results\":[]}";
+  CHECK(queueToCenter(t1.c_str(), t1.size(), "temp"));
+  CHECK(queueToCenter(t2.c_str(), t2.size(), "temp"));
+  runFor(1);
+  CHECK_EQ(uplinkHttp.postCount, postsBefore + 1);
+  CHECK_EQ(Outbox_size(), 2);
+  uplinkHttp.responseBody = "{\"status\":\"ok\",\"accepted\":2,\"rejected\":0,\"results\":[1,1]}";
+  runFor(UPLINK_BACKOFF_MIN + 1);
+  CHECK_EQ(uplinkHttp.postCount, postsBefore + 2);
+  batch = "[" + t1 + "," + t2 + "]";
+  CHECK_STR(uplinkHttp.lastBody.c_str(), batch.c_str());
+  CHECK_EQ(Outbox_size(), 0);
+
+  // 4xx ทั้ง batch → ส่งทีละรายการ (ทิ้งเฉพาะรายการที่เสีย)
+  postsBefore = uplinkHttp.postCount;
+  uplinkHttp.responseCode = 400;
+  CHECK(queueToCenter(t1.c_str(), t1.size(), "temp"));
+  CHECK(queueToCenter(t2.c_str(), t2.size(), "temp"));
+  runFor(1);
+  CHECK_EQ(uplinkSingleRemaining, 2);
+  CHECK_EQ(Outbox_size(), 2);
+  uplinkHttp.responseCode = HTTP_CODE_OK;
+  uplinkHttp.responseBody = "{\"status\":\"ok\"}";
+  runFor(5);
+  CHECK_EQ(uplinkHttp.postCount, postsBefore + 3);
+  CHECK_STR(uplinkHttp.path.c_str(), "/api/vitals");
+  CHECK_STR(uplinkHttp.lastBody.c_str(), t2.c_str());
+  CHECK_EQ(Outbox_size(), 0);
+
+  // Center รุ่นเก่า (404) → ส่งทีละรายการตลอด
+  postsBefore = uplinkHttp.postCount;
+  uplinkHttp.responseCode = 404;
+  CHECK(queueToCenter(t1.c_str(), t1.size(), "temp"));
+  CHECK(queueToCenter(t2.c_str(), t2.size(), "temp"));
+  runFor(1);
+  CHECK(!uplinkBatchSupported);
+  uplinkHttp.responseCode = HTTP_CODE_OK;
+  runFor(5);
+  CHECK_EQ(uplinkHttp.postCount, postsBefore + 3);
+  CHECK_STR(uplinkHttp.path.c_str(), "/api/vitals");
+  CHECK_EQ(Outbox_size(), 0);
+  CHECK_EQ(Journal_getPendingCount(), 0);
+  uplinkBatchSupported = true;
+}
+
+int main() {
+  testSetup();
+  testSendReadingWire();
+  testSendReadingRetry();
+  testSendJson();
+  testStaleSocketRetry();
+  testSendBatchResults();
+  return HostCheck_finish("device_sketch");
+}
@@ -0,0 +1,223 @@
+/**
+ * FramerTest.cpp - resync ของ JsonFramer / LineFramer (ESP32_RS232)
+ *
+ * ป้อน byte แบบเดียวกับ RS232Reader แล้วตรวจว่า:
+ * - ขยะระหว่างเฟรมถูกทิ้ง เฟรมถัดไปได้ครบ
+ * - เฟรมที่ลึกเกิน JSON_FRAMER_MAX_DEPTH รายงาน CORRUPT ครั้งเดียว
+ *   และ '{' ด้านในไม่กลายเป็นเฟรมปลอม
+ * - เฟรม/บรรทัดที่ยาวเกิน buffer ถูกข้ามจนจบ แล้วเฟรมถัดไปได้ครบ
+ */
+
+#include "HostCheck.h"
+#include "JsonFramer.h"
+#include "LineFramer.h"
+
+#include <string>
+#include <vector>
+
+// ผลจากการป้อนข้อความทั้งก้อน
+struct FeedResult {
+  std::vector<std::string> frames;
+  int overflows = 0;
+  int corrupts = 0;
+};
+
+static FeedResult feedJson(JsonFramer& f, const std::string& text) {
+  FeedResult result;
+  for (size_t i = 0; i < text.size(); i++) {
+    switch (JsonFramer_push(f, text[i])) {
+      case JSON_FRAMER_FRAME:    result.frames.push_back(f.buffer); break;
+      case JSON_FRAMER_OVERFLOW: result.overflows++; break;
+      case JSON_FRAMER_CORRUPT:  result.corrupts++; break;
+      default: break;
+    }
+  }
+  return result;
+}
+
+static FeedResult feedLine(LineFramer& f, const std::string& text) {
+  FeedResult result;
+  for (size_t i = 0; i < text.size(); i++) {
+    switch (LineFramer_push(f, text[i])) {
+      case LINE_FRAMER_FRAME:
+        result.frames.push_back(f.buffer);
+        LineFramer_reset(f);
+        break;
+      case LINE_FRAMER_OVERFLOW:
+        result.overflows++;
+        break;
+      default:
+        break;
+    }
+  }
+  return result;
+}
+
+// ===== JSON: เฟรมปกติ + ขยะ =====
+static void testJsonGarbage() {
+  JsonFramer f;
+  JsonFramer_begin(f);
+
+  FeedResult r = feedJson(f, "xx\r\n{\"sys\":120}junk{\"dia\":80,\"o\":{\"a\":[1,2]}}");
+  CHECK_EQ(r.frames.size(), 2);
+  if (r.frames.size() == 2) {
+    CHECK_STR(r.frames[0].c_str(), "{\"sys\":120}");
+    CHECK_STR(r.frames[1].c_str(), "{\"dia\":80,\"o\":{\"a\":[1,2]}}");
+  }
+  CHECK_EQ(f.garbageBytes, 8);
+  CHECK_EQ(f.frameCount, 2);
+  CHECK(!JsonFramer_inFrame(f));
+}
+
+// ===== JSON: { } และ \" ใน string ไม่ถูกนับ =====
+static void testJsonStrings() {
+  JsonFramer f;
+  JsonFramer_begin(f);
+
+  FeedResult r = feedJson(f, "{\"note\":\"a}b{c\\\"}\",\"x\":1}");
+  CHECK_EQ(r.frames.size(), 1);
+  if (r.frames.size() == 1) {
+    CHECK_STR(r.frames[0].c_str(), "{\"note\":\"a}b{c\\\"}\",\"x\":1}");
+  }
+  CHECK(!JsonFramer_inFrame(f));
+}
+
+// ===== JSON: ลึกเกิน → CORRUPT ครั้งเดียว ไม่มีเฟรมปลอมจาก '{' ด้านใน =====
+static void testJsonTooDeep() {
+  JsonFramer f;
+  JsonFramer_begin(f);
+
+  std::string deep;
+  for (int i = 0; i < JSON_FRAMER_MAX_DEPTH + 4; i++) {
+    deep += "{\"a\":";
+  }
+  deep += "1";
+  for (int i = 0; i < JSON_FRAMER_MAX_DEPTH + 4; i++) {
+    deep += "}";
+  }
+
+  FeedResult r = feedJson(f, deep + "{\"ok\":1}");
+  CHECK_EQ(r.corrupts, 1);
+  CHECK_EQ(f.corruptCount, 1);
+  CHECK_EQ(r.frames.size(), 1);
+  if (r.frames.size() == 1) {
+    CHECK_STR(r.frames[0].c_str(), "{\"ok\":1}");
+  }
+  CHECK_EQ(f.garbageBytes, 0);
+}
+
+// ===== JSON: ปิดวงเล็บผิดชนิด → CORRUPT แล้วเฟรมถัดไปได้ครบ =====
+static void testJsonMismatch() {
+  JsonFramer f;
+  JsonFramer_begin(f);
+
+  // '}' ปิด '[' - ข้ามต่อจน '}' นอกสุด
+  FeedResult r = feedJson(f, "{\"a\":[1}}{\"ok\":1}");
+  CHECK_EQ(r.corrupts, 1);
+  CHECK_EQ(r.frames.size(), 1);
+  if (r.frames.size() == 1) {
+    CHECK_STR(r.frames[0].c_str(), "{\"ok\":1}");
+  }
+
+  // ']' ปิด '{' ตัวนอกสุด → CORRUPT ที่ byte นั้นเลย
+  r = feedJson(f, "{\"a\":1]{\"ok\":2}");
+  CHECK_EQ(r.corrupts, 1);
+  CHECK_EQ(r.frames.size(), 1);
+  CHECK_EQ(f.corruptCount, 2);
+
+  // เฟรมที่ไม่ครบหลังวงเล็บผิด → สายเงียบไม่นับเป็นเฟรมไม่ครบซ้ำ
+  r = feedJson(f, "{\"a\":{\"b\":[1,2}");
+  CHECK_EQ(r.corrupts, 1);
+  CHECK(!JsonFramer_idle(f));
+
+  // วงเล็บซ้อนถูกชนิด / วงเล็บใน string ไม่ถูกตรวจ
+  r = feedJson(f, "{\"a\":[{\"b\":[]},[\"]}\"]]}");
+  CHECK_EQ(r.corrupts, 0);
+  CHECK_EQ(r.frames.size(), 1);
+}
+
+// ===== JSON: เฟรมเสียแล้วสายเงียบ → idle ไม่นับเป็นเฟรมไม่ครบซ้ำ =====
+static void testJsonIdle() {
+  JsonFramer f;
+  JsonFramer_begin(f);
+
+  feedJson(f, "{\"sys\":12");
+  CHECK(JsonFramer_inFrame(f));
+  CHECK(JsonFramer_idle(f));
+  CHECK(!JsonFramer_inFrame(f));
+
+  std::string deep(JSON_FRAMER_MAX_DEPTH + 1, '{');
+  FeedResult r = feedJson(f, deep);
+  CHECK_EQ(r.corrupts, 1);
+  CHECK(!JsonFramer_idle(f));
+
+  // หลัง idle '}' ที่ค้างเป็นขยะ เฟรมถัดไปได้ครบ
+  r = feedJson(f, "}}{\"ok\":2}");
+  CHECK_EQ(r.frames.size(), 1);
+  CHECK_EQ(f.garbageBytes, 2);
+}
+
+// ===== JSON: ใหญ่เกิน buffer → OVERFLOW แล้วข้ามจนจบเฟรม =====
+static void testJsonOverflow() {
+  JsonFramer f;
+  JsonFramer_begin(f);
+
+  std::string big = "{\"blob\":\"" + std::string(JSON_FRAMER_CAPACITY, 'x') + "{}\",\"n\":{}}";
+  FeedResult r = feedJson(f, big + "{\"ok\":3}");
+  CHECK_EQ(r.overflows, 1);
+  CHECK_EQ(f.overflowCount, 1);
+  CHECK_EQ(r.frames.size(), 1);
+  if (r.frames.size() == 1) {
+    CHECK_STR(r.frames[0].c_str(), "{\"ok\":3}");
+  }
+}
+
+// ===== Line: บรรทัดปกติ, CRLF, บรรทัดว่าง =====
+static void testLineBasic() {
+  LineFramer f;
+  LineFramer_begin(f);
+
+  FeedResult r = feedLine(f, "ST,GS,  65.40kg\r\n\r\nUS,GS,  65.50kg\n");
+  CHECK_EQ(r.frames.size(), 2);
+  if (r.frames.size() == 2) {
+    CHECK_STR(r.frames[0].c_str(), "ST,GS,  65.40kg");
+    CHECK_STR(r.frames[1].c_str(), "US,GS,  65.50kg");
+  }
+  CHECK_EQ(f.lineCount, 2);
+  CHECK(!LineFramer_inFrame(f));
+}
+
+// ===== Line: ยาวเกิน → OVERFLOW ตอนจบบรรทัด แล้วบรรทัดถัดไปได้ครบ =====
+static void testLineOverflow() {
+  LineFramer f;
+  LineFramer_begin(f);
+
+  FeedResult r = feedLine(f, std::string(LINE_FRAMER_CAPACITY + 10, 'x'));
+  CHECK_EQ(r.overflows, 0);
+  CHECK(LineFramer_inFrame(f));
+
+  r = feedLine(f, "\nST,GS,  70.00kg\n");
+  CHECK_EQ(r.overflows, 1);
+  CHECK_EQ(f.overflowCount, 1);
+  CHECK_EQ(r.frames.size(), 1);
+  if (r.frames.size() == 1) {
+    CHECK_STR(r.frames[0].c_str(), "ST,GS,  70.00kg");
+  }
+
+  // สายเงียบกลางบรรทัด = จบบรรทัด
+  feedLine(f, "ST,GS,  71.00kg");
+  CHECK_EQ(LineFramer_finish(f), LINE_FRAMER_FRAME);
+  CHECK_STR(f.buffer, "ST,GS,  71.00kg");
+}
+
+int main() {
+  testJsonGarbage();
+  testJsonStrings();
+  testJsonTooDeep();
+  testJsonMismatch();
+  testJsonIdle();
+  testJsonOverflow();
+  testLineBasic();
+  testLineOverflow();
+  return HostCheck_finish("framer");
+}
@@ -0,0 +1,66 @@
+/**
+ * HostCheck.h - CHECK แบบง่ายสำหรับ test บน PC (ไม่ใช้ framework ภายนอก)
+ *
+ *   CHECK(cond)          ไม่จริง → พิมพ์ไฟล์:บรรทัด แล้วนับเป็น failure (ทำต่อ)
+ *   CHECK_EQ(a, b)       เทียบค่าจำนวนเต็ม - พิมพ์ทั้งสองค่าเมื่อไม่เท่ากัน
+ *   CHECK_STR(a, b)      เทียบ C string
+ *   return HostCheck_finish("ชื่อ test") ใน main() → exit code 1 ถ้ามี failure
+ */
+
+#ifndef HOST_CHECK_H
+#define HOST_CHECK_H
+
+#include <stdio.h>
+#include <string.h>
+
+inline int& HostCheck_failures() {
+  static int failures = 0;
+  return failures;
+}
+
+inline int& HostCheck_count() {
+  static int count = 0;
+  return count;
+}
+
+inline void HostCheck_fail(const char* file, int line, const char* text) {
+  fprintf(stderr, "%s:%d: CHECK ไม่ผ่าน: %s\n", file, line, text);
+  HostCheck_failures()++;
+}
+
+#define CHECK(cond) do { \
+    HostCheck_count()++; \
+    if (!(cond)) HostCheck_fail(__FILE__, __LINE__, #cond); \
+  } while (0)
+
+#define CHECK_EQ(a, b) do { \
+    HostCheck_count()++; \
+    long long checkA = (long long)(a), checkB = (long long)(b); \
+    if (checkA != checkB) { \
+      fprintf(stderr, "%s:%d: CHECK_EQ ไม่ผ่าน: %s = %lld, %s = %lld\n", \
+              __FILE__, __LINE__, #a, checkA, #b, checkB); \
+      HostCheck_failures()++; \
+    } \
+  } while (0)
+
+#define CHECK_STR(a, b) do { \
+    HostCheck_count()++; \
+    const char* checkA = (a); \
+    const char* checkB = (b); \
+    if (checkA == nullptr || checkB == nullptr || strcmp(checkA, checkB) != 0) { \
+      fprintf(stderr, "%s:%d: CHECK_STR ไม่ผ่าน: %s = \"%s\", %s = \"%s\"\n", __FILE__, __LINE__, \
+              #a, checkA ? checkA : "(null)", #b, checkB ? checkB : "(null)"); \
+      HostCheck_failures()++; \
+    } \
+  } while (0)
+
+inline int HostCheck_finish(const char* name) {
+  if (HostCheck_failures() > 0) {
+    fprintf(stderr, "❌ %s: ไม่ผ่าน %d จาก %d\n", name, HostCheck_failures(), HostCheck_count());
+    return 1;
+  }
+  printf("✅ %s: ผ่าน %d\n", name, HostCheck_count());
+  return 0;
+}
+
+#endif
@@ -0,0 +1,190 @@
+/**
+ * JournalTest.cpp - Journal.h บน LittleFS ของ shim (ESP32_RS232)
+ *
+ * จำลอง reboot ด้วย LittleFS.powerLoss() + ล้างตัวแปรใน RAM แล้ว Journal_begin() ใหม่
+ * - append / ack แล้ว reboot → record ที่ยังไม่ได้ส่งกลับมาใน backlog ตามลำดับ seq
+ * - เขียนไม่ครบ (tearAfter) แล้วไฟดับ → slot crc ไม่ตรง ถูกข้ามและนับใน journalCorruptCount
+ * - byte เสียใน flash (corrupt) → ข้ามเฉพาะ record นั้น
+ * - ring เต็ม → record เก่าที่ยังไม่ได้ส่งนับใน journalLostCount
+ * - epoch สร้างใหม่เมื่อไม่มี record / epoch หาย
+ */
+
+#include "HostCheck.h"
+#include "Journal.h"
+
+#include <string>
+#include <vector>
+
+// ===== ไฟดับ/reboot: flash ย้อนไป flush ล่าสุด, ตัวแปรใน RAM เริ่มใหม่ =====
+static void reboot() {
+  LittleFS.powerLoss();
+  journalFile = File();
+  journalReady = false;
+  journalLostCount = 0;
+  journalCorruptCount = 0;
+  CHECK(Journal_begin());
+  Serial.takeOutput();
+}
+
+static void freshJournal() {
+  LittleFS.reset();
+  reboot();
+}
+
+static uint32_t append(const char* payload) {
+  return Journal_append(payload, strlen(payload), "bp");
+}
+
+// seq ของ backlog ทั้งหมด (ข้าม slot ที่ส่งแล้ว/เสีย) พร้อมตรวจ payload
+static std::vector<uint32_t> drainBacklog() {
+  std::vector<uint32_t> seqs;
+  char payload[JOURNAL_PAYLOAD_SIZE + 1];
+  char label[JOURNAL_LABEL_SIZE];
+  uint16_t length = 0;
+  while (Journal_hasBacklog()) {
+    uint32_t seq = Journal_nextBacklog(payload, length, label);
+    if (seq == 0) {
+      continue;
+    }
+    seqs.push_back(seq);
+    std::string expected = "{\"seq\":" + std::to_string(seq) + "}";
+    CHECK_STR(payload, expected.c_str());
+    CHECK_EQ(length, expected.size());
+    CHECK_STR(label, "bp");
+  }
+  return seqs;
+}
+
+static uint32_t appendSeq() {
+  std::string payload = "{\"seq\":" + std::to_string(Journal_peekNextSeq()) + "}";
+  return append(payload.c_str());
+}
+
+// ===== append / ack / recover =====
+static void testRecover() {
+  freshJournal();
+  CHECK_EQ(Journal_peekNextSeq(), 1);
+  CHECK(Journal_getEpoch() != 0);
+  uint32_t epoch = Journal_getEpoch();
+
+  CHECK_EQ(appendSeq(), 1);
+  CHECK_EQ(appendSeq(), 2);
+  CHECK_EQ(appendSeq(), 3);
+  Journal_ack(2);
+  Journal_ack(2);                 // ack ซ้ำ ไม่นับซ้ำ
+  CHECK_EQ(Journal_getPendingCount(), 2);
+
+  reboot();
+  CHECK_EQ(Journal_getPendingCount(), 2);
+  CHECK_EQ(Journal_peekNextSeq(), 4);
+  CHECK_EQ(Journal_getEpoch(), epoch);
+  CHECK_EQ(journalCorruptCount, 0);
+
+  std::vector<uint32_t> seqs = drainBacklog();
+  CHECK_EQ(seqs.size(), 2);
+  if (seqs.size() == 2) {
+    CHECK_EQ(seqs[0], 1);
+    CHECK_EQ(seqs[1], 3);
+  }
+}
+
+// ===== เขียนไม่ครบแล้วไฟดับ → slot เสียถูกข้าม =====
+static void testTornWrite() {
+  freshJournal();
+  appendSeq();
+  appendSeq();
+
+  // header (มี magic) + label บางส่วนลง flash แต่ payload ไม่ถึง
+  LittleFS.tearAfter(sizeof(JournalHeader) + 4);
+  appendSeq();
+  reboot();
+
+  CHECK_EQ(journalCorruptCount, 1);
+  CHECK_EQ(Journal_getPendingCount(), 2);
+  CHECK_EQ(Journal_peekNextSeq(), 3);
+
+  // seq 3 ถูกใช้ใหม่กับ slot เดิม → ครั้งนี้ครบ
+  CHECK_EQ(appendSeq(), 3);
+  reboot();
+  CHECK_EQ(journalCorruptCount, 0);
+  CHECK_EQ(Journal_getPendingCount(), 3);
+
+  std::vector<uint32_t> seqs = drainBacklog();
+  CHECK_EQ(seqs.size(), 3);
+}
+
+// ===== byte เสียใน flash → ข้ามเฉพาะ record นั้น =====
+static void testCorruptSlot() {
+  freshJournal();
+  appendSeq();
+  appendSeq();
+  appendSeq();
+
+  // byte แรกของ payload ของ seq 2
+  CHECK(LittleFS.corrupt(JOURNAL_FILE, 2 * JOURNAL_SLOT_SIZE + sizeof(JournalHeader) + JOURNAL_LABEL_SIZE, 0x01));
+  reboot();
+
+  CHECK_EQ(journalCorruptCount, 1);
+  CHECK_EQ(Journal_getPendingCount(), 2);
+  CHECK_EQ(Journal_peekNextSeq(), 4);
+
+  std::vector<uint32_t> seqs = drainBacklog();
+  CHECK_EQ(seqs.size(), 2);
+  if (seqs.size() == 2) {
+    CHECK_EQ(seqs[0], 1);
+    CHECK_EQ(seqs[1], 3);
+  }
+}
+
+// ===== ring เต็ม → record เก่าสุดที่ยังไม่ได้ส่งหาย =====
+static void testRingFull() {
+  freshJournal();
+  const int extra = 6;
+  for (int i = 0; i < JOURNAL_SLOT_COUNT + extra; i++) {
+    appendSeq();
+  }
+  CHECK_EQ(Journal_getLostCount(), extra);
+  CHECK_EQ(Journal_getPendingCount(), JOURNAL_SLOT_COUNT);
+
+  reboot();
+  CHECK_EQ(Journal_getPendingCount(), JOURNAL_SLOT_COUNT);
+  std::vector<uint32_t> seqs = drainBacklog();
+  CHECK_EQ(seqs.size(), JOURNAL_SLOT_COUNT);
+  if (!seqs.empty()) {
+    CHECK_EQ(seqs.front(), extra + 1);
+    CHECK_EQ(seqs.back(), JOURNAL_SLOT_COUNT + extra);
+  }
+}
+
+// ===== epoch: ไม่มี record → epoch ใหม่ / epoch หาย (firmware เก่า) → สร้างให้ seq เดิม =====
+static void testEpoch() {
+  freshJournal();
+  uint32_t first = Journal_getEpoch();
+  reboot();
+  CHECK(Journal_getEpoch() != 0);
+  CHECK(Journal_getEpoch() != first);
+
+  appendSeq();
+  appendSeq();
+  uint32_t epoch = Journal_getEpoch();
+  reboot();
+  CHECK_EQ(Journal_getEpoch(), epoch);
+
+  for (int i = 0; i < 4; i++) {
+    LittleFS.corrupt(JOURNAL_FILE, JOURNAL_EPOCH_OFFSET + i, (uint8_t)(epoch >> (8 * i)));
+  }
+  reboot();
+  CHECK(Journal_getEpoch() != 0);
+  CHECK(Journal_getEpoch() != epoch);
+  CHECK_EQ(Journal_peekNextSeq(), 3);
+  CHECK_EQ(Journal_getPendingCount(), 2);
+}
+
+int main() {
+  testRecover();
+  testTornWrite();
+  testCorruptSlot();
+  testRingFull();
+  testEpoch();
+  return HostCheck_finish("journal");
+}
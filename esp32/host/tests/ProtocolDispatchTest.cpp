@@ -0,0 +1,187 @@
+/**
+ * ProtocolDispatchTest.cpp - ProtocolList / Protocol_dispatch() (ESP32_RS232/ProtocolRegistry.h)
+ *
+ * ใช้ ProtocolList ของตัวเอง = WeightTextProtocol + โปรโตคอลปลอม (ไม่ต้องมี ArduinoJson)
+ * - table มี ID/NAME/BAUD ตรงกับ struct ตามลำดับที่ประกาศ
+ * - dispatch ไปยัง apply<P>() ของโปรโตคอลที่ ID ตรงเท่านั้น / ID ที่ไม่รู้จัก → false
+ * - visitor แบบเดียวกับ RS232Reader (Framer → Parser) ได้ reading ของโปรโตคอลนั้น
+ * มี ArduinoJson → ตรวจ InstrumentProtocols, Protocol_find() และ Protocol_findByName() ด้วย
+ */
+
+#include "HostCheck.h"
+#include "ProtocolRegistry.h"
+#include "WeightTextProtocol.h"
+#ifdef HOST_HAVE_ARDUINOJSON
+  #include "InstrumentProtocol.h"
+#endif
+
+#include <string>
+
+// ===== โปรโตคอลปลอม: เฟรมจบด้วย '#', reading = ความยาวเฟรม =====
+struct FakeProtocol {
+  static constexpr uint8_t ID = 42;
+  static constexpr const char* NAME = "fake";
+  static constexpr const char* DESCRIPTION = "test";
+  static constexpr const char* FORMAT = "xxx#";
+  static constexpr uint32_t BAUD = 4800;
+  static constexpr uint32_t IDLE_TIMEOUT = 50;
+
+  struct Framer {
+    char buffer[16];
+    size_t length;
+  };
+  struct Parser {
+    const char* error;
+  };
+
+  static void begin(Framer& f, Parser& p) {
+    f.length = 0;
+    p.error = "";
+  }
+  static ProtocolFrameResult push(Framer& f, char c) {
+    if (c == '#') {
+      f.buffer[f.length] = '\0';
+      return PROTOCOL_FRAME_READY;
+    }
+    if (f.length + 1 >= sizeof(f.buffer)) {
+      return PROTOCOL_FRAME_OVERFLOW;
+    }
+    f.buffer[f.length++] = c;
+    return PROTOCOL_FRAME_NONE;
+  }
+  static ProtocolFrameResult idle(Framer& f) {
+    return f.length > 0 ? PROTOCOL_FRAME_INCOMPLETE : PROTOCOL_FRAME_NONE;
+  }
+  static char* frame(Framer& f, size_t& length) {
+    length = f.length;
+    return f.buffer;
+  }
+  static void reset(Framer& f) {
+    f.length = 0;
+  }
+  static ProtocolParseResult parse(Parser& p, char* frame, size_t length, uint32_t now, WireReading& out) {
+    memset(&out, 0, sizeof(out));
+    out.kind = WIRE_KIND_WEIGHT;
+    out.values[0] = (int16_t)length;
+    out.fields = WIRE_FIELD_VALUE0;
+    return PROTOCOL_PARSE_READING;
+  }
+};
+
+typedef ProtocolList<WeightTextProtocol, FakeProtocol> TestProtocols;
+
+// ===== visitor ที่บันทึกว่าโปรโตคอลไหนถูกเรียก =====
+struct RecordVisitor {
+  int calls = 0;
+  uint8_t id = 0;
+  const char* name = nullptr;
+
+  template <typename P>
+  void apply() {
+    calls++;
+    id = P::ID;
+    name = P::NAME;
+  }
+};
+
+// ===== visitor แบบ RS232Reader: ป้อน byte → เฟรม → reading =====
+struct ReadVisitor {
+  const char* input;
+  int readings = 0;
+  WireReading last;
+
+  template <typename P>
+  void apply() {
+    typename P::Framer framer;
+    typename P::Parser parser;
+    P::begin(framer, parser);
+    for (const char* c = input; *c; c++) {
+      if (P::push(framer, *c) != PROTOCOL_FRAME_READY) {
+        continue;
+      }
+      size_t length = 0;
+      char* frame = P::frame(framer, length);
+      if (P::parse(parser, frame, length, 1000, last) == PROTOCOL_PARSE_READING) {
+        readings++;
+      }
+      P::reset(framer);
+    }
+  }
+};
+
+static void testTable() {
+  CHECK_EQ(TestProtocols::COUNT, 2);
+  CHECK_EQ(TestProtocols::table[0].id, WeightTextProtocol::ID);
+  CHECK_STR(TestProtocols::table[0].name, "weight-text");
+  CHECK_EQ(TestProtocols::table[0].baud, 9600);
+  CHECK_EQ(TestProtocols::table[1].id, 42);
+  CHECK_STR(TestProtocols::table[1].name, "fake");
+  CHECK_STR(TestProtocols::table[1].format, "xxx#");
+  CHECK_EQ(TestProtocols::table[1].baud, 4800);
+
+  // ใช้ตอน compile ได้ (constexpr)
+  static_assert(TestProtocols::table[1].id == FakeProtocol::ID, "table ต้องเป็น constexpr");
+}
+
+static void testDispatch() {
+  RecordVisitor visitor;
+  CHECK(Protocol_dispatch(FakeProtocol::ID, visitor, (TestProtocols*)nullptr));
+  CHECK_EQ(visitor.calls, 1);
+  CHECK_EQ(visitor.id, FakeProtocol::ID);
+  CHECK_STR(visitor.name, "fake");
+
+  CHECK(Protocol_dispatch(WeightTextProtocol::ID, visitor, (TestProtocols*)nullptr));
+  CHECK_EQ(visitor.calls, 2);
+  CHECK_EQ(visitor.id, WeightTextProtocol::ID);
+
+  // ID ที่ไม่รู้จัก / 0 / list ว่าง → ไม่เรียก apply
+  CHECK(!Protocol_dispatch(7, visitor, (TestProtocols*)nullptr));
+  CHECK(!Protocol_dispatch(0, visitor, (TestProtocols*)nullptr));
+  CHECK(!Protocol_dispatch(FakeProtocol::ID, visitor, (ProtocolList<>*)nullptr));
+  CHECK_EQ(visitor.calls, 2);
+}
+
+static void testPipeline() {
+  ReadVisitor fake;
+  fake.input = "abc#12345#";
+  CHECK(Protocol_dispatch(FakeProtocol::ID, fake, (TestProtocols*)nullptr));
+  CHECK_EQ(fake.readings, 2);
+  CHECK_EQ(fake.last.kind, WIRE_KIND_WEIGHT);
+  CHECK_EQ(fake.last.values[0], 5);
+
+  ReadVisitor weight;
+  weight.input = "T365$\r\n";
+  CHECK(Protocol_dispatch(WeightTextProtocol::ID, weight, (TestProtocols*)nullptr));
+  CHECK_EQ(weight.readings, 1);
+  CHECK_EQ(weight.last.kind, WIRE_KIND_TEMP);
+  CHECK_EQ(weight.last.values[0], 365);
+}
+
+#ifdef HOST_HAVE_ARDUINOJSON
+// ===== โปรโตคอลจริงของ firmware =====
+static void testInstrumentProtocols() {
+  for (size_t i = 0; i < InstrumentProtocols::COUNT; i++) {
+    const ProtocolInfo& info = InstrumentProtocols::table[i];
+    CHECK(info.id != 0);
+    CHECK(Protocol_find(info.id) == &info);           // ID ไม่ซ้ำ (ตัวแรกที่เจอ = ตัวเอง)
+    CHECK(Protocol_findByName(info.name) == &info);
+
+    RecordVisitor visitor;
+    CHECK(Protocol_dispatch(info.id, visitor));
+    CHECK_EQ(visitor.id, info.id);
+  }
+  CHECK(Protocol_find(0) == nullptr);
+  CHECK(Protocol_findByName("unknown") == nullptr);
+  CHECK(Protocol_find(BPJsonProtocol::ID) != nullptr);
+}
+#endif
+
+int main() {
+  testTable();
+  testDispatch();
+  testPipeline();
+#ifdef HOST_HAVE_ARDUINOJSON
+  testInstrumentProtocols();
+#endif
+  return HostCheck_finish("protocol dispatch");
+}
@@ -0,0 +1,223 @@
+/**
+ * ReadingCacheTest.cpp - ค่าล่าสุดของแต่ละอุปกรณ์ (center/ReadingCache.h)
+ *
+ * - kind → ช่อง (weight/height/weight_height ใช้ช่องเดียวกัน), kind ที่ไม่รู้จัก / index เกิน → ไม่เก็บ
+ * - generation เพิ่มทีละ 1, clearDevice → อ่านไม่ได้จนกว่าจะเก็บใหม่
+ * - JSON: since = 0 ทุกอุปกรณ์ / since > 0 เฉพาะที่เปลี่ยน / buffer เล็ก → "complete": false
+ *   แล้วถามต่อด้วย "generation" ได้อุปกรณ์ที่เหลือครบ
+ * - seqlock: loop() เขียน entry เดียวซ้ำๆ ขณะ network task อ่านคนละ thread จริง
+ *   → ทุกครั้งที่ Cache_read คืน true ค่าทุก field มาจาก reading เดียวกัน (ไม่ขาดครึ่ง)
+ *
+ * ส่วน thread ขึ้นกับจังหวะ (ไม่ deterministic) แต่ต้องผ่านทุกครั้ง - ล้มแม้ครั้งเดียว = barrier ผิด
+ */
+
+#include "HostCheck.h"
+#include "ReadingCache.h"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#define CACHE_TEST_TIMEOUT 30000
+#define SEQLOCK_WRITES 300000
+
+static WireReading makeReading(uint8_t kind, int16_t value) {
+  WireReading reading;
+  memset(&reading, 0, sizeof(reading));
+  reading.kind = kind;
+  reading.fields = WIRE_FIELD_VALUE0;
+  reading.values[0] = value;
+  return reading;
+}
+
+static void resetCache() {
+  memset(cacheEntries, 0, sizeof(cacheEntries));
+  cacheGeneration = 0;
+  Registry_begin(CACHE_TEST_TIMEOUT, 0);
+}
+
+static int addDevice(const char* deviceId, const char* mac) {
+  bool isNew;
+  RegistryDevice* device = Registry_update(deviceId, deviceId, mac, 0, isNew);
+  return device == nullptr ? -1 : (int)(device - registryDevices);
+}
+
+// ===== ช่อง / generation / clear =====
+static void testStoreAndRead() {
+  resetCache();
+  CHECK_EQ(Cache_slotFor(WIRE_KIND_BLOOD_PRESSURE), CACHE_SLOT_BP);
+  CHECK_EQ(Cache_slotFor(WIRE_KIND_WEIGHT), CACHE_SLOT_WEIGHT_HEIGHT);
+  CHECK_EQ(Cache_slotFor(WIRE_KIND_HEIGHT), CACHE_SLOT_WEIGHT_HEIGHT);
+  CHECK_EQ(Cache_slotFor(WIRE_KIND_WEIGHT_HEIGHT), CACHE_SLOT_WEIGHT_HEIGHT);
+  CHECK_EQ(Cache_slotFor(WIRE_KIND_TEMP), CACHE_SLOT_TEMP);
+  CHECK_EQ(Cache_slotFor(0), CACHE_SLOT_NONE);
+
+  CachedReading out;
+  CHECK(!Cache_read(0, CACHE_SLOT_BP, out));
+
+  CHECK_EQ(Cache_store(0, makeReading(WIRE_KIND_BLOOD_PRESSURE, 120), 7, 1000), 1);
+  CHECK_EQ(Cache_store(0, makeReading(WIRE_KIND_WEIGHT, 655), 8, 1100), 2);
+  CHECK_EQ(Cache_store(0, makeReading(WIRE_KIND_HEIGHT, 1702), 9, 1200), 3);   // ทับ weight
+  CHECK_EQ(Cache_store(0, makeReading(0, 1), 10, 1300), 0);
+  CHECK_EQ(Cache_store(-1, makeReading(WIRE_KIND_TEMP, 365), 11, 1300), 0);
+  CHECK_EQ(Cache_store(REGISTRY_CAPACITY, makeReading(WIRE_KIND_TEMP, 365), 11, 1300), 0);
+  CHECK_EQ(cacheGeneration, 3);
+
+  CHECK(Cache_read(0, CACHE_SLOT_BP, out));
+  CHECK_EQ(out.generation, 1);
+  CHECK_EQ(out.seq, 7);
+  CHECK_EQ(out.receivedAt, 1000);
+  CHECK_EQ(out.reading.values[0], 120);
+  CHECK(Cache_read(0, CACHE_SLOT_WEIGHT_HEIGHT, out));
+  CHECK_EQ(out.generation, 3);
+  CHECK_EQ(out.reading.kind, WIRE_KIND_HEIGHT);
+  CHECK(!Cache_read(0, CACHE_SLOT_TEMP, out));
+
+  // ช่อง registry ถูกใช้กับอุปกรณ์ใหม่ → ไม่เห็นค่าของอุปกรณ์เดิม
+  Cache_clearDevice(0);
+  CHECK(!Cache_read(0, CACHE_SLOT_BP, out));
+  CHECK(!Cache_read(0, CACHE_SLOT_WEIGHT_HEIGHT, out));
+  CHECK_EQ(Cache_store(0, makeReading(WIRE_KIND_TEMP, 365), 12, 1400), 4);
+  CHECK(Cache_read(0, CACHE_SLOT_TEMP, out));
+  CHECK_EQ(out.reading.values[0], 365);
+}
+
+// ===== JSON snapshot / changes / แบ่งหน้า =====
+static uint32_t resumeGeneration(const char* json) {
+  const char* found = strstr(json, "],\"generation\":");
+  return found == nullptr ? 0 : (uint32_t)strtoul(found + 15, nullptr, 10);
+}
+
+static void testJson() {
+  resetCache();
+  int a = addDevice("ST-A", "24:6F:28:00:00:0A");
+  int b = addDevice("ST-B", "24:6F:28:00:00:0B");
+  int c = addDevice("ST-C", "24:6F:28:00:00:0C");
+  CHECK(a >= 0 && b >= 0 && c >= 0);
+
+  char json[1024];
+  // since = 0: ทุกอุปกรณ์แม้ยังไม่มีค่า
+  CHECK(Cache_writeJson(json, sizeof(json), 0, 5000) > 0);
+  CHECK(strstr(json, "\"ST-A\"") && strstr(json, "\"ST-B\"") && strstr(json, "\"ST-C\""));
+  CHECK(strstr(json, "\"complete\":true") != nullptr);
+
+  Cache_store(a, makeReading(WIRE_KIND_TEMP, 368), 1, 5000);
+  Cache_store(b, makeReading(WIRE_KIND_TEMP, -15), 1, 5000);
+  uint32_t seen = cacheGeneration;
+  Cache_store(c, makeReading(WIRE_KIND_WEIGHT, 655), 1, 5000);
+
+  size_t onlyC = Cache_writeJson(json, sizeof(json), seen, 6000);
+  CHECK(onlyC > 0);
+  CHECK(strstr(json, "\"ST-A\"") == nullptr && strstr(json, "\"ST-B\"") == nullptr);
+  CHECK(strstr(json, "\"ST-C\"") != nullptr);
+  CHECK(strstr(json, "\"weight\":65.5") != nullptr);
+  CHECK(strstr(json, "\"ageMs\":1000") != nullptr);
+  CHECK_EQ(resumeGeneration(json), 3);
+
+  Cache_writeJson(json, sizeof(json), 0, 6000);
+  CHECK(strstr(json, "\"temp\":36.8") != nullptr);
+  CHECK(strstr(json, "\"temp\":-1.5") != nullptr);
+
+  // buffer พอแค่อุปกรณ์เดียว (ตัวที่ยาวที่สุด) → ถามต่อจนครบ ไม่มีอุปกรณ์ตกหล่น
+  size_t small = onlyC + 48;
+  std::string pages;
+  uint32_t since = 0;
+  int rounds = 0;
+  bool complete = false;
+  while (!complete && rounds < 5) {
+    CHECK(Cache_writeJson(json, small, since, 6000) > 0);
+    pages += json;
+    complete = strstr(json, "\"complete\":true") != nullptr;
+    since = resumeGeneration(json);
+    rounds++;
+  }
+  CHECK(complete);
+  CHECK(rounds > 1);
+  CHECK(pages.find("\"ST-A\"") != std::string::npos);
+  CHECK(pages.find("\"ST-B\"") != std::string::npos);
+  CHECK(pages.find("\"ST-C\"") != std::string::npos);
+
+  // buffer เล็กกว่าส่วนหัว
+  CHECK_EQ(Cache_writeJson(json, 40, 0, 6000), 0);
+}
+
+// ===== seqlock ภายใต้ writer คนละ thread =====
+// ทุก field ของ reading ที่ n คำนวณจาก n → ผู้อ่านตรวจได้ว่ามาจาก reading เดียวกัน
+static WireReading seqlockReading(uint32_t n) {
+  WireReading reading;
+  memset(&reading, 0, sizeof(reading));
+  reading.kind = WIRE_KIND_BLOOD_PRESSURE;
+  reading.fields = WIRE_FIELD_VALUE0 | WIRE_FIELD_VALUE1 | WIRE_FIELD_VALUE2 | WIRE_FIELD_IDCARD;
+  reading.idcard = 1000000000000ULL + n;
+  for (int i = 0; i < 4; i++) {
+    reading.values[i] = (int16_t)(n * 3 + i);
+  }
+  reading.timestamp = ~n;
+  return reading;
+}
+
+static bool seqlockConsistent(const CachedReading& out, uint32_t base) {
+  uint32_t n = out.seq;
+  WireReading expected = seqlockReading(n);
+  return out.generation == base + n + 1 && out.receivedAt == n * 7 &&
+         out.reading.kind == expected.kind && out.reading.fields == expected.fields &&
+         out.reading.idcard == expected.idcard && out.reading.timestamp == expected.timestamp &&
+         memcmp(out.reading.values, expected.values, sizeof(expected.values)) == 0;
+}
+
+static void testConcurrentWriter() {
+  resetCache();
+  uint32_t base = cacheGeneration;
+  std::atomic<bool> started(false);
+  std::atomic<bool> done(false);
+
+  std::thread writer([&started, &done]() {
+    while (!started) {
+      std::this_thread::yield();
+    }
+    for (uint32_t n = 0; n < SEQLOCK_WRITES; n++) {
+      Cache_store(0, seqlockReading(n), n, n * 7);
+      if (n % 64 == 0) {
+        std::this_thread::yield();   // เปิดช่องให้ผู้อ่านได้ค่าบ้าง (เครื่อง core เดียว)
+      }
+    }
+    done = true;
+  });
+
+  unsigned long reads = 0;
+  unsigned long torn = 0;
+  unsigned long backwards = 0;
+  uint32_t lastGeneration = 0;
+  started = true;
+  while (!done) {
+    CachedReading out;
+    if (!Cache_read(0, CACHE_SLOT_BP, out)) {
+      continue;   // ชนกับการเขียนทุกครั้ง - ไม่ได้ค่า แต่ไม่ได้ค่าผิด
+    }
+    reads++;
+    if (!seqlockConsistent(out, base)) {
+      torn++;
+    }
+    if (out.generation < lastGeneration) {
+      backwards++;
+    }
+    lastGeneration = out.generation;
+  }
+  writer.join();
+
+  CHECK_EQ(torn, 0);
+  CHECK_EQ(backwards, 0);
+  CHECK(reads > 0);
+
+  CachedReading last;
+  CHECK(Cache_read(0, CACHE_SLOT_BP, last));
+  CHECK_EQ(last.seq, SEQLOCK_WRITES - 1);
+  CHECK(seqlockConsistent(last, base));
+}
+
+int main() {
+  testStoreAndRead();
+  testJson();
+  testConcurrentWriter();
+  return HostCheck_finish("reading_cache");
+}
@@ -0,0 +1,245 @@
+/**
+ * ReadingStreamTest.cpp - ส่ง reading ให้หลาย client ผ่าน /ws (center/ReadingStream.h)
+ *
+ * transport ปลอม: client แต่ละตัวเก็บ frame ที่ได้ / stalled = คิวเต็ม (STREAM_BUSY) ตลอด
+ * - client ปกติได้ทุก frame ครบ เรียงตามลำดับ publish
+ * - client ที่ค้างจนค้างเกิน STREAM_LOG_FRAMES frame → ถูกตัด (close) ตัวอื่นยังได้ต่อไม่สะดุด
+ * - ค้างชั่วคราว (ไม่เกิน log) → ส่งที่ค้างต่อได้ครบเมื่อกลับมารับ
+ * - client ใหม่เริ่มที่ reading ถัดไป, ตารางเต็ม → close, หลุด (STREAM_GONE / event) → ออกจากตาราง
+ */
+
+#include "HostCheck.h"
+#include "ReadingStream.h"
+
+#include <string>
+#include <vector>
+
+#define TEST_CLIENTS 8
+
+struct FakeClient {
+  uint32_t id;
+  bool stalled;
+  bool gone;
+  bool closed;
+  std::vector<std::string> frames;
+};
+
+static FakeClient fakeClients[TEST_CLIENTS];
+static Histogram latency;
+
+static FakeClient* fakeFind(uint32_t id) {
+  for (int i = 0; i < TEST_CLIENTS; i++) {
+    if (fakeClients[i].id == id) {
+      return &fakeClients[i];
+    }
+  }
+  return nullptr;
+}
+
+static StreamSendResult fakeSend(uint32_t id, const char* data, size_t length) {
+  FakeClient* client = fakeFind(id);
+  if (client == nullptr || client->gone) {
+    return STREAM_GONE;
+  }
+  if (client->stalled) {
+    return STREAM_BUSY;
+  }
+  client->frames.push_back(std::string(data, length));
+  return STREAM_SENT;
+}
+
+static void fakeClose(uint32_t id) {
+  FakeClient* client = fakeFind(id);
+  if (client != nullptr) {
+    client->closed = true;
+  }
+}
+
+static void resetStream() {
+  memset(streamClients, 0, sizeof(streamClients));
+  streamHead = 0;
+  streamEventsHead = 0;
+  streamEventsTail = 0;
+  streamPublished = streamTooLarge = streamSent = streamSlowDropped = streamRejected = 0;
+  streamEventsDropped = 0;
+  for (int i = 0; i < TEST_CLIENTS; i++) {
+    fakeClients[i].id = 100 + i;
+    fakeClients[i].stalled = false;
+    fakeClients[i].gone = false;
+    fakeClients[i].closed = false;
+    fakeClients[i].frames.clear();
+  }
+  Histogram_reset(latency);
+}
+
+static void connect(uint32_t id) {
+  ReadingStream_pushEvent(id, true);
+  ReadingStream_processEvents(fakeClose);
+}
+
+static std::string readingJson(int n) {
+  char json[64];
+  snprintf(json, sizeof(json), "{\"seq\":%d}", n);
+  return json;
+}
+
+static void publish(int n) {
+  std::string json = readingJson(n);
+  CHECK(ReadingStream_publish(json.c_str(), json.size(), (uint32_t)n * 1000));
+}
+
+// ได้ frame from..to-1 ครบและเรียง
+static bool receivedInOrder(const FakeClient& client, int from, int to) {
+  if ((int)client.frames.size() != to - from) {
+    return false;
+  }
+  for (int n = from; n < to; n++) {
+    if (client.frames[n - from] != readingJson(n)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// ===== fan-out: ทุก client ได้ครบตามลำดับ =====
+static void testFanOut() {
+  resetStream();
+  for (int i = 0; i < STREAM_MAX_CLIENTS; i++) {
+    connect(fakeClients[i].id);
+  }
+  CHECK_EQ(ReadingStream_clientCount(), STREAM_MAX_CLIENTS);
+
+  // publish ทีละหลาย frame ก่อน drain (ไม่เกิน log) เหมือน loop ที่รับหลาย reading ต่อรอบ
+  int n = 0;
+  for (int round = 0; round < 10; round++) {
+    for (int k = 0; k < STREAM_LOG_FRAMES / 2; k++) {
+      publish(n++);
+    }
+    CHECK_EQ(ReadingStream_drain(n * 1000, fakeSend, fakeClose, latency), STREAM_MAX_CLIENTS * STREAM_LOG_FRAMES / 2);
+  }
+  for (int i = 0; i < STREAM_MAX_CLIENTS; i++) {
+    CHECK(receivedInOrder(fakeClients[i], 0, n));
+    CHECK(!fakeClients[i].closed);
+  }
+  CHECK_EQ(streamSent, (uint32_t)(STREAM_MAX_CLIENTS * n));
+  CHECK_EQ(latency.count, (uint32_t)(STREAM_MAX_CLIENTS * n));
+  CHECK_EQ(streamSlowDropped, 0);
+}
+
+// ===== client ค้าง: ตัดเมื่อค้างเกิน log ตัวอื่นยังได้ครบ =====
+static void testStalledClientDropped() {
+  resetStream();
+  for (int i = 0; i < STREAM_MAX_CLIENTS; i++) {
+    connect(fakeClients[i].id);
+  }
+  FakeClient& slow = fakeClients[0];
+  slow.stalled = true;
+
+  // ค้างพอดี STREAM_LOG_FRAMES frame → ยังไม่ถูกเขียนทับ ยังไม่ตัด
+  int n = 0;
+  for (; n < STREAM_LOG_FRAMES; n++) {
+    publish(n);
+    ReadingStream_drain(n * 1000, fakeSend, fakeClose, latency);
+  }
+  CHECK(!slow.closed);
+  CHECK_EQ(ReadingStream_clientCount(), STREAM_MAX_CLIENTS);
+  CHECK_EQ(slow.frames.size(), 0);
+
+  // frame ถัดไปเขียนทับ frame แรกที่ slow ยังไม่ได้ → ตัด
+  publish(n++);
+  ReadingStream_drain(n * 1000, fakeSend, fakeClose, latency);
+  CHECK(slow.closed);
+  CHECK_EQ(streamSlowDropped, 1);
+  CHECK(ReadingStream_find(slow.id) == nullptr);
+  CHECK_EQ(ReadingStream_clientCount(), STREAM_MAX_CLIENTS - 1);
+
+  // ตัวอื่นได้ต่อเนื่องไม่สะดุด ทั้งก่อนและหลัง slow ถูกตัด
+  for (int k = 0; k < 3 * STREAM_LOG_FRAMES; k++) {
+    publish(n++);
+    ReadingStream_drain(n * 1000, fakeSend, fakeClose, latency);
+  }
+  for (int i = 1; i < STREAM_MAX_CLIENTS; i++) {
+    CHECK(receivedInOrder(fakeClients[i], 0, n));
+    CHECK(!fakeClients[i].closed);
+  }
+  CHECK_EQ(slow.frames.size(), 0);
+
+  // client ต่อใหม่ (ดึงที่พลาดจาก /api/changes) → เริ่มที่ reading ถัดไป
+  slow.stalled = false;
+  slow.closed = false;
+  connect(slow.id);
+  publish(n);
+  ReadingStream_drain(n * 1000, fakeSend, fakeClose, latency);
+  CHECK(receivedInOrder(slow, n, n + 1));
+}
+
+// ===== ค้างชั่วคราว: ส่งที่ค้างต่อได้ครบ =====
+static void testTemporaryStall() {
+  resetStream();
+  connect(fakeClients[0].id);
+  connect(fakeClients[1].id);
+  fakeClients[1].stalled = true;
+
+  int n = 0;
+  for (; n < STREAM_LOG_FRAMES - 1; n++) {
+    publish(n);
+    ReadingStream_drain(n * 1000, fakeSend, fakeClose, latency);
+  }
+  fakeClients[1].stalled = false;
+  CHECK_EQ(ReadingStream_drain(n * 1000, fakeSend, fakeClose, latency), STREAM_LOG_FRAMES - 1);
+  CHECK(receivedInOrder(fakeClients[0], 0, n));
+  CHECK(receivedInOrder(fakeClients[1], 0, n));
+  CHECK(!fakeClients[1].closed);
+  CHECK_EQ(streamSlowDropped, 0);
+}
+
+// ===== ตารางเต็ม / หลุด / frame ใหญ่เกิน =====
+static void testClientTable() {
+  resetStream();
+  publish(0);   // ก่อนต่อ → client ไม่ได้
+  for (int i = 0; i < STREAM_MAX_CLIENTS + 1; i++) {
+    connect(fakeClients[i].id);
+  }
+  CHECK_EQ(ReadingStream_clientCount(), STREAM_MAX_CLIENTS);
+  CHECK_EQ(streamRejected, 1);
+  CHECK(fakeClients[STREAM_MAX_CLIENTS].closed);
+
+  publish(1);
+  ReadingStream_drain(1000, fakeSend, fakeClose, latency);
+  CHECK(receivedInOrder(fakeClients[0], 1, 2));
+
+  // หลุดระหว่างส่ง → STREAM_GONE → ออกจากตาราง (ไม่นับเป็น client ช้า)
+  fakeClients[0].gone = true;
+  publish(2);
+  ReadingStream_drain(2000, fakeSend, fakeClose, latency);
+  CHECK(ReadingStream_find(fakeClients[0].id) == nullptr);
+  CHECK_EQ(streamSlowDropped, 0);
+
+  // event หลุดจาก network task
+  ReadingStream_pushEvent(fakeClients[1].id, false);
+  ReadingStream_processEvents(fakeClose);
+  CHECK(ReadingStream_find(fakeClients[1].id) == nullptr);
+
+  // ยาวเกิน frame → ไม่ส่ง ไม่เลื่อน head
+  std::string big(STREAM_FRAME_SIZE, 'x');
+  uint32_t head = streamHead;
+  CHECK(!ReadingStream_publish(big.c_str(), big.size(), 0));
+  CHECK_EQ(streamTooLarge, 1);
+  CHECK_EQ(streamHead, head);
+
+  // คิว event เต็ม → นับ dropped
+  for (int i = 0; i < STREAM_EVENTS_CAPACITY; i++) {
+    CHECK(ReadingStream_pushEvent(500 + i, false));
+  }
+  CHECK(!ReadingStream_pushEvent(600, false));
+  CHECK_EQ(streamEventsDropped, 1);
+  ReadingStream_processEvents(fakeClose);
+}
+
+int main() {
+  testFanOut();
+  testStalledClientDropped();
+  testTemporaryStall();
+  testClientTable();
+  return HostCheck_finish("reading_stream");
+}
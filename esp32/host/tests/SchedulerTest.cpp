@@ -0,0 +1,150 @@
+/**
+ * SchedulerTest.cpp - ตัวจัดตารางงานแบบ cooperative (ESP32_RS232/Scheduler.h) บนนาฬิกาจำลอง
+ *
+ * - interval = 0 → ทุกรอบ / interval N → ครั้งแรกหลัง add ครบ N ms และห่างกันไม่น้อยกว่า N ms
+ * - loop() มาช้า → ทำครั้งเดียว (ไม่ทำชดเชยรอบที่พลาด) แล้วนับ interval ใหม่จากเวลาที่ทำจริง
+ * - งานที่ใช้เวลานาน → maxRunTime ของงานนั้น และงานถัดไปในรอบเดียวกันได้ now ที่เลื่อนแล้ว
+ * - millis() วนรอบ 32 bit ระหว่างรอ → ยังทำตาม interval
+ * - เต็ม SCHEDULER_MAX_TASKS → add คืน false
+ */
+
+#include "HostCheck.h"
+#include "Log.h"
+#include "Scheduler.h"
+
+#include <vector>
+
+static std::vector<unsigned long> everyRuns;
+static std::vector<unsigned long> slowRuns;
+static std::vector<unsigned long> afterBusyRuns;
+static unsigned long busyMs = 0;
+
+static void everyPass(unsigned long now) {
+  everyRuns.push_back(now);
+}
+
+static void every100(unsigned long now) {
+  slowRuns.push_back(now);
+}
+
+static void busyTask(unsigned long now) {
+  delay(busyMs);   // นาฬิกาจำลองเลื่อนเหมือนงานที่ทำนาน
+}
+
+static void afterBusy(unsigned long now) {
+  afterBusyRuns.push_back(now);
+}
+
+static void resetScheduler(uint64_t startMs) {
+  Host_setMicros(startMs * 1000);
+  schedulerTaskCount = 0;
+  everyRuns.clear();
+  slowRuns.clear();
+  afterBusyRuns.clear();
+  busyMs = 0;
+}
+
+// loop() ทุก step ms เป็นเวลา ms
+static void runFor(unsigned long ms, unsigned long step) {
+  for (unsigned long t = 0; t < ms; t += step) {
+    Scheduler_run();
+    Host_advanceMillis(step);
+  }
+}
+
+// ===== interval =====
+static void testIntervals() {
+  resetScheduler(5000);
+  CHECK(Scheduler_add("every", everyPass, 0));
+  CHECK(Scheduler_add("slow", every100, 100));
+
+  runFor(1000, 1);
+  CHECK_EQ(everyRuns.size(), 1000);
+  CHECK_EQ(slowRuns.size(), 9);       // 5100 ... 5900
+  CHECK_EQ(slowRuns[0], 5100);   // ครบ 100 ms หลัง add ไม่ใช่ทันที
+  bool spaced = true;
+  for (size_t i = 1; i < slowRuns.size(); i++) {
+    spaced = spaced && slowRuns[i] - slowRuns[i - 1] == 100;
+  }
+  CHECK(spaced);
+
+  // loop() ค้าง 350 ms → ทำครั้งเดียว แล้วนับใหม่จากเวลาที่ทำจริง
+  Host_advanceMillis(350);
+  size_t before = slowRuns.size();
+  runFor(1, 1);
+  CHECK_EQ(slowRuns.size(), before + 1);
+  unsigned long late = slowRuns.back();
+  runFor(99, 1);
+  CHECK_EQ(slowRuns.size(), before + 1);
+  runFor(1, 1);
+  CHECK_EQ(slowRuns.size(), before + 2);
+  CHECK_EQ(slowRuns.back() - late, 100);
+
+  // loop() ถี่น้อยกว่า interval (step 30 ms) → ห่างกันไม่น้อยกว่า 100 ms
+  before = slowRuns.size();
+  runFor(3000, 30);
+  bool atLeast = true;
+  for (size_t i = before + 1; i < slowRuns.size(); i++) {
+    atLeast = atLeast && slowRuns[i] - slowRuns[i - 1] >= 100 && slowRuns[i] - slowRuns[i - 1] < 130;
+  }
+  CHECK(atLeast);
+  CHECK(slowRuns.size() - before >= 3000 / 120 - 1);   // ทุก 120 ms (ปัดขึ้นเป็นจังหวะของ loop)
+}
+
+// ===== งานที่ใช้เวลานาน =====
+static void testRunTime() {
+  resetScheduler(10000);
+  CHECK(Scheduler_add("busy", busyTask, 0));
+  CHECK(Scheduler_add("after", afterBusy, 0));
+
+  busyMs = 3;
+  runFor(10, 1);
+  busyMs = 25;
+  runFor(1, 1);
+  busyMs = 0;
+  runFor(10, 1);
+
+  CHECK_EQ(schedulerTasks[0].maxRunTime, 25);
+  CHECK_EQ(schedulerTasks[1].maxRunTime, 0);
+  // รอบที่ busy ใช้ 25 ms → after ได้ now หลังจากนั้น
+  bool sawLateNow = false;
+  for (size_t i = 0; i < afterBusyRuns.size(); i++) {
+    sawLateNow = sawLateNow || afterBusyRuns[i] - (i == 0 ? 10000 : afterBusyRuns[i - 1]) >= 25;
+  }
+  CHECK(sawLateNow);
+}
+
+// ===== millis() วนรอบ =====
+static void testMillisWrap() {
+  resetScheduler(0x100000000ULL - 250);   // millis() = 2^32 - 250
+  CHECK(Scheduler_add("slow", every100, 100));
+
+  runFor(600, 1);
+  CHECK_EQ(slowRuns.size(), 5);       // -150, -50, 50, 150, 250 รอบ 0
+  bool spaced = true;
+  for (size_t i = 1; i < slowRuns.size(); i++) {
+    spaced = spaced && (uint32_t)(slowRuns[i] - slowRuns[i - 1]) == 100;
+  }
+  CHECK(spaced);
+  CHECK(slowRuns.back() < 1000);   // ข้าม 0 แล้ว
+}
+
+// ===== เต็ม =====
+static void testCapacity() {
+  resetScheduler(0);
+  for (int i = 0; i < SCHEDULER_MAX_TASKS; i++) {
+    CHECK(Scheduler_add("every", everyPass, 0));
+  }
+  CHECK(!Scheduler_add("extra", every100, 0));
+  CHECK_EQ(schedulerTaskCount, SCHEDULER_MAX_TASKS);
+  runFor(1, 1);
+  CHECK_EQ(everyRuns.size(), SCHEDULER_MAX_TASKS);
+}
+
+int main() {
+  testIntervals();
+  testRunTime();
+  testMillisWrap();
+  testCapacity();
+  return HostCheck_finish("scheduler");
+}
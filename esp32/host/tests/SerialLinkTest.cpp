@@ -0,0 +1,226 @@
+/**
+ * SerialLinkTest.cpp - frame แบบ COBS + CRC16 ระหว่าง Center กับ PC (center/SerialLink.h)
+ *
+ * ฝั่ง PC ในที่นี้ = แยก output ของ Serial ด้วย 0x00 แล้ว decode เอง / ACK-NACK ป้อนด้วย Serial.inject()
+ * - DATA/HELLO decode กลับได้ payload เดิม (รวม byte 0x00 และ block ยาวเกิน 254) และ crc ตรง
+ * - ขยะ/frame เสียก่อน frame จริง → นับเป็น bad frame แล้ว frame ถัดไปใช้ได้ (resync ที่ 0x00)
+ * - ACK/NACK ที่ boot ไม่ตรง (ค้างจากก่อน reboot) ถูกข้ามและนับใน serialLinkStaleFrames
+ */
+
+#include "HostCheck.h"
+#include "SerialLink.h"
+
+#include <string>
+#include <vector>
+
+struct DecodedFrame {
+  uint8_t type;
+  uint16_t boot;
+  uint32_t seq;
+  std::string payload;
+};
+
+// แยก output ของ Center เป็น frame (ข้ามส่วนที่ decode/crc ไม่ผ่าน → นับใน bad)
+static std::vector<DecodedFrame> takeFrames(int* bad = nullptr) {
+  std::string out = Serial.takeOutput();
+  std::vector<DecodedFrame> frames;
+  size_t start = 0;
+  while (start < out.size()) {
+    size_t end = out.find('\0', start);
+    if (end == std::string::npos) {
+      end = out.size();
+    }
+    if (end > start) {
+      std::vector<uint8_t> data(out.begin() + start, out.begin() + end);
+      int length = SerialLink_decodeCobs(data.data(), data.size());
+      if (length < SERIAL_LINK_OVERHEAD ||
+          Wire_get16(&data[length - 2]) != Wire_crc16(data.data(), length - 2)) {
+        if (bad != nullptr) {
+          (*bad)++;
+        }
+      } else {
+        DecodedFrame frame;
+        frame.type = data[0];
+        frame.boot = Wire_get16(&data[1]);
+        frame.seq = Wire_get32(&data[3]);
+        frame.payload.assign((const char*)&data[SERIAL_LINK_HEADER_SIZE], length - SERIAL_LINK_OVERHEAD);
+        frames.push_back(frame);
+      }
+    }
+    start = end + 1;
+  }
+  return frames;
+}
+
+// frame จาก PC (encode ด้วย SerialLink_writeCobs แล้วย้ายจาก output ไป input)
+static std::string makeFrame(uint8_t type, uint16_t boot, uint32_t seq) {
+  uint8_t header[SERIAL_LINK_HEADER_SIZE];
+  header[0] = type;
+  Wire_put16(header + 1, boot);
+  Wire_put32(header + 3, seq);
+  uint8_t crc[2];
+  Wire_put16(crc, Wire_crc16(header, sizeof(header)));
+
+  std::string pending = Serial.takeOutput();
+  SerialLink_writeCobs(header, sizeof(header), nullptr, 0, crc, 2);
+  std::string frame = Serial.takeOutput();
+  Serial.print(pending.c_str());
+  return frame;
+}
+
+static void injectAndPoll(const std::string& bytes) {
+  Serial.inject((const uint8_t*)bytes.data(), bytes.size());
+  SerialLink_poll();
+}
+
+static void restart() {
+  Serial.takeOutput();
+  serialLinkPeerActive = false;
+  serialLinkProbeCount = 0;
+  serialLinkRxLength = 0;
+  serialLinkRxOverflow = false;
+  serialLinkBadFrames = 0;
+  serialLinkStaleFrames = 0;
+  serialLinkNackMissed = 0;
+  serialLinkRetransmits = 0;
+  memset(serialLinkRing, 0, sizeof(serialLinkRing));
+  SerialLink_begin();
+}
+
+// ===== CRC-16/CCITT-FALSE (ค่าตรวจมาตรฐาน) =====
+static void testCrc16() {
+  CHECK_EQ(Wire_crc16((const uint8_t*)"123456789", 9), 0x29B1);
+  uint16_t split = Wire_crc16((const uint8_t*)"6789", 4, Wire_crc16((const uint8_t*)"12345", 5));
+  CHECK_EQ(split, 0x29B1);
+}
+
+// ===== HELLO + DATA decode กลับได้ตรง =====
+static void testRoundTrip() {
+  restart();
+  std::vector<DecodedFrame> frames = takeFrames();
+  CHECK_EQ(frames.size(), 1);
+  if (frames.size() == 1) {
+    CHECK_EQ(frames[0].type, SERIAL_FRAME_HELLO);
+    CHECK_EQ(frames[0].boot, serialLinkBoot);
+    CHECK_EQ(frames[0].seq, 0);
+    CHECK(frames[0].payload.empty());
+  }
+  CHECK(serialLinkBoot != 0);
+
+  std::string json = "{\"type\":\"BP\",\"sys\":120}";
+  std::string zeros("a\0\0b\0", 5);
+  std::string longRun(SERIAL_LINK_PAYLOAD_SIZE, 'x');   // หลาย block ของ COBS (254)
+  longRun[300] = '\0';
+  CHECK(SerialLink_send(json.data(), json.size()));
+  CHECK(SerialLink_send(zeros.data(), zeros.size()));
+  CHECK(SerialLink_send(longRun.data(), longRun.size()));
+  CHECK(!SerialLink_send(longRun.data(), SERIAL_LINK_PAYLOAD_SIZE + 1));
+
+  int bad = 0;
+  frames = takeFrames(&bad);
+  CHECK_EQ(bad, 0);
+  CHECK_EQ(frames.size(), 3);
+  if (frames.size() == 3) {
+    CHECK_EQ(frames[0].type, SERIAL_FRAME_DATA);
+    CHECK_EQ(frames[0].seq, 1);
+    CHECK(frames[0].payload == json);
+    CHECK_EQ(frames[1].seq, 2);
+    CHECK(frames[1].payload == zeros);
+    CHECK_EQ(frames[2].seq, 3);
+    CHECK(frames[2].payload == longRun);
+  }
+  CHECK_EQ(SerialLink_getPendingCount(), 3);
+}
+
+// ===== ขยะ / frame เสีย → ข้าม แล้ว ACK ถัดไปใช้ได้ =====
+static void testResync() {
+  restart();
+  const char* body = "{\"n\":1}";
+  SerialLink_send(body, strlen(body));
+  SerialLink_send(body, strlen(body));
+  Serial.takeOutput();
+
+  std::string ack = makeFrame(SERIAL_FRAME_ACK, serialLinkBoot, 1);
+  injectAndPoll("[DEBUG] boot ok\r\n" + ack);
+  CHECK_EQ(serialLinkBadFrames, 1);
+  CHECK_EQ(serialLinkAckedSeq, 1);
+
+  // ขยะยาวเกิน buffer รับ → ทิ้งทั้งก้อน (ไม่นับเป็น bad frame)
+  injectAndPoll(std::string(SERIAL_LINK_RX_SIZE * 3, 'z') + makeFrame(SERIAL_FRAME_ACK, serialLinkBoot, 2));
+  CHECK_EQ(serialLinkBadFrames, 1);
+  CHECK_EQ(serialLinkAckedSeq, 2);
+
+  // byte เสียกลาง frame → crc ไม่ตรง
+  SerialLink_send(body, strlen(body));
+  Serial.takeOutput();
+  std::string broken = makeFrame(SERIAL_FRAME_ACK, serialLinkBoot, 3);
+  broken[broken.size() - 3] ^= 0x40;
+  injectAndPoll(broken);
+  CHECK_EQ(serialLinkBadFrames, 2);
+  CHECK_EQ(serialLinkAckedSeq, 2);
+
+  // ACK เกิน seq ที่ส่งไป → ไม่ใช้
+  injectAndPoll(makeFrame(SERIAL_FRAME_ACK, serialLinkBoot, 9));
+  CHECK_EQ(serialLinkAckedSeq, 2);
+  CHECK_EQ(SerialLink_getPendingCount(), 1);
+}
+
+// ===== ACK/NACK ของ boot ก่อนหน้า → ข้าม =====
+static void testStaleBoot() {
+  restart();
+  const char* body = "{\"n\":2}";
+  SerialLink_send(body, strlen(body));
+  SerialLink_send(body, strlen(body));
+  Serial.takeOutput();
+
+  uint16_t oldBoot = serialLinkBoot ^ 0x5A5A;
+  injectAndPoll(makeFrame(SERIAL_FRAME_ACK, oldBoot, 2));
+  injectAndPoll(makeFrame(SERIAL_FRAME_NACK, oldBoot, 1));
+  CHECK_EQ(serialLinkStaleFrames, 2);
+  CHECK_EQ(serialLinkAckedSeq, 0);
+  CHECK_EQ(serialLinkRetransmits, 0);
+  CHECK(takeFrames().empty());
+
+  injectAndPoll(makeFrame(SERIAL_FRAME_ACK, serialLinkBoot, 2));
+  CHECK_EQ(serialLinkAckedSeq, 2);
+}
+
+// ===== NACK → ส่งซ้ำจาก ring / ไม่มี ACK ใหม่นาน → ส่งตัวแรกที่ค้างซ้ำ =====
+static void testRetransmit() {
+  restart();
+  std::string bodies[3] = { "{\"n\":1}", "{\"n\":2}", "{\"n\":3}" };
+  for (int i = 0; i < 3; i++) {
+    SerialLink_send(bodies[i].data(), bodies[i].size());
+  }
+  Serial.takeOutput();
+
+  injectAndPoll(makeFrame(SERIAL_FRAME_NACK, serialLinkBoot, 2));
+  std::vector<DecodedFrame> frames = takeFrames();
+  CHECK_EQ(frames.size(), 1);
+  if (frames.size() == 1) {
+    CHECK_EQ(frames[0].seq, 2);
+    CHECK(frames[0].payload == bodies[1]);
+  }
+
+  injectAndPoll(makeFrame(SERIAL_FRAME_NACK, serialLinkBoot, 3 + SERIAL_LINK_RING_SIZE));
+  CHECK_EQ(serialLinkNackMissed, 1);
+  CHECK(takeFrames().empty());
+
+  injectAndPoll(makeFrame(SERIAL_FRAME_ACK, serialLinkBoot, 1));
+  Host_advanceMillis(SERIAL_LINK_RETRANSMIT_TIMEOUT + 1);
+  SerialLink_poll();
+  frames = takeFrames();
+  CHECK_EQ(frames.size(), 1);
+  if (frames.size() == 1) {
+    CHECK_EQ(frames[0].seq, 2);
+  }
+}
+
+int main() {
+  testCrc16();
+  testRoundTrip();
+  testResync();
+  testStaleBoot();
+  testRetransmit();
+  return HostCheck_finish("serial link");
+}
@@ -0,0 +1,186 @@
+/**
+ * SpscQueueTest.cpp - คิว single-producer / single-consumer แบบไม่มี lock ภายใต้ 2 thread จริง
+ *
+ * FrameQueue.h (task รับ UART → loop()), center/Inbox.h (network task → loop()), center/StationEvents.h
+ * (WiFi event → loop()): producer กับ consumer อยู่คนละ thread พร้อมกัน
+ * - consumer ได้ทุก item ครบ เรียงตามลำดับ ไม่หาย ไม่ซ้ำ และข้อมูลใน slot ตรงกับที่ producer เขียน
+ * - คิวเต็ม → push คืน false (producer ลองใหม่) นับใน dropped ตรงกับจำนวนที่ producer เห็น
+ * - head/tail เริ่มใกล้ 2^32 → ผ่านจุดที่ index วนรอบ uint32 ระหว่างทดสอบ
+ *
+ * ผลขึ้นกับจังหวะของ thread (ไม่ deterministic) แต่ต้องผ่านทุกครั้ง - ล้มแม้ครั้งเดียว = barrier ผิด
+ */
+
+#include "HostCheck.h"
+#include "FrameQueue.h"
+#include "Inbox.h"
+#include "StationEvents.h"
+
+#include <thread>
+
+#define SPSC_ITEMS 200000
+#define SPSC_WRAP_START 0xFFFFFF00u   // วนรอบ uint32 หลัง 256 item
+
+// ข้อมูลของ item ที่ n: ความยาวและเนื้อหาเปลี่ยนตาม n (ตรวจว่าไม่ได้ slot ของ item อื่น)
+static size_t fillPayload(uint32_t n, char* out, size_t capacity) {
+  size_t length = 8 + n % (capacity - 8);
+  for (size_t i = 0; i < length; i++) {
+    out[i] = (char)('A' + (n + i) % 26);
+  }
+  memcpy(out, &n, sizeof(n));
+  return length;
+}
+
+struct SpscResult {
+  uint32_t received;
+  uint32_t outOfOrder;     // ได้ item ไม่ตรงลำดับ (หาย/ซ้ำ/สลับ)
+  uint32_t corrupt;        // เนื้อหาไม่ตรงกับ item ที่ควรเป็น
+  uint32_t producerFull;   // push ไม่ผ่านเพราะคิวเต็ม
+};
+
+// ===== FrameQueue =====
+static FrameQueue frameQueue;
+
+static void testFrameQueue() {
+  FrameQueue_begin(frameQueue);
+  frameQueue.head = SPSC_WRAP_START;
+  frameQueue.tail = SPSC_WRAP_START;
+  SpscResult result = { 0, 0, 0, 0 };
+
+  std::thread producer([&result]() {
+    char payload[FRAME_QUEUE_SLOT_SIZE];
+    for (uint32_t n = 0; n < SPSC_ITEMS; n++) {
+      size_t length = fillPayload(n, payload, 64);
+      while (!FrameQueue_push(frameQueue, payload, length, n, n + 1)) {
+        result.producerFull++;
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  char expected[FRAME_QUEUE_SLOT_SIZE];
+  while (result.received < SPSC_ITEMS) {
+    QueuedFrame* frame = FrameQueue_peek(frameQueue);
+    if (frame == nullptr) {
+      std::this_thread::yield();
+      continue;
+    }
+    uint32_t n = result.received;
+    size_t length = fillPayload(n, expected, 64);
+    if (frame->startedAt != n) {
+      result.outOfOrder++;
+    } else if (frame->length != length || frame->completedAt != n + 1 ||
+               memcmp(frame->data, expected, length) != 0 || frame->data[length] != '\0') {
+      result.corrupt++;
+    }
+    FrameQueue_pop(frameQueue);
+    result.received++;
+  }
+  producer.join();
+
+  CHECK_EQ(result.received, SPSC_ITEMS);
+  CHECK_EQ(result.outOfOrder, 0);
+  CHECK_EQ(result.corrupt, 0);
+  CHECK_EQ(FrameQueue_size(frameQueue), 0);
+  CHECK(FrameQueue_peek(frameQueue) == nullptr);
+  CHECK_EQ(frameQueue.droppedCount, result.producerFull);
+  CHECK(frameQueue.highWater >= 1 && frameQueue.highWater <= FRAME_QUEUE_SLOTS);
+  CHECK_EQ(frameQueue.head, (uint32_t)(SPSC_WRAP_START + SPSC_ITEMS));
+}
+
+// ===== Inbox =====
+static void testInbox() {
+  inboxHead = SPSC_WRAP_START;
+  inboxTail = SPSC_WRAP_START;
+  inboxDroppedCount = 0;
+  inboxHighWater = 0;
+  SpscResult result = { 0, 0, 0, 0 };
+
+  std::thread producer([&result]() {
+    char body[INBOX_BODY_SIZE];
+    for (uint32_t n = 0; n < SPSC_ITEMS; n++) {
+      size_t length = fillPayload(n, body, 96);
+      while (!Inbox_push(n % 2 == 0 ? INBOX_VITALS : INBOX_STATUS, n, body, length)) {
+        result.producerFull++;
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  char expected[INBOX_BODY_SIZE];
+  while (result.received < SPSC_ITEMS) {
+    InboxItem* item = Inbox_peek();
+    if (item == nullptr) {
+      std::this_thread::yield();
+      continue;
+    }
+    uint32_t n = result.received;
+    size_t length = fillPayload(n, expected, 96);
+    if (item->remoteIP != n) {
+      result.outOfOrder++;
+    } else if (item->kind != (n % 2 == 0 ? INBOX_VITALS : INBOX_STATUS) || item->length != length ||
+               memcmp(item->body, expected, length) != 0 || item->body[length] != '\0') {
+      result.corrupt++;
+    }
+    Inbox_pop();
+    result.received++;
+  }
+  producer.join();
+
+  CHECK_EQ(result.received, SPSC_ITEMS);
+  CHECK_EQ(result.outOfOrder, 0);
+  CHECK_EQ(result.corrupt, 0);
+  CHECK_EQ(Inbox_size(), 0);
+  CHECK_EQ(Inbox_getDroppedCount(), result.producerFull);
+  CHECK(Inbox_getHighWater() >= 1 && Inbox_getHighWater() <= INBOX_CAPACITY);
+}
+
+// ===== StationEvents =====
+static void testStationEvents() {
+  stationEventsHead = SPSC_WRAP_START;
+  stationEventsTail = SPSC_WRAP_START;
+  stationEventsDropped = 0;
+  SpscResult result = { 0, 0, 0, 0 };
+
+  std::thread producer([&result]() {
+    for (uint32_t n = 0; n < SPSC_ITEMS; n++) {
+      uint8_t mac[6] = { 0x24, 0x6F, 0, 0, 0, 0 };
+      memcpy(mac + 2, &n, sizeof(n));
+      while (!StationEvents_push(mac, n % 3 != 0)) {
+        result.producerFull++;
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  while (result.received < SPSC_ITEMS) {
+    StationEvent event;
+    if (!StationEvents_pop(event)) {
+      std::this_thread::yield();
+      continue;
+    }
+    uint32_t n = result.received;
+    uint32_t got;
+    memcpy(&got, event.mac + 2, sizeof(got));
+    if (got != n) {
+      result.outOfOrder++;
+    } else if (event.mac[0] != 0x24 || event.mac[1] != 0x6F || event.connected != (n % 3 != 0)) {
+      result.corrupt++;
+    }
+    result.received++;
+  }
+  producer.join();
+
+  CHECK_EQ(result.received, SPSC_ITEMS);
+  CHECK_EQ(result.outOfOrder, 0);
+  CHECK_EQ(result.corrupt, 0);
+  CHECK_EQ(stationEventsDropped, result.producerFull);
+  StationEvent event;
+  CHECK(!StationEvents_pop(event));
+}
+
+int main() {
+  testFrameQueue();
+  testInbox();
+  testStationEvents();
+  return HostCheck_finish("spsc_queue");
+}
@@ -0,0 +1,173 @@
+/**
+ * StabilityDetectorTest.cpp - ค่านิ่งของเครื่องชั่ง (ESP32_RS232/StabilityDetector.h)
+ *
+ * ป้อน W/H ทุก 200 ms แบบเครื่องชั่งที่ส่งต่อเนื่อง
+ * - ค่าแกว่งตอนก้าวขึ้น → ยังไม่ส่ง / นิ่งครบ STABILITY_DWELL → SETTLED ครั้งเดียวต่อคน
+ * - ก้าวลง (W ≤ STABILITY_ZERO) หรือเงียบเกิน STABILITY_QUIET → คนถัดไปส่งได้อีก
+ * - ไม่เคยนิ่ง → ABANDONED / เครื่องที่ส่งครั้งเดียวต่อคน → SETTLED ตอน poll
+ */
+
+#include "HostCheck.h"
+#include "StabilityDetector.h"
+
+#define SAMPLE_MS 200
+
+struct Scale {
+  StabilitySession session;
+  uint32_t now = 1000;
+  int settled = 0;
+  int abandoned = 0;
+  int16_t weight = 0;
+  int16_t height = 0;
+};
+
+static StabilityResult sample(Scale& s, int16_t weightTenths, int16_t heightTenths) {
+  s.now += SAMPLE_MS;
+  int16_t weight, height;
+  StabilityResult result = Stability_add(s.session, weightTenths, heightTenths, s.now, weight, height);
+  if (result == STABILITY_SETTLED) {
+    s.settled++;
+    s.weight = weight;
+    s.height = height;
+  } else if (result == STABILITY_ABANDONED) {
+    s.abandoned++;
+  }
+  return result;
+}
+
+// ===== running mean / SD =====
+static void testWindow() {
+  StabilityWindow w;
+  StabilityWindow_reset(w);
+  CHECK(!StabilityWindow_isSteady(w, 1));
+  CHECK_EQ(StabilityWindow_mean(w), 0);
+
+  StabilityWindow_add(w, 2);
+  StabilityWindow_add(w, 3);
+  CHECK_EQ(StabilityWindow_mean(w), 3);       // 2.5 ปัดขึ้น
+  StabilityWindow_reset(w);
+  StabilityWindow_add(w, -2);
+  StabilityWindow_add(w, -3);
+  CHECK_EQ(StabilityWindow_mean(w), -3);
+
+  // SD ของ {700 ± 2} = 2 → นิ่ง / {700 ± 3} = 3 → ไม่นิ่ง
+  StabilityWindow_reset(w);
+  for (int i = 0; i < STABILITY_WINDOW; i++) {
+    StabilityWindow_add(w, i % 2 ? 702 : 698);
+  }
+  CHECK(StabilityWindow_isSteady(w, STABILITY_WINDOW));
+  CHECK(!StabilityWindow_isSteady(w, STABILITY_WINDOW + 1));
+  CHECK_EQ(StabilityWindow_mean(w), 700);
+  for (int i = 0; i < STABILITY_WINDOW; i++) {
+    StabilityWindow_add(w, i % 2 ? 703 : 697);
+  }
+  CHECK(!StabilityWindow_isSteady(w, STABILITY_WINDOW));
+  CHECK_EQ(w.count, STABILITY_WINDOW);
+
+  // ค่าใหญ่สุดของ int16 ไม่ล้น
+  StabilityWindow_reset(w);
+  for (int i = 0; i < STABILITY_WINDOW; i++) {
+    StabilityWindow_add(w, 32767);
+  }
+  CHECK(StabilityWindow_isSteady(w, STABILITY_WINDOW));
+  CHECK_EQ(StabilityWindow_mean(w), 32767);
+}
+
+// ===== ก้าวขึ้น → แกว่ง → นิ่ง → ส่งครั้งเดียว → ก้าวลง → คนถัดไป =====
+static void testSettleOncePerPerson() {
+  Scale s;
+  Stability_begin(s.session);
+
+  int16_t swing[] = { 420, 810, 655, 731, 689, 712 };
+  for (int16_t w : swing) {
+    CHECK_EQ(sample(s, w, 1735), STABILITY_NONE);
+  }
+
+  // นิ่ง: ต้องเต็ม window ก่อน แล้วนิ่งต่ออีก STABILITY_DWELL
+  uint32_t steadyFrom = 0;
+  for (int i = 0; i < 30 && s.settled == 0; i++) {
+    sample(s, i % 2 ? 704 : 702, i % 3 ? 1735 : 1736);
+    if (i == STABILITY_WINDOW - 1) {
+      steadyFrom = s.now;
+    }
+  }
+  CHECK_EQ(s.settled, 1);
+  CHECK(steadyFrom != 0);
+  CHECK_EQ(s.now - steadyFrom, STABILITY_DWELL);
+  CHECK_EQ(s.weight, 703);
+  CHECK_EQ(s.height, 1735);
+
+  // ยังยืนอยู่ → ไม่ส่งซ้ำ
+  for (int i = 0; i < 20; i++) {
+    CHECK_EQ(sample(s, 703, 1735), STABILITY_NONE);
+  }
+
+  // ก้าวลง → จบ session (ส่งแล้ว ไม่ใช่ ABANDONED)
+  CHECK_EQ(sample(s, 0, 0), STABILITY_NONE);
+  CHECK_EQ(s.abandoned, 0);
+
+  // คนถัดไป
+  for (int i = 0; i < 30 && s.settled == 1; i++) {
+    sample(s, 551, 1620);
+  }
+  CHECK_EQ(s.settled, 2);
+  CHECK_EQ(s.weight, 551);
+  CHECK_EQ(s.session.settledCount, 2);
+}
+
+// ===== ไม่เคยนิ่ง → ABANDONED =====
+static void testAbandoned() {
+  Scale s;
+  Stability_begin(s.session);
+
+  for (int i = 0; i < 20; i++) {
+    CHECK_EQ(sample(s, i % 2 ? 650 : 720, 1700), STABILITY_NONE);
+  }
+  CHECK_EQ(sample(s, 5, 0), STABILITY_ABANDONED);
+  CHECK_EQ(s.session.abandonedCount, 1);
+
+  // W ≤ STABILITY_ZERO ตอนไม่มี session → ไม่นับ
+  CHECK_EQ(sample(s, 0, 0), STABILITY_NONE);
+  CHECK_EQ(s.session.abandonedCount, 1);
+
+  // เงียบเกิน STABILITY_QUIET หลังแกว่ง → poll ได้ ABANDONED
+  sample(s, 650, 1700);
+  sample(s, 720, 1700);
+  int16_t weight, height;
+  CHECK_EQ(Stability_poll(s.session, s.now + STABILITY_QUIET - 1, weight, height), STABILITY_NONE);
+  CHECK_EQ(Stability_poll(s.session, s.now + STABILITY_QUIET, weight, height), STABILITY_ABANDONED);
+  CHECK_EQ(Stability_poll(s.session, s.now + 2 * STABILITY_QUIET, weight, height), STABILITY_NONE);
+}
+
+// ===== เครื่องที่ส่งครั้งเดียวต่อคน / sample ห่างเกิน STABILITY_QUIET =====
+static void testQuietDevices() {
+  Scale s;
+  Stability_begin(s.session);
+  int16_t weight = 0, height = 0;
+
+  CHECK_EQ(sample(s, 688, 1701), STABILITY_NONE);
+  CHECK_EQ(Stability_poll(s.session, s.now + STABILITY_QUIET, weight, height), STABILITY_SETTLED);
+  CHECK_EQ(weight, 688);
+  CHECK_EQ(height, 1701);
+  CHECK_EQ(s.session.lastSample, 0);
+
+  // ไม่ได้ poll ระหว่างสองคน → sample ที่ห่างเกิน STABILITY_QUIET ถือเป็นคนใหม่
+  for (int i = 0; i < 30 && s.settled == 0; i++) {
+    sample(s, 700, 1700);
+  }
+  CHECK_EQ(s.settled, 1);
+  s.now += STABILITY_QUIET;
+  for (int i = 0; i < 30 && s.settled == 1; i++) {
+    sample(s, 800, 1800);
+  }
+  CHECK_EQ(s.settled, 2);
+  CHECK_EQ(s.weight, 800);
+}
+
+int main() {
+  testWindow();
+  testSettleOncePerPerson();
+  testAbandoned();
+  testQuietDevices();
+  return HostCheck_finish("stability detector");
+}
@@ -0,0 +1,134 @@
+/**
+ * WeightParserTest.cpp - แยกค่าจากบรรทัด Text ของเครื่องชั่ง (ESP32_RS232/WeightParser.h)
+ *
+ * - Weight_parseTenths: ทศนิยม 0/1/2 ตำแหน่ง, ไม่มีทศนิยม, ติดลบ, เกิน int16 → ไม่รับ
+ * - Weight_tokenizeLine: W:/H:/Txxx$ ในบรรทัดเดียวหรือแยกบรรทัด, หน่วย/ขยะต่อท้าย,
+ *   token ที่คล้ายแต่ไม่ใช่ (T ไม่มี $, W: ไม่มีตัวเลข) ไม่ทับค่าที่อ่านได้แล้ว
+ */
+
+#include "HostCheck.h"
+#include "WeightParser.h"
+
+// คืนค่าหน่วย 0.1 / -99999 = ไม่รับ
+static long parse(const char* text, int* used = nullptr) {
+  int16_t tenths = 0;
+  int n = Weight_parseTenths(text, tenths);
+  if (used != nullptr) {
+    *used = n;
+  }
+  return n > 0 ? tenths : -99999;
+}
+
+static WeightReading emptyReading() {
+  WeightReading reading = { 0, 0, 0, 0 };
+  return reading;
+}
+
+static void testParseTenths() {
+  int used;
+  CHECK_EQ(parse("070.3", &used), 703);
+  CHECK_EQ(used, 5);
+  CHECK_EQ(parse("173"), 1730);              // ไม่มีทศนิยม
+  CHECK_EQ(parse("70."), 700);               // มี '.' แต่ไม่มีตัวเลขตามหลัง
+  CHECK_EQ(parse(".5"), 5);
+  CHECK_EQ(parse("65.25", &used), 652);      // ตัดตำแหน่งที่ 2 ทิ้ง (ไม่ปัด) แต่อ่านข้ามไปทั้งหมด
+  CHECK_EQ(used, 5);
+  CHECK_EQ(parse("0"), 0);
+  CHECK_EQ(parse("12.3kg", &used), 123);     // หยุดที่หน่วย
+  CHECK_EQ(used, 4);
+  CHECK_EQ(parse("1.2.3", &used), 12);       // '.' ที่สองไม่ใช่ตัวเลข
+  CHECK_EQ(used, 3);
+}
+
+static void testParseSign() {
+  int used;
+  CHECK_EQ(parse("-0.5", &used), -5);
+  CHECK_EQ(used, 4);
+  CHECK_EQ(parse("-12"), -120);
+  CHECK_EQ(parse("-.5"), -5);
+  CHECK_EQ(parse("-"), -99999);
+  CHECK_EQ(parse("- 5"), -99999);
+  CHECK_EQ(parse("--5"), -99999);
+}
+
+static void testParseOverflow() {
+  CHECK_EQ(parse("3276.7"), 32767);
+  CHECK_EQ(parse("-3276.7"), -32767);
+  CHECK_EQ(parse("3276.8"), -99999);
+  CHECK_EQ(parse("3277"), -99999);          // 32770 หลังคูณ 10
+  CHECK_EQ(parse("99999999999999999999"), -99999);
+  CHECK_EQ(parse(""), -99999);
+  CHECK_EQ(parse("."), -99999);
+  CHECK_EQ(parse("abc"), -99999);
+}
+
+static void testTokenizeLine() {
+  WeightReading reading = emptyReading();
+  CHECK_EQ(Weight_tokenizeLine("W:070.3 H:173.5", reading), WEIGHT_FIELD_WEIGHT | WEIGHT_FIELD_HEIGHT);
+  CHECK_EQ(reading.weightTenths, 703);
+  CHECK_EQ(reading.heightTenths, 1735);
+
+  reading = emptyReading();
+  CHECK_EQ(Weight_tokenizeLine("T365$", reading), WEIGHT_FIELD_TEMP);
+  CHECK_EQ(reading.tempTenths, 365);
+
+  // ช่องว่างหลัง ':' / หน่วยต่อท้าย / ลำดับสลับ
+  reading = emptyReading();
+  CHECK_EQ(Weight_tokenizeLine("H: 160.0cm  W: 55.2kg T362$", reading),
+           WEIGHT_FIELD_WEIGHT | WEIGHT_FIELD_HEIGHT | WEIGHT_FIELD_TEMP);
+  CHECK_EQ(reading.weightTenths, 552);
+  CHECK_EQ(reading.heightTenths, 1600);
+  CHECK_EQ(reading.tempTenths, 362);
+
+  reading = emptyReading();
+  CHECK_EQ(Weight_tokenizeLine("W:-0.4 H:0", reading), WEIGHT_FIELD_WEIGHT | WEIGHT_FIELD_HEIGHT);
+  CHECK_EQ(reading.weightTenths, -4);
+  CHECK_EQ(reading.heightTenths, 0);
+}
+
+// W กับ H มาคนละบรรทัด → fields สะสมใน reading เดียว
+static void testSplitLines() {
+  WeightReading reading = emptyReading();
+  CHECK_EQ(Weight_tokenizeLine("W:070.3", reading), WEIGHT_FIELD_WEIGHT);
+  CHECK_EQ(Weight_tokenizeLine("H:173.5", reading), WEIGHT_FIELD_HEIGHT);
+  CHECK_EQ(reading.fields, WEIGHT_FIELD_WEIGHT | WEIGHT_FIELD_HEIGHT);
+  CHECK_EQ(reading.weightTenths, 703);
+  CHECK_EQ(reading.heightTenths, 1735);
+
+  // บรรทัดถูกตัดกลาง token (เช่น LineFramer ล้น) → ไม่ได้ค่า ไม่ทับค่าเดิม
+  CHECK_EQ(Weight_tokenizeLine("W:", reading), 0);
+  CHECK_EQ(Weight_tokenizeLine("T36", reading), 0);
+  CHECK_EQ(reading.weightTenths, 703);
+}
+
+static void testJunkTokens() {
+  WeightReading reading = emptyReading();
+  CHECK_EQ(Weight_tokenizeLine("", reading), 0);
+  CHECK_EQ(Weight_tokenizeLine("STABLE GROSS", reading), 0);     // 'T' ไม่ตามด้วยตัวเลข
+  CHECK_EQ(Weight_tokenizeLine("W:abc H:--", reading), 0);
+  CHECK_EQ(Weight_tokenizeLine("T3$", reading), 0);              // ต้องอย่างน้อย 2 หลัก
+  CHECK_EQ(Weight_tokenizeLine("T365", reading), 0);             // ไม่มี '$'
+  CHECK_EQ(Weight_tokenizeLine("T123456$", reading), 0);         // เกิน 5 หลัก
+  CHECK_EQ(Weight_tokenizeLine("T99999$", reading), 0);          // เกิน int16
+  CHECK_EQ(Weight_tokenizeLine("W:9999.9", reading), 0);
+  CHECK_EQ(reading.fields, 0);
+
+  // ขยะก่อน/หลัง token จริง
+  CHECK_EQ(Weight_tokenizeLine("\x02##W:070.3##\x03", reading), WEIGHT_FIELD_WEIGHT);
+  CHECK_EQ(reading.weightTenths, 703);
+  CHECK_EQ(Weight_tokenizeLine("TEMP T372$ OK", reading), WEIGHT_FIELD_TEMP);
+  CHECK_EQ(reading.tempTenths, 372);
+  CHECK_EQ(Weight_tokenizeLine("WW:1.0 HH:2.0", reading), WEIGHT_FIELD_WEIGHT | WEIGHT_FIELD_HEIGHT);
+  CHECK_EQ(reading.weightTenths, 10);
+  CHECK_EQ(reading.heightTenths, 20);
+}
+
+int main() {
+  testParseTenths();
+  testParseSign();
+  testParseOverflow();
+  testTokenizeLine();
+  testSplitLines();
+  testJunkTokens();
+  return HostCheck_finish("weight_parser");
+}
@@ -0,0 +1,217 @@
+/**
+ * WireProtocolTest.cpp - frame Binary ระหว่าง Device กับ Center (WireProtocol.h)
+ *
+ * - CRC-16/CCITT-FALSE ตรงค่ามาตรฐาน ("123456789" → 0x29B1) และต่อข้าม buffer ได้
+ * - READING/HELLO/ACK/HEARTBEAT encode → parse → decode ได้ค่าเดิม (ค่าติดลบ, idcard 13 หลัก)
+ * - CRC ไม่ตรง / magic หรือ version อื่น / frame สั้นหรือถูกตัด → -1 (ไม่อ่าน header)
+ * - payload ขนาดผิดของแต่ละชนิด / kind ที่ไม่รู้จัก → decode ไม่ผ่าน
+ */
+
+#include "HostCheck.h"
+#include "WireProtocol.h"
+
+static void testCrc() {
+  const uint8_t check[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+  CHECK_EQ(Wire_crc16(check, sizeof(check)), 0x29B1);
+  CHECK_EQ(Wire_crc16(check + 4, 5, Wire_crc16(check, 4)), 0x29B1);
+  CHECK_EQ(Wire_crc16(check, 0), 0xFFFF);
+}
+
+static void testLittleEndian() {
+  uint8_t p[4];
+  Wire_put32(p, 0x12345678);
+  CHECK_EQ(p[0], 0x78);
+  CHECK_EQ(p[3], 0x12);
+  CHECK_EQ(Wire_get32(p), 0x12345678);
+  Wire_put16(p, 0xBEEF);
+  CHECK_EQ(Wire_get16(p), 0xBEEF);
+}
+
+static void testReadingRoundTrip() {
+  WireReading reading = { WIRE_KIND_BLOOD_PRESSURE,
+                          WIRE_FIELD_VALUE0 | WIRE_FIELD_VALUE1 | WIRE_FIELD_VALUE2 | WIRE_FIELD_IDCARD,
+                          Wire_idcardFromString("1103700012345"), { 127, 82, 74, -1 }, 0xFEDCBA98 };
+  uint8_t packed[WIRE_READING_SIZE];
+  Wire_packReading(packed, reading);
+
+  uint8_t frame[WIRE_MAX_FRAME];
+  size_t length = Wire_encodeReading(frame, 0x1234, 0x89ABCDEF, packed, WIRE_READING_DURABLE_SEQ);
+  CHECK_EQ(length, WIRE_HEADER_SIZE + WIRE_READING_SIZE + WIRE_CRC_SIZE);
+
+  WireHeader header;
+  int payloadLength = Wire_parseFrame(frame, length, header);
+  CHECK_EQ(payloadLength, WIRE_READING_SIZE);
+  CHECK_EQ(header.type, WIRE_MSG_READING);
+  CHECK_EQ(header.status, WIRE_READING_DURABLE_SEQ);
+  CHECK_EQ(header.session, 0x1234);
+  CHECK_EQ(header.seq, 0x89ABCDEF);
+
+  WireReading decoded;
+  CHECK(Wire_decodeReading(frame + WIRE_HEADER_SIZE, payloadLength, decoded));
+  CHECK_EQ(decoded.kind, WIRE_KIND_BLOOD_PRESSURE);
+  CHECK_EQ(decoded.fields, reading.fields);
+  CHECK(decoded.idcard == reading.idcard);
+  CHECK_EQ(decoded.values[0], 127);
+  CHECK_EQ(decoded.values[2], 74);
+  CHECK_EQ(decoded.values[3], -1);
+  CHECK_EQ(decoded.timestamp, 0xFEDCBA98);
+
+  char idcard[24];
+  Wire_idcardToString(decoded.idcard, idcard, sizeof(idcard));
+  CHECK_STR(idcard, "1103700012345");
+
+  // น้ำหนักติดลบหลัง tare (หน่วย 0.1)
+  WireReading weight = { WIRE_KIND_WEIGHT, WIRE_FIELD_VALUE0, 0, { -5, 0, 0, 0 }, 1 };
+  Wire_packReading(packed, weight);
+  CHECK(Wire_decodeReading(packed, WIRE_READING_SIZE, decoded));
+  CHECK_EQ(decoded.values[0], -5);
+  CHECK(decoded.idcard == 0);
+}
+
+static void testReadingRejected() {
+  WireReading reading = { WIRE_KIND_TEMP, WIRE_FIELD_VALUE0, 0, { 365, 0, 0, 0 }, 0 };
+  uint8_t packed[WIRE_READING_SIZE];
+  Wire_packReading(packed, reading);
+  WireReading decoded;
+  CHECK(!Wire_decodeReading(packed, WIRE_READING_SIZE - 1, decoded));
+  CHECK(!Wire_decodeReading(packed, WIRE_READING_SIZE + 1, decoded));
+
+  packed[0] = 0;
+  CHECK(!Wire_decodeReading(packed, WIRE_READING_SIZE, decoded));
+  packed[0] = WIRE_KIND_HEIGHT + 1;
+  CHECK(!Wire_decodeReading(packed, WIRE_READING_SIZE, decoded));
+}
+
+static void testCorruptFrame() {
+  WireReading reading = { WIRE_KIND_WEIGHT_HEIGHT, WIRE_FIELD_VALUE0 | WIRE_FIELD_VALUE1, 0, { 703, 1735, 0, 0 }, 5 };
+  uint8_t packed[WIRE_READING_SIZE];
+  Wire_packReading(packed, reading);
+  uint8_t frame[WIRE_MAX_FRAME];
+  size_t length = Wire_encodeReading(frame, 1, 2, packed);
+  WireHeader header = { 0, 0, 0, 0 };
+
+  // ทุก bit ที่เพี้ยน (header, payload, crc) → CRC ไม่ตรง
+  bool allRejected = true;
+  for (size_t i = 0; i < length; i++) {
+    for (int bit = 0; bit < 8; bit++) {
+      frame[i] ^= 1 << bit;
+      allRejected = allRejected && Wire_parseFrame(frame, length, header) == -1;
+      frame[i] ^= 1 << bit;
+    }
+  }
+  CHECK(allRejected);
+  CHECK_EQ(header.type, 0);            // frame เสีย → ไม่เขียน header
+  CHECK_EQ(Wire_parseFrame(frame, length, header), WIRE_READING_SIZE);
+}
+
+static void testVersionAndMagic() {
+  uint8_t frame[WIRE_MAX_FRAME];
+  size_t length = Wire_encodeAck(frame, 7, 9, WIRE_ACK_OK);
+  WireHeader header;
+  CHECK_EQ(Wire_parseFrame(frame, length, header), 0);
+
+  // version ใหม่กว่า (layout อาจเปลี่ยน) ถึง CRC จะถูก → ไม่รับ
+  frame[1] = WIRE_VERSION + 1;
+  Wire_put16(frame + length - WIRE_CRC_SIZE, Wire_crc16(frame, length - WIRE_CRC_SIZE));
+  CHECK_EQ(Wire_parseFrame(frame, length, header), -1);
+
+  frame[1] = WIRE_VERSION;
+  frame[0] = 0x5A;
+  Wire_put16(frame + length - WIRE_CRC_SIZE, Wire_crc16(frame, length - WIRE_CRC_SIZE));
+  CHECK_EQ(Wire_parseFrame(frame, length, header), -1);
+}
+
+static void testTruncated() {
+  WireHello hello = { { 0xAA, 0xBB, 0xCC, 0x00, 0x00, 0x10 }, "Scale-10", 42 };
+  uint8_t frame[WIRE_MAX_FRAME];
+  size_t length = Wire_encodeHello(frame, 0x55, hello);
+  WireHeader header;
+
+  for (size_t cut = 0; cut < length; cut++) {
+    if (Wire_parseFrame(frame, cut, header) != -1) {
+      fprintf(stderr, "frame ถูกตัดเหลือ %u bytes แต่ parse ผ่าน\n", (unsigned)cut);
+      CHECK(false);
+    }
+  }
+
+  // frame ที่ถูกตัดแล้วคำนวณ CRC ใหม่ (เช่นผู้ส่งผิด) → header ผ่านแต่ payload ขนาดผิด
+  size_t payloadLength = length - WIRE_HEADER_SIZE - WIRE_CRC_SIZE;
+  WireHello decoded;
+  CHECK(!Wire_decodeHello(frame + WIRE_HEADER_SIZE, 6, decoded));
+  CHECK(!Wire_decodeHello(frame + WIRE_HEADER_SIZE, payloadLength - 1, decoded));
+  CHECK(!Wire_decodeHello(frame + WIRE_HEADER_SIZE, payloadLength - 5, decoded));
+  CHECK(!Wire_decodeHeartbeat(frame + WIRE_HEADER_SIZE, WIRE_HEARTBEAT_SIZE - 1, decoded.mac));
+}
+
+static void testHello() {
+  WireHello hello = { { 0xAA, 0xBB, 0xCC, 0x00, 0x00, 0x10 }, "Scale-10", 0xA1B2C3D4 };
+  uint8_t frame[WIRE_MAX_FRAME];
+  size_t length = Wire_encodeHello(frame, 0x55, hello);
+  WireHeader header;
+  int payloadLength = Wire_parseFrame(frame, length, header);
+  CHECK_EQ(header.type, WIRE_MSG_HELLO);
+  CHECK_EQ(header.session, 0x55);
+
+  WireHello decoded;
+  CHECK(Wire_decodeHello(frame + WIRE_HEADER_SIZE, payloadLength, decoded));
+  CHECK(memcmp(decoded.mac, hello.mac, 6) == 0);
+  CHECK_STR(decoded.name, "Scale-10");
+  CHECK_EQ(decoded.epoch, 0xA1B2C3D4);
+
+  // firmware เก่า: ไม่มี epoch → 0
+  CHECK(Wire_decodeHello(frame + WIRE_HEADER_SIZE, payloadLength - 4, decoded));
+  CHECK_EQ(decoded.epoch, 0);
+
+  // ชื่อยาวเกิน → ตัดเหลือ WIRE_NAME_SIZE - 1 และยังอยู่ใน WIRE_MAX_FRAME
+  memset(hello.name, 'N', sizeof(hello.name));
+  length = Wire_encodeHello(frame, 0x55, hello);
+  CHECK(length <= WIRE_MAX_FRAME);
+  payloadLength = Wire_parseFrame(frame, length, header);
+  CHECK(Wire_decodeHello(frame + WIRE_HEADER_SIZE, payloadLength, decoded));
+  CHECK_EQ(strlen(decoded.name), WIRE_NAME_SIZE - 1);
+}
+
+static void testAckAndHeartbeat() {
+  uint8_t frame[WIRE_MAX_FRAME];
+  size_t length = Wire_encodeAck(frame, 0x1234, 77, WIRE_ACK_UNKNOWN_SESSION);
+  CHECK_EQ(length, WIRE_HEADER_SIZE + WIRE_CRC_SIZE);
+  WireHeader header;
+  CHECK_EQ(Wire_parseFrame(frame, length, header), 0);
+  CHECK_EQ(header.type, WIRE_MSG_ACK);
+  CHECK_EQ(header.status, WIRE_ACK_UNKNOWN_SESSION);
+  CHECK_EQ(header.seq, 77);
+
+  const uint8_t mac[6] = { 1, 2, 3, 4, 5, 6 };
+  length = Wire_encodeHeartbeat(frame, 0x1234, mac);
+  CHECK_EQ(Wire_parseFrame(frame, length, header), WIRE_HEARTBEAT_SIZE);
+  CHECK_EQ(header.type, WIRE_MSG_HEARTBEAT);
+  uint8_t decoded[6];
+  CHECK(Wire_decodeHeartbeat(frame + WIRE_HEADER_SIZE, WIRE_HEARTBEAT_SIZE, decoded));
+  CHECK(memcmp(decoded, mac, 6) == 0);
+}
+
+static void testIdcard() {
+  char out[24];
+  CHECK(Wire_idcardFromString("0012345678901") == 12345678901ULL);
+  Wire_idcardToString(12345678901ULL, out, sizeof(out));
+  CHECK_STR(out, "0012345678901");      // เติม 0 ด้านหน้าให้ครบ 13 หลัก
+  CHECK(Wire_idcardFromString("") == 0);
+  CHECK(Wire_idcardFromString(nullptr) == 0);
+  CHECK(Wire_idcardFromString("1-1037-00012-34-5") == 0);
+  Wire_idcardToString(1103700012345ULL, out, 6);
+  CHECK_STR(out, "11037");              // buffer เล็ก → ตัด ไม่ล้น
+}
+
+int main() {
+  testCrc();
+  testLittleEndian();
+  testReadingRoundTrip();
+  testReadingRejected();
+  testCorruptFrame();
+  testVersionAndMagic();
+  testTruncated();
+  testHello();
+  testAckAndHeartbeat();
+  testIdcard();
+  return HostCheck_finish("wire_protocol");
+}
@@ -116,6 +116,8 @@ export function SerialSection({ form, updateField }: SerialSectionProps) {
               <SelectItem value="57600">57600</SelectItem>
               <SelectItem value="115200">115200</SelectItem>
               <SelectItem value="230400">230400</SelectItem>
+              <SelectItem value="460800">460800</SelectItem>
+              <SelectItem value="921600">921600</SelectItem>
             </SelectContent>
           </Select>
         </div>